@@ -88,6 +88,75 @@ hse_kvdb_compact(struct hse_kvdb *kvdb, unsigned int flags);
 hse_err_t
 hse_kvdb_compact_status_get(struct hse_kvdb *kvdb, struct hse_kvdb_compact_status *status);
 
+/** @brief Opaque structure, a pointer to which is a handle to a write batch. */
+struct hse_kvdb_batch;
+
+/** @brief Allocate a write batch.
+ *
+ * A write batch accumulates puts and deletes to any number of
+ * non-transactional KVSs in the KVDB, and applies them atomically via
+ * hse_kvdb_batch_apply().  This provides all-or-nothing visibility for a
+ * group of mutations without the key locks and conflict detection of a
+ * transaction.  Concurrent writers to the same keys are ordered by their
+ * apply, the last one applied wins.
+ *
+ * A batch refers to, but does not hold open, the KVSs it mutates.  Applying
+ * a batch that refers to a closed KVS fails with EBADF, and a batch must not
+ * be applied once a KVS it refers to has been dropped.  All batches must be
+ * freed before the KVDB is closed.
+ *
+ * @note This function is thread safe, but the batch must not be used by more
+ * than one thread at a time.
+ *
+ * @param kvdb: KVDB handle.
+ *
+ * @remark @p kvdb must not be NULL.
+ *
+ * @returns The allocated write batch, or NULL if out of memory.
+ */
+struct hse_kvdb_batch *
+hse_kvdb_batch_alloc(struct hse_kvdb *kvdb);
+
+/** @brief Free a write batch.
+ *
+ * Mutations in the batch that have not been applied are discarded.
+ *
+ * @note This function is thread safe with respect to other batches.
+ *
+ * @param kvdb: KVDB handle.
+ * @param batch: Write batch handle.
+ *
+ * @remark @p kvdb must not be NULL.
+ */
+void
+hse_kvdb_batch_free(struct hse_kvdb *kvdb, struct hse_kvdb_batch *batch);
+
+/** @brief Atomically apply all mutations in a write batch.
+ *
+ * All mutations in the batch are assigned the same sequence number and become
+ * visible to readers together.  They are logged to the WAL as one transaction,
+ * i.e., one record per mutation followed by a single commit record, such that
+ * WAL replay recovers either all of them or none.  On success the batch is
+ * emptied and may be reused.  On failure no mutation in the batch becomes
+ * visible and the batch is left intact.
+ *
+ * @note This function is thread safe with respect to other batches.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvdb: KVDB handle.
+ * @param flags: Flags for operation specialization.
+ * @param batch: Write batch handle.
+ *
+ * @remark @p kvdb must not be NULL.
+ * @remark @p batch must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvdb_batch_apply(struct hse_kvdb *kvdb, unsigned int flags, struct hse_kvdb_batch *batch);
+
 /**@} KVDB */
 
 /** @addtogroup KVS Key-Value Store (KVS)
@@ -150,6 +219,279 @@ hse_kvs_prefix_probe(
     size_t valbuf_sz,
     size_t *val_len);
 
+/** @brief Retrieve the values for a batch of keys from the referenced KVS.
+ *
+ * Semantically equivalent to calling hse_kvs_get() once for each key, except
+ * that all keys are retrieved from the same view of the KVS and that lookups
+ * which must search the on-media portion of the KVS are grouped by tree node.
+ * This amortizes the per-key overhead of locking, routing and kvset search,
+ * and allows the filter and index pages for many keys to be fetched in
+ * parallel.
+ *
+ * If the i'th key exists in the KVS, then @p found[i] is set to true. If the
+ * caller's i'th value buffer is large enough then the data will be returned.
+ * Regardless, the actual length of the value is placed in @p val_lens[i].
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction context (optional).
+ * @param count: Number of keys in @p keys.
+ * @param keys: Vector of keys.
+ * @param key_lens: Vector of key lengths.
+ * @param[out] found: Vector of found indicators.
+ * @param[in,out] valbufs: Vector of value buffers (optional).
+ * @param valbuf_szs: Vector of value buffer sizes (optional).
+ * @param[out] val_lens: Vector of actual value lengths.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p keys, @p key_lens, @p found and @p val_lens must not be NULL.
+ * @remark @p valbufs and @p valbuf_szs must both be NULL or both be non-NULL.
+ * @remark Each key must not be NULL.
+ * @remark Each key length must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_get_many(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    unsigned int count,
+    const void * const *keys,
+    const size_t *key_lens,
+    bool *found,
+    void * const *valbufs,
+    const size_t *valbuf_szs,
+    size_t *val_lens);
+
+/** @brief Completion callback for hse_kvs_get_async().
+ *
+ * @param arg: The @p cbarg passed to hse_kvs_get_async().
+ * @param err: Error status of the get.
+ * @param found: Whether or not the key was found.
+ * @param val_len: Actual length of the value (valid only if @p found is true).
+ */
+typedef void
+hse_kvs_get_async_cb(void *arg, hse_err_t err, bool found, size_t val_len);
+
+/** @brief Asynchronously retrieve the value for a given key from the referenced KVS.
+ *
+ * Semantically equivalent to hse_kvs_get(), except that the result is delivered
+ * via @p cb rather than through output parameters.  The key is looked up on the
+ * caller's stack, but if its value must be read from media then the read is
+ * issued asynchronously (via io_uring where available) and this function returns
+ * without waiting for it to complete.  This allows a single thread to keep many
+ * value reads in flight.
+ *
+ * @p cb is invoked exactly once if and only if this function returns success.
+ * It may be invoked before this function returns (e.g., if the value was found
+ * in memory), or from an internal HSE thread, in which case it must not block
+ * and must not call back into HSE.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction context (optional).
+ * @param key: Key to get from the KVS.
+ * @param key_len: Length of @p key.
+ * @param valbuf: Buffer into which the value associated with @p key will be
+ *   copied (optional).
+ * @param valbuf_sz: Size of @p valbuf.
+ * @param cb: Completion callback.
+ * @param cbarg: Argument passed to @p cb.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p key must not be NULL, but need not remain valid after this
+ *   function returns.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p valbuf must remain valid until @p cb has been invoked.
+ * @remark @p cb must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_get_async(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    const void *key,
+    size_t key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    hse_kvs_get_async_cb *cb,
+    void *cbarg);
+
+/** @brief Add a put of a key-value pair to a write batch.
+ *
+ * The put takes effect when the batch is applied via hse_kvdb_batch_apply().
+ * The key and value are copied, hence need not remain valid after this
+ * function returns.  Values are compressed (if so configured) at the time of
+ * this call.
+ *
+ * <b>Flags:</b>
+ * @arg HSE_KVS_PUT_VCOMP_OFF - Disable value compression.
+ * @arg HSE_KVS_PUT_VCOMP_ON - Enable value compression.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param batch: Write batch handle.
+ * @param key: Key to put into the KVS.
+ * @param key_len: Length of @p key.
+ * @param val: Value associated with @p key.
+ * @param val_len: Length of @p value.
+ *
+ * @remark @p kvs must not be NULL, and must not be transactional.
+ * @remark @p batch must have been allocated from the KVDB containing @p kvs.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark If @p val is NULL, then @p val_len must be 0.
+ * @remark @p val_len must be within the range of [0, HSE_KVS_VALUE_LEN_MAX].
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_batch_put(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len);
+
+/** @brief Add a delete of a key to a write batch.
+ *
+ * The delete takes effect when the batch is applied via hse_kvdb_batch_apply().
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param batch: Write batch handle.
+ * @param key: Key to be deleted from @p kvs.
+ * @param key_len: Length of @p key.
+ *
+ * @remark @p kvs must not be NULL, and must not be transactional.
+ * @remark @p batch must have been allocated from the KVDB containing @p kvs.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_batch_delete(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    const void *key,
+    size_t key_len);
+
+/** @brief Maximum length of a merge operand. */
+#define HSE_KVS_MERGE_OPND_LEN_MAX (255)
+
+/** @brief Merge operator callback.
+ *
+ * Combines a key's base value with the operands merged into it since the base
+ * value was written, yielding the key's new value.  The operator is invoked
+ * when the key is read and when operands are collapsed by compaction, possibly
+ * many times over the same operands, hence it must be deterministic and must
+ * not call back into HSE.  For example, a counter's operator might add each
+ * operand to the base value.
+ *
+ * @param key: Key.
+ * @param key_len: Length of @p key.
+ * @param base: Base value, or NULL if the key has no value (i.e., it was never
+ *   put or it was deleted).
+ * @param base_len: Length of @p base.
+ * @param opndc: Number of operands (at least 1).
+ * @param opndv: Vector of operands, oldest first.
+ * @param opnd_lenv: Vector of operand lengths.
+ * @param buf: Buffer to which the new value must be written.
+ * @param buf_sz: Size of @p buf (HSE_KVS_VALUE_LEN_MAX).
+ * @param[out] out_len: Length of the new value.
+ *
+ * @returns Zero on success, or an errno value on failure.
+ */
+typedef int
+hse_kvs_merge_fn(
+    const void *key,
+    size_t key_len,
+    const void *base,
+    size_t base_len,
+    unsigned int opndc,
+    const void * const *opndv,
+    const size_t *opnd_lenv,
+    void *buf,
+    size_t buf_sz,
+    size_t *out_len);
+
+/** @brief Register the merge operator of a KVS.
+ *
+ * The operator is not persisted, hence it must be registered each time the
+ * KVS is opened, before any operands are merged into or read from the KVS.
+ * Reads of keys with unresolved operands fail with ENOTSUP if no operator is
+ * registered.
+ *
+ * @note This function is not thread safe.
+ *
+ * @param kvs: KVS handle.
+ * @param fn: Merge operator, or NULL to unregister the current operator.
+ *
+ * @remark @p kvs must not be NULL, and must not be transactional.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_merge_op_set(struct hse_kvs *kvs, hse_kvs_merge_fn *fn);
+
+/** @brief Merge an operand into the value of a key.
+ *
+ * Unlike a read-modify-write, this function neither reads the key's value nor
+ * invokes the merge operator.  The operand is instead stored alongside the
+ * key's prior value, and the two are combined by the KVS's merge operator when
+ * the key is read, or when compaction collapses the operands.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg HSE_KVS_PUT_PRIO - Operation will not be throttled.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction context (must be NULL).
+ * @param key: Key to merge the operand into.
+ * @param key_len: Length of @p key.
+ * @param opnd: Merge operand.
+ * @param opnd_len: Length of @p opnd.
+ *
+ * @remark @p kvs must not be NULL, and must not be transactional.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p opnd must not be NULL.
+ * @remark @p opnd_len must be within the range of [1, HSE_KVS_MERGE_OPND_LEN_MAX].
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_merge(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    const void *key,
+    size_t key_len,
+    const void *opnd,
+    size_t opnd_len);
+
 /**@} KVS */
 
 #pragma GCC visibility pop
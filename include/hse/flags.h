@@ -16,10 +16,15 @@ extern "C" {
 #define HSE_KVDB_SYNC_ASYNC (1u << 0)
 #define HSE_KVDB_SYNC_RSVD1 (1u << 1)
 
+/* hse_kvdb_txn_begin_flags() flags */
+#define HSE_KVDB_TXN_BEGIN_WAIT         (1u << 0)
+#define HSE_KVDB_TXN_BEGIN_SERIALIZABLE (1u << 1)
+
 /* hse_kvs_put() flags */
 #define HSE_KVS_PUT_PRIO      (1u << 0)
 #define HSE_KVS_PUT_VCOMP_OFF (1u << 1)
 #define HSE_KVS_PUT_VCOMP_ON  (1u << 2)
+#define HSE_KVS_PUT_SYNC      (1u << 3)
 
 /* hse_kvs_cursor_create() flags */
 #define HSE_CURSOR_CREATE_REV (1u << 0)
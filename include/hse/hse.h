@@ -708,12 +708,20 @@ hse_kvs_prefix_delete(
  * not attempt to compress a value unless the HSE_KVS_PUT_VCOMP_ON flag is
  * given. Otherwise, the HSE_KVS_PUT_VCOMP_ON flag is ignored.
  *
+ * If the HSE_KVS_PUT_SYNC flag is given, hse_kvs_put() does not return until
+ * the put is durable. Unlike hse_kvdb_sync(), it waits only for the portion of
+ * the WAL that contains the put, hence concurrent synchronous puts may be made
+ * durable together (see the durability.group_commit.* KVDB parameters). The
+ * flag may not be used with a transaction, as transactional puts become
+ * durable only when the transaction commits.
+ *
  * @note This function is thread safe.
  *
  * <b>Flags:</b>
  * @arg HSE_KVS_PUT_PRIO - Operation will not be throttled.
  * @arg HSE_KVS_PUT_VCOMP_OFF - Value will not be compressed.
  * @arg HSE_KVS_PUT_VCOMP_ON - Value may be compressed.
+ * @arg HSE_KVS_PUT_SYNC - Operation will not return until the put is durable.
  *
  * @param kvs: KVS handle.
  * @param flags: Flags for operation specialization.
@@ -854,6 +862,39 @@ hse_kvdb_txn_alloc(struct hse_kvdb *kvdb);
 hse_err_t
 hse_kvdb_txn_begin(struct hse_kvdb *kvdb, struct hse_kvdb_txn *txn);
 
+/** @brief Initiate a transaction with flags.
+ *
+ * Same as hse_kvdb_txn_begin(), but with flags that control the behavior of
+ * the transaction.
+ *
+ * <b>Flags:</b>
+ * @arg HSE_KVDB_TXN_BEGIN_WAIT - On a write conflict with a transaction that
+ * is still active, wait for it to finish rather than fail immediately. If the
+ * other transaction aborts, the write proceeds. If it commits, if the wait
+ * exceeds the txn_lock_wait_timeout KVDB parameter, or if waiting would
+ * deadlock, the write fails with ECANCELED (see @ref WRITE_CONFLICT).
+ * @arg HSE_KVDB_TXN_BEGIN_SERIALIZABLE - Track the keys read by the
+ * transaction and, at commit, verify that none of them has been written by
+ * another transaction since this one began. If the verification fails, the
+ * transaction is aborted and hse_kvdb_txn_commit() returns ECANCELED. Prefix
+ * probes and cursors are verified against all concurrent writers, hence they
+ * fail to commit whenever another transaction commits writes in the interim.
+ *
+ * @note This function is thread safe with different transactions.
+ *
+ * @param kvdb: KVDB handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction handle.
+ *
+ * @remark @p kvdb must not be NULL.
+ * @remark @p txn must not be NULL.
+ *
+ * @returns Error status.
+ */
+/* MTF_MOCK */
+hse_err_t
+hse_kvdb_txn_begin_flags(struct hse_kvdb *kvdb, unsigned int flags, struct hse_kvdb_txn *txn);
+
 /** @brief Commit all the mutations of a transaction.
  *
  * @warning The call fails if the referenced transaction is not in the ACTIVE
@@ -81,6 +81,8 @@ enum kvdb_perfc_sidx_ctxnop {
     PERFC_LT_CTXNOP_COMMIT,
     PERFC_RA_CTXNOP_ABORT,
     PERFC_RA_CTXNOP_LOCKFAIL,
+    PERFC_RA_CTXNOP_LOCKWAIT,
+    PERFC_RA_CTXNOP_DEADLOCK,
     PERFC_RA_CTXNOP_FREE,
     PERFC_EN_CTXNOP
 };
@@ -88,12 +90,13 @@ enum kvdb_perfc_sidx_ctxnop {
 enum kvdb_perfc_sidx_cnget {
     PERFC_LT_CNGET_GET,
 
-    /* The following five enumerators must match enum key_lookup_res */
+    /* The following six enumerators must match enum key_lookup_res */
     PERFC_RA_CNGET_MISS,
     PERFC_RA_CNGET_GET,
     PERFC_RA_CNGET_TOMB,
     PERFC_RA_CNGET_PTOMB,
     PERFC_RA_CNGET_MULTIPLE,
+    PERFC_RA_CNGET_MOPND,
 
     /* The enumerators PERFC_LT_CNGET_GET_ROOT and LEAF must be sequential */
     PERFC_LT_CNGET_GET_ROOT,
@@ -156,6 +159,25 @@ enum kvdb_perfc_cncapped {
     PERFC_EN_CNCAPPED
 };
 
+enum kvdb_perfc_mbcache {
+    PERFC_RA_MBCACHE_HIT,
+    PERFC_RA_MBCACHE_MISS,
+    PERFC_RA_MBCACHE_BYPASS,
+    PERFC_RA_MBCACHE_EVICT,
+    PERFC_BA_MBCACHE_EXTENTS,
+    PERFC_BA_MBCACHE_BYTES,
+    PERFC_EN_MBCACHE
+};
+
+enum kvdb_perfc_rcache {
+    PERFC_RA_RCACHE_HIT,
+    PERFC_RA_RCACHE_MISS,
+    PERFC_RA_RCACHE_FILL,
+    PERFC_RA_RCACHE_EVICT,
+    PERFC_BA_RCACHE_BYTES,
+    PERFC_EN_RCACHE
+};
+
 enum kvdb_perfc_sidx_cursorcache {
     PERFC_RA_CC_HIT,
     PERFC_RA_CC_MISS,
@@ -201,6 +223,7 @@ enum kvdb_perfc_sidx_pkvsl {
     PERFC_LT_PKVSL_KVS_DEL,
     PERFC_LT_PKVSL_KVS_PFX_PROBE,
     PERFC_LT_PKVSL_KVS_PFX_DEL,
+    PERFC_LT_PKVSL_KVS_GET_MANY,
 
     PERFC_EN_PKVSL
 };
@@ -245,6 +245,27 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_mbcache_sz",
+        .ps_description = "size of cN kblock/hblock cache for direct I/O media classes (bytes)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U64,
+        .ps_offset = offsetof(struct hse_gparams, gp_cn_mbcache_sz),
+        .ps_size = PARAM_SZ(struct hse_gparams, gp_cn_mbcache_sz),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = HSE_CN_MBCACHE_SZ_DFLT,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = HSE_CN_MBCACHE_SZ_MIN,
+                .ps_max = HSE_CN_MBCACHE_SZ_MAX,
+            },
+        },
+    },
     {
         .ps_name = "c0kvs_ccache_sz_max",
         .ps_description = "max size of c0kvs cheap cache (bytes)",
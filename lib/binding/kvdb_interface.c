@@ -18,6 +18,7 @@
 #include <hse/version.h>
 
 #include <hse/config/config.h>
+#include <hse/ikvdb/cn.h>
 #include <hse/ikvdb/hse_gparams.h>
 #include <hse/ikvdb/ikvdb.h>
 #include <hse/ikvdb/kvdb_cparams.h>
@@ -52,7 +53,9 @@
         HSE_KVDB_COMPACT_FULL )
 
 #define HSE_KVDB_SYNC_MASK     (HSE_KVDB_SYNC_ASYNC)
-#define HSE_KVS_PUT_MASK       (HSE_KVS_PUT_PRIO | HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
+#define HSE_KVDB_TXN_BEGIN_MASK (HSE_KVDB_TXN_BEGIN_WAIT | HSE_KVDB_TXN_BEGIN_SERIALIZABLE)
+#define HSE_KVS_PUT_MASK \
+    (HSE_KVS_PUT_PRIO | HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON | HSE_KVS_PUT_SYNC)
 #define HSE_KVS_PUT_VCOMP_MASK (HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
 #define HSE_CURSOR_CREATE_MASK (HSE_CURSOR_CREATE_REV)
 
@@ -1209,7 +1212,8 @@ hse_kvs_put(
 
     if (HSE_UNLIKELY(
             !handle || !key || (val_len > 0 && !val) || flags & ~HSE_KVS_PUT_MASK ||
-            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK ||
+            (txn && (flags & HSE_KVS_PUT_SYNC))))
         return merr(EINVAL);
 
     if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
@@ -1293,6 +1297,183 @@ hse_kvs_get(
     return 0;
 }
 
+hse_err_t
+hse_kvs_get_many(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const unsigned int count,
+    const void * const *keys,
+    const size_t *key_lens,
+    bool *found,
+    void * const *valbufs,
+    const size_t *valbuf_szs,
+    size_t *val_lens)
+{
+    struct kvs_ktuple ktv_stack[HSE_KVS_GET_MANY_BATCH], *ktv = ktv_stack;
+    enum key_lookup_res resv_stack[HSE_KVS_GET_MANY_BATCH], *resv = resv_stack;
+    struct kvs_buf vbufv_stack[HSE_KVS_GET_MANY_BATCH], *vbufv = vbufv_stack;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !keys || !key_lens || !found || !val_lens || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(!valbufs != !valbuf_szs))
+        return merr(EINVAL);
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (HSE_UNLIKELY(!keys[i]))
+            return merr(EINVAL);
+
+        if (HSE_UNLIKELY(valbufs && !valbufs[i] && valbuf_szs[i] > 0))
+            return merr(EINVAL);
+
+        if (HSE_UNLIKELY(key_lens[i] > HSE_KVS_KEY_LEN_MAX))
+            return merr(ENAMETOOLONG);
+
+        if (HSE_UNLIKELY(key_lens[i] == 0))
+            return merr(ENOENT);
+    }
+
+    if (count == 0)
+        return 0;
+
+    /* All keys must be searched using the same view, so large batches
+     * cannot be split here.  cn splits them as needed internally.
+     */
+    if (count > HSE_KVS_GET_MANY_BATCH) {
+        ktv = malloc(count * (sizeof(*ktv) + sizeof(*resv) + sizeof(*vbufv)));
+        if (ev(!ktv))
+            return merr(ENOMEM);
+
+        vbufv = (void *)(ktv + count);
+        resv = (void *)(vbufv + count);
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        void *valbuf = valbufs ? valbufs[i] : NULL;
+        size_t valbuf_sz = valbufs ? valbuf_szs[i] : 0;
+
+        /* See hse_kvs_get() for the meaning of a NULL valbuf. */
+        if (!valbuf && valbuf_sz == 0)
+            valbuf = (void *)-1;
+
+        kvs_ktuple_init_nohash(ktv + i, keys[i], key_lens[i]);
+        kvs_buf_init(vbufv + i, valbuf, valbuf_sz);
+    }
+
+    err = ikvdb_kvs_get_many(handle, flags, txn, count, ktv, resv, vbufv);
+    if (ev(err))
+        goto out;
+
+    for (unsigned int i = 0; i < count; i++) {
+        found[i] = (resv[i] == FOUND_VAL);
+        val_lens[i] = vbufv[i].b_len;
+
+        if (ev(resv[i] == FOUND_MULTIPLE)) {
+            err = merr(EPROTO);
+            goto out;
+        }
+
+        PERFC_INCADD_RU(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_GET, PERFC_RA_KVDBOP_KVS_GETB,
+            found[i] ? val_lens[i] : 0);
+    }
+
+out:
+    if (ktv != ktv_stack)
+        free(ktv);
+
+    return err;
+}
+
+/* Per-request state of hse_kvs_get_async(), freed after the caller's
+ * callback has been invoked.
+ */
+struct kvs_get_async_req {
+    struct cn_get_aio aio;
+    struct kvs_buf vbuf;
+    hse_kvs_get_async_cb *cb;
+    void *cbarg;
+};
+
+static void
+hse_kvs_get_async_done(struct cn_get_aio *aio)
+{
+    struct kvs_get_async_req *req = container_of(aio, struct kvs_get_async_req, aio);
+    merr_t err = aio->cga_err;
+    bool found = false;
+
+    if (!ev(err)) {
+        found = (aio->cga_res == FOUND_VAL);
+
+        if (ev(aio->cga_res == FOUND_MULTIPLE))
+            err = merr(EPROTO);
+        else if (ev(aio->cga_res == FOUND_MOPND))
+            err = merr(ENOTSUP);
+        else
+            PERFC_INCADD_RU(
+                &kvdb_pc, PERFC_RA_KVDBOP_KVS_GET, PERFC_RA_KVDBOP_KVS_GETB,
+                found ? req->vbuf.b_len : 0);
+    }
+
+    req->cb(req->cbarg, err, found, req->vbuf.b_len);
+    free(req);
+}
+
+hse_err_t
+hse_kvs_get_async(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *key,
+    size_t key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    hse_kvs_get_async_cb *cb,
+    void *cbarg)
+{
+    struct kvs_get_async_req *req;
+    struct kvs_ktuple kt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !key || !cb || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(!valbuf && valbuf_sz > 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    /* See hse_kvs_get() for the meaning of a NULL valbuf. */
+    if (!valbuf && valbuf_sz == 0)
+        valbuf = (void *)-1;
+
+    req = malloc(sizeof(*req));
+    if (ev(!req))
+        return merr(ENOMEM);
+
+    req->cb = cb;
+    req->cbarg = cbarg;
+    req->aio.cga_cb = hse_kvs_get_async_done;
+    req->aio.cga_vbuf = &req->vbuf;
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_buf_init(&req->vbuf, valbuf, valbuf_sz);
+
+    /* On success the request is owned by hse_kvs_get_async_done().
+     */
+    err = ikvdb_kvs_get_async(handle, flags, txn, &kt, &req->aio);
+    if (ev(err))
+        free(req);
+
+    return err;
+}
+
 /**
  * hse_kvs_delete() - remove the supplied key and associated value from the KVS
  */
@@ -1492,18 +1673,18 @@ hse_kvdb_txn_free(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
 }
 
 hse_err_t
-hse_kvdb_txn_begin(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
+hse_kvdb_txn_begin_flags(struct hse_kvdb *handle, const unsigned int flags, struct hse_kvdb_txn *txn)
 {
     merr_t err;
     uint64_t tstart;
 
-    if (HSE_UNLIKELY(!handle || !txn))
+    if (HSE_UNLIKELY(!handle || !txn || flags & ~HSE_KVDB_TXN_BEGIN_MASK))
         return merr(EINVAL);
 
     tstart = kvdb_lat_startu(PERFC_LT_PKVDBL_KVDB_TXN_BEGIN);
     PERFC_INC_RU(&kvdb_pc, PERFC_RA_KVDBOP_KVDB_TXN_BEGIN);
 
-    err = ikvdb_txn_begin((struct ikvdb *)handle, txn);
+    err = ikvdb_txn_begin((struct ikvdb *)handle, flags, txn);
     ev(err);
 
     kvdb_lat_record(PERFC_LT_PKVDBL_KVDB_TXN_BEGIN, tstart);
@@ -1511,6 +1692,12 @@ hse_kvdb_txn_begin(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
     return err;
 }
 
+hse_err_t
+hse_kvdb_txn_begin(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
+{
+    return hse_kvdb_txn_begin_flags(handle, 0, txn);
+}
+
 hse_err_t
 hse_kvdb_txn_commit(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
 {
@@ -1802,6 +1989,155 @@ hse_kvdb_compact_status_get(struct hse_kvdb *handle, struct hse_kvdb_compact_sta
     return 0;
 }
 
+struct hse_kvdb_batch *
+hse_kvdb_batch_alloc(struct hse_kvdb *handle)
+{
+    if (HSE_UNLIKELY(!handle))
+        return NULL;
+
+    return ikvdb_batch_alloc((struct ikvdb *)handle);
+}
+
+void
+hse_kvdb_batch_free(struct hse_kvdb *handle, struct hse_kvdb_batch *batch)
+{
+    if (HSE_UNLIKELY(!handle || !batch))
+        return;
+
+    ikvdb_batch_free((struct ikvdb *)handle, batch);
+}
+
+hse_err_t
+hse_kvs_batch_put(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len)
+{
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || !batch || !key || (val_len > 0 && !val) ||
+            flags & ~HSE_KVS_PUT_VCOMP_MASK ||
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(val_len > HSE_KVS_VALUE_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_vtuple_init(&vt, (void *)val, val_len);
+
+    err = ikvdb_kvs_batch_put(handle, flags, batch, &kt, &vt);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_batch_delete(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    const void *key,
+    size_t key_len)
+{
+    struct kvs_ktuple kt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !batch || !key || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+
+    err = ikvdb_kvs_batch_del(handle, flags, batch, &kt);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_batch_apply(struct hse_kvdb *handle, const unsigned int flags, struct hse_kvdb_batch *batch)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !batch || flags != 0))
+        return merr(EINVAL);
+
+    err = ikvdb_batch_apply((struct ikvdb *)handle, flags, batch);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_merge_op_set(struct hse_kvs *handle, hse_kvs_merge_fn *fn)
+{
+    if (HSE_UNLIKELY(!handle))
+        return merr(EINVAL);
+
+    return ikvdb_kvs_merge_op_set(handle, fn);
+}
+
+hse_err_t
+hse_kvs_merge(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *key,
+    size_t key_len,
+    const void *opnd,
+    size_t opnd_len)
+{
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !key || !opnd || txn || flags & ~HSE_KVS_PUT_PRIO))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(opnd_len == 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(opnd_len > HSE_KVS_MERGE_OPND_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_vtuple_init(&vt, (void *)opnd, opnd_len);
+
+    err = ikvdb_kvs_merge(handle, flags, &kt, &vt);
+    ev(err);
+
+    if (!err)
+        PERFC_INCADD_RU(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_PUT, PERFC_RA_KVDBOP_KVS_PUTB, key_len + opnd_len);
+
+    return err;
+}
+
 size_t
 hse_strerror(hse_err_t err, char *buf, size_t buf_sz)
 {
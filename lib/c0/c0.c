@@ -128,7 +128,8 @@ c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct c0_impl *self;
 
@@ -136,7 +137,8 @@ c0_get(
 
     assert(self->c0_index < HSE_KVS_COUNT_MAX);
     return c0sk_get(
-        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, view_seqno, seqnoref, res, vbuf);
+        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, view_seqno, seqnoref, res, vbuf,
+        seqnop);
 }
 
 merr_t
@@ -14,10 +14,42 @@
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/lc.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/util/atomic.h>
 #include <hse/util/platform.h>
+#include <hse/util/workqueue.h>
 
 /* clang-format off */
 
+struct c0_ingest_build_set;
+
+/**
+ * struct c0_ingest_build - kvset build job for the keys of one kvs in an ingest
+ * @c0ib_ingest:   ingest to which the job belongs
+ * @c0ib_startv:   index of the job's first entry in each of the ingest's cn lists
+ * @c0ib_endv:     index one past the job's last entry in each cn list
+ * @c0ib_thr_tls:  throttle state of the thread running the job
+ * @c0ib_kbytes:   key bytes added to the job's kvset builder
+ * @c0ib_vbytes:   value bytes added to the job's kvset builder
+ * @c0ib_mask:     throttle sensor update threshold
+ * @c0ib_err:      job status
+ * @c0ib_claimed:  set by the thread that runs the job
+ * @c0ib_set:      state shared by the build jobs of the ingest
+ * @c0ib_work:     work struct for the build workqueue
+ */
+struct c0_ingest_build {
+    struct c0_ingest_work       *c0ib_ingest;
+    size_t                       c0ib_startv[2];
+    size_t                       c0ib_endv[2];
+    struct throttle_tls         *c0ib_thr_tls;
+    uint64_t                     c0ib_kbytes;
+    uint64_t                     c0ib_vbytes;
+    uint64_t                     c0ib_mask;
+    merr_t                       c0ib_err;
+    atomic_int                   c0ib_claimed;
+    struct c0_ingest_build_set  *c0ib_set;
+    struct work_struct           c0ib_work;
+};
+
 /**
  * struct c0_ingest_work - description of ingest work to be performed
  * @c0iw_c0:            struct c0 in whose context the ingest is occuring
@@ -26,6 +58,8 @@
  * @c0iw_kvms_iterv:
  * @c0iw_coalscedbldrs:
  * @c0iw_bldrs:
+ * @c0iw_buildv:        kvset build jobs, one per kvs with keys to ingest
+ * @c0iw_buildc:        number of jobs in c0iw_buildv[]
  * @c0iw_mblocks:
  * @c0iw_c0kvms:        struct c0_kvmultiset being ingested
  * @c0iw_c0:
@@ -39,13 +73,14 @@
  */
 struct c0_ingest_work {
     struct throttle_sensor  *c0iw_thr_sensor;
-    struct throttle_tls     *c0iw_thr_tls;
     struct c0sk             *c0iw_c0sk;
     struct element_source   *c0iw_kvms_sourcev[HSE_C0_INGEST_WIDTH_MAX];
     struct c0_kvset_iterator c0iw_kvms_iterv[HSE_C0_INGEST_WIDTH_MAX];
     struct lc_ingest_iter    c0iw_lc_iterv[LC_SOURCE_CNT_MAX];
     struct element_source   *c0iw_lc_sourcev[LC_SOURCE_CNT_MAX];
     struct kvset_builder    *c0iw_bldrs[HSE_KVS_COUNT_MAX];
+    struct c0_ingest_build   c0iw_buildv[HSE_KVS_COUNT_MAX];
+    uint32_t                 c0iw_buildc;
     struct kvset_mblocks     c0iw_mblocks[HSE_KVS_COUNT_MAX];
     uint64_t                 c0iw_kvsetidv[HSE_KVS_COUNT_MAX];
     struct c0_kvmultiset    *c0iw_c0kvms;
@@ -65,10 +100,6 @@ struct c0_ingest_work {
     uint64_t t0, t3, t4, t5, t6, t7, t8, t9, t10;
     uint64_t gencur, gen;
 
-    uint64_t c0iw_kbytes;
-    uint64_t c0iw_vbytes;
-    uint64_t c0iw_mask;
-
     /* Establishing view for ingest */
     uint64_t c0iw_ingest_max_seqno;
     uint64_t c0iw_ingest_min_seqno;
@@ -8,8 +8,8 @@
 #include <hse/ikvdb/c0_kvset.h>
 #include <hse/ikvdb/c0_kvset_iterator.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/util/bonsai_tree.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
 #include <hse/util/keycmp.h>
@@ -539,13 +539,9 @@ void *
 c0kvs_alloc(struct c0_kvset *handle, size_t align, size_t sz)
 {
     struct c0_kvset_impl *impl = c0_kvset_h2r(handle);
-    void *mem;
 
-    c0kvs_lock(impl);
-    mem = cheap_memalign(impl->c0s_cheap, align, sz);
-    c0kvs_unlock(impl);
-
-    return mem;
+    /* Cheap allocations are thread-safe, no need for the lock. */
+    return cheap_memalign(impl->c0s_cheap, align, sz);
 }
 
 static merr_t
@@ -586,11 +582,40 @@ c0kvs_put(
     struct c0_kvset_impl *self = c0_kvset_h2r(handle);
     struct bonsai_skey skey;
     struct bonsai_sval sval;
+    uint32_t flags = kt->kt_flags;
+    void *vdata = vt->vt_data;
+    uint vlen = 0;
+    merr_t err;
+
+    bn_sval_init(vdata, vt->vt_xlen, seqnoref, &sval);
+
+    /* Copy the value into the cheap before acquiring the c0kvs lock so
+     * that concurrent writers to this c0kvs copy their values in parallel.
+     * The lock then protects only the tree update.
+     */
+    if (!(flags & HSE_BTF_MANAGED) && bonsai_sval_vlen(&sval) > 0) {
+        vlen = bonsai_sval_vlen(&sval);
+
+        vdata = cheap_malloc(self->c0s_cheap, vlen);
+        if (ev(!vdata))
+            return merr(ENOMEM);
 
-    bn_skey_init(kt->kt_data, kt->kt_len, kt->kt_flags, skidx, &skey);
-    bn_sval_init(vt->vt_data, vt->vt_xlen, seqnoref, &sval);
+        memcpy(vdata, vt->vt_data, vlen);
+        bn_sval_init(vdata, vt->vt_xlen, seqnoref, &sval);
+        flags |= HSE_BTF_MANAGED_VAL;
+    }
+
+    bn_skey_init(kt->kt_data, kt->kt_len, flags, skidx, &skey);
+
+    err = c0kvs_putdel(self, &skey, &sval, &kt->kt_seqno);
 
-    return c0kvs_putdel(self, &skey, &sval, &kt->kt_seqno);
+    /* Return the copy to the cheap, which succeeds unless another
+     * writer has allocated from the cheap since.
+     */
+    if (err && vlen > 0)
+        cheap_free(self->c0s_cheap, vdata, vlen);
+
+    return err;
 }
 
 merr_t
@@ -660,6 +685,8 @@ c0kvs_usage(struct c0_kvset *handle, struct c0_usage *usage)
 /*
  * If key is found:
  *     return value == 0 && *res == FOUND_VAL && *oseqnoref == seqnoref of match
+ * If a merge operand is found:
+ *     return value == 0 && *res == FOUND_MOPND && *oseqnoref == seqnoref of match
  * If tombstone is found:
  *     return value == 0 && *res == FOUND_TMB && *oseqnoref == seqnoref of match
  * If key is not found:
@@ -719,8 +746,7 @@ c0kvs_get_excl(
         ulen = bonsai_val_ulen(val);
 
         if (clen > 0) {
-            err = compress_lz4_ops.cop_decompress(
-                val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
+            err = vcomp_decompress(val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
             if (ev(err))
                 return err;
 
@@ -733,7 +759,7 @@ c0kvs_get_excl(
         }
     }
 
-    *res = FOUND_VAL;
+    *res = (val->bv_xlen & HSE_XLEN_MOPND) ? FOUND_MOPND : FOUND_VAL;
 
     return 0;
 }
@@ -850,7 +876,7 @@ c0kvs_pfx_probe_cmn(
                 ulen = bonsai_val_ulen(val);
 
                 if (clen > 0) {
-                    err = compress_lz4_ops.cop_decompress(
+                    err = vcomp_decompress(
                         val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
                     if (ev(err))
                         return err;
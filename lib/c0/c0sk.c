@@ -296,7 +296,8 @@ c0sk_get(
     uint64_t view_seq,
     uintptr_t seqref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct c0_kvmultiset *c0kvms;
     struct c0sk_impl *self;
@@ -352,6 +353,9 @@ c0sk_get(
         vbuf->b_len = 0;
     }
 
+    if (seqnop && *res == FOUND_MOPND)
+        *seqnop = val_seq;
+
     if (start > 0) {
         perfc_lat_record(&self->c0sk_pc_op, PERFC_LT_C0SKOP_GET, start);
         perfc_inc(&self->c0sk_pc_op, PERFC_RA_C0SKOP_GET);
@@ -498,6 +502,16 @@ c0sk_open(
         goto errout;
     }
 
+    tdmax = min_t(uint, kvdb_rp->c0_ingest_build_threads, HSE_C0_INGEST_BUILD_THREADS_MAX);
+
+    if (tdmax > 0) {
+        c0sk->c0sk_wq_build = alloc_workqueue("hse_c0sk_build", 0, 1, tdmax);
+        if (!c0sk->c0sk_wq_build) {
+            err = merr(ENOMEM);
+            goto errout;
+        }
+    }
+
     c0sk->c0sk_ingest_width = kvdb_rp->c0_ingest_width;
 
     if (gen > 0)
@@ -535,6 +549,8 @@ errout:
         if (c0sk) {
             destroy_workqueue(c0sk->c0sk_wq_ingest);
             destroy_workqueue(c0sk->c0sk_wq_maint);
+            if (c0sk->c0sk_wq_build)
+                destroy_workqueue(c0sk->c0sk_wq_build);
             cv_destroy(&c0sk->c0sk_kvms_cv);
             mutex_destroy(&c0sk->c0sk_sync_mutex);
             mutex_destroy(&c0sk->c0sk_kvms_mutex);
@@ -586,6 +602,8 @@ c0sk_close(struct c0sk *handle)
 
     destroy_workqueue(self->c0sk_wq_ingest);
     destroy_workqueue(self->c0sk_wq_maint);
+    if (self->c0sk_wq_build)
+        destroy_workqueue(self->c0sk_wq_build);
     c0kvms_destroy_cache(&self->c0sk_stash);
     cv_destroy(&self->c0sk_kvms_cv);
     mutex_destroy(&self->c0sk_sync_mutex);
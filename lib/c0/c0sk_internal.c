@@ -28,6 +28,7 @@
 #include <hse/util/bonsai_tree.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/log2.h>
+#include <hse/util/minmax.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
 #include <hse/util/table.h>
@@ -259,18 +260,20 @@ c0sk_bkv_sort_vals(struct bonsai_kv *bkv, struct bonsai_val **val_head)
  * c0sk_cningest_cb() - Callback function for bkv_collection. Called once for every pair of
  *                      key and its value list.
  *
- * @rock:  Context - ingest worker object
+ * @rock:  Context - build job for the key's kvs
  * @bkv:   Key
  * @vlist: List of values
  */
 static merr_t
 c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
 {
-    struct c0_ingest_work *ingest = rock;
+    struct c0_ingest_build *job = rock;
+    struct c0_ingest_work *ingest = job->c0ib_ingest;
     struct bonsai_val *val;
     merr_t err;
-    uint64_t seqno_prev, pt_seqno_prev;
+    uint64_t seqno_prev, pt_seqno_prev, seqno_max;
     struct key_obj ko;
+    bool ptomb = false;
 
     uint16_t skidx = key_immediate_index(&bkv->bkv_key_imm);
     struct c0sk_impl *c0sk = c0sk_h2r(ingest->c0iw_c0sk);
@@ -305,6 +308,7 @@ c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
 
     seqno_prev = UINT64_MAX;
     pt_seqno_prev = UINT64_MAX;
+    seqno_max = 0;
     klen = key_imm_klen(&bkv->bkv_key_imm);
     vlen = 0;
     key2kobj(&ko, bkv->bkv_key, klen);
@@ -324,15 +328,21 @@ c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
 
         assert(val == vlist || rc < 0);
 
-        if (HSE_CORE_IS_PTOMB(val->bv_value))
+        if (HSE_CORE_IS_PTOMB(val->bv_value)) {
             pt_seqno_prev = seqno;
-        else
+            ptomb = true;
+        } else {
             seqno_prev = seqno;
+        }
 
+        seqno_max = max(seqno_max, seqno);
         vlen += bonsai_val_vlen(val);
 
-        err = kvset_builder_add_val(
-            bldr, &ko, val->bv_value, bonsai_val_ulen(val), seqno, bonsai_val_clen(val));
+        if (val->bv_xlen & HSE_XLEN_MOPND)
+            err = kvset_builder_add_mopnd(bldr, seqno, val->bv_value, bonsai_val_ulen(val));
+        else
+            err = kvset_builder_add_val(
+                bldr, &ko, val->bv_value, bonsai_val_ulen(val), seqno, bonsai_val_clen(val));
 
         if (ev(err))
             return err;
@@ -342,17 +352,22 @@ c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
     if (ev(err))
         return err;
 
-    ingest->c0iw_kbytes += klen;
-    ingest->c0iw_vbytes += vlen;
+    /* The kvms remains in c0 until the ingest commits, hence caches of
+     * cn content can drop the key now without exposing a stale value.
+     */
+    cn_ingest_inval(cn, bkv->bkv_key, klen, seqno_max, ptomb);
 
-    if (ingest->c0iw_kbytes + ingest->c0iw_vbytes > ingest->c0iw_mask) {
-        struct throttle_tls *tls = ingest->c0iw_thr_tls;
+    job->c0ib_kbytes += klen;
+    job->c0ib_vbytes += vlen;
+
+    if (job->c0ib_kbytes + job->c0ib_vbytes > job->c0ib_mask) {
+        struct throttle_tls *tls = job->c0ib_thr_tls;
 
         tls->bytes += klen + vlen;
 
-        if (tls->bytes > ingest->c0iw_mask) {
+        if (tls->bytes > job->c0ib_mask) {
             struct throttle_sensor *ts = ingest->c0iw_thr_sensor;
-            uint64_t resid = tls->bytes & ingest->c0iw_mask;
+            uint64_t resid = tls->bytes & job->c0ib_mask;
             uint64_t gen;
 
             tls->bytes -= resid;
@@ -362,12 +377,12 @@ c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
                 atomic_ulong *cntrp;
                 uint64_t pct;
 
-                pct = (ingest->c0iw_kbytes * 100) / (ingest->c0iw_kbytes + ingest->c0iw_vbytes);
+                pct = (job->c0ib_kbytes * 100) / (job->c0ib_kbytes + job->c0ib_vbytes);
                 if (pct < 10) {
-                    ingest->c0iw_mask = (32ul << 20) - 1;
+                    job->c0ib_mask = (32ul << 20) - 1;
                 } else {
                     tls->bytes += (tls->bytes * pct) / 100;
-                    ingest->c0iw_mask = (16ul << 20) - 1;
+                    job->c0ib_mask = (16ul << 20) - 1;
                 }
 
                 /* Average out the byte count for each missed generation.
@@ -560,6 +575,182 @@ c0sk_merge_loop(
     return 0;
 }
 
+/**
+ * struct c0_ingest_build_set - shared state of the build jobs of an ingest
+ * @cibs_lock:    protects cibs_pending
+ * @cibs_cv:      signaled when the last queued job completes
+ * @cibs_pending: number of jobs queued to the build workqueue yet to complete
+ * @cibs_listv:   the ingest's cn lists (see c0sk_ingest_worker())
+ */
+struct c0_ingest_build_set {
+    struct mutex           cibs_lock;
+    struct cv              cibs_cv;
+    uint                   cibs_pending;
+    struct bkv_collection *cibs_listv[2];
+};
+
+static void
+c0sk_ingest_build_job(struct c0_ingest_build *job)
+{
+    struct c0_ingest_work *ingest = job->c0ib_ingest;
+    struct c0_ingest_build_set *set = job->c0ib_set;
+
+    /* Initialize the per-thread throttle state so that c0sk_cningest_cb() (called
+     * repeatedly by bkv_collection_finish_pair_range()) can update the c0sk throttle
+     * sensor with the observed spill rate.
+     */
+    if (ingest->c0iw_thr_sensor) {
+        job->c0ib_thr_tls = &hse_throttle_tls;
+        job->c0ib_thr_tls->bytes = 0;
+        job->c0ib_thr_tls->cntrgen = atomic_read_acq(ingest->c0iw_thr_sensor->ts_cntrgenp);
+        job->c0ib_mask = (32ul << 20) - 1;
+    } else {
+        job->c0ib_mask = UINT64_MAX;
+    }
+
+    job->c0ib_err = bkv_collection_finish_pair_range(
+        set->cibs_listv[0], set->cibs_listv[1], job->c0ib_startv, job->c0ib_endv, job);
+
+    /* Prevent any other thread from accessing this thread's local storage via c0ib_thr_tls.
+     */
+    job->c0ib_thr_tls = NULL;
+}
+
+static void
+c0sk_ingest_build_worker(struct work_struct *work)
+{
+    struct c0_ingest_build *job = container_of(work, struct c0_ingest_build, c0ib_work);
+    struct c0_ingest_build_set *set = job->c0ib_set;
+
+    if (atomic_cas(&job->c0ib_claimed, 0, 1))
+        c0sk_ingest_build_job(job);
+
+    mutex_lock(&set->cibs_lock);
+    if (--set->cibs_pending == 0)
+        cv_signal(&set->cibs_cv);
+    mutex_unlock(&set->cibs_lock);
+}
+
+/* Return the index one past the run of entries for kvs skidx that begins at
+ * start.  The entries of a cn list are sorted by skidx and then by key.
+ */
+static size_t
+c0sk_ingest_build_end(struct bkv_collection *list, size_t start, uint16_t skidx)
+{
+    size_t lo = start, hi = bkv_collection_count(list);
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        struct bonsai_kv *bkv = bkv_collection_bkv_get(list, mid);
+
+        if (key_immediate_index(&bkv->bkv_key_imm) > skidx)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return lo;
+}
+
+/**
+ * c0sk_ingest_build() - Build the kvsets of an ingest
+ *
+ * @c0sk:    c0sk
+ * @ingest:  ingest work
+ * @cn_list: cn lists produced by the ingest's merge loops
+ *
+ * The entries of the cn lists are partitioned by kvs, each partition being
+ * merged and added to its kvs' kvset builder by a separate job.  The jobs are
+ * independent of one another, hence all but the first are offered to the build
+ * workqueue while the ingest thread runs the first, after which the ingest thread
+ * runs whichever jobs have not yet been picked up rather than wait for them.
+ * Only the subsequent cndb/cn update must proceed in ingest order.
+ */
+static merr_t
+c0sk_ingest_build(
+    struct c0sk_impl *c0sk,
+    struct c0_ingest_work *ingest,
+    struct bkv_collection **cn_list)
+{
+    struct c0_ingest_build_set set;
+    size_t posv[2] = { 0, 0 };
+    size_t cntv[2];
+    uint jobc = 0;
+    merr_t err = 0;
+
+    for (int i = 0; i < 2; i++) {
+        cntv[i] = bkv_collection_count(cn_list[i]);
+        set.cibs_listv[i] = cn_list[i];
+    }
+
+    while (posv[0] < cntv[0] || posv[1] < cntv[1]) {
+        struct c0_ingest_build *job = ingest->c0iw_buildv + jobc++;
+        uint16_t skidx = UINT16_MAX;
+
+        assert(jobc <= NELEM(ingest->c0iw_buildv));
+
+        for (int i = 0; i < 2; i++) {
+            if (posv[i] < cntv[i]) {
+                struct bonsai_kv *bkv = bkv_collection_bkv_get(cn_list[i], posv[i]);
+
+                skidx = min_t(uint16_t, skidx, key_immediate_index(&bkv->bkv_key_imm));
+            }
+        }
+
+        for (int i = 0; i < 2; i++) {
+            job->c0ib_startv[i] = posv[i];
+            posv[i] = c0sk_ingest_build_end(cn_list[i], posv[i], skidx);
+            job->c0ib_endv[i] = posv[i];
+        }
+
+        job->c0ib_ingest = ingest;
+        job->c0ib_thr_tls = NULL;
+        job->c0ib_kbytes = 0;
+        job->c0ib_vbytes = 0;
+        job->c0ib_err = 0;
+        job->c0ib_set = &set;
+        atomic_set(&job->c0ib_claimed, 0);
+    }
+
+    ingest->c0iw_buildc = jobc;
+    ingest->c0iw_thr_sensor = c0sk->c0sk_sensor;
+
+    mutex_init(&set.cibs_lock);
+    cv_init(&set.cibs_cv);
+    set.cibs_pending = 0;
+
+    if (c0sk->c0sk_wq_build && jobc > 1) {
+        set.cibs_pending = jobc - 1;
+
+        for (uint j = 1; j < jobc; j++) {
+            INIT_WORK(&ingest->c0iw_buildv[j].c0ib_work, c0sk_ingest_build_worker);
+            queue_work(c0sk->c0sk_wq_build, &ingest->c0iw_buildv[j].c0ib_work);
+        }
+    }
+
+    for (uint j = 0; j < jobc; j++) {
+        struct c0_ingest_build *job = ingest->c0iw_buildv + j;
+
+        if (atomic_cas(&job->c0ib_claimed, 0, 1))
+            c0sk_ingest_build_job(job);
+    }
+
+    /* Wait for the queued work to complete as it references set.
+     */
+    mutex_lock(&set.cibs_lock);
+    while (set.cibs_pending > 0)
+        cv_wait(&set.cibs_cv, &set.cibs_lock, "c0bldwt");
+    mutex_unlock(&set.cibs_lock);
+
+    cv_destroy(&set.cibs_cv);
+    mutex_destroy(&set.cibs_lock);
+
+    for (uint j = 0; j < jobc && !err; j++)
+        err = ingest->c0iw_buildv[j].c0ib_err;
+
+    return err;
+}
+
 /**
  * c0sk_ingest_worker() - Ingest worker thread
  *
@@ -578,9 +769,10 @@ c0sk_merge_loop(
  *  2. Iterate over kv-pairs in LC and add them to cn_list[1] if they are ready for ingest.
  *  3. Update LC with the entries in lc_list.
  *  4. Merge cn_list[0] and cn_list[1] and add the resulting list of kv-pairs to cn using kvset
- *     builders.
+ *     builders.  This step runs concurrently for each kvs (see c0sk_ingest_build()).
  *
- * For all ingests, steps 2 and 3 need to be performed in ingest queuing order.
+ * For all ingests, steps 2 and 3 need to be performed in ingest queuing order, as does
+ * the update of cn with the resulting kvsets.
  */
 void
 c0sk_ingest_worker(struct work_struct *work)
@@ -630,8 +822,10 @@ c0sk_ingest_worker(struct work_struct *work)
     if (debug)
         ingest->t0 = get_time_ns();
 
+    /* The callback's context is supplied per build job, see c0sk_ingest_build().
+     */
     for (i = 0; i < 2; i++) {
-        err = bkv_collection_create(&cn_list[i], CN_INGEST_BKV_CNT, &c0sk_cningest_cb, ingest);
+        err = bkv_collection_create(&cn_list[i], CN_INGEST_BKV_CNT, &c0sk_cningest_cb, NULL);
         if (ev(err))
             goto health_err;
     }
@@ -705,28 +899,10 @@ c0sk_ingest_worker(struct work_struct *work)
 
     ingest->t6 = get_time_ns();
 
-    /* Initialize the per-thread throttle state so that c0sk_cningest_cb() (called
-     * repeatedly by bkv_collection_finish_pair()) can update the c0sk throttle
-     * sensor with the observed spill rate.
-     */
-    if (c0sk->c0sk_sensor) {
-        ingest->c0iw_thr_sensor = c0sk->c0sk_sensor;
-        ingest->c0iw_thr_tls = &hse_throttle_tls;
-        ingest->c0iw_thr_tls->bytes = 0;
-        ingest->c0iw_thr_tls->cntrgen = atomic_read_acq(ingest->c0iw_thr_sensor->ts_cntrgenp);
-        ingest->c0iw_mask = (32ul << 20) - 1;
-    } else {
-        ingest->c0iw_mask = UINT64_MAX;
-    }
-
-    err = bkv_collection_finish_pair(cn_list[0], cn_list[1]);
+    err = c0sk_ingest_build(c0sk, ingest, cn_list);
     if (ev(err))
         goto health_err;
 
-    /* Prevent any other thread from accessing this thread's local storage via c0iw_thr_tls.
-     */
-    ingest->c0iw_thr_tls = NULL;
-
     ingest->t7 = get_time_ns();
 
     for (i = 0; i < HSE_KVS_COUNT_MAX; ++i) {
@@ -44,6 +44,7 @@ struct c0sk {
  * @c0sk_ds:              mpool dataset
  * @c0sk_wq_ingest        workqueue for ingest processing (one thread)
  * @c0sk_wq_maint         workqueue for concurrent maintenance tasks
+ * @c0sk_wq_build         workqueue for concurrent kvset builds (may be NULL)
  * @c0sk_kvdb_seq:        kvdb seqno
  * @c0sk_closing:         set to %true when c0sk is closing
  * @c0sk_pc_op:           perf counter for c0sk
@@ -75,6 +76,7 @@ struct c0sk_impl {
     struct mpool            *c0sk_ds;      /* not owned by c0sk */
     struct workqueue_struct *c0sk_wq_ingest;
     struct workqueue_struct *c0sk_wq_maint;
+    struct workqueue_struct *c0sk_wq_build;
     struct kvdb_health      *c0sk_kvdb_health;
     struct kvdb_callback    *c0sk_cb;
     struct csched           *c0sk_csched;
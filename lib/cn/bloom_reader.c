@@ -4,6 +4,7 @@
  */
 
 #include <hse/util/bloom_filter.h>
+#include <hse/util/fuse_filter.h>
 #include <hse/util/page.h>
 
 #include "bloom_reader.h"
@@ -26,9 +27,58 @@ bloom_reader_lookup(const struct bloom_desc *desc, uint64_t hash)
     if (!bitmap)
         return true;
 
+    if (desc->bd_fuse)
+        return ff_lookup(
+            hash, bitmap, desc->bd_ff_fpbits, desc->bd_ff_seed, desc->bd_ff_seglen_shift,
+            desc->bd_ff_seg_count_len);
+
     bkt = bf_hash2bkt(hash, desc->bd_modulus, desc->bd_bktshift);
 
     bitmap += (bkt / PAGE_SIZE) * PAGE_SIZE + (bkt % PAGE_SIZE);
 
+    if (HSE_LIKELY(desc->bd_split))
+        return bf_sb_lookup(hash, bitmap, desc->bd_n_hashes);
+
     return bf_lookup(hash, bitmap, desc->bd_n_hashes, desc->bd_rotl, desc->bd_bktmask);
 }
+
+void
+bloom_reader_prefetch(const struct bloom_desc *desc, uint64_t hash)
+{
+    const uint8_t *bitmap = desc->bd_bitmap;
+    size_t bkt;
+
+    if (!bitmap)
+        return;
+
+    if (desc->bd_fuse) {
+        const uint32_t fpsz = desc->bd_ff_fpbits / 8;
+        uint32_t slotv[FF_ARITY];
+
+        ff_hash2slots(
+            ff_mix(hash, desc->bd_ff_seed), desc->bd_ff_seglen_shift, desc->bd_ff_seg_count_len,
+            slotv);
+
+        for (uint i = 0; i < FF_ARITY; ++i)
+            __builtin_prefetch(bitmap + slotv[i] * fpsz);
+        return;
+    }
+
+    bkt = bf_hash2bkt(hash, desc->bd_modulus, desc->bd_bktshift);
+
+    __builtin_prefetch(bitmap + bkt);
+}
+
+void
+bloom_reader_lookup_batch(
+    const struct bloom_desc *const *descv,
+    const uint64_t *hashv,
+    uint n,
+    bool *hitv)
+{
+    for (uint i = 0; i < n; ++i)
+        bloom_reader_prefetch(descv[i], hashv[i]);
+
+    for (uint i = 0; i < n; ++i)
+        hitv[i] = bloom_reader_lookup(descv[i], hashv[i]);
+}
@@ -8,13 +8,21 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <sys/types.h>
 
 /**
  * struct bloom_desc - a descriptor for reading data from a Bloom filter
- * @bd_bitmap:      base address of bloom filter data in virtual memory
- * @bd_n_pages:     size of data region in pages
+ * @bd_bitmap:           base address of bloom filter data in virtual memory
+ * @bd_n_pages:          size of data region in pages
  * @bd_n_hashes:
- * @bd_first_page:  offset, in pages, from start of mblock to data region
+ * @bd_first_page:       offset, in pages, from start of mblock to data region
+ * @bd_split:            bloom uses the split-block layout (BLOOM_OMF_VERSION6+)
+ * @bd_fuse:             filter is a binary fuse filter (BLOOM_OMF_VERSION7+)
+ * @bd_ff_fpbits:        fuse filter bits per fingerprint
+ * @bd_ff_seglen_shift:  fuse filter log2 of the segment length
+ * @bd_ff_seg_count_len: fuse filter number of slots from which a key's first
+ *                       slot is chosen
+ * @bd_ff_seed:          fuse filter seed
  *
  * When a kblock is opened for reading, the @bloom_hdr_omf struct is read from
  * media and the relevant information is stored in a @bloom_desc struct.
@@ -24,6 +32,10 @@
  *    So, if @bd_first_page=2 and @bd_n_pages=3, then the Bloom
  *    filter data region occupies pages 2,3 and 4 -- which maps
  *    to bytes 2*4096 to 5*4096-1 (end of page 4).
+ *  - @bd_fuse selects the filter type.  The bloom-only fields (@bd_modulus,
+ *    @bd_bktshift, @bd_n_hashes, @bd_rotl, @bd_bktmask and @bd_split) of a
+ *    fuse filter descriptor are zero, as are the @bd_ff_ fields of a bloom
+ *    descriptor.
  */
 struct bloom_desc {
     uint8_t *bd_bitmap;
@@ -35,6 +47,12 @@ struct bloom_desc {
     uint32_t bd_bktmask;
     uint32_t bd_first_page;
     uint32_t bd_bktsz;
+    bool bd_split;
+    bool bd_fuse;
+    uint32_t bd_ff_fpbits;
+    uint32_t bd_ff_seglen_shift;
+    uint32_t bd_ff_seg_count_len;
+    uint64_t bd_ff_seed;
 };
 
 /**
@@ -45,4 +63,34 @@ struct bloom_desc {
 bool
 bloom_reader_lookup(const struct bloom_desc *desc, uint64_t hash);
 
+/**
+ * bloom_reader_prefetch() - prefetch the bloom bucket for a hash
+ * @desc:  bloom descriptor
+ * @hash:  hash of key to be looked up
+ *
+ * Issues a prefetch for the bucket that a subsequent bloom_reader_lookup()
+ * of @hash will probe.
+ */
+void
+bloom_reader_prefetch(const struct bloom_desc *desc, uint64_t hash);
+
+/**
+ * bloom_reader_lookup_batch() - probe a batch of bloom filters
+ * @descv:  bloom descriptors
+ * @hashv:  hash of the key to lookup in the corresponding descriptor
+ * @n:      number of elements in @descv and @hashv
+ * @hitv:   (output) result of bloom_reader_lookup() for each element
+ *
+ * Prefetches the buckets for all probes before evaluating any of them so
+ * that the cache misses overlap rather than serialize.  The same descriptor
+ * or hash may appear more than once, so this serves both N keys probed in
+ * one filter and one key probed in M filters.
+ */
+void
+bloom_reader_lookup_batch(
+    const struct bloom_desc *const *descv,
+    const uint64_t *hashv,
+    uint n,
+    bool *hitv);
+
 #endif
@@ -63,6 +63,7 @@
 #include "kv_iterator.h"
 #include "kvset.h"
 #include "kvset_internal.h"
+#include "mbcache.h"
 #include "omf.h"
 #include "route.h"
 #include "spill.h"
@@ -98,16 +99,23 @@ cn_init(void)
     if (err)
         goto cn_tree_cleanup;
 
+    err = mbcache_init();
+    if (err)
+        goto kvset_cleanup;
+
     sz = sizeof(struct cn_cursor);
     cache = kmem_cache_create("cn_cursor", sz, alignof(struct cn_cursor), SLAB_PACKED, NULL);
     if (ev(!cache)) {
         err = merr(ENOMEM);
-        goto kvset_cleanup;
+        goto mbcache_cleanup;
     }
 
     cn_cursor_cache = cache;
     return 0;
 
+mbcache_cleanup:
+    mbcache_fini();
+
 kvset_cleanup:
     kvset_fini();
 
@@ -129,6 +137,7 @@ cn_fini(void)
     kmem_cache_destroy(cn_cursor_cache);
     cn_cursor_cache = NULL;
 
+    mbcache_fini();
     kvset_fini();
     cn_tree_fini();
     ib_fini();
@@ -138,13 +147,24 @@ cn_fini(void)
 uint64_t
 cn_get_ingest_dgen(struct cn *cn)
 {
-    return atomic_read(&cn->cn_ingest_dgen);
+    return atomic_read_acq(&cn->cn_ingest_dgen);
+}
+
+uint64_t
+cn_get_ingest_seqno_max(struct cn *cn)
+{
+    return atomic_read(&cn->cn_ingest_seqno_max);
 }
 
 void
-cn_inc_ingest_dgen(struct cn *cn)
+cn_inc_ingest_dgen(struct cn *cn, uint64_t seqno_max)
 {
-    atomic_inc(&cn->cn_ingest_dgen);
+    if (seqno_max > atomic_read(&cn->cn_ingest_seqno_max))
+        atomic_set(&cn->cn_ingest_seqno_max, seqno_max);
+
+    /* Publish the seqno max before the new dgen.
+     */
+    atomic_inc_rel(&cn->cn_ingest_dgen);
 }
 
 struct kvs_rparams *
@@ -315,6 +335,12 @@ cn_cp2cflags(const struct kvs_cparams *cp)
     if (cp->kvs_ext01)
         flags |= CN_CFLAG_CAPPED;
 
+    if (cp->filter_type == KVS_FILTER_FUSE)
+        flags |= CN_CFLAG_FUSE;
+
+    if (cp->hash_index)
+        flags |= CN_CFLAG_HIX;
+
     return flags;
 }
 
@@ -340,15 +366,60 @@ cn_get_cparams(const struct cn *handle)
     return handle->cp;
 }
 
+void
+cn_set_merge_fn(struct cn *cn, hse_kvs_merge_fn *fn)
+{
+    cn->cn_merge_fn = fn;
+}
+
+hse_kvs_merge_fn *
+cn_get_merge_fn(const struct cn *cn)
+{
+    return cn->cn_merge_fn;
+}
+
+void
+cn_set_ingest_inval(struct cn *cn, cn_ingest_inval_fn *fn, void *arg)
+{
+    cn->cn_inval_arg = arg;
+    cn->cn_inval_fn = fn;
+}
+
+void
+cn_ingest_inval(struct cn *cn, const void *key, uint klen, uint64_t seqno, bool ptomb)
+{
+    if (cn->cn_inval_fn)
+        cn->cn_inval_fn(cn->cn_inval_arg, key, klen, seqno, ptomb);
+}
+
 merr_t
 cn_get(
     struct cn *cn,
     struct kvs_ktuple *kt,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
+{
+    return cn_tree_lookup(cn->cn_tree, &cn->cn_pc_get, kt, seq, res, NULL, vbuf, seqnop);
+}
+
+merr_t
+cn_get_many(
+    struct cn *cn,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
 {
-    return cn_tree_lookup(cn->cn_tree, &cn->cn_pc_get, kt, seq, res, NULL, vbuf);
+    return cn_tree_lookup_many(cn->cn_tree, &cn->cn_pc_get, keyc, ktv, seq, resv, vbufv);
+}
+
+merr_t
+cn_get_async(struct cn *cn, struct kvs_ktuple *kt, uint64_t seq, struct cn_get_aio *aio)
+{
+    return cn_tree_lookup_async(cn->cn_tree, &cn->cn_pc_get, kt, seq, aio);
 }
 
 merr_t
@@ -756,6 +827,7 @@ struct cndb_cn_ctx {
     struct cn_tree *tree;
     struct map *nodemap;
     uint64_t max_dgen;
+    uint64_t max_seqno;
 };
 
 static merr_t
@@ -782,6 +854,7 @@ cndb_cn_ctx_init(struct cndb_cn_ctx *ctx, struct cn_tree *tree, struct cn_tree_n
     ctx->nodemap = nodemap;
     ctx->tree = tree;
     ctx->max_dgen = 0;
+    ctx->max_seqno = 0;
 
     return 0;
 }
@@ -836,6 +909,9 @@ cndb_cn_callback(void *arg, struct kvset_meta *km, uint64_t kvsetid)
     if (ctx->max_dgen < km->km_dgen_hi)
         ctx->max_dgen = km->km_dgen_hi;
 
+    if (ctx->max_seqno < kvset_get_seqno_max(kvset))
+        ctx->max_seqno = kvset_get_seqno_max(kvset);
+
     return 0;
 }
 
@@ -1008,6 +1084,7 @@ cn_open(
 
     err = cndb_cn_instantiate(cndb, cnid, &ctx, cndb_cn_callback);
     atomic_set(&cn->cn_ingest_dgen, ctx.max_dgen);
+    atomic_set(&cn->cn_ingest_seqno_max, ctx.max_seqno);
     cndb_cn_ctx_fini(&ctx);
     if (ev(err))
         goto err_exit;
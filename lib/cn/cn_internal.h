@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <hse/experimental.h>
 #include <hse/limits.h>
 
 #include <hse/mpool/mpool.h>
@@ -33,6 +34,7 @@ struct cn {
     uint64_t cn_cnid;
 
     atomic_ulong cn_ingest_dgen;
+    atomic_ulong cn_ingest_seqno_max;
 
     atomic_int cn_refcnt;
     bool cn_replay;
@@ -68,6 +70,10 @@ struct cn {
 
     uint32_t cn_cflags;
 
+    hse_kvs_merge_fn *cn_merge_fn;
+    cn_ingest_inval_fn *cn_inval_fn;
+    void *cn_inval_arg;
+
     const char *cn_kvdb_alias;
     const char *cn_kvs_name;
 
@@ -22,6 +22,7 @@ struct perfc_name cn_perfc_get[] _dt_section = {
     NE(PERFC_RA_CNGET_TOMB,      2, "cN lookup tomb hit rate",       "c_tmb(/s)"),
     NE(PERFC_RA_CNGET_PTOMB,     2, "cN lookup ptomb hit rate",      "r_cnget_ptmb(/s)"),
     NE(PERFC_RA_CNGET_MULTIPLE,  2, "cN lookup multiple hit rate",   "r_cnget_multiple(/s)"),
+    NE(PERFC_RA_CNGET_MOPND,     2, "cN lookup merge operand rate",  "r_cnget_mopnd(/s)"),
 
     /* ROOT must be active for LEAF to record.
      */
@@ -78,6 +79,8 @@ static_assert(PERFC_RA_CNGET_PTOMB == 4 && FOUND_PTMB == 4,
               "PERFC_RA_CNGET_PTOMB out of sync with enum key_lookup_res");
 static_assert(PERFC_RA_CNGET_MULTIPLE == 5 && FOUND_MULTIPLE == 5,
               "PERFC_RA_CNGET_FMULT out of sync with enum key_lookup_res");
+static_assert(PERFC_RA_CNGET_MOPND == 6 && FOUND_MOPND == 6,
+              "PERFC_RA_CNGET_MOPND out of sync with enum key_lookup_res");
 
 /* clang-format on */
 
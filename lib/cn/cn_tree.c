@@ -102,6 +102,8 @@ cn_node_alloc(struct cn_tree *tree, uint64_t nodeid)
 
     tn->tn_split_size = (size_t)tree->rp->cn_split_size << 30;
     atomic_set(&tn->tn_readers, 0);
+    atomic_set(&tn->tn_heat_reads, 0);
+    atomic_set(&tn->tn_heat, 0);
 
     INIT_LIST_HEAD(&tn->tn_kvset_list);
 
@@ -973,6 +975,7 @@ cn_tree_prefix_probe(
             if (qctx->seen > 1 || *res == FOUND_PTMB) {
                 if (!atomic_read(&node->tn_readers))
                     atomic_inc(&node->tn_readers);
+                cn_node_heat_record(node);
                 goto done;
             }
         }
@@ -1020,16 +1023,18 @@ done:
  * @qctx: query context (if this is a prefix probe)
  * @kbuf: (output) key if this is a prefix probe
  * @vbuf: (output) value if result @res == %FOUND_VAL or %FOUND_MULTIPLE
+ * @seqnop: (output) seqno of the operand if @res == %FOUND_MOPND (optional)
  */
-merr_t
-cn_tree_lookup(
+static merr_t
+cn_tree_lookup_impl(
     struct cn_tree *tree,
     struct perfc_set *pc,
     struct kvs_ktuple *kt,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *kbuf,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop,
+    struct cn_get_aio *aio)
 {
     enum kvdb_perfc_sidx_cnget pc_cidx;
     struct cn_tree_node *node;
@@ -1056,24 +1061,47 @@ cn_tree_lookup(
 
     while (node) {
         struct kvset_list_entry *le;
+        uint runmax = KVSET_FILTER_MIN;
 
-        /* Search kvsets from newest to oldest (head to tail).
+        le = list_first_entry_or_null(&node->tn_kvset_list, typeof(*le), le_link);
+
+        /* Search kvsets from newest to oldest (head to tail), filtering
+         * each run of kvsets through their blooms in a single pass.  The
+         * first run is short since the key is often in a recent kvset,
+         * and each subsequent run is twice as long (up to KVSET_FILTER_MAX).
          * If an error occurs or a key is found, return immediately.
          */
-        list_for_each_entry(le, &node->tn_kvset_list, le_link) {
-            struct kvset *kvset = le->le_kvset;
+        while (le) {
+            struct kvset *kvsetv[KVSET_FILTER_MAX];
+            int kblkv[KVSET_FILTER_MAX];
+            uint kvsetc = 0;
+
+            while (le && kvsetc < runmax) {
+                kvsetv[kvsetc++] = le->le_kvset;
+                le = list_next_entry_or_null(le, le_link, &node->tn_kvset_list);
+            }
 
-            err = kvset_lookup(kvset, kt, &kdisc, seq, res, vbuf);
-            if (err)
-                goto done;
+            runmax = min_t(uint, runmax * 2, NELEM(kvsetv));
 
-            if (*res != NOT_FOUND) {
-                if (!atomic_read(&node->tn_readers))
-                    atomic_inc(&node->tn_readers);
-                goto done;
-            }
+            kvset_lookup_filter(kvsetv, kvsetc, kt, &kdisc, kblkv);
 
-            pc_cidx++;
+            for (uint i = 0; i < kvsetc; i++) {
+                if (aio)
+                    err = kvset_lookup_async(kvsetv[i], kt, kblkv[i], seq, res, aio);
+                else
+                    err = kvset_lookup(kvsetv[i], kt, kblkv[i], seq, res, vbuf, seqnop);
+                if (err)
+                    goto done;
+
+                if (*res != NOT_FOUND) {
+                    if (!atomic_read(&node->tn_readers))
+                        atomic_inc(&node->tn_readers);
+                    cn_node_heat_record(node);
+                    goto done;
+                }
+
+                pc_cidx++;
+            }
         }
 
         if (cn_node_isleaf(node))
@@ -1099,6 +1127,198 @@ done:
     return err;
 }
 
+merr_t
+cn_tree_lookup(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    struct kvs_ktuple *kt,
+    uint64_t seq,
+    enum key_lookup_res *res,
+    struct kvs_buf *kbuf,
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
+{
+    return cn_tree_lookup_impl(tree, pc, kt, seq, res, vbuf, seqnop, NULL);
+}
+
+merr_t
+cn_tree_lookup_async(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    struct kvs_ktuple *kt,
+    uint64_t seq,
+    struct cn_get_aio *aio)
+{
+    merr_t err;
+
+    aio->cga_kvset = NULL;
+    aio->cga_err = 0;
+
+    err = cn_tree_lookup_impl(tree, pc, kt, seq, &aio->cga_res, aio->cga_vbuf, NULL, aio);
+    if (err) {
+        assert(!aio->cga_kvset);
+        return err;
+    }
+
+    /* The value read (if any) is issued only after the tree lock has
+     * been released, as it may complete on this call stack.
+     */
+    if (aio->cga_kvset)
+        kvset_lookup_val_async(aio);
+    else
+        aio->cga_cb(aio);
+
+    return 0;
+}
+
+static int
+kvset_lookup_key_cmp(const void *lhs, const void *rhs)
+{
+    const struct kvset_lookup_key *l = lhs, *r = rhs;
+
+    if (l->lk_node->tn_nodeid != r->lk_node->tn_nodeid)
+        return l->lk_node->tn_nodeid < r->lk_node->tn_nodeid ? -1 : 1;
+
+    return 0;
+}
+
+/* Search the given node's kvsets (from newest to oldest) for all the keys
+ * in keyv[].  Keys resolved by a newer kvset are skipped by the older ones.
+ */
+static merr_t
+cn_tree_node_lookup_batch(
+    struct cn_tree_node *node,
+    uint64_t seq,
+    struct kvset_lookup_key *keyv,
+    uint keyc)
+{
+    struct kvset_list_entry *le;
+    uint pending = keyc;
+    merr_t err;
+    uint i;
+
+    list_for_each_entry(le, &node->tn_kvset_list, le_link) {
+        err = kvset_lookup_batch(le->le_kvset, seq, keyv, keyc);
+        if (err)
+            return err;
+
+        for (i = pending = 0; i < keyc; ++i)
+            pending += (*keyv[i].lk_res == NOT_FOUND);
+
+        if (!pending)
+            break;
+    }
+
+    if (pending < keyc) {
+        if (!atomic_read(&node->tn_readers))
+            atomic_inc(&node->tn_readers);
+        cn_node_heat_record(node);
+    }
+
+    return 0;
+}
+
+merr_t
+cn_tree_lookup_many(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct kvset_lookup_key keyv[HSE_KVS_GET_MANY_BATCH];
+    uint64_t pc_start;
+    void *lock;
+    merr_t err = 0;
+    uint i, j;
+
+    static_assert(HSE_KVS_GET_MANY_BATCH <= 64, "HSE_KVS_GET_MANY_BATCH too large for searchmask");
+
+    pc_start = perfc_lat_startu(pc, PERFC_LT_CNGET_GET);
+
+    /* Hold the tree lock across all batches so that the route map and
+     * kvset lists are acquired once for the entire set of keys.
+     */
+    rmlock_rlock(&tree->ct_lock, &lock);
+
+    for (i = 0; i < keyc && !err; i += HSE_KVS_GET_MANY_BATCH) {
+        uint n = min_t(uint, keyc - i, HSE_KVS_GET_MANY_BATCH);
+        uint64_t searchmask = 0;
+        uint cnt = 0;
+
+        for (j = 0; j < n; ++j) {
+            struct kvset_lookup_key *lk = keyv + cnt;
+
+            if (resv[i + j] != NOT_FOUND)
+                continue;
+
+            lk->lk_kt = ktv + i + j;
+            lk->lk_res = resv + i + j;
+            lk->lk_vbuf = vbufv + i + j;
+            lk->lk_node = tree->ct_root;
+            key_disc_init(lk->lk_kt->kt_data, lk->lk_kt->kt_len, &lk->lk_kdisc);
+            searchmask |= (1ul << j);
+            ++cnt;
+        }
+
+        if (!cnt)
+            continue;
+
+        err = cn_tree_node_lookup_batch(tree->ct_root, seq, keyv, cnt);
+        if (cn_node_isleaf(tree->ct_root))
+            cnt = 0;
+
+        /* Route the keys not resolved by the root node to their leaf
+         * nodes, then group them by leaf node so that each leaf's kvset
+         * list is walked only once for the entire batch.
+         */
+        for (j = 0, n = cnt, cnt = 0; j < n && !err; ++j) {
+            struct kvset_lookup_key *lk = keyv + j;
+
+            if (*lk->lk_res != NOT_FOUND)
+                continue;
+
+            lk->lk_node = cn_tree_node_lookup(tree, lk->lk_kt->kt_data, lk->lk_kt->kt_len);
+            if (lk->lk_node)
+                keyv[cnt++] = *lk;
+        }
+
+        if (cnt > 1)
+            qsort(keyv, cnt, sizeof(*keyv), kvset_lookup_key_cmp);
+
+        for (j = 0; j < cnt && !err;) {
+            struct cn_tree_node *node = keyv[j].lk_node;
+            uint k = j + 1;
+
+            while (k < cnt && keyv[k].lk_node == node)
+                ++k;
+
+            err = cn_tree_node_lookup_batch(node, seq, keyv + j, k - j);
+            j = k;
+        }
+
+        while (searchmask) {
+            j = __builtin_ctzl(searchmask);
+            searchmask &= searchmask - 1;
+
+            if (pc_start > 0) {
+                uint pc_cidx_lt = (resv[i + j] == NOT_FOUND) ? PERFC_LT_CNGET_MISS
+                                                             : PERFC_LT_CNGET_GET;
+
+                perfc_lat_record(pc, pc_cidx_lt, pc_start);
+            }
+
+            perfc_inc(pc, resv[i + j]);
+        }
+    }
+
+    rmlock_runlock(lock);
+
+    return err;
+}
+
 bool
 cn_tree_is_capped(const struct cn_tree *tree)
 {
@@ -2767,7 +2987,7 @@ cn_tree_ingest_update(
     kwlen = kvset_get_kwlen(kvset);
     vwlen = kvset_get_vwlen(kvset);
 
-    cn_inc_ingest_dgen(tree->cn);
+    cn_inc_ingest_dgen(tree->cn, kvset_get_seqno_max(kvset));
 
     /* Record ptomb as the max ptomb seen by this cn */
     if (cn_get_flags(tree->cn) & CN_CFLAG_CAPPED) {
@@ -2856,6 +3076,9 @@ cn_tree_node_mclass(struct cn_tree_node *tn, enum hse_mclass_policy_dtype dtype)
     policy = cn_get_mclass_policy(tn->tn_tree->cn);
     age = cn_node_isroot(tn) ? HSE_MPOLICY_AGE_ROOT : HSE_MPOLICY_AGE_LEAF;
 
+    if (dtype == HSE_MPOLICY_DTYPE_VALUE && cn_node_ishot(tn, tn->tn_tree->rp))
+        age = HSE_MPOLICY_AGE_ROOT;
+
     return mclass_policy_get_type(policy, age, dtype);
 }
 
@@ -2866,7 +3089,7 @@ cn_tree_node_scatter(const struct cn_tree_node *tn)
     uint scatter = 0;
 
     list_for_each_entry_reverse(le, &tn->tn_kvset_list, le_link) {
-        const uint vgroups = kvset_get_vgroups(le->le_kvset);
+        const uint vgroups = kvset_get_scatter(le->le_kvset);
 
         /* Exclude oldest kvsets with no scatter.
          */
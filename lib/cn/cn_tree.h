@@ -21,6 +21,7 @@ struct cn_tree;
 struct cn_tree_node;
 enum key_lookup_res;
 struct kvs_buf;
+struct cn_get_aio;
 struct kvs_ktuple;
 struct perfc_set;
 struct query_ctx;
@@ -43,7 +44,44 @@ cn_tree_lookup(
     uint64_t seq,
     enum key_lookup_res *res,
     struct kvs_buf *kbuf,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
+
+/**
+ * cn_tree_lookup_many() - search cn tree for a batch of keys
+ * @tree: cn tree
+ * @pc:   perf counters
+ * @keyc: number of keys
+ * @ktv:  vector of keys to search for
+ * @seq:  view sequence number
+ * @resv: (in/out) vector of results, only keys with NOT_FOUND are searched
+ * @vbufv: (output) vector of values for keys found with %FOUND_VAL
+ */
+merr_t
+cn_tree_lookup_many(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
+/**
+ * cn_tree_lookup_async() - search cn tree for a key, reading its value asynchronously
+ * @tree: cn tree
+ * @pc:   perf counters
+ * @kt:   key to search for
+ * @seq:  view sequence number
+ * @aio:  get request (see cn_get_async())
+ */
+merr_t
+cn_tree_lookup_async(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    struct kvs_ktuple *kt,
+    uint64_t seq,
+    struct cn_get_aio *aio);
 
 /* MTF_MOCK */
 merr_t
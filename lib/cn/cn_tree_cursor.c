@@ -649,6 +649,7 @@ merr_t
 cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool *eof)
 {
     struct cn_kv_item *item;
+    enum kmd_vtype vtype;
     uint64_t seq;
     bool found;
     const void *vdata;
@@ -670,7 +671,6 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
         key2kobj(&filter_ko, cur->cncur_filter->kcf_maxkey, cur->cncur_filter->kcf_maxklen);
 
     do {
-        enum kmd_vtype vtype;
         uint32_t vbidx;
         uint32_t vboff;
         bool more;
@@ -749,7 +749,10 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
     } while (!found);
 
     elem->kce_kobj = item->kobj;
-    kvs_vtuple_init(&elem->kce_vt, (void *)vdata, vlen);
+    if (vtype == VTYPE_MOPND)
+        kvs_vtuple_minit(&elem->kce_vt, (void *)vdata, vlen);
+    else
+        kvs_vtuple_init(&elem->kce_vt, (void *)vdata, vlen);
     elem->kce_complen = complen;
     elem->kce_is_ptomb = false; /* cn never returns a ptomb */
     elem->kce_seqnoref = HSE_ORDNL_TO_SQNREF(seq);
@@ -12,8 +12,11 @@
 
 #include <hse/limits.h>
 
+#include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/mclass_policy.h>
 #include <hse/ikvdb/sched_sts.h>
+#include <hse/util/atomic.h>
+#include <hse/util/compiler.h>
 #include <hse/util/list.h>
 #include <hse/util/mutex.h>
 #include <hse/util/rmlock.h>
@@ -141,6 +144,8 @@ struct cn_tree {
  * @tn_split_size:   size in bytes at which the node should split
  * @tn_split_ns:     time beyond which a node may split again
  * @tn_readers:      non-zero if there have been readers in the node recently
+ * @tn_heat_reads:   sampled reads of the node since the last heat update
+ * @tn_heat:         read heat, decayed by half on each heat update
  * @tn_hlog:         hyperloglog structure
  * @tn_ns:           metrics about node to guide node compaction decisions
  * @tn_compacting:   true if if an exclusive job is running on this node
@@ -156,6 +161,8 @@ struct cn_tree_node {
     size_t tn_split_size;
     uint64_t tn_split_ns;
     atomic_uint tn_readers;
+    atomic_uint tn_heat_reads;
+    atomic_uint tn_heat;
 
     struct list_head tn_kvset_list HSE_L1D_ALIGNED;
     uint64_t tn_update_incr_dgen;
@@ -220,6 +227,43 @@ cn_node_isleaf(const struct cn_tree_node *tn)
     return !cn_node_isroot(tn);
 }
 
+/* Reads of a node are sampled into its heat such that the shared counter
+ * is updated on only one in CN_NODE_HEAT_SAMPLE reads (per thread).
+ */
+#define CN_NODE_HEAT_SAMPLE (16)
+
+static HSE_ALWAYS_INLINE void
+cn_node_heat_record(struct cn_tree_node *tn)
+{
+    static thread_local uint heat_tick_tls;
+
+    if (++heat_tick_tls % CN_NODE_HEAT_SAMPLE == 0)
+        atomic_add(&tn->tn_heat_reads, CN_NODE_HEAT_SAMPLE);
+}
+
+/* Fold the reads since the last update into the node's heat, which thereby
+ * approximates the number of reads of the node per update interval.
+ */
+static HSE_ALWAYS_INLINE void
+cn_node_heat_update(struct cn_tree_node *tn)
+{
+    const uint reads = atomic_read(&tn->tn_heat_reads);
+
+    atomic_sub(&tn->tn_heat_reads, reads);
+    atomic_set(&tn->tn_heat, ((uint64_t)atomic_read(&tn->tn_heat) + reads) / 2);
+}
+
+/* A leaf node is hot if its read heat has reached the kvs rparam
+ * cn_mclass_hot, in which case its values are placed on the media class
+ * of the root age group.
+ */
+static HSE_ALWAYS_INLINE bool
+cn_node_ishot(const struct cn_tree_node *tn, const struct kvs_rparams *rp)
+{
+    return tn && rp->cn_mclass_hot > 0 && cn_node_isleaf(tn) &&
+           atomic_read(&tn->tn_heat) >= rp->cn_mclass_hot;
+}
+
 enum hse_mclass
 cn_tree_node_mclass(struct cn_tree_node *tn, enum hse_mclass_policy_dtype dtype);
 
@@ -0,0 +1,344 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+
+#include <hse/ikvdb/cn.h>
+#include <hse/ikvdb/cndb.h>
+#include <hse/ikvdb/encoders.h>
+#include <hse/ikvdb/kvs_rparams.h>
+#include <hse/ikvdb/kvset_builder.h>
+#include <hse/ikvdb/sched_sts.h>
+#include <hse/util/alloc.h>
+#include <hse/util/condvar.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/minmax.h>
+#include <hse/util/mutex.h>
+
+#include "cn_metrics.h"
+#include "cn_tree.h"
+#include "cn_tree_compact.h"
+#include "cn_tree_internal.h"
+#include "compact_slice.h"
+#include "kv_iterator.h"
+#include "kvset.h"
+
+/* Shared by a compaction and the sts jobs it submitted for its slices.  The
+ * slices are allocated in the same block, which is freed by whichever of them
+ * drops the last reference.  A job that finds its slice already claimed by
+ * the compaction thread does not touch anything but its own sts_job.
+ */
+struct compact_slice_sync {
+    struct mutex css_lock;
+    struct cv css_cv;
+    uint css_running;
+    uint css_refcnt;
+};
+
+uint
+compact_slice_count(struct cn_compaction_work *w, bool vblocks)
+{
+    uint slicec = w->cw_rp->cn_compact_slices;
+    uint kblks_max = 0, vblks = 0;
+
+    if (slicec < 2 || w->cw_kvset_cnt == 0)
+        return 1;
+
+    if (cn_get_flags(cn_tree_get_cn(w->cw_tree)) & CN_CFLAG_CAPPED)
+        return 1;
+
+    for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+        const struct kvset *ks = kvset_iter_kvset_get(w->cw_inputv[i]);
+        const struct kvset_stats *stats = kvset_statsp(ks);
+
+        /* The effect of a prefix tombstone is not confined to the slice
+         * that contains it.
+         */
+        if (stats->kst_ptombs > 0)
+            return 1;
+
+        kblks_max = max_t(uint, kblks_max, stats->kst_kblks);
+        vblks += stats->kst_vblks;
+    }
+
+    /* Each slice should have at least a couple of kblocks worth of keys
+     * from the largest input kvset.
+     */
+    slicec = min_t(uint, slicec, kblks_max / 2);
+
+    /* Each slice records vblock indexes in a disjoint range in the output
+     * kblocks, ensure each range is large enough for all the values.
+     */
+    if (vblocks) {
+        while (slicec > 1 && 2 * vblks + 1 >= (HG16_32K_MAX + 1) / slicec)
+            --slicec;
+    }
+
+    return max_t(uint, slicec, 1);
+}
+
+static void
+compact_slice_sync_put(struct compact_slice_sync *sync)
+{
+    bool last;
+
+    mutex_lock(&sync->css_lock);
+    last = (--sync->css_refcnt == 0);
+    mutex_unlock(&sync->css_lock);
+
+    if (last) {
+        cv_destroy(&sync->css_cv);
+        mutex_destroy(&sync->css_lock);
+        free(sync);
+    }
+}
+
+static bool
+compact_slice_claim(struct compact_slice *cs)
+{
+    struct compact_slice_sync *sync = cs->cs_sync;
+    bool claimed;
+
+    mutex_lock(&sync->css_lock);
+    claimed = !cs->cs_claimed;
+    cs->cs_claimed = true;
+    mutex_unlock(&sync->css_lock);
+
+    return claimed;
+}
+
+static void
+compact_slice_job(struct sts_job *job)
+{
+    struct compact_slice *cs = container_of(job, struct compact_slice, cs_job);
+    struct compact_slice_sync *sync = cs->cs_sync;
+    bool claimed;
+
+    mutex_lock(&sync->css_lock);
+    claimed = !cs->cs_claimed;
+    cs->cs_claimed = true;
+    sync->css_running += claimed;
+    mutex_unlock(&sync->css_lock);
+
+    if (claimed) {
+        cs->cs_err = cs->cs_fn(cs);
+
+        mutex_lock(&sync->css_lock);
+        if (--sync->css_running == 0)
+            cv_signal(&sync->css_cv);
+        mutex_unlock(&sync->css_lock);
+    }
+
+    sts_job_done(job);
+    compact_slice_sync_put(sync);
+}
+
+static merr_t
+compact_slice_init(struct compact_slice *cs, uint idx, uint slicec, uint64_t vgroup)
+{
+    struct cn_compaction_work *w = cs->cs_work;
+    struct cn *cn = cn_tree_get_cn(w->cw_tree);
+    const uint stride = (HG16_32K_MAX + 1) / slicec;
+    merr_t err;
+
+    if (idx == 0) {
+        cs->cs_inputv = w->cw_inputv;
+        cs->cs_stats = &w->cw_stats;
+        cs->cs_progress = true;
+    } else {
+        cs->cs_inputv = calloc(w->cw_kvset_cnt, sizeof(*cs->cs_inputv));
+        if (ev(!cs->cs_inputv))
+            return merr(ENOMEM);
+
+        cs->cs_stats = &cs->cs_mstats;
+
+        for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+            struct kvset *ks = kvset_iter_kvset_get(w->cw_inputv[i]);
+            uint start, end;
+
+            kvset_kblk_range(ks, &cs->cs_lo, &cs->cs_hi, &start, &end);
+            if (start == end)
+                continue;
+
+            err = kvset_iter_create_range(
+                ks, w->cw_io_workq, cn_get_maint_wq(cn), w->cw_pc, w->cw_iter_flags, start, end,
+                &cs->cs_inputv[i]);
+            if (ev(err))
+                return err;
+
+            kvset_iter_set_stats(cs->cs_inputv[i], cs->cs_stats);
+        }
+    }
+
+    err = kvset_builder_create(&cs->cs_bldr, cn, w->cw_pc, vgroup);
+    if (ev(err))
+        return err;
+
+    err = kvset_builder_set_agegroup(cs->cs_bldr, HSE_MPOLICY_AGE_LEAF);
+    if (!err && cn_node_ishot(w->cw_node, w->cw_rp))
+        err = kvset_builder_set_value_agegroup(cs->cs_bldr, HSE_MPOLICY_AGE_ROOT);
+    if (ev(err))
+        return err;
+
+    kvset_builder_set_merge_stats(cs->cs_bldr, cs->cs_stats);
+    kvset_builder_set_vbidx_base(cs->cs_bldr, idx * stride, stride);
+
+    return 0;
+}
+
+static void
+compact_slice_fini(struct compact_slice *cs, uint idx)
+{
+    struct cn_compaction_work *w = cs->cs_work;
+
+    kvset_builder_destroy(cs->cs_bldr);
+
+    if (idx > 0 && cs->cs_inputv) {
+        for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+            if (cs->cs_inputv[i])
+                kvset_iter_release(cs->cs_inputv[i]);
+        }
+
+        free(cs->cs_inputv);
+    }
+}
+
+merr_t
+compact_slice_run(
+    struct cn_compaction_work *w,
+    uint slicec,
+    compact_slice_fn *fn,
+    struct kvset_builder *bldr)
+{
+    struct kvset_builder **bldrv;
+    struct compact_slice_sync *sync;
+    struct compact_slice *slicev;
+    const struct kvset *pivot = NULL;
+    struct sts *sts = w->cw_job.sj_sts;
+    uint kblks = 0;
+    merr_t err = 0;
+
+    if (slicec < 2) {
+        struct compact_slice cs = {
+            .cs_work = w,
+            .cs_inputv = w->cw_inputv,
+            .cs_bldr = bldr,
+            .cs_stats = &w->cw_stats,
+            .cs_progress = true,
+        };
+
+        err = fn(&cs);
+        w->cw_vbmap.vbm_used += cs.cs_vused;
+
+        return err;
+    }
+
+    sync = calloc(1, sizeof(*sync) + slicec * (sizeof(*slicev) + sizeof(*bldrv)));
+    if (ev(!sync))
+        return merr(ENOMEM);
+
+    mutex_init(&sync->css_lock);
+    cv_init(&sync->css_cv);
+    sync->css_refcnt = 1;
+
+    slicev = (void *)(sync + 1);
+    bldrv = (void *)(slicev + slicec);
+
+    /* The slice boundaries are the min keys of evenly spaced kblocks in the
+     * input kvset with the most kblocks.
+     */
+    for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+        const struct kvset *ks = kvset_iter_kvset_get(w->cw_inputv[i]);
+
+        if (kvset_statsp(ks)->kst_kblks > kblks) {
+            kblks = kvset_statsp(ks)->kst_kblks;
+            pivot = ks;
+        }
+    }
+
+    assert(pivot && kblks >= slicec);
+
+    for (uint j = 0; j < slicec; j++) {
+        struct compact_slice *cs = slicev + j;
+        const void *key;
+        uint16_t klen;
+
+        cs->cs_work = w;
+        cs->cs_fn = fn;
+        cs->cs_sync = sync;
+
+        if (j > 0) {
+            kvset_kblk_minkey(pivot, j * kblks / slicec, &key, &klen);
+            key2kobj(&cs->cs_lo, key, klen);
+            slicev[j - 1].cs_hi = cs->cs_lo;
+        }
+    }
+
+    for (uint j = 0; j < slicec; j++) {
+        uint64_t vgroup;
+
+        vgroup = j ? cndb_kvsetid_mint(cn_tree_get_cndb(w->cw_tree)) : w->cw_kvsetidv[0];
+
+        err = compact_slice_init(slicev + j, j, slicec, vgroup);
+        if (err)
+            goto out;
+    }
+
+    /* Offer the remaining slices to the sts workers running this
+     * compaction.  Without an sts (e.g., unit tests) all slices run in
+     * the calling thread.
+     */
+    if (sts) {
+        sync->css_refcnt += slicec - 1;
+
+        for (uint j = 1; j < slicec; j++) {
+            sts_job_init(&slicev[j].cs_job, compact_slice_job, sts_job_id_get(&w->cw_job));
+            sts_job_submit(sts, &slicev[j].cs_job);
+        }
+    }
+
+    slicev[0].cs_err = fn(slicev);
+
+    /* Run the slices that no worker has picked up yet rather than wait
+     * for them, the workers may all be busy with other compactions.
+     */
+    for (uint j = 1; j < slicec; j++) {
+        struct compact_slice *cs = slicev + j;
+
+        if (compact_slice_claim(cs))
+            cs->cs_err = fn(cs);
+    }
+
+    /* Wait only for the slices a worker is still running.
+     */
+    mutex_lock(&sync->css_lock);
+    while (sync->css_running > 0)
+        cv_wait(&sync->css_cv, &sync->css_lock, "cslice");
+    mutex_unlock(&sync->css_lock);
+
+    for (uint j = 0; j < slicec; j++) {
+        struct compact_slice *cs = slicev + j;
+
+        if (!err)
+            err = cs->cs_err;
+
+        if (j > 0)
+            cn_merge_stats_add(&w->cw_stats, cs->cs_stats);
+
+        w->cw_vbmap.vbm_used += cs->cs_vused;
+        bldrv[j] = cs->cs_bldr;
+    }
+
+    if (!err)
+        err = kvset_builder_adopt_slices(bldr, bldrv, slicec);
+
+out:
+    for (uint j = 0; j < slicec; j++)
+        compact_slice_fini(slicev + j, j);
+
+    compact_slice_sync_put(sync);
+
+    return err;
+}
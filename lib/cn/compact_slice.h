@@ -0,0 +1,110 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_KVS_CN_COMPACT_SLICE_H
+#define HSE_KVS_CN_COMPACT_SLICE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/sched_sts.h>
+#include <hse/util/key_util.h>
+
+#include "cn_metrics.h"
+
+struct cn_compaction_work;
+struct compact_slice;
+struct kv_iterator;
+struct kvset_builder;
+
+typedef merr_t
+compact_slice_fn(struct compact_slice *cs);
+
+/**
+ * struct compact_slice - one key range of a k/kv-compaction
+ *
+ * @cs_work:     the compaction work this slice belongs to
+ * @cs_inputv:   input iterators, one per input kvset (NULL if no keys in range)
+ * @cs_bldr:     builder for the keys in this slice
+ * @cs_stats:    merge stats for this slice
+ * @cs_lo:       smallest key in the slice (zero length if unbounded)
+ * @cs_hi:       first key past the slice (zero length if unbounded)
+ * @cs_vused:    value bytes referenced by adopted vblocks (k-compaction only)
+ * @cs_progress: true if this slice reports progress via cw_progress
+ *
+ * A compaction is split into slices by key range.  Each slice merges its keys
+ * from the input kvsets into its own kvset builder, after which the builders
+ * are stitched into a single output kvset.  See compact_slice_run().
+ */
+struct compact_slice {
+    struct cn_compaction_work *cs_work;
+    struct kv_iterator **cs_inputv;
+    struct kvset_builder *cs_bldr;
+    struct cn_merge_stats *cs_stats;
+    struct key_obj cs_lo;
+    struct key_obj cs_hi;
+    uint64_t cs_vused;
+    bool cs_progress;
+
+    /* private */
+    merr_t cs_err;
+    bool cs_claimed;
+    compact_slice_fn *cs_fn;
+    struct compact_slice_sync *cs_sync;
+    struct cn_merge_stats cs_mstats;
+    struct sts_job cs_job;
+};
+
+/**
+ * compact_slice_lo() - Check if a key sorts before the start of a slice
+ */
+static inline bool
+compact_slice_lo(const struct compact_slice *cs, const struct key_obj *kobj)
+{
+    return key_obj_len(&cs->cs_lo) > 0 && key_obj_cmp(kobj, &cs->cs_lo) < 0;
+}
+
+/**
+ * compact_slice_hi() - Check if a key sorts at or after the end of a slice
+ */
+static inline bool
+compact_slice_hi(const struct compact_slice *cs, const struct key_obj *kobj)
+{
+    return key_obj_len(&cs->cs_hi) > 0 && key_obj_cmp(kobj, &cs->cs_hi) >= 0;
+}
+
+/**
+ * compact_slice_count() - Determine the number of slices for a compaction
+ * @w:       compaction work
+ * @vblocks: true if the compaction writes new vblocks (kv-compaction)
+ *
+ * Return: the number of slices, 1 if the compaction should run serially
+ */
+uint
+compact_slice_count(struct cn_compaction_work *w, bool vblocks);
+
+/**
+ * compact_slice_run() - Run a compaction as one or more key-range slices
+ * @w:      compaction work
+ * @slicec: number of slices, from compact_slice_count()
+ * @fn:     merge function invoked once per slice
+ * @bldr:   builder for the output kvset
+ *
+ * Slice 0 runs in the calling thread while the remaining slices are submitted
+ * as jobs to the sts running the compaction (w->cw_job.sj_sts).  Slices that
+ * no worker has started by the time the caller finishes slice 0 are run by
+ * the caller, which then waits only for the slices still running on workers.
+ * The output of all slices is adopted by @bldr, and the slice stats are added
+ * to w->cw_stats.
+ */
+merr_t
+compact_slice_run(
+    struct cn_compaction_work *w,
+    uint slicec,
+    compact_slice_fn *fn,
+    struct kvset_builder *bldr);
+
+#endif
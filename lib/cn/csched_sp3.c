@@ -1542,6 +1542,9 @@ sp3_comp_thread_name(
     snprintf(buf, bufsz, "hse_%s_%s_%lu", a, r, nodeid);
 }
 
+static void
+sp3_comp_slice_cb(struct sts_job *job);
+
 static merr_t
 sp3_job_serialize(struct sts_job * const job, void * const arg)
 {
@@ -1555,6 +1558,11 @@ sp3_job_serialize(struct sts_job * const job, void * const arg)
     INVARIANT(job);
     INVARIANT(arg);
 
+    /* Skip the key-range slices a compaction submits on its own behalf.
+     */
+    if (job->sj_job_fn != sp3_comp_slice_cb)
+        return 0;
+
     jobs = arg;
     w = container_of(job, typeof(*w), cw_job);
 
@@ -1961,6 +1969,8 @@ sp3_tree_shape_check(struct sp3 *sp)
                 atomic_sub(&tn->tn_readers, readers);
                 ev_debug(1);
             }
+
+            cn_node_heat_update(tn);
         }
         rmlock_runlock(lock);
 
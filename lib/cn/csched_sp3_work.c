@@ -716,7 +716,7 @@ sp3_work_wtype_scatter(
     /* Find the oldest kvset which has vgroup scatter.
      */
     list_for_each_entry_reverse(le, head, le_link) {
-        if (kvset_get_vgroups(le->le_kvset) > 1) {
+        if (kvset_get_scatter(le->le_kvset) > 1) {
             *mark = le;
             break;
         }
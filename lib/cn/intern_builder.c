@@ -16,6 +16,7 @@
 #include "intern_builder.h"
 #include "omf.h"
 #include "wbt_builder.h"
+#include "wbt_internal.h"
 
 /**
  * struct intern_node - node data
@@ -268,6 +269,7 @@ ib_node_publish(struct intern_level *ib, uint last_child)
     size_t lcp_len = ib->node_lcp_len;
     struct wbt_ine_omf *entry; /* (out) current key entry ptr */
     void *sfxp;                /* (out) current suffix ptr */
+    void *hintv;               /* (out) hint array */
     int i;
     uint nkey = ib->curr_rkeys_cnt;
 
@@ -290,6 +292,7 @@ ib_node_publish(struct intern_level *ib, uint last_child)
     }
 
     entry = cnode + sizeof(*node_hdr) + lcp_len;
+    hintv = entry + nkey + 1; /* follows the right edge entry */
     sfxp = cnode + PAGE_SIZE;
 
     for (i = 0; i < nkey; i++) {
@@ -299,17 +302,18 @@ ib_node_publish(struct intern_level *ib, uint last_child)
         memcpy(sfxp, k->kdata + lcp_len, sfx_len);
         omf_set_ine_koff(entry, sfxp - cnode);
         omf_set_ine_left_child(entry, k->child_idx);
+        wbt_node_hint_set(hintv, i, wbt_key_hint(k->kdata + lcp_len, sfx_len));
 
         assert((void *)k >= (void *)ib->sbuf);
         assert((void *)k < (void *)(ib->sbuf + ib->sbuf_used));
-        assert((void *)entry < sfxp);
+        assert(hintv + nkey * WBT_NODE_HINT_SIZE <= sfxp);
 
         entry++;
         k = (void *)k + roundup(sizeof(*k) + k->klen, __alignof__(*k));
     }
 
     /* should have space for this last entry */
-    assert((void *)(entry) <= sfxp);
+    assert((void *)(entry + 1) <= hintv);
 
     /* Create rightmost edge entry -- yes, it uses 'ine_left_child' member.
      */
@@ -483,19 +487,21 @@ key_add(struct intern_builder *ibldr, struct key_obj *right_edge, uint *node_cnt
     while (l) {
         uint used;
         uint ine_sz = sizeof(struct wbt_ine_omf);
+        uint hint_sz = WBT_NODE_HINT_SIZE;
         uint hdr_sz = sizeof(struct wbt_node_hdr_omf);
         uint lcp_len = ib_lcp_len(l, right_edge); /* new lcp len if key is added */
 
         /* All internal nodes must have a right edge. Adding one to
-         * the level's l->curr_rkeys_cnt accounts for this.
+         * the level's l->curr_rkeys_cnt accounts for this.  The right
+         * edge has no key, hence no hint.
          *
-         * used = hdr_sz + lcp_len + tot_klen - lcp_savings + ines
+         * used = hdr_sz + lcp_len + tot_klen - lcp_savings + ines + hints
          */
         used = hdr_sz + lcp_len + l->curr_rkeys_sum - (l->curr_rkeys_cnt * lcp_len) +
-            ((1 + l->curr_rkeys_cnt) * ine_sz);
+            ((1 + l->curr_rkeys_cnt) * ine_sz) + (l->curr_rkeys_cnt * hint_sz);
 
         /* Check if this key will prompt a new node at this level */
-        if (used + ine_sz + right_edge_klen - lcp_len > PAGE_SIZE) {
+        if (used + ine_sz + hint_sz + right_edge_klen - lcp_len > PAGE_SIZE) {
 
             /* Count this key as the right edge of the current node
              * and finish the node.
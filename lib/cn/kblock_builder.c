@@ -22,9 +22,11 @@
 #include <hse/util/assert.h>
 #include <hse/util/bloom_filter.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/fuse_filter.h>
 #include <hse/util/hlog.h>
 #include <hse/util/keycmp.h>
 #include <hse/util/log2.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/perfc.h>
 #include <hse/util/slab.h>
@@ -38,6 +40,7 @@
 #include "kblock_reader.h"
 #include "kvs_mblk_desc.h"
 #include "omf.h"
+#include "wbehind.h"
 #include "wbt_builder.h"
 #include "wbt_reader.h"
 
@@ -92,9 +95,15 @@ struct hash_set {
  * @max_pgc:  Max size of kblock in pages.
  * @wbt_pgc:  Number of pages reserved for wbtree.
  * @blm_pgc:  Number of pages reserved for Bloom filter.
+ * @hix_pgc:  Number of pages reserved for the hash index.
  * @bloom_elt_cap: Number of keys Bloom filter can hold at current size
- * @hash_set:  Hash set to store key hashes. Used to build
- *             Bloom filter at end of kblock construction.
+ * @ff_fpbits: Bits per fingerprint if building a binary fuse filter,
+ *             zero if building a Bloom filter.
+ * @hash_set:  Hash set to store key hashes. Used to build the Bloom
+ *             filter and hash index at end of kblock construction.
+ * @hix_leafv: Ordinal of the first key of each wbtree leaf node, if
+ *             building a hash index.
+ * @hix_leafc: Number of wbtree leaf nodes in @hix_leafv.
  * @num_keys:  Number of keys in kblock.
  * @num_tombstones:  Number of keys in kblock that have tombstone values.
  * @total_key_bytes: Sum of all key lengths.
@@ -123,6 +132,8 @@ struct hash_set {
  *   Wbtree occupies next wbt_pgc pages.
  *
  *   Bloom tree occupies next blm_pbc pages.
+ *
+ *   Hash index (if any) occupies next hix_pgc pages.
  */
 struct curr_kblock {
 
@@ -141,11 +152,20 @@ struct curr_kblock {
     uint32_t max_size;
     uint32_t max_pgc;
     uint32_t blm_pgc;
+    uint32_t hix_pgc;
     uint32_t wbt_pgc;
 
     uint blm_elt_cap;
     struct hash_set hash_set;
     struct bf_bithash_desc desc;
+    uint32_t ff_fpbits;
+
+    uint32_t *hix_leafv;
+    uint32_t hix_leafc;
+    uint32_t hix_nbkts;
+    void *hix;
+    uint hix_len;
+    uint hix_alloc_len;
 
     void *kblk_hdr;
     struct hlog *hlog;
@@ -158,7 +178,8 @@ struct curr_kblock {
 static HSE_ALWAYS_INLINE uint32_t
 available_pgc(struct curr_kblock *kblk)
 {
-    const uint32_t used = KBLOCK_HDR_PAGES + HLOG_PGC + kblk->blm_pgc + kblk->wbt_pgc;
+    const uint32_t used =
+        KBLOCK_HDR_PAGES + HLOG_PGC + kblk->blm_pgc + kblk->hix_pgc + kblk->wbt_pgc;
 
     assert(kblk->max_pgc >= used);
     if (kblk->max_pgc >= used)
@@ -167,6 +188,31 @@ available_pgc(struct curr_kblock *kblk)
     return 0;
 }
 
+/* Max number of in-memory kblock images per builder.  Each image is as large
+ * as a kblock, so kblocks are at most double-buffered.
+ */
+#define KBLOCK_WBUF_MAX (2)
+
+/**
+ * struct kblock_wreq - an in-memory kblock image and its write request
+ * @kw_req:   write-behind request
+ * @kw_bld:   the kblock builder
+ * @kw_kblk:  the kblock image
+ * @kw_iov:   iovec describing the finished image (NULL if no write pending)
+ * @kw_iovc:  NELEM(kw_iov)
+ * @kw_blkid: mblock to which the image is written
+ * @kw_init:  true if kw_kblk has been initialized
+ */
+struct kblock_wreq {
+    struct wbehind_req kw_req;
+    struct kblock_builder *kw_bld;
+    struct curr_kblock kw_kblk;
+    struct iovec *kw_iov;
+    uint kw_iovc;
+    uint64_t kw_blkid;
+    bool kw_init;
+};
+
 /**
  * struct kblock_builder - Create kblocks from a stream of key/value pairs.
  * @mp: the dataset in which kblocks will be created
@@ -175,6 +221,10 @@ available_pgc(struct curr_kblock *kblk)
  * @curr: the kblock currently being built
  * @finished: mark builder as finished (end of life)
  * @max_size: Maximum mblock size of all configured media classes.
+ * @wb: write-behind queue for finished kblocks
+ * @kblk_idx: index of the wreqv slot that holds %curr
+ * @kblkc: number of usable wreqv slots
+ * @wreqv: kblock images, one is being built while the others are written
  */
 struct kblock_builder {
     struct mpool *mp;
@@ -185,18 +235,23 @@ struct kblock_builder {
     struct hlog *composite_hlog;
     struct cn_merge_stats *mstats;
     struct blk_list finished_kblks;
-    struct curr_kblock curr;
+    struct curr_kblock *curr;
     enum hse_mclass_policy_age agegroup;
     bool finished;
     uint pt_pgc;
     uint pt_max_pgc;
     uint32_t max_size;
+    struct wbehind wb;
+    uint kblk_idx;
+    uint kblkc;
+    struct kblock_wreq wreqv[KBLOCK_WBUF_MAX];
 };
 
 /**
  * mblk_blow_chunks() - Split a large mpool_mblock_write request into a
  *                      sequence of smaller requests.
  * @self:      kblock builder
+ * @stats:     write stats
  * @mbid:      mblock id
  * @iov:       iovec
  * @iov_cnt:   NELEM(iovec)
@@ -225,6 +280,7 @@ struct kblock_builder {
 static merr_t
 mblk_blow_chunks(
     struct kblock_builder *self,
+    struct cn_merge_stats_ops *stats,
     uint64_t mbid,
     struct iovec *iov,
     uint iov_cnt,
@@ -240,8 +296,7 @@ mblk_blow_chunks(
     uint bx, blen_orig;
     uint wlen, need;
 
-    uint64_t dt = 0;
-    struct cn_merge_stats *stats = self->mstats;
+    uint64_t dt;
 
     /* ax, aoff, alen, bx, blen explained:
      *
@@ -291,13 +346,11 @@ mblk_blow_chunks(
             iov[ax].iov_base += aoff;
             iov[ax].iov_len = need;
 
-            if (stats)
-                dt = get_time_ns();
+            dt = get_time_ns();
             err = mpool_mblock_write(self->mp, mbid, iov + ax, 1);
             if (ev(err))
                 return err;
-            if (stats)
-                dt = get_time_ns() - dt;
+            dt = get_time_ns() - dt;
 
             iov[ax].iov_base -= aoff;
             iov[ax].iov_len = alen_orig;
@@ -330,13 +383,11 @@ mblk_blow_chunks(
                 iov[bx].iov_len = need;
             }
 
-            if (stats)
-                dt = get_time_ns();
+            dt = get_time_ns();
             err = mpool_mblock_write(self->mp, mbid, iov + ax, bx - ax + 1);
             if (ev(err))
                 return err;
-            if (stats)
-                dt = get_time_ns() - dt;
+            dt = get_time_ns() - dt;
 
             iov[ax].iov_base -= aoff;
             iov[ax].iov_len = alen_orig;
@@ -356,8 +407,7 @@ mblk_blow_chunks(
             ax = bx;
         }
 
-        if (stats)
-            count_ops(&stats->ms_kblk_write, 1, wlen, dt);
+        count_ops(stats, 1, wlen, dt);
 
         written += wlen;
 
@@ -379,7 +429,7 @@ hash_set_init(struct hash_set *hs)
 }
 
 static merr_t
-hash_set_add(struct hash_set *hs, const struct key_obj *kobj)
+hash_set_add(struct hash_set *hs, uint64_t hash)
 {
     if (!hs->curr_part) {
         hs->curr_part = vlb_alloc(VLB_ALLOCSZ_MAX);
@@ -393,7 +443,7 @@ hash_set_add(struct hash_set *hs, const struct key_obj *kobj)
 
     assert(hs->curr_part->n_hashes < HSP_HASH_MAX_KEYS);
 
-    hs->curr_part->hashvec[hs->curr_part->n_hashes++] = key_obj_hash64(kobj);
+    hs->curr_part->hashvec[hs->curr_part->n_hashes++] = hash;
 
     /* If full, then use next part.  If next is null, allocate new
      * part next time one is added.
@@ -475,13 +525,27 @@ kblock_init(
     kblk->pc = pc;
     kblk->desc = bf_compute_bithash_est(rp->cn_bloom_prob);
 
+    if (cp->filter_type == KVS_FILTER_FUSE)
+        kblk->ff_fpbits = ff_compute_fpbits_est(rp->cn_bloom_prob);
+
+    /* A kblock has at most one leaf node per page.
+     */
+    if (cp->hash_index) {
+        kblk->hix_leafv = malloc(kblk->max_pgc * sizeof(*kblk->hix_leafv));
+        if (ev(!kblk->hix_leafv))
+            return merr(ENOMEM);
+    }
+
     err = hlog_create(&kblk->hlog, HLOG_PRECISION);
-    if (ev(err))
+    if (ev(err)) {
+        free(kblk->hix_leafv);
         return err;
+    }
 
     err = wbb_create(&kblk->wbtree, kblk->wbt_pgc + available_pgc(kblk), &kblk->wbt_pgc);
     if (ev(err)) {
         hlog_destroy(kblk->hlog);
+        free(kblk->hix_leafv);
         return err;
     }
 
@@ -504,6 +568,11 @@ kblock_reset(struct curr_kblock *kblk)
     kblk->blm_elt_cap = 0;
     kblk->bloom_len = 0;
 
+    kblk->hix_pgc = 0;
+    kblk->hix_leafc = 0;
+    kblk->hix_nbkts = 0;
+    kblk->hix_len = 0;
+
     hash_set_reset(&kblk->hash_set);
 
     hlog_reset(kblk->hlog);
@@ -517,6 +586,8 @@ static void
 kblock_free(struct curr_kblock *kblk)
 {
     vlb_free(kblk->bloom, kblk->bloom_used_max);
+    free(kblk->hix);
+    free(kblk->hix_leafv);
     free(kblk->kblk_hdr);
 
     wbb_destroy(kblk->wbtree);
@@ -548,36 +619,73 @@ kblock_add_entry(
     struct key_stats *stats,
     bool *added)
 {
+    uint32_t blm_pgc = kblk->blm_pgc;
+    uint32_t hix_pgc = kblk->hix_pgc;
+    uint blm_elt_cap = kblk->blm_elt_cap;
+    uint32_t avail = available_pgc(kblk);
     merr_t err = 0;
 
     *added = false;
 
+    /* Determine the pages the bloom filter and hash index need to cover one
+     * more key, but reserve them only once the wbtree has accepted the key.
+     */
     if (kblk->rp->cn_bloom_create) {
-
-        /* Ensure we have enough pages reserved for bloom filters. */
-        if (kblk->num_keys + 1 > kblk->blm_elt_cap) {
-            if (!available_pgc(kblk))
+        while (kblk->num_keys + 1 > blm_elt_cap) {
+            if (!avail)
                 return 0;
-            kblk->blm_pgc++;
-            kblk->blm_elt_cap = bf_element_estimate(kblk->desc, kblk->blm_pgc * PAGE_SIZE);
+            avail--;
+            blm_pgc++;
+
+            if (kblk->ff_fpbits)
+                blm_elt_cap = ff_element_estimate(kblk->ff_fpbits, blm_pgc * PAGE_SIZE);
+            else
+                blm_elt_cap = bf_element_estimate(kblk->desc, blm_pgc * PAGE_SIZE);
         }
+    }
 
-        /* Add key's hash to hash_set.
-         */
-        err = hash_set_add(&kblk->hash_set, kobj);
+    if (kblk->hix_leafv) {
+        const uint32_t pgc = kblock_hix_pgc(kblock_hix_nbkts(kblk->num_keys + 1));
 
-        if (ev(err))
-            return err;
+        while (hix_pgc < pgc) {
+            if (!avail)
+                return 0;
+            avail--;
+            hix_pgc++;
+        }
     }
 
     /* update wbtree */
     err = wbb_add_entry(
-        kblk->wbtree, kobj, stats->nvals, stats->tot_vlen, kmd, kmd_len,
-        kblk->wbt_pgc + available_pgc(kblk), &kblk->wbt_pgc, added);
+        kblk->wbtree, kobj, stats->nvals, stats->tot_vlen, kmd, kmd_len, kblk->wbt_pgc + avail,
+        &kblk->wbt_pgc, added);
     /* Out of space indicated by err==0 and added==false. */
     if (ev(err) || !*added)
         return err;
 
+    kblk->blm_pgc = blm_pgc;
+    kblk->blm_elt_cap = blm_elt_cap;
+    kblk->hix_pgc = hix_pgc;
+
+    /* Add key's hash to hash_set only once the key has been added, as the
+     * fuse filter and hash index require exactly one hash per key.
+     */
+    if (kblk->rp->cn_bloom_create || kblk->hix_leafv) {
+        err = hash_set_add(&kblk->hash_set, key_obj_hash64(kobj));
+        if (ev(err))
+            return err;
+    }
+
+    if (kblk->hix_leafv) {
+        uint node, slot;
+
+        wbb_last_entry(kblk->wbtree, &node, &slot);
+        if (node == kblk->hix_leafc) {
+            assert(slot == 0);
+            kblk->hix_leafv[kblk->hix_leafc++] = kblk->num_keys;
+        }
+    }
+
     /* update metrics */
     kblk->num_keys++;
     kblk->total_key_bytes += key_obj_len(kobj);
@@ -588,6 +696,43 @@ kblock_add_entry(
     return 0;
 }
 
+/* Build a binary fuse filter from the kblock's key hashes.  The filter
+ * is constructed from all the hashes at once, so gather them into one
+ * vector if they span more than one hash set part.
+ */
+static merr_t
+kblock_finish_fuse(struct curr_kblock *kblk, struct fuse_filter *ff)
+{
+    struct hash_set_part *part;
+    uint64_t *hashv;
+    uint32_t hashc = 0;
+    merr_t err;
+
+    part = list_first_entry(&kblk->hash_set.part_list, typeof(*part), part_link);
+
+    if (part->n_hashes == kblk->num_keys) {
+        return ff_filter_build(
+            ff, kblk->ff_fpbits, part->hashvec, part->n_hashes, kblk->bloom, kblk->bloom_len);
+    }
+
+    hashv = malloc(kblk->num_keys * sizeof(*hashv));
+    if (ev(!hashv))
+        return merr(ENOMEM);
+
+    list_for_each_entry(part, &kblk->hash_set.part_list, part_link) {
+        memcpy(hashv + hashc, part->hashvec, part->n_hashes * sizeof(*hashv));
+        hashc += part->n_hashes;
+    }
+
+    assert(hashc == kblk->num_keys);
+
+    err = ff_filter_build(ff, kblk->ff_fpbits, hashv, hashc, kblk->bloom, kblk->bloom_len);
+
+    free(hashv);
+
+    return err;
+}
+
 /* Finalize wbtree bloom filter.
  */
 static merr_t
@@ -595,6 +740,9 @@ kblock_finish_bloom(struct curr_kblock *kblk, struct bloom_hdr_omf *blm_hdr)
 {
     struct bloom_filter bloom;
     struct hash_set_part *part;
+    struct fuse_filter ff;
+
+    memset(&ff, 0, sizeof(ff));
 
     if (kblk->num_keys == 0 || kblk->rp->cn_bloom_create == 0) {
         assert(kblk->blm_pgc == 0);
@@ -617,10 +765,18 @@ kblock_finish_bloom(struct curr_kblock *kblk, struct bloom_hdr_omf *blm_hdr)
 
         kblk->bloom_used_max = max_t(uint, kblk->bloom_used_max, kblk->bloom_len);
 
-        memset(kblk->bloom, 0, kblk->bloom_len);
-        bf_filter_init(&bloom, kblk->desc, kblk->num_keys, kblk->bloom, kblk->bloom_len);
-        list_for_each_entry(part, &kblk->hash_set.part_list, part_link) {
-            bf_filter_insert_by_hashv(&bloom, part->hashvec, part->n_hashes);
+        if (kblk->ff_fpbits) {
+            merr_t err;
+
+            err = kblock_finish_fuse(kblk, &ff);
+            if (ev(err))
+                return err;
+        } else {
+            memset(kblk->bloom, 0, kblk->bloom_len);
+            bf_filter_init(&bloom, kblk->desc, kblk->num_keys, kblk->bloom, kblk->bloom_len);
+            list_for_each_entry(part, &kblk->hash_set.part_list, part_link) {
+                bf_filter_insert_by_hashv(&bloom, part->hashvec, part->n_hashes);
+            }
         }
     }
 
@@ -628,6 +784,19 @@ kblock_finish_bloom(struct curr_kblock *kblk, struct bloom_hdr_omf *blm_hdr)
     memset(blm_hdr, 0, sizeof(*blm_hdr));
     omf_set_bh_magic(blm_hdr, BLOOM_OMF_MAGIC);
     omf_set_bh_version(blm_hdr, BLOOM_OMF_VERSION);
+
+    if (ff.ff_fpbits) {
+        omf_set_bh_type(blm_hdr, BLOOM_OMF_TYPE_FUSE);
+        omf_set_bh_bitmapsz(blm_hdr, ff.ff_fpvsz);
+        omf_set_bh_modulus(blm_hdr, ff.ff_seg_count_len);
+        omf_set_bh_bktshift(blm_hdr, ff.ff_seglen_shift);
+        omf_set_bh_rotl(blm_hdr, ff.ff_fpbits);
+        omf_set_bh_n_hashes(blm_hdr, FF_ARITY);
+        omf_set_bh_seed(blm_hdr, ff.ff_seed);
+        return 0;
+    }
+
+    omf_set_bh_type(blm_hdr, BLOOM_OMF_TYPE_BLOOM);
     omf_set_bh_bitmapsz(blm_hdr, bloom.bf_bitmapsz);
     omf_set_bh_modulus(blm_hdr, bloom.bf_modulus);
     omf_set_bh_bktshift(blm_hdr, bloom.bf_bktshift);
@@ -637,6 +806,89 @@ kblock_finish_bloom(struct curr_kblock *kblk, struct bloom_hdr_omf *blm_hdr)
     return 0;
 }
 
+/* Build the hash index from the kblock's key hashes.  Keys are added in
+ * order, hence the wbtree leaf node and slot of each key follow from its
+ * ordinal and the ordinal of the first key of each leaf node.
+ */
+static merr_t
+kblock_finish_hix(struct curr_kblock *kblk)
+{
+    struct kblock_hix_ent_omf *bktv, *ent;
+    struct hash_set_part *part;
+    uint32_t nbkts, ord, leaf;
+    size_t bktsz;
+
+    if (!kblk->hix_leafv || kblk->num_keys == 0) {
+        kblk->hix_pgc = 0;
+        return 0;
+    }
+
+    nbkts = kblock_hix_nbkts(kblk->num_keys);
+    bktsz = nbkts * KBLOCK_HIX_BKT_SIZE;
+    assert(kblock_hix_pgc(nbkts) <= kblk->hix_pgc);
+
+    kblk->hix_len = kblk->hix_pgc * PAGE_SIZE;
+
+    if (kblk->hix_len > kblk->hix_alloc_len) {
+        free(kblk->hix);
+
+        kblk->hix_alloc_len = roundup(kblk->hix_len, 1u << 20);
+        kblk->hix = aligned_alloc(PAGE_SIZE, kblk->hix_alloc_len);
+        if (ev(!kblk->hix)) {
+            kblk->hix_len = 0;
+            kblk->hix_alloc_len = 0;
+            return merr(ENOMEM);
+        }
+    }
+
+    /* All bits set marks every entry as empty (KBLOCK_HIX_NODE_EMPTY).
+     */
+    bktv = kblk->hix;
+    memset(bktv, 0xff, bktsz);
+    memset((void *)bktv + bktsz, 0, kblk->hix_len - bktsz);
+
+    ord = leaf = 0;
+
+    list_for_each_entry(part, &kblk->hash_set.part_list, part_link) {
+        for (uint32_t i = 0; i < part->n_hashes; ++i, ++ord) {
+            const uint64_t hash = part->hashvec[i];
+            uint32_t bkt = kblock_hix_bkt(hash, nbkts);
+            uint j;
+
+            while (leaf + 1 < kblk->hix_leafc && kblk->hix_leafv[leaf + 1] <= ord)
+                ++leaf;
+
+            /* The table is never more than KBLOCK_HIX_BKT_LOAD/KBLOCK_HIX_BKT_ENTRIES
+             * full, so there is always an empty entry to be found.
+             */
+            while (1) {
+                ent = bktv + bkt * KBLOCK_HIX_BKT_ENTRIES;
+
+                for (j = 0; j < KBLOCK_HIX_BKT_ENTRIES; ++j, ++ent) {
+                    if (omf_hxe_node(ent) == KBLOCK_HIX_NODE_EMPTY)
+                        break;
+                }
+
+                if (j < KBLOCK_HIX_BKT_ENTRIES)
+                    break;
+
+                if (++bkt == nbkts)
+                    bkt = 0;
+            }
+
+            omf_set_hxe_fp(ent, hash >> 32);
+            omf_set_hxe_node(ent, leaf);
+            omf_set_hxe_slot(ent, ord - kblk->hix_leafv[leaf]);
+        }
+    }
+
+    assert(ord == kblk->num_keys);
+
+    kblk->hix_nbkts = nbkts;
+
+    return 0;
+}
+
 /* Prepare kblock header for writing to media.
  *
  * Parameters:
@@ -729,14 +981,20 @@ kblock_make_header(
     /* make sure max key doesn't overlap with min key */
     assert(omf_kbh_min_koff(hdr) >= omf_kbh_max_koff(hdr) + key_obj_len(&max_kobj));
 
-    /* Set offset and length for wbtree, bloom and hlog regions. */
+    /* Set offset and length for wbtree, bloom, hash index and hlog regions. */
     omf_set_kbh_wbt_doff_pg(hdr, KBLOCK_HDR_PAGES);
     omf_set_kbh_wbt_dlen_pg(hdr, kblk->wbt_pgc);
 
     omf_set_kbh_blm_doff_pg(hdr, KBLOCK_HDR_PAGES + kblk->wbt_pgc);
     omf_set_kbh_blm_dlen_pg(hdr, kblk->blm_pgc);
 
-    omf_set_kbh_hlog_doff_pg(hdr, KBLOCK_HDR_PAGES + kblk->wbt_pgc + kblk->blm_pgc);
+    if (kblk->hix_nbkts) {
+        omf_set_kbh_hix_doff_pg(hdr, KBLOCK_HDR_PAGES + kblk->wbt_pgc + kblk->blm_pgc);
+        omf_set_kbh_hix_nbkts(hdr, kblk->hix_nbkts);
+    }
+
+    omf_set_kbh_hlog_doff_pg(
+        hdr, KBLOCK_HDR_PAGES + kblk->wbt_pgc + kblk->blm_pgc + kblk->hix_pgc);
     omf_set_kbh_hlog_dlen_pg(hdr, HLOG_PGC);
 
     /* Copy wbtree, bloom and min/max keys into header page.
@@ -760,30 +1018,97 @@ kbb_estimate_alen(struct cn *cn, size_t wlen, enum hse_mclass mclass)
         KBLOCK_MAX_SIZE, zonealloc_unit, wlen, CN_MB_EST_FLAGS_TRUNCATE | CN_MB_EST_FLAGS_POW2);
 }
 
+static merr_t
+kblock_write_cb(struct wbehind_req *req)
+{
+    struct kblock_wreq *kw = container_of(req, struct kblock_wreq, kw_req);
+
+    /* Write mblock in chunks.  Chunk size must be a multiple of
+     * mblock optimal write size. Use largest chunk size less than 1 MiB.
+     * Runs on the write-behind worker, see wbehind_stats_get().
+     */
+    return mblk_blow_chunks(
+        kw->kw_bld, &req->wr_stats, kw->kw_blkid, kw->kw_iov, kw->kw_iovc, 1024 * 1024);
+}
+
+/* Wait for the write of the given slot's kblock image (if any) to complete,
+ * after which the slot may be reused for the next kblock.
+ */
+static merr_t
+kblock_write_wait(struct kblock_builder *bld, struct kblock_wreq *kw)
+{
+    merr_t err;
+
+    err = wbehind_wait(&bld->wb, &kw->kw_req);
+    wbehind_stats_get(&bld->wb, bld->mstats ? &bld->mstats->ms_kblk_write : NULL);
+
+    if (kw->kw_iov) {
+        free(kw->kw_iov);
+        kw->kw_iov = NULL;
+        kblock_reset(&kw->kw_kblk);
+    }
+
+    return err;
+}
+
+/* Switch to the next slot, initializing its kblock image on first use.
+ */
+static merr_t
+kblock_next(struct kblock_builder *bld)
+{
+    struct kblock_wreq *kw;
+    merr_t err;
+
+    bld->kblk_idx = (bld->kblk_idx + 1) % bld->kblkc;
+    kw = bld->wreqv + bld->kblk_idx;
+
+    err = kblock_write_wait(bld, kw);
+    if (ev(err))
+        return err;
+
+    if (!kw->kw_init) {
+        err = kblock_init(&kw->kw_kblk, bld->cp, bld->rp, bld->pc, bld->max_size);
+        if (ev(err))
+            return err;
+
+        kw->kw_init = true;
+    }
+
+    bld->curr = &kw->kw_kblk;
+
+    return 0;
+}
+
 /**
  * kblock_finish() - allocate and write an mblock with kblock data
+ * @bld:  kblock builder
+ * @last: true if no more keys will be added to the builder
  *
  * Finalize wbtree and Bloom filter regions, allocate an appropriately sized
- * mblock, and write all kblock data to it.  Does not commit the mblock.
+ * mblock, and submit a write of all kblock data to it.  Does not commit the
+ * mblock.  Unless @last is true, bld->curr is then set to an empty kblock
+ * (which may require waiting for the write of a previous kblock).
  *
- * This function unconditionally invokes kblock_free().
+ * The current kblock is unconditionally reset once its data is no longer
+ * needed.
  */
 static merr_t
-kblock_finish(struct kblock_builder *bld)
+kblock_finish(struct kblock_builder *bld, bool last)
 {
+    struct kblock_wreq *kw = bld->wreqv + bld->kblk_idx;
     struct bloom_hdr_omf blm_hdr;
     struct wbt_hdr_omf wbt_hdr = { 0 };
     struct mblock_props mbprop;
     struct mpool_mclass_props mc_props;
 
-    struct curr_kblock *kblk = &bld->curr;
+    struct curr_kblock *kblk = bld->curr;
     struct cn_merge_stats *stats = bld->mstats;
     struct mclass_policy *mpolicy = cn_get_mclass_policy(bld->cn);
 
     struct iovec *iov = NULL;
     uint iov_cnt = 0;
     uint iov_max;
-    uint i, chunk;
+    uint i;
     size_t wlen;
     uint32_t flags = 0;
 
@@ -803,14 +1128,14 @@ kblock_finish(struct kblock_builder *bld)
         }
     }
 
-    /* Include wbtree pages from main and ptree and add 3 more iov members for
-     * the kblock header, bloom and hlog
+    /* Include wbtree pages from main and ptree and add 4 more iov members for
+     * the kblock header, bloom, hash index and hlog
      *
      * [HSE_TODO]: This 1 here represents the wbtree's nodev iovec. Create a
      * helper function to just ask the wbtree how many iovecs it will need in
      * the worst case.
      */
-    iov_max = 3 + 1 + wbb_max_inodec_get(kblk->wbtree) + wbb_kmd_pgc_get(kblk->wbtree);
+    iov_max = 4 + 1 + wbb_max_inodec_get(kblk->wbtree) + wbb_kmd_pgc_get(kblk->wbtree);
 
     iov = malloc(sizeof(*iov) * iov_max);
     if (ev(!iov))
@@ -845,8 +1170,18 @@ kblock_finish(struct kblock_builder *bld)
         iov_cnt++;
     }
 
+    /* Finalize hash index. */
+    err = kblock_finish_hix(kblk);
+    if (ev(err))
+        goto errout;
+    if (kblk->hix_len) {
+        iov[iov_cnt].iov_base = kblk->hix;
+        iov[iov_cnt].iov_len = kblk->hix_len;
+        iov_cnt++;
+    }
+
     /* Finalize HyperLogLog. */
-    iov[iov_cnt].iov_base = hlog_data(bld->curr.hlog);
+    iov[iov_cnt].iov_base = hlog_data(bld->curr->hlog);
     iov[iov_cnt].iov_len = HLOG_PGC * PAGE_SIZE;
     iov_cnt++;
 
@@ -897,26 +1232,32 @@ kblock_finish(struct kblock_builder *bld)
     if (stats)
         count_ops(&stats->ms_kblk_alloc, 1, mbprop.mpr_alloc_cap, get_time_ns() - tstart);
 
-    /* Write mblock in chunks.  Chunk size must be a multiple of
-     * mblock optimal write size. Use largest chunk size less than 1 MiB.
+    /* Once on the list the mblock is deleted by kbb_destroy() should the
+     * write fail.
      */
-    chunk = 1024 * 1024;
-    err = mblk_blow_chunks(bld, blkid, iov, iov_cnt, chunk);
-    if (ev(err))
-        goto errout;
-
     err = blk_list_append(&bld->finished_kblks, blkid);
     if (ev(err))
         goto errout;
 
+    kw->kw_blkid = blkid;
+    blkid = 0;
+
     /* Add the current kblock's hlog to the composite hlog */
     hlog_union(bld->composite_hlog, hlog_data(kblk->hlog));
 
-    /* unconditional reset */
-    kblock_reset(kblk);
-    free(iov);
+    /* The iovec and the kblock image are released once the write completes,
+     * see kblock_write_wait().
+     */
+    kw->kw_iov = iov;
+    kw->kw_iovc = iov_cnt;
 
-    return 0;
+    err = wbehind_submit(&bld->wb, &kw->kw_req, kblock_write_cb);
+    if (ev(err)) {
+        kw->kw_iov = NULL;
+        goto errout;
+    }
+
+    return last ? 0 : kblock_next(bld);
 
 errout:
     if (blkid)
@@ -941,6 +1282,7 @@ kbb_create(struct kblock_builder **builder_out, struct cn *cn, struct perfc_set
     struct kblock_builder *bld;
     struct mpool_mclass_props props;
     struct mclass_policy *policy;
+    struct workqueue_struct *wq;
 
     assert(builder_out);
 
@@ -969,10 +1311,24 @@ kbb_create(struct kblock_builder **builder_out, struct cn *cn, struct perfc_set
     if (ev(err))
         goto err_exit1;
 
-    err = kblock_init(&bld->curr, bld->cp, bld->rp, bld->pc, bld->max_size);
+    bld->curr = &bld->wreqv[0].kw_kblk;
+
+    err = kblock_init(bld->curr, bld->cp, bld->rp, bld->pc, bld->max_size);
     if (ev(err))
         goto err_exit2;
 
+    /* Double-buffer kblocks only if the writes can be performed
+     * asynchronously.
+     */
+    wq = cn_get_io_wq(cn);
+    bld->kblkc = (wq && bld->rp->cn_wbehind_qdepth > 1) ? KBLOCK_WBUF_MAX : 1;
+
+    for (uint i = 0; i < bld->kblkc; i++)
+        bld->wreqv[i].kw_bld = bld;
+    bld->wreqv[0].kw_init = true;
+
+    wbehind_init(&bld->wb, bld->kblkc > 1 ? wq : NULL);
+
     *builder_out = bld;
     return 0;
 
@@ -991,8 +1347,19 @@ kbb_destroy(struct kblock_builder *bld)
     if (ev(!bld))
         return;
 
+    /* Wait for pending writes before the mblocks are deleted.
+     */
+    wbehind_fini(&bld->wb);
+
+    for (uint i = 0; i < bld->kblkc; i++) {
+        struct kblock_wreq *kw = bld->wreqv + i;
+
+        free(kw->kw_iov);
+        if (kw->kw_init)
+            kblock_free(&kw->kw_kblk);
+    }
+
     hlog_destroy(bld->composite_hlog);
-    kblock_free(&bld->curr);
     delete_mblocks(bld->mp, &bld->finished_kblks);
     blk_list_free(&bld->finished_kblks);
     free(bld);
@@ -1019,11 +1386,11 @@ kbb_add_entry(
 
     hash = hse_hash64v(kobj->ko_pfx, kobj->ko_pfx_len, kobj->ko_sfx, kobj->ko_sfx_len);
 
-    err = kblock_add_entry(&bld->curr, kobj, kmd, kmd_len, stats, &added);
+    err = kblock_add_entry(bld->curr, kobj, kmd, kmd_len, stats, &added);
     if (ev(err))
         return err;
     if (added) {
-        hlog_add(bld->curr.hlog, hash);
+        hlog_add(bld->curr->hlog, hash);
         return 0;
     }
 
@@ -1034,19 +1401,19 @@ kbb_add_entry(
      *   - add key to new kblock
      *   - bug if fails with no space
      */
-    assert(!kblock_is_empty(&bld->curr));
-    if (ev(kblock_is_empty(&bld->curr)))
+    assert(!kblock_is_empty(bld->curr));
+    if (ev(kblock_is_empty(bld->curr)))
         return merr(EBUG);
 
     /* There are more keys to add, do not pass in ptree details */
-    err = kblock_finish(bld);
+    err = kblock_finish(bld, false);
     if (ev(err))
         return err;
 
-    err = kblock_add_entry(&bld->curr, kobj, kmd, kmd_len, stats, &added);
+    err = kblock_add_entry(bld->curr, kobj, kmd, kmd_len, stats, &added);
     if (ev(err))
         return err;
-    hlog_add(bld->curr.hlog, hash);
+    hlog_add(bld->curr->hlog, hash);
     assert(added);
     if (ev(!added))
         return merr(EBUG);
@@ -1071,13 +1438,18 @@ kbb_finish(struct kblock_builder *bld, struct blk_list *kblks)
     bld->finished = true;
 
     /* In the event we have no keys, return no kblocks to the caller. */
-    if (bld->curr.num_keys == 0) {
+    if (bld->curr->num_keys == 0) {
         assert(bld->finished_kblks.idc == 0);
 
         return 0;
     }
 
-    err = kblock_finish(bld);
+    err = kblock_finish(bld, true);
+    if (ev(err))
+        return err;
+
+    err = wbehind_drain(&bld->wb);
+    wbehind_stats_get(&bld->wb, bld->mstats ? &bld->mstats->ms_kblk_write : NULL);
     if (ev(err))
         return err;
 
@@ -1096,6 +1468,12 @@ kbb_get_composite_hlog(const struct kblock_builder * const bld)
     return hlog_data(bld->composite_hlog);
 }
 
+void
+kbb_union_composite_hlog(struct kblock_builder *bld, const uint8_t *regv)
+{
+    hlog_union(bld->composite_hlog, regv);
+}
+
 merr_t
 kbb_set_agegroup(struct kblock_builder *bld, enum hse_mclass_policy_age age)
 {
@@ -1126,7 +1504,7 @@ kbb_set_merge_stats(struct kblock_builder *bld, struct cn_merge_stats *stats)
 bool
 kbb_is_empty(struct kblock_builder *bld)
 {
-    return kblock_is_empty(&bld->curr);
+    return kblock_is_empty(bld->curr);
 }
 
 void
@@ -1135,7 +1513,7 @@ kbb_curr_kblk_min_max_keys(
     struct key_obj *min_kobj,
     struct key_obj *max_kobj)
 {
-    wbb_min_max_keys(bld->curr.wbtree, min_kobj, max_kobj);
+    wbb_min_max_keys(bld->curr->wbtree, min_kobj, max_kobj);
 }
 
 #if HSE_MOCKING
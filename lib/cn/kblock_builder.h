@@ -121,6 +121,13 @@ kbb_estimate_alen(struct cn *cn, size_t wlen, enum hse_mclass mclass);
 const uint8_t *
 kbb_get_composite_hlog(const struct kblock_builder *bld);
 
+/**
+ * kbb_union_composite_hlog() - Merge an hlog into the builder's composite hlog
+ * @regv: hlog registers, e.g., from kbb_get_composite_hlog() of another builder
+ */
+void
+kbb_union_composite_hlog(struct kblock_builder *bld, const uint8_t *regv);
+
 merr_t
 kbb_set_agegroup(struct kblock_builder *bld, enum hse_mclass_policy_age age);
 
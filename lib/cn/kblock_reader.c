@@ -14,6 +14,7 @@
 #include <hse/util/bloom_filter.h>
 #include <hse/util/compiler.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/fuse_filter.h>
 #include <hse/util/page.h>
 #include <hse/util/slab.h>
 
@@ -83,7 +84,8 @@ kbr_read_blm_region_desc(struct kvs_mblk_desc *kbd, struct bloom_desc *desc)
      * it's safe to run without blooms, albeit at a big hit to read perf.
      */
     version = omf_bh_version(blm_omf);
-    if (ev(version != BLOOM_OMF_VERSION)) {
+    if (ev(version != BLOOM_OMF_VERSION && version != BLOOM_OMF_VERSION6 &&
+           version != BLOOM_OMF_VERSION5)) {
         log_err("bloom %lx invalid version %u (expected %u)", mbid, version, BLOOM_OMF_VERSION);
         return 0;
     }
@@ -91,11 +93,60 @@ kbr_read_blm_region_desc(struct kvs_mblk_desc *kbd, struct bloom_desc *desc)
     desc->bd_first_page = omf_kbh_blm_doff_pg(hdr);
     desc->bd_n_pages = omf_kbh_blm_dlen_pg(hdr);
 
-    desc->bd_modulus = omf_bh_modulus(blm_omf);
-    desc->bd_bktshift = omf_bh_bktshift(blm_omf);
-    desc->bd_n_hashes = omf_bh_n_hashes(blm_omf);
-    desc->bd_rotl = omf_bh_rotl(blm_omf);
-    desc->bd_bktmask = (1u << desc->bd_bktshift) - 1;
+    desc->bd_fuse = (version >= BLOOM_OMF_VERSION7 && omf_bh_type(blm_omf) == BLOOM_OMF_TYPE_FUSE);
+
+    if (version >= BLOOM_OMF_VERSION7 && !desc->bd_fuse &&
+        ev(omf_bh_type(blm_omf) != BLOOM_OMF_TYPE_BLOOM)) {
+        log_err("bloom %lx invalid type %u", mbid, omf_bh_type(blm_omf));
+        memset(desc, 0, sizeof(*desc));
+        return 0;
+    }
+
+    /* A fuse filter reuses the bloom header's modulus, bktshift and rotl
+     * fields for its own parameters, which are kept apart in the descriptor.
+     */
+    if (desc->bd_fuse) {
+        const uint32_t fpbits = omf_bh_rotl(blm_omf);
+        const uint32_t seglen_shift = omf_bh_bktshift(blm_omf);
+        const uint32_t seg_count_len = omf_bh_modulus(blm_omf);
+        bool valid;
+
+        /* All three slots of every key must lie within the data region.
+         */
+        valid = ff_fpbits_valid(fpbits) && seglen_shift <= FF_SEGLEN_BITS &&
+            ((seg_count_len + ((uint64_t)(FF_ARITY - 1) << seglen_shift)) * fpbits + 7) / 8 <=
+                (uint64_t)desc->bd_n_pages * PAGE_SIZE;
+
+        if (ev(!valid)) {
+            log_err(
+                "bloom %lx invalid fuse filter fpbits %u seglen_shift %u slots %u", mbid, fpbits,
+                seglen_shift, seg_count_len);
+            memset(desc, 0, sizeof(*desc));
+            return 0;
+        }
+
+        desc->bd_ff_fpbits = fpbits;
+        desc->bd_ff_seglen_shift = seglen_shift;
+        desc->bd_ff_seg_count_len = seg_count_len;
+        desc->bd_ff_seed = omf_bh_seed(blm_omf);
+    } else {
+        desc->bd_modulus = omf_bh_modulus(blm_omf);
+        desc->bd_bktshift = omf_bh_bktshift(blm_omf);
+        desc->bd_n_hashes = omf_bh_n_hashes(blm_omf);
+        desc->bd_rotl = omf_bh_rotl(blm_omf);
+        desc->bd_bktmask = (1u << desc->bd_bktshift) - 1;
+        desc->bd_split = (version >= BLOOM_OMF_VERSION6);
+    }
+
+    if (desc->bd_split) {
+        if (ev(desc->bd_bktshift != BF_SB_BKTSHIFT || desc->bd_n_hashes > BF_SB_LANES)) {
+            log_err(
+                "bloom %lx invalid bktshift %u or hashes %u", mbid, desc->bd_bktshift,
+                desc->bd_n_hashes);
+            memset(desc, 0, sizeof(*desc));
+            return 0;
+        }
+    }
 
     if (desc->bd_n_pages)
         desc->bd_bitmap = (void *)kbd->map_base + desc->bd_first_page * PAGE_SIZE;
@@ -105,6 +156,84 @@ kbr_read_blm_region_desc(struct kvs_mblk_desc *kbd, struct bloom_desc *desc)
     return 0;
 }
 
+merr_t
+kbr_read_hix_region_desc(struct kvs_mblk_desc *kbd, struct kblock_hix_desc *desc)
+{
+    const struct kblock_hdr_omf *hdr = kbd->map_base;
+    uint32_t nbkts, first_pg;
+
+    memset(desc, 0, sizeof(*desc));
+
+    if (!kblock_hdr_valid(hdr))
+        return merr(EINVAL);
+
+    if (omf_kbh_version(hdr) < KBLOCK_HDR_VERSION7)
+        return 0;
+
+    nbkts = omf_kbh_hix_nbkts(hdr);
+    if (!nbkts)
+        return 0;
+
+    /* The index must lie within the written portion of the kblock.
+     */
+    first_pg = omf_kbh_hix_doff_pg(hdr);
+    if (ev(first_pg < KBLOCK_HDR_PAGES ||
+           (uint64_t)first_pg + kblock_hix_pgc(nbkts) > kbd->wlen_pages)) {
+        log_err("kblock %lx invalid hash index page %u buckets %u", kbd->mbid, first_pg, nbkts);
+        return merr(EINVAL);
+    }
+
+    desc->hix_bktv = kbd->map_base + (size_t)first_pg * PAGE_SIZE;
+    desc->hix_nbkts = nbkts;
+
+    return 0;
+}
+
+void
+kbr_hix_read_vref(
+    const void *base,
+    const struct kblock_hix_desc *hix,
+    const struct wbt_desc *wbd,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    uint64_t seq,
+    enum key_lookup_res *lookup_res,
+    struct vgmap *vgmap,
+    struct kvs_vtuple_ref *vref)
+{
+    const uint32_t fp = hash >> 32;
+    uint32_t bkt, n;
+
+    assert(hix->hix_nbkts > 0);
+
+    bkt = kblock_hix_bkt(hash, hix->hix_nbkts);
+
+    /* Entries whose fingerprint matches that of another key are rejected
+     * by the key comparison in wbtr_read_vref_at().
+     */
+    for (n = 0; n < hix->hix_nbkts; ++n) {
+        const struct kblock_hix_ent_omf *ent = hix->hix_bktv + bkt * KBLOCK_HIX_BKT_ENTRIES;
+
+        for (uint i = 0; i < KBLOCK_HIX_BKT_ENTRIES; ++i, ++ent) {
+            const uint node = omf_hxe_node(ent);
+
+            if (node == KBLOCK_HIX_NODE_EMPTY)
+                goto done;
+
+            if (omf_hxe_fp(ent) == fp &&
+                wbtr_read_vref_at(
+                    base, wbd, node, omf_hxe_slot(ent), kt, seq, lookup_res, vgmap, vref))
+                return;
+        }
+
+        if (++bkt == hix->hix_nbkts)
+            bkt = 0;
+    }
+
+done:
+    *lookup_res = NOT_FOUND;
+}
+
 merr_t
 kbr_read_metrics(struct kvs_mblk_desc *kblkdesc, struct kblk_metrics *metrics)
 {
@@ -14,6 +14,8 @@ struct cn;
 struct bloom_desc;
 struct wbt_desc;
 struct kvs_mblk_desc;
+struct kblock_hix_ent_omf;
+struct vgmap;
 
 struct kblk_metrics {
     uint32_t num_keys;
@@ -26,6 +28,16 @@ struct kblk_metrics {
     uint32_t tot_blm_pages;
 };
 
+/**
+ * struct kblock_hix_desc - kblock hash index descriptor
+ * @hix_bktv:  first entry of the first bucket (NULL if no hash index)
+ * @hix_nbkts: number of buckets
+ */
+struct kblock_hix_desc {
+    const struct kblock_hix_ent_omf *hix_bktv;
+    uint32_t hix_nbkts;
+};
+
 struct kblock_desc {
     struct cn *cn;
     struct kvs_mblk_desc *kd_mbd;
@@ -51,6 +63,44 @@ kbr_read_wbt_region_desc(struct kvs_mblk_desc *kblock_desc, struct wbt_desc *wbt
 merr_t
 kbr_read_blm_region_desc(struct kvs_mblk_desc *kblock_desc, struct bloom_desc *blm_desc);
 
+/**
+ * kbr_read_hix_region_desc() - Read the hash index region descriptor
+ *                          for the given KBLOCK ID.
+ * @kblock_desc:    KVBLOCK_DESC for KBLOCK to read
+ * @hix_desc:       (output) hash index descriptor
+ *
+ * Kblocks built without a hash index yield a descriptor with no buckets.
+ */
+merr_t
+kbr_read_hix_region_desc(struct kvs_mblk_desc *kblock_desc, struct kblock_hix_desc *hix_desc);
+
+/**
+ * kbr_hix_read_vref() - Look up a key via the kblock's hash index
+ * @base:       base address of the kblock
+ * @hix:        hash index descriptor (must have buckets)
+ * @wbd:        wbtree descriptor
+ * @kt:         key to search for
+ * @hash:       hash of the entire key
+ * @seq:        view sequence number
+ * @lookup_res: (output) as for wbtr_read_vref()
+ * @vgmap:      vgroup map to apply to vblock indexes (may be NULL)
+ * @vref:       (output) value metadata if found
+ *
+ * The probe sequence ends at the first empty entry, so a key absent from
+ * the kblock typically costs a single cache line.
+ */
+void
+kbr_hix_read_vref(
+    const void *base,
+    const struct kblock_hix_desc *hix,
+    const struct wbt_desc *wbd,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    uint64_t seq,
+    enum key_lookup_res *lookup_res,
+    struct vgmap *vgmap,
+    struct kvs_vtuple_ref *vref);
+
 /**
  * kbr_read_metrics() - Read kblock header to obtain metrics.
  *
@@ -19,6 +19,7 @@
 #include "cn_tree.h"
 #include "cn_tree_compact.h"
 #include "cn_tree_internal.h"
+#include "compact_slice.h"
 #include "kcompact.h"
 #include "kv_iterator.h"
 #include "kvset.h"
@@ -45,12 +46,16 @@ kv_item_compare(const void *a, const void *b)
  *   - Iterator iterv[i] must contain newer entries than iterv[i+1].
  */
 static merr_t
-kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
+kcompact(struct compact_slice *cs)
 {
+    struct cn_compaction_work *w = cs->cs_work;
+    struct cn_merge_stats *stats = cs->cs_stats;
+    struct kvset_builder *bldr = cs->cs_bldr;
     merr_t err;
     struct cn_kv_item *curr;
     struct bin_heap *bh = NULL;
     struct element_source **sources = NULL;
+    uint32_t *vbmv;
 
     enum kmd_vtype vtype;
     uint vbidx, vboff, vlen, complen;
@@ -72,43 +77,54 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
 
     uint seqno_errcnt = 0;
 
-    /* 'vbm_used' counts only the values referenced after this compaction;
-     * however, waste accumulates from compact-to-compact
-     */
-    w->cw_vbmap.vbm_used = 0;
-
-    if (w->cw_prog_interval && w->cw_progress)
+    if (cs->cs_progress && w->cw_prog_interval && w->cw_progress)
         tprog = jiffies;
 
     err = bin_heap_create(w->cw_kvset_cnt, kv_item_compare, &bh);
     if (ev(err))
         return err;
 
-    sources = malloc(w->cw_kvset_cnt * sizeof(*sources));
+    sources = malloc(w->cw_kvset_cnt * (sizeof(*sources) + sizeof(*vbmv)));
     if (!sources) {
         err = merr(ENOMEM);
         goto done;
     }
 
+    vbmv = (void *)(sources + w->cw_kvset_cnt);
+
     for (uint i = 0; i < w->cw_kvset_cnt; i++) {
-        struct kv_iterator *iter = w->cw_inputv[i];
+        struct kv_iterator *iter = cs->cs_inputv[i];
 
-        sources[i] = kvset_iter_es_get(iter);
+        sources[i] = iter ? kvset_iter_es_get(iter) : NULL;
+        if (sources[i])
+            sources[i]->es_sort = -1;
     }
 
     err = bin_heap_prepare(bh, w->cw_kvset_cnt, sources);
     if (ev(err))
         goto done;
-    /* In the event this assert fails, at least one iterator is EOF and the idea
-     * that struct element_source::es_sort will properly index the vblock map is
-     * incorrect. Kvsets won't typically exist if they have no prefix tombstones
-     * or keys.
-     */
-    assert(bin_heap_width(bh) == w->cw_kvset_cnt);
 
-    w->cw_stats.ms_srcs = w->cw_kvset_cnt;
+    /* bin_heap_prepare() packs the sources that are not at EOF, such that
+     * struct element_source::es_sort no longer indexes the vblock map if a
+     * slice has no keys in one of the input kvsets.  Build a map indexed by
+     * es_sort to the first vblock of each input kvset.
+     */
+    for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+        if (sources[i] && sources[i]->es_sort >= 0)
+            vbmv[sources[i]->es_sort] = w->cw_vbmap.vbm_map[i];
+    }
 
+    /* Skip the keys that precede this slice's key range.
+     */
     more = bin_heap_peek(bh, (void **)&curr);
+    while (more && compact_slice_lo(cs, &curr->kobj)) {
+        bin_heap_pop(bh, NULL);
+        more = bin_heap_peek(bh, (void **)&curr);
+    }
+
+    if (more && compact_slice_hi(cs, &curr->kobj))
+        more = false;
+
     while (more) {
         uint idx = curr->src->es_sort;
         struct kv_iterator *iter = kvset_cursor_es_h2r(curr->src);
@@ -139,8 +155,8 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
 
     values:
         vdata = NULL;
-        w->cw_stats.ms_keys_in++;
-        w->cw_stats.ms_key_bytes_in += key_obj_len(&curr->kobj);
+        stats->ms_keys_in++;
+        stats->ms_key_bytes_in += key_obj_len(&curr->kobj);
 
         while (horizon &&
                kvset_iter_next_vref(
@@ -161,7 +177,10 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
             dbg_prev_seq = seq;
 
             if (seq <= w->cw_horizon) {
-                horizon = false;
+                /* Values beneath a merge operand remain visible until
+                 * the operands are resolved by kv-compaction.
+                 */
+                horizon = (vtype == VTYPE_MOPND);
                 if (pt_set && seq < pt_seq)
                     continue; /* skip value */
 
@@ -191,13 +210,15 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
                 switch (vtype) {
                 case VTYPE_UCVAL:
                 case VTYPE_CVAL:
-                    err = kvset_builder_add_vref(
-                        bldr, seq, vbidx + w->cw_vbmap.vbm_map[idx], vboff, vlen, complen);
+                    err = kvset_builder_add_vref(bldr, seq, vbidx + vbmv[idx], vboff, vlen, complen);
                     break;
                 case VTYPE_ZVAL:
                 case VTYPE_IVAL:
                     err = kvset_builder_add_val(bldr, &curr->kobj, vdata, vlen, seq, 0);
                     break;
+                case VTYPE_MOPND:
+                    err = kvset_builder_add_mopnd(bldr, seq, vdata, vlen);
+                    break;
                 default:
                     err = kvset_builder_add_nonval(bldr, seq, vtype);
                     break;
@@ -212,11 +233,11 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
                     emitted_seq = seq;
 
                 if (complen) {
-                    w->cw_stats.ms_val_bytes_out += complen;
-                    w->cw_vbmap.vbm_used += complen;
+                    stats->ms_val_bytes_out += complen;
+                    cs->cs_vused += complen;
                 } else {
-                    w->cw_stats.ms_val_bytes_out += vlen;
-                    w->cw_vbmap.vbm_used += vlen;
+                    stats->ms_val_bytes_out += vlen;
+                    cs->cs_vused += vlen;
                 }
             } else {
                 /* The only time we ever land here is when the same
@@ -258,6 +279,9 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
          */
         bin_heap_pop(bh, NULL);
         more = bin_heap_peek(bh, (void **)&curr);
+        if (more && compact_slice_hi(cs, &curr->kobj))
+            more = false;
+
         if (more) {
             iter = kvset_cursor_es_h2r(curr->src);
             idx = curr->src->es_sort;
@@ -276,13 +300,12 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
             err = kvset_builder_add_key(bldr, &prev_kobj);
             if (ev(err))
                 goto done;
-            w->cw_stats.ms_keys_out++;
-            w->cw_stats.ms_key_bytes_out += key_obj_len(&prev_kobj);
+            stats->ms_keys_out++;
+            stats->ms_key_bytes_out += key_obj_len(&prev_kobj);
         }
     }
 
 done:
-    w->cw_vbmap.vbm_waste = w->cw_vbmap.vbm_tot - w->cw_vbmap.vbm_used;
     bin_heap_destroy(bh);
     free(sources);
 
@@ -313,7 +336,14 @@ cn_kcompact(struct cn_compaction_work *w)
 
     kvset_builder_set_merge_stats(bldr, &w->cw_stats);
 
-    err = kcompact(w, bldr);
+    /* 'vbm_used' counts only the values referenced after this compaction;
+     * however, waste accumulates from compact-to-compact
+     */
+    w->cw_vbmap.vbm_used = 0;
+    w->cw_stats.ms_srcs = w->cw_kvset_cnt;
+
+    err = compact_slice_run(w, compact_slice_count(w, false), kcompact, bldr);
+    w->cw_vbmap.vbm_waste = w->cw_vbmap.vbm_tot - w->cw_vbmap.vbm_used;
     if (ev(err))
         goto done;
 
@@ -11,9 +11,11 @@
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
@@ -23,6 +25,7 @@
 #include "cn_tree.h"
 #include "cn_tree_compact.h"
 #include "cn_tree_internal.h"
+#include "compact_slice.h"
 #include "kv_iterator.h"
 #include "kvcompact.h"
 #include "kvset.h"
@@ -82,12 +85,172 @@ get_direct_read_buf(uint len, bool aligned_voff, uint32_t *bufsz, void **buf)
     return 0;
 }
 
-merr_t
-cn_kvcompact(struct cn_compaction_work *w)
+/* Merge operands of the current key that are at or below the horizon are
+ * collected (newest first) until the key's base value is found, at which
+ * point the operands are collapsed into a new base value by the kvs's merge
+ * operator.  If the base value might reside in an older kvset outside of this
+ * compaction then the operands are emitted as is.
+ */
+struct kvcompact_opnd {
+    uint64_t ko_seq;
+    uint ko_len;
+    uint8_t ko_data[HSE_KVS_MERGE_OPND_LEN_MAX];
+};
+
+struct kvcompact_merge {
+    hse_kvs_merge_fn *km_fn;
+    struct kvcompact_opnd *km_opndv;
+    const void **km_datav;
+    size_t *km_lenv;
+    uint km_opndc;
+    uint km_opndmax;
+    bool km_nobase;
+    void *km_buf; /* key, decompressed base, and merged value */
+};
+
+static merr_t
+kvcompact_opnd_add(struct kvcompact_merge *km, const void *vdata, uint vlen, uint64_t seq)
+{
+    struct kvcompact_opnd *opnd;
+
+    if (km->km_opndc >= km->km_opndmax) {
+        uint max = km->km_opndmax ? km->km_opndmax * 2 : 8;
+        void *p;
+
+        p = realloc(km->km_opndv, max * sizeof(*km->km_opndv));
+        if (ev(!p))
+            return merr(ENOMEM);
+        km->km_opndv = p;
+
+        p = realloc(km->km_datav, max * sizeof(*km->km_datav));
+        if (ev(!p))
+            return merr(ENOMEM);
+        km->km_datav = p;
+
+        p = realloc(km->km_lenv, max * sizeof(*km->km_lenv));
+        if (ev(!p))
+            return merr(ENOMEM);
+        km->km_lenv = p;
+
+        km->km_opndmax = max;
+    }
+
+    assert(vlen <= sizeof(opnd->ko_data));
+
+    opnd = km->km_opndv + km->km_opndc++;
+    opnd->ko_seq = seq;
+    opnd->ko_len = min_t(uint, vlen, sizeof(opnd->ko_data));
+    memcpy(opnd->ko_data, vdata, opnd->ko_len);
+
+    return 0;
+}
+
+/* Emit the collected operands as is, newest first.
+ */
+static merr_t
+kvcompact_opnd_flush(struct kvcompact_merge *km, struct kvset_builder *bldr, uint64_t *vbytes)
+{
+    for (uint i = 0; i < km->km_opndc; i++) {
+        struct kvcompact_opnd *opnd = km->km_opndv + i;
+        merr_t err;
+
+        err = kvset_builder_add_mopnd(bldr, opnd->ko_seq, opnd->ko_data, opnd->ko_len);
+        if (ev(err))
+            return err;
+
+        *vbytes += opnd->ko_len;
+    }
+
+    km->km_opndc = 0;
+
+    return 0;
+}
+
+/* Collapse the collected operands and the given base value (which is NULL if
+ * the key has no base value) into a new value whose seqno is that of the
+ * newest operand.  If the merge operator fails then the operands are emitted
+ * as is and *merged is set to false, in which case the caller must emit the
+ * base value.
+ */
+static merr_t
+kvcompact_opnd_merge(
+    struct kvcompact_merge *km,
+    struct kvset_builder *bldr,
+    const struct key_obj *kobj,
+    const void *base,
+    uint baselen,
+    uint complen,
+    uint64_t *vbytes,
+    bool *merged)
+{
+    const size_t vmax = HSE_KVS_VALUE_LEN_MAX;
+    void *kbuf, *basebuf, *outbuf;
+    size_t outlen = 0;
+    uint klen, n;
+    merr_t err;
+    int rc;
+
+    assert(km->km_fn && km->km_opndc > 0);
+
+    *merged = false;
+
+    if (!km->km_buf) {
+        km->km_buf = malloc(HSE_KVS_KEY_LEN_MAX + 2 * vmax);
+        if (ev(!km->km_buf))
+            return merr(ENOMEM);
+    }
+
+    kbuf = km->km_buf;
+    basebuf = kbuf + HSE_KVS_KEY_LEN_MAX;
+    outbuf = basebuf + vmax;
+
+    key_obj_copy(kbuf, HSE_KVS_KEY_LEN_MAX, &klen, kobj);
+
+    if (base && complen > 0) {
+        err = vcomp_decompress(base, complen, basebuf, vmax, &baselen);
+        if (ev(err))
+            return err;
+
+        base = basebuf;
+    }
+
+    /* The merge operator takes the operands oldest first.
+     */
+    n = km->km_opndc;
+    for (uint i = 0; i < n; i++) {
+        km->km_datav[i] = km->km_opndv[n - i - 1].ko_data;
+        km->km_lenv[i] = km->km_opndv[n - i - 1].ko_len;
+    }
+
+    rc = km->km_fn(kbuf, klen, base, baselen, n, km->km_datav, km->km_lenv, outbuf, vmax, &outlen);
+    if (ev(rc || outlen > vmax)) {
+        log_warn("merge operator failed: rc %d, outlen %zu", rc, outlen);
+        return kvcompact_opnd_flush(km, bldr, vbytes);
+    }
+
+    err = kvset_builder_add_val(bldr, kobj, outbuf, outlen, km->km_opndv[0].ko_seq, 0);
+    if (ev(err))
+        return err;
+
+    *vbytes += outlen;
+    km->km_opndc = 0;
+    *merged = true;
+
+    return 0;
+}
+
+/**
+ * kvcompact() - merge the keys and values of one slice into a new kvset
+ */
+static merr_t
+kvcompact(struct compact_slice *cs)
 {
+    struct cn_compaction_work *w = cs->cs_work;
+    struct cn_merge_stats *stats = cs->cs_stats;
+    struct kvset_builder *bldr = cs->cs_bldr;
     struct bin_heap *bh = 0;
-    struct kvset_builder *bldr = NULL;
     struct key_obj prev_kobj = { 0 };
+    struct kvcompact_merge km = { 0 };
 
     uint vlen, complen, omlen, direct_read_len;
     uint curr_klen HSE_MAYBE_UNUSED;
@@ -114,7 +277,7 @@ cn_kvcompact(struct cn_compaction_work *w)
     struct element_source **bh_sources;
 
     assert(w->cw_kvset_cnt);
-    assert(w->cw_inputv);
+    assert(cs->cs_inputv);
 
     bh_sources = malloc(w->cw_kvset_cnt * sizeof(*bh_sources));
     if (!bh_sources)
@@ -124,7 +287,7 @@ cn_kvcompact(struct cn_compaction_work *w)
     if (err)
         goto out;
 
-    if (w->cw_prog_interval && w->cw_progress)
+    if (cs->cs_progress && w->cw_prog_interval && w->cw_progress)
         tprog = jiffies;
 
     /* We must issue a direct read for all values that will not fit into the vblock readahead
@@ -135,36 +298,36 @@ cn_kvcompact(struct cn_compaction_work *w)
     direct_read_len = w->cw_rp->cn_compact_vblk_ra;
     direct_read_len -= PAGE_SIZE;
 
-    w->cw_kvsetidv[0] = cndb_kvsetid_mint(cn_tree_get_cndb(w->cw_tree));
-
-    err = kvset_builder_create(&bldr, cn_tree_get_cn(w->cw_tree), w->cw_pc, w->cw_kvsetidv[0]);
-    if (err)
-        goto out;
-
-    kvset_builder_set_merge_stats(bldr, &w->cw_stats);
-
-    err = kvset_builder_set_agegroup(bldr, HSE_MPOLICY_AGE_LEAF);
-    if (err)
-        goto out;
-
     new_key = true;
 
     tstart = perfc_ison(w->cw_pc, PERFC_DI_CNCOMP_VGET) ? 1 : 0;
 
+    km.km_fn = cn_get_merge_fn(cn_tree_get_cn(w->cw_tree));
+
     for (uint i = 0; i < w->cw_kvset_cnt; i++) {
-        struct kv_iterator *iter = w->cw_inputv[i];
+        struct kv_iterator *iter = cs->cs_inputv[i];
 
-        bh_sources[i] = kvset_iter_es_get(iter);
+        bh_sources[i] = iter ? kvset_iter_es_get(iter) : NULL;
     }
 
     err = bin_heap_prepare(bh, w->cw_kvset_cnt, bh_sources);
     if (err)
         goto out;
 
+    /* Skip the keys that precede this slice's key range.
+     */
     more = bin_heap_peek(bh, (void **)&curr);
-    if (curr) {
-        w->cw_stats.ms_keys_in++;
-        w->cw_stats.ms_key_bytes_in += key_obj_len(&curr->kobj);
+    while (more && compact_slice_lo(cs, &curr->kobj)) {
+        bin_heap_pop(bh, NULL);
+        more = bin_heap_peek(bh, (void **)&curr);
+    }
+
+    if (more && compact_slice_hi(cs, &curr->kobj))
+        more = false;
+
+    if (more) {
+        stats->ms_keys_in++;
+        stats->ms_key_bytes_in += key_obj_len(&curr->kobj);
     }
 
     while (more) {
@@ -178,6 +341,7 @@ cn_kvcompact(struct cn_compaction_work *w)
             emitted_val = false;
             emitted_seq = 0;
             emitted_seq_pt = 0;
+            km.km_nobase = false;
 
             dbg_prev_seq = 0;
             dbg_prev_idx = 0;
@@ -235,8 +399,10 @@ cn_kvcompact(struct cn_compaction_work *w)
 
             bg_val = (seq <= w->cw_horizon);
 
-            if (bg_val && pt_set && w->cw_horizon >= pt_seq && pt_seq > seq)
+            if (bg_val && pt_set && w->cw_horizon >= pt_seq && pt_seq > seq) {
+                km.km_nobase = true;
                 break; /* drop val if it and pt are beyond horizon */
+            }
 
             /* Set ptomb context irrespective of bg_val for tombstone propagation */
             if (HSE_CORE_IS_PTOMB(vdata)) {
@@ -255,20 +421,60 @@ cn_kvcompact(struct cn_compaction_work *w)
             /* Compare seq to emitted_seq to ensure when a key has values in two kvsets with
              * the same sequence number, then only the value from the first kvset is emitted.
              */
+            if (should_emit && bg_val && km.km_fn && vtype != VTYPE_PTOMB) {
+                bool merged;
+
+                if (vtype == VTYPE_MOPND) {
+                    err = kvcompact_opnd_add(&km, vdata, vlen, seq);
+                    if (err)
+                        break;
+
+                    emitted_val = true;
+                    emitted_seq = seq;
+                    bg_val = false;
+                    continue; /* keep looking for the base value */
+                }
+
+                if (km.km_opndc > 0) {
+                    const void *base = (vtype == VTYPE_ZVAL) ? "" : vdata;
+
+                    if (vtype == VTYPE_TOMB)
+                        base = NULL;
+
+                    err = kvcompact_opnd_merge(
+                        &km, bldr, &curr->kobj, base, base ? vlen : 0, complen,
+                        &stats->ms_val_bytes_out, &merged);
+                    if (err)
+                        break;
+
+                    if (merged)
+                        continue; /* the base value is obsolete */
+                }
+            }
+
             if (should_emit) {
                 if (w->cw_drop_tombs && HSE_CORE_IS_TOMB(vdata) && bg_val)
                     continue; /* skip value */
 
-                err = kvset_builder_add_val(bldr, &curr->kobj, vdata, vlen, seq, complen);
+                if (vtype == VTYPE_MOPND)
+                    err = kvset_builder_add_mopnd(bldr, seq, vdata, vlen);
+                else
+                    err = kvset_builder_add_val(bldr, &curr->kobj, vdata, vlen, seq, complen);
                 if (err)
                     break;
 
-                w->cw_stats.ms_val_bytes_out += complen ? complen : vlen;
+                stats->ms_val_bytes_out += complen ? complen : vlen;
                 emitted_val = true;
                 if (HSE_CORE_IS_PTOMB(vdata))
                     emitted_seq_pt = seq;
                 else
                     emitted_seq = seq;
+
+                /* Without a merge operator the values beneath an operand
+                 * remain visible and must be retained.
+                 */
+                if (vtype == VTYPE_MOPND)
+                    bg_val = false;
             } else {
                 /* The same key can appear in two input kvsets with overlapping sequence
                  * numbers. The following assertions verify that we aren't here for other
@@ -305,9 +511,12 @@ cn_kvcompact(struct cn_compaction_work *w)
         bin_heap_pop(bh, NULL);
         more = bin_heap_peek(bh, (void **)&curr);
 
-        if (curr) {
-            w->cw_stats.ms_keys_in++;
-            w->cw_stats.ms_key_bytes_in += key_obj_len(&curr->kobj);
+        if (more && compact_slice_hi(cs, &curr->kobj))
+            more = false;
+
+        if (more) {
+            stats->ms_keys_in++;
+            stats->ms_key_bytes_in += key_obj_len(&curr->kobj);
         }
 
         if (more) {
@@ -321,13 +530,30 @@ cn_kvcompact(struct cn_compaction_work *w)
             }
         }
 
+        /* The base value of a key with pending operands was not found, hence
+         * the operands can be collapsed only if the key has no base value.
+         */
+        if (km.km_opndc > 0) {
+            bool merged = false;
+
+            if (km.km_nobase || w->cw_drop_tombs)
+                err = kvcompact_opnd_merge(
+                    &km, bldr, &prev_kobj, NULL, 0, 0, &stats->ms_val_bytes_out, &merged);
+            if (!err && !merged)
+                err = kvcompact_opnd_flush(&km, bldr, &stats->ms_val_bytes_out);
+            if (err)
+                goto out;
+
+            assert(emitted_val);
+        }
+
         if (emitted_val) {
             err = kvset_builder_add_key(bldr, &prev_kobj);
             if (err)
                 goto out;
 
-            w->cw_stats.ms_keys_out++;
-            w->cw_stats.ms_key_bytes_out += key_obj_len(&prev_kobj);
+            stats->ms_keys_out++;
+            stats->ms_key_bytes_out += key_obj_len(&prev_kobj);
         }
 
         new_key = true;
@@ -347,15 +573,14 @@ cn_kvcompact(struct cn_compaction_work *w)
         }
     }
 
-    err = kvset_builder_get_mblocks(bldr, &w->cw_outv[0]);
-    if (!err)
-        w->cw_output_nodev[0] = w->cw_node;
-
 out:
-    kvset_builder_destroy(bldr);
     bin_heap_destroy(bh);
     free(bh_sources);
     free(buf);
+    free(km.km_buf);
+    free(km.km_opndv);
+    free(km.km_datav);
+    free(km.km_lenv);
 
     if (seqno_errcnt)
         log_warn("seqno errcnt %u", seqno_errcnt);
@@ -365,3 +590,40 @@ out:
 
     return err;
 }
+
+merr_t
+cn_kvcompact(struct cn_compaction_work *w)
+{
+    struct kvset_builder *bldr = NULL;
+    merr_t err;
+
+    assert(w->cw_kvset_cnt);
+    assert(w->cw_inputv);
+
+    w->cw_kvsetidv[0] = cndb_kvsetid_mint(cn_tree_get_cndb(w->cw_tree));
+
+    err = kvset_builder_create(&bldr, cn_tree_get_cn(w->cw_tree), w->cw_pc, w->cw_kvsetidv[0]);
+    if (err)
+        return err;
+
+    kvset_builder_set_merge_stats(bldr, &w->cw_stats);
+
+    err = kvset_builder_set_agegroup(bldr, HSE_MPOLICY_AGE_LEAF);
+    if (!err && cn_node_ishot(w->cw_node, w->cw_rp))
+        err = kvset_builder_set_value_agegroup(bldr, HSE_MPOLICY_AGE_ROOT);
+    if (err)
+        goto out;
+
+    err = compact_slice_run(w, compact_slice_count(w, true), kvcompact, bldr);
+    if (err)
+        goto out;
+
+    err = kvset_builder_get_mblocks(bldr, &w->cw_outv[0]);
+    if (!err)
+        w->cw_output_nodev[0] = w->cw_node;
+
+out:
+    kvset_builder_destroy(bldr);
+
+    return err;
+}
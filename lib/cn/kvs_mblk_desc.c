@@ -42,6 +42,7 @@ mblk_mmap(struct mpool *mp, uint64_t mbid, struct kvs_mblk_desc *md)
     md->wlen_pages = props.mpr_write_len / PAGE_SIZE;
     md->ra_pages = props.mpr_ra_pages;
     md->mclass = props.mpr_mclass;
+    md->cached = 0;
     md->mbid = mbid;
 
     /* Verify mappings to pages and smaller int types don't lose information.
@@ -84,7 +85,10 @@ mblk_madvise_pages(const struct kvs_mblk_desc *md, size_t pg, size_t pg_cnt, int
     if (pg + pg_cnt > wlen_pages)
         pg_cnt = wlen_pages - pg;
 
-    if (pg_cnt == 0)
+    /* Cached mblocks are resident in anonymous memory, where readahead
+     * is moot and MADV_DONTNEED would discard their contents.
+     */
+    if (pg_cnt == 0 || md->cached)
         return 0;
 
     ra_pages = (advice == MADV_WILLNEED) ? md->ra_pages : pg_cnt;
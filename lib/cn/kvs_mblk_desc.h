@@ -26,6 +26,7 @@ struct kvs_mblk_desc {
     uint16_t wlen_pages; // written length of mblock, in 4K pages
     uint16_t ra_pages;   // max readahead pages
     uint8_t mclass;      // media class
+    uint8_t cached;      // map_base refers to an mblock cache copy
 };
 
 static_assert(
@@ -7,6 +7,7 @@
 
 #include <sys/mman.h>
 
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/kvdb_perfc.h>
 #include <hse/limits.h>
 
@@ -20,7 +21,6 @@
 #include <hse/util/alloc.h>
 #include <hse/util/assert.h>
 #include <hse/util/bloom_filter.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/condvar.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/keycmp.h>
@@ -54,6 +54,7 @@
 #include "kvset.h"
 #include "kvset_internal.h"
 #include "kvset_split.h"
+#include "mbcache.h"
 #include "mbset.h"
 #include "omf.h"
 #include "vblock_reader.h"
@@ -220,6 +221,24 @@ kvset_put_ref(struct kvset *ks)
     cn_work_submit(cn, kvset_put_ref_work, &ks->ks_kvset_cn_work);
 }
 
+/* Register the wbtree regions of a kblock or the ptree of an hblock with the
+ * mblock cache, see kbr_madvise_wbt_leaf_nodes() et al for the layout.
+ */
+static void
+kvset_wbt_mbcache_init(struct mbcache_map *map, const struct wbt_desc *wbd)
+{
+    const uint32_t pg = wbd->wbd_first_page;
+
+    if (!map || !wbd->wbd_n_pages)
+        return;
+
+    mbcache_extent_set(map, MBC_EXT_WBT_LEAF, pg, wbd->wbd_leaf_cnt);
+    mbcache_extent_set(
+        map, MBC_EXT_WBT_INT, pg + wbd->wbd_leaf_cnt,
+        wbd->wbd_n_pages - wbd->wbd_leaf_cnt - wbd->wbd_kmd_pgc);
+    mbcache_extent_set(map, MBC_EXT_KMD, pg + wbd->wbd_root + 1, wbd->wbd_kmd_pgc);
+}
+
 static merr_t
 kvset_hblk_init(
     struct mpool *mpool,
@@ -240,7 +259,7 @@ kvset_hblk_init(
     *vgmap_out = NULL;
     *use_vgmap = false;
 
-    err = mblk_mmap(mpool, mbid, hbd);
+    err = mbcache_mmap(mpool, mbid, hbd, &blk->kh_mbcm);
     if (ev(err))
         return err;
 
@@ -252,6 +271,8 @@ kvset_hblk_init(
     if (err)
         return err;
 
+    kvset_wbt_mbcache_init(blk->kh_mbcm, &blk->kh_ptree_desc);
+
     err = hbr_read_metrics(hbd, &blk->kh_metrics);
     if (err)
         return err;
@@ -305,7 +326,7 @@ kvset_kblk_init(struct kvs_rparams *rp, struct mpool *ds, uint64_t mbid, struct
     struct kblock_hdr_omf *hdr;
     merr_t err;
 
-    err = mblk_mmap(ds, mbid, kbd);
+    err = mbcache_mmap(ds, mbid, kbd, &p->kb_mbcm);
     if (ev(err))
         return err;
 
@@ -317,10 +338,26 @@ kvset_kblk_init(struct kvs_rparams *rp, struct mpool *ds, uint64_t mbid, struct
     if (ev(err))
         return err;
 
+    err = kbr_read_hix_region_desc(kbd, &p->kb_hix_desc);
+    if (ev(err))
+        return err;
+
     err = kbr_read_metrics(kbd, &p->kb_metrics);
     if (ev(err))
         return err;
 
+    kvset_wbt_mbcache_init(p->kb_mbcm, &p->kb_wbt_desc);
+
+    if (p->kb_blm_desc.bd_bitmap)
+        mbcache_extent_set(
+            p->kb_mbcm, MBC_EXT_FILTER, p->kb_blm_desc.bd_first_page, p->kb_blm_desc.bd_n_pages);
+
+    if (p->kb_hix_desc.hix_nbkts)
+        mbcache_extent_set(
+            p->kb_mbcm, MBC_EXT_HIX,
+            ((const void *)p->kb_hix_desc.hix_bktv - kbd->map_base) / PAGE_SIZE,
+            kblock_hix_pgc(p->kb_hix_desc.hix_nbkts));
+
     hdr = p->kb_kblk_desc.map_base;
 
     /* Cache min/max key ptrs and lengths, and initialize the
@@ -369,6 +406,33 @@ vblock_udata_init(const struct kvs_mblk_desc *mblk, void *rock)
     return vbr_desc_read(mblk, rock);
 }
 
+/* Vgroups whose keys all follow those of the preceding vgroup (e.g., the
+ * per-slice vgroups of a range-partitioned kv-compaction) do not scatter
+ * reads, so they are not counted.
+ */
+static uint32_t
+kvset_vgroup_scatter(struct kvset *ks)
+{
+    uint32_t nvgroups = kvset_get_vgroups(ks);
+    uint32_t scatter = nvgroups;
+
+    for (uint32_t i = 1; i < nvgroups; i++) {
+        const struct vblock_desc *prev, *next;
+        struct key_obj max, min;
+
+        prev = kvset_get_nth_vblock_desc(ks, vgmap_vbidx_out_end(ks, i - 1));
+        next = kvset_get_nth_vblock_desc(ks, vgmap_vbidx_out_start(ks, i));
+
+        key2kobj(&max, prev->vbd_mblkdesc->map_base + prev->vbd_max_koff, prev->vbd_max_klen);
+        key2kobj(&min, next->vbd_mblkdesc->map_base + next->vbd_min_koff, next->vbd_min_klen);
+
+        if (key_obj_cmp(&max, &min) < 0)
+            scatter--;
+    }
+
+    return scatter;
+}
+
 merr_t
 kvset_open2(
     struct cn_tree *tree,
@@ -559,10 +623,12 @@ kvset_open2(
              * pages will eventually be reclaimed by the VMM.
              * For debug builds, we remove all access rights
              * to the kblock header in order to catch those
-             * who might otherwise try to access it.
+             * who might otherwise try to access it (unless the
+             * kblock is cached, as then it may be shared).
              */
 #if defined(HSE_BUILD_DEBUG) && !defined(NDEBUG)
-            mprotect(kb->kb_kblk_desc.map_base, PAGE_SIZE, PROT_NONE);
+            if (!kb->kb_kblk_desc.cached)
+                mprotect(kb->kb_kblk_desc.map_base, PAGE_SIZE, PROT_NONE);
 #endif
         }
     }
@@ -674,6 +740,8 @@ kvset_open2(
         free(vgroupv);
     }
 
+    ks->ks_scatter = kvset_vgroup_scatter(ks);
+
     /* begin life with one ref and not deleting */
     kvset_get_ref(ks);
     ks->ks_deleted = DEL_NONE;
@@ -838,7 +906,7 @@ cleanup_kblocks(struct kvset *ks)
     merr_t err = 0;
 
     for (uint32_t i = 0; i < ks->ks_st.kst_kblks; i++) {
-        err = mblk_munmap(ks->ks_mp, &ks->ks_kblks[i].kb_kblk_desc);
+        err = mbcache_munmap(ks->ks_mp, &ks->ks_kblks[i].kb_kblk_desc, ks->ks_kblks[i].kb_mbcm);
         ev(err);
     }
 
@@ -864,7 +932,7 @@ cleanup_hblock(struct kvset *ks)
 {
     merr_t err;
 
-    err = mblk_munmap(ks->ks_mp, &ks->ks_hblk.kh_hblk_desc);
+    err = mbcache_munmap(ks->ks_mp, &ks->ks_hblk.kh_hblk_desc, ks->ks_hblk.kh_mbcm);
     ev(err);
 
     if (ks->ks_deleted == DEL_NONE || ks->ks_deleted == DEL_LIST)
@@ -1067,8 +1135,17 @@ kvset_kblk_start(struct kvset *ks, const void *key, int len, bool reverse)
     }
 }
 
+static HSE_ALWAYS_INLINE uint64_t
+kblk_bloom_hash(const struct kvset *ks, const struct kvs_ktuple *kt)
+{
+    if (ks->ks_rp->kvs_sfxlen)
+        return key_hash64(kt->kt_data, kt->kt_len);
+
+    return kt->kt_hash;
+}
+
 static merr_t
-kblk_get_value_ref(
+kblk_get_value_ref_nobloom(
     struct kvset *ks,
     uint kblk_idx,
     struct kvs_ktuple *kt,
@@ -1077,13 +1154,21 @@ kblk_get_value_ref(
     struct kvs_vtuple_ref *vref)
 {
     struct kvset_kblk *kblk = ks->ks_kblks + kblk_idx;
-    uint64_t hash = kt->kt_hash;
 
-    if (ks->ks_rp->kvs_sfxlen)
-        hash = key_hash64(kt->kt_data, kt->kt_len);
+    if (kblk->kb_hix_desc.hix_nbkts) {
+        mbcache_touch(
+            kblk->kb_mbcm,
+            MBC_EXT_MASK(MBC_EXT_HIX) | MBC_EXT_MASK(MBC_EXT_WBT_LEAF) | MBC_EXT_MASK(MBC_EXT_KMD));
 
-    if (!bloom_reader_lookup(&kblk->kb_blm_desc, hash))
+        kbr_hix_read_vref(
+            kblk->kb_kblk_desc.map_base, &kblk->kb_hix_desc, &kblk->kb_wbt_desc, kt,
+            kblk_bloom_hash(ks, kt), seq, result, ks->ks_use_vgmap ? ks->ks_vgmap : NULL, vref);
         return 0;
+    }
+
+    mbcache_touch(
+        kblk->kb_mbcm,
+        MBC_EXT_MASK(MBC_EXT_WBT_INT) | MBC_EXT_MASK(MBC_EXT_WBT_LEAF) | MBC_EXT_MASK(MBC_EXT_KMD));
 
     return wbtr_read_vref(
         kblk->kb_kblk_desc.map_base, &kblk->kb_wbt_desc, kt, seq, result,
@@ -1105,6 +1190,11 @@ kvset_ptomb_lookup(
 
         kvs_ktuple_init_nohash(&pfx, kt->kt_data, ks->ks_pfx_len);
 
+        mbcache_touch(
+            ks->ks_hblk.kh_mbcm,
+            MBC_EXT_MASK(MBC_EXT_WBT_INT) | MBC_EXT_MASK(MBC_EXT_WBT_LEAF) |
+                MBC_EXT_MASK(MBC_EXT_KMD));
+
         err = wbtr_read_vref(
             ks->ks_hblk.kh_hblk_desc.map_base, &ks->ks_hblk.kh_ptree_desc, &pfx, view_seq, res,
             ks->ks_use_vgmap ? ks->ks_vgmap : NULL, vref);
@@ -1115,33 +1205,27 @@ kvset_ptomb_lookup(
     return 0;
 }
 
-static merr_t
-kvset_lookup_vref(
-    struct kvset *ks,
-    struct kvs_ktuple *kt,
-    const struct key_disc *kdisc,
-    uint64_t seq,
-    enum key_lookup_res *result,
-    struct kvs_vtuple_ref *vref)
+/**
+ * kvset_kblk_find() - find the kblock that might contain a key
+ * @ks:     kvset to search
+ * @kt:     key to search for
+ * @kdisc:  key discriminator of @kt
+ *
+ * Return: Index of the only kblock in which @kt might reside,
+ * or -1 if @kt falls outside the bounds of all kblocks.
+ */
+static int
+kvset_kblk_find(struct kvset *ks, const struct kvs_ktuple *kt, const struct key_disc *kdisc)
 {
     int first, last;
     int rc, i;
     int lcp;
-    merr_t err;
-
-    enum key_lookup_res pt_result;
-    struct kvs_vtuple_ref pt_vref;
 
     lcp = 0;
 
     first = 0;
     last = ks->ks_st.kst_kblks - 1;
 
-    pt_result = NOT_FOUND;
-    err = kvset_ptomb_lookup(ks, kt, seq, &pt_result, &pt_vref);
-    if (ev(err))
-        return err;
-
     /* If (kvset->ks_lcp > 0) then all keys in the kvset have a common
      * prefix of at least kvset->ks_lcp bytes.  Here we compute the
      * longest common prefix between the kvset and the target key.
@@ -1161,11 +1245,11 @@ kvset_lookup_vref(
      */
     rc = key_disc_cmp(kdisc, &ks->ks_kdisc_max);
     if (rc > 0)
-        goto done;
+        return -1;
 
     rc = key_disc_cmp(kdisc, &ks->ks_kdisc_min);
     if (rc < 0)
-        goto done;
+        return -1;
 
 search:
     while (first <= last) {
@@ -1181,14 +1265,45 @@ search:
             continue;
         }
 
-        err = kblk_get_value_ref(ks, i, kt, seq, result, vref);
+        return i;
+    }
+
+    return -1;
+}
+
+/**
+ * kvset_lookup_vref_kblk() - search a kvset for a key given its kblock
+ * @ks:       kvset to search
+ * @kt:       key to search for
+ * @kblk_idx: kblock that might contain @kt per its bloom (-1 if none)
+ * @seq:      view sequence number
+ * @result:   (output) lookup result
+ * @vref:     (output) value reference
+ */
+static merr_t
+kvset_lookup_vref_kblk(
+    struct kvset *ks,
+    struct kvs_ktuple *kt,
+    int kblk_idx,
+    uint64_t seq,
+    enum key_lookup_res *result,
+    struct kvs_vtuple_ref *vref)
+{
+    enum key_lookup_res pt_result;
+    struct kvs_vtuple_ref pt_vref;
+    merr_t err;
+
+    pt_result = NOT_FOUND;
+    err = kvset_ptomb_lookup(ks, kt, seq, &pt_result, &pt_vref);
+    if (ev(err))
+        return err;
+
+    if (kblk_idx >= 0) {
+        err = kblk_get_value_ref_nobloom(ks, kblk_idx, kt, seq, result, vref);
         if (ev(err))
             return err;
-
-        break;
     }
 
-done:
     if (pt_result == FOUND_PTMB) {
         if (*result == NOT_FOUND || pt_vref.vr_seq > vref->vr_seq) {
             *result = pt_result;
@@ -1199,6 +1314,52 @@ done:
     return 0;
 }
 
+void
+kvset_lookup_filter(
+    struct kvset *const *kvsetv,
+    uint kvsetc,
+    const struct kvs_ktuple *kt,
+    const struct key_disc *kdisc,
+    int *kblkv)
+{
+    const struct bloom_desc *descv[KVSET_FILTER_MAX];
+    uint64_t hashv[KVSET_FILTER_MAX];
+    bool hitv[KVSET_FILTER_MAX];
+    uint idxv[KVSET_FILTER_MAX];
+    uint64_t hash;
+    uint i, n;
+
+    INVARIANT(kvsetc <= KVSET_FILTER_MAX);
+
+    if (kvsetc == 0)
+        return;
+
+    /* All the kvsets are from the same kvs and hence hash keys the same way.
+     */
+    hash = kblk_bloom_hash(kvsetv[0], kt);
+
+    for (i = n = 0; i < kvsetc; ++i) {
+        struct kvset *ks = kvsetv[i];
+
+        kblkv[i] = kvset_kblk_find(ks, kt, kdisc);
+        if (kblkv[i] < 0)
+            continue;
+
+        mbcache_touch(ks->ks_kblks[kblkv[i]].kb_mbcm, MBC_EXT_MASK(MBC_EXT_FILTER));
+
+        descv[n] = &ks->ks_kblks[kblkv[i]].kb_blm_desc;
+        hashv[n] = hash;
+        idxv[n++] = i;
+    }
+
+    bloom_reader_lookup_batch(descv, hashv, n, hitv);
+
+    for (i = 0; i < n; ++i) {
+        if (!hitv[i])
+            kblkv[idxv[i]] = -1;
+    }
+}
+
 static merr_t
 kvset_get_immediate_value(struct kvs_vtuple_ref *vref, struct kvs_buf *vbuf)
 {
@@ -1328,7 +1489,7 @@ kvset_lookup_val_direct_decompress(
     } else {
         src = iov.iov_base + (vboff & ~PAGE_MASK);
 
-        err = compress_lz4_ops.cop_decompress(src, omlen, vbuf, copylen, outlenp);
+        err = vcomp_decompress(src, omlen, vbuf, copylen, outlenp);
     }
 
     if (freeme)
@@ -1337,6 +1498,15 @@ kvset_lookup_val_direct_decompress(
     return ev(err);
 }
 
+/* Values at least ks_vmax bytes in size are read from media via direct
+ * I/O rather than copied out of the mapped vblock (except on pmem).
+ */
+static bool
+kvset_lookup_val_isdirect(struct kvset *ks, const struct vblock_desc *vbd, uint copylen)
+{
+    return (copylen >= ks->ks_vmax) && (vbd->vbd_mblkdesc->mclass != HSE_MCLASS_PMEM);
+}
+
 static merr_t
 kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *vbuf)
 {
@@ -1348,14 +1518,15 @@ kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *
 
     assert(
         vref->vr_type == VTYPE_IVAL || vref->vr_type == VTYPE_ZVAL ||
-        vref->vr_type == VTYPE_UCVAL || vref->vr_type == VTYPE_CVAL);
+        vref->vr_type == VTYPE_UCVAL || vref->vr_type == VTYPE_CVAL ||
+        vref->vr_type == VTYPE_MOPND);
 
     if (HSE_UNLIKELY(vref->vr_type == VTYPE_ZVAL)) {
         vbuf->b_len = 0;
         return 0;
     }
 
-    if (vref->vr_type == VTYPE_IVAL)
+    if (vref->vr_type == VTYPE_IVAL || vref->vr_type == VTYPE_MOPND)
         return kvset_get_immediate_value(vref, vbuf);
 
     vbd = lvx2vbd(ks, vref->vb.vr_index);
@@ -1369,7 +1540,7 @@ kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *
     dst = vbuf->b_buf;
     copylen = min(vref->vb.vr_len, vbuf->b_buf_sz);
 
-    direct = (copylen >= ks->ks_vmax) && (vbd->vbd_mblkdesc->mclass != HSE_MCLASS_PMEM);
+    direct = kvset_lookup_val_isdirect(ks, vbd, copylen);
 
     if (!copylen)
         goto done;
@@ -1384,7 +1555,7 @@ kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *
                 ks, vbd, vref->vb.vr_index, vref->vb.vr_off, dst, copylen, omlen, &outlen);
 
         if (!direct || err) {
-            err = compress_lz4_ops.cop_decompress(src, omlen, dst, copylen, &outlen);
+            err = vcomp_decompress(src, omlen, dst, copylen, &outlen);
             if (ev(err))
                 return err;
         }
@@ -1570,24 +1741,255 @@ merr_t
 kvset_lookup(
     struct kvset *ks,
     struct kvs_ktuple *kt,
-    const struct key_disc *kdisc,
+    int kblk,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct kvs_vtuple_ref vref;
     merr_t err;
 
-    err = kvset_lookup_vref(ks, kt, kdisc, seq, res, &vref);
+    err = kvset_lookup_vref_kblk(ks, kt, kblk, seq, res, &vref);
     if (ev(err))
         return err;
 
-    if (*res != FOUND_VAL)
+    if (*res == FOUND_MOPND && seqnop)
+        *seqnop = vref.vr_seq;
+
+    if (*res != FOUND_VAL && *res != FOUND_MOPND)
         return 0;
 
     return kvset_lookup_val(ks, &vref, vbuf);
 }
 
+/* Select the buffer for an async direct read of the value described by
+ * aio->cga_vref.  The thread-local bounce buffer used by the synchronous
+ * path cannot be used here as the read completes on another thread.
+ */
+static merr_t
+kvset_lookup_val_async_prep(struct cn_get_aio *aio)
+{
+    const struct kvs_vtuple_ref *vref = &aio->cga_vref;
+    const struct kvs_buf *vbuf = aio->cga_vbuf;
+    struct iovec *iov = &aio->cga_iov;
+    uint32_t vboff = vref->vb.vr_off;
+    uint rdlen;
+
+    /* Compressed values are read in full, others only as much as fits in vbuf.
+     */
+    rdlen = vref->vb.vr_complen ?: min(vref->vb.vr_len, vbuf->b_buf_sz);
+
+    iov->iov_len = ALIGN(vboff + rdlen, PAGE_SIZE) - (vboff & PAGE_MASK);
+    iov->iov_base = vbuf->b_buf;
+    aio->cga_freeme = false;
+
+    if (vref->vb.vr_complen || !IS_ALIGNED((ulong)vbuf->b_buf, PAGE_SIZE) ||
+        vbuf->b_buf_sz < iov->iov_len) {
+
+        iov->iov_base = vlb_alloc(iov->iov_len);
+        if (!iov->iov_base)
+            return merr(ENOMEM);
+
+        aio->cga_freeme = true;
+    }
+
+    return 0;
+}
+
+merr_t
+kvset_lookup_async(
+    struct kvset *ks,
+    struct kvs_ktuple *kt,
+    int kblk,
+    uint64_t seq,
+    enum key_lookup_res *res,
+    struct cn_get_aio *aio)
+{
+    struct kvs_vtuple_ref *vref = &aio->cga_vref;
+    const struct vblock_desc *vbd;
+    uint copylen;
+    merr_t err;
+
+    err = kvset_lookup_vref_kblk(ks, kt, kblk, seq, res, vref);
+    if (ev(err))
+        return err;
+
+    if (*res != FOUND_VAL && *res != FOUND_MOPND)
+        return 0;
+
+    if (vref->vr_type != VTYPE_UCVAL && vref->vr_type != VTYPE_CVAL)
+        return kvset_lookup_val(ks, vref, aio->cga_vbuf);
+
+    vbd = lvx2vbd(ks, vref->vb.vr_index);
+    copylen = min(vref->vb.vr_len, aio->cga_vbuf->b_buf_sz);
+
+    if (copylen > 0 && kvset_lookup_val_isdirect(ks, vbd, copylen)) {
+        err = kvset_lookup_val_async_prep(aio);
+        if (!ev(err)) {
+            aio->cga_cn = cn_tree_get_cn(ks->ks_tree);
+            aio->cga_kvset = ks;
+
+            cn_ref_get(aio->cga_cn);
+            kvset_get_ref(ks);
+            return 0;
+        }
+    }
+
+    return kvset_lookup_val(ks, vref, aio->cga_vbuf);
+}
+
+static void
+kvset_lookup_val_async_cb(struct mpool_aio *mpaio)
+{
+    struct cn_get_aio *aio = container_of(mpaio, struct cn_get_aio, cga_mpaio);
+    struct kvs_vtuple_ref *vref = &aio->cga_vref;
+    struct kvs_buf *vbuf = aio->cga_vbuf;
+    struct kvset *ks = aio->cga_kvset;
+    struct cn *cn = aio->cga_cn;
+    uint copylen, outlen;
+    merr_t err;
+    void *src;
+
+    copylen = min(vref->vb.vr_len, vbuf->b_buf_sz);
+    src = aio->cga_iov.iov_base + (vref->vb.vr_off & ~PAGE_MASK);
+
+    err = mpaio->ma_err;
+    if (err) {
+        log_errx("len %lx, copylen %u", err, aio->cga_iov.iov_len, copylen);
+    } else if (vref->vb.vr_complen) {
+        err = vcomp_decompress(src, vref->vb.vr_complen, vbuf->b_buf, copylen, &outlen);
+
+        if (!err && copylen == vref->vb.vr_len && outlen != copylen) {
+            assert(0);
+            err = merr(EBUG);
+        }
+    } else if (src != vbuf->b_buf) {
+        memmove(vbuf->b_buf, src, copylen);
+    }
+
+    if (aio->cga_freeme)
+        vlb_free(aio->cga_iov.iov_base, aio->cga_iov.iov_len);
+
+    /* A failed read completes the request with the error.  Retrying it
+     * synchronously here could block the I/O completion thread on a read
+     * that only it can complete.
+     */
+    if (!ev(err))
+        vbuf->b_len = vref->vb.vr_len;
+
+    aio->cga_err = err;
+    aio->cga_kvset = NULL;
+
+    kvset_put_ref(ks);
+
+    /* The callback may free the request, so the cn ref (which keeps
+     * the kvset's mpool open) is dropped only after it returns.
+     */
+    aio->cga_cb(aio);
+    cn_ref_put(cn);
+}
+
+void
+kvset_lookup_val_async(struct cn_get_aio *aio)
+{
+    const struct kvs_vtuple_ref *vref = &aio->cga_vref;
+    struct kvset *ks = aio->cga_kvset;
+    const struct vblock_desc *vbd;
+    off_t off;
+    merr_t err;
+
+    INVARIANT(ks);
+
+    vbd = lvx2vbd(ks, vref->vb.vr_index);
+    off = vbd->vbd_off + (vref->vb.vr_off & PAGE_MASK);
+
+    aio->cga_mpaio.ma_cb = kvset_lookup_val_async_cb;
+
+    err = mpool_mblock_read_async(
+        ks->ks_mp, lvx2mbid(ks, vref->vb.vr_index), &aio->cga_iov, 1, off, &aio->cga_mpaio);
+    if (ev(err)) {
+        aio->cga_mpaio.ma_err = err;
+        kvset_lookup_val_async_cb(&aio->cga_mpaio);
+    }
+}
+
+merr_t
+kvset_lookup_batch(struct kvset *ks, uint64_t seq, struct kvset_lookup_key *keyv, uint keyc)
+{
+    struct kvs_vtuple_ref vref;
+    merr_t err;
+    uint i;
+
+    /* Locate the kblock for each key and prefetch its bloom bucket so that
+     * the bucket loads overlap with the kblock searches of the other keys.
+     */
+    for (i = 0; i < keyc; ++i) {
+        struct kvset_lookup_key *lk = keyv + i;
+
+        lk->lk_kblk = -1;
+
+        if (*lk->lk_res != NOT_FOUND)
+            continue;
+
+        lk->lk_kblk = kvset_kblk_find(ks, lk->lk_kt, &lk->lk_kdisc);
+        if (lk->lk_kblk < 0)
+            continue;
+
+        lk->lk_hash = kblk_bloom_hash(ks, lk->lk_kt);
+        bloom_reader_prefetch(&ks->ks_kblks[lk->lk_kblk].kb_blm_desc, lk->lk_hash);
+    }
+
+    /* Probe the blooms and prefetch the hash index bucket (or else the
+     * wbtree root) of each kblock that might contain its key.
+     */
+    for (i = 0; i < keyc; ++i) {
+        struct kvset_lookup_key *lk = keyv + i;
+        struct kvset_kblk *kblk;
+
+        if (lk->lk_kblk < 0)
+            continue;
+
+        kblk = ks->ks_kblks + lk->lk_kblk;
+
+        if (!bloom_reader_lookup(&kblk->kb_blm_desc, lk->lk_hash)) {
+            lk->lk_kblk = -1;
+            continue;
+        }
+
+        if (kblk->kb_hix_desc.hix_nbkts) {
+            const struct kblock_hix_desc *hix = &kblk->kb_hix_desc;
+            const uint32_t bkt = kblock_hix_bkt(lk->lk_hash, hix->hix_nbkts);
+
+            __builtin_prefetch(hix->hix_bktv + bkt * KBLOCK_HIX_BKT_ENTRIES);
+            continue;
+        }
+
+        __builtin_prefetch(
+            kblk->kb_kblk_desc.map_base +
+            (kblk->kb_wbt_desc.wbd_first_page + kblk->kb_wbt_desc.wbd_root) * PAGE_SIZE);
+    }
+
+    for (i = 0; i < keyc; ++i) {
+        struct kvset_lookup_key *lk = keyv + i;
+
+        if (*lk->lk_res != NOT_FOUND)
+            continue;
+
+        err = kvset_lookup_vref_kblk(ks, lk->lk_kt, lk->lk_kblk, seq, lk->lk_res, &vref);
+        if (ev(err))
+            return err;
+
+        if (*lk->lk_res == FOUND_VAL || *lk->lk_res == FOUND_MOPND) {
+            err = kvset_lookup_val(ks, &vref, lk->lk_vbuf);
+            if (ev(err))
+                return err;
+        }
+    }
+
+    return 0;
+}
+
 uint64_t
 kvset_get_nodeid(const struct kvset *ks)
 {
@@ -1644,6 +2046,12 @@ kvset_get_vgroups(const struct kvset *ks)
     return ks->ks_vgmap ? ks->ks_vgmap->nvgroups : 0;
 }
 
+uint32_t
+kvset_get_scatter(const struct kvset *ks)
+{
+    return ks->ks_scatter;
+}
+
 size_t
 kvset_get_kwlen(const struct kvset *ks)
 {
@@ -1963,8 +2371,8 @@ struct iter_meta {
 
 struct wb_pos {
     void *wb_node;              /* current node */
-    void *wb_pfx;               /* node's lcp */
-    uint16_t wb_pfx_len;        /* length of node's lcp */
+    const void *wb_pfx;         /* current key's prefix */
+    uint16_t wb_pfx_len;        /* length of current key's prefix */
     struct wbt_lfe_omf *wb_lfe; /* current key */
     uint16_t wb_nodec;          /* #nodes left in current buffer */
     uint16_t wb_keyc;           /* #keys left in current node */
@@ -1981,6 +2389,7 @@ struct kvset_iterator {
     struct perfc_set *pc;
     struct cn_merge_stats *stats;
     uint curr_kblk;
+    uint kblk_end;
     enum last_src last;
     uint32_t vra_flags;
     uint32_t vra_len;
@@ -2486,7 +2895,8 @@ kvset_iter_enable_mblock_read(struct kvset_iterator *iter)
         }
     }
 
-    kr->kr_blk_cnt = iter->ks->ks_st.kst_kblks;
+    kr->kr_next_blk_idx = iter->curr_kblk;
+    kr->kr_blk_cnt = iter->kblk_end;
 
     return 0;
 
@@ -2506,10 +2916,12 @@ kvset_iter_mblock_read_start(struct kvset_iterator *iter)
     p->kr_requested = true;
     kblk_start_read(iter, p, READ_PT);
 
-    /* Initiate first reads */
+    /* Initiate first reads.  The first vblock is only likely to be needed
+     * if we start from the first kblock.
+     */
     k->kr_requested = true;
     kblk_start_read(iter, k, READ_WBT);
-    if (iter->ks->ks_st.kst_vblks) {
+    if (iter->ks->ks_st.kst_vblks && iter->curr_kblk == 0) {
         struct vblk_reader *vr = &iter->vreaders[0];
 
         vr->vr_requested = vr_start_read(vr, 0, 0, iter->workq, iter->ks);
@@ -2542,6 +2954,21 @@ kvset_iter_create(
     struct perfc_set *pc,
     enum kvset_iter_flags flags,
     struct kv_iterator **handle)
+{
+    return kvset_iter_create_range(
+        ks, io_workq, vra_wq, pc, flags, 0, ks->ks_st.kst_kblks, handle);
+}
+
+merr_t
+kvset_iter_create_range(
+    struct kvset *ks,
+    struct workqueue_struct *io_workq,
+    struct workqueue_struct *vra_wq,
+    struct perfc_set *pc,
+    enum kvset_iter_flags flags,
+    uint kblk_start,
+    uint kblk_end,
+    struct kv_iterator **handle)
 {
     merr_t err = 0;
     struct kvset_iterator *iter;
@@ -2556,6 +2983,14 @@ kvset_iter_create(
     if (ev(reverse && (io_workq || mblock_read)))
         return merr(EINVAL);
 
+    kblk_end = min_t(uint, kblk_end, ks->ks_st.kst_kblks);
+
+    /* Reverse iteration over a subset of the kblocks is not supported.
+     */
+    if (ev(kblk_start > kblk_end ||
+           (reverse && (kblk_start > 0 || kblk_end < ks->ks_st.kst_kblks))))
+        return merr(EINVAL);
+
     iter = kmem_cache_zalloc(kvset_iter_cache);
     if (ev(!iter))
         return merr(ENOMEM);
@@ -2585,6 +3020,9 @@ kvset_iter_create(
     iter->last = SRC_NONE;
     iter->pc = pc;
 
+    iter->curr_kblk = reverse ? 0 : kblk_start;
+    iter->kblk_end = kblk_end;
+
     if (mblock_read) {
         iter->asyncio = io_workq ? true : false;
 
@@ -2955,7 +3393,7 @@ next_kblock:
         bool eof;
 
         eof = (iter->reverse && iter->curr_kblk == (uint)-1) ||
-            (!iter->reverse && iter->curr_kblk >= ks->ks_st.kst_kblks);
+            (!iter->reverse && iter->curr_kblk >= iter->kblk_end);
 
         if (eof) {
             iter->wbti_meta.eof = true;
@@ -3000,6 +3438,7 @@ kvset_iter_next_key_read(
     struct iter_meta *meta;
     struct kblk_reader *kr;
     struct cn_merge_stats *ms = iter->stats;
+    uint pfx_len;
 
     if (read_type == READ_WBT) {
         kr = &iter->kreader;
@@ -3053,16 +3492,17 @@ kvset_iter_next_key_read(
 
     /* just landed on a new node */
     wbt_reader->wb_keyc = omf_wbn_num_keys(wbt_reader->wb_node);
-    wbt_reader->wb_pfx_len = omf_wbn_pfx_len(wbt_reader->wb_node);
-    wbt_reader->wb_pfx = wbt_reader->wb_node + sizeof(struct wbt_node_hdr_omf);
-    wbt_reader->wb_lfe = wbt_reader->wb_pfx + wbt_reader->wb_pfx_len;
+    wbt_reader->wb_lfe = wbt_reader->wb_node + sizeof(struct wbt_node_hdr_omf) +
+        omf_wbn_pfx_len(wbt_reader->wb_node);
 
     /* prepare for next node (after each key in node is processed) */
     wbt_reader->wb_nodec--;
 
 next_key:
-    /* set kdata and klen outputs */
+    /* set kdata and klen outputs, and the prefix that precedes them */
     wbt_lfe_key(wbt_reader->wb_node, wbt_reader->wb_lfe, kdata, klen);
+    wbt_lfe_pfx(wbt_reader->wb_node, wbt_reader->wb_lfe, &wbt_reader->wb_pfx, &pfx_len);
+    wbt_reader->wb_pfx_len = pfx_len;
 
     /* set kmd output, which is used by caller to iterate through values */
     meta->kmd =
@@ -3238,6 +3678,9 @@ kvset_iter_next_vref(
     case VTYPE_IVAL:
         kmd_ival(vc->kmd, &vc->off, vdata, vlen);
         break;
+    case VTYPE_MOPND:
+        kmd_mopnd(vc->kmd, &vc->off, vdata, vlen);
+        break;
     case VTYPE_ZVAL:
     case VTYPE_TOMB:
     case VTYPE_PTOMB:
@@ -3464,6 +3907,7 @@ kvset_iter_val_get(
         *complen = 0;
         return 0;
     case VTYPE_IVAL:
+    case VTYPE_MOPND:
         assert(*vdata);
         assert(*vlen);
         *complen = 0;
@@ -3589,6 +4033,71 @@ kvset_minkey(const struct kvset *ks, const void **minkey, uint16_t *minklen)
     *minklen = ks->ks_minklen;
 }
 
+/**
+ * kvset_kblk_minkey() - Return the smallest key in the nth kblock of a kvset
+ *
+ * @ks:      Kvset handle
+ * @index:   kblock index
+ * @minkey:  (output) pointer to the min key
+ * @minklen: (output) length of @minkey
+ */
+void
+kvset_kblk_minkey(const struct kvset *ks, uint32_t index, const void **minkey, uint16_t *minklen)
+{
+    assert(index < ks->ks_st.kst_kblks);
+
+    *minkey = ks->ks_kblks[index].kb_koff_min;
+    *minklen = ks->ks_kblks[index].kb_klen_min;
+}
+
+/**
+ * kvset_kblk_range() - Find the kblocks that may contain keys in [lo, hi)
+ *
+ * @ks:    Kvset handle
+ * @lo:    smallest key of interest (no lower bound if zero length)
+ * @hi:    first key past the range of interest (no upper bound if zero length)
+ * @start: (output) index of the first kblock in range
+ * @end:   (output) index of the first kblock past the range
+ *
+ * The range is empty if @start == @end.
+ */
+void
+kvset_kblk_range(
+    const struct kvset *ks,
+    const struct key_obj *lo,
+    const struct key_obj *hi,
+    uint *start,
+    uint *end)
+{
+    const uint kblkc = ks->ks_st.kst_kblks;
+    struct key_obj kobj;
+    uint i = 0;
+
+    if (key_obj_len(lo) > 0) {
+        for (; i < kblkc; i++) {
+            const struct kvset_kblk *kb = ks->ks_kblks + i;
+
+            if (key_obj_cmp(key2kobj(&kobj, kb->kb_koff_max, kb->kb_klen_max), lo) >= 0)
+                break;
+        }
+    }
+
+    *start = i;
+
+    if (key_obj_len(hi) > 0) {
+        for (; i < kblkc; i++) {
+            const struct kvset_kblk *kb = ks->ks_kblks + i;
+
+            if (key_obj_cmp(key2kobj(&kobj, kb->kb_koff_min, kb->kb_klen_min), hi) >= 0)
+                break;
+        }
+    } else {
+        i = kblkc;
+    }
+
+    *end = i;
+}
+
 /**
  * kvset_max_ptkey() - Return the largest ptomb in a kvset if one exists.
  *
@@ -16,6 +16,7 @@
 #include <hse/ikvdb/kvset_view.h>
 #include <hse/ikvdb/omf_kmd.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/util/key_util.h>
 #include <hse/util/list.h>
 #include <hse/util/perfc.h>
 
@@ -34,6 +35,8 @@ struct workqueue_struct;
 struct mbset;
 struct cn_kvdb;
 struct cn_tree;
+struct cn_tree_node;
+struct cn_get_aio;
 struct cn_merge_stats;
 struct kvset_stats;
 struct vgmap;
@@ -276,25 +279,130 @@ kvset_has_ptree(const struct kvset *ks) HSE_NONNULL(1);
 int
 kvset_kblk_start(struct kvset *kvset, const void *key, int len, bool reverse);
 
+/* Min and max number of kvsets filtered by one kvset_lookup_filter() call
+ * in a point lookup.
+ */
+#define KVSET_FILTER_MIN (2)
+#define KVSET_FILTER_MAX (16)
+
+/**
+ * kvset_lookup_filter() - Filter a run of kvsets for a key by kblock bounds and bloom
+ * @kvsetv: kvsets to filter (at most KVSET_FILTER_MAX)
+ * @kvsetc: number of kvsets in @kvsetv
+ * @kt:     key to search for
+ * @kdisc:  key discriminator of @kt
+ * @kblkv:  (output) for each kvset, the index of the kblock that might
+ *          contain @kt, or -1 if no kblock can contain it
+ *
+ * Locates the candidate kblock in each kvset, then probes all their blooms
+ * in a single batch so that the bloom bucket loads overlap.  The results
+ * are to be passed to kvset_lookup() or kvset_lookup_async().
+ */
+/* MTF_MOCK */
+void
+kvset_lookup_filter(
+    struct kvset *const *kvsetv,
+    uint kvsetc,
+    const struct kvs_ktuple *kt,
+    const struct key_disc *kdisc,
+    int *kblkv);
+
 /**
  * kvset_lookup() - Search a kvset for a key and return its value
  * @kvset:  kvset to search
  * @kt:     key to search for
- * @kdisc:  key discriminator
+ * @kblk:   candidate kblock for @kt from kvset_lookup_filter()
  * @seq:    sequence number
- * @result: (output) one of NOT_FOUND, FOUND_VAL, or FOUND_TMB (tombstone)
- * @vbuf:   (output) value if result==FOUND_VAL
+ * @result: (output) one of NOT_FOUND, FOUND_VAL, FOUND_TMB (tombstone),
+ *          or FOUND_MOPND (merge operand)
+ * @vbuf:   (output) value if result==FOUND_VAL or FOUND_MOPND
  *                   If vbuf->b_buf is NULL, a buffer large enough to hold the
  *                   value will be allocated.
+ * @seqnop: (output) seqno of the operand if result==FOUND_MOPND (optional)
  */
+/* MTF_MOCK */
 merr_t
 kvset_lookup(
     struct kvset *kvset,
     struct kvs_ktuple *kt,
-    const struct key_disc *kdisc,
+    int kblk,
+    uint64_t seq,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
+
+/**
+ * kvset_lookup_async() - Search a kvset for a key, deferring any media read
+ * @kvset:  kvset to search
+ * @kt:     key to search for
+ * @kblk:   candidate kblock for @kt from kvset_lookup_filter()
+ * @seq:    sequence number
+ * @res:    (output) one of NOT_FOUND, FOUND_VAL, or FOUND_TMB (tombstone)
+ * @aio:    get request, the value is returned via aio->cga_vbuf
+ *
+ * Behaves like kvset_lookup() except that if the value must be read from
+ * media then the read is prepared but not issued: aio->cga_kvset is set to
+ * the kvset (with a reference held on it and its cn), and the caller must
+ * then call kvset_lookup_val_async() to issue the read.
+ */
+merr_t
+kvset_lookup_async(
+    struct kvset *kvset,
+    struct kvs_ktuple *kt,
+    int kblk,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct cn_get_aio *aio);
+
+/**
+ * kvset_lookup_val_async() - Issue the value read prepared by kvset_lookup_async()
+ * @aio:  get request
+ *
+ * aio->cga_cb is invoked once the value has been copied out (possibly
+ * before this function returns), after which the references acquired
+ * by kvset_lookup_async() have been released.
+ */
+void
+kvset_lookup_val_async(struct cn_get_aio *aio);
+
+/**
+ * struct kvset_lookup_key - per-key state for a batched kvset lookup
+ * @lk_kt:     key to search for
+ * @lk_res:    (in/out) lookup result, only keys with NOT_FOUND are searched
+ * @lk_vbuf:   (output) value if *@lk_res == FOUND_VAL
+ * @lk_node:   cn tree node to search next (owned by the caller)
+ * @lk_kdisc:  key discriminator of @lk_kt
+ * @lk_hash:   bloom hash of @lk_kt (private to kvset_lookup_batch())
+ * @lk_kblk:   kblock index of @lk_kt (private to kvset_lookup_batch())
+ */
+struct kvset_lookup_key {
+    struct kvs_ktuple *lk_kt;
+    enum key_lookup_res *lk_res;
+    struct kvs_buf *lk_vbuf;
+    struct cn_tree_node *lk_node;
+    struct key_disc lk_kdisc;
+    uint64_t lk_hash;
+    int lk_kblk;
+};
+
+/**
+ * kvset_lookup_batch() - Search a kvset for a batch of keys
+ * @kvset:  kvset to search
+ * @seq:    sequence number
+ * @keyv:   vector of keys to search for
+ * @keyc:   number of keys in @keyv
+ *
+ * Equivalent to calling kvset_lookup() for each key in @keyv whose result
+ * is NOT_FOUND, but the kblock bloom and wbtree pages for all the keys are
+ * prefetched before any of them are searched so that the cache misses for
+ * the batch overlap rather than serialize.
+ */
+merr_t
+kvset_lookup_batch(
+    struct kvset *kvset,
+    uint64_t seq,
+    struct kvset_lookup_key *keyv,
+    uint keyc);
 
 struct query_ctx;
 
@@ -391,6 +499,16 @@ kvset_set_compc(struct kvset *ks, uint32_t compc);
 uint
 kvset_get_vgroups(const struct kvset *km);
 
+/**
+ * kvset_get_scatter() - Return the number of vgroups that scatter reads
+ *
+ * This is the number of vgroups less those whose keys all sort after the
+ * keys of the preceding vgroup.
+ */
+/* MTF_MOCK */
+uint
+kvset_get_scatter(const struct kvset *ks);
+
 size_t
 kvset_get_kwlen(const struct kvset *ks);
 
@@ -454,6 +572,26 @@ kvset_iter_create(
     enum kvset_iter_flags flags,
     struct kv_iterator **kv_iter);
 
+/**
+ * kvset_iter_create_range() - Create an iterator over a subset of a kvset's kblocks
+ * @kblk_start: index of the first kblock to iterate over
+ * @kblk_end:   index of the first kblock past the end of the iteration
+ *
+ * Same as kvset_iter_create() but only the keys in kblocks [@kblk_start, @kblk_end)
+ * are visited. Prefix tombstones are always visited. Not supported for reverse iterators.
+ */
+/* MTF_MOCK */
+merr_t
+kvset_iter_create_range(
+    struct kvset *kvset,
+    struct workqueue_struct *io_workq,
+    struct workqueue_struct *vra_wq,
+    struct perfc_set *pc,
+    enum kvset_iter_flags flags,
+    uint kblk_start,
+    uint kblk_end,
+    struct kv_iterator **kv_iter);
+
 /* MTF_MOCK */
 void
 kvset_iter_release(struct kv_iterator *handle);
@@ -559,6 +697,19 @@ kvset_minkey(const struct kvset *ks, const void **minkey, uint16_t *minklen);
 void
 kvset_max_ptkey(const struct kvset *ks, const void **max, uint16_t *maxlen);
 
+/* MTF_MOCK */
+void
+kvset_kblk_minkey(const struct kvset *ks, uint32_t index, const void **minkey, uint16_t *minklen);
+
+/* MTF_MOCK */
+void
+kvset_kblk_range(
+    const struct kvset *ks,
+    const struct key_obj *lo,
+    const struct key_obj *hi,
+    uint *start,
+    uint *end);
+
 /**
  * kvset_iter_next_val_direct() -  read value via direct io
  * @handle: handle to kv iterator
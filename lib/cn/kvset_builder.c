@@ -77,7 +77,7 @@ static int
 reserve_kmd(struct kmd_info *ki)
 {
     uint initial = 16 * 1024;
-    uint need = 256;
+    uint need = 512;
     uint min_size = ki->kmd_used + need;
     uint new_size;
     uint8_t *new_mem;
@@ -226,6 +226,13 @@ kvset_builder_add_val(
         if (ev(err))
             return err;
 
+        if (self->vbidx_limit) {
+            if (ev(vbidx >= self->vbidx_limit))
+                return merr(EFBIG);
+
+            vbidx += self->vbidx_base;
+        }
+
         if (complen)
             kmd_add_cval(
                 self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vbidx, vboff, vlen, complen);
@@ -295,6 +302,42 @@ kvset_builder_add_vref(
     return 0;
 }
 
+/**
+ * kvset_builder_add_mopnd() - add a VTYPE_MOPND (merge operand) entry to a kvset
+ *
+ * Merge operands are always stored in the kblock (like immediate values),
+ * hence @vlen is limited to what fits in the u8 kmd length.
+ */
+merr_t
+kvset_builder_add_mopnd(struct kvset_builder *self, uint64_t seq, const void *vdata, uint vlen)
+{
+    uint64_t seqno_prev;
+
+    if (ev(!vdata || vlen == 0 || vlen > UINT8_MAX))
+        return merr(EINVAL);
+
+    if (reserve_kmd(&self->kblk_kmd))
+        return merr(ev(ENOMEM));
+
+    kmd_add_mopnd(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vdata, vlen);
+
+    self->key_stats.tot_vlen += vlen;
+    self->key_stats.nvals++;
+
+    self->seqno_max = max_t(uint64_t, self->seqno_max, seq);
+    self->seqno_min = min_t(uint64_t, self->seqno_min, seq);
+
+    seqno_prev = self->seqno_prev;
+    self->seqno_prev = seq;
+
+    assert(seq <= seqno_prev);
+
+    if (seq > seqno_prev)
+        return merr(ev(EINVAL));
+
+    return 0;
+}
+
 merr_t
 kvset_builder_add_nonval(struct kvset_builder *self, uint64_t seq, enum kmd_vtype vtype)
 {
@@ -343,6 +386,123 @@ kvset_builder_adopt_vblocks(
     self->vgmap = vgmap;
 }
 
+void
+kvset_builder_set_vbidx_base(struct kvset_builder *self, uint32_t base, uint32_t limit)
+{
+    assert(self->vblk_list.idc == 0);
+
+    self->vbidx_base = base;
+    self->vbidx_limit = limit;
+}
+
+merr_t
+kvset_builder_adopt_slices(
+    struct kvset_builder *self,
+    struct kvset_builder **slicev,
+    uint slicec)
+{
+    uint32_t vgroupc = 0, vgidx = 0, vbidx_out = 0;
+    merr_t err;
+
+    assert(kbb_is_empty(self->kbb));
+    assert(self->kblk_list.idc == 0 && self->vblk_list.idc == 0 && !self->vgmap);
+
+    /* Finish each slice's kblocks and vblocks.  Once finished, the mblocks
+     * are owned by the slice builder until they are transferred below, such
+     * that they are deleted if the slice builder is destroyed on error.
+     */
+    for (uint i = 0; i < slicec; i++) {
+        struct kvset_builder *slice = slicev[i];
+        struct key_obj min_kobj = { 0 }, max_kobj = { 0 };
+
+        assert(slice->key_stats.nptombs == 0 && hbb_get_nptombs(slice->hbb) == 0);
+
+        if (kbb_is_empty(slice->kbb))
+            continue;
+
+        kbb_curr_kblk_min_max_keys(slice->kbb, &min_kobj, &max_kobj);
+
+        err = vbb_finish(slice->vbb, &slice->vblk_list, &max_kobj);
+        if (ev(err))
+            return err;
+
+        err = kbb_finish(slice->kbb, &slice->kblk_list);
+        if (ev(err))
+            return err;
+
+        if (slice->vblk_list.idc > 0)
+            vgroupc++;
+    }
+
+    if (vgroupc > 0) {
+        self->vgmap = vgmap_alloc(vgroupc);
+        if (ev(!self->vgmap))
+            return merr(ENOMEM);
+    }
+
+    for (uint i = 0; i < slicec; i++) {
+        struct kvset_builder *slice = slicev[i];
+        const uint32_t vblkc = slice->vblk_list.idc;
+
+        if (slice->kblk_list.idc == 0)
+            continue;
+
+        for (uint j = 0; j < slice->kblk_list.idc; j++) {
+            err = blk_list_append(&self->kblk_list, slice->kblk_list.idv[j]);
+            if (ev(err))
+                goto errout;
+        }
+
+        for (uint j = 0; j < vblkc; j++) {
+            err = blk_list_append(&self->vblk_list, slice->vblk_list.idv[j]);
+            if (ev(err))
+                goto errout;
+        }
+
+        /* kblocks written by this slice record vblock indexes starting at
+         * vbidx_base, whereas its vblocks start at vbidx_out in the output.
+         */
+        if (vblkc > 0) {
+            err = vgmap_vbidx_set(
+                NULL, slice->vbidx_base + vblkc - 1, self->vgmap, vbidx_out + vblkc - 1,
+                vgidx++);
+            if (ev(err))
+                goto errout;
+
+            vbidx_out += vblkc;
+            self->vtotal += vbb_vlen_get(slice->vbb);
+        }
+
+        kbb_union_composite_hlog(self->kbb, kbb_get_composite_hlog(slice->kbb));
+
+        self->seqno_max = max_t(uint64_t, self->seqno_max, slice->seqno_max);
+        self->seqno_min = min_t(uint64_t, self->seqno_min, slice->seqno_min);
+        self->vused += slice->vused;
+    }
+
+    /* The mblocks are now owned by self.
+     */
+    for (uint i = 0; i < slicec; i++) {
+        blk_list_free(&slicev[i]->kblk_list);
+        blk_list_free(&slicev[i]->vblk_list);
+    }
+
+    self->slice_kblks = self->kblk_list.idc > 0;
+    self->slice_vblks = self->vblk_list.idc > 0;
+
+    return 0;
+
+errout:
+    /* The slice builders still own all the mblocks.
+     */
+    blk_list_free(&self->kblk_list);
+    blk_list_free(&self->vblk_list);
+    vgmap_free(self->vgmap);
+    self->vgmap = NULL;
+
+    return err;
+}
+
 void
 kvset_builder_destroy(struct kvset_builder *bld)
 {
@@ -387,13 +547,17 @@ static merr_t
 kvset_builder_finish(struct kvset_builder *imp)
 {
     merr_t err;
-    bool adopted_vbs = (imp->vblk_list.idc > 0);
+    bool adopted_vbs = (imp->vblk_list.idc > 0) && !imp->slice_vblks;
 
     INVARIANT(imp->hbb);
     INVARIANT(imp->kbb);
     INVARIANT(imp->vbb);
 
-    if (!kbb_is_empty(imp->kbb)) {
+    if (imp->slice_kblks) {
+        /* The kblocks and any new vblocks were finished by the slice builders
+         * and have been adopted by kvset_builder_adopt_slices().
+         */
+    } else if (!kbb_is_empty(imp->kbb)) {
         /* If we haven't adopted any vblocks previously */
         if (!adopted_vbs) {
             struct key_obj min_kobj = { 0 }, max_kobj = { 0 };
@@ -444,12 +608,14 @@ kvset_builder_finish(struct kvset_builder *imp)
         }
     }
 
-    err = kbb_finish(imp->kbb, &imp->kblk_list);
-    if (err) {
-        if (!adopted_vbs)
-            delete_mblocks(cn_get_mpool(imp->cn), &imp->vblk_list);
+    if (!imp->slice_kblks) {
+        err = kbb_finish(imp->kbb, &imp->kblk_list);
+        if (err) {
+            if (!adopted_vbs)
+                delete_mblocks(cn_get_mpool(imp->cn), &imp->vblk_list);
 
-        return err;
+            return err;
+        }
     }
 
     err = hbb_finish(
@@ -529,6 +695,14 @@ kvset_builder_set_agegroup(struct kvset_builder *self, enum hse_mclass_policy_ag
     return err;
 }
 
+merr_t
+kvset_builder_set_value_agegroup(struct kvset_builder *self, enum hse_mclass_policy_age age)
+{
+    INVARIANT(age < HSE_MPOLICY_AGE_CNT);
+
+    return vbb_set_agegroup(self->vbb, age);
+}
+
 void
 kvset_builder_set_merge_stats(struct kvset_builder *self, struct cn_merge_stats *stats)
 {
@@ -53,6 +53,11 @@ struct kvset_builder {
     uint64_t vused;     // sum of len of all values in new kvset
     uint64_t vtotal;    // sum of written lengths of all vblocks (excluding vblock footer)
 
+    uint32_t vbidx_base;  // added to the vblock index of each value written by this builder
+    uint32_t vbidx_limit; // max vblocks this builder may write (0 for no limit)
+    bool slice_kblks;     // kblocks were adopted from slice builders
+    bool slice_vblks;     // vblocks were adopted from slice builders
+
     uint64_t seqno_prev;       // for sanity checks while building kvsets
     uint64_t seqno_prev_ptomb; // for sanity checks while building kvsets
 
@@ -28,9 +28,12 @@
 #include "wbt_internal.h"
 #include "wbt_reader.h"
 
+struct mbcache_map;
+
 struct kvset_hblk {
     struct kvs_mblk_desc kh_hblk_desc;
     struct wbt_desc kh_ptree_desc;
+    struct mbcache_map *kh_mbcm; /* mblock cache map (may be NULL) */
 
     struct key_disc kh_pfx_max_disc;
     struct key_disc kh_pfx_min_disc;
@@ -48,6 +51,7 @@ struct kvset_hblk {
 struct kvset_kblk {
     struct kvs_mblk_desc kb_kblk_desc; /* kblock descriptor */
     struct wbt_desc kb_wbt_desc;       /* wbtree descriptor */
+    struct mbcache_map *kb_mbcm;       /* mblock cache map (may be NULL) */
 
     uint8_t kb_ksmall[64];        /* small key cache */
     struct key_disc kb_kdisc_max; /* kdisc of largest key in kblk */
@@ -58,7 +62,8 @@ struct kvset_kblk {
     uint16_t kb_klen_max;         /* length of largest key */
     uint16_t kb_klen_min;         /* length of smallest key */
 
-    struct bloom_desc kb_blm_desc; /* Bloom descriptor */
+    struct bloom_desc kb_blm_desc;      /* Bloom descriptor */
+    struct kblock_hix_desc kb_hix_desc; /* hash index descriptor */
 
     struct kblk_metrics kb_metrics; /* kblock metrics */
 };
@@ -95,6 +100,7 @@ struct kvset {
 
     struct vgmap *ks_vgmap;
     bool ks_use_vgmap; /* consult vgmap during query/compaction? */
+    uint32_t ks_scatter; /* vgroups that overlap their predecessor, see kvset_get_scatter() */
 
     struct mbset_locator *ks_vblk2mbs;
 
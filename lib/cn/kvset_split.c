@@ -171,6 +171,7 @@ kblock_copy_range(
                 break;
 
             case VTYPE_IVAL:
+            case VTYPE_MOPND:
                 stats.tot_vlen += vref.vi.vr_len;
                 break;
 
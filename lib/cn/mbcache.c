@@ -0,0 +1,589 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include <hse/kvdb_perfc.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/hse_gparams.h>
+#include <hse/logging/logging.h>
+#include <hse/mpool/mpool.h>
+#include <hse/mpool/mpool_structs.h>
+#include <hse/util/assert.h>
+#include <hse/util/atomic.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/list.h>
+#include <hse/util/map.h>
+#include <hse/util/mutex.h>
+#include <hse/util/page.h>
+#include <hse/util/perfc.h>
+#include <hse/util/platform.h>
+#include <hse/util/workqueue.h>
+
+#include "kvs_mblk_desc.h"
+#include "mbcache.h"
+
+/* Mblocks are distributed over the shards by mblock ID, each shard having
+ * its own lock, map from mblock ID to cache map, budget and clock.
+ */
+#define MBCACHE_SHARDS (16)
+
+/* Every resident extent splits the VMA of its mblock's mapping, hence the
+ * number of resident extents is bounded well below vm.max_map_count.
+ */
+#define MBCACHE_EXTENTS_MAX (16 * 1024)
+
+#define MBCACHE_WEIGHT_HOT  (3)
+#define MBCACHE_WEIGHT_COLD (1)
+
+enum mbcache_ext_state {
+    MBX_EMPTY,    /* pages are mapped from media */
+    MBX_QUEUED,   /* fill is queued */
+    MBX_FILLING,  /* fill is reading the extent */
+    MBX_RESIDENT, /* pages are a cached copy and on the shard's clock */
+    MBX_BYPASS,   /* extent exceeds the shard budget */
+};
+
+struct mbcache_extent {
+    struct list_head mbx_link;
+    struct mbcache_map *mbx_map;
+    uint32_t mbx_pg;
+    uint32_t mbx_pgc;
+    atomic_int mbx_state;
+    atomic_int mbx_clock;
+};
+
+/**
+ * struct mbcache_map - cache state of one mapped mblock
+ * @mbm_mapcnt: number of mbcache_mmap() mappings (protected by shard lock)
+ * @mbm_refcnt: one for all mappings plus one per running or queued fill
+ * @mbm_dead:   the last mapping is gone (protected by shard lock)
+ * @mbm_queued: fill work is queued
+ */
+struct mbcache_map {
+    uint64_t mbm_mbid;
+    struct mpool *mbm_mp;
+    void *mbm_base;
+    struct mbcache_shard *mbm_shard;
+    uint mbm_mapcnt;
+    bool mbm_dead;
+    atomic_int mbm_refcnt;
+    atomic_int mbm_queued;
+    struct work_struct mbm_work;
+    struct mbcache_extent mbm_extv[MBC_EXT_MAX];
+};
+
+struct mbcache_shard {
+    struct mutex mbs_lock HSE_L1D_ALIGNED;
+    struct map *mbs_map;
+    struct list_head mbs_clock;
+    uint64_t mbs_resident;
+    uint mbs_extents;
+};
+
+static struct {
+    struct mbcache_shard mbc_shardv[MBCACHE_SHARDS];
+    struct workqueue_struct *mbc_wq;
+    uint64_t mbc_budget;
+} mbcache;
+
+static struct perfc_set mbcache_pc HSE_READ_MOSTLY;
+
+/* clang-format off */
+
+struct perfc_name mbcache_perfc[] _dt_section = {
+    NE(PERFC_RA_MBCACHE_HIT,     2, "cN mblock cache hit rate",      "r_hit(/s)"),
+    NE(PERFC_RA_MBCACHE_MISS,    2, "cN mblock cache miss rate",     "r_miss(/s)"),
+    NE(PERFC_RA_MBCACHE_BYPASS,  2, "cN mblock cache bypass rate",   "r_bypass(/s)"),
+    NE(PERFC_RA_MBCACHE_EVICT,   2, "cN mblock cache eviction rate", "r_evict(/s)"),
+    NE(PERFC_BA_MBCACHE_EXTENTS, 2, "cN mblock cache extents",       "c_extents"),
+    NE(PERFC_BA_MBCACHE_BYTES,   2, "cN mblock cache bytes",         "c_bytes"),
+};
+
+NE_CHECK(mbcache_perfc, PERFC_EN_MBCACHE, "mbcache_perfc table/enum mismatch");
+
+/* clang-format on */
+
+static struct mbcache_shard *
+mbcache_shard(uint64_t mbid)
+{
+    return mbcache.mbc_shardv + (mbid % MBCACHE_SHARDS);
+}
+
+static int
+mbcache_weight(const struct mbcache_extent *x)
+{
+    const enum mbcache_ext ext = x - x->mbx_map->mbm_extv;
+
+    return ext <= MBC_EXT_WBT_INT ? MBCACHE_WEIGHT_HOT : MBCACHE_WEIGHT_COLD;
+}
+
+static void
+mbcache_map_put(struct mbcache_map *map)
+{
+    if (atomic_dec_return(&map->mbm_refcnt) == 0)
+        free(map);
+}
+
+/* Put an extent's pages from media back in place of its cached copy.
+ * Caller holds the shard lock.
+ *
+ * Should that fail while the mblock is mapped, the copy remains valid and
+ * the extent remains resident.  Otherwise (@dead) the extent is taken off
+ * the clock regardless, and the copy is replaced by inaccessible pages, as
+ * it would shadow the next mblock allocated at the same offset.
+ */
+static merr_t
+mbcache_evict_locked(struct mbcache_shard *shard, struct mbcache_extent *x, bool dead)
+{
+    const struct mbcache_map *map = x->mbx_map;
+    const size_t len = (size_t)x->mbx_pgc * PAGE_SIZE;
+    void *addr = map->mbm_base + (size_t)x->mbx_pg * PAGE_SIZE;
+    merr_t err;
+
+    assert(atomic_read(&x->mbx_state) == MBX_RESIDENT);
+
+    err = mpool_mblock_mmap_restore(map->mbm_mp, map->mbm_mbid, (size_t)x->mbx_pg * PAGE_SIZE, len);
+    if (ev(err) && !dead)
+        return err;
+
+    if (err) {
+        const int flags = MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+        log_errx("unable to restore mblock 0x%lx pages %u-%u", err, map->mbm_mbid, x->mbx_pg,
+                 x->mbx_pg + x->mbx_pgc - 1);
+
+        /* The copy is a VMA of its own, hence unmapping it cannot fail,
+         * but would leave a hole that an unrelated mapping could fill.
+         */
+        if (mmap(addr, len, PROT_NONE, flags, -1, 0) == MAP_FAILED)
+            munmap(addr, len);
+    }
+
+    list_del_init(&x->mbx_link);
+    atomic_set(&x->mbx_state, MBX_EMPTY);
+
+    shard->mbs_resident -= len;
+    shard->mbs_extents--;
+
+    perfc_sub(&mbcache_pc, PERFC_BA_MBCACHE_BYTES, len);
+    perfc_dec(&mbcache_pc, PERFC_BA_MBCACHE_EXTENTS);
+
+    return err;
+}
+
+/* Advance the clock hand until there is room for len more bytes.  An extent
+ * touched since the hand last passed it has its clock decremented and goes
+ * another lap, such that hot extents outlast cold ones by their weight.
+ * Caller holds the shard lock.
+ */
+static bool
+mbcache_reclaim_locked(struct mbcache_shard *shard, size_t len)
+{
+    const uint64_t budget = mbcache.mbc_budget / MBCACHE_SHARDS;
+    uint laps = (MBCACHE_WEIGHT_HOT + 1) * shard->mbs_extents;
+
+    while (shard->mbs_resident + len > budget ||
+           shard->mbs_extents >= MBCACHE_EXTENTS_MAX / MBCACHE_SHARDS) {
+        struct mbcache_extent *x;
+
+        x = list_first_entry_or_null(&shard->mbs_clock, struct mbcache_extent, mbx_link);
+        if (!x || laps-- == 0)
+            return false;
+
+        list_del(&x->mbx_link);
+        list_add_tail(&x->mbx_link, &shard->mbs_clock);
+
+        if (atomic_read(&x->mbx_clock) > 0) {
+            atomic_dec(&x->mbx_clock);
+            continue;
+        }
+
+        if (!mbcache_evict_locked(shard, x, false))
+            perfc_inc(&mbcache_pc, PERFC_RA_MBCACHE_EVICT);
+    }
+
+    return true;
+}
+
+/* Read a queued extent into anonymous memory and move it over the extent's
+ * pages of the mblock mapping.  The copy is made read-only first, as is the
+ * mapping it replaces.
+ */
+static void
+mbcache_fill(struct mbcache_map *map, struct mbcache_extent *x)
+{
+    struct mbcache_shard *shard = map->mbm_shard;
+    const size_t len = (size_t)x->mbx_pgc * PAGE_SIZE;
+    const size_t off = (size_t)x->mbx_pg * PAGE_SIZE;
+    struct iovec iov;
+    void *buf = NULL;
+    merr_t err = 0;
+    bool admit;
+
+    mutex_lock(&shard->mbs_lock);
+    if (map->mbm_dead || atomic_read(&x->mbx_state) != MBX_QUEUED) {
+        mutex_unlock(&shard->mbs_lock);
+        return;
+    }
+
+    admit = mbcache_reclaim_locked(shard, len);
+    if (admit) {
+        shard->mbs_resident += len;
+        shard->mbs_extents++;
+    }
+
+    atomic_set(&x->mbx_state, admit ? MBX_FILLING : MBX_EMPTY);
+    mutex_unlock(&shard->mbs_lock);
+
+    if (!admit) {
+        perfc_inc(&mbcache_pc, PERFC_RA_MBCACHE_BYPASS);
+        return;
+    }
+
+    buf = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ev(buf == MAP_FAILED)) {
+        err = merr(ENOMEM);
+        buf = NULL;
+    }
+
+    if (!err) {
+        iov.iov_base = buf;
+        iov.iov_len = len;
+
+        err = mpool_mblock_read(map->mbm_mp, map->mbm_mbid, &iov, 1, off);
+        if (!err && mprotect(buf, len, PROT_READ))
+            err = merr(errno);
+    }
+
+    mutex_lock(&shard->mbs_lock);
+    if (!err && !map->mbm_dead) {
+        void *addr;
+
+        /* mremap() atomically replaces the pages mapped from media with the
+         * copy, whose contents are identical, so concurrent readers never
+         * see a hole.
+         */
+        addr = mremap(buf, len, len, MREMAP_MAYMOVE | MREMAP_FIXED, map->mbm_base + off);
+        if (addr != MAP_FAILED)
+            buf = NULL;
+        else
+            err = merr(errno);
+    }
+
+    if (buf || err) {
+        atomic_set(&x->mbx_state, MBX_EMPTY);
+        shard->mbs_resident -= len;
+        shard->mbs_extents--;
+    } else {
+        atomic_set(&x->mbx_clock, mbcache_weight(x));
+        atomic_set(&x->mbx_state, MBX_RESIDENT);
+        list_add_tail(&x->mbx_link, &shard->mbs_clock);
+
+        perfc_add(&mbcache_pc, PERFC_BA_MBCACHE_BYTES, len);
+        perfc_inc(&mbcache_pc, PERFC_BA_MBCACHE_EXTENTS);
+    }
+    mutex_unlock(&shard->mbs_lock);
+
+    if (buf)
+        munmap(buf, len);
+
+    ev(err);
+}
+
+static void
+mbcache_fill_work(struct work_struct *work)
+{
+    struct mbcache_map *map = container_of(work, struct mbcache_map, mbm_work);
+
+again:
+    for (size_t i = 0; i < NELEM(map->mbm_extv); ++i) {
+        struct mbcache_extent *x = map->mbm_extv + i;
+
+        if (atomic_read(&x->mbx_state) == MBX_QUEUED)
+            mbcache_fill(map, x);
+    }
+
+    /* A touch that queued an extent after the scan above but before
+     * mbm_queued was cleared will not have queued the work again.
+     */
+    atomic_set(&map->mbm_queued, 0);
+
+    for (size_t i = 0; i < NELEM(map->mbm_extv); ++i) {
+        struct mbcache_extent *x = map->mbm_extv + i;
+
+        if (atomic_read(&x->mbx_state) == MBX_QUEUED && atomic_cas(&map->mbm_queued, 0, 1))
+            goto again;
+    }
+
+    mbcache_map_put(map);
+}
+
+bool
+mbcache_touch(struct mbcache_map *map, uint extmask)
+{
+    bool queue = false;
+    bool hit = true;
+
+    if (!map)
+        return false;
+
+    for (uint i = 0; i < NELEM(map->mbm_extv); ++i) {
+        struct mbcache_extent *x = map->mbm_extv + i;
+        int state;
+
+        if (!(extmask & MBC_EXT_MASK(i)) || x->mbx_pgc == 0)
+            continue;
+
+        state = atomic_read(&x->mbx_state);
+        if (state == MBX_RESIDENT) {
+            const int weight = mbcache_weight(x);
+
+            if (atomic_read(&x->mbx_clock) != weight)
+                atomic_set(&x->mbx_clock, weight);
+            continue;
+        }
+
+        hit = false;
+
+        if (state == MBX_EMPTY && atomic_cas(&x->mbx_state, MBX_EMPTY, MBX_QUEUED))
+            queue = true;
+    }
+
+    perfc_inc(&mbcache_pc, hit ? PERFC_RA_MBCACHE_HIT : PERFC_RA_MBCACHE_MISS);
+
+    if (queue && atomic_cas(&map->mbm_queued, 0, 1)) {
+        atomic_inc(&map->mbm_refcnt);
+        queue_work(mbcache.mbc_wq, &map->mbm_work);
+    }
+
+    return hit;
+}
+
+void
+mbcache_extent_set(struct mbcache_map *map, enum mbcache_ext ext, uint32_t pg, uint32_t pgc)
+{
+    struct mbcache_extent *x;
+
+    if (!map || pgc == 0)
+        return;
+
+    assert(ext < MBC_EXT_MAX);
+    x = map->mbm_extv + ext;
+
+    /* Mappings that share the map register identical extents.
+     */
+    mutex_lock(&map->mbm_shard->mbs_lock);
+    if (x->mbx_pgc == 0) {
+        x->mbx_pg = pg;
+        x->mbx_pgc = pgc;
+
+        if ((uint64_t)pgc * PAGE_SIZE > mbcache.mbc_budget / MBCACHE_SHARDS)
+            atomic_set(&x->mbx_state, MBX_BYPASS);
+    }
+    mutex_unlock(&map->mbm_shard->mbs_lock);
+
+    assert(x->mbx_pg == pg && x->mbx_pgc == pgc);
+}
+
+merr_t
+mbcache_mmap(
+    struct mpool *mp,
+    uint64_t mbid,
+    struct kvs_mblk_desc *md,
+    struct mbcache_map **map_out)
+{
+    struct mbcache_shard *shard;
+    struct mblock_props props;
+    struct mbcache_map *map;
+    merr_t err;
+
+    INVARIANT(mp);
+    INVARIANT(md);
+    INVARIANT(map_out);
+
+    *map_out = NULL;
+
+    err = mblk_mmap(mp, mbid, md);
+    if (err || !mbcache.mbc_budget)
+        return err;
+
+    err = mpool_mblock_props_get(mp, mbid, &props);
+    if (ev(err)) {
+        mblk_munmap(mp, md);
+        return err;
+    }
+
+    if (!props.mpr_directio || props.mpr_write_len == 0)
+        return 0;
+
+    shard = mbcache_shard(mbid);
+
+    mutex_lock(&shard->mbs_lock);
+    map = map_lookup_ptr(shard->mbs_map, mbid);
+    if (map) {
+        assert(map->mbm_base == md->map_base);
+        map->mbm_mapcnt++;
+    } else {
+        map = calloc(1, sizeof(*map));
+        if (map) {
+            map->mbm_mbid = mbid;
+            map->mbm_mp = mp;
+            map->mbm_base = md->map_base;
+            map->mbm_shard = shard;
+            map->mbm_mapcnt = 1;
+            atomic_set(&map->mbm_refcnt, 1);
+            atomic_set(&map->mbm_queued, 0);
+            INIT_WORK(&map->mbm_work, mbcache_fill_work);
+
+            for (size_t i = 0; i < NELEM(map->mbm_extv); ++i) {
+                INIT_LIST_HEAD(&map->mbm_extv[i].mbx_link);
+                map->mbm_extv[i].mbx_map = map;
+                atomic_set(&map->mbm_extv[i].mbx_state, MBX_EMPTY);
+                atomic_set(&map->mbm_extv[i].mbx_clock, 0);
+            }
+
+            err = map_insert_ptr(shard->mbs_map, mbid, map);
+            if (ev(err)) {
+                free(map);
+                map = NULL;
+            }
+        }
+    }
+    mutex_unlock(&shard->mbs_lock);
+
+    /* Without a cache map the mblock is simply not cached.
+     */
+    if (!map)
+        return 0;
+
+    md->cached = 1;
+    *map_out = map;
+
+    return 0;
+}
+
+merr_t
+mbcache_munmap(struct mpool *mp, struct kvs_mblk_desc *md, struct mbcache_map *map)
+{
+    merr_t err = 0, err2;
+
+    INVARIANT(mp);
+    INVARIANT(md);
+
+    if (map) {
+        struct mbcache_shard *shard = map->mbm_shard;
+        bool last;
+
+        /* The extents must be restored before the mblock is unmapped, as
+         * otherwise copies could outlive the mblock in a mapping shared
+         * with other mblocks (and then shadow a new mblock at the same
+         * offset).  Fills in progress see mbm_dead and discard theirs.
+         */
+        mutex_lock(&shard->mbs_lock);
+        assert(map->mbm_mapcnt > 0);
+        last = --map->mbm_mapcnt == 0;
+        if (last) {
+            map_remove_ptr(shard->mbs_map, map->mbm_mbid);
+            map->mbm_dead = true;
+
+            for (size_t i = 0; i < NELEM(map->mbm_extv); ++i) {
+                struct mbcache_extent *x = map->mbm_extv + i;
+
+                if (atomic_read(&x->mbx_state) != MBX_RESIDENT)
+                    continue;
+
+                err2 = mbcache_evict_locked(shard, x, true);
+                if (!err)
+                    err = err2;
+            }
+        }
+        mutex_unlock(&shard->mbs_lock);
+
+        if (last)
+            mbcache_map_put(map);
+    }
+
+    md->cached = 0;
+
+    err2 = mblk_munmap(mp, md);
+
+    return err ? err : err2;
+}
+
+void
+mbcache_sync(void)
+{
+    if (mbcache.mbc_wq)
+        flush_workqueue(mbcache.mbc_wq);
+}
+
+merr_t
+mbcache_init(void)
+{
+    for (size_t i = 0; i < NELEM(mbcache.mbc_shardv); ++i) {
+        struct mbcache_shard *shard = mbcache.mbc_shardv + i;
+
+        mutex_init(&shard->mbs_lock);
+        INIT_LIST_HEAD(&shard->mbs_clock);
+        shard->mbs_resident = 0;
+        shard->mbs_extents = 0;
+    }
+
+    for (size_t i = 0; i < NELEM(mbcache.mbc_shardv); ++i) {
+        struct mbcache_shard *shard = mbcache.mbc_shardv + i;
+
+        shard->mbs_map = map_create(0);
+        if (ev(!shard->mbs_map)) {
+            mbcache_fini();
+            return merr(ENOMEM);
+        }
+    }
+
+    if (hse_gparams.gp_cn_mbcache_sz > 0) {
+        mbcache.mbc_wq = alloc_workqueue("hse_mbcache", 0, 1, 4);
+        if (ev(!mbcache.mbc_wq)) {
+            mbcache_fini();
+            return merr(ENOMEM);
+        }
+    }
+
+    mbcache.mbc_budget = hse_gparams.gp_cn_mbcache_sz;
+
+    perfc_alloc(mbcache_perfc, "global", "mbcache", hse_gparams.gp_perfc_level, &mbcache_pc);
+
+    return 0;
+}
+
+void
+mbcache_fini(void)
+{
+    mbcache.mbc_budget = 0;
+
+    /* Queued fills of dead maps hold the last reference on them.
+     */
+    destroy_workqueue(mbcache.mbc_wq);
+    mbcache.mbc_wq = NULL;
+
+    perfc_free(&mbcache_pc);
+
+    for (size_t i = 0; i < NELEM(mbcache.mbc_shardv); ++i) {
+        struct mbcache_shard *shard = mbcache.mbc_shardv + i;
+
+        if (shard->mbs_map) {
+            assert(map_count_get(shard->mbs_map) == 0);
+            map_destroy(shard->mbs_map);
+            shard->mbs_map = NULL;
+        }
+
+        assert(list_empty(&shard->mbs_clock));
+        mutex_destroy(&shard->mbs_lock);
+    }
+}
@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#ifndef HSE_CN_MBCACHE_H
+#define HSE_CN_MBCACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/compiler.h>
+
+/* The mblock cache keeps HSE-managed copies of the hot regions of kblocks and
+ * hblocks that reside on media classes opened for direct I/O, such that point
+ * gets are served from memory whose residency HSE controls rather than from
+ * the page cache (which may be thrashed by other tenants).
+ *
+ * Kblocks and hblocks are memory mapped as usual.  Each region registered
+ * via mbcache_extent_set() is an extent of the mapping that lookups report
+ * via mbcache_touch().  A touch that finds an extent absent counts as a miss
+ * and queues an asynchronous fill, which reads the extent into anonymous
+ * memory and moves it over the extent's pages of the mapping.  Eviction
+ * remaps the pages from media.  Either way map_base and every pointer
+ * derived from it remain valid, hence readers need not pin anything.
+ *
+ * Residency is bounded by gparam cn_mbcache_sz, split evenly over the shards,
+ * each of which runs a CLOCK over its resident extents.  A touch sets an
+ * extent's clock to the weight of its kind, where filters, wbtree internal
+ * nodes and hash indexes weigh more than leaf nodes and key metadata, and
+ * hence survive more sweeps of the hand.
+ */
+
+struct mpool;
+struct kvs_mblk_desc;
+struct mbcache_map;
+
+enum mbcache_ext {
+    MBC_EXT_FILTER,   /* bloom or fuse filter */
+    MBC_EXT_HIX,      /* kblock hash index */
+    MBC_EXT_WBT_INT,  /* wbtree internal nodes */
+    MBC_EXT_WBT_LEAF, /* wbtree leaf nodes */
+    MBC_EXT_KMD,      /* wbtree key metadata */
+    MBC_EXT_MAX
+};
+
+#define MBC_EXT_MASK(_ext) (1u << (_ext))
+
+/**
+ * mbcache_mmap() - map a kblock or hblock via the mblock cache
+ * @mp:      mpool
+ * @mbid:    mblock ID
+ * @md_out:  (output) mblock descriptor
+ * @map_out: (output) cache map, NULL if the mblock is not eligible
+ *
+ * Mappings of the same mblock share one cache map.  Use mbcache_munmap()
+ * to release an mblock mapped by mbcache_mmap().
+ */
+merr_t
+mbcache_mmap(
+    struct mpool *mp,
+    uint64_t mbid,
+    struct kvs_mblk_desc *md_out,
+    struct mbcache_map **map_out);
+
+/**
+ * mbcache_munmap() - release an mblock mapped by mbcache_mmap()
+ * @mp:  mpool
+ * @md:  mblock descriptor
+ * @map: cache map (may be NULL)
+ */
+merr_t
+mbcache_munmap(struct mpool *mp, struct kvs_mblk_desc *md, struct mbcache_map *map);
+
+/**
+ * mbcache_extent_set() - register a cacheable region of a mapped mblock
+ * @map: cache map (may be NULL)
+ * @ext: kind of region
+ * @pg:  first page of the region
+ * @pgc: number of pages in the region
+ */
+void
+mbcache_extent_set(struct mbcache_map *map, enum mbcache_ext ext, uint32_t pg, uint32_t pgc);
+
+/**
+ * mbcache_touch() - record a lookup of an mblock's extents
+ * @map:     cache map (may be NULL)
+ * @extmask: MBC_EXT_MASK() of the extents the lookup reads
+ *
+ * Counts a hit if all the given extents are resident, otherwise a miss,
+ * and queues fills for the absent extents.
+ *
+ * Return: true if all the given extents were resident
+ */
+bool
+mbcache_touch(struct mbcache_map *map, uint extmask);
+
+/**
+ * mbcache_sync() - wait for all queued fills to complete
+ */
+void
+mbcache_sync(void);
+
+merr_t
+mbcache_init(void) HSE_COLD;
+
+void
+mbcache_fini(void) HSE_COLD;
+
+#endif
@@ -338,11 +338,11 @@ wbt_leaf_compare(const void * const a, const void * const b)
     INVARIANT(b);
 
     lfe_a = wbt_lfe(wbt_node_a, 0);
-    wbt_node_pfx(wbt_node_a, &key_a.ko_pfx, &key_a.ko_pfx_len);
+    wbt_lfe_pfx(wbt_node_a, lfe_a, &key_a.ko_pfx, &key_a.ko_pfx_len);
     wbt_lfe_key(wbt_node_a, lfe_a, &key_a.ko_sfx, &key_a.ko_sfx_len);
 
     lfe_b = wbt_lfe(wbt_node_b, 0);
-    wbt_node_pfx(wbt_node_b, &key_b.ko_pfx, &key_b.ko_pfx_len);
+    wbt_lfe_pfx(wbt_node_b, lfe_b, &key_b.ko_pfx, &key_b.ko_pfx_len);
     wbt_lfe_key(wbt_node_b, lfe_b, &key_b.ko_sfx, &key_b.ko_sfx_len);
 
     /* Return the WBT leaf node with the smallest key. */
@@ -438,7 +438,7 @@ find_split_key(
 
     /* Get first leaf node entry */
     lfe = wbt_lfe(wnode, 0);
-    wbt_node_pfx(wnode, &key.ko_pfx, &key.ko_pfx_len);
+    wbt_lfe_pfx(wnode, lfe, &key.ko_pfx, &key.ko_pfx_len);
     wbt_lfe_key(wnode, lfe, &key.ko_sfx, &key.ko_sfx_len);
 
     key_obj_copy(key_buf, key_buf_sz, key_len, &key);
@@ -21,6 +21,12 @@
  * Wanna B-Tree (WBT) On-Media-Format
  *
  * Supported versions:
+ *     v8: Leaf node keys are front coded relative to restart keys instead
+ *         of sharing a node prefix, and leaf node hints cover only the
+ *         restart keys.  See WBT_LFE_RESTART_INTERVAL.
+ *     v7: Added an array of fixed-width key suffix hints to each node,
+ *         following its entries (including the right edge entry of an
+ *         internal node).  See WBT_NODE_HINT_SIZE.
  *     v6: Added support for compressed values. Uses a new value type
  *         (VTYPE_CVAL) which affects KMD format. Unfortunately,
  *         there is no version field for KMD, so we bump the WBTree
@@ -64,7 +70,7 @@ struct wbt_node_hdr_omf {
     uint32_t wbn_kmd;      /* offset in kmd region to this node's kmd */
     uint64_t wbn_kvlen;    /* total key and value data referenced by this node */
     uint16_t wbn_pfx_len;  /* length of the longest common prefix */
-    uint16_t wbn_rsvd1;    /* unused padding */
+    uint16_t wbn_restart;  /* leaf key restart interval (v8), else zero */
     uint32_t wbn_rsvd2;    /* unused padding */
 } HSE_PACKED;
 
@@ -73,6 +79,7 @@ OMF_SETGET(struct wbt_node_hdr_omf, wbn_num_keys, 16)
 OMF_SETGET(struct wbt_node_hdr_omf, wbn_kmd, 32)
 OMF_SETGET(struct wbt_node_hdr_omf, wbn_kvlen, 64)
 OMF_SETGET(struct wbt_node_hdr_omf, wbn_pfx_len, 16)
+OMF_SETGET(struct wbt_node_hdr_omf, wbn_restart, 16)
 
 /* WBT internal node entry (v6) */
 struct wbt_ine_omf {
@@ -95,9 +102,37 @@ struct wbt_lfe_omf {
 /* Size of an LE32 */
 #define WBT_LFE_INLINE_KMD_OFF_SIZE 4
 
+/* Size of a node's per-key suffix hint (v7).  A hint is the first four bytes
+ * of a key's suffix, zero padded, stored as an LE32 of their big-endian value.
+ * Hints are thus in the same order as the keys of the node, except where two
+ * hints are equal.
+ */
+#define WBT_NODE_HINT_SIZE 4
+
 OMF_SETGET(struct wbt_lfe_omf, lfe_koff, 16)
 OMF_SETGET(struct wbt_lfe_omf, lfe_kmd, 16)
 
+/* Leaf nodes of v8 trees have no node prefix.  Instead, every
+ * WBT_LFE_RESTART_INTERVAL'th key (starting with the first) is a restart key
+ * and is stored whole.  Every other key is stored as the length of the prefix
+ * it shares with the restart key that precedes it (an LE16, following the
+ * inline kmd offset, if any), followed by the rest of the key.  A key is thus
+ * a prefix of its restart key plus its own suffix, neither of which needs to
+ * be copied, and a node can be searched by restart keys first.  The hint
+ * array that follows the entries holds one hint per restart key.
+ *
+ * The interval is recorded in each leaf node header (wbn_restart), leaf nodes
+ * of earlier versions having always zeroed the header padding.  It must be a
+ * power of two.
+ */
+#define WBT_LFE_RESTART_INTERVAL 16
+
+struct wbt_lfe_shared_omf {
+    uint16_t lfs_shared;
+} HSE_PACKED;
+
+OMF_SETGET(struct wbt_lfe_shared_omf, lfs_shared, 16)
+
 /*****************************************************************
  *
  * Hblock header OMF
@@ -225,7 +260,7 @@ struct kblock_hdr_omf {
     /* metrics */
     uint32_t kbh_entries;
     uint32_t kbh_tombs;
-    uint32_t kbh_rsvd1;
+    uint32_t kbh_hix_nbkts;
     uint32_t kbh_key_bytes;
     uint64_t kbh_val_bytes;
     uint64_t kbh_kvlen;
@@ -237,7 +272,7 @@ struct kblock_hdr_omf {
     uint32_t kbh_max_koff;
     uint16_t kbh_min_klen;
     uint16_t kbh_max_klen;
-    uint32_t kbh_rsvd2;
+    uint32_t kbh_hix_doff_pg;
 
     /* WBT header */
     uint32_t kbh_wbt_hoff;
@@ -280,6 +315,9 @@ OMF_SETGET(struct kblock_hdr_omf, kbh_blm_hlen, 32)
 OMF_SETGET(struct kblock_hdr_omf, kbh_blm_doff_pg, 32)
 OMF_SETGET(struct kblock_hdr_omf, kbh_blm_dlen_pg, 32)
 
+OMF_SETGET(struct kblock_hdr_omf, kbh_hix_nbkts, 32)
+OMF_SETGET(struct kblock_hdr_omf, kbh_hix_doff_pg, 32)
+
 /* Storing 2 keys in the header: min and max. */
 #define KBLOCK_HDR_PAGES \
     (roundup(sizeof(struct kblock_hdr_omf) + 2 * HSE_KVS_KEY_LEN_MAX, PAGE_SIZE) / PAGE_SIZE)
@@ -300,10 +338,17 @@ static_assert(KBLOCK_HDR_PAGES == 1, "Kblock header spanning more than 1 page ha
  * @bh_magic:           BLOOM_OMF_MAGIC
  * @bh_version:         BLOOM_OMF_VERSION
  * @bh_bktsz:           number of bytes per bucket
+ * @bh_type:            filter type (BLOOM_OMF_TYPE_*, BLOOM_OMF_VERSION7+)
  * @bh_rotl:            hash rotate left amount
  * @bh_n_hashes:        number of hashes per bucket
  * @bh_bitmapsz:        size of bitmap in bytes
  * @bh_modulus:         modulus used to convert first hash to bucket
+ * @bh_seed:            filter seed (binary fuse filters only)
+ *
+ * For binary fuse filters @bh_bitmapsz is the size of the fingerprint
+ * array, @bh_modulus is the number of slots from which the first slot
+ * of a key is chosen, @bh_bktshift is log2 of the segment length, and
+ * @bh_rotl is the number of bits per fingerprint.
  */
 struct bloom_hdr_omf {
     uint32_t bh_magic;
@@ -311,21 +356,84 @@ struct bloom_hdr_omf {
     uint32_t bh_bitmapsz;
     uint32_t bh_modulus;
     uint32_t bh_bktshift;
-    uint16_t bh_rsvd1;
+    uint16_t bh_type;
     uint8_t bh_rotl;
     uint8_t bh_n_hashes;
-    uint32_t bh_rsvd2;
-    uint32_t bh_rsvd3;
+    uint64_t bh_seed;
 } HSE_PACKED;
 
+enum {
+    BLOOM_OMF_TYPE_BLOOM = 0,
+    BLOOM_OMF_TYPE_FUSE = 1,
+};
+
 /* Define set/get methods for bloom_hdr_omf */
 OMF_SETGET(struct bloom_hdr_omf, bh_magic, 32)
 OMF_SETGET(struct bloom_hdr_omf, bh_version, 32)
 OMF_SETGET(struct bloom_hdr_omf, bh_bitmapsz, 32)
 OMF_SETGET(struct bloom_hdr_omf, bh_modulus, 32)
 OMF_SETGET(struct bloom_hdr_omf, bh_bktshift, 32)
+OMF_SETGET(struct bloom_hdr_omf, bh_type, 16)
 OMF_SETGET(struct bloom_hdr_omf, bh_rotl, 8)
 OMF_SETGET(struct bloom_hdr_omf, bh_n_hashes, 8)
+OMF_SETGET(struct bloom_hdr_omf, bh_seed, 64)
+
+/*****************************************************************
+ *
+ * Kblock hash index OMF (KBLOCK_HDR_VERSION7+)
+ *
+ ****************************************************************/
+
+/* The optional hash index maps the hash of each key in a kblock to the wbt
+ * leaf node and slot that holds the key.  It is an open addressing table of
+ * kbh_hix_nbkts cache line sized buckets stored at page kbh_hix_doff_pg,
+ * right after the bloom filter.  A key's probe sequence starts at the bucket
+ * chosen by the low 32 bits of its hash and proceeds through consecutive
+ * buckets (wrapping around) until an empty entry is found.  Each entry holds
+ * the high 32 bits of the key's hash as a fingerprint.  Buckets are filled
+ * to at most KBLOCK_HIX_BKT_LOAD entries on average, hence every probe
+ * sequence ends at an empty entry.  A kbh_hix_nbkts of zero (as in all
+ * kblocks prior to version 7) means the kblock has no hash index.
+ */
+#define KBLOCK_HIX_BKT_ENTRIES (8)
+#define KBLOCK_HIX_BKT_LOAD    (6)
+#define KBLOCK_HIX_NODE_EMPTY  ((uint16_t)UINT16_MAX)
+
+struct kblock_hix_ent_omf {
+    uint32_t hxe_fp;
+    uint16_t hxe_node;
+    uint16_t hxe_slot;
+} HSE_PACKED;
+
+#define KBLOCK_HIX_BKT_SIZE (KBLOCK_HIX_BKT_ENTRIES * sizeof(struct kblock_hix_ent_omf))
+
+static_assert(KBLOCK_HIX_BKT_SIZE == 64, "hash index bucket must fill one cache line");
+
+OMF_SETGET(struct kblock_hix_ent_omf, hxe_fp, 32)
+OMF_SETGET(struct kblock_hix_ent_omf, hxe_node, 16)
+OMF_SETGET(struct kblock_hix_ent_omf, hxe_slot, 16)
+
+/* Number of buckets and pages of a hash index for nkeys keys.
+ */
+static inline uint32_t
+kblock_hix_nbkts(uint32_t nkeys)
+{
+    return nkeys ? (nkeys + KBLOCK_HIX_BKT_LOAD - 1) / KBLOCK_HIX_BKT_LOAD : 1;
+}
+
+static inline uint32_t
+kblock_hix_pgc(uint32_t nbkts)
+{
+    return (nbkts * KBLOCK_HIX_BKT_SIZE + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
+/* Bucket at which the probe sequence of a key hash begins.
+ */
+static inline uint32_t
+kblock_hix_bkt(uint64_t hash, uint32_t nbkts)
+{
+    return ((hash & UINT32_MAX) * nbkts) >> 32;
+}
 
 /*****************************************************************
  *
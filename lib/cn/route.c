@@ -9,7 +9,9 @@
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/assert.h>
+#include <hse/util/atomic.h>
 #include <hse/util/byteorder.h>
+#include <hse/util/event_counter.h>
 #include <hse/util/keycmp.h>
 #include <hse/util/log2.h>
 #include <hse/util/minmax.h>
@@ -19,13 +21,198 @@
 #include "cn_tree_internal.h"
 #include "route.h"
 
+/* The route index is an immutable snapshot of the rb tree used to speed up
+ * lookups.  Edge keys are laid out in Eytzinger (BFS) order such that the
+ * top levels of the search share a few cache lines and the descendants of
+ * each entry can be prefetched.  Each entry caches the eight bytes of its
+ * edge key that follow the prefix common to all edge keys, so most steps
+ * need not touch the route node at all.
+ *
+ * Any change to the rb tree or to an edge key discards the index, and the
+ * next lookup rebuilds it.  Mutations are serialized against lookups by
+ * the caller (e.g., via the cn tree lock), hence an index is never freed
+ * while in use.  Lookups that race with a rebuild use the rb tree.
+ */
+struct route_index_ent {
+    uint64_t rie_pfx;
+    struct route_node *rie_node;
+};
+
+struct route_index {
+    uint rti_nodec;
+    uint rti_lcp;
+    struct route_node *rti_first;
+    struct route_node *rti_last;
+    struct route_index_ent rti_entv[] HSE_L1D_ALIGNED;
+};
+
 struct route_map {
     struct rb_root rtm_root;
     uint rtm_nodec;
     struct route_node *rtm_free;
+    struct route_index *_Atomic rtm_index;
+    atomic_int rtm_index_busy;
     struct route_node rtm_nodev[] HSE_L1D_ALIGNED;
 };
 
+static void
+route_map_index_invalidate(struct route_map *map)
+{
+    free(atomic_exchange(&map->rtm_index, NULL));
+}
+
+static HSE_ALWAYS_INLINE uint64_t
+route_key_pfx(const void *key, uint klen)
+{
+    uint64_t pfx = 0;
+
+    memcpy(&pfx, key, min_t(uint, klen, sizeof(pfx)));
+
+    return be64_to_cpu(pfx);
+}
+
+static struct rb_node *
+route_index_fill(struct route_index *ix, uint k, struct rb_node *rbn)
+{
+    struct route_node *node;
+
+    if (k > ix->rti_nodec)
+        return rbn;
+
+    rbn = route_index_fill(ix, 2 * k, rbn);
+
+    node = rb_entry(rbn, struct route_node, rtn_node);
+    ix->rti_entv[k].rie_pfx =
+        route_key_pfx(node->rtn_keybufp + ix->rti_lcp, node->rtn_keylen - ix->rti_lcp);
+    ix->rti_entv[k].rie_node = node;
+
+    return route_index_fill(ix, 2 * k + 1, rb_next(rbn));
+}
+
+static struct route_index *
+route_index_create(struct route_map *map)
+{
+    struct route_node *first, *last;
+    struct route_index *ix;
+    struct rb_node *rbn;
+    uint nodec = 0, lcp;
+    size_t sz;
+
+    for (rbn = rb_first(&map->rtm_root); rbn; rbn = rb_next(rbn))
+        nodec++;
+
+    if (nodec == 0)
+        return NULL;
+
+    sz = sizeof(*ix) + sizeof(ix->rti_entv[0]) * (nodec + 1);
+
+    ix = aligned_alloc(__alignof__(*ix), roundup(sz, __alignof__(*ix)));
+    if (ev(!ix))
+        return NULL;
+
+    first = rb_entry(rb_first(&map->rtm_root), struct route_node, rtn_node);
+    last = rb_entry(rb_last(&map->rtm_root), struct route_node, rtn_node);
+
+    /* The prefix common to all edge keys is that of the first and last keys.
+     */
+    lcp = min_t(uint, first->rtn_keylen, last->rtn_keylen);
+    for (uint i = 0; i < lcp; ++i) {
+        if (first->rtn_keybufp[i] != last->rtn_keybufp[i]) {
+            lcp = i;
+            break;
+        }
+    }
+
+    ix->rti_nodec = nodec;
+    ix->rti_lcp = lcp;
+    ix->rti_first = first;
+    ix->rti_last = last;
+    ix->rti_entv[0].rie_pfx = 0;
+    ix->rti_entv[0].rie_node = NULL;
+
+    rbn = route_index_fill(ix, 1, rb_first(&map->rtm_root));
+    assert(!rbn);
+
+    return ix;
+}
+
+/* Return the route index, building it if it was discarded by a mutation.
+ * Only one lookup at a time builds it, the others use the rb tree meanwhile.
+ */
+static struct route_index *
+route_map_index_get(struct route_map *map)
+{
+    struct route_index *ix;
+
+    ix = atomic_load_explicit(&map->rtm_index, memory_order_acquire);
+    if (HSE_LIKELY(ix))
+        return ix;
+
+    if (!atomic_cas(&map->rtm_index_busy, 0, 1))
+        return NULL;
+
+    ix = atomic_load_explicit(&map->rtm_index, memory_order_acquire);
+    if (!ix) {
+        ix = route_index_create(map);
+        atomic_store_explicit(&map->rtm_index, ix, memory_order_release);
+    }
+
+    atomic_set_rel(&map->rtm_index_busy, 0);
+
+    return ix;
+}
+
+/* Same semantics as route_map_find(), see below.
+ */
+static struct route_node *
+route_index_find(const struct route_index *ix, const void *key, uint keylen, bool gt)
+{
+    const struct route_index_ent *entv = ix->rti_entv;
+    const uint nodec = ix->rti_nodec;
+    const uint lcp = ix->rti_lcp;
+    uint64_t pfx;
+    uint k = 1;
+
+    if (lcp > 0) {
+        int rc = memcmp(key, ix->rti_first->rtn_keybufp, min_t(uint, keylen, lcp));
+
+        if (rc < 0 || (rc == 0 && keylen < lcp))
+            return ix->rti_first;
+        if (rc > 0)
+            return ix->rti_last;
+    }
+
+    pfx = route_key_pfx((const uint8_t *)key + lcp, keylen - lcp);
+
+    while (k <= nodec) {
+        const struct route_index_ent *ent = entv + k;
+        int rc;
+
+        /* The four grandchildren of entry k share a cache line.
+         */
+        __builtin_prefetch(entv + 4 * k);
+
+        if (pfx != ent->rie_pfx)
+            rc = (pfx < ent->rie_pfx) ? -1 : 1;
+        else
+            rc = route_node_keycmp(key, keylen, ent->rie_node);
+
+        k = 2 * k + (rc > 0 || (gt && rc == 0));
+    }
+
+    /* Undo the right turns taken after the last left turn, which leaves
+     * the successor (or zero if there were no left turns).
+     */
+    k >>= __builtin_ffs(~k);
+    if (k > 0)
+        return entv[k].rie_node;
+
+    if (gt && route_node_keycmp(key, keylen, ix->rti_last) == 0)
+        return NULL;
+
+    return ix->rti_last;
+}
+
 static merr_t
 route_node_keybuf_alloc(struct route_node *node, uint edge_klen)
 {
@@ -134,6 +321,7 @@ route_node_key_modify(
         return err;
 
     route_node_key_set(node, edge_key, edge_klen);
+    route_map_index_invalidate(map);
 
     return 0;
 }
@@ -171,6 +359,7 @@ route_map_insert_by_node(struct route_map *map, struct route_node *node)
 
     rb_link_node(&node->rtn_node, parent, link);
     rb_insert_color(&node->rtn_node, root);
+    route_map_index_invalidate(map);
 
     if (first != rb_first(root)) {
         assert(rb_first(root) == &node->rtn_node);
@@ -232,6 +421,7 @@ route_map_delete(struct route_map *map, struct route_node *node)
 
     rb_erase(&node->rtn_node, root);
     route_node_free(map, node);
+    route_map_index_invalidate(map);
 
     assert(first && last);
     if (first != (cur = rb_first(root)) && cur) {
@@ -313,16 +503,31 @@ route_map_first_node(struct route_map *map)
     return first;
 }
 
+static struct route_node *
+route_map_lookup_impl(struct route_map *map, const void *key, uint keylen, bool gt)
+{
+    struct route_index *ix;
+
+    if (!map)
+        return NULL;
+
+    ix = route_map_index_get(map);
+    if (ix)
+        return route_index_find(ix, key, keylen, gt);
+
+    return route_map_find(map, key, keylen, gt);
+}
+
 struct route_node *
 route_map_lookup(struct route_map *map, const void *key, uint keylen)
 {
-    return map ? route_map_find(map, key, keylen, false) : NULL;
+    return route_map_lookup_impl(map, key, keylen, false);
 }
 
 struct route_node *
 route_map_lookupGT(struct route_map *map, const void *key, uint keylen)
 {
-    return map ? route_map_find(map, key, keylen, true) : NULL;
+    return route_map_lookup_impl(map, key, keylen, true);
 }
 
 struct route_node *
@@ -409,6 +614,7 @@ route_map_destroy(struct route_map *map)
         node = node->rtn_next;
     }
 
+    route_map_index_invalidate(map);
     free(map);
 }
 
@@ -71,6 +71,9 @@ route_node_free(struct route_map *map, struct route_node *node);
  * @map:    Route map handle
  * @key:    Key being looked up
  * @keylen: Length of %key
+ *
+ * Lookups may run concurrently with each other but not with any function that
+ * modifies the map (insert, delete, key modify).
  */
 struct route_node *
 route_map_lookup(struct route_map *map, const void *key, uint keylen);
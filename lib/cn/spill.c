@@ -261,6 +261,8 @@ cn_subspill(
     kvset_builder_set_merge_stats(child, &w->cw_stats);
 
     err = kvset_builder_set_agegroup(child, HSE_MPOLICY_AGE_LEAF);
+    if (!err && cn_node_ishot(node, w->cw_rp))
+        err = kvset_builder_set_value_agegroup(child, HSE_MPOLICY_AGE_ROOT);
     if (err) {
         kvset_builder_destroy(child);
         return err;
@@ -389,7 +391,10 @@ cn_subspill(
                 if (w->cw_drop_tombs && HSE_CORE_IS_TOMB(vdata) && bg_val)
                     continue; /* skip value */
 
-                err = kvset_builder_add_val(child, &sctx->curr->kobj, vdata, vlen, seq, complen);
+                if (vtype == VTYPE_MOPND)
+                    err = kvset_builder_add_mopnd(child, seq, vdata, vlen);
+                else
+                    err = kvset_builder_add_val(child, &sctx->curr->kobj, vdata, vlen, seq, complen);
                 if (err)
                     break;
 
@@ -415,6 +420,12 @@ cn_subspill(
                  */
                 assert(vdata != HSE_CORE_TOMB_PFX);
             }
+
+            /* Merge operands are resolved only by kv-compaction, hence the
+             * values beneath an operand remain visible and must be spilled.
+             */
+            if (vtype == VTYPE_MOPND)
+                bg_val = false;
         }
 
         if (err)
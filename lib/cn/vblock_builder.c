@@ -15,6 +15,7 @@
 #include <hse/error/merr.h>
 #include <hse/ikvdb/blk_list.h>
 #include <hse/ikvdb/cn.h>
+#include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/mclass_policy.h>
@@ -24,6 +25,7 @@
 #include <hse/util/alloc.h>
 #include <hse/util/assert.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/perfc.h>
 #include <hse/util/slab.h>
@@ -35,9 +37,28 @@
 #include "cn_perfc.h"
 #include "omf.h"
 #include "vblock_builder.h"
+#include "wbehind.h"
 
 #define WBUF_LEN_MAX ((1024 * 1024) + VBLOCK_FOOTER_LEN)
 
+struct vblock_builder;
+
+/**
+ * struct vblock_wreq - a vblock write buffer and its write-behind request
+ * @vw_req:   write-behind request
+ * @vw_bld:   vblock builder
+ * @vw_blkid: vblock to which @vw_buf is written
+ * @vw_buf:   write buffer (WBUF_LEN_MAX bytes)
+ * @vw_len:   number of bytes to write
+ */
+struct vblock_wreq {
+    struct wbehind_req vw_req;
+    struct vblock_builder *vw_bld;
+    uint64_t vw_blkid;
+    void *vw_buf;
+    uint32_t vw_len;
+};
+
 /**
  * struct vblock_builder - create vblocks from a stream of values
  * @mp:        mpool handle
@@ -53,6 +74,10 @@
  * @mblocksz:  mblock size of specified media class
  * @cur_minklen: min key length
  * @cur_minkey:  a copy of the min key referencing this vblock
+ * @wb:        write-behind queue
+ * @wbuf_idx:  index of @wbuf in @wreqv
+ * @wbufc:     number of write buffers
+ * @wreqv:     write buffers and their write requests
  *
  * WBUF_LEN_MAX is the allocated size of the write buffer.  Each mblock write
  * will be at most WBUF_LEN_MAX bytes.  Member @wbuf_len is the actual write
@@ -60,7 +85,10 @@
  *
  * The vblock builder creates as many vblocks as needed to store the values.
  * The write buffer is allocated once when the builder is created, and is
- * reused between vblocks.  The following logic explains how the vlbock
+ * reused between vblocks.  If cn_wbehind_qdepth is greater than one, a full
+ * write buffer is handed off to the cn I/O workqueue and the builder continues
+ * with the next of up to @wbufc write buffers, waiting only if that buffer's
+ * previous write has yet to complete.  The following logic explains how the vlbock
  * builder state is managed as new values are added.
  *
  * When a new value is given to the vblock builder:
@@ -104,6 +132,10 @@ struct vblock_builder {
     bool destruct;
     uint32_t cur_minklen;
     char cur_minkey[HSE_KVS_KEY_LEN_MAX];
+    struct wbehind wb;
+    uint wbuf_idx;
+    uint wbufc;
+    struct vblock_wreq wreqv[WBEHIND_QDEPTH_MAX];
 };
 
 static inline bool
@@ -128,6 +160,24 @@ vbb_estimate_alen(struct cn *cn, size_t wlen, enum hse_mclass mclass)
         VBLOCK_MAX_SIZE, zonealloc_unit, wlen, CN_MB_EST_FLAGS_TRUNCATE | CN_MB_EST_FLAGS_PREALLOC);
 }
 
+/* Allocate the current write buffer if it has yet to be used.
+ */
+static merr_t
+vblock_wbuf_alloc(struct vblock_builder *bld)
+{
+    struct vblock_wreq *vw = bld->wreqv + bld->wbuf_idx;
+
+    if (!vw->vw_buf) {
+        vw->vw_buf = vlb_alloc(WBUF_LEN_MAX);
+        if (ev(!vw->vw_buf))
+            return merr(ENOMEM);
+    }
+
+    bld->wbuf = vw->vw_buf;
+
+    return 0;
+}
+
 static merr_t
 vblock_start(struct vblock_builder *bld, const struct key_obj *min_kobj)
 {
@@ -143,6 +193,10 @@ vblock_start(struct vblock_builder *bld, const struct key_obj *min_kobj)
 
     bld->destruct = true;
 
+    err = vblock_wbuf_alloc(bld);
+    if (err)
+        return err;
+
     mclass = mclass_policy_get_type(mpolicy, bld->agegroup, HSE_MPOLICY_DTYPE_VALUE);
     if (mclass == HSE_MCLASS_INVALID)
         return merr(EINVAL);
@@ -177,17 +231,16 @@ vblock_start(struct vblock_builder *bld, const struct key_obj *min_kobj)
 }
 
 static merr_t
-vblock_write(struct vblock_builder *bld)
+vblock_write_cb(struct wbehind_req *req)
 {
-    merr_t err;
+    struct vblock_wreq *vw = container_of(req, struct vblock_wreq, vw_req);
+    struct vblock_builder *bld = vw->vw_bld;
     struct iovec iov;
-    struct cn_merge_stats *stats = bld->mstats;
     uint64_t tstart;
+    merr_t err;
 
-    assert(bld->blkid);
-
-    iov.iov_base = bld->wbuf;
-    iov.iov_len = bld->wbuf_len;
+    iov.iov_base = vw->vw_buf;
+    iov.iov_len = vw->vw_len;
 
     /* Function mblk_blow_chunks(), which is used in the kblock builder,
      * is not needed here because our write buffer is already
@@ -195,21 +248,56 @@ vblock_write(struct vblock_builder *bld)
      */
     tstart = get_time_ns();
 
-    err = mpool_mblock_write(bld->mp, bld->blkid, &iov, 1);
+    err = mpool_mblock_write(bld->mp, vw->vw_blkid, &iov, 1);
 
-    if (stats)
-        count_ops(&stats->ms_vblk_write, 1, iov.iov_len, get_time_ns() - tstart);
+    /* Runs on the write-behind worker, see wbehind_stats_get().
+     */
+    count_ops(&req->wr_stats, 1, iov.iov_len, get_time_ns() - tstart);
+
+    if (ev(err))
+        return err;
+
+    perfc_inc(bld->pc, PERFC_RA_CNCOMP_WREQS);
+    perfc_add(bld->pc, PERFC_RA_CNCOMP_WBYTES, iov.iov_len);
+
+    return 0;
+}
+
+/* Submit the write buffer and switch to the next one, waiting for the
+ * next buffer's previous write to complete if necessary.  The next buffer
+ * is allocated on demand unless this is the last write to the vblock.
+ */
+static merr_t
+vblock_write(struct vblock_builder *bld, bool last)
+{
+    struct vblock_wreq *vw = bld->wreqv + bld->wbuf_idx;
+    merr_t err;
+
+    assert(bld->blkid);
+    assert(vw->vw_buf == bld->wbuf);
+
+    vw->vw_blkid = bld->blkid;
+    vw->vw_len = bld->wbuf_len;
+
+    err = wbehind_submit(&bld->wb, &vw->vw_req, vblock_write_cb);
+    if (!err) {
+        bld->wbuf_idx = (bld->wbuf_idx + 1) % bld->wbufc;
+        vw = bld->wreqv + bld->wbuf_idx;
+
+        err = wbehind_wait(&bld->wb, &vw->vw_req);
+        wbehind_stats_get(&bld->wb, bld->mstats ? &bld->mstats->ms_vblk_write : NULL);
+        if (!err && !last)
+            err = vblock_wbuf_alloc(bld);
+    }
 
     if (ev(err)) {
         bld->destruct = true;
         return err;
     }
 
+    bld->wbuf = vw->vw_buf;
     bld->wbuf_off = 0;
 
-    perfc_inc(bld->pc, PERFC_RA_CNCOMP_WREQS);
-    perfc_add(bld->pc, PERFC_RA_CNCOMP_WBYTES, bld->wbuf_len);
-
     return 0;
 }
 
@@ -254,7 +342,7 @@ vblock_finish(struct vblock_builder *bld, const struct key_obj *max_kobj)
 
     buflen = bld->wbuf_len;
     bld->wbuf_len = bld->wbuf_off + VBLOCK_FOOTER_LEN;
-    err = vblock_write(bld);
+    err = vblock_write(bld, true);
     if (!err)
         bld->tot_vlen += (bld->wbuf_len - VBLOCK_FOOTER_LEN);
     bld->wbuf_len = buflen;
@@ -274,6 +362,7 @@ vbb_create(
 {
     struct mpool_mclass_props props;
     struct mclass_policy *policy;
+    struct workqueue_struct *wq;
     struct vblock_builder *bld;
     void *wbuf;
     merr_t err;
@@ -294,6 +383,17 @@ vbb_create(
     bld->agegroup = HSE_MPOLICY_AGE_LEAF;
     bld->wbuf = wbuf;
 
+    /* Write-behind buffers beyond the first are allocated on demand.
+     */
+    wq = cn_get_io_wq(cn);
+    bld->wbufc = wq ? clamp_t(uint, cn_get_rp(cn)->cn_wbehind_qdepth, 1, WBEHIND_QDEPTH_MAX) : 1;
+
+    for (uint i = 0; i < bld->wbufc; i++)
+        bld->wreqv[i].vw_bld = bld;
+    bld->wreqv[0].vw_buf = wbuf;
+
+    wbehind_init(&bld->wb, bld->wbufc > 1 ? wq : NULL);
+
     policy = cn_get_mclass_policy(bld->cn);
 
     err = mpool_mclass_props_get(
@@ -315,10 +415,17 @@ vbb_destroy(struct vblock_builder *bld)
     if (ev(!bld))
         return;
 
+    /* Wait for writes in flight before deleting their mblocks.
+     */
+    wbehind_fini(&bld->wb);
+
     delete_mblocks(bld->mp, &bld->vblk_list);
     blk_list_free(&bld->vblk_list);
 
-    vlb_free(bld->wbuf, WBUF_LEN_MAX + sizeof(*bld));
+    for (uint i = 1; i < bld->wbufc; i++)
+        vlb_free(bld->wreqv[i].vw_buf, WBUF_LEN_MAX);
+
+    vlb_free(bld->wreqv[0].vw_buf, WBUF_LEN_MAX + sizeof(*bld));
 }
 
 /* Add a value to vblock.  Create new vblock if needed. */
@@ -375,7 +482,7 @@ vbb_add_entry(
 
         /* Issue write if buffer is full. */
         if (bld->wbuf_off == bld->wbuf_len) {
-            err = vblock_write(bld);
+            err = vblock_write(bld, false);
             if (ev(err))
                 return err;
             bld->tot_vlen += bld->wbuf_len;
@@ -410,6 +517,11 @@ vbb_finish(struct vblock_builder *bld, struct blk_list *vblks, const struct key_
     if (ev(err))
         return err;
 
+    err = wbehind_drain(&bld->wb);
+    wbehind_stats_get(&bld->wb, bld->mstats ? &bld->mstats->ms_vblk_write : NULL);
+    if (ev(err))
+        return err;
+
     /* Transfer ownership of blk_list and the mblocks in
      * the blk_list to caller  */
     *vblks = bld->vblk_list;
@@ -3,9 +3,30 @@
  * SPDX-FileCopyrightText: Copyright 2020 Micron Technology, Inc.
  */
 
+#include "build_config.h"
+
 #include <hse/ikvdb/vcomp_params.h>
 #include <hse/util/compression_lz4.h>
+#include <hse/util/compression_zstd.h>
+#include <hse/util/event_counter.h>
 
 const struct compress_ops *vcomp_compress_ops[VCOMP_ALGO_COUNT] = {
-    &compress_lz4_ops,
+    [VCOMP_ALGO_LZ4] = &compress_lz4_ops,
+#ifdef HAVE_ZSTD
+    [VCOMP_ALGO_ZSTD] = &compress_zstd_ops,
+#endif
 };
+
+merr_t
+vcomp_decompress(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len)
+{
+    const struct compress_ops *cops = vcomp_compress_ops[VCOMP_ALGO_LZ4];
+
+    if (compress_zstd_frame(src, src_len)) {
+        cops = vcomp_compress_ops[VCOMP_ALGO_ZSTD];
+        if (ev(!cops))
+            return merr(ENOTSUP);
+    }
+
+    return cops->cop_decompress(src, src_len, dst, dst_capacity, dst_len);
+}
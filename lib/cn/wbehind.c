@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <string.h>
+
+#include <hse/util/assert.h>
+#include <hse/util/event_counter.h>
+
+#include "wbehind.h"
+
+static void
+wbehind_worker(struct work_struct *work)
+{
+    struct wbehind *wb = container_of(work, struct wbehind, wb_work);
+    struct wbehind_req *req;
+
+    mutex_lock(&wb->wb_lock);
+    while ((req = list_first_entry_or_null(&wb->wb_pending, struct wbehind_req, wr_link))) {
+        merr_t err = wb->wb_err;
+
+        mutex_unlock(&wb->wb_lock);
+
+        if (!err)
+            err = req->wr_fn(req);
+
+        mutex_lock(&wb->wb_lock);
+        list_del(&req->wr_link);
+        cn_merge_stats_ops_add(&wb->wb_stats, &req->wr_stats);
+        req->wr_busy = false;
+
+        if (ev(err) && !wb->wb_err)
+            wb->wb_err = err;
+
+        cv_broadcast(&wb->wb_cv);
+    }
+
+    wb->wb_running = false;
+    cv_broadcast(&wb->wb_cv);
+    mutex_unlock(&wb->wb_lock);
+}
+
+void
+wbehind_init(struct wbehind *wb, struct workqueue_struct *wq)
+{
+    wb->wb_wq = wq;
+    wb->wb_running = false;
+    wb->wb_err = 0;
+    memset(&wb->wb_stats, 0, sizeof(wb->wb_stats));
+
+    mutex_init(&wb->wb_lock);
+    cv_init(&wb->wb_cv);
+    INIT_LIST_HEAD(&wb->wb_pending);
+    INIT_WORK(&wb->wb_work, wbehind_worker);
+}
+
+void
+wbehind_fini(struct wbehind *wb)
+{
+    wbehind_drain(wb);
+
+    cv_destroy(&wb->wb_cv);
+    mutex_destroy(&wb->wb_lock);
+}
+
+merr_t
+wbehind_submit(struct wbehind *wb, struct wbehind_req *req, wbehind_fn *fn)
+{
+    merr_t err;
+
+    INVARIANT(!req->wr_busy);
+
+    req->wr_fn = fn;
+    memset(&req->wr_stats, 0, sizeof(req->wr_stats));
+
+    if (!wb->wb_wq) {
+        if (wb->wb_err)
+            return wb->wb_err;
+
+        err = fn(req);
+        cn_merge_stats_ops_add(&wb->wb_stats, &req->wr_stats);
+        if (ev(err))
+            wb->wb_err = err;
+
+        return err;
+    }
+
+    mutex_lock(&wb->wb_lock);
+    err = wb->wb_err;
+    if (!err) {
+        req->wr_busy = true;
+        list_add_tail(&req->wr_link, &wb->wb_pending);
+
+        if (!wb->wb_running) {
+            wb->wb_running = true;
+            queue_work(wb->wb_wq, &wb->wb_work);
+        }
+    }
+    mutex_unlock(&wb->wb_lock);
+
+    return err;
+}
+
+merr_t
+wbehind_wait(struct wbehind *wb, struct wbehind_req *req)
+{
+    merr_t err;
+
+    if (!wb->wb_wq)
+        return wb->wb_err;
+
+    mutex_lock(&wb->wb_lock);
+    while (req->wr_busy)
+        cv_wait(&wb->wb_cv, &wb->wb_lock, "wbwait");
+    err = wb->wb_err;
+    mutex_unlock(&wb->wb_lock);
+
+    return err;
+}
+
+merr_t
+wbehind_drain(struct wbehind *wb)
+{
+    merr_t err;
+
+    if (!wb->wb_wq)
+        return wb->wb_err;
+
+    mutex_lock(&wb->wb_lock);
+    while (wb->wb_running)
+        cv_wait(&wb->wb_cv, &wb->wb_lock, "wbdrain");
+    err = wb->wb_err;
+    mutex_unlock(&wb->wb_lock);
+
+    return err;
+}
+
+void
+wbehind_stats_get(struct wbehind *wb, struct cn_merge_stats_ops *stats)
+{
+    if (!stats)
+        return;
+
+    mutex_lock(&wb->wb_lock);
+    cn_merge_stats_ops_add(stats, &wb->wb_stats);
+    memset(&wb->wb_stats, 0, sizeof(wb->wb_stats));
+    mutex_unlock(&wb->wb_lock);
+}
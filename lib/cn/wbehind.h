@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_KVS_CN_WBEHIND_H
+#define HSE_KVS_CN_WBEHIND_H
+
+#include <stdbool.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/condvar.h>
+#include <hse/util/list.h>
+#include <hse/util/mutex.h>
+#include <hse/util/workqueue.h>
+
+#include "cn_metrics.h"
+
+/* Max number of write buffers a builder may have in flight.
+ */
+#define WBEHIND_QDEPTH_MAX (8)
+
+struct wbehind_req;
+
+typedef merr_t
+wbehind_fn(struct wbehind_req *req);
+
+/**
+ * struct wbehind_req - a write-behind request
+ * @wr_link: pending list linkage
+ * @wr_fn:   function that performs the write
+ * @wr_busy:  true while the request is queued or in progress
+ * @wr_stats: write stats, updated only by @wr_fn
+ *
+ * Embed in a caller defined structure that describes the write.
+ */
+struct wbehind_req {
+    struct list_head wr_link;
+    wbehind_fn *wr_fn;
+    bool wr_busy;
+    struct cn_merge_stats_ops wr_stats;
+};
+
+/**
+ * struct wbehind - ordered write-behind queue
+ * @wb_wq:      workqueue on which writes are performed (NULL for synchronous writes)
+ * @wb_lock:    protects the fields below
+ * @wb_cv:      signaled when a request completes
+ * @wb_pending: requests that have not yet completed, in submission order
+ * @wb_running: true if wb_work is queued or running
+ * @wb_err:     first error encountered by a write
+ * @wb_stats:   stats of completed writes not yet collected by wbehind_stats_get()
+ * @wb_work:    drains wb_pending
+ *
+ * A write-behind queue lets an mblock builder hand off a full write buffer and
+ * continue to fill another while the write is in progress.  Requests are
+ * performed one at a time in submission order, as required for mblock writes.
+ * Once a write fails, all subsequent writes are skipped and the error is
+ * returned by all subsequent calls.
+ *
+ * Write stats are gathered per request and accumulated under wb_lock, the
+ * builder collects them from its own thread via wbehind_stats_get() so that
+ * its merge stats are never updated concurrently.
+ */
+struct wbehind {
+    struct workqueue_struct *wb_wq;
+    struct mutex wb_lock;
+    struct cv wb_cv;
+    struct list_head wb_pending;
+    bool wb_running;
+    merr_t wb_err;
+    struct cn_merge_stats_ops wb_stats;
+    struct work_struct wb_work;
+};
+
+void
+wbehind_init(struct wbehind *wb, struct workqueue_struct *wq);
+
+/**
+ * wbehind_fini() - wait for all requests to complete and release resources
+ */
+void
+wbehind_fini(struct wbehind *wb);
+
+/**
+ * wbehind_submit() - queue a write request
+ *
+ * Return: the error of a previous write, in which case @req is not queued
+ */
+merr_t
+wbehind_submit(struct wbehind *wb, struct wbehind_req *req, wbehind_fn *fn);
+
+/**
+ * wbehind_wait() - wait for a request to complete
+ *
+ * Return: the error of any write submitted so far that has completed
+ */
+merr_t
+wbehind_wait(struct wbehind *wb, struct wbehind_req *req);
+
+/**
+ * wbehind_drain() - wait for all requests to complete
+ */
+merr_t
+wbehind_drain(struct wbehind *wb);
+
+/**
+ * wbehind_stats_get() - collect the stats of the writes completed so far
+ * @stats: stats to which the write stats are added (may be NULL)
+ *
+ * Each completed write is accounted for exactly once.
+ */
+void
+wbehind_stats_get(struct wbehind *wb, struct cn_merge_stats_ops *stats);
+
+#endif
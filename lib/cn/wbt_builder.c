@@ -12,6 +12,7 @@
 #include <hse/util/alloc.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/key_util.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
@@ -39,6 +40,7 @@
  * @cnode_key_stage_base: staging buffer base address
  * @cnode_key_stage_end:  staging buffer end address
  * @cnode_nkeys: number of keys (aka, entries) in current node
+ * @cnode_head_off: staging offset of the restart key of the current group
  * @entries: total number of keys stored so far
  * @wbt_first_kobj: first key (aka, min key in wb tree)
  * @wbt_last_kobj: last key (aka, max key in wb tree)
@@ -48,6 +50,11 @@
  *   @max_pages tracks the max number of pages that can be used by the wbtree.
  *   It decreases over time as keys are added to leave space for bloom filters.
  *   Each call to the wbtree builder provides an updated value for @max_pgc.
+ *
+ *   Leaf keys are front coded: every WBT_LFE_RESTART_INTERVAL'th key of a
+ *   node is a restart key and is stored whole, every other key stores only
+ *   what follows the prefix it shares with its group's restart key.  Only
+ *   the restart keys have hints.
  */
 struct wbb {
     void *nodev;
@@ -69,7 +76,7 @@ struct wbb {
     uint32_t cnode_kmd_off;
     uint64_t cnode_kvlen;
     uint16_t cnode_nkeys;
-    uint16_t cnode_pfx_len;
+    uint cnode_head_off;
     uint cnode_sumlen;
     uint cnode_key_stage_pgc;
     uint cnode_key_extra_cnt;
@@ -92,6 +99,7 @@ struct wbb {
 struct key_stage_entry_leaf {
     uint32_t kmd_off;
     uint16_t klen;
+    uint16_t shared;
     uint8_t kdata[] HSE_ALIGNED(4);
 };
 
@@ -138,7 +146,7 @@ _new_node(struct wbb *wbb)
 {
     wbb->cnode = wbb->nodev + wbb->lnodec * PAGE_SIZE;
     wbb->cnode_key_cursor = wbb->cnode_key_stage_base;
-    wbb->cnode_pfx_len = 0;
+    wbb->cnode_head_off = 0;
     wbb->cnode_sumlen = 0;
     wbb->cnode_kmd_off = get_kmd_len(wbb);
     wbb->cnode_nkeys = 0;
@@ -178,37 +186,24 @@ _new_leaf_node(struct wbb *wbb, struct key_obj *right_edge)
 }
 
 /**
- * wbb_lcp_len() - Compute lcp of ko and keys currently in the staging area
+ * wbb_head_lcp() - Compute lcp of ko and the restart key of the current group
  * @wbb: wbtree builder
  * @ko:  new key (object) being added
  */
-static int
-wbb_lcp_len(struct wbb *wbb, const struct key_obj *ko)
+static uint
+wbb_head_lcp(struct wbb *wbb, const struct key_obj *ko)
 {
-    uint new_pfx_len, old_pfx_len;
-
-    if (wbb->cnode_nkeys == 0)
-        return key_obj_len(ko);
-
-    old_pfx_len = wbb->cnode_pfx_len;
+    const struct key_stage_entry_leaf *head = wbb->cnode_key_stage_base + wbb->cnode_head_off;
+    uint lcp;
 
-    if (old_pfx_len < 1)
-        return 0;
+    lcp = memlcp(head->kdata, ko->ko_pfx, min_t(uint, head->klen, ko->ko_pfx_len));
+    if (lcp == ko->ko_pfx_len) {
+        uint cmplen = min_t(uint, head->klen - lcp, ko->ko_sfx_len);
 
-    if (old_pfx_len < ko->ko_pfx_len)
-        return memlcp(wbb->cnode_first_key, ko->ko_pfx, old_pfx_len);
-
-    /* old_pfx_len >= ko->ko_pfx_len */
-    new_pfx_len = memlcp(wbb->cnode_first_key, ko->ko_pfx, ko->ko_pfx_len);
-    if (new_pfx_len == ko->ko_pfx_len) {
-        void *p = wbb->cnode_first_key + new_pfx_len;
-        uint cmplen = old_pfx_len - new_pfx_len;
-
-        assert(old_pfx_len >= new_pfx_len);
-        new_pfx_len += memlcp(p, ko->ko_sfx, cmplen);
+        lcp += memlcp(head->kdata + lcp, ko->ko_sfx, cmplen);
     }
 
-    return new_pfx_len;
+    return lcp;
 }
 
 static merr_t
@@ -257,45 +252,65 @@ wbb_entries(const struct wbb *wbb)
     return wbb->entries + wbb->cnode_nkeys;
 }
 
-/* Close out the node - Write out node_hdr, prefix, LFEs and key suffixes.
+void
+wbb_last_entry(const struct wbb *wbb, uint *node, uint *slot)
+{
+    assert(wbb->lnodec > 0 && wbb->cnode_nkeys > 0);
+
+    *node = wbb->lnodec - 1;
+    *slot = wbb->cnode_nkeys - 1;
+}
+
+/* Close out the node - Write out node_hdr, LFEs, restart key hints and front
+ * coded keys.
  */
 static void
 wbt_leaf_publish(struct wbb *wbb)
 {
     struct wbt_node_hdr_omf *node_hdr = wbb->cnode;
 
-    size_t pfx_len = wbb->cnode_pfx_len;
     struct wbt_lfe_omf *entry; /* (out) current key entry ptr */
+    void *hintv;               /* (out) restart key hint array */
     void *sfxp;                /* (out) current suffix ptr */
+    void *head = NULL;         /* current restart key */
+    uint hintc;
     int i;
 
     struct key_stage_entry_leaf *kin = wbb->cnode_key_stage_base;
 
+    static_assert(
+        !(WBT_LFE_RESTART_INTERVAL & (WBT_LFE_RESTART_INTERVAL - 1)),
+        "restart interval must be a power of two");
+
     wbb->cnode_kvlen += WBT_NODE_SIZE;
 
     omf_set_wbn_num_keys(node_hdr, wbb->cnode_nkeys);
-    omf_set_wbn_pfx_len(node_hdr, pfx_len);
+    omf_set_wbn_pfx_len(node_hdr, 0);
+    omf_set_wbn_restart(node_hdr, WBT_LFE_RESTART_INTERVAL);
     omf_set_wbn_kvlen(node_hdr, wbb->cnode_kvlen);
 
     wbb->total_kvlen += wbb->cnode_kvlen;
 
-    /* Use the first key to write out the prefix. */
-    if (pfx_len) {
-        void *pfxp = wbb->cnode + sizeof(*node_hdr);
-
-        assert(pfx_len <= kin->klen);
-        memcpy(pfxp, kin->kdata, pfx_len);
-    }
-
-    entry = wbb->cnode + sizeof(*node_hdr) + pfx_len;
+    entry = wbb->cnode + sizeof(*node_hdr);
+    hintv = entry + wbb->cnode_nkeys;
+    hintc = (wbb->cnode_nkeys + WBT_LFE_RESTART_INTERVAL - 1) / WBT_LFE_RESTART_INTERVAL;
     sfxp = wbb->cnode + PAGE_SIZE;
 
     for (i = 0; i < wbb->cnode_nkeys; i++) {
-        uint16_t sfx_len = kin->klen - pfx_len;
+        uint16_t sfx_len = kin->klen - kin->shared;
         uint key_extra = kin->kmd_off < UINT16_MAX ? 0 : 4;
+        uint shared_sz = 0;
+
+        if (i % WBT_LFE_RESTART_INTERVAL) {
+            shared_sz = sizeof(struct wbt_lfe_shared_omf);
+        } else {
+            assert(kin->shared == 0);
+            wbt_node_hint_set(
+                hintv, i / WBT_LFE_RESTART_INTERVAL, wbt_key_hint(kin->kdata, kin->klen));
+        }
 
-        sfxp -= sfx_len + key_extra;
-        assert((void *)entry < sfxp);
+        sfxp -= key_extra + shared_sz + sfx_len;
+        assert(hintv + hintc * WBT_NODE_HINT_SIZE <= sfxp);
 
         if (key_extra) {
             uint32_t kmd_off_omf;
@@ -314,16 +329,21 @@ wbt_leaf_publish(struct wbb *wbb)
         assert((void *)kin >= wbb->cnode_key_stage_base);
         assert((void *)kin < wbb->cnode_key_stage_end);
 
-        memcpy(sfxp + key_extra, kin->kdata + pfx_len, sfx_len);
+        if (shared_sz)
+            omf_set_lfs_shared(sfxp + key_extra, kin->shared);
+        else
+            head = sfxp + key_extra;
+
+        memcpy(sfxp + key_extra + shared_sz, kin->kdata + kin->shared, sfx_len);
         omf_set_lfe_koff(entry, sfxp - wbb->cnode);
 
         /* Store last key. */
-        wbb->wbt_last_kobj.ko_pfx = wbb->cnode + sizeof(*node_hdr);
-        wbb->wbt_last_kobj.ko_pfx_len = pfx_len;
-        wbb->wbt_last_kobj.ko_sfx = sfxp + key_extra;
+        wbb->wbt_last_kobj.ko_pfx = head;
+        wbb->wbt_last_kobj.ko_pfx_len = kin->shared;
+        wbb->wbt_last_kobj.ko_sfx = sfxp + key_extra + shared_sz;
         wbb->wbt_last_kobj.ko_sfx_len = sfx_len;
 
-        assert(pfx_len + sfx_len <= HSE_KVS_KEY_LEN_MAX);
+        assert(kin->klen <= HSE_KVS_KEY_LEN_MAX);
 
         /* Store first key. */
         if (!wbb->entries)
@@ -353,8 +373,8 @@ wbb_add_entry(
     uint key_extra;
     size_t space, encoded_cnt_len;
     char encoded_cnt[4]; /* large enough to hold kmd encoded count */
-    size_t new_pfx_len;
     uint klen = key_obj_len(kobj);
+    uint shared = 0;
 
     struct key_stage_entry_leaf *kst_leaf;
 
@@ -365,11 +385,12 @@ wbb_add_entry(
         return merr(ev(EBUG));
     }
 
-    /* Track longest pfx_len here because we need the length to calculate
-     * total space consumed so far in the node.
+    /* Keys other than restart keys store only what follows the prefix they
+     * share with their restart key, preceded by the shared length.
      */
-    new_pfx_len = wbb_lcp_len(wbb, kobj);
-    assert(new_pfx_len <= klen);
+    if (wbb->cnode_nkeys % WBT_LFE_RESTART_INTERVAL)
+        shared = wbb_head_lcp(wbb, kobj);
+    assert(shared <= klen);
 
     /* entry_kmd_off will be saved in the "lfe" for this key */
     entry_kmd_off = get_kmd_len(wbb);
@@ -398,12 +419,15 @@ wbb_add_entry(
     if (ev(err))
         return err;
 
-    wbb->cnode_sumlen += klen;
+    wbb->cnode_sumlen += klen - shared;
+    if (wbb->cnode_nkeys % WBT_LFE_RESTART_INTERVAL)
+        wbb->cnode_sumlen += sizeof(struct wbt_lfe_shared_omf);
 
     /* Create a new node if space exceeds PAGE_SIZE */
-    space = sizeof(struct wbt_node_hdr_omf) + new_pfx_len +
+    space = sizeof(struct wbt_node_hdr_omf) +
         ((wbb->cnode_nkeys + 1) * sizeof(struct wbt_lfe_omf)) + wbb->cnode_sumlen +
-        (sizeof(uint32_t) * wbb->cnode_key_extra_cnt) - ((wbb->cnode_nkeys + 1) * new_pfx_len);
+        (sizeof(uint32_t) * wbb->cnode_key_extra_cnt) +
+        ((wbb->cnode_nkeys / WBT_LFE_RESTART_INTERVAL + 1) * WBT_NODE_HINT_SIZE);
 
     if (space > PAGE_SIZE) {
         /* close out current node */
@@ -423,15 +447,12 @@ wbb_add_entry(
         assert(wbb->cnode_nkeys == 0);
         assert(wbb->cnode_sumlen == 0);
 
-        wbb->cnode_pfx_len = klen;
+        /* The key is the first restart key of the new node. */
         wbb->cnode_sumlen += klen;
+        shared = 0;
         key_extra = 0; /* reset key_extra */
-    } else {
-        wbb->cnode_pfx_len = new_pfx_len;
     }
 
-    assert(new_pfx_len <= wbb->cnode_pfx_len);
-
     /* Copy kmd into iovec. Should not fail b/c space has been reserved. */
     if (wbb_kmd_append(wbb, encoded_cnt, encoded_cnt_len, true) ||
         wbb_kmd_append(wbb, key_kmd, key_kmd_len, true))
@@ -486,6 +507,7 @@ wbb_add_entry(
     kst_leaf = wbb->cnode_key_cursor;
     kst_leaf->kmd_off = entry_kmd_off;
     kst_leaf->klen = klen;
+    kst_leaf->shared = shared;
 
     if (kobj->ko_pfx)
         memcpy(kst_leaf->kdata, kobj->ko_pfx, kobj->ko_pfx_len);
@@ -499,6 +521,9 @@ wbb_add_entry(
         wbb->cnode_first_klen = klen;
     }
 
+    if (wbb->cnode_nkeys % WBT_LFE_RESTART_INTERVAL == 0)
+        wbb->cnode_head_off = (void *)kst_leaf - wbb->cnode_key_stage_base;
+
     wbb->cnode_last_key = kst_leaf->kdata;
     wbb->cnode_last_klen = klen;
 
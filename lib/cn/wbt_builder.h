@@ -49,6 +49,11 @@ wbb_destroy(struct wbb *wbb);
 uint
 wbb_entries(const struct wbb *wbb);
 
+/* Get the leaf node and the slot within it of the most recently added key.
+ */
+void
+wbb_last_entry(const struct wbb *wbb, uint *node, uint *slot);
+
 /* Get the current "kvlen" of a finalized wbtree.
  */
 uint64_t
@@ -6,12 +6,16 @@
 #ifndef HSE_KVS_CN_WBT_INTERNAL_H
 #define HSE_KVS_CN_WBT_INTERNAL_H
 
+#include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <sys/types.h>
 
 #include <hse/util/byteorder.h>
 #include <hse/util/compiler.h>
+#include <hse/util/keycmp.h>
 
 #include "kvs_mblk_desc.h"
 #include "omf.h"
@@ -31,6 +35,40 @@ wbt_node_pfx(const struct wbt_node_hdr_omf *node, const void **pfx, uint *pfx_le
     *pfx = (void *)node + sizeof(*node);
 }
 
+/* Return true if the keys of a leaf node are front coded (v8).
+ */
+static HSE_ALWAYS_INLINE bool
+wbt_lfe_front_coded(const struct wbt_node_hdr_omf *node)
+{
+    return omf_wbn_restart(node) > 0;
+}
+
+/* Return true if a leaf entry of a front coded node stores its shared prefix
+ * length, i.e., if the entry is not a restart key.
+ */
+static HSE_ALWAYS_INLINE bool
+wbt_lfe_has_shared(const struct wbt_node_hdr_omf *node, const struct wbt_lfe_omf *lfe)
+{
+    uint restart = omf_wbn_restart(node);
+
+    assert(!(restart & (restart - 1)));
+
+    return restart && ((lfe - wbt_lfe(node, 0)) & (restart - 1));
+}
+
+/* Return the start of the data of a leaf entry, i.e., what follows the
+ * inline kmd offset, if any.
+ */
+static HSE_ALWAYS_INLINE const void *
+wbt_lfe_data(const struct wbt_node_hdr_omf *node, const struct wbt_lfe_omf *lfe)
+{
+    /* Add 4 if lfe_kmd == UINT16_MAX, else add 0. */
+    return (void *)node + omf_lfe_koff(lfe) + 4 * (omf_lfe_kmd(lfe) == UINT16_MAX);
+}
+
+/* Return the key suffix stored by a leaf entry, which follows the node prefix
+ * or, if the node is front coded, the prefix shared with the restart key.
+ */
 static HSE_ALWAYS_INLINE void
 wbt_lfe_key(
     const struct wbt_node_hdr_omf *node,
@@ -38,19 +76,112 @@ wbt_lfe_key(
     const void **kdata,
     uint *klen)
 {
-    uint start, end;
+    const void *start;
+    uint end;
 
-    /* Add 4 if lfe_kmd == UINT16_MAX, else add 0. */
-    start = omf_lfe_koff(lfe) + 4 * (omf_lfe_kmd(lfe) == UINT16_MAX);
+    start = wbt_lfe_data(node, lfe);
+    if (wbt_lfe_has_shared(node, lfe))
+        start += sizeof(struct wbt_lfe_shared_omf);
 
     /* prefetch key data */
-    __builtin_prefetch((void *)node + start);
+    __builtin_prefetch(start);
 
     /* end == one byte past end of key. */
     end = (lfe == wbt_lfe(node, 0) ? WBT_NODE_SIZE : omf_lfe_koff(lfe - 1));
 
-    *klen = end - start;
-    *kdata = (void *)node + start;
+    *klen = end - (start - (void *)node);
+    *kdata = start;
+}
+
+/* Return the part of a leaf entry's key that precedes wbt_lfe_key(), which
+ * is either the node prefix or a prefix of the entry's restart key.
+ */
+static HSE_ALWAYS_INLINE void
+wbt_lfe_pfx(
+    const struct wbt_node_hdr_omf *node,
+    const struct wbt_lfe_omf *lfe,
+    const void **pfx,
+    uint *pfx_len)
+{
+    const struct wbt_lfe_omf *head;
+    uint restart, nth;
+
+    if (!wbt_lfe_front_coded(node)) {
+        wbt_node_pfx(node, pfx, pfx_len);
+        return;
+    }
+
+    restart = omf_wbn_restart(node);
+    nth = lfe - wbt_lfe(node, 0);
+    head = wbt_lfe(node, nth & ~(restart - 1));
+
+    *pfx = wbt_lfe_data(node, head);
+    *pfx_len = (head == lfe) ? 0 : omf_lfs_shared(wbt_lfe_data(node, lfe));
+}
+
+/* Compare a key, less the node prefix, with the key of a leaf entry.
+ */
+static HSE_ALWAYS_INLINE int
+wbt_lfe_keycmp(
+    const struct wbt_node_hdr_omf *node,
+    const struct wbt_lfe_omf *lfe,
+    const void *key,
+    uint klen)
+{
+    const void *kdata;
+    uint kdlen;
+
+    if (wbt_lfe_has_shared(node, lfe)) {
+        const void *pfx;
+        uint pfx_len;
+        int rc;
+
+        wbt_lfe_pfx(node, lfe, &pfx, &pfx_len);
+
+        rc = memcmp(key, pfx, klen < pfx_len ? klen : pfx_len);
+        if (rc || klen < pfx_len)
+            return rc ? rc : -1;
+
+        key += pfx_len;
+        klen -= pfx_len;
+    }
+
+    wbt_lfe_key(node, lfe, &kdata, &kdlen);
+
+    return keycmp(key, klen, kdata, kdlen);
+}
+
+/* As keycmp_prefix() of a prefix, less the node prefix, and the key of a leaf
+ * entry.
+ */
+static HSE_ALWAYS_INLINE int
+wbt_lfe_keycmp_prefix(
+    const struct wbt_node_hdr_omf *node,
+    const struct wbt_lfe_omf *lfe,
+    const void *pfx,
+    uint pfxlen)
+{
+    const void *kdata;
+    uint kdlen;
+
+    if (wbt_lfe_has_shared(node, lfe)) {
+        const void *kpfx;
+        uint kpfx_len;
+        int rc;
+
+        wbt_lfe_pfx(node, lfe, &kpfx, &kpfx_len);
+
+        rc = memcmp(pfx, kpfx, pfxlen < kpfx_len ? pfxlen : kpfx_len);
+        if (rc || pfxlen <= kpfx_len)
+            return rc;
+
+        pfx += kpfx_len;
+        pfxlen -= kpfx_len;
+    }
+
+    wbt_lfe_key(node, lfe, &kdata, &kdlen);
+
+    return keycmp_prefix(pfx, pfxlen, kdata, kdlen);
 }
 
 static HSE_ALWAYS_INLINE uint32_t
@@ -94,4 +225,51 @@ wbt_ine_key(
     *klen = end - start;
 }
 
+/* Return the hint array of a v7 node, which follows its entries.  Front coded
+ * leaf nodes have hints for their restart keys only.
+ */
+static HSE_ALWAYS_INLINE const void *
+wbt_node_hints(const struct wbt_node_hdr_omf *node)
+{
+    uint nkeys = omf_wbn_num_keys(node);
+
+    if (omf_wbn_magic(node) == WBT_INE_NODE_MAGIC)
+        return wbt_ine(node, nkeys + 1); /* skip the right edge */
+
+    return wbt_lfe(node, nkeys);
+}
+
+static HSE_ALWAYS_INLINE uint32_t
+wbt_node_hint(const void *hintv, uint nth)
+{
+    uint32_t hint;
+
+    memcpy(&hint, hintv + nth * WBT_NODE_HINT_SIZE, sizeof(hint));
+
+    return omf32_to_cpu(hint);
+}
+
+static HSE_ALWAYS_INLINE void
+wbt_node_hint_set(void *hintv, uint nth, uint32_t hint)
+{
+    hint = cpu_to_omf32(hint);
+    memcpy(hintv + nth * WBT_NODE_HINT_SIZE, &hint, sizeof(hint));
+}
+
+/* Compute the hint of a key suffix.
+ */
+static HSE_ALWAYS_INLINE uint32_t
+wbt_key_hint(const void *sfx, uint sfx_len)
+{
+    uint8_t buf[WBT_NODE_HINT_SIZE] = { 0 };
+    uint32_t hint;
+
+    static_assert(sizeof(hint) == WBT_NODE_HINT_SIZE, "hint size mismatch");
+
+    memcpy(buf, sfx, sfx_len < sizeof(buf) ? sfx_len : sizeof(buf));
+    memcpy(&hint, buf, sizeof(hint));
+
+    return be32_to_cpu(hint);
+}
+
 #endif /* HSE_KVS_CN_WBT_INTERNAL_H */
@@ -17,6 +17,7 @@
 #include <hse/util/compiler.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/keycmp.h>
+#include <hse/util/log2.h>
 #include <hse/util/page.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
@@ -84,6 +85,11 @@ wbt_read_kmd_vref(
         vref->vi.vr_data = vdata;
         vref->vi.vr_len = vlen;
         break;
+    case VTYPE_MOPND:
+        kmd_mopnd(kmd, off, &vdata, &vlen);
+        vref->vi.vr_data = vdata;
+        vref->vi.vr_len = vlen;
+        break;
     case VTYPE_ZVAL:
     case VTYPE_TOMB:
     case VTYPE_PTOMB:
@@ -117,6 +123,197 @@ wbti_get_page(struct wbti *self, uint32_t node_idx)
     self->node_idx = node_idx;
 }
 
+typedef void
+wbt_hint_search_fn(const void *hintv, uint hintc, uint32_t hint, int *first, int *last);
+
+/* Narrow the search of a node to the entries whose hints equal the hint of the
+ * search key, i.e., set *first to the number of hints less than @hint and *last
+ * to one less than the number of hints less than or equal to @hint.
+ */
+static void
+wbt_hint_search_scalar(const void *hintv, uint hintc, uint32_t hint, int *first, int *last)
+{
+    uint lo = 0, hi = hintc;
+
+    while (lo < hi) {
+        uint j = (lo + hi) / 2;
+
+        if (wbt_node_hint(hintv, j) < hint)
+            lo = j + 1;
+        else
+            hi = j;
+    }
+
+    *first = lo;
+
+    hi = hintc;
+    while (lo < hi) {
+        uint j = (lo + hi) / 2;
+
+        if (wbt_node_hint(hintv, j) <= hint)
+            lo = j + 1;
+        else
+            hi = j;
+    }
+
+    *last = lo - 1;
+}
+
+#if __amd64__
+
+/* Compare eight hints at a time, stopping at the first group that contains a
+ * hint greater than the search hint (the hints being in ascending order).
+ * The hints are biased so as to make use of the signed compare.
+ */
+__attribute__((__target__("avx2"))) static void
+wbt_hint_search_avx2(const void *hintv, uint hintc, uint32_t hint, int *first, int *last)
+{
+    const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+    const __m256i key = _mm256_set1_epi32(hint ^ 0x80000000u);
+    uint lt = 0, le = 0, i;
+
+    for (i = 0; i + 8 <= hintc; i += 8) {
+        __m256i v;
+        uint gt;
+
+        v = _mm256_xor_si256(_mm256_loadu_si256(hintv + i * WBT_NODE_HINT_SIZE), bias);
+
+        lt += __builtin_popcount(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(key, v))));
+        gt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, key)));
+        le += 8 - __builtin_popcount(gt);
+
+        if (gt)
+            goto out;
+    }
+
+    for (; i < hintc; ++i) {
+        uint32_t h = wbt_node_hint(hintv, i);
+
+        if (h > hint)
+            break;
+
+        lt += (h < hint);
+        le++;
+    }
+
+out:
+    *first = lt;
+    *last = le - 1;
+}
+
+#endif
+
+static wbt_hint_search_fn wbt_hint_search_resolve;
+
+/* Resolved on first use to the best implementation supported by the cpu.
+ */
+static wbt_hint_search_fn *wbt_hint_search_impl HSE_READ_MOSTLY = wbt_hint_search_resolve;
+
+static void
+wbt_hint_search_resolve(const void *hintv, uint hintc, uint32_t hint, int *first, int *last)
+{
+    wbt_hint_search_fn *fn = wbt_hint_search_scalar;
+
+#if __amd64__
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        fn = wbt_hint_search_avx2;
+#endif
+
+    wbt_hint_search_impl = fn;
+
+    fn(hintv, hintc, hint, first, last);
+}
+
+/* Narrow the binary search [*first, *last] over the entire node to the entries
+ * that cannot be ordered by their hints alone (v7 and later).
+ */
+static HSE_ALWAYS_INLINE void
+wbtr_hint_narrow(
+    const struct wbt_desc *wbd,
+    const struct wbt_node_hdr_omf *node,
+    const void *sfx,
+    uint sfx_len,
+    int *first,
+    int *last)
+{
+    assert(*first == 0);
+
+    if (wbd->wbd_version < WBT_TREE_VERSION7 || *last < 0)
+        return;
+
+    wbt_hint_search_impl(wbt_node_hints(node), *last + 1, wbt_key_hint(sfx, sfx_len), first, last);
+}
+
+/* Narrow the binary search [*first, *last] over a front coded leaf node to
+ * the keys following the greatest restart key less than or equal to the
+ * search key.  The restart keys, which are stored whole, are first narrowed
+ * by their hints and then compared.
+ */
+static HSE_ALWAYS_INLINE void
+wbtr_restart_narrow(
+    const struct wbt_node_hdr_omf *node,
+    const void *key,
+    uint klen,
+    int *first,
+    int *last)
+{
+    const int restart = omf_wbn_restart(node);
+    const int shift = ilog2(restart);
+    int lo, hi;
+
+    assert(*first == 0);
+
+    wbt_hint_search_impl(
+        wbt_node_hints(node), (*last >> shift) + 1, wbt_key_hint(key, klen), &lo, &hi);
+
+    while (lo <= hi) {
+        int j = (lo + hi) / 2;
+        int cmp;
+
+        cmp = wbt_lfe_keycmp(node, wbt_lfe(node, j << shift), key, klen);
+        if (cmp < 0) {
+            hi = j - 1;
+        } else if (cmp > 0) {
+            lo = j + 1;
+        } else {
+            *first = *last = j << shift;
+            return;
+        }
+    }
+
+    if (hi < 0) {
+        *last = -1;
+        return;
+    }
+
+    *first = (hi << shift) + 1;
+    *last = min_t(int, *last, (hi << shift) + restart - 1);
+}
+
+/* Narrow the binary search [*first, *last] over a leaf node by the means its
+ * version affords.
+ */
+static HSE_ALWAYS_INLINE void
+wbtr_lfe_narrow(
+    const struct wbt_desc *wbd,
+    const struct wbt_node_hdr_omf *node,
+    const void *sfx,
+    uint sfx_len,
+    int *first,
+    int *last)
+{
+    if (wbt_lfe_front_coded(node)) {
+        if (*last >= 0)
+            wbtr_restart_narrow(node, sfx, sfx_len, first, last);
+        return;
+    }
+
+    wbtr_hint_narrow(wbd, node, sfx, sfx_len, first, last);
+}
+
 static int
 wbtr_seek_page(
     const void *base,
@@ -171,6 +368,8 @@ wbtr_seek_page(
             goto navigate;
         }
 
+        wbtr_hint_narrow(wbd, node, kt_data + cmplen, kt_len - cmplen, &first, &last);
+
         /* prefetch first node in binary search */
         __builtin_prefetch(wbt_ine(node, (first + last) / 2));
 
@@ -272,8 +471,8 @@ wbti_seek_fwd(struct wbti *self, struct kvs_ktuple *kt)
     int j, cmp, node_num;
     int first, last, lfe_eof;
     size_t pg;
-    const void *kdata, *kt_data;
-    uint klen, kt_len, cmplen;
+    const void *kt_data;
+    uint kt_len, cmplen;
     const struct wbt_lfe_omf *lfe;
     struct wbt_desc *wbd = self->wbd;
 
@@ -327,15 +526,16 @@ wbti_seek_fwd(struct wbti *self, struct kvs_ktuple *kt)
     if (!sfx_search)
         goto skip_search;
 
+    wbtr_lfe_narrow(wbd, node, kt_data, kt_len, &first, &last);
+
     /* prefetch first node in binary search */
     __builtin_prefetch(wbt_lfe(node, (first + last) / 2));
 
     while (first <= last) {
         j = (first + last) / 2;
         lfe = wbt_lfe(node, j);
-        wbt_lfe_key(node, lfe, &kdata, &klen);
 
-        cmp = keycmp(kt_data, kt_len, kdata, klen);
+        cmp = wbt_lfe_keycmp(node, lfe, kt_data, kt_len);
         if (cmp < 0) {
             last = j - 1;
         } else if (cmp > 0) {
@@ -361,11 +561,10 @@ skip_search:
     /* It wasn't a seek, must be a cursor create.  Compare with
      * the prefix of the best match to determine if found.
      */
-    lfe = wbt_lfe(node, first);
-    wbt_lfe_key(node, lfe, &kdata, &klen);
-
     if (sfx_search) {
-        cmp = keycmp_prefix(kt_data, kt_len, kdata, klen);
+        cmp = 1; /* past the last key of the last leaf */
+        if (first <= lfe_eof)
+            cmp = wbt_lfe_keycmp_prefix(node, wbt_lfe(node, first), kt_data, kt_len);
         if (!cmp)
             self->lfe_idx = first - 1; /* found pfx key */
     }
@@ -463,8 +662,8 @@ wbti_seek_rev(struct wbti *self, struct kvs_ktuple *kt)
     int cmp, node_num;
     int first, last, lfe_eof;
     size_t pg;
-    const void *kdata, *kt_data;
-    uint klen, kt_len, cmplen;
+    const void *kt_data;
+    uint kt_len, cmplen;
     const struct wbt_lfe_omf *lfe;
     struct wbt_desc *wbd = self->wbd;
     bool create = kt->kt_len < 0;
@@ -535,6 +734,8 @@ repeat:
     if (!sfx_search)
         goto skip_search;
 
+    wbtr_lfe_narrow(wbd, node, kt_data, kt_len, &first, &last);
+
     /* prefetch first node in binary search */
     __builtin_prefetch(wbt_lfe(node, (first + last) / 2));
 
@@ -542,9 +743,8 @@ repeat:
         int j = (first + last) / 2;
 
         lfe = wbt_lfe(node, j);
-        wbt_lfe_key(node, lfe, &kdata, &klen);
 
-        cmp = keycmp(kt_data, kt_len, kdata, klen);
+        cmp = wbt_lfe_keycmp(node, lfe, kt_data, kt_len);
         if (cmp < 0) {
             last = j - 1;
         } else if (cmp > 0) {
@@ -584,15 +784,13 @@ skip_search:
     /* It wasn't a seek, must be a cursor create.  Compare with
      * the prefix of the best match to determine if found.
      */
-
-    lfe = wbt_lfe(node, last);
-    wbt_lfe_key(node, lfe, &kdata, &klen);
-
     if (sfx_search) {
         kt_data = kt->kt_data + node_pfx_len;
         kt_len = abs(kt->kt_len) - node_pfx_len;
 
-        cmp = keycmp_prefix(kt_data, kt_len, kdata, klen);
+        cmp = -1; /* before the first key of the first leaf */
+        if (last >= 0)
+            cmp = wbt_lfe_keycmp_prefix(node, wbt_lfe(node, last), kt_data, kt_len);
         if (!cmp)
             self->lfe_idx = last + 1; /* found pfx key */
     }
@@ -745,6 +943,51 @@ wbti_reset(
     }
 }
 
+/* Find the newest value of a leaf entry visible at seq.
+ */
+static void
+wbtr_read_lfe_vref(
+    const void *base,
+    const struct wbt_desc *wbd,
+    const struct wbt_node_hdr_omf *node,
+    const struct wbt_lfe_omf *lfe,
+    uint64_t seq,
+    enum key_lookup_res *lookup_res,
+    struct vgmap *vgmap,
+    struct kvs_vtuple_ref *vref)
+{
+    const void *kmd;
+    size_t off;
+    uint64_t vseq;
+    uint nvals;
+
+    kmd = base + PAGE_SIZE * (wbd->wbd_first_page + wbd->wbd_root + 1);
+
+    off = wbt_lfe_kmd(node, lfe);
+    assert(off < wbd->wbd_kmd_pgc * PAGE_SIZE);
+    nvals = kmd_count(kmd, &off);
+    assert(nvals > 0);
+    while (nvals--) {
+        wbt_read_kmd_vref(kmd, vgmap, &off, &vseq, vref);
+        assert(off <= wbd->wbd_kmd_pgc * PAGE_SIZE);
+        if (seq >= vseq) {
+            vref->vr_seq = vseq;
+            if (vref->vr_type == VTYPE_TOMB)
+                *lookup_res = FOUND_TMB;
+            else if (vref->vr_type == VTYPE_PTOMB)
+                *lookup_res = FOUND_PTMB;
+            else if (vref->vr_type == VTYPE_MOPND)
+                *lookup_res = FOUND_MOPND;
+            else
+                *lookup_res = FOUND_VAL;
+
+            return;
+        }
+    }
+
+    *lookup_res = NOT_FOUND;
+}
+
 merr_t
 wbtr_read_vref(
     const void *base,
@@ -759,8 +1002,8 @@ wbtr_read_vref(
     int j, cmp, node_num;
     int first, last;
     size_t pg;
-    const void *kdata, *kt_data;
-    uint klen, kt_len;
+    const void *kt_data;
+    uint kt_len;
     const struct wbt_lfe_omf *lfe;
 
     const void *node_pfx;
@@ -796,51 +1039,27 @@ wbtr_read_vref(
     if (cmp)
         goto done; /* prefix didn't match; key not found */
 
-    /* prefetch first node in binary search */
-    __builtin_prefetch(wbt_lfe(node, (first + last) / 2));
-
     kt_data += node_pfx_len;
     kt_len -= node_pfx_len;
 
+    wbtr_lfe_narrow(wbd, node, kt_data, kt_len, &first, &last);
+
+    /* prefetch first node in binary search */
+    __builtin_prefetch(wbt_lfe(node, (first + last) / 2));
+
     while (first <= last) {
         j = (first + last) / 2;
         lfe = wbt_lfe(node, j);
-        wbt_lfe_key(node, lfe, &kdata, &klen); /* sfx */
 
-        cmp = keycmp(kt_data, kt_len, kdata, klen);
+        cmp = wbt_lfe_keycmp(node, lfe, kt_data, kt_len);
         if (cmp < 0)
             last = j - 1;
         else if (cmp > 0)
             first = j + 1;
         else {
             /* Found key */
-            const void *kmd;
-            size_t off;
-            uint64_t vseq;
-            uint nvals;
-
-            kmd = base + PAGE_SIZE * (wbd->wbd_first_page + wbd->wbd_root + 1);
-
-            off = wbt_lfe_kmd(node, lfe);
-            assert(off < wbd->wbd_kmd_pgc * PAGE_SIZE);
-            nvals = kmd_count(kmd, &off);
-            assert(nvals > 0);
-            while (nvals--) {
-                wbt_read_kmd_vref(kmd, vgmap, &off, &vseq, vref);
-                assert(off <= wbd->wbd_kmd_pgc * PAGE_SIZE);
-                if (seq >= vseq) {
-                    vref->vr_seq = vseq;
-                    if (vref->vr_type == VTYPE_TOMB)
-                        *lookup_res = FOUND_TMB;
-                    else if (vref->vr_type == VTYPE_PTOMB)
-                        *lookup_res = FOUND_PTMB;
-                    else
-                        *lookup_res = FOUND_VAL;
-
-                    return 0;
-                }
-            }
-            break;
+            wbtr_read_lfe_vref(base, wbd, node, lfe, seq, lookup_res, vgmap, vref);
+            return 0;
         }
     }
 done:
@@ -849,10 +1068,49 @@ done:
     return 0;
 }
 
+bool
+wbtr_read_vref_at(
+    const void *base,
+    const struct wbt_desc *wbd,
+    uint node_num,
+    uint slot,
+    const struct kvs_ktuple *kt,
+    uint64_t seq,
+    enum key_lookup_res *lookup_res,
+    struct vgmap *vgmap,
+    struct kvs_vtuple_ref *vref)
+{
+    const struct wbt_node_hdr_omf *node;
+    const struct wbt_lfe_omf *lfe;
+    const void *pfx, *kdata;
+    uint pfx_len, klen;
+
+    if (ev(node_num < wbd->wbd_leaf || node_num >= wbd->wbd_leaf + wbd->wbd_leaf_cnt))
+        return false;
+
+    node = base + PAGE_SIZE * (wbd->wbd_first_page + node_num);
+    assert(omf_wbn_magic(node) == WBT_LFE_NODE_MAGIC);
+
+    if (ev(slot >= omf_wbn_num_keys(node)))
+        return false;
+
+    lfe = wbt_lfe(node, slot);
+    wbt_lfe_pfx(node, lfe, &pfx, &pfx_len);
+    wbt_lfe_key(node, lfe, &kdata, &klen);
+
+    if (kt->kt_len != pfx_len + klen || memcmp(kt->kt_data, pfx, pfx_len) ||
+        memcmp(kt->kt_data + pfx_len, kdata, klen))
+        return false;
+
+    wbtr_read_lfe_vref(base, wbd, node, lfe, seq, lookup_res, vgmap, vref);
+
+    return true;
+}
+
 void
 wbti_prefix(struct wbti *self, const void **pfx, uint *pfx_len)
 {
-    wbt_node_pfx(self->node, pfx, pfx_len);
+    wbt_lfe_pfx(self->node, wbt_lfe(self->node, self->lfe_idx), pfx, pfx_len);
 }
 
 merr_t
@@ -924,7 +1182,8 @@ wbtr_hdr_valid(const struct wbt_hdr_omf *omf)
     const uint32_t version = omf_wbt_version(omf);
     const uint32_t magic = omf_wbt_magic(omf);
 
-    return HSE_LIKELY(version == WBT_TREE_VERSION && magic == WBT_TREE_MAGIC);
+    return HSE_LIKELY(
+        version >= WBT_TREE_VERSION6 && version <= WBT_TREE_VERSION && magic == WBT_TREE_MAGIC);
 }
 
 merr_t
@@ -936,7 +1195,9 @@ wbtr_read_desc(const struct wbt_hdr_omf *wbt_hdr, struct wbt_desc *desc)
     desc->wbd_version = omf_wbt_version(wbt_hdr);
 
     switch (desc->wbd_version) {
-    case WBT_TREE_VERSION:
+    case WBT_TREE_VERSION6:
+    case WBT_TREE_VERSION7:
+    case WBT_TREE_VERSION8:
         desc->wbd_root = omf_wbt_root(wbt_hdr);
         desc->wbd_leaf = omf_wbt_leaf(wbt_hdr);
         desc->wbd_leaf_cnt = omf_wbt_leaf_cnt(wbt_hdr);
@@ -80,6 +80,33 @@ wbtr_read_vref(
     struct vgmap *vgmap,
     struct kvs_vtuple_ref *vref);
 
+/**
+ * wbtr_read_vref_at() - Read the value metadata of the key at a given leaf
+ *                       node and slot, if it is the given key
+ * @base: base address of the block
+ * @wbd: wbtree descriptor
+ * @node_num: leaf node number
+ * @slot: index of the entry within the leaf node
+ * @kt: key to match
+ * @seq: view sequence number
+ * @lookup_res: (output) as for wbtr_read_vref(), valid only if true is returned
+ * @vgmap: vgroup map to apply to vblock indexes (may be NULL)
+ * @vref: (output) value metadata if found
+ *
+ * Return: true if the entry at (@node_num, @slot) holds @kt.
+ */
+bool
+wbtr_read_vref_at(
+    const void *base,
+    const struct wbt_desc *wbd,
+    uint node_num,
+    uint slot,
+    const struct kvs_ktuple *kt,
+    uint64_t seq,
+    enum key_lookup_res *lookup_res,
+    struct vgmap *vgmap,
+    struct kvs_vtuple_ref *vref);
+
 merr_t
 wbti_alloc(struct wbti **wbti_out);
 
@@ -130,9 +157,9 @@ void
 wbti_destroy(struct wbti *wbti);
 
 /**
- * wbti_prefix() - Get the current wbt node's longest common prefix
+ * wbti_prefix() - Get the prefix of the current key
  * @self:   wbt iterator handle
- * @pfx:    (out) longest common prefix
+ * @pfx:    (out) bytes that precede the suffix returned by wbti_next()
  * @pfx_len: (out) length of @pfx
  */
 /* MTF_MOCK */
@@ -61,6 +61,12 @@ cndb_omf_kvs_add_write(
     if (cp->kvs_ext01)
         flags |= CN_CFLAG_CAPPED;
 
+    if (cp->filter_type == KVS_FILTER_FUSE)
+        flags |= CN_CFLAG_FUSE;
+
+    if (cp->hash_index)
+        flags |= CN_CFLAG_HIX;
+
     cndb_hdr_omf_init(&omf.hdr, CNDB_TYPE_KVS_ADD, sizeof(omf));
 
     omf_set_kvs_add_pfxlen(&omf, cp->pfx_len);
@@ -290,6 +296,9 @@ cndb_omf_kvs_add_read(
 {
     cp->pfx_len = omf_kvs_add_pfxlen(omf);
     cp->kvs_ext01 = omf_kvs_add_flags(omf) & CN_CFLAG_CAPPED;
+    cp->filter_type =
+        (omf_kvs_add_flags(omf) & CN_CFLAG_FUSE) ? KVS_FILTER_FUSE : KVS_FILTER_BLOOM;
+    cp->hash_index = omf_kvs_add_flags(omf) & CN_CFLAG_HIX;
 
     *cnid = omf_kvs_add_cnid(omf);
     omf_kvs_add_name(omf, namebuf, namebufsz);
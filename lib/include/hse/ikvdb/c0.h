@@ -109,6 +109,7 @@ c0_put(struct c0 *self, struct kvs_ktuple *key, const struct kvs_vtuple *value,
  * @seqno:     Seqno to use for get
  * @res:       Status of lookup
  * @vbuf:      Ptr to callers buffer
+ * @seqnop:    (output) Seqno of the merge operand found (optional)
  *
  * Return: [HSE_REVISIT]
  */
@@ -120,7 +121,8 @@ c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
 
 /**
  * c0_del() - delete any value associated with the given key
@@ -169,6 +169,10 @@ c0sk_put(
  * @seqref:    Caller's sequence number reference (may be 0)
  * @res:       Status of lookup
  * @vbuf:      Ptr to callers buffer
+ * @seqnop:    (output) Seqno of the merge operand found (optional)
+ *
+ * If @res is %FOUND_MOPND then @vbuf contains a merge operand rather than
+ * a value, and *@seqnop is set to its seqno.
  *
  * Return: [HSE_REVISIT]
  */
@@ -182,7 +186,8 @@ c0sk_get(
     uint64_t view_seq,
     uintptr_t seqref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
 
 /**
  * c0sk_del() - delete any value associated with the given key
@@ -8,17 +8,24 @@
 
 #include <stdint.h>
 
+#include <sys/uio.h>
+
+#include <hse/experimental.h>
+
 #include <hse/error/merr.h>
 #include <hse/ikvdb/kvdb_health.h>
 #include <hse/ikvdb/kvs.h>
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/mpool/mpool.h>
 #include <hse/util/workqueue.h>
 
 /* MTF_MOCK_DECL(cn) */
 
 #define CN_CFLAG_CAPPED (1 << 0)
+#define CN_CFLAG_FUSE   (1 << 1)
+#define CN_CFLAG_HIX    (1 << 2)
 
 struct cn;
 struct cn_kvdb;
@@ -26,6 +33,7 @@ struct cndb;
 struct mpool;
 struct kvs_cparams;
 struct kvs_rparams;
+struct kvset;
 struct kvset_mblocks;
 struct kvdb_kvs;
 struct sts;
@@ -80,9 +88,16 @@ cn_fini(void);
 uint64_t
 cn_get_ingest_dgen(struct cn *cn);
 
+/* Max seqno of all kvsets ingested into cn.  Read it after the ingest
+ * dgen to obtain a bound for the content of cn at that dgen.
+ */
+/* MTF_MOCK */
+uint64_t
+cn_get_ingest_seqno_max(struct cn *cn);
+
 /* MTF_MOCK */
 void
-cn_inc_ingest_dgen(struct cn *cn);
+cn_inc_ingest_dgen(struct cn *cn, uint64_t seqno_max);
 
 /* MTF_MOCK */
 struct kvs_rparams *
@@ -103,6 +118,9 @@ cn_disable_maint(struct cn *handle, bool onoff);
 /*
  * Note: Tombstones indicated by:
  *     return value == hse_success && res == FOUND_TOMB
+ *
+ * If res == FOUND_MOPND then vbuf contains a merge operand, and *seqnop
+ * (if seqnop is not NULL) is set to its seqno.
  */
 /* MTF_MOCK */
 merr_t
@@ -111,7 +129,67 @@ cn_get(
     struct kvs_ktuple *kt,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
+
+/**
+ * cn_get_many() - vectored version of cn_get()
+ * @cn:    cn handle
+ * @keyc:  number of keys
+ * @ktv:   vector of keys to search for
+ * @seq:   view sequence number
+ * @resv:  (in/out) vector of results, only keys with NOT_FOUND are searched
+ * @vbufv: (output) vector of value buffers
+ */
+merr_t
+cn_get_many(
+    struct cn *cn,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
+/**
+ * struct cn_get_aio - asynchronous cn get request
+ * @cga_cb:    completion callback
+ * @cga_res:   lookup result (valid within/after @cga_cb)
+ * @cga_err:   completion status (valid within/after @cga_cb)
+ * @cga_vbuf:  value buffer, must remain valid until @cga_cb is invoked
+ *
+ * The remaining fields are private to cn and describe the value read
+ * that is in flight, if any.
+ */
+struct cn_get_aio {
+    void (*cga_cb)(struct cn_get_aio *aio);
+    enum key_lookup_res cga_res;
+    merr_t cga_err;
+    struct kvs_buf *cga_vbuf;
+
+    struct mpool_aio cga_mpaio;
+    struct cn *cga_cn;
+    struct kvset *cga_kvset;
+    struct kvs_vtuple_ref cga_vref;
+    struct iovec cga_iov;
+    bool cga_freeme;
+};
+
+/**
+ * cn_get_async() - asynchronous version of cn_get()
+ * @cn:   cn handle
+ * @kt:   key to search for
+ * @seq:  view sequence number
+ * @aio:  get request
+ *
+ * The lookup is performed on the caller's stack, but if the value must
+ * be read from media then the read is issued asynchronously and
+ * aio->cga_cb is invoked from an mpool completion thread once the value
+ * has been copied out.  Otherwise aio->cga_cb is invoked before
+ * cn_get_async() returns.  If cn_get_async() returns an error then
+ * aio->cga_cb is not invoked.
+ */
+merr_t
+cn_get_async(struct cn *cn, struct kvs_ktuple *kt, uint64_t seq, struct cn_get_aio *aio);
 
 struct query_ctx;
 
@@ -151,6 +229,46 @@ cn_ingestv(
 struct perfc_set *
 cn_get_ingest_perfc(const struct cn *cn);
 
+/**
+ * cn_set_merge_fn() - set the merge operator used to resolve merge operands
+ * @cn: cn handle
+ * @fn: merge operator (may be NULL)
+ *
+ * The merge operator is used by kvs gets to resolve operands, and by
+ * kv-compaction to collapse them.
+ */
+/* MTF_MOCK */
+void
+cn_set_merge_fn(struct cn *cn, hse_kvs_merge_fn *fn);
+
+/* MTF_MOCK */
+hse_kvs_merge_fn *
+cn_get_merge_fn(const struct cn *cn);
+
+/* Callback for each key about to be ingested into cn, made while the key's
+ * newest value (with seqno @seqno) is still visible in c0 or lc.  @ptomb is
+ * true if the key is a prefix tombstone.
+ */
+typedef void
+cn_ingest_inval_fn(void *arg, const void *key, uint klen, uint64_t seqno, bool ptomb);
+
+/**
+ * cn_set_ingest_inval() - set the callback made for each key ingested
+ * @cn:  cn handle
+ * @fn:  callback (may be NULL)
+ * @arg: callback argument
+ *
+ * Used to invalidate caches of cn content (e.g., the kvs row cache) key by
+ * key, before an ingest commits.
+ */
+/* MTF_MOCK */
+void
+cn_set_ingest_inval(struct cn *cn, cn_ingest_inval_fn *fn, void *arg);
+
+/* MTF_MOCK */
+void
+cn_ingest_inval(struct cn *cn, const void *key, uint klen, uint64_t seqno, bool ptomb);
+
 /* MTF_MOCK */
 void *
 cn_get_tree(const struct cn *cn);
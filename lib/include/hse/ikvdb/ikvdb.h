@@ -8,6 +8,7 @@
 
 #include <bsd/libutil.h>
 
+#include <hse/experimental.h>
 #include <hse/flags.h>
 
 #include <hse/error/merr.h>
@@ -33,9 +34,11 @@ struct hse_kvs_cursor;
 struct mpool;
 struct c0sk;
 struct cndb;
+struct cn_get_aio;
 struct kvdb_diag_kvs_list;
 struct kvs;
 struct ikvdb_kvs_hdl;
+struct hse_kvdb_batch;
 enum hse_mclass;
 
 struct hse_kvdb_txn {};
@@ -406,6 +409,30 @@ ikvdb_kvs_put(
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt);
 
+/**
+ * ikvdb_kvs_merge() - merge an operand into the value of a key
+ * @kvs:   KVS handle (must not be transactional)
+ * @flags: operation flags
+ * @kt:    key
+ * @vt:    merge operand (never compressed)
+ */
+/* MTF_MOCK */
+merr_t
+ikvdb_kvs_merge(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt);
+
+/**
+ * ikvdb_kvs_merge_op_set() - register the merge operator of a KVS
+ * @kvs: KVS handle (must not be transactional)
+ * @fn:  merge operator (may be NULL)
+ */
+/* MTF_MOCK */
+merr_t
+ikvdb_kvs_merge_op_set(struct hse_kvs *kvs, hse_kvs_merge_fn *fn);
+
 /**
  * ikvdb_kvs_get() - search for the given key within the KVS. HSE allocates
  * memory for the result if vbuf->b_buf is NULL.
@@ -419,6 +446,32 @@ ikvdb_kvs_get(
     enum key_lookup_res *res,
     struct kvs_buf *vbuf);
 
+/**
+ * ikvdb_kvs_get_many() - vectored version of ikvdb_kvs_get(). All keys
+ * are searched using the same view.
+ */
+merr_t
+ikvdb_kvs_get_many(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    unsigned int keyc,
+    struct kvs_ktuple *ktv,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
+/**
+ * ikvdb_kvs_get_async() - asynchronous version of ikvdb_kvs_get(). The
+ * result is delivered via aio->cga_cb, see cn_get_async().
+ */
+merr_t
+ikvdb_kvs_get_async(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    struct kvs_ktuple *kt,
+    struct cn_get_aio *aio);
+
 /**
  * ikvdb_kvs_del() - remove the supplied key and associated value from the KVS
  * indexed by opspec->kop_index.
@@ -477,6 +530,47 @@ ikvdb_sync(struct ikvdb *kvdb, unsigned int flags);
 uint64_t
 ikvdb_horizon(struct ikvdb *store);
 
+/**
+ * ikvdb_batch_alloc() - allocate an empty write batch
+ */
+struct hse_kvdb_batch *
+ikvdb_batch_alloc(struct ikvdb *kvdb);
+
+/**
+ * ikvdb_batch_free() - free a write batch, discarding its contents
+ */
+void
+ikvdb_batch_free(struct ikvdb *kvdb, struct hse_kvdb_batch *batch);
+
+/**
+ * ikvdb_kvs_batch_put() - append a put to a write batch. The key and value
+ * are copied (and the value compressed per the kvs/wal policy).
+ */
+merr_t
+ikvdb_kvs_batch_put(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt);
+
+/**
+ * ikvdb_kvs_batch_del() - append a delete to a write batch
+ */
+merr_t
+ikvdb_kvs_batch_del(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    struct kvs_ktuple *kt);
+
+/**
+ * ikvdb_batch_apply() - atomically apply all mutations in a write batch,
+ * emptying the batch on success
+ */
+merr_t
+ikvdb_batch_apply(struct ikvdb *kvdb, unsigned int flags, struct hse_kvdb_batch *batch);
+
 /**
  * ikvdb_txn_horizon() - return an upper bound on the smallest view sequence
  *                   number in use by any currently active transaction.
@@ -498,9 +592,10 @@ ikvdb_txn_free(struct ikvdb *kvdb, struct hse_kvdb_txn *txn);
 
 /**
  * ikvdb_txn_begin() - initiate a transaction. txn->kt_seq_num identifies it.
+ * @flags:  HSE_KVDB_TXN_BEGIN_* flags
  */
 merr_t
-ikvdb_txn_begin(struct ikvdb *kvdb, struct hse_kvdb_txn *txn);
+ikvdb_txn_begin(struct ikvdb *kvdb, unsigned int flags, struct hse_kvdb_txn *txn);
 
 /**
  * ikvdb_txn_commit() - publish all mutations performed in the context of txn.
@@ -647,6 +742,7 @@ ikvdb_wal_replay_open(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl **ikvsh_out);
 void
 ikvdb_wal_replay_close(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl *ikvsh);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_put(
     struct ikvdb *ikvdb,
@@ -656,6 +752,7 @@ ikvdb_wal_replay_put(
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_del(
     struct ikvdb *ikvdb,
@@ -664,6 +761,7 @@ ikvdb_wal_replay_del(
     uint64_t seqno,
     struct kvs_ktuple *kt);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_prefix_del(
     struct ikvdb *ikvdb,
@@ -70,6 +70,26 @@ kvdb_ctxn_free(struct kvdb_ctxn *txn);
 merr_t
 kvdb_ctxn_begin(struct kvdb_ctxn *txn);
 
+/**
+ * kvdb_ctxn_lock_wait_set() - set how long the txn waits on write conflicts
+ * @txn:        transaction handle
+ * @timeout_ms: max wait (ms) for a conflicting txn to finish, 0 to fail fast
+ *
+ * Applies to the current incarnation of an active txn only.
+ */
+void
+kvdb_ctxn_lock_wait_set(struct kvdb_ctxn *txn, uint32_t timeout_ms);
+
+/**
+ * kvdb_ctxn_serializable_set() - make the txn validate its reads at commit
+ * @txn:          transaction handle
+ * @serializable: true to track reads and fail commit on read-write conflict
+ *
+ * Applies to the current incarnation of an active txn only.
+ */
+void
+kvdb_ctxn_serializable_set(struct kvdb_ctxn *txn, bool serializable);
+
 /* MTF_MOCK */
 merr_t
 kvdb_ctxn_commit(struct kvdb_ctxn *txn);
@@ -78,6 +98,27 @@ kvdb_ctxn_commit(struct kvdb_ctxn *txn);
 void
 kvdb_ctxn_abort(struct kvdb_ctxn *txn);
 
+/**
+ * kvdb_ctxn_batch_begin() - begin the application of a write batch
+ * @txn:     an idle (not active) transaction
+ * @seqref:  (output) seqnoref to be assigned to each batch mutation
+ * @txid:    (output) WAL txn ID for each batch mutation
+ * @cookie:  (output) WAL cookie for each batch mutation
+ *
+ * A write batch is applied as an anonymous txn that acquires no key locks.
+ * On success the txn remains locked until kvdb_ctxn_batch_end() is called.
+ */
+merr_t
+kvdb_ctxn_batch_begin(struct kvdb_ctxn *txn, uintptr_t *seqref, uint64_t *txid, int64_t *cookie);
+
+/**
+ * kvdb_ctxn_batch_end() - publish (or discard) all mutations of a write batch
+ * @txn:     txn given to kvdb_ctxn_batch_begin()
+ * @commit:  true to commit the batch, false to abort it
+ */
+merr_t
+kvdb_ctxn_batch_end(struct kvdb_ctxn *txn, bool commit);
+
 /* MTF_MOCK */
 enum kvdb_ctxn_state
 kvdb_ctxn_get_state(struct kvdb_ctxn *txn);
@@ -108,6 +149,7 @@ kvdb_ctxn_trylock_write(
     uint64_t *view_seqno,
     int64_t *cookie,
     bool is_ptomb,
+    uint64_t kvshash,
     uint64_t pfxhash,
     uint64_t keyhash);
 
@@ -115,6 +157,29 @@ kvdb_ctxn_trylock_write(
 void
 kvdb_ctxn_unlock(struct kvdb_ctxn *handle);
 
+/**
+ * kvdb_ctxn_read_key() - record a point read by a serializable txn
+ * @handle:  transaction handle, locked by kvdb_ctxn_trylock_read()
+ * @kvshash: pfxlock hash of the kvs, as given to kvdb_ctxn_trylock_write()
+ * @pfxhash: pfxlock hash of the key's prefix (zero if none)
+ * @hash:    hash of the key, as given to kvdb_ctxn_trylock_write()
+ */
+/* MTF_MOCK */
+void
+kvdb_ctxn_read_key(struct kvdb_ctxn *handle, uint64_t kvshash, uint64_t pfxhash, uint64_t hash);
+
+/**
+ * kvdb_ctxn_read_range() - record a range (prefix or cursor) read by a
+ *                          serializable txn
+ * @handle:  transaction handle, locked by kvdb_ctxn_trylock_read()
+ * @kvshash: pfxlock hash of the kvs
+ * @pfxhash: pfxlock hash of the prefix of the range, zero if the range
+ *           isn't confined to one prefix
+ */
+/* MTF_MOCK */
+void
+kvdb_ctxn_read_range(struct kvdb_ctxn *handle, uint64_t kvshash, uint64_t pfxhash);
+
 int64_t
 kvdb_ctxn_wal_cookie_get(struct kvdb_ctxn *handle);
 
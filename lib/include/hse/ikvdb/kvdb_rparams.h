@@ -36,6 +36,7 @@
  * @c0_debug:         c0 debug flags (see param_debug_flags.h)
  * @keylock_tables:   number of keylock hash tables
  * @txn_wkth_delay:        delay (msecs) to invoke transaction worker thread
+ * @txn_lock_wait_timeout: max wait (msecs) on a write conflict by a waiting txn
  *
  * The following tunable parameters can have a major impact on the way KVDB
  * operates.  Test thoroughly after any modifications.
@@ -54,6 +55,7 @@ struct kvdb_rparams {
     uint32_t c0_ingest_width;
 
     uint64_t txn_timeout;
+    uint32_t txn_lock_wait_timeout;
 
     uint64_t csched_debug_mask;
     uint64_t csched_qthreads;
@@ -74,7 +76,10 @@ struct kvdb_rparams {
     uint32_t dur_bufsz_mb;
     uint32_t dur_intvl_ms;
     uint32_t dur_size_bytes;
+    uint32_t dur_gc_wait_us;
+    uint32_t dur_vcomp_min;
     bool dur_enable;
+    bool dur_gc_enable;
     bool dur_buf_managed;
     bool dur_replay_force;
     uint8_t dur_throttle_lo_th;
@@ -94,6 +99,7 @@ struct kvdb_rparams {
     uint64_t txn_wkth_delay;
     uint32_t c0_maint_threads;
     uint32_t c0_ingest_threads;
+    uint32_t c0_ingest_build_threads;
     uint16_t cn_maint_threads;
     uint16_t cn_io_threads;
     double cndb_compact_hwm_pct;
@@ -102,6 +108,7 @@ struct kvdb_rparams {
     enum kvdb_open_mode mode;
 
     bool dio_enable[HSE_MCLASS_COUNT];
+    enum mpool_io_engine io_engine[HSE_MCLASS_COUNT];
     struct mclass_policy mclass_policies[HSE_MPOLICY_COUNT];
 };
 
@@ -32,6 +32,8 @@ struct mpool;
 struct kvs_cparams;
 struct lc;
 struct cn;
+struct kvs_rcache;
+struct cn_get_aio;
 struct cn_kvdb;
 struct wal;
 struct viewset;
@@ -63,6 +65,7 @@ struct ikvs {
     struct cn *ikv_cn;
     struct lc *ikv_lc;
     struct wal *ikv_wal;
+    struct kvs_rcache *ikv_rcache;
     struct perfc_set ikv_pkvsl_pc; /* Public kvs interfaces Lat. */
     struct perfc_set ikv_cc_pc;
     struct perfc_set ikv_cd_pc;
@@ -170,7 +173,9 @@ kvs_put(
     struct hse_kvdb_txn *txn,
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt,
-    uint64_t seqno);
+    struct kvs_vtuple *wvt,
+    uint64_t seqno,
+    bool sync);
 
 merr_t
 kvs_get(
@@ -181,9 +186,73 @@ kvs_get(
     enum key_lookup_res *res,
     struct kvs_buf *vbuf);
 
+/**
+ * kvs_get_merge() - resolve the merge operands of a key
+ * @ikvs:  kvs handle
+ * @key:   key whose newest version in the view is a merge operand
+ * @seqno: view seqno
+ * @res:   (output) result of the lookup
+ * @vbuf:  (output) merged value
+ *
+ * Collects the key's operands (newest first) until its base value is found,
+ * and then combines them via the kvs's merge operator.  Merges are permitted
+ * only on non-transactional kvses, hence there is no txn.
+ */
+merr_t
+kvs_get_merge(
+    struct ikvs *ikvs,
+    struct kvs_ktuple *key,
+    uint64_t seqno,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf);
+
+merr_t
+kvs_get_many(
+    struct ikvs *ikvs,
+    struct hse_kvdb_txn *txn,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seqno,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
+merr_t
+kvs_get_async(
+    struct ikvs *ikvs,
+    struct hse_kvdb_txn *txn,
+    struct kvs_ktuple *kt,
+    uint64_t seqno,
+    struct cn_get_aio *aio);
+
 merr_t
 kvs_del(struct ikvs *ikvs, struct hse_kvdb_txn *txn, struct kvs_ktuple *key, uint64_t seqno);
 
+/* Write batch mutations are applied under a seqnoref, WAL txid and WAL cookie
+ * obtained from kvdb_ctxn_batch_begin(), without acquiring key locks.
+ */
+merr_t
+kvs_batch_put(
+    struct ikvs *ikvs,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    uint64_t txid,
+    int64_t cookie);
+
+merr_t
+kvs_batch_del(
+    struct ikvs *ikvs,
+    struct kvs_ktuple *kt,
+    uintptr_t seqnoref,
+    uint64_t txid,
+    int64_t cookie);
+
+/* Record a read of the range of keys with the given prefix (or of the whole
+ * kvs if pfx is shorter than the kvs prefix) by a serializable txn.
+ */
+merr_t
+kvs_txn_read_range(struct ikvs *ikvs, struct hse_kvdb_txn *txn, const void *pfx, size_t pfx_len);
+
 merr_t
 kvs_pfx_probe(
     struct ikvs *kvs,
@@ -6,6 +6,7 @@
 #ifndef HSE_KVS_CPARAMS_H
 #define HSE_KVS_CPARAMS_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -14,9 +15,24 @@
 #include <hse/error/merr.h>
 #include <hse/util/compiler.h>
 
+#define KVS_FILTER_PARAM_BLOOM "bloom"
+#define KVS_FILTER_PARAM_FUSE  "fuse"
+
+/* Type of the per-kblock filter used to skip kblocks on point gets.
+ */
+enum kvs_filter_type {
+    KVS_FILTER_BLOOM,
+    KVS_FILTER_FUSE,
+};
+
+#define KVS_FILTER_MIN KVS_FILTER_BLOOM
+#define KVS_FILTER_MAX KVS_FILTER_FUSE
+
 struct kvs_cparams {
     uint32_t pfx_len;
     uint32_t kvs_ext01;
+    enum kvs_filter_type filter_type;
+    bool hash_index;
 };
 
 const struct param_spec *
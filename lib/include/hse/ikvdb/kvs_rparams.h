@@ -33,6 +33,7 @@
  */
 struct kvs_rparams {
     uint64_t kvs_cursor_ttl;
+    uint64_t kvs_rcache_sz;
 
     bool transactions_enable;
     bool cn_maint_disable;
@@ -43,6 +44,8 @@ struct kvs_rparams {
     uint32_t cn_maint_delay;
     uint32_t cn_split_size;
     uint32_t cn_dsplit_size;
+    uint32_t cn_compact_slices;
+    uint32_t cn_wbehind_qdepth;
     uint32_t kvs_sfxlen;
 
     uint64_t cn_compact_kblk_ra;
@@ -70,9 +73,13 @@ struct kvs_rparams {
 
     uint64_t capped_evict_ttl;
 
+    uint32_t cn_mclass_hot;
+
     struct {
         struct {
             enum vcomp_default dflt;
+            enum vcomp_algorithm algo;
+            int32_t level;
         } compression;
     } value;
 
@@ -94,6 +94,10 @@ kvset_builder_add_vref(
     uint vlen,
     uint complen);
 
+/* MTF_MOCK */
+merr_t
+kvset_builder_add_mopnd(struct kvset_builder *self, uint64_t seq, const void *vdata, uint vlen);
+
 /* MTF_MOCK */
 merr_t
 kvset_builder_add_nonval(struct kvset_builder *self, uint64_t seq, enum kmd_vtype vtype);
@@ -107,6 +111,38 @@ kvset_builder_adopt_vblocks(
     uint64_t vtotal,
     struct vgmap *vgmap);
 
+/**
+ * kvset_builder_set_vbidx_base() - Offset the vblock indexes recorded by a builder
+ * @base:  added to the vblock index of each value written to a vblock
+ * @limit: max number of vblocks the builder may write
+ *
+ * Used by the slices of a range-partitioned compaction so that the kblocks
+ * written by each slice reference a disjoint range of vblock indexes.  The
+ * slices are stitched into a single kvset by kvset_builder_adopt_slices().
+ */
+/* MTF_MOCK */
+void
+kvset_builder_set_vbidx_base(struct kvset_builder *self, uint32_t base, uint32_t limit);
+
+/**
+ * kvset_builder_adopt_slices() - Stitch the output of several builders into one kvset
+ * @self:   builder to which no keys have been added
+ * @slicev: builders for disjoint key ranges, in ascending key order
+ * @slicec: number of builders in @slicev
+ *
+ * Finishes the kblocks and vblocks of each slice builder and transfers them to
+ * @self, which is then finished by kvset_builder_get_mblocks().  Each slice
+ * that wrote vblocks becomes one vgroup in the resulting kvset.  On success
+ * the slice builders hold no mblocks and may be destroyed.  The slice builders
+ * must not have any prefix tombstones.
+ */
+/* MTF_MOCK */
+merr_t
+kvset_builder_adopt_slices(
+    struct kvset_builder *self,
+    struct kvset_builder **slicev,
+    uint slicec);
+
 /* MTF_MOCK */
 void
 kvset_builder_destroy(struct kvset_builder *builder);
@@ -119,6 +155,13 @@ kvset_mblocks_destroy(struct kvset_mblocks *kvset);
 merr_t
 kvset_builder_set_agegroup(struct kvset_builder *self, enum hse_mclass_policy_age age);
 
+/* Override the age group by which the media class of values is chosen.
+ * Must be called after kvset_builder_set_agegroup().
+ */
+/* MTF_MOCK */
+merr_t
+kvset_builder_set_value_agegroup(struct kvset_builder *self, enum hse_mclass_policy_age age);
+
 /* MTF_MOCK */
 void
 kvset_builder_set_merge_stats(struct kvset_builder *self, struct cn_merge_stats *stats);
@@ -24,10 +24,28 @@
 #define HSE_C0_INGEST_THREADS_DFLT  (3)
 #define HSE_C0_INGEST_THREADS_MAX   (5)
 
+/* Zero build threads leaves all kvset builds of an ingest to its ingest thread.
+ */
+#define HSE_C0_INGEST_BUILD_THREADS_MIN     (0)
+#define HSE_C0_INGEST_BUILD_THREADS_DFLT    (4)
+#define HSE_C0_INGEST_BUILD_THREADS_MAX     (16)
+
 #define HSE_C0_MAINT_THREADS_MIN    (1)
 #define HSE_C0_MAINT_THREADS_DFLT   (3)
 #define HSE_C0_MAINT_THREADS_MAX    (7)
 
+/* A zero-sized mblock cache leaves all kblocks and hblocks to the page cache.
+ */
+#define HSE_CN_MBCACHE_SZ_MIN       (0ul)
+#define HSE_CN_MBCACHE_SZ_DFLT      (0ul)
+#define HSE_CN_MBCACHE_SZ_MAX       (1ul << 40)
+
+/* A zero-sized row cache disables the kvs row cache.
+ */
+#define HSE_KVS_RCACHE_SZ_MIN       (0ul)
+#define HSE_KVS_RCACHE_SZ_DFLT      (0ul)
+#define HSE_KVS_RCACHE_SZ_MAX       (1ul << 40)
+
 /* CNDB */
 #define HSE_CNDB_COMPACT_HWM_PCT_DEFAULT (80)
 
@@ -64,6 +82,17 @@
 #define HSE_CURACTIVE_SZ_MIN        (2ul << 30)
 #define HSE_CURACTIVE_SZ_MAX        (32ul << 30)
 
+/* Maximum number of keys that a batched get resolves in one pass
+ * through cn (see cn_tree_lookup_many()).  Larger batches are split.
+ */
+#define HSE_KVS_GET_MANY_BATCH      (64)
+
+/* Maximum footprint of a write batch (see ikvdb_batch_apply()).  A batch is
+ * applied as a single unit, and its mutations must fit in c0 along with
+ * those of concurrent writers.
+ */
+#define HSE_KVDB_BATCH_SZ_MAX       (64ul << 20)
+
 /* A cursor's footprint is at least 1MB, not including iterators
  * (see struct kvs_cursor).
  */
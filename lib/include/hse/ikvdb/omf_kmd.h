@@ -24,6 +24,9 @@
  *   clen    hg32_1024m   1   1   4   not present for tombs and
  *                                    non-compressed values
  *
+ * Immediate values and merge operands are instead stored in the kmd as
+ * a u8 length followed by the data (hence at most 255 bytes).
+ *
  * Per-entry overhead:
  *
  *     Min  Typical  Max
@@ -124,6 +127,18 @@ kmd_add_ival(void *kmd, size_t *off, uint64_t seq, const void *vdata, uint8_t vl
     *off += vlen;
 }
 
+static inline void
+kmd_add_mopnd(void *kmd, size_t *off, uint64_t seq, const void *vdata, uint8_t vlen)
+{
+    ((uint8_t *)kmd)[*off] = VTYPE_MOPND;
+    *off += 1;
+    encode_hg64(kmd, off, seq);
+    ((uint8_t *)kmd)[*off] = vlen;
+    *off += 1;
+    memcpy(((uint8_t *)kmd) + *off, vdata, vlen);
+    *off += vlen;
+}
+
 static inline void
 kmd_add_val(void *kmd, size_t *off, uint64_t seq, uint vbidx, uint vboff, uint vlen)
 {
@@ -202,4 +217,10 @@ kmd_ival(const void *kmd, size_t *off, const void **vbase, uint *vlen)
     *vbase = ((const uint8_t *)kmd) + *off;
     *off += *vlen;
 }
+
+static inline void
+kmd_mopnd(const void *kmd, size_t *off, const void **vbase, uint *vlen)
+{
+    kmd_ival(kmd, off, vbase, vlen);
+}
 #endif
@@ -17,8 +17,9 @@ enum kmd_vtype {
     VTYPE_PTOMB = 3,  // prefix tombstone
     VTYPE_IVAL = 4,   // immediate value, uncompressed, stored in a kblock
     VTYPE_CVAL = 5,   // an LZ4 compressed value stored in a vblock
+    VTYPE_MOPND = 6,  // merge operand, uncompressed, stored in a kblock (KBLOCK_HDR_VERSION8+)
 };
 
-#define NUM_KMD_VTYPES 6
+#define NUM_KMD_VTYPES 7
 
 #endif
@@ -11,6 +11,12 @@ enum {
     GLOBAL_OMF_VERSION2 = 2,
     GLOBAL_OMF_VERSION3 = 3,
     GLOBAL_OMF_VERSION4 = 4,
+    GLOBAL_OMF_VERSION5 = 5,
+    GLOBAL_OMF_VERSION6 = 6,
+    GLOBAL_OMF_VERSION7 = 7,
+    GLOBAL_OMF_VERSION8 = 8,
+    GLOBAL_OMF_VERSION9 = 9,
+    GLOBAL_OMF_VERSION10 = 10,
 };
 
 enum {
@@ -23,6 +29,8 @@ enum { VGROUP_MAP_VERSION1 = 1 };
 
 enum {
     KBLOCK_HDR_VERSION6 = 6,
+    KBLOCK_HDR_VERSION7 = 7,
+    KBLOCK_HDR_VERSION8 = 8,
 };
 
 enum {
@@ -31,10 +39,14 @@ enum {
 
 enum {
     BLOOM_OMF_VERSION5 = 5,
+    BLOOM_OMF_VERSION6 = 6,
+    BLOOM_OMF_VERSION7 = 7,
 };
 
 enum {
     WBT_TREE_VERSION6 = 6,
+    WBT_TREE_VERSION7 = 7,
+    WBT_TREE_VERSION8 = 8,
 };
 
 enum {
@@ -55,6 +67,7 @@ enum {
 enum {
     WAL_VERSION1 = 1,
     WAL_VERSION2 = 2,
+    WAL_VERSION3 = 3,
 };
 
 enum {
@@ -62,7 +75,7 @@ enum {
     KVDB_META_VERSION2 = 2,
 };
 
-#define GLOBAL_OMF_VERSION GLOBAL_OMF_VERSION4
+#define GLOBAL_OMF_VERSION GLOBAL_OMF_VERSION10
 
 /* In the event one of the following versions in incremented, increment the
  * global OMF version.
@@ -71,14 +84,14 @@ enum {
 #define CNDB_VERSION           CNDB_VERSION1
 #define HBLOCK_HDR_VERSION     HBLOCK_HDR_VERSION1
 #define VGROUP_MAP_VERSION     VGROUP_MAP_VERSION1
-#define KBLOCK_HDR_VERSION     KBLOCK_HDR_VERSION6
+#define KBLOCK_HDR_VERSION     KBLOCK_HDR_VERSION8
 #define VBLOCK_FOOTER_VERSION  VBLOCK_FOOTER_VERSION1
-#define BLOOM_OMF_VERSION      BLOOM_OMF_VERSION5
-#define WBT_TREE_VERSION       WBT_TREE_VERSION6
+#define BLOOM_OMF_VERSION      BLOOM_OMF_VERSION7
+#define WBT_TREE_VERSION       WBT_TREE_VERSION8
 #define CN_TSTATE_VERSION      CN_TSTATE_VERSION2
 #define MBLOCK_METAHDR_VERSION MBLOCK_METAHDR_VERSION2
 #define MDC_LOGHDR_VERSION     MDC_LOGHDR_VERSION2
-#define WAL_VERSION            WAL_VERSION2
+#define WAL_VERSION            WAL_VERSION3
 #define KVDB_META_VERSION      KVDB_META_VERSION2
 
 #endif
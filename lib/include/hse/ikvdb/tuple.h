@@ -6,6 +6,7 @@
 #ifndef HSE_CORE_TUPLE_H
 #define HSE_CORE_TUPLE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <hse/error/merr.h>
@@ -32,8 +33,15 @@ enum key_lookup_res {
     FOUND_TMB = 3,
     FOUND_PTMB = 4,
     FOUND_MULTIPLE = 5,
+    FOUND_MOPND = 6,
 };
 
+/* Merge operands are distinguished from values in c0 (and hence in the WAL,
+ * as of WAL_VERSION3) by the most significant bit of the uncompressed length
+ * in their xlen.  Operands are never compressed.
+ */
+#define HSE_XLEN_MOPND          (1ul << 31)
+
 /* clang-format on */
 
 struct kvs_ktuple {
@@ -143,6 +151,27 @@ kvs_vtuple_cinit(struct kvs_vtuple *vt, void *val, uint vlen, uint clen)
     vt->vt_xlen = ((uint64_t)clen << 32) | vlen;
 }
 
+/**
+ * kvs_vtuple_minit() - initialize a merge operand tuple
+ * @vt:   the vtuple to initialize
+ * @val:  pointer to the in-core operand
+ * @vlen: the operand length
+ */
+static inline void
+kvs_vtuple_minit(struct kvs_vtuple *vt, void *val, uint vlen)
+{
+    assert(vlen < HSE_XLEN_MOPND);
+
+    vt->vt_data = val;
+    vt->vt_xlen = HSE_XLEN_MOPND | vlen;
+}
+
+static HSE_ALWAYS_INLINE bool
+kvs_vtuple_is_mopnd(const struct kvs_vtuple *vt)
+{
+    return vt->vt_xlen & HSE_XLEN_MOPND;
+}
+
 /**
  * kvs_vtuple_vlen() - return in-core value length
  * @vt: ptr to a vtuple
@@ -154,7 +183,7 @@ static HSE_ALWAYS_INLINE uint32_t
 kvs_vtuple_vlen(const struct kvs_vtuple *vt)
 {
     const uint32_t clen = vt->vt_xlen >> 32;
-    const uint32_t vlen = vt->vt_xlen & 0xfffffffful;
+    const uint32_t vlen = vt->vt_xlen & ~HSE_XLEN_MOPND & 0xfffffffful;
 
     return clen ? clen : vlen;
 }
@@ -7,9 +7,14 @@
 #define HSE_VCOMP_PARAMS_H
 
 #include <stdint.h>
+#include <sys/types.h>
 
-#define VCOMP_PARAM_OFF "off"
-#define VCOMP_PARAM_ON  "on"
+#include <hse/error/merr.h>
+
+#define VCOMP_PARAM_OFF  "off"
+#define VCOMP_PARAM_ON   "on"
+#define VCOMP_PARAM_LZ4  "lz4"
+#define VCOMP_PARAM_ZSTD "zstd"
 
 enum vcomp_default {
     VCOMP_DEFAULT_OFF,
@@ -22,12 +27,35 @@ enum vcomp_default {
 
 enum vcomp_algorithm {
     VCOMP_ALGO_LZ4,
+    VCOMP_ALGO_ZSTD,
 };
 
 #define VCOMP_ALGO_MIN   VCOMP_ALGO_LZ4
-#define VCOMP_ALGO_MAX   VCOMP_ALGO_LZ4
+#define VCOMP_ALGO_MAX   VCOMP_ALGO_ZSTD
 #define VCOMP_ALGO_COUNT (VCOMP_ALGO_MAX + 1)
 
+/* Compression level bounds, zero selects the algorithm's default level.
+ * zstd levels above 19 require a large amount of memory per context.
+ */
+#define VCOMP_LEVEL_MIN (-5)
+#define VCOMP_LEVEL_MAX (19)
+
+/* An entry is NULL if support for the algorithm was not built in.
+ */
 extern const struct compress_ops *vcomp_compress_ops[VCOMP_ALGO_COUNT];
 
+/**
+ * vcomp_decompress() - decompress a value compressed by any vcomp algorithm
+ * @src:          compressed value
+ * @src_len:      compressed length
+ * @dst:          output buffer
+ * @dst_capacity: size of %dst, may be less than the uncompressed length
+ * @dst_len:      (output) number of bytes written to %dst
+ *
+ * The algorithm is determined from the compressed data itself, such that
+ * values compressed under different kvs rparams may be freely mixed.
+ */
+merr_t
+vcomp_decompress(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len);
+
 #endif
@@ -25,6 +25,15 @@
 #define HSE_WAL_DUR_BUFSZ_MB_DFLT (4096ul)
 #define HSE_WAL_DUR_BUFSZ_MB_MAX  (8192ul)
 
+/* Group commit max wait for more sync callers to join an epoch */
+#define HSE_WAL_GC_WAIT_US_MIN  (0)
+#define HSE_WAL_GC_WAIT_US_DFLT (100)
+#define HSE_WAL_GC_WAIT_US_MAX  (10000)
+
+/* Min length of values compressed before they are logged (0 disables) */
+#define HSE_WAL_VCOMP_MIN_DFLT (0)
+#define HSE_WAL_VCOMP_MIN_MAX  (HSE_KVS_VALUE_LEN_MAX)
+
 struct wal;
 struct throttle_sensor;
 
@@ -126,6 +135,9 @@ wal_bufrel_cb(struct wal *wal, uint64_t gen);
 merr_t
 wal_sync(struct wal *wal);
 
+merr_t
+wal_op_sync(struct wal *wal, const struct wal_record *rec);
+
 void
 wal_throttle_sensor(struct wal *wal, struct throttle_sensor *sensor);
 
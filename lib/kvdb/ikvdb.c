@@ -61,6 +61,7 @@
 #include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/log2.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/seqno.h>
 #include <hse/util/vlb.h>
@@ -89,6 +90,8 @@ struct perfc_name ctxn_perfc_op[] _dt_section = {
     NE(PERFC_LT_CTXNOP_COMMIT,    3, "Latency of ctxn commits",    "l_ctxn_commit(/s)", 7),
     NE(PERFC_RA_CTXNOP_ABORT,     3, "Rate of ctxn aborts",        "r_ctxn_abort(/s)"),
     NE(PERFC_RA_CTXNOP_LOCKFAIL,  2, "Rate of key lock failures",  "r_ctxn_lockfail(/s)"),
+    NE(PERFC_RA_CTXNOP_LOCKWAIT,  2, "Rate of key lock waits",     "r_ctxn_lockwait(/s)"),
+    NE(PERFC_RA_CTXNOP_DEADLOCK,  2, "Rate of key lock deadlocks", "r_ctxn_deadlock(/s)"),
     NE(PERFC_RA_CTXNOP_FREE,      1, "Rate of ctxn frees",         "r_ctxn_free(/s)"),
 };
 
@@ -960,8 +963,10 @@ ikvdb_diag_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb
     if (ev(err))
         goto self_cleanup;
 
-    for (int i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++)
+    for (int i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         mparams.mclass[i].dio_disable = !params->dio_enable[i];
+        mparams.mclass[i].io_engine = params->io_engine[i];
+    }
 
     err = mpool_open(kvdb_home, &mparams, O_RDONLY, &self->ikdb_mp);
     if (ev(err))
@@ -1179,6 +1184,9 @@ ikvdb_lowmem_adjust(struct ikvdb_impl *self, ulong memgb)
     if (rp->c0_ingest_threads == rpdef.c0_ingest_threads)
         rp->c0_ingest_threads = HSE_C0_INGEST_THREADS_MIN;
 
+    if (rp->c0_ingest_build_threads == rpdef.c0_ingest_build_threads)
+        rp->c0_ingest_build_threads = HSE_C0_INGEST_BUILD_THREADS_MIN;
+
     if (rp->c0_ingest_width == rpdef.c0_ingest_width)
         rp->c0_ingest_width = HSE_C0_INGEST_WIDTH_MIN;
 
@@ -1313,8 +1321,10 @@ ikvdb_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb **ha
     if (ev(err))
         goto out;
 
-    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++)
+    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         mparams.mclass[i].dio_disable = !params->dio_enable[i];
+        mparams.mclass[i].io_engine = params->io_engine[i];
+    }
 
     err = mpool_open(kvdb_home, &mparams, allow_media_writes ? O_RDWR : O_RDONLY, &self->ikdb_mp);
     if (ev(err))
@@ -2035,6 +2045,14 @@ ikvdb_kvs_open(
         }
     }
 
+    cops = vcomp_compress_ops[params->value.compression.algo];
+    if (!cops) {
+        log_err("value compression algorithm not supported by this build for KVS (%s)", kvs_name);
+        return merr(ENOTSUP);
+    }
+
+    assert(cops->cop_compress && cops->cop_estimate);
+
     mutex_lock(&self->ikdb_lock);
 
     idx = get_kvs_index(self->ikdb_kvs_vec, kvs_name, NULL);
@@ -2054,9 +2072,7 @@ ikvdb_kvs_open(
     kvs->kk_viewset = self->ikdb_cur_viewset;
 
     kvs->kk_vcomp_default = params->value.compression.dflt;
-    cops = vcomp_compress_ops[VCOMP_ALGO_LZ4];
-    assert(cops && cops->cop_compress && cops->cop_estimate);
-
+    kvs->kk_vcomplevel = params->value.compression.level;
     kvs->kk_vcompress = cops->cop_compress;
     kvs->kk_vcompbnd = cops->cop_estimate(NULL, tls_vbufsz);
     kvs->kk_vcompbnd = tls_vbufsz - (kvs->kk_vcompbnd - tls_vbufsz);
@@ -2267,12 +2283,72 @@ is_compression_allowed(const struct kvdb_kvs * const kk, const unsigned int flag
         (kk->kk_vcomp_default == VCOMP_DEFAULT_ON && !(flags & HSE_KVS_PUT_VCOMP_OFF));
 }
 
+/* Large values of kvses that do not compress by default may nonetheless be
+ * compressed to reduce WAL write bandwidth.  Only the logged copy is compressed,
+ * c0 and cn get the value as given (replay decompresses such values, see
+ * ikvdb_wal_replay_put()).
+ */
+static HSE_ALWAYS_INLINE bool
+is_wal_compression_allowed(
+    const struct ikvdb_impl * const self,
+    const unsigned int flags,
+    const uint vlen)
+{
+    const uint32_t vmin = self->ikdb_rp.dur_vcomp_min;
+
+    return vmin > 0 && vlen >= vmin && self->ikdb_wal && !(flags & HSE_KVS_PUT_VCOMP_OFF);
+}
+
 #if CN_SMALL_VALUE_THRESHOLD > 15
 #define VCOMP_VALUE_THRESHOLD (CN_SMALL_VALUE_THRESHOLD)
 #else
 #define VCOMP_VALUE_THRESHOLD (15)
 #endif
 
+/* Compress the value of a put if the kvs compression policy calls for it, in
+ * which case vt is reinitialized to refer to the compressed value in the
+ * returned buffer.  The caller must release the buffer unless it is tls_vbuf.
+ */
+static void *
+ikvdb_kvs_vcompress(
+    struct kvdb_kvs *kk,
+    const unsigned int flags,
+    struct kvs_vtuple *vt,
+    size_t *vbufszp,
+    uint *clenp)
+{
+    uint vlen = kvs_vtuple_vlen(vt);
+    uint clen = kvs_vtuple_clen(vt);
+    size_t vbufsz = tls_vbufsz;
+    void *vbuf = NULL;
+    merr_t err;
+
+    if (clen == 0 && vlen > VCOMP_VALUE_THRESHOLD &&
+        is_compression_allowed(kk, flags)) {
+        if (vlen > kk->kk_vcompbnd) {
+            vbufsz = vlen + PAGE_SIZE * 2;
+            vbuf = vlb_alloc(vbufsz);
+        } else {
+            vbuf = tls_vbuf;
+        }
+
+        if (vbuf) {
+            err = kk->kk_vcompress(vt->vt_data, vlen, vbuf, vbufsz, kk->kk_vcomplevel, &clen);
+
+            /* Save space by storing the original value if the compressed length
+             * is larger than the original length.
+             */
+            if (!err && clen < vlen)
+                kvs_vtuple_cinit(vt, vbuf, vlen, clen);
+        }
+    }
+
+    *vbufszp = vbufsz;
+    *clenp = clen;
+
+    return vbuf;
+}
+
 merr_t
 ikvdb_kvs_put(
     struct hse_kvs *handle,
@@ -2284,11 +2360,11 @@ ikvdb_kvs_put(
     void *vbuf;
     merr_t err;
     size_t vbufsz;
-    uint vlen, clen;
+    uint vlen, clen, wclen;
     uint64_t seqnoref;
     struct kvdb_kvs *kk;
     struct kvs_ktuple ktbuf;
-    struct kvs_vtuple vtbuf;
+    struct kvs_vtuple vtbuf, wvtbuf, *wvt;
     struct ikvdb_impl *parent;
 
     INVARIANT(handle && kt && vt);
@@ -2312,39 +2388,24 @@ ikvdb_kvs_put(
     kt = &ktbuf;
     vt = &vtbuf;
 
+    vbuf = ikvdb_kvs_vcompress(kk, flags, vt, &vbufsz, &clen);
     vlen = kvs_vtuple_vlen(vt);
-    clen = kvs_vtuple_clen(vt);
+    wclen = 0;
+    wvt = NULL;
 
-    vbufsz = tls_vbufsz;
-    vbuf = NULL;
+    if (!vbuf && is_wal_compression_allowed(parent, flags, vlen)) {
+        wvtbuf = vtbuf;
+        wvt = &wvtbuf;
 
-    if (clen == 0 && vlen > VCOMP_VALUE_THRESHOLD && is_compression_allowed(kk, flags)) {
-        if (vlen > kk->kk_vcompbnd) {
-            vbufsz = vlen + PAGE_SIZE * 2;
-            vbuf = vlb_alloc(vbufsz);
-        } else {
-            vbuf = tls_vbuf;
-        }
-
-        if (vbuf) {
-            err = kk->kk_vcompress(vt->vt_data, vlen, vbuf, vbufsz, &clen);
-
-            /* Save space by storing the original value if the compressed length
-             * is larger than the original length.
-             */
-            if (!err && clen < vlen) {
-                kvs_vtuple_cinit(vt, vbuf, vlen, clen);
-                vlen = clen;
-            }
-        }
+        vbuf = ikvdb_kvs_vcompress(kk, HSE_KVS_PUT_VCOMP_ON, wvt, &vbufsz, &wclen);
     }
 
     seqnoref = txn ? 0 : HSE_SQNREF_SINGLE;
 
-    err = kvs_put(kk->kk_ikvs, txn, kt, vt, seqnoref);
+    err = kvs_put(kk->kk_ikvs, txn, kt, vt, wvt, seqnoref, flags & HSE_KVS_PUT_SYNC);
 
     if (vbuf && vbuf != tls_vbuf)
-        vlb_free(vbuf, (vbufsz > VLB_ALLOCSZ_MAX) ? vbufsz : clen);
+        vlb_free(vbuf, (vbufsz > VLB_ALLOCSZ_MAX) ? vbufsz : (clen ? clen : wclen));
 
     if (!(flags & HSE_KVS_PUT_PRIO || parent->ikdb_rp.throttle_disable))
         throttle(parent->ikdb_sensor, &hse_throttle_tls, kt->kt_len + (clen ? clen : vlen));
@@ -2352,6 +2413,63 @@ ikvdb_kvs_put(
     return err;
 }
 
+merr_t
+ikvdb_kvs_merge(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt)
+{
+    struct ikvdb_impl *parent;
+    struct kvs_ktuple ktbuf;
+    struct kvs_vtuple vtbuf;
+    struct kvdb_kvs *kk;
+    merr_t err;
+
+    INVARIANT(handle && kt && vt);
+
+    kk = (struct kvdb_kvs *)handle;
+
+    /* Operands are collapsed without regard to txn visibility, hence
+     * merges are not permitted on transactional kvses.
+     */
+    if (ev(kvs_txn_is_enabled(kk->kk_ikvs)))
+        return merr(EINVAL);
+
+    parent = kk->kk_parent;
+    if (HSE_UNLIKELY(!parent->ikdb_allow_writes))
+        return merr(EROFS);
+
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (err)
+        return err;
+
+    ktbuf = *kt;
+    kvs_vtuple_minit(&vtbuf, (void *)vt->vt_data, kvs_vtuple_vlen(vt));
+
+    err = kvs_put(kk->kk_ikvs, NULL, &ktbuf, &vtbuf, NULL, HSE_SQNREF_SINGLE, false);
+
+    if (!(flags & HSE_KVS_PUT_PRIO || parent->ikdb_rp.throttle_disable))
+        throttle(parent->ikdb_sensor, &hse_throttle_tls, kt->kt_len + kvs_vtuple_vlen(vt));
+
+    return err;
+}
+
+merr_t
+ikvdb_kvs_merge_op_set(struct hse_kvs *handle, hse_kvs_merge_fn *fn)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+
+    INVARIANT(handle);
+
+    if (ev(kvs_txn_is_enabled(kk->kk_ikvs)))
+        return merr(EINVAL);
+
+    cn_set_merge_fn(kvs_cn(kk->kk_ikvs), fn);
+
+    return 0;
+}
+
 merr_t
 ikvdb_kvs_pfx_probe(
     struct hse_kvs *handle,
@@ -2425,6 +2543,70 @@ ikvdb_kvs_get(
     return kvs_get(kk->kk_ikvs, txn, kt, view_seqno, res, vbuf);
 }
 
+merr_t
+ikvdb_kvs_get_many(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    unsigned int keyc,
+    struct kvs_ktuple *ktv,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *p;
+    uint64_t view_seqno;
+
+    if (ev(!handle))
+        return merr(EINVAL);
+
+    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    if (txn) {
+        view_seqno = 0;
+    } else {
+        /* Establish our view before waiting on ongoing commits. */
+        view_seqno = atomic_read(&p->ikdb_seqno);
+        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+    }
+
+    return kvs_get_many(kk->kk_ikvs, txn, keyc, ktv, view_seqno, resv, vbufv);
+}
+
+merr_t
+ikvdb_kvs_get_async(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt,
+    struct cn_get_aio *aio)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *p;
+    uint64_t view_seqno;
+
+    if (ev(!handle || !aio || !aio->cga_cb))
+        return merr(EINVAL);
+
+    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    if (txn) {
+        view_seqno = 0;
+    } else {
+        /* Establish our view before waiting on ongoing commits. */
+        view_seqno = atomic_read(&p->ikdb_seqno);
+        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+    }
+
+    return kvs_get_async(kk->kk_ikvs, txn, kt, view_seqno, aio);
+}
+
 merr_t
 ikvdb_kvs_del(
     struct hse_kvs *handle,
@@ -2620,6 +2802,10 @@ ikvdb_kvs_cursor_create(
         err = kvdb_ctxn_get_view_seqno(ctxn, &vseq);
         if (ev(err))
             return err;
+
+        err = kvs_txn_read_range(kk->kk_ikvs, txn, prefix, pfx_len);
+        if (ev(err))
+            return err;
     }
 
     /* The initialization sequence is driven by the way the sequence
@@ -3039,8 +3225,324 @@ ikvdb_txn_free(struct ikvdb *handle, struct hse_kvdb_txn *txn)
     }
 }
 
+/* A write batch is a buffer of variable length records, each of which is a
+ * header followed by the key and the (possibly compressed) value of a put, or
+ * by just the key of a delete.  Records are padded to keep headers aligned.
+ * The batch keeps a list of the kvses its records refer to, but holds a
+ * reference on them only while it is being applied.
+ */
+struct ikvdb_batch_rec {
+    struct kvdb_kvs *br_kvs;
+    uint64_t br_xlen;
+    uint32_t br_klen;
+    bool br_tomb;
+    char br_data[];
+};
+
+struct ikvdb_batch {
+    struct ikvdb_impl *ib_kvdb;
+    char *ib_buf;
+    size_t ib_len;
+    size_t ib_size;
+    uint ib_cnt;
+    uint ib_kvsc;
+    struct kvdb_kvs *ib_kvsv[HSE_KVS_COUNT_MAX];
+};
+
+static void
+ikvdb_batch_kvs_add(struct ikvdb_batch *b, struct kvdb_kvs *kk)
+{
+    for (uint i = b->ib_kvsc; i > 0; --i) {
+        if (b->ib_kvsv[i - 1] == kk)
+            return;
+    }
+
+    assert(b->ib_kvsc < NELEM(b->ib_kvsv));
+
+    b->ib_kvsv[b->ib_kvsc++] = kk;
+}
+
+/* Take a reference on each kvs in the batch, failing if any of them is
+ * closed.  ikvdb_kvs_close() clears kk_ikvs under the kvdb lock, and then
+ * waits for the references taken before that to be released.
+ */
+static merr_t
+ikvdb_batch_kvs_getref(struct ikvdb_batch *b)
+{
+    uint i;
+
+    mutex_lock(&b->ib_kvdb->ikdb_lock);
+    for (i = 0; i < b->ib_kvsc; ++i) {
+        if (!b->ib_kvsv[i]->kk_ikvs)
+            break;
+
+        atomic_inc(&b->ib_kvsv[i]->kk_refcnt);
+    }
+    mutex_unlock(&b->ib_kvdb->ikdb_lock);
+
+    if (i == b->ib_kvsc)
+        return 0;
+
+    while (i-- > 0)
+        atomic_dec(&b->ib_kvsv[i]->kk_refcnt);
+
+    return merr(EBADF);
+}
+
+static void
+ikvdb_batch_kvs_putref(struct ikvdb_batch *b)
+{
+    for (uint i = 0; i < b->ib_kvsc; ++i)
+        atomic_dec(&b->ib_kvsv[i]->kk_refcnt);
+}
+
+static void
+ikvdb_batch_reset(struct ikvdb_batch *b)
+{
+    b->ib_kvsc = 0;
+    b->ib_len = 0;
+    b->ib_cnt = 0;
+}
+
+static HSE_ALWAYS_INLINE size_t
+ikvdb_batch_rec_sz(uint32_t klen, uint32_t vlen)
+{
+    return ALIGN(sizeof(struct ikvdb_batch_rec) + klen + vlen, __alignof__(struct ikvdb_batch_rec));
+}
+
+static merr_t
+ikvdb_batch_append(
+    struct ikvdb_batch *b,
+    struct kvdb_kvs *kk,
+    const struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt)
+{
+    struct ikvdb_batch_rec *rec;
+    uint32_t vlen;
+    size_t sz;
+
+    vlen = vt ? kvs_vtuple_vlen(vt) : 0;
+    sz = ikvdb_batch_rec_sz(kt->kt_len, vlen);
+
+    if (b->ib_len + sz > b->ib_size) {
+        size_t size;
+        char *buf;
+
+        if (ev(b->ib_len + sz > HSE_KVDB_BATCH_SZ_MAX))
+            return merr(EFBIG);
+
+        size = max_t(size_t, b->ib_size * 2, b->ib_len + sz);
+        size = max_t(size_t, size, PAGE_SIZE);
+        size = min_t(size_t, size, HSE_KVDB_BATCH_SZ_MAX);
+
+        buf = realloc(b->ib_buf, size);
+        if (ev(!buf))
+            return merr(ENOMEM);
+
+        b->ib_buf = buf;
+        b->ib_size = size;
+    }
+
+    ikvdb_batch_kvs_add(b, kk);
+
+    rec = (void *)(b->ib_buf + b->ib_len);
+    rec->br_kvs = kk;
+    rec->br_xlen = vt ? vt->vt_xlen : 0;
+    rec->br_klen = kt->kt_len;
+    rec->br_tomb = !vt;
+
+    memcpy(rec->br_data, kt->kt_data, kt->kt_len);
+    if (vlen > 0)
+        memcpy(rec->br_data + kt->kt_len, vt->vt_data, vlen);
+
+    b->ib_len += sz;
+    b->ib_cnt++;
+
+    return 0;
+}
+
+struct hse_kvdb_batch *
+ikvdb_batch_alloc(struct ikvdb *handle)
+{
+    struct ikvdb_batch *b;
+
+    b = calloc(1, sizeof(*b));
+    if (ev(!b))
+        return NULL;
+
+    b->ib_kvdb = ikvdb_h2r(handle);
+
+    return (struct hse_kvdb_batch *)b;
+}
+
+void
+ikvdb_batch_free(struct ikvdb *handle, struct hse_kvdb_batch *batch)
+{
+    struct ikvdb_batch *b = (struct ikvdb_batch *)batch;
+
+    if (!b)
+        return;
+
+    assert(b->ib_kvdb == ikvdb_h2r(handle));
+
+    ikvdb_batch_reset(b);
+    free(b->ib_buf);
+    free(b);
+}
+
 merr_t
-ikvdb_txn_begin(struct ikvdb *handle, struct hse_kvdb_txn *txn)
+ikvdb_kvs_batch_put(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_batch *b = (struct ikvdb_batch *)batch;
+    struct kvs_vtuple vtbuf;
+    size_t vbufsz;
+    void *vbuf;
+    uint clen;
+    merr_t err;
+
+    INVARIANT(handle && batch && kt && vt);
+
+    /* Batches bypass key locks, hence must not touch transactional kvses.
+     */
+    if (HSE_UNLIKELY(kk->kk_parent != b->ib_kvdb || !is_write_allowed(kk->kk_ikvs, NULL)))
+        return merr(EINVAL);
+
+    vtbuf = *vt;
+
+    vbuf = ikvdb_kvs_vcompress(kk, flags, &vtbuf, &vbufsz, &clen);
+
+    err = ikvdb_batch_append(b, kk, kt, &vtbuf);
+
+    if (vbuf && vbuf != tls_vbuf)
+        vlb_free(vbuf, (vbufsz > VLB_ALLOCSZ_MAX) ? vbufsz : clen);
+
+    return err;
+}
+
+merr_t
+ikvdb_kvs_batch_del(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_batch *batch,
+    struct kvs_ktuple *kt)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_batch *b = (struct ikvdb_batch *)batch;
+
+    INVARIANT(handle && batch && kt);
+
+    if (HSE_UNLIKELY(kk->kk_parent != b->ib_kvdb || !is_write_allowed(kk->kk_ikvs, NULL)))
+        return merr(EINVAL);
+
+    return ikvdb_batch_append(b, kk, kt, NULL);
+}
+
+/* A batch is applied as an anonymous txn borrowed from the txn cache: All its
+ * mutations share one seqnoref and are logged under one WAL txid, such that
+ * they become visible (and are replayed) all together or not at all.  Since
+ * batches are confined to non-transactional kvses no key locks are needed.
+ *
+ * Each mutation is still a WAL record of its own, bracketed by the txn's begin
+ * and commit records, and the apply still reserves a view and a c0snr.  What
+ * a batch saves over a txn is the key locks and the per-key conflict checks.
+ */
+merr_t
+ikvdb_batch_apply(struct ikvdb *handle, const unsigned int flags, struct hse_kvdb_batch *batch)
+{
+    struct ikvdb_impl *self = ikvdb_h2r(handle);
+    struct ikvdb_batch *b = (struct ikvdb_batch *)batch;
+    struct hse_kvdb_txn *txn;
+    struct kvdb_ctxn *ctxn;
+    uintptr_t seqnoref;
+    uint64_t txid;
+    int64_t cookie;
+    size_t off;
+    merr_t err, err2;
+
+    INVARIANT(handle && batch);
+
+    if (ev(b->ib_kvdb != self))
+        return merr(EINVAL);
+
+    if (b->ib_cnt == 0)
+        return 0;
+
+    if (HSE_UNLIKELY(!self->ikdb_allow_writes))
+        return merr(EROFS);
+
+    err = kvdb_health_check(&self->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
+
+    err = ikvdb_batch_kvs_getref(b);
+    if (ev(err))
+        return err;
+
+    txn = ikvdb_txn_alloc(handle);
+    if (ev(!txn)) {
+        ikvdb_batch_kvs_putref(b);
+        return merr(ENOMEM);
+    }
+
+    ctxn = kvdb_ctxn_h2h(txn);
+
+    err = kvdb_ctxn_batch_begin(ctxn, &seqnoref, &txid, &cookie);
+    if (ev(err))
+        goto out;
+
+    for (off = 0; off < b->ib_len && !err;) {
+        struct ikvdb_batch_rec *rec = (void *)(b->ib_buf + off);
+        struct ikvs *ikvs = rec->br_kvs->kk_ikvs;
+        struct kvs_ktuple kt;
+        struct kvs_vtuple vt;
+
+        /* The kvs is being closed (which our reference holds off until
+         * we're done), so the batch must be aborted.
+         */
+        if (ev(!ikvs)) {
+            err = merr(EBADF);
+            break;
+        }
+
+        kvs_ktuple_init_nohash(&kt, rec->br_data, rec->br_klen);
+
+        if (rec->br_tomb) {
+            err = kvs_batch_del(ikvs, &kt, seqnoref, txid, cookie);
+        } else {
+            kvs_vtuple_init(&vt, rec->br_data + rec->br_klen, rec->br_xlen);
+            err = kvs_batch_put(ikvs, &kt, &vt, seqnoref, txid, cookie);
+        }
+
+        off += ikvdb_batch_rec_sz(rec->br_klen, rec->br_tomb ? 0 : kvs_vtuple_vlen(&vt));
+    }
+
+    err2 = kvdb_ctxn_batch_end(ctxn, !err);
+    if (!err)
+        err = err2;
+
+out:
+    ikvdb_txn_free(handle, txn);
+    ikvdb_batch_kvs_putref(b);
+
+    if (ev(err))
+        return err;
+
+    if (!self->ikdb_rp.throttle_disable)
+        throttle(self->ikdb_sensor, &hse_throttle_tls, b->ib_len);
+
+    ikvdb_batch_reset(b);
+
+    return 0;
+}
+
+merr_t
+ikvdb_txn_begin(struct ikvdb *handle, unsigned int flags, struct hse_kvdb_txn *txn)
 {
     struct ikvdb_impl *self = ikvdb_h2r(handle);
     struct kvdb_ctxn *ctxn = kvdb_ctxn_h2h(txn);
@@ -3050,10 +3552,18 @@ ikvdb_txn_begin(struct ikvdb *handle, struct hse_kvdb_txn *txn)
     perfc_inc(&self->ikdb_ctxn_op, PERFC_RA_CTXNOP_BEGIN);
 
     err = kvdb_ctxn_begin(ctxn);
-    if (err)
+    if (err) {
         perfc_dec(&self->ikdb_ctxn_op, PERFC_BA_CTXNOP_ACTIVE);
+        return err;
+    }
 
-    return err;
+    kvdb_ctxn_lock_wait_set(
+        ctxn, (flags & HSE_KVDB_TXN_BEGIN_WAIT) ? self->ikdb_rp.txn_lock_wait_timeout : 0);
+
+    if (flags & HSE_KVDB_TXN_BEGIN_SERIALIZABLE)
+        kvdb_ctxn_serializable_set(ctxn, true);
+
+    return 0;
 }
 
 merr_t
@@ -3099,8 +3609,6 @@ ikvdb_txn_state(struct ikvdb *handle, struct hse_kvdb_txn *txn)
 /* ------------------  WAL replay ikvdb interfaces ---------------- */
 
 struct ikvdb_kvs_hdl {
-    struct kvdb_kvs *kk_prev;
-    uint64_t cnid_prev;
     size_t cache_sz;
     size_t cheap_sz;
     bool needs_reset;
@@ -3170,21 +3678,19 @@ ikvdb_wal_replay_close(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl *ikvsh)
     free(ikvsh);
 }
 
+/* Replay applies records from many threads concurrently, hence the kvs
+ * handle set must not be modified here.
+ */
 static struct kvdb_kvs *
 ikvdb_wal_replay_kvs_get(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid)
 {
     int i;
 
-    if (ikvsh->cnid_prev == cnid)
-        return ikvsh->kk_prev;
-
     for (i = 0; i < ikvsh->kvshc; i++) {
         struct kvdb_kvs *kk = (struct kvdb_kvs *)ikvsh->kvshv[i];
-        if (kk->kk_cnid == cnid) {
-            ikvsh->cnid_prev = cnid;
-            ikvsh->kk_prev = kk;
+
+        if (kk->kk_cnid == cnid)
             return kk;
-        }
     }
 
     return NULL;
@@ -3200,7 +3706,10 @@ ikvdb_wal_replay_put(
     struct kvs_vtuple *vt)
 {
     struct kvdb_kvs *kk;
-    merr_t err;
+    struct kvs_vtuple vtbuf;
+    void *vbuf = NULL;
+    uint vlen, clen, outlen;
+    merr_t err = 0;
 
     assert(ikvdb && ikvsh);
 
@@ -3208,8 +3717,34 @@ ikvdb_wal_replay_put(
     if (ev(!kk))
         return 0; /* Possible that the kvs is dropped just prior to crash */
 
-    err = kvs_put(kk->kk_ikvs, NULL, kt, vt, HSE_ORDNL_TO_SQNREF(seqno));
-    if (!err) /* Update ikdb_seqno if it's lower than "seqno", called from the replay thread */
+    /* Values of kvses that do not compress by default were compressed
+     * for the WAL only (see is_wal_compression_allowed()).
+     */
+    vlen = kvs_vtuple_vlen(vt);
+    clen = kvs_vtuple_clen(vt);
+
+    if (clen > 0 && !is_compression_allowed(kk, 0)) {
+        vbuf = (vlen > tls_vbufsz) ? vlb_alloc(vlen) : tls_vbuf;
+        if (ev(!vbuf))
+            return merr(ENOMEM);
+
+        err = vcomp_decompress(vt->vt_data, clen, vbuf, vlen, &outlen);
+        if (!ev(err) && ev(outlen != vlen))
+            err = merr(EBADMSG);
+
+        if (!err) {
+            kvs_vtuple_init(&vtbuf, vbuf, vlen);
+            vt = &vtbuf;
+        }
+    }
+
+    if (!err)
+        err = kvs_put(kk->kk_ikvs, NULL, kt, vt, NULL, HSE_ORDNL_TO_SQNREF(seqno), false);
+
+    if (vbuf && vbuf != tls_vbuf)
+        vlb_free(vbuf, vlen);
+
+    if (!err) /* Update ikdb_seqno if it's lower than "seqno" */
         ikvdb_wal_replay_seqno_set(ikvdb, seqno);
 
     return err;
@@ -3275,14 +3810,16 @@ void
 ikvdb_wal_replay_seqno_set(struct ikvdb *ikvdb, uint64_t seqno)
 {
     struct ikvdb_impl *self;
+    uint64_t cur;
 
     assert(ikvdb);
 
     self = ikvdb_h2r(ikvdb);
 
-    /* This is called only in a single-threaded replay context */
-    if (seqno > atomic_read(&self->ikdb_seqno))
-        atomic_set(&self->ikdb_seqno, seqno);
+    /* Replay threads race to raise the seqno */
+    cur = atomic_read(&self->ikdb_seqno);
+    while (seqno > cur && !atomic_cmpxchg(&self->ikdb_seqno, &cur, seqno))
+        ; /* cur was reloaded by the failed exchange */
 }
 
 void
@@ -39,6 +39,13 @@
 #define kvdb_ctxn_set_h2r(_ktn_handle) \
     container_of(_ktn_handle, struct kvdb_ctxn_set_impl, ktn_handle)
 
+/* Bounds on the capacity of each of a serializable txn's read sets.  A txn
+ * that reads more keys than fit at half load is validated as having read
+ * the kvs as a whole.
+ */
+#define KVDB_CTXN_RSET_MIN      (64)
+#define KVDB_CTXN_RSET_MAX      (128 * 1024)
+
 struct kvdb_ctxn_set {
 };
 
@@ -55,6 +62,9 @@ struct kvdb_ctxn_set {
  * @ktn_pending:      transactions to be freed when reader thread finishes
  * @ktn_reading:      indicates whether the worker thread is reading the list
  * @ktn_queued:       has the worker thread been queued
+ * @ktn_serializable: number of active serializable transactions
+ * @ktn_unlocked_busy: commits in progress of txns that wrote without kvs locks
+ * @ktn_unlocked_seqno: highest commit seqno of a txn that wrote without kvs locks
  */
 struct kvdb_ctxn_set_impl {
     struct kvdb_ctxn_set     ktn_handle;
@@ -71,6 +81,10 @@ struct kvdb_ctxn_set_impl {
     atomic_int               ktn_reading;
     bool                     ktn_queued;
 
+    atomic_int               ktn_serializable HSE_ACP_ALIGNED;
+    atomic_int               ktn_unlocked_busy;
+    atomic_ulong             ktn_unlocked_seqno;
+
     struct cds_list_head     ktn_alloc_list HSE_ALIGNED(CAA_CACHE_LINE_SIZE);
 };
 
@@ -299,6 +313,89 @@ kvdb_ctxn_set_wait_commits(struct kvdb_ctxn_set *handle, uint64_t head)
         cpu_relax();
 }
 
+/* The read sets are open-addressed (linear probing) hash sets of the hashes
+ * of the keys, prefixes and kvses read by a serializable txn.  Zero marks an
+ * empty slot.
+ */
+static void
+kvdb_ctxn_rset_insert(struct kvdb_ctxn_rset *rs, uint64_t hash)
+{
+    uint32_t mask = rs->rs_max - 1;
+    uint32_t i = hash & mask;
+
+    while (rs->rs_hashv[i]) {
+        if (rs->rs_hashv[i] == hash)
+            return;
+
+        i = (i + 1) & mask;
+    }
+
+    rs->rs_hashv[i] = hash;
+    rs->rs_cnt++;
+}
+
+static bool
+kvdb_ctxn_rset_grow(struct kvdb_ctxn_rset *rs)
+{
+    uint64_t *old = rs->rs_hashv;
+    uint32_t oldmax = rs->rs_max;
+    uint32_t max;
+
+    max = oldmax ? oldmax * 2 : KVDB_CTXN_RSET_MIN;
+    if (max > KVDB_CTXN_RSET_MAX)
+        return false;
+
+    rs->rs_hashv = calloc(max, sizeof(*rs->rs_hashv));
+    if (ev(!rs->rs_hashv)) {
+        rs->rs_hashv = old;
+        return false;
+    }
+
+    rs->rs_max = max;
+    rs->rs_cnt = 0;
+
+    for (uint32_t i = 0; i < oldmax; ++i) {
+        if (old[i])
+            kvdb_ctxn_rset_insert(rs, old[i]);
+    }
+
+    free(old);
+
+    return true;
+}
+
+/* Returns false if hash is zero or the set is full.
+ */
+static bool
+kvdb_ctxn_rset_add(struct kvdb_ctxn_rset *rs, uint64_t hash)
+{
+    if (HSE_UNLIKELY(!hash))
+        return false;
+
+    if (rs->rs_cnt >= rs->rs_max / 2 && !kvdb_ctxn_rset_grow(rs))
+        return false;
+
+    kvdb_ctxn_rset_insert(rs, hash);
+
+    return true;
+}
+
+static void
+kvdb_ctxn_rset_reset(struct kvdb_ctxn_rset *rs)
+{
+    if (rs->rs_cnt > 0) {
+        memset(rs->rs_hashv, 0, rs->rs_max * sizeof(*rs->rs_hashv));
+        rs->rs_cnt = 0;
+    }
+}
+
+static void
+kvdb_ctxn_rset_free(struct kvdb_ctxn_rset *rs)
+{
+    free(rs->rs_hashv);
+    memset(rs, 0, sizeof(*rs));
+}
+
 void
 kvdb_ctxn_free(struct kvdb_ctxn *handle)
 {
@@ -314,6 +411,10 @@ kvdb_ctxn_free(struct kvdb_ctxn *handle)
     assert(!ctxn->ctxn_locks_handle);
     assert(!ctxn->ctxn_pfxlock_handle);
 
+    kvdb_ctxn_rset_free(&ctxn->ctxn_rset_keys);
+    kvdb_ctxn_rset_free(&ctxn->ctxn_rset_pfxs);
+    kvdb_ctxn_rset_free(&ctxn->ctxn_rset_ranges);
+
     kvdb_ctxn_set_remove(ctxn->ctxn_kvdb_ctxn_set, ctxn);
 }
 
@@ -378,6 +479,14 @@ kvdb_ctxn_begin(struct kvdb_ctxn *handle)
     ctxn->ctxn_seqref = HSE_SQNREF_UNDEFINED;
     ctxn->ctxn_bind.b_ctxn = &ctxn->ctxn_inner_handle;
     ctxn->ctxn_expired = false;
+    ctxn->ctxn_lock_wait_ms = 0;
+    ctxn->ctxn_serializable = false;
+    ctxn->ctxn_kvs_unlocked = false;
+    ctxn->ctxn_rset_full = false;
+
+    kvdb_ctxn_rset_reset(&ctxn->ctxn_rset_keys);
+    kvdb_ctxn_rset_reset(&ctxn->ctxn_rset_pfxs);
+    kvdb_ctxn_rset_reset(&ctxn->ctxn_rset_ranges);
 
     err = viewset_insert(
         ctxn->ctxn_viewset, &ctxn->ctxn_view_seqno, &tseqno, &ctxn->ctxn_viewset_cookie);
@@ -392,6 +501,121 @@ errout:
     return err;
 }
 
+void
+kvdb_ctxn_lock_wait_set(struct kvdb_ctxn *handle, uint32_t timeout_ms)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+
+    kvdb_ctxn_lock_impl(ctxn);
+    ctxn->ctxn_lock_wait_ms = timeout_ms;
+    kvdb_ctxn_unlock_impl(ctxn);
+}
+
+void
+kvdb_ctxn_serializable_set(struct kvdb_ctxn *handle, bool serializable)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+    struct kvdb_ctxn_set_impl *kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
+
+    /* Writers take the kvs-wide pfxlocks only while a serializable txn is
+     * active (see kvdb_ctxn_trylock_write()).
+     */
+    kvdb_ctxn_lock_impl(ctxn);
+    if (ctxn->ctxn_viewset_cookie && ctxn->ctxn_serializable != serializable) {
+        if (serializable)
+            atomic_inc(&kcs->ktn_serializable);
+        else
+            atomic_dec(&kcs->ktn_serializable);
+
+        ctxn->ctxn_serializable = serializable;
+    }
+    kvdb_ctxn_unlock_impl(ctxn);
+}
+
+void
+kvdb_ctxn_read_range(struct kvdb_ctxn *handle, uint64_t kvshash, uint64_t pfxhash)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+
+    if (!ctxn->ctxn_serializable || ctxn->ctxn_rset_full)
+        return;
+
+    if (!kvdb_ctxn_rset_add(&ctxn->ctxn_rset_ranges, pfxhash ? pfxhash : kvshash))
+        ctxn->ctxn_rset_full = true;
+}
+
+void
+kvdb_ctxn_read_key(struct kvdb_ctxn *handle, uint64_t kvshash, uint64_t pfxhash, uint64_t hash)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+
+    if (!ctxn->ctxn_serializable || ctxn->ctxn_rset_full)
+        return;
+
+    /* A key that doesn't fit in the read set is validated as a read of
+     * the whole kvs.
+     */
+    if (!kvdb_ctxn_rset_add(&ctxn->ctxn_rset_keys, hash) ||
+        (pfxhash && !kvdb_ctxn_rset_add(&ctxn->ctxn_rset_pfxs, pfxhash)))
+        kvdb_ctxn_read_range(handle, kvshash, 0);
+}
+
+/* Check whether anything read by a serializable txn may have been changed
+ * by another txn since the txn's view was established.  Point reads are
+ * checked against the key locks and against prefix deletes in the pfxlock.
+ * Range reads are checked against the shared pfxlocks that writers take on
+ * the prefix and the kvs of each key they write.  Committed writers retain
+ * both kinds of locks for as long as any txn whose view predates their
+ * commit is active.
+ *
+ * Writers that skipped the kvs-wide locks (as no serializable txn was active
+ * at the time) are invisible to the pfxlock, hence any range read conflicts
+ * with their commits after the view.
+ */
+static bool
+kvdb_ctxn_rset_conflict(struct kvdb_ctxn_impl *ctxn)
+{
+    struct kvdb_ctxn_set_impl *kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
+    struct kvdb_ctxn_pfxlock *kpl = ctxn->ctxn_pfxlock_handle;
+    struct kvdb_pfxlock *pfxlock = ctxn->ctxn_kvdb_pfxlock;
+    const struct kvdb_ctxn_rset *rs;
+    uint64_t view = ctxn->ctxn_view_seqno;
+
+    if (ctxn->ctxn_rset_full)
+        return true;
+
+    rs = &ctxn->ctxn_rset_keys;
+    for (uint32_t i = 0; i < rs->rs_max && rs->rs_cnt > 0; ++i) {
+        uint64_t hash = rs->rs_hashv[i];
+
+        if (hash && kvdb_keylock_read_conflict(ctxn->ctxn_kvdb_keylock, ctxn->ctxn_locks_handle,
+                                               hash, view))
+            return true;
+    }
+
+    rs = &ctxn->ctxn_rset_pfxs;
+    for (uint32_t i = 0; i < rs->rs_max && rs->rs_cnt > 0; ++i) {
+        uint64_t hash = rs->rs_hashv[i];
+
+        if (hash && kvdb_ctxn_pfxlock_read_conflict(pfxlock, kpl, hash, view, false))
+            return true;
+    }
+
+    rs = &ctxn->ctxn_rset_ranges;
+    if (rs->rs_cnt > 0 && (atomic_read_acq(&kcs->ktn_unlocked_busy) > 0 ||
+                           atomic_read(&kcs->ktn_unlocked_seqno) > view))
+        return true;
+
+    for (uint32_t i = 0; i < rs->rs_max && rs->rs_cnt > 0; ++i) {
+        uint64_t hash = rs->rs_hashv[i];
+
+        if (hash && kvdb_ctxn_pfxlock_read_conflict(pfxlock, kpl, hash, view, true))
+            return true;
+    }
+
+    return false;
+}
+
 static void
 kvdb_ctxn_deactivate(struct kvdb_ctxn_impl *ctxn)
 {
@@ -405,6 +629,13 @@ kvdb_ctxn_deactivate(struct kvdb_ctxn_impl *ctxn)
     if (!cookie)
         return;
 
+    if (ctxn->ctxn_serializable) {
+        struct kvdb_ctxn_set_impl *kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
+
+        atomic_dec(&kcs->ktn_serializable);
+        ctxn->ctxn_serializable = false;
+    }
+
     if (ctxn->ctxn_pfxlock_handle) {
         kvdb_ctxn_pfxlock_destroy(ctxn->ctxn_pfxlock_handle);
         ctxn->ctxn_pfxlock_handle = NULL;
@@ -500,6 +731,18 @@ kvdb_ctxn_commit(struct kvdb_ctxn *handle)
     if (err)
         return err;
 
+    /* A serializable txn must validate its reads before it takes a commit
+     * ticket, as every ticket taken must yield a commit record in the WAL.
+     * Write locks are acquired at write time, so of any two conflicting
+     * serializable txns at least one observes the other here.
+     */
+    if (ctxn->ctxn_serializable && kvdb_ctxn_rset_conflict(ctxn)) {
+        kvdb_ctxn_abort_inner(ctxn);
+        kvdb_ctxn_unlock_impl(ctxn);
+
+        return merr(ECANCELED);
+    }
+
     /* If this transaction never wrote anything then the commit path is
      * much simpler. We make our "transaction sequence number" be a
      * reference encoded copy of our view sequence number. We also take
@@ -557,6 +800,13 @@ kvdb_ctxn_commit(struct kvdb_ctxn *handle)
 
     kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
 
+    /* A txn that wrote without the kvs-wide locks announces its commit
+     * before it mints its commit seqno, and publishes the seqno before it
+     * withdraws the announcement (see kvdb_ctxn_rset_conflict()).
+     */
+    if (ctxn->ctxn_kvs_unlocked)
+        atomic_inc_acq(&kcs->ktn_unlocked_busy);
+
     /* Prefetch priv to try and avoid a cache miss whithin the critsec.
      */
     priv = (uintptr_t *)ctxn->ctxn_seqref;
@@ -597,6 +847,15 @@ kvdb_ctxn_commit(struct kvdb_ctxn *handle)
 
     atomic_inc_rel(&kcs->ktn_tseqno_tail); /* release ticket lock */
 
+    if (ctxn->ctxn_kvs_unlocked) {
+        uint64_t sn = atomic_read(&kcs->ktn_unlocked_seqno);
+
+        while (sn < commit_sn && !atomic_cmpxchg(&kcs->ktn_unlocked_seqno, &sn, commit_sn))
+            continue;
+
+        atomic_dec_rel(&kcs->ktn_unlocked_busy);
+    }
+
     /* Once the indirect assignment has been performed the
      * transaction itself no longer needs to see the shared value
      * and instead just puts it into its private area. This is
@@ -631,6 +890,123 @@ kvdb_ctxn_commit(struct kvdb_ctxn *handle)
     return err;
 }
 
+merr_t
+kvdb_ctxn_batch_begin(struct kvdb_ctxn *handle, uintptr_t *seqref, uint64_t *txid, int64_t *cookie)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+    enum kvdb_ctxn_state state;
+    uint64_t tseqno;
+    uintptr_t *priv;
+    merr_t err;
+
+    kvdb_ctxn_lock_impl(ctxn);
+    state = seqnoref_to_state(ctxn->ctxn_seqref);
+
+    if (ev(state != KVDB_CTXN_ABORTED && state != KVDB_CTXN_COMMITTED &&
+           state != KVDB_CTXN_INVALID))
+    {
+        err = merr(EINVAL);
+        goto errout;
+    }
+
+    ctxn->ctxn_begin_ts = get_time_ns();
+    ctxn->ctxn_can_insert = false;
+    ctxn->ctxn_expired = false;
+    ctxn->ctxn_serializable = false;
+    ctxn->ctxn_kvs_unlocked = false;
+
+    /* A batch reads nothing, so its view is needed only to hold back the
+     * WAL reclaim horizon while its records are in flight, and there is
+     * no need to wait for commits in progress.
+     */
+    err = viewset_insert(
+        ctxn->ctxn_viewset, &ctxn->ctxn_view_seqno, &tseqno, &ctxn->ctxn_viewset_cookie);
+    if (ev(err))
+        goto errout;
+
+    err = wal_txn_begin(ctxn->ctxn_wal, ctxn->ctxn_view_seqno, &ctxn->ctxn_wal_cookie);
+    if (ev(err))
+        goto deactivate;
+
+    priv = c0snr_set_get_c0snr(ctxn->ctxn_c0snr_set, &ctxn->ctxn_inner_handle);
+    if (ev(!priv)) {
+        err = merr(ECANCELED);
+        goto deactivate;
+    }
+
+    assert(*priv == HSE_SQNREF_INVALID);
+    *priv = HSE_SQNREF_UNDEFINED;
+
+    ctxn->ctxn_seqref = HSE_REF_TO_SQNREF(priv);
+
+    *seqref = ctxn->ctxn_seqref;
+    *txid = ctxn->ctxn_view_seqno;
+    *cookie = ctxn->ctxn_wal_cookie;
+
+    return 0;
+
+deactivate:
+    kvdb_ctxn_deactivate(ctxn);
+
+errout:
+    kvdb_ctxn_unlock_impl(ctxn);
+
+    return err;
+}
+
+merr_t
+kvdb_ctxn_batch_end(struct kvdb_ctxn *handle, bool commit)
+{
+    struct kvdb_ctxn_impl *ctxn = kvdb_ctxn_h2r(handle);
+    struct kvdb_ctxn_set_impl *kcs;
+    uint64_t head, commit_sn;
+    uintptr_t ref, *priv;
+    merr_t err;
+
+    priv = (uintptr_t *)ctxn->ctxn_seqref;
+
+    assert(HSE_SQNREF_INDIRECT_P(ctxn->ctxn_seqref));
+
+    if (!commit) {
+        *priv = HSE_SQNREF_ABORTED;
+        ctxn->ctxn_seqref = HSE_SQNREF_ABORTED;
+        c0snr_clear_txn(priv);
+
+        err = wal_txn_abort(ctxn->ctxn_wal, ctxn->ctxn_view_seqno, ctxn->ctxn_wal_cookie);
+        goto out;
+    }
+
+    kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
+
+    /* Mint the commit seqno and publish it in commit ticket order, exactly
+     * as kvdb_ctxn_commit() does.  There are no write locks to enqueue, so
+     * the keylock list lock is not needed.
+     */
+    head = atomic_fetch_add(&kcs->ktn_tseqno_head, 1);
+
+    while (atomic_read(&kcs->ktn_tseqno_tail) < head)
+        cpu_relax();
+
+    commit_sn = 1 + atomic_fetch_add(ctxn->ctxn_kvdb_seq_addr, 2);
+
+    ref = HSE_ORDNL_TO_SQNREF(commit_sn);
+    *priv = ref;
+
+    atomic_inc_rel(&kcs->ktn_tseqno_tail);
+
+    ctxn->ctxn_seqref = ref;
+    c0snr_clear_txn(priv);
+
+    err = wal_txn_commit(
+        ctxn->ctxn_wal, ctxn->ctxn_view_seqno, commit_sn, head, ctxn->ctxn_wal_cookie);
+
+out:
+    kvdb_ctxn_deactivate(ctxn);
+    kvdb_ctxn_unlock_impl(ctxn);
+
+    return err;
+}
+
 enum kvdb_ctxn_state
 kvdb_ctxn_get_state(struct kvdb_ctxn *handle)
 {
@@ -836,15 +1212,18 @@ kvdb_ctxn_trylock_write(
     uint64_t *view_seqno,
     int64_t *cookie,
     bool is_ptomb,
+    uint64_t kvshash,
     uint64_t pfxhash,
     uint64_t hash)
 {
+    struct kvdb_ctxn_set_impl *kcs;
     struct kvdb_ctxn_impl *ctxn;
     merr_t err;
 
     assert(handle);
 
     ctxn = kvdb_ctxn_h2r(handle);
+    kcs = kvdb_ctxn_set_h2r(ctxn->ctxn_kvdb_ctxn_set);
 
     err = kvdb_ctxn_trylock_impl(ctxn);
     if (err)
@@ -860,6 +1239,19 @@ kvdb_ctxn_trylock_write(
             goto errout;
     }
 
+    /* Writers hold a shared lock on the kvs as a whole such that serializable
+     * txns can validate the ranges they read (see kvdb_ctxn_rset_conflict()).
+     * Without serializable txns the lock is skipped, and the txn's commit is
+     * tracked instead.
+     */
+    if (atomic_read(&kcs->ktn_serializable) > 0) {
+        err = kvdb_ctxn_pfxlock_shared(ctxn->ctxn_pfxlock_handle, kvshash);
+        if (err)
+            goto errout;
+    } else {
+        ctxn->ctxn_kvs_unlocked = true;
+    }
+
     if (pfxhash) {
         struct kvdb_ctxn_pfxlock *pl = ctxn->ctxn_pfxlock_handle;
 
@@ -870,8 +1262,13 @@ kvdb_ctxn_trylock_write(
     }
 
     if (HSE_LIKELY(!is_ptomb)) {
-        err = kvdb_keylock_lock(
-            ctxn->ctxn_kvdb_keylock, ctxn->ctxn_locks_handle, hash, ctxn->ctxn_view_seqno);
+        if (ctxn->ctxn_lock_wait_ms > 0)
+            err = kvdb_keylock_lock_wait(
+                ctxn->ctxn_kvdb_keylock, ctxn->ctxn_locks_handle, hash, ctxn->ctxn_view_seqno,
+                ctxn->ctxn_lock_wait_ms);
+        else
+            err = kvdb_keylock_lock(
+                ctxn->ctxn_kvdb_keylock, ctxn->ctxn_locks_handle, hash, ctxn->ctxn_view_seqno);
 
         if (err)
             goto errout;
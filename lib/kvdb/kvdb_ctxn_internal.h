@@ -17,6 +17,18 @@
 #define kvdb_ctxn_h2r(_ctxn_handle) \
     container_of(_ctxn_handle, struct kvdb_ctxn_impl, ctxn_inner_handle)
 
+/**
+ * struct kvdb_ctxn_rset - open-addressed (linear probing) hash set of hashes
+ * @rs_cnt:   number of hashes in the set
+ * @rs_max:   capacity of the set (power of 2)
+ * @rs_hashv: slots, zero marks an empty slot
+ */
+struct kvdb_ctxn_rset {
+    uint32_t  rs_cnt;
+    uint32_t  rs_max;
+    uint64_t *rs_hashv;
+};
+
 /**
  * struct kvdb_ctxn_impl -
  * @ctxn_inner_handle:
@@ -37,6 +49,13 @@
  * @ctxn_alloc_link:          used to queue onto KVDB allocated txn list
  * @ctxn_free_link:           used to queue onto the list of txns to be freed
  * @ctxn_abort_link:
+ * @ctxn_lock_wait_ms:        max wait on write conflicts (ms), 0 to fail fast
+ * @ctxn_serializable:        validate the read set at commit
+ * @ctxn_kvs_unlocked:        wrote without holding the kvs-wide pfxlocks
+ * @ctxn_rset_full:           the read set overflowed (conflicts with everything)
+ * @ctxn_rset_keys:           hashes of the keys read
+ * @ctxn_rset_pfxs:           pfxlock hashes of the prefixes of the keys read
+ * @ctxn_rset_ranges:         pfxlock hashes of the prefixes or kvses of the ranges read
  */
 struct kvdb_ctxn_impl {
     struct kvdb_ctxn        ctxn_inner_handle;
@@ -66,6 +85,13 @@ struct kvdb_ctxn_impl {
     struct list_head        ctxn_abort_link;
     uint64_t                ctxn_begin_ts;
     bool                    ctxn_expired;
+    uint32_t                ctxn_lock_wait_ms;
+    bool                    ctxn_serializable;
+    bool                    ctxn_kvs_unlocked;
+    bool                    ctxn_rset_full;
+    struct kvdb_ctxn_rset   ctxn_rset_keys;
+    struct kvdb_ctxn_rset   ctxn_rset_pfxs;
+    struct kvdb_ctxn_rset   ctxn_rset_ranges;
 };
 
 /* clang-format on */
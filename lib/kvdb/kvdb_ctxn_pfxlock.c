@@ -194,6 +194,27 @@ kvdb_ctxn_pfxlock_seqno_pub(struct kvdb_ctxn_pfxlock *ktp, uint64_t end_seqno)
     }
 }
 
+bool
+kvdb_ctxn_pfxlock_read_conflict(
+    struct kvdb_pfxlock            *pfxlock,
+    struct kvdb_ctxn_pfxlock       *ktp,
+    uint64_t                        hash,
+    uint64_t                        view_seqno,
+    bool                            range)
+{
+    struct kvdb_ctxn_pfxlock_entry *entry = NULL;
+    struct rb_node                **link, *parent;
+    void                           *cookie = NULL;
+
+    if (ktp) {
+        link = kvdb_ctxn_pfxlock_lookup(ktp, hash, &parent, &entry);
+        if (*link)
+            cookie = entry->ktpe_cookie;
+    }
+
+    return kvdb_pfxlock_read_conflict(pfxlock, hash, view_seqno, range, cookie);
+}
+
 merr_t
 kvdb_ctxn_pfxlock_init(void)
 {
@@ -6,6 +6,7 @@
 #ifndef HSE_KVDB_PFXLOCK_H
 #define HSE_KVDB_PFXLOCK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <hse/error/merr.h>
@@ -39,4 +40,13 @@ kvdb_ctxn_pfxlock_excl(struct kvdb_ctxn_pfxlock *kpl, uint64_t hash);
 void
 kvdb_ctxn_pfxlock_seqno_pub(struct kvdb_ctxn_pfxlock *kpl, uint64_t end_seqno);
 
+/* See kvdb_pfxlock_read_conflict(), kpl is the reader's (may be NULL) */
+bool
+kvdb_ctxn_pfxlock_read_conflict(
+    struct kvdb_pfxlock *kvdb_pfxlock,
+    struct kvdb_ctxn_pfxlock *kpl,
+    uint64_t hash,
+    uint64_t view_seqno,
+    bool range);
+
 #endif
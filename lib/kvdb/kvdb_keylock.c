@@ -15,14 +15,17 @@
 #include <hse/util/assert.h>
 #include <hse/util/atomic.h>
 #include <hse/util/compiler.h>
+#include <hse/util/condvar.h>
 #include <hse/util/cursor_heap.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/keylock.h>
+#include <hse/util/minmax.h>
 #include <hse/util/mutex.h>
 #include <hse/util/page.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
 #include <hse/util/spinlock.h>
+#include <hse/util/time.h>
 #include <hse/util/vlb.h>
 #include <hse/util/xrand.h>
 
@@ -35,6 +38,8 @@
 #define KVDB_DLOCK_MAX              (4) /* Must be power-of-2 */
 #define CTXN_LOCKS_IMPL_CACHE_SZ    (1024 + HSE_ACP_LINESIZE)
 #define CTXN_LOCKS_SLAB_CACHE_SZ    (16 * 1024 - HSE_ACP_LINESIZE)
+#define KVDB_WAITQ_MAX              (64) /* Must be power-of-2 */
+#define KVDB_WAITFOR_MAX            (1024)
 
 struct kvdb_keylock {
 };
@@ -42,15 +47,19 @@ struct kvdb_keylock {
 #define kvdb_keylock_h2r(handle) \
     container_of(handle, struct kvdb_keylock_impl, kl_handle)
 
+struct kvdb_keylock_impl;
+
 /**
  * struct kvdb_dlock - per-cpu deferred lock list head
  * @kd_lock:    list lock
  * @kd_list:    list of deferred locks, sorted by minimum view seqno
+ * @kd_klock:   kvdb keylock to which this dlock belongs
  * @kd_mvs:     most recently expired minimum view seqno
  */
 struct kvdb_dlock {
     struct mutex     kd_lock  HSE_ACP_ALIGNED;
     struct list_head kd_list;
+    struct kvdb_keylock_impl *kd_klock;
     volatile uint64_t kd_mvs   HSE_L1D_ALIGNED;
 };
 
@@ -62,12 +71,21 @@ struct kvdb_dlock {
  * @kl_num_entries:        max number of entries (across all tables)
  * @kl_entries_per_txn:    number of entries that can be locked by a txn
  * @kl_perfc_set:
+ * @kl_wait_lock:          protects the wait queues and the wait-for graph
+ * @kl_waiters:            number of txns waiting on a lock
+ * @kl_waitl:              list of all waiters (the wait-for graph)
+ * @kl_waitqv:             waiters hashed by the hash of the key they want
  * @kl_keylock:            vector of ptrs to keylock objects
  */
 struct kvdb_keylock_impl {
     struct kvdb_keylock kl_handle;
     struct kvdb_dlock   kl_dlockv[KVDB_DLOCK_MAX];
 
+    struct mutex     kl_wait_lock HSE_L1D_ALIGNED;
+    atomic_int       kl_waiters;
+    struct list_head kl_waitl;
+    struct list_head kl_waitqv[KVDB_WAITQ_MAX];
+
     uint64_t         kl_num_entries;
     uint32_t         kl_entries_per_txn;
     uint32_t         kl_num_tables;
@@ -75,6 +93,24 @@ struct kvdb_keylock_impl {
     struct keylock * kl_keylock[];
 };
 
+/**
+ * struct kvdb_keylock_waiter - a txn waiting for a key lock (on its stack)
+ * @klw_link:       wait queue linkage (kl_waitqv[])
+ * @klw_wlink:      wait-for graph linkage (kl_waitl)
+ * @klw_cv:         the waiter sleeps here until a holder of klw_hash finishes
+ * @klw_hash:       hash of the key the waiter wants
+ * @klw_desc:       desc of the waiter's lock container
+ * @klw_waitfor:    desc of the txn the waiter waits on (UINT32_MAX if none)
+ */
+struct kvdb_keylock_waiter {
+    struct list_head klw_link;
+    struct list_head klw_wlink;
+    struct cv        klw_cv;
+    uint64_t         klw_hash;
+    uint32_t         klw_desc;
+    uint32_t         klw_waitfor;
+};
+
 struct kvdb_ctxn_locks {
 };
 
@@ -115,6 +151,7 @@ struct ctxn_locks_slab {
  * @ctxn_locks_handle:       handle for kvdb_ctxn_locks struct
  * @ctxn_locks_link:         element to link onto the deferred_locks list
  * @ctxn_locks_end_seqno:    end seqno of the transaction
+ * @ctxn_locks_desc:         owner ID of the locks in the keylock tables
  * @ctxn_locks_magic:        used to detect use-after-free
  * @ctxn_locks_cnt:          number of write locks in this container
  * @ctxn_locks_entries:      linked list of all entries sorted by slab
@@ -182,9 +219,17 @@ kvdb_keylock_create(struct kvdb_keylock **handle_out, uint32_t num_tables)
     for (i = 0; i < KVDB_DLOCK_MAX; ++i) {
         mutex_init(&klock->kl_dlockv[i].kd_lock);
         INIT_LIST_HEAD(&klock->kl_dlockv[i].kd_list);
+        klock->kl_dlockv[i].kd_klock = klock;
         klock->kl_dlockv[i].kd_mvs = UINT64_MAX;
     }
 
+    mutex_init(&klock->kl_wait_lock);
+    atomic_set(&klock->kl_waiters, 0);
+    INIT_LIST_HEAD(&klock->kl_waitl);
+
+    for (i = 0; i < KVDB_WAITQ_MAX; ++i)
+        INIT_LIST_HEAD(&klock->kl_waitqv[i]);
+
     for (i = 0; i < num_tables; i++) {
         err = keylock_create(kvdb_ctxn_lock_inherit, &klock->kl_keylock[i]);
         if (ev(err)) {
@@ -237,9 +282,37 @@ kvdb_keylock_destroy(struct kvdb_keylock *handle)
     for (i = 0; i < klock->kl_num_tables; i++)
         keylock_destroy(klock->kl_keylock[i]);
 
+    assert(list_empty(&klock->kl_waitl));
+    mutex_destroy(&klock->kl_wait_lock);
+
     free(klock);
 }
 
+/* Wake the txns waiting for the lock on hash such that they may recheck its
+ * state (e.g., after its holder committed or released it).  Holders must call
+ * this after they commit or unlock and before their lock container may be
+ * freed, which lets a waiter read the state of the holder it found in the
+ * keylock for as long as it holds kl_wait_lock.
+ */
+static void
+kvdb_keylock_wake(struct kvdb_keylock_impl *klock, uint64_t hash)
+{
+    struct kvdb_keylock_waiter *waiter;
+    struct list_head *waitq;
+
+    if (atomic_read(&klock->kl_waiters) == 0)
+        return;
+
+    waitq = klock->kl_waitqv + (hash % KVDB_WAITQ_MAX);
+
+    mutex_lock(&klock->kl_wait_lock);
+    list_for_each_entry(waiter, waitq, klw_link) {
+        if (waiter->klw_hash == hash)
+            cv_signal(&waiter->klw_cv);
+    }
+    mutex_unlock(&klock->kl_wait_lock);
+}
+
 void
 kvdb_keylock_perfc_init(struct kvdb_keylock *handle, struct perfc_set *perfc_set)
 {
@@ -276,11 +349,19 @@ kvdb_keylock_enqueue_locks(struct kvdb_ctxn_locks *handle, uint64_t end_seqno, v
     struct kvdb_ctxn_locks_impl *locks = kvdb_ctxn_locks_h2r(handle);
     struct kvdb_dlock *dlock = cookie;
     struct kvdb_ctxn_locks_impl *elem;
+    struct ctxn_locks_entry *entry;
 
     assert(dlock && locks->ctxn_locks_cnt > 0);
 
     locks->ctxn_locks_end_seqno = end_seqno;
 
+    /* Waiters for our locks may now inherit them or give up.
+     */
+    if (atomic_read(&dlock->kd_klock->kl_waiters) > 0) {
+        for (entry = locks->ctxn_locks_entries; entry; entry = entry->lte_next)
+            kvdb_keylock_wake(dlock->kd_klock, entry->lte_hash);
+    }
+
     /* The correct position is more likely toward the end of the list, so
      * traverse in reverse.
      */
@@ -304,7 +385,8 @@ void
 kvdb_keylock_prune_own_locks(struct kvdb_keylock *kl_handle, struct kvdb_ctxn_locks *locks_handle)
 {
     struct kvdb_ctxn_locks_impl *locks = kvdb_ctxn_locks_h2r(locks_handle);
-    struct keylock **keylockv = kvdb_keylock_h2r(kl_handle)->kl_keylock;
+    struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(kl_handle);
+    struct keylock **keylockv = klock->kl_keylock;
     struct ctxn_locks_entry *inherited, *entry;
     int64_t cnt;
     uint32_t desc;
@@ -324,6 +406,7 @@ kvdb_keylock_prune_own_locks(struct kvdb_keylock *kl_handle, struct kvdb_ctxn_lo
         }
 
         keylock_unlock(keylockv[entry->lte_tindex], entry->lte_hash, desc);
+        kvdb_keylock_wake(klock, entry->lte_hash);
         cnt--;
     }
 
@@ -446,13 +529,14 @@ kvdb_keylock_release_locks(struct kvdb_keylock *kl_handle, struct kvdb_ctxn_lock
     cnt = locks->ctxn_locks_cnt;
 
     if (cnt > 0) {
-        struct keylock **keylockv = kvdb_keylock_h2r(kl_handle)->kl_keylock;
+        struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(kl_handle);
         struct ctxn_locks_entry *entry;
 
         while ((entry = locks->ctxn_locks_entries)) {
             locks->ctxn_locks_entries = entry->lte_next;
 
-            keylock_unlock(keylockv[entry->lte_tindex], entry->lte_hash, desc);
+            keylock_unlock(klock->kl_keylock[entry->lte_tindex], entry->lte_hash, desc);
+            kvdb_keylock_wake(klock, entry->lte_hash);
             cnt--;
         }
     }
@@ -472,24 +556,13 @@ kvdb_keylock_release_locks(struct kvdb_keylock *kl_handle, struct kvdb_ctxn_lock
     slab->cls_entryc = 0;
 }
 
-/**
- * kvdb_keylock_lock() - lock an entry in the KVDB keylock and add it to the
- * transaction's container of acquired write locks.
- *
- * @hklock:         handle to the KVDB keylock
- * @hlocks:         handle to the KVDB ctxn locks
- * @hash:           hash of the key
- * @start_seq:      starting sequence number of the entity requesting the lock
- */
-merr_t
-kvdb_keylock_lock(
-    struct kvdb_keylock *hklock,
-    struct kvdb_ctxn_locks *hlocks,
+static merr_t
+kvdb_keylock_trylock(
+    struct kvdb_keylock_impl *klock,
+    struct kvdb_ctxn_locks_impl *locks,
     uint64_t hash,
     uint64_t start_seq)
 {
-    struct kvdb_ctxn_locks_impl *locks = kvdb_ctxn_locks_h2r(hlocks);
-    struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(hklock);
     struct ctxn_locks_entry *entry;
     struct ctxn_locks_slab *slab;
     struct rb_node **link, *parent;
@@ -577,14 +650,194 @@ kvdb_keylock_lock(
         rb_insert_color(&entry->lte_node, tree);
 
     } else {
+        slab->cls_entryc--;
+    }
+
+    return err;
+}
+
+/**
+ * kvdb_keylock_lock() - lock an entry in the KVDB keylock and add it to the
+ * transaction's container of acquired write locks.
+ *
+ * @hklock:         handle to the KVDB keylock
+ * @hlocks:         handle to the KVDB ctxn locks
+ * @hash:           hash of the key
+ * @start_seq:      starting sequence number of the entity requesting the lock
+ */
+merr_t
+kvdb_keylock_lock(
+    struct kvdb_keylock *hklock,
+    struct kvdb_ctxn_locks *hlocks,
+    uint64_t hash,
+    uint64_t start_seq)
+{
+    struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(hklock);
+    merr_t err;
+
+    err = kvdb_keylock_trylock(klock, kvdb_ctxn_locks_h2r(hlocks), hash, start_seq);
+    if (err)
         perfc_inc(&klock->kl_perfc_set, PERFC_RA_CTXNOP_LOCKFAIL);
 
-        slab->cls_entryc--;
+    return err;
+}
+
+/* Follow the wait-for graph from the txn identified by holder.  Each txn
+ * waits on at most one other txn, and every edge is added under
+ * kl_wait_lock after this check, hence the graph is acyclic and the
+ * walk finds self only if waiting on holder would close a cycle.
+ * Overly long chains are conservatively treated as a deadlock.
+ *
+ * The edges live in the waiters' records on kl_waitl (not in the lock
+ * containers, which may be freed at any time), hence the caller must
+ * hold kl_wait_lock.
+ */
+static bool
+kvdb_keylock_deadlock(struct kvdb_keylock_impl *klock, uint32_t self, uint32_t holder)
+{
+    struct kvdb_keylock_waiter *waiter;
+    int i;
+
+    for (i = 0; i < KVDB_WAITFOR_MAX && holder != UINT32_MAX; ++i) {
+        uint32_t waitfor = UINT32_MAX;
+
+        if (holder == self)
+            return true;
+
+        list_for_each_entry(waiter, &klock->kl_waitl, klw_wlink) {
+            if (waiter->klw_desc == holder) {
+                waitfor = waiter->klw_waitfor;
+                break;
+            }
+        }
+
+        holder = waitfor;
+    }
+
+    return holder != UINT32_MAX;
+}
+
+merr_t
+kvdb_keylock_lock_wait(
+    struct kvdb_keylock *hklock,
+    struct kvdb_ctxn_locks *hlocks,
+    uint64_t hash,
+    uint64_t start_seq,
+    uint32_t timeout_ms)
+{
+    struct kvdb_ctxn_locks_impl *locks = kvdb_ctxn_locks_h2r(hlocks);
+    struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(hklock);
+    struct kvdb_keylock_waiter waiter;
+    struct keylock *keylock;
+    uint64_t deadline, now;
+    merr_t err;
+
+    err = kvdb_keylock_trylock(klock, locks, hash, start_seq);
+    if (!err || merr_errno(err) != ECANCELED || timeout_ms == 0)
+        goto out;
+
+    perfc_inc(&klock->kl_perfc_set, PERFC_RA_CTXNOP_LOCKWAIT);
+
+    keylock = klock->kl_keylock[hash % klock->kl_num_tables];
+    deadline = get_time_ns() + (uint64_t)timeout_ms * (NSEC_PER_SEC / MSEC_PER_SEC);
+
+    cv_init(&waiter.klw_cv);
+    waiter.klw_hash = hash;
+    waiter.klw_desc = locks->ctxn_locks_desc;
+    waiter.klw_waitfor = UINT32_MAX;
+
+    mutex_lock(&klock->kl_wait_lock);
+    atomic_inc(&klock->kl_waiters);
+    list_add_tail(&waiter.klw_link, klock->kl_waitqv + (hash % KVDB_WAITQ_MAX));
+    list_add_tail(&waiter.klw_wlink, &klock->kl_waitl);
+
+    while (1) {
+        uint64_t end_seqno;
+        uint32_t holder;
+
+        /* Retry with kl_wait_lock held such that a holder which finishes
+         * after this attempt cannot wake us before we are asleep.  The
+         * keylock lets us inherit the lock from a holder that committed
+         * before our view, i.e., if our view is still valid.
+         */
+        err = kvdb_keylock_trylock(klock, locks, hash, start_seq);
+        if (!err || merr_errno(err) != ECANCELED)
+            break;
+
+        /* No holder means the keylock table is full (or the lock was
+         * released just now), either way we fail as if not waiting.
+         */
+        if (!keylock_owner(keylock, hash, &holder))
+            break;
+
+        /* The holder cannot free its lock container while we hold
+         * kl_wait_lock (see kvdb_keylock_wake()).  Once it has committed
+         * after our view the key has a newer version than we can see,
+         * so there is no point in waiting (unless its locks just now
+         * became inheritable).
+         */
+        end_seqno = kvdb_ctxn_locks_end_seqno(holder);
+        if (end_seqno != UINT64_MAX) {
+            if (start_seq > end_seqno)
+                continue;
+            break;
+        }
+
+        if (kvdb_keylock_deadlock(klock, waiter.klw_desc, holder)) {
+            perfc_inc(&klock->kl_perfc_set, PERFC_RA_CTXNOP_DEADLOCK);
+            break;
+        }
+
+        now = get_time_ns();
+        if (now >= deadline)
+            break;
+
+        waiter.klw_waitfor = holder;
+        cv_timedwait_ns(&waiter.klw_cv, &klock->kl_wait_lock, deadline - now, "kvdbklw");
+        waiter.klw_waitfor = UINT32_MAX;
     }
 
+    list_del(&waiter.klw_wlink);
+    list_del(&waiter.klw_link);
+    atomic_dec(&klock->kl_waiters);
+    mutex_unlock(&klock->kl_wait_lock);
+
+    cv_destroy(&waiter.klw_cv);
+
+out:
+    if (err)
+        perfc_inc(&klock->kl_perfc_set, PERFC_RA_CTXNOP_LOCKFAIL);
+
     return err;
 }
 
+bool
+kvdb_keylock_read_conflict(
+    struct kvdb_keylock *hklock,
+    struct kvdb_ctxn_locks *hlocks,
+    uint64_t hash,
+    uint64_t view_seqno)
+{
+    struct kvdb_keylock_impl *klock = kvdb_keylock_h2r(hklock);
+    struct keylock *keylock;
+    uint32_t owner;
+
+    keylock = klock->kl_keylock[hash % klock->kl_num_tables];
+
+    if (!keylock_owner(keylock, hash, &owner))
+        return false;
+
+    if (hlocks && owner == kvdb_ctxn_locks_h2r(hlocks)->ctxn_locks_desc)
+        return false;
+
+    /* A committed writer's locks are retained for as long as any txn whose
+     * view predates the commit is active, hence a write lock still held
+     * for the key is all the evidence there is of a newer version.  An
+     * active holder (end seqno UINT64_MAX) may yet commit ahead of us.
+     */
+    return kvdb_ctxn_locks_end_seqno(owner) > view_seqno;
+}
+
 struct kvdb_ctxn_locks *
 kvdb_ctxn_locks_desc2locks(uint32_t desc)
 {
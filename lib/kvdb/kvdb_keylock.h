@@ -6,6 +6,7 @@
 #ifndef HSE_KVDB_KEYLOCK_H
 #define HSE_KVDB_KEYLOCK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <hse/error/merr.h>
@@ -43,6 +44,48 @@ kvdb_keylock_lock(
     uint64_t hash,
     uint64_t start_seq);
 
+/**
+ * kvdb_keylock_lock_wait() - like kvdb_keylock_lock(), but on conflict with
+ *                            an active txn wait for it to finish
+ * @hklock:     handle to the KVDB keylock
+ * @hlocks:     handle to the KVDB ctxn locks
+ * @hash:       hash of the key
+ * @start_seq:  view seqno of the txn requesting the lock
+ * @timeout_ms: max time to wait (ms)
+ *
+ * The lock is acquired if within %timeout_ms the holder aborts, or commits
+ * before %start_seq such that the waiter may inherit it.  Fails with ECANCELED
+ * if the holder commits after %start_seq (the key then has a version newer
+ * than the waiter's view), on timeout, or if waiting would deadlock.  Waiters
+ * sleep until a holder of %hash finishes, holders wake only the waiters for
+ * the keys they lock.
+ */
+merr_t
+kvdb_keylock_lock_wait(
+    struct kvdb_keylock *hklock,
+    struct kvdb_ctxn_locks *hlocks,
+    uint64_t hash,
+    uint64_t start_seq,
+    uint32_t timeout_ms);
+
+/**
+ * kvdb_keylock_read_conflict() - check whether a key read by a txn may have
+ *                                been written by another txn since its view
+ * @hklock:     handle to the KVDB keylock
+ * @hlocks:     handle to the reader's ctxn locks (may be NULL)
+ * @hash:       hash of the key
+ * @view_seqno: view seqno of the reader
+ *
+ * Return: true if the write lock for %hash is held by another txn which is
+ * either active or committed after %view_seqno.
+ */
+bool
+kvdb_keylock_read_conflict(
+    struct kvdb_keylock *hklock,
+    struct kvdb_ctxn_locks *hlocks,
+    uint64_t hash,
+    uint64_t view_seqno);
+
 merr_t
 kvdb_ctxn_locks_init(void) HSE_COLD;
 
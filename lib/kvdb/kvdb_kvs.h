@@ -25,6 +25,7 @@ struct kvdb_kvs;
  * @kk_ikvs:         kvs handle. NULL if closed.
  * @kk_parent:       pointer to parent kvdb_impl instance.
  * @kk_vcompbnd:     compression output buffer size estimate for tls_vbuf[]
+ * @kk_vcomplevel:   value compression level
  * @kk_vcompress:    ptr to value compression function
  * @kk_cnid:         id of the cn associated with kvdb.
  * @kk_cparams:      cn's create-time parameters.
@@ -39,6 +40,7 @@ struct kvdb_kvs {
     struct ikvdb_impl *kk_parent;
     enum vcomp_default kk_vcomp_default;
     uint32_t kk_vcompbnd;
+    int32_t kk_vcomplevel;
     compress_op_compress_t *kk_vcompress;
     uint64_t kk_cnid;
     struct kvs_cparams *kk_cparams;
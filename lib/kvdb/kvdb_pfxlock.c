@@ -490,6 +490,54 @@ kvdb_pfxlock_seqno_pub(struct kvdb_pfxlock *pfxlock, uint64_t end_seqno, void *c
     mutex_unlock(&tree->kplt_lock);
 }
 
+bool
+kvdb_pfxlock_read_conflict(
+    struct kvdb_pfxlock *pfxlock,
+    uint64_t hash,
+    uint64_t view_seqno,
+    bool range,
+    void *cookie)
+{
+    uint start = kvdb_pfxlock_hash2treeidx(hash, false);
+    bool conflict = false;
+
+    /* Nobody else can have written under a prefix we hold exclusively,
+     * as we could not have acquired it had they committed after our view.
+     */
+    if (cookie && kvdb_pfxlock_cookie_isexcl(cookie))
+        return false;
+
+    /* A shared lock may reside in any tree within the range.
+     */
+    for (uint i = start; i < start + KVDB_PFXLOCK_RANGE_MAX && !conflict; ++i) {
+        struct kvdb_pfxlock_tree *tree = pfxlock->kpl_tree + i;
+        struct kvdb_pfxlock_entry *entry;
+        struct rb_node *node;
+
+        mutex_lock(&tree->kplt_lock);
+        node = tree->kplt_root.rb_node;
+
+        while (node) {
+            entry = rb_entry(node, typeof(*entry), kple_node);
+
+            if (hash == entry->kple_hash) {
+                int others = entry->kple_refcnt - (entry == cookie ? 1 : 0);
+
+                conflict = entry->kple_excl || view_seqno <= entry->kple_end_seqno_excl;
+
+                if (range)
+                    conflict = conflict || others > 0 || view_seqno <= entry->kple_end_seqno;
+                break;
+            }
+
+            node = (hash < entry->kple_hash) ? node->rb_left : node->rb_right;
+        }
+        mutex_unlock(&tree->kplt_lock);
+    }
+
+    return conflict;
+}
+
 /* Garbage Collection
  */
 void
@@ -6,6 +6,7 @@
 #ifndef HSE_KVDB_PFX_RMLOCK_H
 #define HSE_KVDB_PFX_RMLOCK_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <hse/error/merr.h>
@@ -80,6 +81,27 @@ kvdb_pfxlock_excl(
 void
 kvdb_pfxlock_seqno_pub(struct kvdb_pfxlock *pfx_lock, uint64_t end_seqno, void *cookie);
 
+/**
+ * kvdb_pfxlock_read_conflict() - check whether a txn may have written under
+ *                                a prefix since a reader's view
+ * @pfx_lock:   kvdb_pfxlock object
+ * @hash:       hash of pfx
+ * @view_seqno: view seqno of the reader
+ * @range:      true if the reader read a range of keys under pfx
+ * @cookie:     the reader's own lock handle for pfx (may be NULL)
+ *
+ * A point read conflicts with a prefix delete of pfx by another txn that
+ * is active or committed at or after %view_seqno.  A range read moreover
+ * conflicts with any such writer of a key under pfx.
+ */
+bool
+kvdb_pfxlock_read_conflict(
+    struct kvdb_pfxlock *pfx_lock,
+    uint64_t hash,
+    uint64_t view_seqno,
+    bool range,
+    void *cookie);
+
 #if HSE_MOCKING
 #include "kvdb_pfxlock_ut.h"
 #endif /* HSE_MOCKING */
@@ -605,6 +605,76 @@ kvdb_open_mode_jsonify(const struct param_spec * const ps, const void * const va
     return cJSON_CreateString(kvdb_mode_to_string(*((enum kvdb_open_mode *)value)));
 }
 
+static bool HSE_NONNULL(1, 2, 3)
+io_engine_converter(const struct param_spec * const ps, const cJSON * const node, void * const data)
+{
+    const char *value;
+
+    assert(ps);
+    assert(node);
+    assert(data);
+
+    if (!cJSON_IsString(node))
+        return false;
+
+    value = cJSON_GetStringValue(node);
+    if (!strcmp(value, "sync")) {
+        *(enum mpool_io_engine *)data = MPOOL_IO_ENGINE_SYNC;
+    } else if (!strcmp(value, "io_uring")) {
+        *(enum mpool_io_engine *)data = MPOOL_IO_ENGINE_URING;
+    } else {
+        log_err("Invalid value: %s, must be one of sync or io_uring", value);
+        return false;
+    }
+
+    return true;
+}
+
+static const char *
+io_engine_name(enum mpool_io_engine engine)
+{
+    switch (engine) {
+    case MPOOL_IO_ENGINE_SYNC:
+        return "sync";
+    case MPOOL_IO_ENGINE_URING:
+        return "io_uring";
+    default:
+        abort();
+    }
+}
+
+static merr_t
+io_engine_stringify(
+    const struct param_spec * const ps,
+    const void * const value,
+    char * const buf,
+    const size_t buf_sz,
+    size_t * const needed_sz)
+{
+    int n;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    n = snprintf(buf, buf_sz, "\"%s\"", io_engine_name(*(enum mpool_io_engine *)value));
+    if (n < 0)
+        return merr(EBADMSG);
+
+    if (needed_sz)
+        *needed_sz = n;
+
+    return 0;
+}
+
+static cJSON *HSE_NONNULL(1, 2)
+io_engine_jsonify(const struct param_spec * const ps, const void * const value)
+{
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    return cJSON_CreateString(io_engine_name(*(enum mpool_io_engine *)value));
+}
+
 static const struct param_spec pspecs[] = {
     {
         .ps_name = "mode",
@@ -747,6 +817,27 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "txn_lock_wait_timeout",
+        .ps_description = "max time (ms) a waiting transaction blocks on a write conflict",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvdb_rparams, txn_lock_wait_timeout),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, txn_lock_wait_timeout),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 1000,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = 1000 * 60,
+            },
+        },
+    },
     {
         .ps_name = "cndb_compact_hwm_pct",
         .ps_description = "CNDB compaction high water mark percentage",
@@ -1248,6 +1339,63 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "durability.group_commit.enabled",
+        .ps_description = "Coalesce concurrent sync requests into one write and flush per epoch",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvdb_rparams, dur_gc_enable),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, dur_gc_enable),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_bool = false,
+        },
+    },
+    {
+        .ps_name = "durability.group_commit.max_wait_us",
+        .ps_description = "Max time (us) a group commit epoch waits for more sync requests",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvdb_rparams, dur_gc_wait_us),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, dur_gc_wait_us),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = HSE_WAL_GC_WAIT_US_DFLT,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = HSE_WAL_GC_WAIT_US_MIN,
+                .ps_max = HSE_WAL_GC_WAIT_US_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "durability.compression.min_value_bytes",
+        .ps_description = "Min length of values compressed before logging (0 disables)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvdb_rparams, dur_vcomp_min),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, dur_vcomp_min),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = HSE_WAL_VCOMP_MIN_DFLT,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = HSE_WAL_VCOMP_MIN_MAX,
+            },
+        },
+    },
     {
         .ps_name = "throttle_disable",
         .ps_description = "disable sleep throttle",
@@ -1452,6 +1600,27 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "c0_ingest_build_threads",
+        .ps_description = "max number of threads building the kvsets of c0 ingests",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvdb_rparams, c0_ingest_build_threads),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, c0_ingest_build_threads),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = HSE_C0_INGEST_BUILD_THREADS_DFLT,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = HSE_C0_INGEST_BUILD_THREADS_MIN,
+                .ps_max = HSE_C0_INGEST_BUILD_THREADS_MAX,
+            },
+        },
+    },
     {
         .ps_name = "cn_maint_threads",
         .ps_description = "max number of cn maintenance threads",
@@ -1580,6 +1749,69 @@ static const struct param_spec pspecs[] = {
             .as_uscalar = true,
         },
     },
+    {
+        .ps_name = "storage.capacity.io_engine",
+        .ps_description = "I/O engine for capacity mclass data (sync or io_uring)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_CAPACITY]),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, io_engine[HSE_MCLASS_CAPACITY]),
+        .ps_convert = io_engine_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = io_engine_stringify,
+        .ps_jsonify = io_engine_jsonify,
+        .ps_default_value = {
+            .as_enum = MPOOL_IO_ENGINE_SYNC,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = MPOOL_IO_ENGINE_MIN,
+                .ps_max = MPOOL_IO_ENGINE_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "storage.staging.io_engine",
+        .ps_description = "I/O engine for staging mclass data (sync or io_uring)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_STAGING]),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, io_engine[HSE_MCLASS_STAGING]),
+        .ps_convert = io_engine_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = io_engine_stringify,
+        .ps_jsonify = io_engine_jsonify,
+        .ps_default_value = {
+            .as_enum = MPOOL_IO_ENGINE_SYNC,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = MPOOL_IO_ENGINE_MIN,
+                .ps_max = MPOOL_IO_ENGINE_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "storage.pmem.io_engine",
+        .ps_description = "I/O engine for pmem mclass data (sync only, as it is accessed via mmap)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_PMEM]),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, io_engine[HSE_MCLASS_PMEM]),
+        .ps_convert = io_engine_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = io_engine_stringify,
+        .ps_jsonify = io_engine_jsonify,
+        .ps_default_value = {
+            .as_enum = MPOOL_IO_ENGINE_SYNC,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = MPOOL_IO_ENGINE_MIN,
+                .ps_max = MPOOL_IO_ENGINE_SYNC,
+            },
+        },
+    },
 };
 
 const struct param_spec *
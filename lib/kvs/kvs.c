@@ -29,9 +29,13 @@
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
 #include <hse/util/map.h>
+#include <hse/util/minmax.h>
 #include <hse/util/perfc.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
+#include <hse/util/vlb.h>
+
+#include "kvs_rcache.h"
 
 /* clang-format off */
 
@@ -56,6 +60,7 @@ struct perfc_name kvs_pkvsl_perfc_op[] _dt_section = {
     NE(PERFC_LT_PKVSL_KVS_DEL,            5, "kvs_delete latency",         "kvs_del_lat", 7),
     NE(PERFC_LT_PKVSL_KVS_PFX_PROBE,      5, "kvs_prefix_probe latency",   "kvs_pfx_probe_lat", 7),
     NE(PERFC_LT_PKVSL_KVS_PFX_DEL,        5, "kvs_prefix_delete latency",  "kvs_pfx_del_lat", 7),
+    NE(PERFC_LT_PKVSL_KVS_GET_MANY,       5, "kvs_get_many latency",       "kvs_get_many_lat", 7),
 };
 
 /* clang-format on */
@@ -118,10 +123,22 @@ kvs_perfc_free(struct ikvs *kvs)
  *    ---------                  ------
  *    kvs_create                 kvs_destroy
  *    cn_open                    cn_close
+ *    kvs_rcache_create          kvs_destroy
  *    c0_open                    c0_close
  *
  * [HSE_REVISIT]: Perhaps this arg list can be trimmed some ...
  */
+static void
+kvs_rcache_inval_cb(void *arg, const void *key, uint klen, uint64_t seqno, bool ptomb)
+{
+    struct kvs_rcache *rc = arg;
+
+    if (ptomb)
+        kvs_rcache_invalidate_all(rc, seqno);
+    else
+        kvs_rcache_invalidate(rc, key_hash64(key, klen), seqno);
+}
+
 merr_t
 kvs_open(
     struct ikvdb *kvdb,
@@ -174,6 +191,22 @@ kvs_open(
     if (ev(err))
         goto err_exit;
 
+    /* A capped kvs drops its oldest kvsets without ingesting anything, which
+     * would leave stale entries in the row cache.
+     */
+    if (ikvs->ikv_rp.kvs_rcache_sz > 0 && !cn_is_capped(ikvs->ikv_cn)) {
+        char group[DT_PATH_MAX];
+
+        snprintf(group, sizeof(group), "kvdbs/%s/kvs/%s", ikvdb_alias(kvdb), kvs_name);
+
+        err = kvs_rcache_create(
+            ikvs->ikv_rp.kvs_rcache_sz, group, ikvs->ikv_rp.perfc_level, &ikvs->ikv_rcache);
+        if (ev(err))
+            goto err_exit;
+
+        cn_set_ingest_inval(ikvs->ikv_cn, kvs_rcache_inval_cb, ikvs->ikv_rcache);
+    }
+
     err = c0_open(kvdb, ikvs->ikv_cn, &ikvs->ikv_c0);
     if (ev(err))
         goto err_exit;
@@ -252,6 +285,27 @@ kvs_perfc_pkvsl(struct ikvs *ikvs)
     return NULL;
 }
 
+/* The pfxlock hash of a kvs as a whole, which every txn that writes to the
+ * kvs locks shared (see kvdb_ctxn_trylock_write()).
+ */
+static HSE_ALWAYS_INLINE uint64_t
+kvs_kvshash(const struct ikvs *kvs)
+{
+    return key_hash64(&kvs->ikv_gen, sizeof(kvs->ikv_gen));
+}
+
+/* The pfxlock hash of the prefix of the given key, or zero if the kvs has
+ * no prefix or the key is shorter than the prefix.
+ */
+static HSE_ALWAYS_INLINE uint64_t
+kvs_pfxhash(const struct ikvs *kvs, const void *key, size_t klen)
+{
+    if (kvs->ikv_pfx_len && klen >= kvs->ikv_pfx_len)
+        return key_hash64_seed(key, kvs->ikv_pfx_len, kvs->ikv_gen);
+
+    return 0;
+}
+
 bool
 kvs_txn_is_enabled(struct ikvs *kvs)
 {
@@ -264,7 +318,9 @@ kvs_put(
     struct hse_kvdb_txn * const txn,
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt,
-    uintptr_t seqnoref)
+    struct kvs_vtuple *wvt,
+    uintptr_t seqnoref,
+    bool sync)
 {
     struct kvdb_ctxn *ctxn = txn ? kvdb_ctxn_h2h(txn) : 0;
     struct perfc_set *pkvsl_pc = kvs_perfc_pkvsl(kvs);
@@ -289,17 +345,17 @@ kvs_put(
      */
     if (ctxn) {
         uint64_t hash = kt->kt_hash ^ kvs->ikv_gen;
-        uint64_t pfxhash = 0;
+        uint64_t pfxhash = kvs_pfxhash(kvs, kt->kt_data, kt->kt_len);
 
-        if (kvs->ikv_pfx_len && kt->kt_len >= kvs->ikv_pfx_len)
-            pfxhash = key_hash64_seed(kt->kt_data, kvs->ikv_pfx_len, kvs->ikv_gen);
-
-        err = kvdb_ctxn_trylock_write(ctxn, &seqnoref, &seqno, &rec.cookie, false, pfxhash, hash);
+        err = kvdb_ctxn_trylock_write(
+            ctxn, &seqnoref, &seqno, &rec.cookie, false, kvs_kvshash(kvs), pfxhash, hash);
         if (err)
             return err;
     }
 
-    err = wal_put(kvs->ikv_wal, kvs, kt, vt, seqno, &rec);
+    /* wvt, if given, is the value as logged (e.g., compressed for the WAL only).
+     */
+    err = wal_put(kvs->ikv_wal, kvs, kt, wvt ? wvt : vt, seqno, &rec);
 
     if (HSE_LIKELY(!err)) {
         err = c0_put(kvs->ikv_c0, kt, vt, seqnoref);
@@ -310,11 +366,279 @@ kvs_put(
     if (ctxn)
         kvdb_ctxn_unlock(ctxn);
 
+    /* A synchronous put waits only for its own record to become durable,
+     * not for all the data buffered in the WAL.
+     */
+    if (sync && !err) {
+        assert(!ctxn);
+        err = wal_op_sync(kvs->ikv_wal, &rec);
+    }
+
     perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_PUT, tstart);
 
     return err;
 }
 
+/* The row cache is indexed by the hash of the whole key.
+ */
+static HSE_ALWAYS_INLINE uint64_t
+kvs_rcache_hash(const struct ikvs *kvs, const struct kvs_ktuple *kt)
+{
+    if (kvs->ikv_rp.kvs_sfxlen > 0)
+        return key_hash64(kt->kt_data, kt->kt_len);
+
+    return kt->kt_hash;
+}
+
+/* Search cn via the row cache.  A cached value is served only if the view
+ * seqno is not older than any kvset in cn, in which case cn_get() would yield
+ * the same value (ingests invalidate the keys they write, see kvs_rcache.h).
+ */
+static merr_t
+kvs_get_rcache(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    uint64_t seqno,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf)
+{
+    struct kvs_rcache *rc = kvs->ikv_rcache;
+    struct cn *cn = kvs->ikv_cn;
+    uint64_t hash;
+    merr_t err;
+
+    if (seqno < cn_get_ingest_seqno_max(cn))
+        return cn_get(cn, kt, seqno, res, vbuf, NULL);
+
+    hash = kvs_rcache_hash(kvs, kt);
+
+    if (kvs_rcache_get(rc, kt, hash, vbuf)) {
+        *res = FOUND_VAL;
+        return 0;
+    }
+
+    err = cn_get(cn, kt, seqno, res, vbuf, NULL);
+
+    if (!err && *res == FOUND_VAL && vbuf->b_buf && vbuf->b_len <= vbuf->b_buf_sz)
+        kvs_rcache_put(rc, kt, hash, seqno, vbuf);
+
+    return err;
+}
+
+/* As kvs_get_rcache(), for the keys of a batch that missed in c0 and lc.
+ * The keys that miss in the row cache are resolved in one pass through cn.
+ */
+static merr_t
+kvs_get_many_rcache(
+    struct ikvs *kvs,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seqno,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    bool missv_stack[HSE_KVS_GET_MANY_BATCH], *missv = missv_stack;
+    struct kvs_rcache *rc = kvs->ikv_rcache;
+    struct cn *cn = kvs->ikv_cn;
+    uint pending = 0;
+    merr_t err = 0;
+    uint i;
+
+    if (seqno < cn_get_ingest_seqno_max(cn))
+        return cn_get_many(cn, keyc, ktv, seqno, resv, vbufv);
+
+    if (keyc > NELEM(missv_stack)) {
+        missv = malloc(keyc * sizeof(*missv));
+        if (ev(!missv))
+            return merr(ENOMEM);
+    }
+
+    for (i = 0; i < keyc; ++i) {
+        missv[i] = false;
+
+        if (resv[i] != NOT_FOUND)
+            continue;
+
+        if (kvs_rcache_get(rc, ktv + i, kvs_rcache_hash(kvs, ktv + i), vbufv + i)) {
+            resv[i] = FOUND_VAL;
+            continue;
+        }
+
+        missv[i] = true;
+        ++pending;
+    }
+
+    if (pending > 0)
+        err = cn_get_many(cn, keyc, ktv, seqno, resv, vbufv);
+
+    for (i = 0; i < keyc && !err; ++i) {
+        struct kvs_buf *vbuf = vbufv + i;
+
+        if (missv[i] && resv[i] == FOUND_VAL && vbuf->b_buf && vbuf->b_len <= vbuf->b_buf_sz)
+            kvs_rcache_put(rc, ktv + i, kvs_rcache_hash(kvs, ktv + i), seqno, vbuf);
+    }
+
+    if (missv != missv_stack)
+        free(missv);
+
+    return err;
+}
+
+/* Retrieve the newest version of a key in the view of a non-txn reader,
+ * along with its seqno if it is a merge operand.
+ */
+static merr_t
+kvs_get_version(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    uint64_t seqno,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
+{
+    struct c0 *c0 = kvs->ikv_c0;
+    merr_t err;
+
+    err = c0_get(c0, kt, seqno, 0, res, vbuf, seqnop);
+
+    if (!err && *res == NOT_FOUND)
+        err = lc_get(kvs->ikv_lc, c0_index(c0), kvs->ikv_pfx_len, kt, seqno, 0, res, vbuf);
+
+    if (!err && *res == NOT_FOUND)
+        err = cn_get(kvs->ikv_cn, kt, seqno, res, vbuf, seqnop);
+
+    return err;
+}
+
+merr_t
+kvs_get_merge(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    uint64_t seqno,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf)
+{
+    const size_t vmax = HSE_KVS_VALUE_LEN_MAX;
+    struct kvs_opnd {
+        size_t len;
+        uint8_t data[HSE_KVS_MERGE_OPND_LEN_MAX];
+    } *opndv = NULL;
+    const void **datav = NULL;
+    size_t *lenv = NULL;
+    uint opndc = 0, opndmax = 0;
+    hse_kvs_merge_fn *fn;
+    struct kvs_buf buf;
+    void *base, *out;
+    size_t outlen = 0;
+    merr_t err = 0;
+    int rc;
+
+    fn = cn_get_merge_fn(kvs->ikv_cn);
+    if (ev(!fn))
+        return merr(ENOTSUP);
+
+    assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+    kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+
+    base = vlb_alloc(vmax * 2);
+    if (ev(!base))
+        return merr(ENOMEM);
+
+    out = base + vmax;
+
+    /* Walk back through the key's versions until a version that is not an
+     * operand is found, each step viewing only the versions older than the
+     * operand last found.
+     */
+    while (1) {
+        uint64_t vseq = 0;
+
+        kvs_buf_init(&buf, base, vmax);
+
+        err = kvs_get_version(kvs, kt, seqno, res, &buf, &vseq);
+        if (ev(err))
+            goto out;
+
+        if (*res != FOUND_MOPND)
+            break;
+
+        if (opndc >= opndmax) {
+            uint max = opndmax ? opndmax * 2 : 8;
+            void *p;
+
+            p = realloc(opndv, max * sizeof(*opndv));
+            if (ev(!p)) {
+                err = merr(ENOMEM);
+                goto out;
+            }
+            opndv = p;
+            opndmax = max;
+        }
+
+        opndv[opndc].len = min_t(size_t, buf.b_len, sizeof(opndv[opndc].data));
+        memcpy(opndv[opndc].data, base, opndv[opndc].len);
+        opndc++;
+
+        assert(vseq > 0 && vseq <= seqno);
+        seqno = vseq - 1;
+    }
+
+    /* The key has no operands in this view (e.g., they were collapsed
+     * after our caller's lookup).
+     */
+    if (opndc == 0) {
+        if (*res == FOUND_VAL) {
+            if (vbuf->b_buf)
+                memcpy(vbuf->b_buf, base, min_t(size_t, buf.b_len, vbuf->b_buf_sz));
+            vbuf->b_len = buf.b_len;
+        }
+        goto out;
+    }
+
+    datav = malloc(opndc * (sizeof(*datav) + sizeof(*lenv)));
+    if (ev(!datav)) {
+        err = merr(ENOMEM);
+        goto out;
+    }
+
+    lenv = (void *)(datav + opndc);
+
+    /* The merge operator takes the operands oldest first.
+     */
+    for (uint i = 0; i < opndc; i++) {
+        datav[i] = opndv[opndc - i - 1].data;
+        lenv[i] = opndv[opndc - i - 1].len;
+    }
+
+    if (*res != FOUND_VAL)
+        base = NULL;
+
+    rc = fn(kt->kt_data, kt->kt_len, base, base ? buf.b_len : 0, opndc, datav, lenv, out, vmax,
+            &outlen);
+    if (ev(rc)) {
+        err = merr(rc);
+        goto out;
+    }
+
+    if (ev(outlen > vmax)) {
+        err = merr(EINVAL);
+        goto out;
+    }
+
+    if (vbuf->b_buf)
+        memcpy(vbuf->b_buf, out, min_t(size_t, outlen, vbuf->b_buf_sz));
+
+    vbuf->b_len = outlen;
+    *res = FOUND_VAL;
+
+out:
+    vlb_free(out - vmax, vmax * 2);
+    free(datav);
+    free(opndv);
+
+    return err;
+}
+
 merr_t
 kvs_get(
     struct ikvs *kvs,
@@ -345,9 +669,13 @@ kvs_get(
         err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
         if (err)
             return err;
+
+        kvdb_ctxn_read_key(
+            ctxn, kvs_kvshash(kvs), kvs_pfxhash(kvs, kt->kt_data, kt->kt_len),
+            kt->kt_hash ^ kvs->ikv_gen);
     }
 
-    err = c0_get(c0, kt, seqno, seqnoref, res, vbuf);
+    err = c0_get(c0, kt, seqno, seqnoref, res, vbuf, NULL);
 
     if (!err && *res == NOT_FOUND)
         err = lc_get(lc, c0_index(c0), kvs->ikv_pfx_len, kt, seqno, seqnoref, res, vbuf);
@@ -355,14 +683,166 @@ kvs_get(
     if (ctxn)
         kvdb_ctxn_unlock(ctxn);
 
-    if (!err && *res == NOT_FOUND)
-        err = cn_get(cn, kt, seqno, res, vbuf);
+    if (!err && *res == NOT_FOUND) {
+        if (kvs->ikv_rcache)
+            err = kvs_get_rcache(kvs, kt, seqno, res, vbuf);
+        else
+            err = cn_get(cn, kt, seqno, res, vbuf, NULL);
+    }
+
+    if (!err && *res == FOUND_MOPND)
+        err = kvs_get_merge(kvs, kt, seqno, res, vbuf);
 
     perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_GET, tstart);
 
     return err;
 }
 
+merr_t
+kvs_get_many(
+    struct ikvs *kvs,
+    struct hse_kvdb_txn * const txn,
+    uint keyc,
+    struct kvs_ktuple *ktv,
+    uint64_t seqno,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct kvdb_ctxn *ctxn = txn ? kvdb_ctxn_h2h(txn) : 0;
+    struct perfc_set *pkvsl_pc = kvs_perfc_pkvsl(kvs);
+    struct c0 *c0 = kvs->ikv_c0;
+    struct lc *lc = kvs->ikv_lc;
+    uintptr_t seqnoref = 0;
+    uint pending = 0;
+    uint64_t tstart;
+    merr_t err = 0;
+    uint i;
+
+    tstart = perfc_lat_start(pkvsl_pc);
+
+    for (i = 0; i < keyc; ++i) {
+        struct kvs_ktuple *kt = ktv + i;
+
+        assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+        kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+        resv[i] = NOT_FOUND;
+    }
+
+    /* Exclusively lock txn for the c0/lc portion of the query.
+     * seqnoref is invalid after lock is released.
+     */
+    if (ctxn) {
+        err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
+        if (err)
+            return err;
+
+        for (i = 0; i < keyc; ++i)
+            kvdb_ctxn_read_key(
+                ctxn, kvs_kvshash(kvs), kvs_pfxhash(kvs, ktv[i].kt_data, ktv[i].kt_len),
+                ktv[i].kt_hash ^ kvs->ikv_gen);
+    }
+
+    for (i = 0; i < keyc && !err; ++i) {
+        err = c0_get(c0, ktv + i, seqno, seqnoref, resv + i, vbufv + i, NULL);
+
+        if (!err && resv[i] == NOT_FOUND)
+            err = lc_get(
+                lc, c0_index(c0), kvs->ikv_pfx_len, ktv + i, seqno, seqnoref, resv + i, vbufv + i);
+
+        pending += (resv[i] == NOT_FOUND);
+    }
+
+    if (ctxn)
+        kvdb_ctxn_unlock(ctxn);
+
+    /* Resolve all the keys that missed in c0 and lc in one pass through cn,
+     * via the row cache if the kvs has one.
+     */
+    if (!err && pending > 0) {
+        if (kvs->ikv_rcache)
+            err = kvs_get_many_rcache(kvs, keyc, ktv, seqno, resv, vbufv);
+        else
+            err = cn_get_many(kvs->ikv_cn, keyc, ktv, seqno, resv, vbufv);
+    }
+
+    for (i = 0; i < keyc && !err; ++i) {
+        if (resv[i] == FOUND_MOPND)
+            err = kvs_get_merge(kvs, ktv + i, seqno, resv + i, vbufv + i);
+    }
+
+    perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_GET_MANY, tstart);
+
+    return err;
+}
+
+merr_t
+kvs_get_async(
+    struct ikvs *kvs,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt,
+    uint64_t seqno,
+    struct cn_get_aio *aio)
+{
+    struct kvdb_ctxn *ctxn = txn ? kvdb_ctxn_h2h(txn) : 0;
+    struct c0 *c0 = kvs->ikv_c0;
+    struct lc *lc = kvs->ikv_lc;
+    uintptr_t seqnoref = 0;
+    merr_t err;
+
+    /* Resolving merge operands requires a series of lookups, hence gets
+     * from a kvs with a merge operator are performed synchronously.
+     */
+    if (cn_get_merge_fn(kvs->ikv_cn)) {
+        err = kvs_get(kvs, txn, kt, seqno, &aio->cga_res, aio->cga_vbuf);
+        if (err)
+            return err;
+
+        aio->cga_err = 0;
+        aio->cga_cb(aio);
+
+        return 0;
+    }
+
+    assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+    kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+
+    /* Exclusively lock txn for query.
+     * seqnoref is invalid after lock is released.
+     */
+    if (ctxn) {
+        err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
+        if (err)
+            return err;
+
+        kvdb_ctxn_read_key(
+            ctxn, kvs_kvshash(kvs), kvs_pfxhash(kvs, kt->kt_data, kt->kt_len),
+            kt->kt_hash ^ kvs->ikv_gen);
+    }
+
+    err = c0_get(c0, kt, seqno, seqnoref, &aio->cga_res, aio->cga_vbuf, NULL);
+
+    if (!err && aio->cga_res == NOT_FOUND)
+        err = lc_get(
+            lc, c0_index(c0), kvs->ikv_pfx_len, kt, seqno, seqnoref, &aio->cga_res, aio->cga_vbuf);
+
+    if (ctxn)
+        kvdb_ctxn_unlock(ctxn);
+
+    if (err)
+        return err;
+
+    /* Only cn lookups can require media reads, all others complete
+     * on the caller's stack.
+     */
+    if (aio->cga_res == NOT_FOUND)
+        return cn_get_async(kvs->ikv_cn, kt, seqno, aio);
+
+    aio->cga_err = 0;
+    aio->cga_cb(aio);
+
+    return 0;
+}
+
 merr_t
 kvs_del(
     struct ikvs *kvs,
@@ -388,12 +868,10 @@ kvs_del(
      */
     if (ctxn) {
         uint64_t hash = kt->kt_hash ^ kvs->ikv_gen;
-        uint64_t pfxhash = 0;
-
-        if (kvs->ikv_pfx_len && kt->kt_len >= kvs->ikv_pfx_len)
-            pfxhash = key_hash64_seed(kt->kt_data, kvs->ikv_pfx_len, kvs->ikv_gen);
+        uint64_t pfxhash = kvs_pfxhash(kvs, kt->kt_data, kt->kt_len);
 
-        err = kvdb_ctxn_trylock_write(ctxn, &seqnoref, &seqno, &rec.cookie, false, pfxhash, hash);
+        err = kvdb_ctxn_trylock_write(
+            ctxn, &seqnoref, &seqno, &rec.cookie, false, kvs_kvshash(kvs), pfxhash, hash);
         if (err)
             return err;
     }
@@ -438,12 +916,10 @@ kvs_prefix_del(
     /* Exclusively lock txn for c0 update (no write collision detection.
      */
     if (ctxn) {
-        uint64_t pfxhash = 0;
+        uint64_t pfxhash = kvs_pfxhash(kvs, kt->kt_data, kt->kt_len);
 
-        if (kvs->ikv_pfx_len && kt->kt_len >= kvs->ikv_pfx_len)
-            pfxhash = key_hash64_seed(kt->kt_data, kvs->ikv_pfx_len, kvs->ikv_gen);
-
-        err = kvdb_ctxn_trylock_write(ctxn, &seqnoref, &seqno, &rec.cookie, true, pfxhash, 0);
+        err = kvdb_ctxn_trylock_write(
+            ctxn, &seqnoref, &seqno, &rec.cookie, true, kvs_kvshash(kvs), pfxhash, 0);
         if (err)
             return err;
     }
@@ -463,6 +939,87 @@ kvs_prefix_del(
     return ev(err);
 }
 
+merr_t
+kvs_batch_put(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    uint64_t txid,
+    int64_t cookie)
+{
+    struct perfc_set *pkvsl_pc = kvs_perfc_pkvsl(kvs);
+    struct wal_record rec;
+    uint64_t tstart;
+    merr_t err;
+
+    tstart = perfc_lat_start(pkvsl_pc);
+
+    assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+    kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+    rec.cookie = cookie;
+
+    err = wal_put(kvs->ikv_wal, kvs, kt, vt, txid, &rec);
+    if (!err) {
+        err = c0_put(kvs->ikv_c0, kt, vt, seqnoref);
+
+        wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
+    }
+
+    perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_PUT, tstart);
+
+    return err;
+}
+
+merr_t
+kvs_batch_del(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    uintptr_t seqnoref,
+    uint64_t txid,
+    int64_t cookie)
+{
+    struct perfc_set *pkvsl_pc = kvs_perfc_pkvsl(kvs);
+    struct wal_record rec;
+    uint64_t tstart;
+    merr_t err;
+
+    tstart = perfc_lat_start(pkvsl_pc);
+
+    assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+    kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+    rec.cookie = cookie;
+
+    err = wal_del(kvs->ikv_wal, kvs, kt, txid, &rec);
+    if (!err) {
+        err = c0_del(kvs->ikv_c0, kt, seqnoref);
+
+        wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
+    }
+
+    perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_DEL, tstart);
+
+    return err;
+}
+
+merr_t
+kvs_txn_read_range(struct ikvs *kvs, struct hse_kvdb_txn *txn, const void *pfx, size_t pfx_len)
+{
+    struct kvdb_ctxn *ctxn = kvdb_ctxn_h2h(txn);
+    uintptr_t seqnoref;
+    uint64_t seqno;
+    merr_t err;
+
+    err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
+    if (err)
+        return err;
+
+    kvdb_ctxn_read_range(ctxn, kvs_kvshash(kvs), kvs_pfxhash(kvs, pfx, pfx_len));
+    kvdb_ctxn_unlock(ctxn);
+
+    return 0;
+}
+
 merr_t
 kvs_pfx_probe(
     struct ikvs *kvs,
@@ -494,6 +1051,8 @@ kvs_pfx_probe(
         err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
         if (err)
             return err;
+
+        kvdb_ctxn_read_range(ctxn, kvs_kvshash(kvs), kvs_pfxhash(kvs, kt->kt_data, kt->kt_len));
     }
 
     err = c0_pfx_probe(c0, kt, seqno, seqnoref, res, &qctx, kbuf, vbuf);
@@ -535,6 +1094,22 @@ exit:
         *res = FOUND_MULTIPLE;
     }
 
+    /* The probes do not distinguish merge operands from values, hence the
+     * value of the key found must be re-read if it might have operands.
+     */
+    if (*res == FOUND_VAL && cn_get_merge_fn(cn) && kbuf->b_len <= kbuf->b_buf_sz) {
+        struct kvs_ktuple fkt;
+
+        kvs_ktuple_init_nohash(&fkt, kbuf->b_buf, kbuf->b_len);
+
+        err = kvs_get_merge(kvs, &fkt, seqno, res, vbuf);
+        if (ev(err))
+            return err;
+
+        if (*res != FOUND_VAL)
+            *res = NOT_FOUND;
+    }
+
     perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_PFX_PROBE, tstart);
 
     return 0;
@@ -569,6 +1144,7 @@ kvs_destroy(struct ikvs *kvs)
         return;
     }
 
+    kvs_rcache_destroy(kvs->ikv_rcache);
     free((void *)kvs->ikv_kvs_name);
     free(kvs);
 }
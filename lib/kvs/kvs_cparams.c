@@ -3,15 +3,106 @@
  * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
  */
 
+#include <errno.h>
 #include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <hse/limits.h>
 
 #include <hse/config/params.h>
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/logging/logging.h>
+#include <hse/util/assert.h>
 #include <hse/util/base.h>
+#include <hse/util/compiler.h>
+
+static const char *
+filter_type_name(enum kvs_filter_type type)
+{
+    switch (type) {
+    case KVS_FILTER_BLOOM:
+        return KVS_FILTER_PARAM_BLOOM;
+    case KVS_FILTER_FUSE:
+        return KVS_FILTER_PARAM_FUSE;
+    }
+
+    return NULL;
+}
+
+static bool HSE_NONNULL(1, 2, 3)
+filter_type_converter(
+    const struct param_spec * const ps,
+    const cJSON * const node,
+    void * const data)
+{
+    const char *value;
+
+    INVARIANT(ps);
+    INVARIANT(node);
+    INVARIANT(data);
+
+    if (!cJSON_IsString(node))
+        return false;
+
+    value = cJSON_GetStringValue(node);
+    if (strcmp(value, KVS_FILTER_PARAM_BLOOM) == 0) {
+        *(enum kvs_filter_type *)data = KVS_FILTER_BLOOM;
+    } else if (strcmp(value, KVS_FILTER_PARAM_FUSE) == 0) {
+        *(enum kvs_filter_type *)data = KVS_FILTER_FUSE;
+    } else {
+        log_err("Unknown filter type: %s", value);
+        return false;
+    }
+
+    return true;
+}
+
+static merr_t
+filter_type_stringify(
+    const struct param_spec * const ps,
+    const void * const value,
+    char * const buf,
+    const size_t buf_sz,
+    size_t * const needed_sz)
+{
+    const char *param;
+    int n;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+    INVARIANT(buf);
+
+    param = filter_type_name(*(enum kvs_filter_type *)value);
+    assert(param);
+
+    n = snprintf(buf, buf_sz, "\"%s\"", param);
+    if (n < 0)
+        return merr(EBADMSG);
+
+    if (needed_sz)
+        *needed_sz = n;
+
+    return 0;
+}
+
+static cJSON *
+filter_type_jsonify(const struct param_spec * const ps, const void * const value)
+{
+    const char *param;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    param = filter_type_name(*(enum kvs_filter_type *)value);
+    if (!param)
+        abort();
+
+    return cJSON_CreateString(param);
+}
 
 static const struct param_spec pspecs[] = {
     {
@@ -56,6 +147,42 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "filter.type",
+        .ps_description = "Per-kblock filter type (bloom or fuse)",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvs_cparams, filter_type),
+        .ps_size = PARAM_SZ(struct kvs_cparams, filter_type),
+        .ps_convert = filter_type_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = filter_type_stringify,
+        .ps_jsonify = filter_type_jsonify,
+        .ps_default_value = {
+            .as_enum = KVS_FILTER_BLOOM,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = KVS_FILTER_MIN,
+                .ps_max = KVS_FILTER_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "hash_index.enabled",
+        .ps_description = "Add a key hash index to each kblock for point gets",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvs_cparams, hash_index),
+        .ps_size = PARAM_SZ(struct kvs_cparams, hash_index),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_bool = false,
+        },
+    },
 };
 
 const struct param_spec *
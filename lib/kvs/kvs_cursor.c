@@ -7,6 +7,7 @@
 
 #include <c0/c0_cursor.h>
 
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/kvdb_perfc.h>
 
 #include <hse/ikvdb/c0.h>
@@ -19,7 +20,6 @@
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
 #include <hse/logging/logging.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
 #include <hse/util/keycmp.h>
@@ -1149,6 +1149,43 @@ kvs_cursor_val_copy(
     vt = &cur->kci_elem_last.kce_vt;
     clen = cur->kci_elem_last.kce_complen;
 
+    /* A merge operand is resolved by point lookups in the cursor's view.
+     */
+    if (kvs_vtuple_is_mopnd(vt)) {
+        uint8_t kbuf[HSE_KVS_KEY_LEN_MAX];
+        enum key_lookup_res res;
+        struct kvs_ktuple kt;
+        struct kvs_buf vbuf;
+        uint klen;
+
+        if (!buf) {
+            buf = cur->kci_buf + HSE_KVS_KEY_LEN_MAX;
+            bufsz = HSE_KVS_VALUE_LEN_MAX;
+        }
+
+        key_obj_copy(kbuf, sizeof(kbuf), &klen, cur->kci_last);
+        kvs_ktuple_init_nohash(&kt, kbuf, klen);
+        kvs_buf_init(&vbuf, buf, bufsz);
+
+        err = kvs_get_merge(cur->kci_kvs, &kt, cursor->kc_seq, &res, &vbuf);
+        if (ev(err))
+            return err;
+
+        /* The operand the cursor read is no longer visible, hence neither
+         * is a value to return for the key.
+         */
+        if (ev(res != FOUND_VAL))
+            return merr(ENOENT);
+
+        if (val_out)
+            *val_out = buf;
+
+        if (vlen_out)
+            *vlen_out = vbuf.b_len;
+
+        return 0;
+    }
+
     if (!buf && !val_out)
         goto out;
 
@@ -1160,7 +1197,7 @@ kvs_cursor_val_copy(
     if (clen) {
         uint outlen;
 
-        err = compress_lz4_ops.cop_decompress(vt->vt_data, clen, buf, bufsz, &outlen);
+        err = vcomp_decompress(vt->vt_data, clen, buf, bufsz, &outlen);
         if (ev(err))
             return err;
 
@@ -0,0 +1,364 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/kvdb_perfc.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/tuple.h>
+#include <hse/util/alloc.h>
+#include <hse/util/assert.h>
+#include <hse/util/atomic.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/list.h>
+#include <hse/util/map.h>
+#include <hse/util/minmax.h>
+#include <hse/util/mutex.h>
+#include <hse/util/perfc.h>
+#include <hse/util/platform.h>
+
+#include "kvs_rcache.h"
+
+/* Entries are distributed over the shards by key hash, each shard having
+ * its own lock, map from key hash to entry, share of the budget, CLOCK
+ * list (second-chance replacement, the hand being the head of the list),
+ * and invalidation stamps indexed by the low bits of the key hash.
+ *
+ * Keys whose hashes collide simply replace each other.
+ */
+#define RCACHE_SHARDS (16)
+#define RCACHE_STAMPS (1024)
+
+struct rcache_entry {
+    struct list_head rce_link;
+    uint64_t rce_hash;
+    uint32_t rce_klen;
+    uint32_t rce_vlen;
+    bool rce_ref;
+    uint8_t rce_data[]; /* key followed by value */
+};
+
+struct rcache_shard {
+    struct mutex rcs_lock HSE_L1D_ALIGNED;
+    struct map *rcs_map;
+    struct list_head rcs_clock;
+    size_t rcs_resident;
+    size_t rcs_budget;
+    uint64_t rcs_stampv[RCACHE_STAMPS];
+};
+
+struct kvs_rcache {
+    struct rcache_shard rc_shardv[RCACHE_SHARDS];
+    atomic_ulong rc_stamp HSE_L1D_ALIGNED;
+    struct perfc_set rc_pc HSE_L1D_ALIGNED;
+};
+
+/* clang-format off */
+
+struct perfc_name kvs_rcache_perfc[] _dt_section = {
+    NE(PERFC_RA_RCACHE_HIT,   2, "kvs row cache hit rate",    "r_hit(/s)"),
+    NE(PERFC_RA_RCACHE_MISS,  2, "kvs row cache miss rate",   "r_miss(/s)"),
+    NE(PERFC_RA_RCACHE_FILL,  2, "kvs row cache fill rate",   "r_fill(/s)"),
+    NE(PERFC_RA_RCACHE_EVICT, 2, "kvs row cache evict rate",  "r_evict(/s)"),
+    NE(PERFC_BA_RCACHE_BYTES, 2, "kvs row cache bytes",       "c_bytes"),
+};
+
+NE_CHECK(kvs_rcache_perfc, PERFC_EN_RCACHE, "kvs_rcache_perfc table/enum mismatch");
+
+/* clang-format on */
+
+static HSE_ALWAYS_INLINE size_t
+rcache_entry_sz(const struct rcache_entry *e)
+{
+    return sizeof(*e) + e->rce_klen + e->rce_vlen;
+}
+
+static struct rcache_shard *
+rcache_shard(struct kvs_rcache *rc, uint64_t hash)
+{
+    return rc->rc_shardv + ((hash >> 32) % RCACHE_SHARDS);
+}
+
+static HSE_ALWAYS_INLINE uint64_t *
+rcache_stamp(struct rcache_shard *shard, uint64_t hash)
+{
+    return shard->rcs_stampv + (hash % RCACHE_STAMPS);
+}
+
+/* Unlink an entry from its shard.  Caller holds the shard lock and frees
+ * the entry after dropping it.
+ */
+static void
+rcache_unlink_locked(struct kvs_rcache *rc, struct rcache_shard *shard, struct rcache_entry *e)
+{
+    map_remove_ptr(shard->rcs_map, e->rce_hash);
+    list_del(&e->rce_link);
+
+    shard->rcs_resident -= rcache_entry_sz(e);
+    perfc_sub(&rc->rc_pc, PERFC_BA_RCACHE_BYTES, rcache_entry_sz(e));
+}
+
+bool
+kvs_rcache_get(
+    struct kvs_rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    struct kvs_buf *vbuf)
+{
+    struct rcache_shard *shard;
+    struct rcache_entry *e;
+    bool hit = false;
+
+    INVARIANT(rc);
+    INVARIANT(kt);
+    INVARIANT(vbuf);
+
+    shard = rcache_shard(rc, hash);
+
+    mutex_lock(&shard->rcs_lock);
+    e = map_lookup_ptr(shard->rcs_map, hash);
+    if (e) {
+        hit = (e->rce_klen == kt->kt_len && !memcmp(e->rce_data, kt->kt_data, kt->kt_len));
+        if (hit) {
+            if (vbuf->b_buf)
+                memcpy(vbuf->b_buf, e->rce_data + e->rce_klen, min(e->rce_vlen, vbuf->b_buf_sz));
+
+            vbuf->b_len = e->rce_vlen;
+            e->rce_ref = true;
+        }
+    }
+    mutex_unlock(&shard->rcs_lock);
+
+    perfc_inc(&rc->rc_pc, hit ? PERFC_RA_RCACHE_HIT : PERFC_RA_RCACHE_MISS);
+
+    return hit;
+}
+
+void
+kvs_rcache_put(
+    struct kvs_rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    uint64_t seqno,
+    const struct kvs_buf *vbuf)
+{
+    struct rcache_entry *e, *old, *victim;
+    struct rcache_shard *shard;
+    struct list_head evicted;
+    size_t sz, nevicted = 0;
+    merr_t err;
+
+    INVARIANT(rc);
+    INVARIANT(kt);
+    INVARIANT(vbuf);
+    assert(vbuf->b_len <= vbuf->b_buf_sz);
+
+    shard = rcache_shard(rc, hash);
+
+    /* Large values would churn the cache, so cap entries at a fraction
+     * of the shard budget.
+     */
+    sz = sizeof(*e) + kt->kt_len + vbuf->b_len;
+    if (sz > shard->rcs_budget / 4)
+        return;
+
+    e = malloc(sz);
+    if (ev(!e))
+        return;
+
+    e->rce_hash = hash;
+    e->rce_klen = kt->kt_len;
+    e->rce_vlen = vbuf->b_len;
+    e->rce_ref = false;
+    memcpy(e->rce_data, kt->kt_data, kt->kt_len);
+    memcpy(e->rce_data + e->rce_klen, vbuf->b_buf, vbuf->b_len);
+
+    INIT_LIST_HEAD(&evicted);
+
+    mutex_lock(&shard->rcs_lock);
+
+    /* The key was invalidated after the reader established its view, so
+     * the value may already have been replaced by an ingest.
+     */
+    if (seqno < *rcache_stamp(shard, hash) || seqno < atomic_read(&rc->rc_stamp)) {
+        mutex_unlock(&shard->rcs_lock);
+        free(e);
+        return;
+    }
+
+    old = map_lookup_ptr(shard->rcs_map, hash);
+    if (old) {
+        rcache_unlink_locked(rc, shard, old);
+        list_add(&old->rce_link, &evicted);
+    }
+
+    /* Advance the clock hand, giving referenced entries a second chance,
+     * until there is room for the new entry.  Each entry is skipped at
+     * most once, hence the loop terminates.
+     */
+    while (shard->rcs_resident + sz > shard->rcs_budget) {
+        victim = list_first_entry_or_null(&shard->rcs_clock, typeof(*victim), rce_link);
+        if (!victim)
+            break;
+
+        if (victim->rce_ref) {
+            victim->rce_ref = false;
+            list_del(&victim->rce_link);
+            list_add_tail(&victim->rce_link, &shard->rcs_clock);
+            continue;
+        }
+
+        rcache_unlink_locked(rc, shard, victim);
+        list_add(&victim->rce_link, &evicted);
+        ++nevicted;
+    }
+
+    err = map_insert_ptr(shard->rcs_map, hash, e);
+    if (!err) {
+        list_add_tail(&e->rce_link, &shard->rcs_clock);
+        shard->rcs_resident += sz;
+    }
+    mutex_unlock(&shard->rcs_lock);
+
+    list_for_each_entry_safe(victim, old, &evicted, rce_link)
+        free(victim);
+
+    if (ev(err)) {
+        free(e);
+        return;
+    }
+
+    perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_FILL);
+    perfc_add(&rc->rc_pc, PERFC_BA_RCACHE_BYTES, sz);
+    if (nevicted > 0)
+        perfc_add(&rc->rc_pc, PERFC_RA_RCACHE_EVICT, nevicted);
+}
+
+void
+kvs_rcache_invalidate(struct kvs_rcache *rc, uint64_t hash, uint64_t seqno)
+{
+    struct rcache_shard *shard;
+    struct rcache_entry *e;
+    uint64_t *stamp;
+
+    INVARIANT(rc);
+
+    shard = rcache_shard(rc, hash);
+    stamp = rcache_stamp(shard, hash);
+
+    mutex_lock(&shard->rcs_lock);
+    if (seqno > *stamp)
+        *stamp = seqno;
+
+    e = map_lookup_ptr(shard->rcs_map, hash);
+    if (e)
+        rcache_unlink_locked(rc, shard, e);
+    mutex_unlock(&shard->rcs_lock);
+
+    free(e);
+}
+
+void
+kvs_rcache_invalidate_all(struct kvs_rcache *rc, uint64_t seqno)
+{
+    uint64_t stamp;
+
+    INVARIANT(rc);
+
+    /* Raise the stamp before emptying the shards such that a fill that
+     * misses the new stamp is emptied out along with the rest.
+     */
+    stamp = atomic_read(&rc->rc_stamp);
+    while (seqno > stamp && !atomic_cas(&rc->rc_stamp, stamp, seqno))
+        stamp = atomic_read(&rc->rc_stamp);
+
+    for (size_t i = 0; i < NELEM(rc->rc_shardv); ++i) {
+        struct rcache_shard *shard = rc->rc_shardv + i;
+        struct rcache_entry *e, *next;
+        struct list_head evicted;
+
+        INIT_LIST_HEAD(&evicted);
+
+        mutex_lock(&shard->rcs_lock);
+        list_for_each_entry_safe(e, next, &shard->rcs_clock, rce_link) {
+            rcache_unlink_locked(rc, shard, e);
+            list_add(&e->rce_link, &evicted);
+        }
+        mutex_unlock(&shard->rcs_lock);
+
+        list_for_each_entry_safe(e, next, &evicted, rce_link)
+            free(e);
+    }
+}
+
+merr_t
+kvs_rcache_create(
+    size_t cachesz,
+    const char *perfc_group,
+    uint perfc_level,
+    struct kvs_rcache **rc_out)
+{
+    struct kvs_rcache *rc;
+
+    INVARIANT(perfc_group);
+    INVARIANT(rc_out);
+
+    *rc_out = NULL;
+
+    rc = aligned_alloc(__alignof__(*rc), sizeof(*rc));
+    if (ev(!rc))
+        return merr(ENOMEM);
+
+    memset(rc, 0, sizeof(*rc));
+
+    for (size_t i = 0; i < NELEM(rc->rc_shardv); ++i) {
+        struct rcache_shard *shard = rc->rc_shardv + i;
+
+        mutex_init(&shard->rcs_lock);
+        INIT_LIST_HEAD(&shard->rcs_clock);
+        shard->rcs_budget = cachesz / RCACHE_SHARDS;
+    }
+
+    for (size_t i = 0; i < NELEM(rc->rc_shardv); ++i) {
+        struct rcache_shard *shard = rc->rc_shardv + i;
+
+        shard->rcs_map = map_create(0);
+        if (ev(!shard->rcs_map)) {
+            kvs_rcache_destroy(rc);
+            return merr(ENOMEM);
+        }
+    }
+
+    perfc_alloc(kvs_rcache_perfc, perfc_group, "rcache", perfc_level, &rc->rc_pc);
+
+    *rc_out = rc;
+
+    return 0;
+}
+
+void
+kvs_rcache_destroy(struct kvs_rcache *rc)
+{
+    if (!rc)
+        return;
+
+    perfc_free(&rc->rc_pc);
+
+    for (size_t i = 0; i < NELEM(rc->rc_shardv); ++i) {
+        struct rcache_shard *shard = rc->rc_shardv + i;
+        struct rcache_entry *e, *next;
+
+        list_for_each_entry_safe(e, next, &shard->rcs_clock, rce_link)
+            free(e);
+
+        map_destroy(shard->rcs_map);
+        mutex_destroy(&shard->rcs_lock);
+    }
+
+    free(rc);
+}
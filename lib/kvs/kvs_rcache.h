@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#ifndef HSE_KVS_RCACHE_H
+#define HSE_KVS_RCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/compiler.h>
+
+/* The row cache holds key/value pairs retrieved from cn by point gets such
+ * that repeated gets of hot keys need not search the cn tree.
+ *
+ * Newer mutations in c0 and lc shadow the cache by virtue of being searched
+ * first, and each key ingested into cn is invalidated while its newest value
+ * is still in c0 or lc (see cn_set_ingest_inval()), hence an ingest evicts
+ * only the keys it writes.  Invalidating a key also records the seqno of its
+ * newest value, and a fill made by a reader whose view predates that seqno
+ * is discarded, since the reader may have read the value being replaced.
+ * Invalidation stamps are kept per hash slot rather than per key, such that
+ * a colliding key may be refused a fill needlessly but never a stale one.
+ *
+ * Ingesting a prefix tombstone invalidates the entire cache.
+ */
+
+struct kvs_rcache;
+struct kvs_ktuple;
+struct kvs_buf;
+
+/**
+ * kvs_rcache_create() - create a row cache
+ * @cachesz:     memory budget (bytes)
+ * @perfc_group: perfc group in which to create the row cache counters
+ * @perfc_level: perfc priority level
+ * @rc_out:      (output) row cache
+ */
+merr_t
+kvs_rcache_create(
+    size_t cachesz,
+    const char *perfc_group,
+    uint perfc_level,
+    struct kvs_rcache **rc_out) HSE_COLD;
+
+/**
+ * kvs_rcache_destroy() - destroy a row cache
+ * @rc:  row cache (may be NULL)
+ */
+void
+kvs_rcache_destroy(struct kvs_rcache *rc) HSE_COLD;
+
+/**
+ * kvs_rcache_get() - retrieve a value from the row cache
+ * @rc:    row cache
+ * @kt:    key
+ * @hash:  hash of the entire key
+ * @vbuf:  (output) value buffer
+ *
+ * Return: true if found, in which case the value is copied into @vbuf (up
+ * to its size) and vbuf->b_len is set to the length of the value.
+ */
+bool
+kvs_rcache_get(
+    struct kvs_rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    struct kvs_buf *vbuf);
+
+/**
+ * kvs_rcache_put() - insert a value retrieved from cn into the row cache
+ * @rc:    row cache
+ * @kt:    key
+ * @hash:  hash of the entire key
+ * @seqno: view seqno with which the value was retrieved
+ * @vbuf:  value (must not be truncated)
+ */
+void
+kvs_rcache_put(
+    struct kvs_rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t hash,
+    uint64_t seqno,
+    const struct kvs_buf *vbuf);
+
+/**
+ * kvs_rcache_invalidate() - invalidate a key about to be ingested
+ * @rc:    row cache
+ * @hash:  hash of the entire key
+ * @seqno: seqno of the key's newest value
+ */
+void
+kvs_rcache_invalidate(struct kvs_rcache *rc, uint64_t hash, uint64_t seqno);
+
+/**
+ * kvs_rcache_invalidate_all() - invalidate every key
+ * @rc:    row cache
+ * @seqno: seqno of the newest value being ingested
+ */
+void
+kvs_rcache_invalidate_all(struct kvs_rcache *rc, uint64_t seqno);
+
+#endif
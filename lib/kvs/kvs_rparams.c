@@ -115,6 +115,93 @@ compression_default_jsonify(const struct param_spec * const ps, const void * con
     abort();
 }
 
+static bool HSE_NONNULL(1, 2, 3)
+compression_algorithm_converter(
+    const struct param_spec * const ps,
+    const cJSON * const node,
+    void * const data)
+{
+    const char *value;
+
+    INVARIANT(ps);
+    INVARIANT(node);
+    INVARIANT(data);
+
+    if (!cJSON_IsString(node))
+        return false;
+
+    value = cJSON_GetStringValue(node);
+    if (strcmp(value, VCOMP_PARAM_LZ4) == 0) {
+        *(enum vcomp_algorithm *)data = VCOMP_ALGO_LZ4;
+    } else if (strcmp(value, VCOMP_PARAM_ZSTD) == 0) {
+        *(enum vcomp_algorithm *)data = VCOMP_ALGO_ZSTD;
+    } else {
+        log_err("Unknown compression algorithm: %s", value);
+        return false;
+    }
+
+    return true;
+}
+
+static merr_t
+compression_algorithm_stringify(
+    const struct param_spec * const ps,
+    const void * const value,
+    char * const buf,
+    const size_t buf_sz,
+    size_t * const needed_sz)
+{
+    int n;
+    enum vcomp_algorithm algo;
+    const char *param = NULL;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+    INVARIANT(buf);
+
+    algo = *(enum vcomp_algorithm *)value;
+
+    switch (algo) {
+    case VCOMP_ALGO_LZ4:
+        param = VCOMP_PARAM_LZ4;
+        break;
+    case VCOMP_ALGO_ZSTD:
+        param = VCOMP_PARAM_ZSTD;
+        break;
+    }
+
+    assert(param);
+
+    n = snprintf(buf, buf_sz, "\"%s\"", param);
+    if (n < 0)
+        return merr(EBADMSG);
+
+    if (needed_sz)
+        *needed_sz = n;
+
+    return 0;
+}
+
+static cJSON *
+compression_algorithm_jsonify(const struct param_spec * const ps, const void * const value)
+{
+    enum vcomp_algorithm algo;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    algo = *(enum vcomp_algorithm *)value;
+
+    switch (algo) {
+    case VCOMP_ALGO_LZ4:
+        return cJSON_CreateString(VCOMP_PARAM_LZ4);
+    case VCOMP_ALGO_ZSTD:
+        return cJSON_CreateString(VCOMP_PARAM_ZSTD);
+    }
+
+    abort();
+}
+
 static const struct param_spec pspecs[] = {
     {
         .ps_name = "kvs_cursor_ttl",
@@ -137,6 +224,27 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "kvs_rcache_sz",
+        .ps_description = "row cache size (bytes), 0 to disable",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U64,
+        .ps_offset = offsetof(struct kvs_rparams, kvs_rcache_sz),
+        .ps_size = PARAM_SZ(struct kvs_rparams, kvs_rcache_sz),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = HSE_KVS_RCACHE_SZ_DFLT,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = HSE_KVS_RCACHE_SZ_MIN,
+                .ps_max = HSE_KVS_RCACHE_SZ_MAX,
+            },
+        },
+    },
     {
         .ps_name = "kvs_sfx_len",
         .ps_description = "Suffix length (used by prefix probe)",
@@ -299,6 +407,48 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_compact_slices",
+        .ps_description = "max parallel key-range slices per k/kv-compaction",
+        .ps_flags = PARAM_EXPERIMENTAL | PARAM_WRITABLE,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvs_rparams, cn_compact_slices),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_compact_slices),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 4,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 1,
+                .ps_max = 16,
+            },
+        },
+    },
+    {
+        .ps_name = "cn_wbehind_qdepth",
+        .ps_description = "max in-flight mblock write buffers per kblock/vblock builder",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvs_rparams, cn_wbehind_qdepth),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_wbehind_qdepth),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 2,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 1,
+                .ps_max = 8,
+            },
+        },
+    },
     {
         .ps_name = "cn_capped_ttl",
         .ps_description = "cn cursor cache TTL (ms) for capped kvs",
@@ -669,6 +819,27 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_mclass_hot",
+        .ps_description = "leaf node read heat at which values are placed per the root age group (0 to disable)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvs_rparams, cn_mclass_hot),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_mclass_hot),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 0,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = UINT32_MAX,
+            },
+        },
+    },
     {
         .ps_name = "mclass.policy",
         .ps_description = "media class policy",
@@ -710,6 +881,48 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "value.compression.algorithm",
+        .ps_description = "Value compression algorithm (lz4 or zstd)",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvs_rparams, value.compression.algo),
+        .ps_size = PARAM_SZ(struct kvs_rparams, value.compression.algo),
+        .ps_convert = compression_algorithm_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = compression_algorithm_stringify,
+        .ps_jsonify = compression_algorithm_jsonify,
+        .ps_default_value = {
+            .as_enum = VCOMP_ALGO_LZ4,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = VCOMP_ALGO_MIN,
+                .ps_max = VCOMP_ALGO_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "value.compression.level",
+        .ps_description = "Value compression level (0 selects the algorithm's default)",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_I32,
+        .ps_offset = offsetof(struct kvs_rparams, value.compression.level),
+        .ps_size = PARAM_SZ(struct kvs_rparams, value.compression.level),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_scalar = 0,
+        },
+        .ps_bounds = {
+            .as_scalar = {
+                .ps_min = VCOMP_LEVEL_MIN,
+                .ps_max = VCOMP_LEVEL_MAX,
+            },
+        },
+    },
 };
 
 const struct param_spec *
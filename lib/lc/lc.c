@@ -82,12 +82,12 @@
 #include <hse/ikvdb/lc.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/bin_heap.h>
 #include <hse/util/bkv_collection.h>
 #include <hse/util/bonsai_tree.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/rmlock.h>
 #include <hse/util/slab.h>
 #include <hse/util/vlb.h>
@@ -633,8 +633,7 @@ copy_val(struct kvs_buf *vbuf, struct bonsai_val *val)
         ulen = bonsai_val_ulen(val);
 
         if (clen > 0) {
-            err = compress_lz4_ops.cop_decompress(
-                val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
+            err = vcomp_decompress(val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
             if (ev(err))
                 return err;
 
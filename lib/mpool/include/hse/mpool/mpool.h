@@ -423,6 +423,49 @@ mpool_mblock_write(struct mpool *mp, uint64_t mbid, const struct iovec *iov, int
 merr_t
 mpool_mblock_read(struct mpool *mp, uint64_t mbid, const struct iovec *iov, int iovc, off_t offset);
 
+/**
+ * struct mpool_aio - asynchronous mblock read request
+ *
+ * @ma_cb:  completion callback
+ * @ma_err: completion status (valid only within/after @ma_cb)
+ * @ma_len: number of bytes read (valid only within/after @ma_cb)
+ *
+ * The caller owns the request and must keep it (and the buffers described
+ * by the iovec) valid until @ma_cb has been invoked.
+ */
+struct mpool_aio {
+    void (*ma_cb)(struct mpool_aio *aio);
+    merr_t ma_err;
+    size_t ma_len;
+};
+
+/**
+ * mpool_mblock_read_async() - read data from an mblock asynchronously
+ *
+ * @mp:      mpool
+ * @mbid:    mblock object ID
+ * @iov:     iovec for output data
+ * @iov_cnt: length of iov[]
+ * @offset:  PAGE aligned offset into the mblock
+ * @aio:     read request
+ *
+ * On success, @aio->ma_cb will be invoked exactly once, either on the
+ * caller's call stack (e.g., if the backend does not support async reads)
+ * or from an mpool completion thread.  On failure the callback is not
+ * invoked.  The iovec array itself need not persist beyond this call.
+ *
+ * Return: %0 on success, merr_t on error
+ */
+/* MTF_MOCK */
+merr_t
+mpool_mblock_read_async(
+    struct mpool *mp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t offset,
+    struct mpool_aio *aio);
+
 /**
  * mpool_mblock_clone() - clone the specified mblock
  *
@@ -488,6 +531,21 @@ mpool_mblock_punch(struct mpool *mp, uint64_t mbid, off_t off, size_t len);
 merr_t
 mpool_mblock_mmap(struct mpool *mp, uint64_t mbid, const void **addr_out);
 
+/**
+ * mpool_mblock_mmap_restore() - remap a range of a mapped mblock from media
+ *
+ * @mp:   mpool
+ * @mbid: mblock id
+ * @off:  page aligned offset into the mblock
+ * @len:  page aligned length
+ *
+ * Replaces any memory the caller has overlaid on the range of the mapping
+ * returned by mpool_mblock_mmap() with the mblock's pages from media.
+ */
+/* MTF_MOCK */
+merr_t
+mpool_mblock_mmap_restore(struct mpool *mp, uint64_t mbid, size_t off, size_t len);
+
 /**
  * mpool_mblock_munmap() - unmap an mblock
  *
@@ -571,9 +629,12 @@ mpool_file_write(
     size_t *wrlen);
 
 /**
- * mpool_file_sync() - Sync mpool file
+ * mpool_file_sync() - Sync mpool file data (fdatasync)
  *
  * @file:   mpool file handle
+ *
+ * The size of an mpool file is fixed at creation, hence syncing the data
+ * suffices to make completed writes durable.
  */
 merr_t
 mpool_file_sync(struct mpool_file *file);
@@ -33,6 +33,20 @@
 #define MPOOL_MBLOCK_PREALLOC   (1u << 0) /* advisory */
 #define MPOOL_MBLOCK_PUNCH_HOLE (1u << 1)
 
+/**
+ * enum mpool_io_engine - I/O engine for mblock and mpool file data I/O
+ *
+ * @MPOOL_IO_ENGINE_SYNC:  preadv/pwritev
+ * @MPOOL_IO_ENGINE_URING: io_uring (falls back to sync if unavailable)
+ */
+enum mpool_io_engine {
+    MPOOL_IO_ENGINE_SYNC = 0,
+    MPOOL_IO_ENGINE_URING = 1,
+};
+
+#define MPOOL_IO_ENGINE_MIN MPOOL_IO_ENGINE_SYNC
+#define MPOOL_IO_ENGINE_MAX MPOOL_IO_ENGINE_URING
+
 /**
  * struct mpool_cparams - mpool create params
  *
@@ -53,11 +67,14 @@ struct mpool_cparams {
 /**
  * struct mpool_rparams - mpool run params
  *
- * @path:      storage path
+ * @dio_disable: disable direct I/O
+ * @io_engine:   data I/O engine
+ * @path:        storage path
  */
 struct mpool_rparams {
     struct {
         bool dio_disable;
+        enum mpool_io_engine io_engine;
         char path[PATH_MAX];
     } mclass[HSE_MCLASS_COUNT];
 };
@@ -112,6 +129,7 @@ struct mpool_props {
  * @mpr_write_len:    written user-data in bytes
  * @mpr_mclass:       media class
  * @mpr_ra_pages:     read-ahead size in pages
+ * @mpr_directio:     media class data files are opened for direct I/O
  */
 struct mblock_props {
     uint64_t mpr_objid;
@@ -119,6 +137,7 @@ struct mblock_props {
     uint32_t mpr_write_len;
     uint32_t mpr_mclass;
     uint16_t mpr_ra_pages;
+    bool mpr_directio;
 };
 
 struct mpool_file_cb {
@@ -8,6 +8,7 @@
 
 #include "build_config.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 
@@ -15,11 +16,14 @@
 
 #include <hse/error/merr.h>
 
+struct mpool_aio;
+
 /**
  * struct io_ops - io operations to be implemented by different IO backends
  *
- * read:  read IO
- * write: write IO
+ * read:       read IO
+ * write:      write IO
+ * read_async: asynchronous read IO, completion is signaled via aio->ma_cb
  */
 struct io_ops {
     merr_t (*read)(
@@ -29,6 +33,12 @@ struct io_ops {
         int iovcnt,
         int flags,
         size_t *rdlen);
+    merr_t (*read_async)(
+        int src_fd,
+        off_t off,
+        const struct iovec *iov,
+        int iovcnt,
+        struct mpool_aio *aio);
     merr_t (*write)(
         int dst_fd,
         off_t off,
@@ -50,4 +60,21 @@ extern const struct io_ops io_sync_ops;
 extern const struct io_ops io_pmem_ops;
 #endif /* HAVE_PMEM */
 
+#ifdef HAVE_IO_URING
+/* io_uring backend, async reads share a single ring, sync I/O uses per-thread rings */
+extern const struct io_ops io_uring_ops;
+
+merr_t
+iour_init(void);
+
+void
+iour_fini(void);
+
+bool
+iour_enabled(void);
+
+merr_t
+iour_read_async(int src_fd, off_t off, const struct iovec *iov, int iovcnt, struct mpool_aio *aio);
+#endif /* HAVE_IO_URING */
+
 #endif /* MPOOL_IO_H */
@@ -20,6 +20,17 @@ io_pmem_read(int src_fd, off_t off, const struct iovec *iov, int iovcnt, int fla
     return io_sync_ops.read(src_fd, off, iov, iovcnt, flags, rdlen);
 }
 
+merr_t
+io_pmem_read_async(
+    int src_fd,
+    off_t off,
+    const struct iovec *iov,
+    int iovcnt,
+    struct mpool_aio *aio)
+{
+    return io_sync_ops.read_async(src_fd, off, iov, iovcnt, aio);
+}
+
 merr_t
 io_pmem_write(int dst_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *wrlen)
 {
@@ -72,6 +83,7 @@ io_pmem_clone(int src_fd, off_t src_off, int tgt_fd, off_t tgt_off, size_t len,
 
 const struct io_ops io_pmem_ops = {
     .read = io_pmem_read,
+    .read_async = io_pmem_read_async,
     .write = io_pmem_write,
     .mmap = io_pmem_mmap,
     .munmap = io_pmem_munmap,
@@ -23,6 +23,7 @@
 
 #include <sys/mman.h>
 
+#include <hse/mpool/mpool.h>
 #include <hse/util/assert.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/minmax.h>
@@ -83,6 +84,23 @@ out:
     return 0;
 }
 
+/* The sync backend completes async reads on the caller's stack.
+ */
+merr_t
+io_sync_read_async(
+    int src_fd,
+    off_t off,
+    const struct iovec *iov,
+    int iovcnt,
+    struct mpool_aio *aio)
+{
+    aio->ma_len = 0;
+    aio->ma_err = io_sync_read(src_fd, off, iov, iovcnt, 0, &aio->ma_len);
+    aio->ma_cb(aio);
+
+    return 0;
+}
+
 merr_t
 io_sync_write(int dst_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *wrlen)
 {
@@ -195,6 +213,7 @@ io_sync_clone(int src_fd, off_t src_off, int tgt_fd, off_t tgt_off, size_t len,
 
 const struct io_ops io_sync_ops = {
     .read = io_sync_read,
+    .read_async = io_sync_read_async,
     .write = io_sync_write,
     .mmap = io_sync_mmap,
     .munmap = io_sync_munmap,
@@ -0,0 +1,536 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <liburing.h>
+
+#include <hse/logging/logging.h>
+#include <hse/mpool/mpool.h>
+#include <hse/util/assert.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/minmax.h>
+#include <hse/util/mutex.h>
+#include <hse/util/page.h>
+
+#include "io.h"
+
+#define IOUR_QDEPTH    (256)
+#define IOUR_BATCH_MAX (16)
+
+/**
+ * struct iour - io_uring engine
+ *
+ * @ring:    the submission/completion ring
+ * @sq_lock: serializes access to the submission queue
+ * @reaper:  completion thread, invokes the aio callbacks
+ * @refcnt:  number of open mpools using the engine
+ * @enabled: true if the ring was successfully set up
+ *
+ * A single ring is shared by all open mpools for asynchronous reads.
+ * Submissions are serialized by %sq_lock, while completions are reaped and
+ * dispatched by a dedicated thread so that the submitter never has to poll.
+ * Synchronous reads and writes use per-thread rings (see iour_rw()).
+ */
+static struct {
+    struct io_uring ring;
+    struct mutex    sq_lock;
+    pthread_t       reaper;
+    int             refcnt;
+    bool            enabled;
+} iour;
+
+static DEFINE_MUTEX(iour_lock);
+
+/* Submit every request queued on the shared ring, the caller must hold
+ * sq_lock.  A request that has been queued must never be abandoned, since
+ * the next submission would issue it regardless, hence transient failures
+ * are retried until the submission queue is empty.
+ */
+static merr_t
+iour_submit_locked(void)
+{
+    while (io_uring_sq_ready(&iour.ring) > 0) {
+        int rc;
+
+        rc = io_uring_submit(&iour.ring);
+        if (rc > 0)
+            continue;
+
+        if (rc == 0 || rc == -EINTR || rc == -EAGAIN || rc == -EBUSY) {
+            usleep(100);
+            continue;
+        }
+
+        return merr(-rc);
+    }
+
+    return 0;
+}
+
+static void *
+iour_reaper(void *arg)
+{
+    pthread_setname_np(pthread_self(), "hse_iour");
+
+    while (1) {
+        struct io_uring_cqe *cqe;
+        struct mpool_aio *aio;
+        int rc;
+
+        rc = io_uring_wait_cqe(&iour.ring, &cqe);
+        if (rc) {
+            if (rc == -EINTR || rc == -EAGAIN)
+                continue;
+
+            log_errx("io_uring_wait_cqe failed", merr(-rc));
+            break;
+        }
+
+        aio = io_uring_cqe_get_data(cqe);
+        rc = cqe->res;
+
+        io_uring_cqe_seen(&iour.ring, cqe);
+
+        /* A NULL request is the shutdown marker posted by iour_fini().
+         */
+        if (!aio)
+            break;
+
+        aio->ma_err = (rc < 0) ? merr(-rc) : 0;
+        aio->ma_len = (rc < 0) ? 0 : rc;
+
+        aio->ma_cb(aio);
+    }
+
+    return NULL;
+}
+
+merr_t
+iour_init(void)
+{
+    merr_t err = 0;
+    int rc;
+
+    mutex_lock(&iour_lock);
+    if (iour.refcnt++ > 0)
+        goto out;
+
+    rc = io_uring_queue_init(IOUR_QDEPTH, &iour.ring, 0);
+    if (rc) {
+        err = merr(-rc);
+        log_info("io_uring unavailable (%d), falling back to synchronous I/O", -rc);
+        goto out;
+    }
+
+    mutex_init(&iour.sq_lock);
+
+    rc = pthread_create(&iour.reaper, NULL, iour_reaper, NULL);
+    if (rc) {
+        err = merr(rc);
+        mutex_destroy(&iour.sq_lock);
+        io_uring_queue_exit(&iour.ring);
+        goto out;
+    }
+
+    iour.enabled = true;
+
+out:
+    mutex_unlock(&iour_lock);
+
+    return err;
+}
+
+void
+iour_fini(void)
+{
+    struct io_uring_sqe *sqe;
+    merr_t err;
+
+    mutex_lock(&iour_lock);
+    assert(iour.refcnt > 0);
+
+    if (--iour.refcnt > 0 || !iour.enabled)
+        goto out;
+
+    /* Post a drained nop so that the reaper exits only after all
+     * previously submitted requests have completed.
+     */
+    mutex_lock(&iour.sq_lock);
+    err = iour_submit_locked();
+    if (!err) {
+        sqe = io_uring_get_sqe(&iour.ring);
+        assert(sqe);
+
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, NULL);
+        io_uring_sqe_set_flags(sqe, IOSQE_IO_DRAIN);
+        err = iour_submit_locked();
+    }
+    mutex_unlock(&iour.sq_lock);
+
+    if (err)
+        log_errx("io_uring_submit failed, waiting on the reaper", err);
+
+    pthread_join(iour.reaper, NULL);
+
+    mutex_destroy(&iour.sq_lock);
+    io_uring_queue_exit(&iour.ring);
+    iour.enabled = false;
+
+out:
+    mutex_unlock(&iour_lock);
+}
+
+bool
+iour_enabled(void)
+{
+    return iour.enabled;
+}
+
+/* Queue a readv/writev without submitting it, the caller must hold sq_lock.
+ */
+static bool
+iour_prep_locked(
+    int fd,
+    off_t off,
+    const struct iovec *iov,
+    int iovcnt,
+    bool write,
+    struct mpool_aio *aio)
+{
+    struct io_uring_sqe *sqe;
+
+    sqe = io_uring_get_sqe(&iour.ring);
+    if (HSE_UNLIKELY(!sqe)) {
+        if (ev(iour_submit_locked()))
+            return false;
+
+        sqe = io_uring_get_sqe(&iour.ring);
+        if (!sqe)
+            return false;
+    }
+
+    if (write)
+        io_uring_prep_writev(sqe, fd, iov, iovcnt, off);
+    else
+        io_uring_prep_readv(sqe, fd, iov, iovcnt, off);
+
+    io_uring_sqe_set_data(sqe, aio);
+
+    return true;
+}
+
+merr_t
+iour_read_async(int src_fd, off_t off, const struct iovec *iov, int iovcnt, struct mpool_aio *aio)
+{
+    merr_t err;
+
+    INVARIANT(aio && aio->ma_cb);
+
+    mutex_lock(&iour.sq_lock);
+    if (HSE_UNLIKELY(!iour_prep_locked(src_fd, off, iov, iovcnt, false, aio))) {
+        mutex_unlock(&iour.sq_lock);
+        ev(1);
+
+        return io_sync_ops.read_async(src_fd, off, iov, iovcnt, aio);
+    }
+
+    /* Once queued, the request belongs to the ring and is completed only by
+     * the reaper.  Should the submission fail for good, the request remains
+     * queued and is issued by the next submission that succeeds.
+     */
+    err = iour_submit_locked();
+    mutex_unlock(&iour.sq_lock);
+
+    if (err)
+        log_errx("io_uring_submit failed, read left queued", err);
+
+    return 0;
+}
+
+/* Synchronous reads and writes must not depend upon the reaper, as they
+ * may be issued from a completion callback (i.e., on the reaper itself).
+ * Hence each thread lazily creates a small private ring on which it both
+ * submits and reaps its own requests.  The ring is freed at thread exit.
+ */
+#define IOUR_SYNC_QDEPTH    (IOUR_BATCH_MAX)
+#define IOUR_SYNC_IOV_MAX   (16)
+#define IOUR_SYNC_CHUNK_MIN (128 * 1024)
+
+struct iour_tls {
+    struct io_uring ring;
+    bool ready;
+    struct iovec iovv[IOUR_BATCH_MAX][IOUR_SYNC_IOV_MAX];
+};
+
+static pthread_once_t iour_tls_once = PTHREAD_ONCE_INIT;
+static pthread_key_t iour_tls_key;
+static int iour_tls_key_rc;
+
+static void
+iour_tls_free(void *arg)
+{
+    struct iour_tls *tls = arg;
+
+    if (tls->ready)
+        io_uring_queue_exit(&tls->ring);
+    free(tls);
+}
+
+static void
+iour_tls_key_create(void)
+{
+    iour_tls_key_rc = pthread_key_create(&iour_tls_key, iour_tls_free);
+}
+
+static struct iour_tls *
+iour_tls_get(void)
+{
+    struct iour_tls *tls;
+    int rc;
+
+    pthread_once(&iour_tls_once, iour_tls_key_create);
+    if (ev(iour_tls_key_rc))
+        return NULL;
+
+    tls = pthread_getspecific(iour_tls_key);
+    if (!tls) {
+        tls = calloc(1, sizeof(*tls));
+        if (ev(!tls))
+            return NULL;
+
+        if (pthread_setspecific(iour_tls_key, tls)) {
+            free(tls);
+            return NULL;
+        }
+    }
+
+    if (HSE_UNLIKELY(!tls->ready)) {
+        rc = io_uring_queue_init(IOUR_SYNC_QDEPTH, &tls->ring, 0);
+        if (ev(rc))
+            return NULL;
+
+        tls->ready = true;
+    }
+
+    return tls;
+}
+
+/* Discard the thread's ring, e.g., after a failed submission which may
+ * have left requests in its submission queue that must never be issued.
+ */
+static void
+iour_tls_reset(struct iour_tls *tls)
+{
+    io_uring_queue_exit(&tls->ring);
+    tls->ready = false;
+}
+
+static size_t
+iolen(const struct iovec *iov, int cnt)
+{
+    size_t len = 0;
+
+    while (cnt-- > 0)
+        len += iov[cnt].iov_len;
+
+    return len;
+}
+
+/* Split the I/O into up to IOUR_BATCH_MAX requests of at least
+ * IOUR_SYNC_CHUNK_MIN bytes, submit them all in a single system call so
+ * that the device can service them concurrently, and reap them on the
+ * calling thread.  Large buffers are split at page boundaries, which
+ * preserves the alignment required by direct I/O.  As with the sync
+ * backend, a short transfer ends the operation and is reflected in *xlen.
+ */
+static merr_t
+iour_rw(int fd, off_t off, const struct iovec *iov, int iovcnt, bool write, size_t *xlen)
+{
+    struct iour_tls *tls;
+    size_t iov_off = 0;
+    size_t total = 0;
+    merr_t err = 0;
+
+    tls = iour_tls_get();
+    if (!tls) {
+        /* No ring for this thread, use the sync backend.
+         */
+        if (write)
+            return io_sync_ops.write(fd, off, iov, iovcnt, 0, xlen);
+
+        return io_sync_ops.read(fd, off, iov, iovcnt, 0, xlen);
+    }
+
+    while (iovcnt > 0) {
+        size_t lenv[IOUR_BATCH_MAX], chunk;
+        int resv[IOUR_BATCH_MAX];
+        int reqc = 0, submitted = 0, reaped = 0;
+        int rc;
+
+        chunk = (iolen(iov, iovcnt) - iov_off) / IOUR_BATCH_MAX;
+        chunk = max_t(size_t, PAGE_ALIGN(chunk), IOUR_SYNC_CHUNK_MIN);
+
+        while (iovcnt > 0 && reqc < IOUR_BATCH_MAX) {
+            struct iovec *riov = tls->iovv[reqc];
+            struct io_uring_sqe *sqe;
+            int cnt = 0;
+
+            lenv[reqc] = 0;
+
+            while (iovcnt > 0 && cnt < IOUR_SYNC_IOV_MAX && lenv[reqc] < chunk) {
+                size_t len = iov->iov_len - iov_off;
+
+                /* Split a large buffer only at a page boundary. */
+                if (len > chunk - lenv[reqc]) {
+                    len = (chunk - lenv[reqc]) & PAGE_MASK;
+                    if (!len)
+                        break;
+                }
+
+                riov[cnt].iov_base = iov->iov_base + iov_off;
+                riov[cnt].iov_len = len;
+                lenv[reqc] += len;
+                ++cnt;
+
+                iov_off += len;
+                if (iov_off == iov->iov_len) {
+                    iov_off = 0;
+                    ++iov;
+                    --iovcnt;
+                }
+            }
+
+            /* The ring has room for an entire batch. */
+            sqe = io_uring_get_sqe(&tls->ring);
+            assert(sqe);
+
+            if (write)
+                io_uring_prep_writev(sqe, fd, riov, cnt, off);
+            else
+                io_uring_prep_readv(sqe, fd, riov, cnt, off);
+
+            io_uring_sqe_set_data(sqe, (void *)(uintptr_t)reqc);
+
+            off += lenv[reqc];
+            ++reqc;
+        }
+
+        while (submitted < reqc) {
+            rc = io_uring_submit_and_wait(&tls->ring, 1);
+            if (rc > 0) {
+                submitted += rc;
+                continue;
+            }
+
+            if (rc == -EINTR)
+                continue;
+
+            err = merr(rc ? -rc : EIO);
+            log_errx("io_uring_submit failed", err);
+            break;
+        }
+
+        while (reaped < submitted) {
+            struct io_uring_cqe *cqe;
+            uintptr_t i;
+
+            rc = io_uring_wait_cqe(&tls->ring, &cqe);
+            if (rc) {
+                if (rc == -EINTR || rc == -EAGAIN)
+                    continue;
+
+                err = merr(-rc);
+                log_errx("io_uring_wait_cqe failed", err);
+                break;
+            }
+
+            i = (uintptr_t)io_uring_cqe_get_data(cqe);
+            assert(i < reqc);
+            resv[i] = cqe->res;
+
+            io_uring_cqe_seen(&tls->ring, cqe);
+            ++reaped;
+        }
+
+        if (HSE_UNLIKELY(err)) {
+            iour_tls_reset(tls);
+            break;
+        }
+
+        for (int i = 0; i < reqc; ++i) {
+            if (resv[i] < 0) {
+                err = merr(-resv[i]);
+                break;
+            }
+
+            total += resv[i];
+
+            if (resv[i] != lenv[i]) {
+                ev(1);
+                iovcnt = 0;
+                break;
+            }
+        }
+
+        if (err)
+            break;
+    }
+
+    if (xlen)
+        *xlen = total;
+
+    return err;
+}
+
+static merr_t
+iour_read(int src_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *rdlen)
+{
+    return iour_rw(src_fd, off, iov, iovcnt, false, rdlen);
+}
+
+static merr_t
+iour_write(int dst_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *wrlen)
+{
+    return iour_rw(dst_fd, off, iov, iovcnt, true, wrlen);
+}
+
+static merr_t
+iour_mmap(void **addr, size_t len, int prot, int flags, int fd, off_t offset)
+{
+    return io_sync_ops.mmap(addr, len, prot, flags, fd, offset);
+}
+
+static merr_t
+iour_munmap(void *addr, size_t len)
+{
+    return io_sync_ops.munmap(addr, len);
+}
+
+static merr_t
+iour_msync(void *addr, size_t len, int flags)
+{
+    return io_sync_ops.msync(addr, len, flags);
+}
+
+static merr_t
+iour_clone(int src_fd, off_t src_off, int tgt_fd, off_t tgt_off, size_t len, int flags)
+{
+    return io_sync_ops.clone(src_fd, src_off, tgt_fd, tgt_off, len, flags);
+}
+
+const struct io_ops io_uring_ops = {
+    .read = iour_read,
+    .read_async = iour_read_async,
+    .write = iour_write,
+    .mmap = iour_mmap,
+    .munmap = iour_munmap,
+    .msync = iour_msync,
+    .clone = iour_clone,
+};
@@ -4,6 +4,7 @@
  */
 
 #include <hse/logging/logging.h>
+#include <hse/mpool/mpool.h>
 #include <hse/util/event_counter.h>
 
 #include "mblock_file.h"
@@ -98,8 +99,10 @@ mpool_mblock_props_get(struct mpool *mp, uint64_t mbid, struct mblock_props *pro
     if (err)
         return err;
 
-    if (props)
+    if (props) {
         props->mpr_ra_pages = mclass_ra_pages(mc);
+        props->mpr_directio = mclass_supports_directio(mc);
+    }
 
     return 0;
 }
@@ -138,6 +141,29 @@ mpool_mblock_read(struct mpool *mp, uint64_t mbid, const struct iovec *iov, int
     return mblock_fset_read(mclass_fset(mc), mbid, iov, iovc, off);
 }
 
+merr_t
+mpool_mblock_read_async(
+    struct mpool *mp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    struct mpool_aio *aio)
+{
+    struct media_class *mc;
+    enum hse_mclass mclass;
+
+    if (!mp || !iov || !aio || !aio->ma_cb)
+        return merr(EINVAL);
+
+    mclass = mcid_to_mclass(mclassid(mbid));
+    mc = mpool_mclass_handle(mp, mclass);
+    if (!mc)
+        return merr(ENOENT);
+
+    return mblock_fset_read_async(mclass_fset(mc), mbid, iov, iovc, off, aio);
+}
+
 merr_t
 mpool_mblock_punch(struct mpool *mp, uint64_t mbid, off_t off, size_t len)
 {
@@ -192,6 +218,21 @@ mpool_mblock_mmap(struct mpool *mp, uint64_t mbid, const void **addr_out)
     return err;
 }
 
+merr_t
+mpool_mblock_mmap_restore(struct mpool *mp, uint64_t mbid, size_t off, size_t len)
+{
+    struct media_class *mc;
+
+    if (!mp || !mbid)
+        return merr(EINVAL);
+
+    mc = mpool_mclass_handle(mp, mcid_to_mclass(mclassid(mbid)));
+    if (!mc)
+        return merr(ENOENT);
+
+    return mblock_fset_map_restore(mclass_fset(mc), mbid, off, len);
+}
+
 merr_t
 mpool_mblock_munmap(struct mpool *mp, uint64_t mbid)
 {
@@ -8,6 +8,7 @@
 #include <sys/mman.h>
 
 #include <hse/logging/logging.h>
+#include <hse/mpool/mpool.h>
 #include <hse/util/assert.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/log2.h>
@@ -687,6 +688,7 @@ mblock_file_open(
     mbfp->mcid = mcid;
     mbfp->mblocksz = mblocksz;
     mbfp->dataio = io_sync_ops;
+    mclass_io_engine_apply(mc, &mbfp->dataio);
     mbfp->metaio = *params->metaio;
 
     mbfp->fszmax = fszmax;
@@ -1125,19 +1127,20 @@ iov_len_get(const struct iovec *iov, int iovc, size_t *tlen)
     return 0;
 }
 
-merr_t
-mblock_read(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, int iovc, off_t off)
+static merr_t
+mblock_read_check(
+    struct mblock_file *mbfp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    off_t *roff_out)
 {
     uint32_t block;
     off_t roff, eoff;
     size_t len = 0, mblocksz, wlen;
     merr_t err;
 
-    INVARIANT(mbfp && iov);
-
-    if (iovc == 0)
-        return 0;
-
     if (!PAGE_ALIGNED(off))
         return merr(EINVAL);
 
@@ -1164,6 +1167,26 @@ mblock_read(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, in
         return merr(EINVAL);
     }
 
+    *roff_out = roff;
+
+    return 0;
+}
+
+merr_t
+mblock_read(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, int iovc, off_t off)
+{
+    off_t roff;
+    merr_t err;
+
+    INVARIANT(mbfp && iov);
+
+    if (iovc == 0)
+        return 0;
+
+    err = mblock_read_check(mbfp, mbid, iov, iovc, off, &roff);
+    if (err)
+        return err;
+
     hse_wmesg_tls = "mbread";
     err = mbfp->dataio.read(mbfp->fd, roff, iov, iovc, 0, NULL);
     hse_wmesg_tls = "-";
@@ -1171,6 +1194,34 @@ mblock_read(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, in
     return err;
 }
 
+merr_t
+mblock_read_async(
+    struct mblock_file *mbfp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    struct mpool_aio *aio)
+{
+    off_t roff;
+    merr_t err;
+
+    INVARIANT(mbfp && iov && aio);
+
+    if (iovc == 0) {
+        aio->ma_err = 0;
+        aio->ma_len = 0;
+        aio->ma_cb(aio);
+        return 0;
+    }
+
+    err = mblock_read_check(mbfp, mbid, iov, iovc, off, &roff);
+    if (err)
+        return err;
+
+    return mbfp->dataio.read_async(mbfp->fd, roff, iov, iovc, aio);
+}
+
 merr_t
 mblock_write(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, int iovc)
 {
@@ -1353,6 +1404,44 @@ mblock_unmap(struct mblock_file *mbfp, uint64_t mbid)
     return err;
 }
 
+merr_t
+mblock_map_restore(struct mblock_file *mbfp, uint64_t mbid, size_t off, size_t len)
+{
+    struct mblock_mmap *map;
+    size_t mblocksz;
+    off_t soff, coff;
+    merr_t err = 0;
+    void *addr;
+
+    INVARIANT(mbfp);
+
+    mblocksz = mbfp->mblocksz;
+    if (ev(off + len > mblocksz || !PAGE_ALIGNED(off) || !PAGE_ALIGNED(len)))
+        return merr(EINVAL);
+
+    map = &mbfp->mmapv[chunk_idx(mbid, mblocksz)];
+    soff = chunk_start_off(mbid, mblocksz);
+    coff = chunk_off(mbid, mblocksz);
+
+    mutex_lock(&mbfp->mmap_lock);
+    if (map->addr) {
+        addr = map->addr + coff + off;
+
+        /* MAP_FIXED atomically replaces whatever is mapped over the range,
+         * so concurrent readers see either the old or the file pages.
+         */
+        err = mbfp->dataio.mmap(
+            &addr, len, PROT_READ, MAP_SHARED | MAP_FIXED, mbfp->fd, soff + coff + off);
+        if (!err && madvise(addr, len, MADV_RANDOM))
+            err = merr(errno);
+    } else {
+        err = merr(EINVAL);
+    }
+    mutex_unlock(&mbfp->mmap_lock);
+
+    return err;
+}
+
 static void
 mblock_file_unmap(struct mblock_file *mbfp)
 {
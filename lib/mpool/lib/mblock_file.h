@@ -73,6 +73,7 @@ struct mblock_fset;
 struct mblock_file;
 struct kmem_cache;
 struct io_ops;
+struct mpool_aio;
 
 /**
  * struct mblock_filehdr - mblock file header stored in metadata file
@@ -257,6 +258,25 @@ mblock_punch(struct mblock_file *mbfp, uint64_t mbid, off_t off, size_t len);
 merr_t
 mblock_read(struct mblock_file *mbfp, uint64_t mbid, const struct iovec *iov, int iovc, off_t off);
 
+/**
+ * mblock_read_async() - read an mblock object asynchronously
+ *
+ * @mbfp: mblock file handle
+ * @mbid: mblock id
+ * @iov:  iovec ptr
+ * @iovc: iov count
+ * @off:  offset
+ * @aio:  read request
+ */
+merr_t
+mblock_read_async(
+    struct mblock_file *mbfp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    struct mpool_aio *aio);
+
 /**
  * mblock_write() - write an mblock object
  *
@@ -309,6 +329,17 @@ mblock_map_getbase(struct mblock_file *mbfp, uint64_t mbid, char **addr_out, uin
 merr_t
 mblock_unmap(struct mblock_file *mbfp, uint64_t mbid);
 
+/**
+ * mblock_map_restore() - remap a range of a mapped mblock from the file
+ *
+ * @mbfp: mblock file handle
+ * @mbid: mblock id
+ * @off:  page aligned offset into the mblock
+ * @len:  page aligned length
+ */
+merr_t
+mblock_map_restore(struct mblock_file *mbfp, uint64_t mbid, size_t off, size_t len);
+
 /**
  * mblock_file_info_get() - get mblock file info
  *
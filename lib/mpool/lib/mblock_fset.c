@@ -753,6 +753,25 @@ mblock_fset_read(
     return mblock_read(mbfp, mbid, iov, iovc, off);
 }
 
+merr_t
+mblock_fset_read_async(
+    struct mblock_fset *mbfsp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    struct mpool_aio *aio)
+{
+    struct mblock_file *mbfp;
+
+    if (!mbfsp || file_id(mbid) > mbfsp->mhdr.fcnt)
+        return merr(EINVAL);
+
+    mbfp = mbfsp->filev[file_index(mbid)];
+
+    return mblock_read_async(mbfp, mbid, iov, iovc, off, aio);
+}
+
 merr_t
 mblock_fset_map_getbase(struct mblock_fset *mbfsp, uint64_t mbid, char **addr_out, uint32_t *wlen)
 {
@@ -766,6 +785,19 @@ mblock_fset_map_getbase(struct mblock_fset *mbfsp, uint64_t mbid, char **addr_ou
     return mblock_map_getbase(mbfp, mbid, addr_out, wlen);
 }
 
+merr_t
+mblock_fset_map_restore(struct mblock_fset *mbfsp, uint64_t mbid, size_t off, size_t len)
+{
+    struct mblock_file *mbfp;
+
+    if (!mbfsp || file_id(mbid) > mbfsp->mhdr.fcnt)
+        return merr(EINVAL);
+
+    mbfp = mbfsp->filev[file_index(mbid)];
+
+    return mblock_map_restore(mbfp, mbid, off, len);
+}
+
 merr_t
 mblock_fset_unmap(struct mblock_fset *mbfsp, uint64_t mbid)
 {
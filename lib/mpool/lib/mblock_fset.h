@@ -131,6 +131,25 @@ mblock_fset_read(
     int iovc,
     off_t off);
 
+/**
+ * mblock_fset_read_async() - read an mblock asynchronously
+ *
+ * @mbfsp: mblock fileset handle
+ * @mbid:  mblock id
+ * @iov:   iovec ptr
+ * @iovc:  iovec cnt
+ * @off:   offset to read from
+ * @aio:   read request
+ */
+merr_t
+mblock_fset_read_async(
+    struct mblock_fset *mbfsp,
+    uint64_t mbid,
+    const struct iovec *iov,
+    int iovc,
+    off_t off,
+    struct mpool_aio *aio);
+
 /**
  * mblock_fset_find() - find an mblock and return props
  *
@@ -153,6 +172,17 @@ mblock_fset_find(struct mblock_fset *mbfsp, uint64_t *mbidv, int mbidc, struct m
 merr_t
 mblock_fset_map_getbase(struct mblock_fset *mbfsp, uint64_t mbid, char **addr_out, uint32_t *wlen);
 
+/**
+ * mblock_fset_map_restore() - remap a range of the specified mblock from its file
+ *
+ * @mbfsp: mblock fileset handle
+ * @mbid:  mblock id
+ * @off:   page aligned offset into the mblock
+ * @len:   page aligned length
+ */
+merr_t
+mblock_fset_map_restore(struct mblock_fset *mbfsp, uint64_t mbid, size_t off, size_t len);
+
 /**
  * mblock_fset_unmap() - unmap the specified mblock
  *
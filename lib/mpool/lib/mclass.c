@@ -45,6 +45,7 @@ struct media_class {
     enum mclass_id mcid;
     bool gclose;
     bool directio;
+    enum mpool_io_engine ioengine;
     uint16_t ra_pages;
     char *dpath;
     char *upath;
@@ -123,6 +124,7 @@ mclass_open(
 
     mc->dirp = dirp;
     mc->mcid = mclass_to_mcid(mclass);
+    mc->ioengine = params->ioengine;
 
     err = get_ra_pages(dirp, &mc->ra_pages);
     if (err)
@@ -467,6 +469,29 @@ mclass_io_ops_set(enum hse_mclass mclass, struct io_ops *io)
 #endif
 }
 
+void
+mclass_io_engine_apply(const struct media_class *mc, struct io_ops *io)
+{
+    INVARIANT(mc && io);
+
+#ifdef HAVE_IO_URING
+    if (!iour_enabled())
+        return;
+
+    io->read_async = io_uring_ops.read_async;
+
+    /* pmem data is accessed via mmap, hence storage.pmem.io_engine admits
+     * only the sync engine.
+     */
+    assert(mc->mcid != MCID_PMEM || mc->ioengine == MPOOL_IO_ENGINE_SYNC);
+
+    if (mc->ioengine == MPOOL_IO_ENGINE_URING) {
+        io->read = io_uring_ops.read;
+        io->write = io_uring_ops.write;
+    }
+#endif
+}
+
 merr_t
 mclass_info_get(const struct media_class *mc, struct hse_mclass_info *info)
 {
@@ -36,12 +36,14 @@ enum mclass_id {
  * @fmaxsz:   max file size
  * @mblocksz: mblock size
  * @filecnt:  number of files in an mclass fileset
+ * @ioengine: data I/O engine
  * @path:     storage path
  */
 struct mclass_params {
     size_t fmaxsz;
     size_t mblocksz;
     uint8_t filecnt;
+    enum mpool_io_engine ioengine;
     char path[PATH_MAX];
 };
 
@@ -194,6 +196,15 @@ mclass_gclose_get(const struct media_class *mc);
 void
 mclass_io_ops_set(enum hse_mclass mclass, struct io_ops *io);
 
+/**
+ * mclass_io_engine_apply() - route data reads/writes through the mclass io engine
+ *
+ * @mc: mclass handle
+ * @io: io_ops (in/out), only the read/write methods are updated
+ */
+void
+mclass_io_engine_apply(const struct media_class *mc, struct io_ops *io);
+
 /**
  * mclass_info_get() - get media class info
  *
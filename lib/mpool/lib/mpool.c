@@ -26,6 +26,7 @@
 #include <hse/util/page.h>
 #include <hse/util/workqueue.h>
 
+#include "io.h"
 #include "mblock_file.h"
 #include "mblock_fset.h"
 #include "mpool_internal.h"
@@ -356,6 +357,12 @@ mpool_open(
 
     strcpy((char *)mp->home, home);
 
+#ifdef HAVE_IO_URING
+    /* Failure here isn't fatal, async reads then complete synchronously.
+     */
+    ev(iour_init());
+#endif
+
     for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         struct mclass_params mcp = { 0 };
         uint32_t oflags = flags;
@@ -364,6 +371,15 @@ mpool_open(
         if (err)
             goto errout;
 
+        mcp.ioengine = rparams->mclass[i].io_engine;
+
+        /* pmem data is accessed via mmap, which no other engine can improve.
+         */
+        if (i == HSE_MCLASS_PMEM && mcp.ioengine != MPOOL_IO_ENGINE_SYNC) {
+            err = merr(EINVAL);
+            goto errout;
+        }
+
         if (!rparams->mclass[i].dio_disable) {
             bool tmpfs;
 
@@ -396,6 +412,10 @@ errout:
     while (i-- > HSE_MCLASS_BASE)
         mclass_close(mp->mc[i]);
 
+#ifdef HAVE_IO_URING
+    iour_fini();
+#endif
+
     free(mp);
 
     return err;
@@ -417,6 +437,10 @@ mpool_close(struct mpool *mp)
         }
     }
 
+#ifdef HAVE_IO_URING
+    iour_fini();
+#endif
+
     free(mp);
 
     return err;
@@ -102,6 +102,7 @@ mpool_file_open(
     mfp->fd = fd;
     strcpy((char *)mfp->name, name);
     mclass_io_ops_set(mclass, &mfp->io);
+    mclass_io_engine_apply(mc, &mfp->io);
 
     *handle = mfp;
 
@@ -127,7 +128,7 @@ mpool_file_close(struct mpool_file *file)
     err = mpool_file_unmap(file);
     ev(err);
 
-    rc = fsync(file->fd);
+    rc = fdatasync(file->fd);
     if (rc == -1)
         return merr(errno);
 
@@ -35,9 +35,25 @@ bkv_collection_add(struct bkv_collection *bkvc, struct bonsai_kv *bkv, struct bo
 merr_t
 bkv_collection_apply(struct bkv_collection *bkvc);
 
+struct bonsai_kv *
+bkv_collection_bkv_get(struct bkv_collection *bkvc, size_t idx);
+
 merr_t
 bkv_collection_finish_pair(struct bkv_collection *bkvc1, struct bkv_collection *bkvc2);
 
+/* Like bkv_collection_finish_pair(), but limited to the entries in the range
+ * [startv[i], endv[i]) of each collection, and passing rock to the callback in
+ * lieu of the collections' cbarg.  Callers may finish disjoint ranges of the
+ * same pair of collections concurrently.
+ */
+merr_t
+bkv_collection_finish_pair_range(
+    struct bkv_collection *bkvc1,
+    struct bkv_collection *bkvc2,
+    const size_t *startv,
+    const size_t *endv,
+    void *rock);
+
 merr_t
 bkv_collection_init(void);
 
@@ -42,6 +42,21 @@ struct bloom_filter_stats {
     uint32_t bfs_filter_bits;
 };
 
+/* Split-block layout:
+ *
+ * Each 512-bit bucket is divided into BF_SB_LANES 32-bit lanes.  A key sets
+ * one bit in each of n consecutive lanes (modulo BF_SB_LANES), starting at a
+ * lane selected by the hash.  The bit within each lane is derived from the
+ * upper half of the hash and a per-lane salt.  Hence all n bits of a key are
+ * independent of each other and may be computed and tested in parallel with
+ * a few vector instructions (see bf_sb_lookup()).  Bit b of lane l resides
+ * at bit offset (l * 32 + b) of the bucket.
+ */
+#define BF_SB_BKTSHIFT (9)
+#define BF_SB_LANES    (16)
+
+extern const uint32_t bf_sb_saltv[BF_SB_LANES];
+
 static HSE_ALWAYS_INLINE uint64_t
 bf_rotl(const uint64_t x, uint32_t k)
 {
@@ -97,6 +112,8 @@ bf_hash2bit(uint64_t *hashp, uint32_t rotl, uint32_t mask)
  * @rotl:       number of bits to rotate left
  * @mask:       bloom bucket bit mask
  *
+ * Probes a bucket in the original (non-split) layout.
+ *
  * Return:
  *     Returns %true if all n hashes have bits set in the bucket,
  *     otherwise returns %false.
@@ -118,6 +135,9 @@ bf_lookup(uint64_t hash, const uint8_t *bitmap, int32_t n, uint32_t rotl, uint32
  * bf_populate() - populate a bloom bucket with given %hash
  * @hash:       hash used to select the bucket
  *
+ * Populates a bucket in the original (non-split) layout, new filters
+ * are built with bf_sb_populate().
+ *
  * Ideally we'd like to use n statistically independent hashes for the block
  * bloom, but for our use case the additional computation is infeasible.
  * Instead, we exploit properties of xxhash64 (good entropy and avalanche)
@@ -148,6 +168,51 @@ bf_populate(const struct bloom_filter *bf, uint64_t hash)
     }
 }
 
+/**
+ * bf_sb_hash2bit() - determine bit offset of a hash within a split-block bucket
+ * @hash:   hash used to select the bucket
+ * @nth:    nth bit of the hash (0 <= nth < BF_SB_LANES)
+ */
+static HSE_ALWAYS_INLINE uint32_t
+bf_sb_hash2bit(uint64_t hash, uint32_t nth)
+{
+    const uint32_t lane = (hash + nth) % BF_SB_LANES;
+
+    return lane * 32 + (((uint32_t)(hash >> 32) * bf_sb_saltv[lane]) >> 27);
+}
+
+/**
+ * bf_sb_populate() - populate a split-block bloom bucket with given %hash
+ * @bf:         bloom filter
+ * @hash:       hash used to select the bucket
+ */
+static HSE_ALWAYS_INLINE void
+bf_sb_populate(const struct bloom_filter *bf, uint64_t hash)
+{
+    uint8_t *bitmap = bf->bf_bitmap;
+    uint32_t n = bf->bf_n_hashes;
+
+    bitmap += bf_hash2bkt(hash, bf->bf_modulus, BF_SB_BKTSHIFT);
+
+    while (n-- > 0)
+        setbit(bitmap, bf_sb_hash2bit(hash, n));
+}
+
+/**
+ * bf_sb_lookup() - check to see if hash is in a split-block bloom bucket
+ * @hash:       hash used to select the bucket
+ * @bitmap:     base byte address of the bucket
+ * @n:          number of hashes to check (at most BF_SB_LANES)
+ *
+ * Uses AVX-512 or AVX2 if supported by the cpu.
+ *
+ * Return:
+ *     Returns %true if all n hashes have bits set in the bucket,
+ *     otherwise returns %false.
+ */
+bool
+bf_sb_lookup(uint64_t hash, const uint8_t *bitmap, uint32_t n);
+
 struct bf_bithash_desc
 bf_compute_bithash_est(uint32_t probability);
 
@@ -53,6 +53,11 @@
  */
 #define HSE_BTF_MANAGED             (0x0001)
 
+/* Same as HSE_BTF_MANAGED, but applies only to the value.
+ * The key is copied into the bonsai tree as usual.
+ */
+#define HSE_BTF_MANAGED_VAL         (0x0002)
+
 enum bonsai_ior_code {
     B_IOR_INVALID       = 0,
     B_IOR_INSERTED      = 1,
@@ -98,8 +103,11 @@ struct bonsai_skey {
  *
  * Note that the value length (@bv_xlen) is an opaque encoding of compressed
  * and uncompressed value lengths so one must use the bonsai_val_*len()
- * functions to decode it.
+ * functions to decode it.  The most significant bit of the uncompressed
+ * length is reserved for use by the caller as a tag.
  */
+#define BONSAI_XLEN_ULEN_MASK (0x7ffffffful)
+
 struct bonsai_val {
     uintptr_t          bv_seqnoref;
     struct bonsai_val *bv_next;
@@ -121,7 +129,7 @@ struct bonsai_val {
 static HSE_ALWAYS_INLINE uint
 bonsai_val_ulen(const struct bonsai_val *bv)
 {
-    return bv->bv_xlen & 0xfffffffful;
+    return bv->bv_xlen & BONSAI_XLEN_ULEN_MASK;
 }
 
 /**
@@ -179,7 +187,7 @@ static HSE_ALWAYS_INLINE uint
 bonsai_sval_vlen(const struct bonsai_sval *bsv)
 {
     uint clen = bsv->bsv_xlen >> 32;
-    uint vlen = bsv->bsv_xlen & 0xfffffffful;
+    uint vlen = bsv->bsv_xlen & BONSAI_XLEN_ULEN_MASK;
 
     return clen ?: vlen;
 }
@@ -13,8 +13,16 @@
 typedef uint
 compress_op_estimate_t(const void *data, uint len);
 
+/* %level is algorithm specific, zero selects the algorithm's default level.
+ */
 typedef merr_t
-compress_op_compress_t(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len);
+compress_op_compress_t(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len);
 
 typedef merr_t
 compress_op_decompress_t(
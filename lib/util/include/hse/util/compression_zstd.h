@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2020 Micron Technology, Inc.
+ */
+
+#ifndef HSE_UTIL_COMPRESS_ZSTD_H
+#define HSE_UTIL_COMPRESS_ZSTD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <hse/util/compression.h>
+
+/* Every zstd frame begins with this (little-endian) magic number.  The LZ4
+ * block encoder never emits these four bytes as the start of a compressed
+ * block, hence a compressed value's algorithm can be inferred from its first
+ * four bytes without recording it on media.
+ */
+#define COMPRESS_ZSTD_MAGIC (0xfd2fb528u)
+
+/**
+ * compress_zstd_frame() - check whether a compressed buffer is a zstd frame
+ */
+static inline bool
+compress_zstd_frame(const void *src, uint src_len)
+{
+    const uint8_t *p = src;
+
+    if (src_len < 4)
+        return false;
+
+    return (p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24)) == COMPRESS_ZSTD_MAGIC;
+}
+
+extern struct compress_ops compress_zstd_ops;
+
+#endif
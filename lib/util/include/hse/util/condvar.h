@@ -88,6 +88,16 @@ cv_destroy(struct cv *cv);
 int
 cv_timedwait(struct cv *cv, struct mutex *mtx, const long timeout, const char *wmesg);
 
+/**
+ * cv_timedwait_ns() - cv_timedwait() with a timeout in nanoseconds
+ * @cv:         ptr to a condition variable
+ * @mtx:        ptr to mutex
+ * @timeout:    maximum number of nanoseconds to sleep
+ * @wmesg:      wait message, must reside in global memory
+ */
+int
+cv_timedwait_ns(struct cv *cv, struct mutex *mtx, const long timeout, const char *wmesg);
+
 /**
  * cv_wait() - wait for condition variable to be signaled
  * @cv:     ptr to a condition variable
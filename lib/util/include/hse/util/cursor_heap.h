@@ -18,6 +18,7 @@
 #include <stdint.h>
 
 #include <hse/error/merr.h>
+#include <hse/util/atomic.h>
 #include <hse/util/base.h>
 
 #ifdef HSE_BUILD_RELEASE
@@ -28,12 +29,15 @@
 
 /* Everything in this structure is opaque to callers (but not really,
  * because the cheap unit tests need access to the implementation).
+ *
+ * The cursor is advanced atomically such that cheap_malloc(),
+ * cheap_memalign() and cheap_free() may be called concurrently.  All other
+ * functions require the caller to serialize access to the cheap.
  */
 struct cheap {
     size_t alignment;
-    uint64_t cursorp;
+    atomic_ulong cursorp;
     size_t size;
-    uint64_t lastp;
     uint64_t base;
     uint64_t brk;
     void *mem;
@@ -117,8 +121,16 @@ cheap_calloc(struct cheap *h, size_t size)
     return mem;
 }
 
+/**
+ * cheap_free() - return the most recent allocation to the cheap
+ * @h:    the cheap from which @addr was allocated
+ * @addr: the allocation (may be NULL)
+ * @size: the size given to the allocation call
+ *
+ * Nothing is freed unless @addr is the most recent allocation.
+ */
 void
-cheap_free(struct cheap *h, void *addr);
+cheap_free(struct cheap *h, void *addr, size_t size);
 
 /**
  * cheap_memalign() - allocate aligned storage from a cheap
@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#ifndef HSE_PLATFORM_FUSE_FILTER_H
+#define HSE_PLATFORM_FUSE_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/compiler.h>
+
+/* Binary fuse filter:
+ *
+ * A static filter built from the complete set of key hashes.  Each key maps
+ * to three slots, one in each of three consecutive segments of an array of
+ * f-bit fingerprints.  The array is solved such that the xor of a key's three
+ * slots yields the key's fingerprint, hence a lookup reads three slots and
+ * compares.  The false positive rate is 2^-f at roughly 1.125 * f bits per
+ * key (about 9 bits per key at 0.4%), whereas a bloom filter needs about
+ * 1.44 * log2(1/fpp) bits per key (over 13 bits per key at 0.4%).
+ *
+ * Fingerprints are 8, 12 or 16 bits wide, packed little-endian (two 12-bit
+ * fingerprints per three bytes).  See Graf and Lemire, "Binary Fuse Filters:
+ * Fast and Smaller Than Xor Filters", ACM JEA 27 (2022).
+ */
+#define FF_ARITY       (3)
+#define FF_FPBITS_MIN  (8)
+#define FF_FPBITS_MID  (12)
+#define FF_FPBITS_MAX  (16)
+#define FF_SEGLEN_BITS (18)
+
+struct fuse_filter {
+    uint8_t *ff_fpv;
+    size_t ff_fpvsz;
+    uint64_t ff_seed;
+    uint32_t ff_fpbits;
+    uint32_t ff_seglen_shift;
+    uint32_t ff_seg_count_len;
+    uint32_t ff_array_len;
+};
+
+/**
+ * ff_mix() - derive the filter hash of a key from its 64-bit key hash
+ * @hash:   key hash
+ * @seed:   filter seed
+ */
+static HSE_ALWAYS_INLINE uint64_t
+ff_mix(uint64_t hash, uint64_t seed)
+{
+    hash += seed;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/**
+ * ff_hash2slots() - determine the three fingerprint slots of a filter hash
+ * @fh:             filter hash (from ff_mix())
+ * @seglen_shift:   log2 of the segment length
+ * @seg_count_len:  number of slots from which the first slot is chosen
+ * @slotv:          (output) slot indices
+ */
+static HSE_ALWAYS_INLINE void
+ff_hash2slots(uint64_t fh, uint32_t seglen_shift, uint32_t seg_count_len, uint32_t *slotv)
+{
+    const uint32_t seglen = 1u << seglen_shift;
+    const uint32_t mask = seglen - 1;
+    uint32_t h0;
+
+    h0 = ((__uint128_t)fh * seg_count_len) >> 64;
+
+    slotv[0] = h0;
+    slotv[1] = (h0 + seglen) ^ ((fh >> 18) & mask);
+    slotv[2] = (h0 + seglen * 2) ^ (fh & mask);
+}
+
+static HSE_ALWAYS_INLINE uint32_t
+ff_fingerprint(uint64_t fh, uint32_t fpbits)
+{
+    return (fh ^ (fh >> 32)) & ((1u << fpbits) - 1);
+}
+
+static HSE_ALWAYS_INLINE bool
+ff_fpbits_valid(uint32_t fpbits)
+{
+    return fpbits == FF_FPBITS_MIN || fpbits == FF_FPBITS_MID || fpbits == FF_FPBITS_MAX;
+}
+
+/**
+ * ff_fpv_size() - size in bytes of an array of %slots fingerprints
+ */
+static HSE_ALWAYS_INLINE size_t
+ff_fpv_size(uint32_t fpbits, uint32_t slots)
+{
+    return ((size_t)slots * fpbits + 7) / 8;
+}
+
+static HSE_ALWAYS_INLINE uint32_t
+ff_fpget(const uint8_t *fpv, uint32_t fpbits, uint32_t slot)
+{
+    size_t off;
+    uint32_t fp;
+
+    if (fpbits == FF_FPBITS_MIN)
+        return fpv[slot];
+
+    if (fpbits == FF_FPBITS_MAX)
+        return fpv[slot * 2] | ((uint32_t)fpv[slot * 2 + 1] << 8);
+
+    /* Slot 2n occupies the low 12 bits of bytes 3n..3n+1, slot 2n+1 the
+     * high 12 bits of bytes 3n+1..3n+2.
+     */
+    off = ((size_t)slot * 3) >> 1;
+    fp = fpv[off] | ((uint32_t)fpv[off + 1] << 8);
+
+    return (slot & 1) ? fp >> 4 : fp & 0xfff;
+}
+
+/**
+ * ff_lookup() - check to see if hash is in a binary fuse filter
+ * @hash:           key hash
+ * @fpv:            base address of the fingerprint array
+ * @fpbits:         bits per fingerprint
+ * @seed:           filter seed
+ * @seglen_shift:   log2 of the segment length
+ * @seg_count_len:  number of slots from which the first slot is chosen
+ *
+ * Return:
+ *     Returns %false if the key is definitely not in the filter,
+ *     otherwise returns %true.
+ */
+static HSE_ALWAYS_INLINE bool
+ff_lookup(
+    uint64_t hash,
+    const uint8_t *fpv,
+    uint32_t fpbits,
+    uint64_t seed,
+    uint32_t seglen_shift,
+    uint32_t seg_count_len)
+{
+    const uint64_t fh = ff_mix(hash, seed);
+    uint32_t slotv[FF_ARITY];
+    uint32_t fp;
+
+    ff_hash2slots(fh, seglen_shift, seg_count_len, slotv);
+
+    fp = ff_fingerprint(fh, fpbits);
+    fp ^= ff_fpget(fpv, fpbits, slotv[0]);
+    fp ^= ff_fpget(fpv, fpbits, slotv[1]);
+    fp ^= ff_fpget(fpv, fpbits, slotv[2]);
+
+    return fp == 0;
+}
+
+/**
+ * ff_compute_fpbits_est() - fingerprint width for a false positive rate
+ * @probability:  false positive rate times 1000000 (as for bloom filters)
+ *
+ * Returns the smallest fingerprint width whose false positive rate does
+ * not exceed %probability.
+ */
+uint32_t
+ff_compute_fpbits_est(uint32_t probability);
+
+/**
+ * ff_size_estimate() - size in bytes of a filter for %num_elmnts keys
+ */
+size_t
+ff_size_estimate(uint32_t fpbits, uint32_t num_elmnts);
+
+/**
+ * ff_element_estimate() - max number of keys a filter of %size_in_bytes can hold
+ */
+uint32_t
+ff_element_estimate(uint32_t fpbits, size_t size_in_bytes);
+
+/**
+ * ff_filter_build() - build a binary fuse filter from a set of key hashes
+ * @filter:      filter to initialize
+ * @fpbits:      bits per fingerprint (FF_FPBITS_MIN, FF_FPBITS_MID or FF_FPBITS_MAX)
+ * @hashv:       vector of key hashes
+ * @hashc:       number of hashes in %hashv
+ * @storage:     fingerprint array storage
+ * @storage_sz:  size of %storage, at least ff_size_estimate(fpbits, hashc)
+ *
+ * Duplicate hashes in %hashv are permitted.  Bytes of %storage beyond
+ * the fingerprint array are zeroed.
+ */
+merr_t
+ff_filter_build(
+    struct fuse_filter *filter,
+    uint32_t fpbits,
+    const uint64_t *hashv,
+    uint32_t hashc,
+    uint8_t *storage,
+    size_t storage_sz);
+
+#endif
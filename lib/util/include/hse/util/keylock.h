@@ -58,6 +58,17 @@ keylock_lock(
 void
 keylock_unlock(struct keylock *handle, uint64_t hash, uint32_t owner);
 
+/**
+ * keylock_owner() - retrieve the owner of the lock identified by %hash
+ * @handle:     handle from keylock_create()
+ * @hash:       64-bit key to identify the lock
+ * @owner:      (output) owner ID of the current holder
+ *
+ * Return: %true if the lock is held, in which case %owner is set.
+ */
+bool
+keylock_owner(struct keylock *handle, uint64_t hash, uint32_t *owner);
+
 #if HSE_MOCKING
 void
 keylock_search(struct keylock *handle, uint64_t hash, unsigned int *index);
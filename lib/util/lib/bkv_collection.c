@@ -145,20 +145,37 @@ bkv_collection_apply(struct bkv_collection *bkvc)
     return err;
 }
 
+struct bonsai_kv *
+bkv_collection_bkv_get(struct bkv_collection *bkvc, size_t idx)
+{
+    assert(idx < bkvc->bkvcol_cnt);
+
+    return bkvc->bkvcol_entry[idx].bkv;
+}
+
 struct bkv_collection_pair {
     struct bkv_collection *bkvc[2];
-    int idx[2];
+    size_t idx[2];
+    size_t end[2];
 };
 
 static void
 bkv_collection_pair_init(
     struct bkv_collection *bkvc1,
     struct bkv_collection *bkvc2,
+    const size_t *startv,
+    const size_t *endv,
     struct bkv_collection_pair *pair)
 {
     pair->bkvc[0] = bkvc1;
     pair->bkvc[1] = bkvc2;
-    pair->idx[0] = pair->idx[1] = 0;
+
+    for (int i = 0; i < 2; i++) {
+        assert(startv[i] <= endv[i] && endv[i] <= pair->bkvc[i]->bkvcol_cnt);
+
+        pair->idx[i] = startv[i];
+        pair->end[i] = endv[i];
+    }
 }
 
 static bool
@@ -168,16 +185,17 @@ bkv_collection_pair_next(
     struct bonsai_val **vlist)
 {
     struct bkv_collection_entry *e1, *e2;
-    int rc, idx1, idx2;
+    size_t idx1, idx2;
     bool eof1, eof2;
+    int rc;
 
     idx1 = pair->idx[0];
     e1 = &pair->bkvc[0]->bkvcol_entry[idx1];
-    eof1 = idx1 >= pair->bkvc[0]->bkvcol_cnt;
+    eof1 = idx1 >= pair->end[0];
 
     idx2 = pair->idx[1];
     e2 = &pair->bkvc[1]->bkvcol_entry[idx2];
-    eof2 = idx2 >= pair->bkvc[1]->bkvcol_cnt;
+    eof2 = idx2 >= pair->end[1];
 
     if (eof1 && eof2)
         return false;
@@ -216,7 +234,12 @@ bkv_collection_pair_next(
 }
 
 merr_t
-bkv_collection_finish_pair(struct bkv_collection *bkvc1, struct bkv_collection *bkvc2)
+bkv_collection_finish_pair_range(
+    struct bkv_collection *bkvc1,
+    struct bkv_collection *bkvc2,
+    const size_t *startv,
+    const size_t *endv,
+    void *rock)
 {
     merr_t err = 0;
     struct bkv_collection_pair p;
@@ -224,12 +247,11 @@ bkv_collection_finish_pair(struct bkv_collection *bkvc1, struct bkv_collection *
     struct bonsai_val *vlist;
 
     assert(bkvc1->bkvcol_cb == bkvc2->bkvcol_cb);
-    assert(bkvc1->bkvcol_cbarg == bkvc2->bkvcol_cbarg);
 
-    bkv_collection_pair_init(bkvc1, bkvc2, &p);
+    bkv_collection_pair_init(bkvc1, bkvc2, startv, endv, &p);
 
     while (bkv_collection_pair_next(&p, &bkv, &vlist)) {
-        err = bkvc1->bkvcol_cb(bkvc1->bkvcol_cbarg, bkv, vlist);
+        err = bkvc1->bkvcol_cb(rock, bkv, vlist);
         if (ev(err))
             break;
     }
@@ -237,6 +259,17 @@ bkv_collection_finish_pair(struct bkv_collection *bkvc1, struct bkv_collection *
     return err;
 }
 
+merr_t
+bkv_collection_finish_pair(struct bkv_collection *bkvc1, struct bkv_collection *bkvc2)
+{
+    const size_t startv[] = { 0, 0 };
+    const size_t endv[] = { bkvc1->bkvcol_cnt, bkvc2->bkvcol_cnt };
+
+    assert(bkvc1->bkvcol_cbarg == bkvc2->bkvcol_cbarg);
+
+    return bkv_collection_finish_pair_range(bkvc1, bkvc2, startv, endv, bkvc1->bkvcol_cbarg);
+}
+
 /* Init/Fini
  */
 merr_t
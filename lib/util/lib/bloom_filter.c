@@ -7,6 +7,7 @@
 
 #include <hse/logging/logging.h>
 #include <hse/util/bloom_filter.h>
+#include <hse/util/compiler.h>
 #include <hse/util/page.h>
 
 #include "bf_size2bits.i"
@@ -23,6 +24,17 @@
 
 _Static_assert(BF_BKTSHIFT >= 9 && BF_BKTSHIFT <= 15, "BF_BKTSHIFT is too large or too small");
 _Static_assert(BF_ROTL >= 1 && BF_ROTL <= 63, "BF_ROTL is too large or too small");
+_Static_assert(BF_BKTSHIFT == BF_SB_BKTSHIFT, "split-block buckets must be 512 bits");
+_Static_assert(BF_SB_LANES * 32 == 1u << BF_SB_BKTSHIFT, "split-block lanes must be 32 bits");
+
+/* Odd multipliers used to derive the bit within each lane of a split-block
+ * bucket.  These are part of the on-media format, do not change them.
+ */
+const uint32_t bf_sb_saltv[BF_SB_LANES] HSE_ALIGNED(64) = {
+    0xe29a8453, 0x164fb8df, 0x4e758b8b, 0x35657c1d, 0x1b1bdebb, 0x64b1cadf,
+    0x054bd88b, 0xea9d10ef, 0xd7d76b97, 0xbf76f90f, 0xf36e8bf3, 0x2fa4386f,
+    0xf641f4dd, 0x3719ac5f, 0xda45f0d1, 0x9cc51905,
+};
 
 struct bf_prob_range {
     uint32_t bfpr_min;
@@ -160,6 +172,7 @@ bf_filter_init(
 {
     assert(IS_ALIGNED(storage_sz, PAGE_SIZE));
     assert(storage_sz >= PAGE_SIZE);
+    assert(desc.bhd_num_hashes <= BF_SB_LANES);
 
     filter->bf_n_hashes = desc.bhd_num_hashes;
     filter->bf_bktshift = BF_BKTSHIFT;
@@ -180,7 +193,7 @@ bf_filter_init(
 void
 bf_filter_insert_by_hash(struct bloom_filter *bf, uint64_t hash)
 {
-    bf_populate(bf, hash);
+    bf_sb_populate(bf, hash);
 }
 
 void
@@ -189,5 +202,113 @@ bf_filter_insert_by_hashv(struct bloom_filter *bf, uint64_t *keyv, uint32_t keyc
     int i;
 
     for (i = 0; i < keyc; ++i)
-        bf_populate(bf, keyv[i]);
+        bf_sb_populate(bf, keyv[i]);
+}
+
+typedef bool
+bf_sb_lookup_fn(uint64_t hash, const uint8_t *bitmap, uint32_t n);
+
+static bool
+bf_sb_lookup_scalar(uint64_t hash, const uint8_t *bitmap, uint32_t n)
+{
+    while (n-- > 0) {
+        if (!isset(bitmap, bf_sb_hash2bit(hash, n)))
+            return false;
+    }
+
+    return true;
+}
+
+#if __amd64__
+
+/* The vector implementations compute the bit for every lane, and then
+ * discard the lanes not selected by the hash (i.e., those for which
+ * ((lane - first) % BF_SB_LANES) >= n).
+ */
+__attribute__((__target__("avx2"))) static bool
+bf_sb_lookup_avx2(uint64_t hash, const uint8_t *bitmap, uint32_t n)
+{
+    const __m256i key = _mm256_set1_epi32(hash >> 32);
+    const __m256i first = _mm256_set1_epi32(hash % BF_SB_LANES);
+    const __m256i lanemask = _mm256_set1_epi32(BF_SB_LANES - 1);
+    const __m256i nv = _mm256_set1_epi32(n);
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (int i = 0; i < 2; ++i) {
+        __m256i salt, bits, sel;
+
+        salt = _mm256_load_si256((const void *)(bf_sb_saltv + i * 8));
+        bits = _mm256_srli_epi32(_mm256_mullo_epi32(key, salt), 27);
+        bits = _mm256_sllv_epi32(one, bits);
+
+        sel = _mm256_and_si256(_mm256_sub_epi32(lanes, first), lanemask);
+        sel = _mm256_cmpgt_epi32(nv, sel);
+        bits = _mm256_and_si256(bits, sel);
+
+        if (!_mm256_testc_si256(_mm256_loadu_si256((const void *)(bitmap + i * 32)), bits))
+            return false;
+
+        lanes = _mm256_add_epi32(lanes, _mm256_set1_epi32(8));
+    }
+
+    return true;
+}
+
+__attribute__((__target__("avx512f"))) static bool
+bf_sb_lookup_avx512(uint64_t hash, const uint8_t *bitmap, uint32_t n)
+{
+    const __m512i key = _mm512_set1_epi32(hash >> 32);
+    const __m512i first = _mm512_set1_epi32(hash % BF_SB_LANES);
+    const __m512i lanemask = _mm512_set1_epi32(BF_SB_LANES - 1);
+    const __m512i lanes =
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i salt, bits, bkt;
+    __mmask16 sel;
+
+    salt = _mm512_load_si512(bf_sb_saltv);
+    bits = _mm512_srli_epi32(_mm512_mullo_epi32(key, salt), 27);
+    bits = _mm512_sllv_epi32(_mm512_set1_epi32(1), bits);
+
+    sel = _mm512_cmplt_epu32_mask(
+        _mm512_and_si512(_mm512_sub_epi32(lanes, first), lanemask), _mm512_set1_epi32(n));
+
+    bkt = _mm512_loadu_si512(bitmap);
+
+    return _mm512_mask_cmpeq_epi32_mask(sel, _mm512_and_si512(bkt, bits), bits) == sel;
+}
+
+#endif
+
+static bf_sb_lookup_fn bf_sb_lookup_resolve;
+
+/* Resolved on first use to the best implementation supported by the cpu.
+ */
+static bf_sb_lookup_fn *bf_sb_lookup_impl HSE_READ_MOSTLY = bf_sb_lookup_resolve;
+
+static bool
+bf_sb_lookup_resolve(uint64_t hash, const uint8_t *bitmap, uint32_t n)
+{
+    bf_sb_lookup_fn *fn = bf_sb_lookup_scalar;
+
+#if __amd64__
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        fn = bf_sb_lookup_avx512;
+    else if (__builtin_cpu_supports("avx2"))
+        fn = bf_sb_lookup_avx2;
+#endif
+
+    bf_sb_lookup_impl = fn;
+
+    return fn(hash, bitmap, n);
+}
+
+bool
+bf_sb_lookup(uint64_t hash, const uint8_t *bitmap, uint32_t n)
+{
+    assert(n <= BF_SB_LANES);
+
+    return bf_sb_lookup_impl(hash, bitmap, n);
 }
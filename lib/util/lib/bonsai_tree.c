@@ -66,7 +66,7 @@ bn_ior_replace(
     struct bonsai_val *oldv = NULL, *v;
     enum bonsai_ior_code code;
 
-    v = bn_val_alloc(tree, sval, skey->bsk_flags & HSE_BTF_MANAGED);
+    v = bn_val_alloc(tree, sval, skey->bsk_flags & (HSE_BTF_MANAGED | HSE_BTF_MANAGED_VAL));
     if (!v)
         return NULL;
 
@@ -445,17 +445,16 @@ bn_kv_alloc(
     struct bonsai_val *v;
     struct bonsai_kv *kv;
     size_t ksz, vsz;
-    bool managed;
     uint16_t voffset;
 
     ksz = sizeof(*kv);
     vsz = sizeof(*v);
 
-    managed = skey->bsk_flags & HSE_BTF_MANAGED;
-    if (!managed) {
+    if (!(skey->bsk_flags & HSE_BTF_MANAGED))
         ksz += key_imm_klen(&skey->bsk_key_imm);
+
+    if (!(skey->bsk_flags & (HSE_BTF_MANAGED | HSE_BTF_MANAGED_VAL)))
         vsz += bonsai_sval_vlen(sval);
-    }
 
     voffset = roundup(ksz, sizeof(uintptr_t));
 
@@ -26,7 +26,13 @@ compress_lz4_estimate(const void *data, uint len)
 }
 
 static merr_t
-compress_lz4_compress(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len)
+compress_lz4_compress(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len)
 {
     int len;
 
@@ -36,6 +42,7 @@ compress_lz4_compress(const void *src, uint src_len, void *dst, uint dst_capacit
      *   framing or streaming).
      * - If dst_capacity is too big it's probably a bug.
      * - If result doesn't fit an error will be returned.
+     * - Levels do not apply to LZ4's fast block compressor.
      */
     assert(src && dst && dst_len);
     assert(src_len && dst_capacity);
@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <zstd.h>
+
+#include <hse/logging/logging.h>
+#include <hse/util/assert.h>
+#include <hse/util/compression_zstd.h>
+#include <hse/util/event_counter.h>
+
+#if ZSTD_VERSION_NUMBER < (10000 + 400 + 0)
+#error "Need zstd 1.4.0 or higher"
+#endif
+
+_Static_assert(ZSTD_MAGICNUMBER == COMPRESS_ZSTD_MAGIC, "zstd magic number mismatch");
+
+/* Compression and decompression contexts are expensive to create relative
+ * to the cost of compressing a typical value, so each thread lazily creates
+ * and caches one of each.  They are freed when the thread exits.
+ */
+struct compress_zstd_tls {
+    ZSTD_CCtx *cctx;
+    ZSTD_DCtx *dctx;
+};
+
+static pthread_once_t compress_zstd_once = PTHREAD_ONCE_INIT;
+static pthread_key_t compress_zstd_key;
+static int compress_zstd_key_rc;
+
+static void
+compress_zstd_tls_free(void *arg)
+{
+    struct compress_zstd_tls *tls = arg;
+
+    ZSTD_freeCCtx(tls->cctx);
+    ZSTD_freeDCtx(tls->dctx);
+    free(tls);
+}
+
+static void
+compress_zstd_key_create(void)
+{
+    compress_zstd_key_rc = pthread_key_create(&compress_zstd_key, compress_zstd_tls_free);
+}
+
+static struct compress_zstd_tls *
+compress_zstd_tls_get(void)
+{
+    struct compress_zstd_tls *tls;
+
+    pthread_once(&compress_zstd_once, compress_zstd_key_create);
+    if (ev(compress_zstd_key_rc))
+        return NULL;
+
+    tls = pthread_getspecific(compress_zstd_key);
+    if (HSE_LIKELY(tls))
+        return tls;
+
+    tls = calloc(1, sizeof(*tls));
+    if (ev(!tls))
+        return NULL;
+
+    if (pthread_setspecific(compress_zstd_key, tls)) {
+        free(tls);
+        return NULL;
+    }
+
+    return tls;
+}
+
+static uint
+compress_zstd_estimate(const void *data, uint len)
+{
+    if (!len)
+        return 0;
+
+    return (uint)ZSTD_compressBound(len);
+}
+
+static merr_t
+compress_zstd_compress(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len)
+{
+    struct compress_zstd_tls *tls;
+    size_t len;
+
+    assert(src && dst && dst_len);
+    assert(src_len && dst_capacity);
+
+    tls = compress_zstd_tls_get();
+    if (ev(!tls))
+        return merr(ENOMEM);
+
+    if (!tls->cctx) {
+        tls->cctx = ZSTD_createCCtx();
+        if (ev(!tls->cctx))
+            return merr(ENOMEM);
+    }
+
+    /* The content size is recorded in the frame header, which permits
+     * decompression of a prefix without having to allocate a window
+     * larger than the value.
+     */
+    len = ZSTD_compressCCtx(tls->cctx, dst, dst_capacity, src, src_len, level);
+
+    if (ZSTD_isError(len)) {
+        *dst_len = 0;
+        return merr(EFBIG);
+    }
+
+    *dst_len = len;
+
+    return 0;
+}
+
+static merr_t
+compress_zstd_decompress(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len)
+{
+    ZSTD_inBuffer in = { .src = src, .size = src_len };
+    ZSTD_outBuffer out = { .dst = dst, .size = dst_capacity };
+    struct compress_zstd_tls *tls;
+    size_t rc;
+
+    assert(src && dst && dst_len);
+    assert(src_len && dst_capacity);
+
+    tls = compress_zstd_tls_get();
+    if (ev(!tls))
+        return merr(ENOMEM);
+
+    if (!tls->dctx) {
+        tls->dctx = ZSTD_createDCtx();
+        if (ev(!tls->dctx))
+            return merr(ENOMEM);
+    }
+
+    ZSTD_DCtx_reset(tls->dctx, ZSTD_reset_session_only);
+
+    /* Stream the frame such that a caller may decompress only a prefix of
+     * the value into a buffer smaller than the original length (as with
+     * LZ4_decompress_safe_partial()).
+     */
+    do {
+        const size_t inpos = in.pos, outpos = out.pos;
+
+        rc = ZSTD_decompressStream(tls->dctx, &out, &in);
+        if (ZSTD_isError(rc)) {
+            log_err(
+                "slen %u, cap %u, src %p, dst %p, %s", src_len, dst_capacity, src, dst,
+                ZSTD_getErrorName(rc));
+
+            return merr(EFBIG);
+        }
+
+        if (in.pos == inpos && out.pos == outpos)
+            break;
+    } while (rc > 0 && out.pos < out.size);
+
+    if (HSE_UNLIKELY(out.pos == 0))
+        return merr(EFBIG);
+
+    *dst_len = out.pos;
+
+    return 0;
+}
+
+struct compress_ops compress_zstd_ops HSE_READ_MOSTLY = {
+    .cop_estimate = compress_zstd_estimate,
+    .cop_compress = compress_zstd_compress,
+    .cop_decompress = compress_zstd_decompress,
+};
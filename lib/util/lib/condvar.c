@@ -35,6 +35,12 @@ cv_destroy(struct cv *cv)
 
 int
 cv_timedwait(struct cv *cv, struct mutex *mtx, const long timeout, const char *wmesg)
+{
+    return cv_timedwait_ns(cv, mtx, timeout < 0 ? -1 : timeout * 1000000, wmesg);
+}
+
+int
+cv_timedwait_ns(struct cv *cv, struct mutex *mtx, const long timeout, const char *wmesg)
 {
     int rc;
 
@@ -52,8 +58,8 @@ cv_timedwait(struct cv *cv, struct mutex *mtx, const long timeout, const char *w
 
         clock_gettime(CLOCK_MONOTONIC, &ts);
 
-        ts.tv_nsec += (timeout % 1000) * 1000000;
-        ts.tv_sec += (timeout / 1000) + (ts.tv_nsec / 1000000000);
+        ts.tv_nsec += timeout % 1000000000;
+        ts.tv_sec += (timeout / 1000000000) + (ts.tv_nsec / 1000000000);
         ts.tv_nsec %= 1000000000;
 
         rc = pthread_cond_timedwait(&cv->cv_waitq, &mtx->pth_mutex, &ts);
@@ -54,9 +54,8 @@ cheap_create(size_t alignment, size_t size)
         h->alignment = alignment;
         h->size = size - offset - halign - CHEAP_POISON_SZ;
         h->base = (uint64_t)h + halign;
-        h->cursorp = h->base;
-        h->brk = PAGE_ALIGN(h->cursorp);
-        h->lastp = 0;
+        h->brk = PAGE_ALIGN(h->base);
+        atomic_set(&h->cursorp, h->base);
 
         ev_info(1);
     }
@@ -81,36 +80,39 @@ cheap_destroy(struct cheap *h)
 void
 cheap_reset(struct cheap *h, size_t size)
 {
+    uint64_t cursorp = atomic_read(&h->cursorp);
+
     assert(h->magic == (uintptr_t)h);
     assert(size < h->size);
-    assert(size <= h->cursorp - h->base);
+    assert(size <= cursorp - h->base);
 
-    if (h->brk < h->cursorp)
-        h->brk = PAGE_ALIGN(h->cursorp);
+    if (h->brk < cursorp)
+        h->brk = PAGE_ALIGN(cursorp);
 
-    h->cursorp = h->base + size;
-    h->lastp = 0;
+    cursorp = h->base + size;
+    atomic_set(&h->cursorp, cursorp);
 
 #if CHEAP_POISON_SZ > 0
-    memset((void *)h->cursorp, 0xa5, CHEAP_POISON_SZ);
+    memset((void *)cursorp, 0xa5, CHEAP_POISON_SZ);
 #endif
 }
 
 void
 cheap_trim(struct cheap *h, size_t rss)
 {
+    uint64_t cursorp = atomic_read(&h->cursorp);
     size_t len;
     int rc;
 
     assert(h->magic == (uintptr_t)h);
 
-    if (h->brk < h->cursorp)
-        h->brk = PAGE_ALIGN(h->cursorp);
+    if (h->brk < cursorp)
+        h->brk = PAGE_ALIGN(cursorp);
 
     rss = max(PAGE_ALIGN(rss), PAGE_SIZE);
 
-    if (rss < h->cursorp - h->base)
-        rss = PAGE_ALIGN(h->cursorp - h->base);
+    if (rss < cursorp - h->base)
+        rss = PAGE_ALIGN(cursorp - h->base);
 
     if (rss > h->brk - (uint64_t)h->mem)
         return;
@@ -129,20 +131,21 @@ cheap_trim(struct cheap *h, size_t rss)
 static inline void *
 cheap_memalign_impl(struct cheap *h, size_t alignment, size_t size)
 {
-    uint64_t allocp;
+    uint64_t cursorp, allocp;
 
     assert(h->magic == (uintptr_t)h);
 
-    allocp = ALIGN(h->cursorp, alignment);
-
     if (ev(size > h->size))
         return NULL;
 
-    if ((allocp - h->base + size) > h->size)
-        return NULL;
+    cursorp = atomic_read(&h->cursorp);
 
-    h->cursorp = allocp + size;
-    h->lastp = allocp;
+    do {
+        allocp = ALIGN(cursorp, alignment);
+
+        if ((allocp - h->base + size) > h->size)
+            return NULL;
+    } while (!atomic_cmpxchg(&h->cursorp, &cursorp, allocp + size));
 
     return (void *)allocp;
 }
@@ -169,16 +172,25 @@ cheap_malloc(struct cheap *h, size_t size)
  * cheap needs to allocate space to ensure that it can make progress
  * after it does something that may fail. If the failure occurs, we want
  * to free the just-allocated space.
+ *
+ * The cursor is rolled back only if it still points just past the chunk,
+ * so cheap_free() is safe to use on a cheap shared by concurrent allocators
+ * (in which case the chunk is simply not reclaimed if another allocation
+ * followed it).
  */
 void
-cheap_free(struct cheap *h, void *addr)
+cheap_free(struct cheap *h, void *addr, size_t size)
 {
-    if (h->lastp && (uint64_t)addr == h->lastp) {
-        if (h->brk < h->cursorp)
-            h->brk = PAGE_ALIGN(h->cursorp);
-        h->cursorp = h->lastp;
-        h->lastp = 0;
-    }
+    uint64_t cursorp = (uint64_t)addr + size;
+
+    if (!addr)
+        return;
+
+    /* brk is only a hint for cheap_trim(), a stale value merely causes
+     * it to release fewer pages.
+     */
+    if (atomic_cmpxchg(&h->cursorp, &cursorp, (uint64_t)addr) && h->brk < cursorp)
+        h->brk = PAGE_ALIGN(cursorp);
 }
 
 size_t
@@ -186,7 +198,7 @@ cheap_used(struct cheap *h)
 {
     assert(h->magic == (uintptr_t)h);
 
-    return min_t(size_t, h->size, (h->cursorp - h->base));
+    return min_t(size_t, h->size, (atomic_read(&h->cursorp) - h->base));
 }
 
 size_t
@@ -0,0 +1,360 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+/*
+ * References
+ * ----------
+ *
+ * 1. Thomas Mueller Graf and Daniel Lemire.  Binary Fuse Filters: Fast and
+ *    Smaller Than Xor Filters.  ACM Journal of Experimental Algorithmics,
+ *    Volume 27, 2022.
+ *
+ *    https://arxiv.org/abs/2201.01174
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/assert.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/fuse_filter.h>
+#include <hse/util/minmax.h>
+
+/* Construction fails with a probability that shrinks rapidly with the number
+ * of keys, in which case it is retried with a new seed.  Exhausting all tries
+ * is for all practical purposes impossible.
+ */
+#define FF_SEED_TRIES_MAX (100)
+#define FF_SEED_INIT      (0x726b2b9d438b9d4dull)
+
+_Static_assert(FF_ARITY == 3, "ff_hash2slots() yields exactly three slots");
+_Static_assert(FF_SEGLEN_BITS < 32, "FF_SEGLEN_BITS is too large");
+
+static uint64_t
+ff_splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+static void
+ff_fpset(uint8_t *fpv, uint32_t fpbits, uint32_t slot, uint32_t fp)
+{
+    size_t off;
+
+    if (fpbits == FF_FPBITS_MIN) {
+        fpv[slot] = fp;
+        return;
+    }
+
+    if (fpbits == FF_FPBITS_MAX) {
+        fpv[slot * 2] = fp;
+        fpv[slot * 2 + 1] = fp >> 8;
+        return;
+    }
+
+    off = ((size_t)slot * 3) >> 1;
+
+    if (slot & 1) {
+        fpv[off] = (fpv[off] & 0x0f) | (fp << 4);
+        fpv[off + 1] = fp >> 4;
+    } else {
+        fpv[off] = fp;
+        fpv[off + 1] = (fpv[off + 1] & 0xf0) | ((fp >> 8) & 0x0f);
+    }
+}
+
+/* Compute the segment length and array length for n keys.  The array is
+ * segmented such that the first slot of each key lands in any but the last
+ * (FF_ARITY - 1) segments, and the array is oversized by a factor that
+ * approaches 1.125 as n grows.
+ */
+static void
+ff_layout(uint32_t n, uint32_t *seglen_shift, uint32_t *seg_count_len, uint32_t *array_len)
+{
+    uint64_t capacity = 0, segcnt;
+    uint32_t shift = 2;
+
+    if (n > 1) {
+        double factor;
+
+        shift = floor(log(n) / log(3.33) + 2.25);
+        if (shift > FF_SEGLEN_BITS)
+            shift = FF_SEGLEN_BITS;
+
+        factor = fmax(1.125, 0.875 + 0.25 * log(1000000.0) / log(n));
+        capacity = round(n * factor);
+    }
+
+    segcnt = (capacity + (1u << shift) - 1) >> shift;
+    segcnt = (segcnt < FF_ARITY) ? 1 : segcnt - (FF_ARITY - 1);
+
+    *seglen_shift = shift;
+    *seg_count_len = segcnt << shift;
+    *array_len = (segcnt + FF_ARITY - 1) << shift;
+}
+
+uint32_t
+ff_compute_fpbits_est(uint32_t probability)
+{
+    if ((uint64_t)probability << FF_FPBITS_MIN >= 1000000)
+        return FF_FPBITS_MIN;
+
+    if ((uint64_t)probability << FF_FPBITS_MID >= 1000000)
+        return FF_FPBITS_MID;
+
+    return FF_FPBITS_MAX;
+}
+
+size_t
+ff_size_estimate(uint32_t fpbits, uint32_t num_elmnts)
+{
+    uint32_t shift, seg_count_len, array_len;
+
+    ff_layout(num_elmnts, &shift, &seg_count_len, &array_len);
+
+    return ff_fpv_size(fpbits, array_len);
+}
+
+uint32_t
+ff_element_estimate(uint32_t fpbits, size_t size_in_bytes)
+{
+    uint64_t lo = 0, hi;
+
+    /* The array length is nondecreasing in the number of keys and never
+     * less than the number of keys, so binary search for the largest
+     * number of keys that fits.
+     */
+    hi = min_t(uint64_t, size_in_bytes * 8 / fpbits, UINT32_MAX);
+
+    if (ff_size_estimate(fpbits, 0) > size_in_bytes)
+        return 0;
+
+    while (lo < hi) {
+        const uint64_t mid = (lo + hi + 1) / 2;
+
+        if (ff_size_estimate(fpbits, mid) <= size_in_bytes)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    return lo;
+}
+
+static int
+ff_hash_cmp(const void *lhs, const void *rhs)
+{
+    const uint64_t a = *(const uint64_t *)lhs;
+    const uint64_t b = *(const uint64_t *)rhs;
+
+    return (a > b) - (a < b);
+}
+
+merr_t
+ff_filter_build(
+    struct fuse_filter *filter,
+    uint32_t fpbits,
+    const uint64_t *hashv,
+    uint32_t hashc,
+    uint8_t *storage,
+    size_t storage_sz)
+{
+    uint64_t rngstate = FF_SEED_INIT;
+    uint64_t *t2hash, *stackv, *uniqv = NULL;
+    uint32_t *alone, slotv[FF_ARITY];
+    uint8_t *t2count, *stackh;
+    uint32_t cap, stackc = 0;
+    merr_t err = 0;
+    int tries;
+
+    assert(ff_fpbits_valid(fpbits));
+
+    memset(filter, 0, sizeof(*filter));
+    ff_layout(hashc, &filter->ff_seglen_shift, &filter->ff_seg_count_len, &filter->ff_array_len);
+
+    filter->ff_fpbits = fpbits;
+    filter->ff_fpv = storage;
+    filter->ff_fpvsz = ff_fpv_size(fpbits, filter->ff_array_len);
+    filter->ff_seed = ff_splitmix64(&rngstate);
+
+    assert(filter->ff_fpvsz <= storage_sz);
+    if (ev(filter->ff_fpvsz > storage_sz))
+        return merr(EINVAL);
+
+    memset(storage, 0, storage_sz);
+
+    if (hashc == 0)
+        return 0;
+
+    cap = filter->ff_array_len;
+
+    t2hash = calloc(cap, sizeof(*t2hash));
+    t2count = calloc(cap, sizeof(*t2count));
+    alone = malloc(cap * sizeof(*alone));
+    stackv = malloc(hashc * sizeof(*stackv));
+    stackh = malloc(hashc * sizeof(*stackh));
+
+    if (ev(!t2hash || !t2count || !alone || !stackv || !stackh)) {
+        err = merr(ENOMEM);
+        goto errout;
+    }
+
+    for (tries = 0; tries < FF_SEED_TRIES_MAX; ++tries) {
+        uint32_t dups = 0, qc = 0;
+        bool error = false;
+
+        /* Each slot tracks the number of keys that map to it (in the upper
+         * six bits of t2count), the xor of the slot positions (0, 1, or 2)
+         * by which they map to it (in the lower two bits), and the xor of
+         * their filter hashes.  Hence a slot with a count of one yields
+         * both its key and the key's other two slots.
+         */
+        for (uint32_t i = 0; i < hashc; ++i) {
+            const uint64_t fh = ff_mix(hashv[i], filter->ff_seed);
+
+            ff_hash2slots(fh, filter->ff_seglen_shift, filter->ff_seg_count_len, slotv);
+
+            for (uint32_t j = 0; j < FF_ARITY; ++j) {
+                t2count[slotv[j]] += 4;
+                t2count[slotv[j]] ^= j;
+                t2hash[slotv[j]] ^= fh;
+            }
+
+            /* A slot with two identical keys has a zero hash and no
+             * position bits, drop the second key.
+             */
+            if ((t2hash[slotv[0]] & t2hash[slotv[1]] & t2hash[slotv[2]]) == 0) {
+                if ((t2hash[slotv[0]] == 0 && t2count[slotv[0]] == 8) ||
+                    (t2hash[slotv[1]] == 0 && t2count[slotv[1]] == 8) ||
+                    (t2hash[slotv[2]] == 0 && t2count[slotv[2]] == 8)) {
+
+                    for (uint32_t j = 0; j < FF_ARITY; ++j) {
+                        t2count[slotv[j]] -= 4;
+                        t2count[slotv[j]] ^= j;
+                        t2hash[slotv[j]] ^= fh;
+                    }
+                    ++dups;
+                }
+            }
+
+            /* The count overflows if more than 63 keys map to one slot.
+             */
+            for (uint32_t j = 0; j < FF_ARITY; ++j)
+                error |= (t2count[slotv[j]] < 4);
+        }
+
+        if (!error) {
+            for (uint32_t i = 0; i < cap; ++i) {
+                alone[qc] = i;
+                qc += ((t2count[i] >> 2) == 1);
+            }
+
+            /* Peel keys from slots to which only they map, in the order in
+             * which their fingerprints will be assigned in reverse.
+             */
+            while (qc > 0) {
+                const uint32_t idx = alone[--qc];
+                uint64_t fh;
+                uint8_t found;
+
+                if ((t2count[idx] >> 2) != 1)
+                    continue;
+
+                fh = t2hash[idx];
+                found = t2count[idx] & 3;
+
+                ff_hash2slots(fh, filter->ff_seglen_shift, filter->ff_seg_count_len, slotv);
+
+                stackv[stackc] = fh;
+                stackh[stackc] = found;
+                ++stackc;
+
+                for (uint32_t j = 1; j < FF_ARITY; ++j) {
+                    const uint32_t k = (found + j) % FF_ARITY;
+                    const uint32_t other = slotv[k];
+
+                    alone[qc] = other;
+                    qc += ((t2count[other] >> 2) == 2);
+
+                    t2count[other] -= 4;
+                    t2count[other] ^= k;
+                    t2hash[other] ^= fh;
+                }
+            }
+
+            if (stackc + dups == hashc)
+                break;
+        }
+
+        /* Duplicates that were not detected above prevent the peeling
+         * from ever completing, so remove them before retrying.
+         */
+        if (dups > 0 && !uniqv) {
+            uint32_t n = 0;
+
+            uniqv = malloc(hashc * sizeof(*uniqv));
+            if (ev(!uniqv)) {
+                err = merr(ENOMEM);
+                goto errout;
+            }
+
+            memcpy(uniqv, hashv, hashc * sizeof(*uniqv));
+            qsort(uniqv, hashc, sizeof(*uniqv), ff_hash_cmp);
+
+            for (uint32_t i = 0; i < hashc; ++i) {
+                if (n == 0 || uniqv[i] != uniqv[n - 1])
+                    uniqv[n++] = uniqv[i];
+            }
+
+            hashv = uniqv;
+            hashc = n;
+        }
+
+        memset(t2count, 0, cap * sizeof(*t2count));
+        memset(t2hash, 0, cap * sizeof(*t2hash));
+        filter->ff_seed = ff_splitmix64(&rngstate);
+        stackc = 0;
+    }
+
+    if (ev(tries >= FF_SEED_TRIES_MAX)) {
+        err = merr(EAGAIN);
+        goto errout;
+    }
+
+    /* Assign fingerprints in reverse peeling order, such that each key's
+     * slot is set after all other keys that map to it are already final.
+     */
+    while (stackc-- > 0) {
+        const uint64_t fh = stackv[stackc];
+        const uint8_t found = stackh[stackc];
+        uint32_t fp;
+
+        ff_hash2slots(fh, filter->ff_seglen_shift, filter->ff_seg_count_len, slotv);
+
+        fp = ff_fingerprint(fh, fpbits);
+        fp ^= ff_fpget(storage, fpbits, slotv[(found + 1) % FF_ARITY]);
+        fp ^= ff_fpget(storage, fpbits, slotv[(found + 2) % FF_ARITY]);
+
+        ff_fpset(storage, fpbits, slotv[found], fp);
+    }
+
+errout:
+    free(uniqv);
+    free(stackh);
+    free(stackv);
+    free(alone);
+    free(t2count);
+    free(t2hash);
+
+    return err;
+}
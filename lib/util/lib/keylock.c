@@ -260,6 +260,33 @@ keylock_unlock(struct keylock *handle, uint64_t hash, uint32_t owner)
     mutex_unlock(&table->kli_kmutex);
 }
 
+bool
+keylock_owner(struct keylock *handle, uint64_t hash, uint32_t *owner)
+{
+    struct keylock_impl *table = keylock_h2r(handle);
+    uint plen = 0, index;
+    bool found = false;
+
+    index = hash % KLE_PSL_MAX;
+
+    mutex_lock(&table->kli_kmutex);
+
+    while (table->kli_bucketv[index].kle_busy && table->kli_bucketv[index].kle_plen >= plen) {
+        if (table->kli_bucketv[index].kle_hash == hash) {
+            *owner = table->kli_bucketv[index].kle_owner;
+            found = true;
+            break;
+        }
+
+        plen++;
+        index = (index + 1) % KLE_PSL_MAX;
+    }
+
+    mutex_unlock(&table->kli_kmutex);
+
+    return found;
+}
+
 #if HSE_MOCKING
 void
 keylock_search(struct keylock *handle, uint64_t hash, uint *pos)
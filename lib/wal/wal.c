@@ -64,6 +64,7 @@ struct wal {
     struct workqueue_struct *wq;
     uint32_t   dur_ms;
     uint32_t   dur_bytes;
+    uint32_t   gc_wait_us;
     size_t     dur_bufsz;
     enum hse_mclass dur_mclass;
     uint32_t   version;
@@ -238,6 +239,22 @@ wal_timer(struct work_struct *work)
             }
         }
 
+        /* In group commit mode, linger briefly before flushing on behalf of a
+         * sync request so that concurrent sync callers join the same epoch.
+         * The linger ends early if the wal is closing or has failed.
+         */
+        if (wal->sync_pending && wal->gc_wait_us > 0) {
+            uint64_t now, deadline = get_time_ns() + wal->gc_wait_us * 1000ul;
+
+            while (!atomic_read(&wal->closing) && !atomic_read(&wal->error)) {
+                now = get_time_ns();
+                if (now >= deadline)
+                    break;
+
+                cv_timedwait_ns(&wal->timer_cv, &wal->timer_mutex, deadline - now, "waltmgc");
+            }
+        }
+
         wal->sync_pending = false;
 
         begin_stats_work();
@@ -346,6 +363,29 @@ wal_sync(struct wal *wal)
     return wal_sync_impl(wal, &swait);
 }
 
+merr_t
+wal_op_sync(struct wal *wal, const struct wal_record *rec)
+{
+    struct wal_sync_waiter swait = { 0 };
+
+    if (!wal)
+        return 0;
+
+    cv_init(&swait.ws_cv);
+    INIT_LIST_HEAD(&swait.ws_link);
+
+    /* Wait only for the buffer containing the record to become durable
+     * up to the end of the record.
+     */
+    swait.ws_bufcnt = wal_bufset_curoff(wal->wbs, WAL_BUF_MAX, swait.ws_offv);
+    assert(rec->wbidx < swait.ws_bufcnt);
+
+    for (uint32_t i = 0; i < swait.ws_bufcnt; ++i)
+        swait.ws_offv[i] = (i == rec->wbidx) ? rec->offset + rec->len : 0;
+
+    return wal_sync_impl(wal, &swait);
+}
+
 static merr_t
 wal_cond_sync(struct wal *wal, uint64_t gen)
 {
@@ -640,6 +680,7 @@ wal_open(
 {
     struct wal *wal;
     uint8_t mclass;
+    int flags;
     merr_t err;
 
     if (!mp || !rp || !rinfo || !wal_out)
@@ -747,7 +788,14 @@ wal_open(
         wal_fileset_mclass_set(wal->wfset, wal->dur_mclass);
     }
 
-    wal_fileset_flags_set(wal->wfset, rp->dio_enable[wal->dur_mclass] ? O_DIRECT : 0);
+    /* In group commit mode each batch of writes is made durable by a single
+     * flush (see wal_io_worker()), hence the files need not be opened O_SYNC.
+     */
+    flags = rp->dio_enable[wal->dur_mclass] ? O_DIRECT : 0;
+    if (!rp->dur_gc_enable)
+        flags |= O_SYNC;
+
+    wal_fileset_flags_set(wal->wfset, flags);
 
     err = wal_mdc_compact(wal->mdc, wal);
     if (err)
@@ -758,10 +806,14 @@ wal_open(
     if (wal->wal_thr_lwm > wal->wal_thr_hwm / 2)
         wal->wal_thr_lwm = wal->wal_thr_hwm / 2;
 
+    if (rp->dur_gc_enable)
+        wal->gc_wait_us = min_t(uint32_t, rp->dur_gc_wait_us, HSE_WAL_GC_WAIT_US_MAX);
+
     wal->wiocb.iocb = wal_ionotify_cb;
     wal->wiocb.cbarg = wal;
     wal->wbs = wal_bufset_open(
-        wal->wfset, wal->dur_bufsz, wal->dur_bytes, &wal->wal_ingestgen, &wal->wiocb);
+        wal->wfset, wal->dur_bufsz, wal->dur_bytes, &wal->wal_ingestgen, &wal->wiocb,
+        rp->dur_gc_enable);
     if (!wal->wbs) {
         err = merr(ENOMEM);
         goto errout;
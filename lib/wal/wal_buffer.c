@@ -228,7 +228,8 @@ wal_bufset_open(
     size_t bufsz,
     uint32_t dur_bytes,
     atomic_ulong *ingestgen,
-    struct wal_iocb *iocb)
+    struct wal_iocb *iocb,
+    bool gcommit)
 {
     struct wal_bufset *wbs;
     uint32_t i, j, k;
@@ -316,7 +317,7 @@ wal_bufset_open(
     for (i = 0; i < threads; i++) {
         struct wal_buffer *wb = wbs->wbs_bufv + i;
 
-        wb->wb_io = wal_io_create(wfset, i, &wb->wb_doff, iocb);
+        wb->wb_io = wal_io_create(wfset, i, &wb->wb_doff, iocb, gcommit);
         if (!wb->wb_io)
             goto errout;
     }
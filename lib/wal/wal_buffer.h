@@ -24,7 +24,8 @@ wal_bufset_open(
     size_t bufsz,
     uint32_t dur_bytes,
     atomic_ulong *ingestgen,
-    struct wal_iocb *iocb);
+    struct wal_iocb *iocb,
+    bool gcommit);
 
 void
 wal_bufset_close(struct wal_bufset *wbs);
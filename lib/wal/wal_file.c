@@ -3,6 +3,8 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#define MTF_MOCK_IMPL_wal_file
+
 #include <bsd/string.h>
 #include <sys/mman.h>
 
@@ -238,7 +240,7 @@ wal_file_open(
 
     snprintf(name, sizeof(name), "%s-%lu-%d", WAL_FILE_PFX, gen, fileid);
 
-    flags = replay ? O_RDONLY : wfset->flags | O_RDWR | O_SYNC;
+    flags = replay ? O_RDONLY : wfset->flags | O_RDWR;
 
     err = mpool_file_open(wfset->mp, wfset->mclass, name, flags, wfset->capacity, sparse, &mpf);
     if (err)
@@ -311,6 +313,12 @@ wal_file_size(struct wal_file *wfile)
     return mpool_file_size(wfile->mpf);
 }
 
+merr_t
+wal_file_sync(struct wal_file *wfile)
+{
+    return mpool_file_sync(wfile->mpf);
+}
+
 merr_t
 wal_file_complete(struct wal_fileset *wfset, struct wal_file *wfile)
 {
@@ -325,6 +333,12 @@ wal_file_complete(struct wal_fileset *wfset, struct wal_file *wfile)
     if (err)
         return err;
 
+    if (!(wfset->flags & O_SYNC)) {
+        err = mpool_file_sync(wfile->mpf);
+        if (err)
+            return err;
+    }
+
     mutex_lock(&wfset->lock);
     list_del_init(&wfile->link);
     list_for_each_entry_safe(cur, next, &wfset->complete, link) {
@@ -721,3 +735,7 @@ wal_fileset_replay_free(struct wal_fileset *wfset, bool failed)
     free(wfset->repbuf);
     wfset->repbuf = NULL;
 }
+
+#if HSE_MOCKING
+#include "wal_file_ut_impl.i"
+#endif /* HSE_MOCKING */
@@ -9,11 +9,14 @@
 #include <hse/error/merr.h>
 #include <hse/mpool/mpool.h>
 
+/* MTF_MOCK_DECL(wal_file) */
+
 struct wal;
 struct wal_fileset;
 struct wal_file;
 struct wal_replay_gen_info;
 struct wal_replay_info;
+struct wal_minmax_info;
 
 struct wal_fileset *
 wal_fileset_open(
@@ -39,6 +42,7 @@ wal_fileset_version_set(struct wal_fileset *wfset, uint32_t version);
 void
 wal_fileset_flags_set(struct wal_fileset *wfset, uint32_t flags);
 
+/* MTF_MOCK */
 merr_t
 wal_file_open(
     struct wal_fileset *wfset,
@@ -50,9 +54,11 @@ wal_file_open(
 merr_t
 wal_file_close(struct wal_file *walf);
 
+/* MTF_MOCK */
 merr_t
 wal_file_get(struct wal_file *walf);
 
+/* MTF_MOCK */
 void
 wal_file_put(struct wal_file *walf);
 
@@ -62,9 +68,15 @@ wal_file_destroy(struct wal_fileset *wfset, uint64_t gen, int fileid);
 merr_t
 wal_file_read(struct wal_file *walf, char *buf, size_t len);
 
+/* MTF_MOCK */
 merr_t
 wal_file_write(struct wal_file *wfile, char *buf, size_t len, bool bufwrap);
 
+/* MTF_MOCK */
+merr_t
+wal_file_sync(struct wal_file *wfile);
+
+/* MTF_MOCK */
 void
 wal_file_minmax_update(struct wal_file *wfile, struct wal_minmax_info *info);
 
@@ -76,6 +88,7 @@ wal_fileset_reclaim(
     uint64_t txhorizon,
     bool closing);
 
+/* MTF_MOCK */
 merr_t
 wal_file_complete(struct wal_fileset *wfset, struct wal_file *wfile);
 
@@ -89,4 +102,8 @@ wal_fileset_replay(
 void
 wal_fileset_replay_free(struct wal_fileset *wfset, bool failed);
 
+#if HSE_MOCKING
+#include "wal_file_ut.h"
+#endif /* HSE_MOCKING */
+
 #endif /* WAL_FILE_H */
@@ -49,9 +49,22 @@ struct wal_io {
     struct wal_iocb *io_cb;
     atomic_long io_err;
     uint32_t io_index;
+    bool io_gcommit;
     struct work_struct io_work;
 };
 
+/* Record the first error and fail the sync waiters.  The error is sticky,
+ * as nothing written after a failed write or flush can be made durable:
+ * the worker skips queued requests and wal_io_enqueue() rejects new ones.
+ */
+static void
+wal_io_fail(struct wal_io *io, merr_t err)
+{
+    atomic_cas(&io->io_err, 0L, err);
+
+    io->io_cb->iocb(io->io_cb->cbarg, atomic_read(&io->io_err));
+}
+
 static merr_t
 wal_io_submit(struct wal_io_work *iow)
 {
@@ -99,8 +112,14 @@ wal_io_submit(struct wal_io_work *iow)
     }
 
     wal_file_minmax_update(io->io_wfile, &iow->iow_info);
-    atomic_add(io->io_doff, buflen);
-    io->io_cb->iocb(io->io_cb->cbarg, 0);
+
+    /* In group commit mode the durable offset advances only after the
+     * whole batch has been flushed, see wal_io_worker().
+     */
+    if (!io->io_gcommit) {
+        atomic_add(io->io_doff, buflen);
+        io->io_cb->iocb(io->io_cb->cbarg, 0);
+    }
 
     wal_file_put(io->io_wfile);
 
@@ -117,6 +136,7 @@ wal_io_worker(struct work_struct *work)
     while (true) {
         struct wal_io_work *iow, *next;
         struct list_head active;
+        uint64_t gcbytes = 0;
 
         INIT_LIST_HEAD(&active);
 
@@ -146,8 +166,9 @@ wal_io_worker(struct work_struct *work)
 
                 err = wal_io_submit(iow);
                 if (err) {
-                    atomic_set(&io->io_err, err);
-                    io->io_cb->iocb(io->io_cb->cbarg, err); /* Notify sync waiters */
+                    wal_io_fail(io, err);
+                } else if (io->io_gcommit) {
+                    gcbytes += iow->iow_len;
                 }
 
                 atomic_inc(&io->io_comp);
@@ -156,6 +177,24 @@ wal_io_worker(struct work_struct *work)
             list_del(&iow->iow_list);
             kmem_cache_free(iowcache, iow);
         }
+
+        /* Group commit: all the requests that accumulated while the previous
+         * batch was in flight are written back-to-back and then made durable
+         * by a single flush, after which all of their sync waiters are woken.
+         * Writes to files completed by a rollover were flushed by
+         * wal_file_complete().
+         */
+        if (gcbytes > 0 && atomic_read(&io->io_err) == 0) {
+            merr_t err;
+
+            err = wal_file_sync(io->io_wfile);
+            if (err) {
+                wal_io_fail(io, err);
+            } else {
+                atomic_add(io->io_doff, gcbytes);
+                io->io_cb->iocb(io->io_cb->cbarg, 0);
+            }
+        }
     }
 }
 
@@ -204,7 +243,12 @@ wal_io_enqueue(
 }
 
 struct wal_io *
-wal_io_create(struct wal_fileset *wfset, uint32_t index, atomic_ulong *doff, struct wal_iocb *iocb)
+wal_io_create(
+    struct wal_fileset *wfset,
+    uint32_t index,
+    atomic_ulong *doff,
+    struct wal_iocb *iocb,
+    bool gcommit)
 {
     struct wal_io *io;
     size_t sz;
@@ -228,6 +272,7 @@ wal_io_create(struct wal_fileset *wfset, uint32_t index, atomic_ulong *doff, str
     io->io_index = index;
     io->io_wfset = wfset;
     io->io_cb = iocb;
+    io->io_gcommit = gcommit;
 
     INIT_WORK(&io->io_work, wal_io_worker);
     queue_work(iowq, &io->io_work);
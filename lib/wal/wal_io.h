@@ -20,7 +20,12 @@ wal_io_enqueue(
     bool bufwrap);
 
 struct wal_io *
-wal_io_create(struct wal_fileset *wfset, uint32_t index, atomic_ulong *doff, struct wal_iocb *iocb);
+wal_io_create(
+    struct wal_fileset *wfset,
+    uint32_t index,
+    atomic_ulong *doff,
+    struct wal_iocb *iocb,
+    bool gcommit);
 
 void
 wal_io_destroy(struct wal_io *io);
@@ -46,6 +46,7 @@ wal_rechdr_len(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_rechdr_omf_v1);
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         return sizeof(struct wal_rechdr_omf);
 
@@ -93,6 +94,7 @@ wal_reclen(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_rec_omf_v1);
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         return sizeof(struct wal_rec_omf);
 
@@ -165,6 +167,7 @@ wal_rec_cksum_valid(const char *inbuf, uint32_t version)
     case WAL_VERSION1:
         return wal_rec_cksum_valid_v1(inbuf);
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         return wal_rec_cksum_valid_latest(inbuf);
 
@@ -312,6 +315,7 @@ wal_rechdr_unpack(const void *inbuf, uint32_t version, struct wal_rechdr *hdr)
         wal_rechdr_unpack_v1(inbuf, hdr);
         break;
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         wal_rechdr_unpack_latest(inbuf, hdr);
         break;
@@ -383,6 +387,7 @@ wal_rec_unpack(const char *inbuf, struct wal_rechdr *hdr, uint32_t version, stru
         wal_rec_unpack_v1(inbuf, hdr, rec);
         break;
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         wal_rec_unpack_latest(inbuf, hdr, rec);
         break;
@@ -447,6 +452,7 @@ wal_txn_rec_unpack(
         wal_txn_rec_unpack_v1(inbuf, hdr, trec);
         break;
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         wal_txn_rec_unpack_latest(inbuf, hdr, trec);
         break;
@@ -463,6 +469,7 @@ wal_txn_reclen(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_txnrec_omf_v1);
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         return sizeof(struct wal_txnrec_omf);
 
@@ -558,6 +565,7 @@ wal_filehdr_unpack_latest(
     uint32_t crc32;
     uint32_t ignore = sizeof(fhomf->fh_cksum);
     uint32_t len = sizeof(*fhomf);
+    uint32_t version;
 
     *close = (omf_fh_close(fhomf) == 1);
     *soff = omf_fh_startoff(fhomf);
@@ -578,7 +586,11 @@ wal_filehdr_unpack_latest(
         return ((memcmp(fhomf, &ref, sizeof(*fhomf)) == 0) ? merr(ENODATA) : merr(EBADMSG));
     }
 
-    if ((magic != omf_fh_magic(fhomf)) || (WAL_VERSION != omf_fh_version(fhomf)))
+    /* WAL_VERSION3 added merge operands (HSE_XLEN_MOPND) without changing
+     * the layout of version 2.
+     */
+    version = omf_fh_version(fhomf);
+    if (magic != omf_fh_magic(fhomf) || version < WAL_VERSION2 || version > WAL_VERSION)
         return merr(EBADMSG);
 
     return 0;
@@ -601,6 +613,7 @@ wal_filehdr_unpack(
         err = wal_filehdr_unpack_v1(inbuf, magic, close, soff, eoff, info);
         break;
 
+    case WAL_VERSION2:
     case WAL_VERSION:
         err = wal_filehdr_unpack_latest(inbuf, magic, close, soff, eoff, info);
         break;
@@ -3,6 +3,8 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include <sys/sysinfo.h>
+
 #include <rbtree.h>
 
 #include <hse/error/merr.h>
@@ -23,17 +25,37 @@
 #include "wal_omf.h"
 #include "wal_replay.h"
 
-struct wal_replay_gen {
-    struct mutex rg_lock HSE_ACP_ALIGNED;
-    struct rb_root rg_root;
-    struct list_head rg_link;
+/* The records of a gen are partitioned by kvs and key hash such that all
+ * the mutations of a given key land in the same partition.  The partitions
+ * of a gen are applied to c0 concurrently, each in record ID order, which
+ * preserves the order of mutations to any given key.  Mutations of distinct
+ * keys need not be ordered as c0 orders them by seqno.
+ */
+#define WAL_REPLAY_PARTS (32)
+
+struct wal_replay_part {
+    struct mutex rp_lock HSE_L1D_ALIGNED;
+    struct rb_root rp_root;
+    uint64_t rp_bytes;
+    uint64_t rp_krcnt;
+    uint64_t rp_maxseqno;
+
+    struct work_struct rp_work;
+    struct wal_replay *rp_rep;
+    struct wal_replay_gen *rp_rgen;
+    uint32_t rp_flags;
+    merr_t rp_err;
+};
 
-    struct wal_minmax_info rg_info HSE_L1D_ALIGNED;
+struct wal_replay_gen {
+    struct list_head rg_link HSE_ACP_ALIGNED;
+    struct wal_minmax_info rg_info;
     uint64_t rg_gen;
 
     uint64_t rg_krcnt;
     uint64_t rg_maxseqno;
-    uint64_t rg_bytes;
+
+    struct wal_replay_part rg_partv[WAL_REPLAY_PARTS];
 };
 
 struct wal_replay_work {
@@ -57,8 +79,11 @@ struct wal_replay {
     atomic_long r_verr;
 
     struct wal *r_wal HSE_L1D_ALIGNED;
+    uint32_t r_version;
+    struct ikvdb *r_ikvdb;
     struct ikvdb_kvs_hdl *r_ikvsh;
     struct workqueue_struct *r_wq;
+    struct workqueue_struct *r_applywq;
 
     struct wal_replay_info *r_info;
     struct wal_replay_gen_info *r_ginfo;
@@ -89,6 +114,9 @@ static void
 wal_replay_dump_rgen(struct wal_replay *rep);
 #endif
 
+static void
+wal_replay_gen_free(struct wal_replay_gen *rgen);
+
 static struct wal_replay_gen *
 wal_replay_gen_get(struct wal_replay *rep, uint64_t gen);
 
@@ -120,11 +148,14 @@ wal_replay_open(struct wal *wal, struct wal_replay_info *rinfo, struct wal_repla
         goto err_exit;
     }
 
-    err = ikvdb_wal_replay_open(wal_ikvdb(wal), &rep->r_ikvsh);
+    rep->r_ikvdb = wal_ikvdb(wal);
+
+    err = ikvdb_wal_replay_open(rep->r_ikvdb, &rep->r_ikvsh);
     if (err)
         goto err_exit;
 
     rep->r_wal = wal;
+    rep->r_version = wal_version_get(wal);
     rep->r_info = rinfo;
     INIT_LIST_HEAD(&rep->r_head);
 
@@ -164,16 +195,21 @@ wal_replay_close(struct wal_replay *rep, bool failed)
     ikvdb_wal_replay_close(wal_ikvdb(wal), rep->r_ikvsh);
 
     list_for_each_entry_safe(cgen, ngen, &rep->r_head, rg_link) {
-        struct rb_root *root = &cgen->rg_root;
-        struct wal_rec *cur, *next;
+        for (i = 0; i < WAL_REPLAY_PARTS; i++) {
+            struct wal_replay_part *part = cgen->rg_partv + i;
+            struct wal_rec *cur, *next;
 
-        rbtree_postorder_for_each_entry_safe(cur, next, root, node)
-            kmem_cache_free(rep->r_cache, cur);
+            rbtree_postorder_for_each_entry_safe(cur, next, &part->rp_root, node)
+                kmem_cache_free(rep->r_cache, cur);
+        }
 
         list_del_init(&cgen->rg_link);
-        free(cgen);
+        wal_replay_gen_free(cgen);
     }
 
+    if (rep->r_applywq)
+        destroy_workqueue(rep->r_applywq);
+
     rbtree_postorder_for_each_entry_safe(ctxm, ntxm, &rep->r_txm_root, node)
         kmem_cache_free(rep->r_txm_cache, ctxm);
 
@@ -246,7 +282,7 @@ wal_rec_iter_next(struct wal_rec_iter *iter)
     struct wal_rec *rec;
     struct wal_rechdr hdr;
     const char *buf;
-    uint32_t version = wal_version_get(iter->rw->rw_rep->r_wal);
+    uint32_t version = iter->rw->rw_rep->r_version;
 
 next_rec:
     if (iter->eof)
@@ -375,7 +411,7 @@ wal_recs_validate(struct wal_replay_work *rw)
     merr_t err = 0;
 
     info = rginfo->info_valid ? NULL : &rginfo->info;
-    version = wal_version_get(rep->r_wal);
+    version = rep->r_version;
 
     while (
         (valid = wal_rec_is_valid(
@@ -460,14 +496,48 @@ static void
 wal_replay_gen_init(struct wal_replay_gen *rgen, struct wal_replay_gen_info *rginfo)
 {
     INIT_LIST_HEAD(&rgen->rg_link);
-    mutex_init(&rgen->rg_lock);
-    rgen->rg_root = RB_ROOT;
 
     rgen->rg_gen = rginfo->gen;
     rgen->rg_info = rginfo->info;
     rgen->rg_krcnt = 0;
     rgen->rg_maxseqno = 0;
-    rgen->rg_bytes = 0;
+
+    for (int i = 0; i < WAL_REPLAY_PARTS; i++) {
+        struct wal_replay_part *part = rgen->rg_partv + i;
+
+        memset(part, 0, sizeof(*part));
+        mutex_init(&part->rp_lock);
+        part->rp_root = RB_ROOT;
+        part->rp_rgen = rgen;
+    }
+}
+
+static void
+wal_replay_gen_free(struct wal_replay_gen *rgen)
+{
+    for (int i = 0; i < WAL_REPLAY_PARTS; i++)
+        mutex_destroy(&rgen->rg_partv[i].rp_lock);
+
+    free(rgen);
+}
+
+static uint64_t
+wal_replay_gen_bytes(struct wal_replay_gen *rgen)
+{
+    uint64_t bytes = 0;
+
+    for (int i = 0; i < WAL_REPLAY_PARTS; i++)
+        bytes += rgen->rg_partv[i].rp_bytes;
+
+    return bytes;
+}
+
+static struct wal_replay_part *
+wal_replay_gen_part(struct wal_replay_gen *rgen, const struct wal_rec *rec)
+{
+    uint64_t hash = rec->kt.kt_hash ^ (rec->cnid * 0x9e3779b97f4a7c15ul);
+
+    return rgen->rg_partv + ((hash >> 32) % WAL_REPLAY_PARTS);
 }
 
 static void
@@ -514,13 +584,15 @@ wal_replay_gen_getbyseqno(struct wal_replay *rep, uint64_t seqno)
     return NULL;
 }
 
-merr_t
-wal_replay_gen_impl(struct wal_replay *rep, struct wal_replay_gen *rgen, bool flags)
+static void
+wal_replay_part_worker(struct work_struct *work)
 {
-    struct rb_root *root = &rgen->rg_root;
-    struct rb_node *node;
-    struct ikvdb *ikvdb = wal_ikvdb(rep->r_wal);
+    struct wal_replay_part *part = container_of(work, struct wal_replay_part, rp_work);
+    struct wal_replay *rep = part->rp_rep;
+    struct rb_root *root = &part->rp_root;
+    struct ikvdb *ikvdb = rep->r_ikvdb;
     struct ikvdb_kvs_hdl *ikvsh = rep->r_ikvsh;
+    struct rb_node *node;
     merr_t err;
 
     node = rb_first(root);
@@ -533,7 +605,7 @@ wal_replay_gen_impl(struct wal_replay *rep, struct wal_replay_gen *rgen, bool fl
 
         assert(rec->hdr.type == WAL_RT_NONTX || rec->hdr.type == WAL_RT_TX);
 
-        kt->kt_flags = flags;
+        kt->kt_flags = part->rp_flags;
 
         switch (rec->op) {
         case WAL_OP_PUT:
@@ -558,22 +630,59 @@ wal_replay_gen_impl(struct wal_replay *rep, struct wal_replay_gen *rgen, bool fl
 
             log_crit(
                 "WAL replay: Unrecognized record op %d in gen %lu, failing replay", rec->op,
-                rgen->rg_gen);
+                part->rp_rgen->rg_gen);
 
             rbtree_postorder_for_each_entry_safe(cur, next, root, node)
                 kmem_cache_free(rep->r_cache, cur);
+            *root = RB_ROOT;
 
-            return err;
+            part->rp_err = err;
+            return;
         }
 
-        rgen->rg_maxseqno = max_t(uint64_t, rgen->rg_maxseqno, rec->seqno);
+        part->rp_maxseqno = max_t(uint64_t, part->rp_maxseqno, rec->seqno);
 
         rb_erase(&rec->node, root);
         kmem_cache_free(rep->r_cache, rec);
-        rgen->rg_krcnt++;
+        part->rp_krcnt++;
     }
+}
 
-    return 0;
+static merr_t
+wal_replay_gen_impl(struct wal_replay *rep, struct wal_replay_gen *rgen, uint32_t flags)
+{
+    merr_t err = 0;
+    int i;
+
+    for (i = 0; i < WAL_REPLAY_PARTS; i++) {
+        struct wal_replay_part *part = rgen->rg_partv + i;
+
+        if (RB_EMPTY_ROOT(&part->rp_root))
+            continue;
+
+        INIT_WORK(&part->rp_work, wal_replay_part_worker);
+        part->rp_rep = rep;
+        part->rp_flags = flags;
+        part->rp_err = 0;
+
+        queue_work(rep->r_applywq, &part->rp_work);
+    }
+
+    /* All the records of a gen must be in c0 before the next gen is replayed.
+     */
+    flush_workqueue(rep->r_applywq);
+
+    for (i = 0; i < WAL_REPLAY_PARTS; i++) {
+        struct wal_replay_part *part = rgen->rg_partv + i;
+
+        if (part->rp_err)
+            err = part->rp_err;
+
+        rgen->rg_krcnt += part->rp_krcnt;
+        rgen->rg_maxseqno = max_t(uint64_t, rgen->rg_maxseqno, part->rp_maxseqno);
+    }
+
+    return err;
 }
 
 /*
@@ -609,17 +718,23 @@ wal_replay_core(struct wal_replay *rep)
     struct wal_replay_gen *cur, *next;
     struct ikvdb *ikvdb;
     const struct kvdb_rparams *rp;
-    uint32_t flags;
+    uint32_t flags, threads;
     uint64_t maxseqno = 0, last_gen = 0;
     bool need_sync;
     merr_t err;
 
-    ikvdb = wal_ikvdb(rep->r_wal);
+    ikvdb = rep->r_ikvdb;
     rp = ikvdb_get_rparams(ikvdb);
     need_sync = !kvdb_mode_allows_user_writes(rp->mode);
 
     flags = HSE_BTF_MANAGED; /* Replay with MANAGED flag to let c0 share the mmaped wal files */
 
+    threads = clamp_t(uint32_t, get_nprocs(), 1, WAL_REPLAY_PARTS);
+
+    rep->r_applywq = alloc_workqueue("hse_wal_apply", 0, threads, threads);
+    if (!rep->r_applywq)
+        return merr(ENOMEM);
+
     /* Set c0sk to wal replay mode. This disables the c0kvms_should ingest() check and
      * allow us to take control of the c0kvms boundaries. Also, the seqno bump for reserved
      * seqno and LC are also skipped.
@@ -627,21 +742,21 @@ wal_replay_core(struct wal_replay *rep)
     ikvdb_wal_replay_enable(ikvdb);
 
     cur = list_first_entry_or_null(&rep->r_head, typeof(*cur), rg_link);
-    if (cur && cur->rg_bytes != 0) {
+    if (cur && wal_replay_gen_bytes(cur) != 0) {
         /*
          * When the first c0kvms to be replayed requires resizing, the current active c0kvms
          * is synced and a new c0kvms with an appropriate size is provisioned.
          * This could result in rolling back the gen for this newly provisioned c0kvms by
          * at most one in ikvdb_wal_replay_gen_set().
          */
-        if (ikvdb_wal_replay_size_set(ikvdb, rep->r_ikvsh, cur->rg_bytes)) {
+        if (ikvdb_wal_replay_size_set(ikvdb, rep->r_ikvsh, wal_replay_gen_bytes(cur))) {
             need_sync = true;
             ikvdb_wal_replay_sync(ikvdb, 0);
         }
     }
 
     list_for_each_entry_safe(cur, next, &rep->r_head, rg_link) {
-        bool flush = false, last_entry;
+        bool flush = false, last_entry = list_is_last(&cur->rg_link, &rep->r_head);
 
         /* Ensure that WAL replays in increasing order of c0kvms gen */
         if (cur->rg_gen <= last_gen) {
@@ -658,10 +773,8 @@ wal_replay_core(struct wal_replay *rep)
         if (err)
             goto errout;
 
-        if (next && next->rg_bytes != 0)
-            flush = ikvdb_wal_replay_size_set(ikvdb, rep->r_ikvsh, next->rg_bytes);
-
-        last_entry = !next;
+        if (!last_entry && wal_replay_gen_bytes(next) != 0)
+            flush = ikvdb_wal_replay_size_set(ikvdb, rep->r_ikvsh, wal_replay_gen_bytes(next));
 
         if (flush || cur->rg_krcnt || last_entry) {
             err = ikvdb_wal_replay_sync(
@@ -683,7 +796,7 @@ wal_replay_core(struct wal_replay *rep)
             cur->rg_krcnt);
 
         list_del_init(&cur->rg_link);
-        free(cur);
+        wal_replay_gen_free(cur);
     }
 
     /* This additional sync ensures that all replayed c0kvmses are ingested in the case of a
@@ -748,7 +861,7 @@ wal_replay_consolidate(struct wal_replay *rep)
     if (err) {
         list_for_each_entry_safe(cur, next, &rep->r_head, rg_link) {
             list_del_init(&cur->rg_link);
-            free(cur);
+            wal_replay_gen_free(cur);
         }
 
         return err;
@@ -862,9 +975,8 @@ wal_txmeta_gen_update(struct wal_replay *rep)
 }
 
 static merr_t
-wal_rec_rb_insert(struct wal_replay_gen *rgen, struct wal_rec *rec)
+wal_rec_rb_insert(struct rb_root *root, struct wal_rec *rec)
 {
-    struct rb_root *root = &rgen->rg_root;
     struct rb_node **new = &root->rb_node;
     struct rb_node *parent = NULL;
 
@@ -957,6 +1069,7 @@ wal_replay_worker(struct work_struct *work)
 
     while ((rec = wal_rec_iter_next(&iter))) {
         struct wal_replay_gen *trgen = rgen;
+        struct wal_replay_part *part;
         uint64_t gen = rec->hdr.gen;
         uint64_t seqno = rec->seqno;
 
@@ -970,18 +1083,20 @@ wal_replay_worker(struct work_struct *work)
             continue; /* skip this rec */
         }
 
-        mutex_lock(&trgen->rg_lock);
-        err = wal_rec_rb_insert(trgen, rec);
-        mutex_unlock(&trgen->rg_lock);
+        part = wal_replay_gen_part(trgen, rec);
+
+        mutex_lock(&part->rp_lock);
+        err = wal_rec_rb_insert(&part->rp_root, rec);
+        if (!err)
+            part->rp_bytes +=
+                (sizeof(struct bonsai_node) + sizeof(struct bonsai_kv) +
+                 sizeof(struct bonsai_val) + rec->kt.kt_len + kvs_vtuple_vlen(&rec->vt));
+        mutex_unlock(&part->rp_lock);
         if (err) {
             rw->rw_err = err;
             break;
         }
 
-        trgen->rg_bytes +=
-            (sizeof(struct bonsai_node) + sizeof(struct bonsai_kv) + sizeof(struct bonsai_val) +
-             rec->kt.kt_len + kvs_vtuple_vlen(&rec->vt));
-
         (rec->hdr.type == WAL_RT_TX) ? ntxrecs++ : nrecs++;
     }
 
@@ -1134,7 +1249,7 @@ wal_replay_dump_rgen(struct wal_replay *rep)
     list_for_each_entry(cur, &rep->r_head, rg_link) {
         log_info(
             "WAL replay: Gen %lu Seqno (%lu : %lu) Memsz: %lu", cur->rg_gen, cur->rg_info.min_seqno,
-            cur->rg_info.max_seqno, cur->rg_bytes);
+            cur->rg_info.max_seqno, wal_replay_gen_bytes(cur));
     }
 }
 #endif
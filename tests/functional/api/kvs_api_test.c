@@ -4,6 +4,8 @@
  */
 
 #include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
 
 #include <hse/experimental.h>
 #include <hse/hse.h>
@@ -500,6 +502,288 @@ MTF_DEFINE_UTEST_PREPOST(
     ASSERT_EQ(0, memcmp(valbuf, "value0", val_len));
 }
 
+MTF_DEFINE_UTEST(kvs_api_test, get_many_null_kvs)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_many(
+        NULL, 0, NULL, 1, (const void * const *)-1, (size_t *)-1, (bool *)-1, NULL, NULL,
+        (size_t *)-1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_many_invalid_flags)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_many(
+        (struct hse_kvs *)-1, ~0, NULL, 1, (const void * const *)-1, (size_t *)-1, (bool *)-1,
+        NULL, NULL, (size_t *)-1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_many_mismatch_valbufs_valbuf_szs)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_many(
+        (struct hse_kvs *)-1, 0, NULL, 1, (const void * const *)-1, (size_t *)-1, (bool *)-1,
+        (void * const *)-1, NULL, (size_t *)-1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_many_null_key)
+{
+    hse_err_t err;
+    const void *keys[] = { "key0", NULL };
+    size_t key_lens[] = { 4, 4 };
+
+    err = hse_kvs_get_many(
+        (struct hse_kvs *)-1, 0, NULL, NELEM(keys), keys, key_lens, (bool *)-1, NULL, NULL,
+        (size_t *)-1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_many_key_len_too_long)
+{
+    hse_err_t err;
+    const void *keys[] = { "key0", "key1" };
+    size_t key_lens[] = { 4, HSE_KVS_KEY_LEN_MAX + 1 };
+
+    err = hse_kvs_get_many(
+        (struct hse_kvs *)-1, 0, NULL, NELEM(keys), keys, key_lens, (bool *)-1, NULL, NULL,
+        (size_t *)-1);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_many_key_len_is_0)
+{
+    hse_err_t err;
+    const void *keys[] = { "key0", "key1" };
+    size_t key_lens[] = { 4, 0 };
+
+    err = hse_kvs_get_many(
+        (struct hse_kvs *)-1, 0, NULL, NELEM(keys), keys, key_lens, (bool *)-1, NULL, NULL,
+        (size_t *)-1);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_many_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    const void *keys[NUM_ENTRIES + 1];
+    size_t key_lens[NUM_ENTRIES + 1];
+    char keybufs[NUM_ENTRIES + 1][8];
+    char valbufs[NUM_ENTRIES + 1][8];
+    void *valbufv[NUM_ENTRIES + 1];
+    size_t valbuf_szs[NUM_ENTRIES + 1];
+    size_t val_lens[NUM_ENTRIES + 1];
+    bool found[NUM_ENTRIES + 1];
+
+    /* Search the keys in reverse order and include one that doesn't exist. */
+    for (int i = 0; i < NUM_ENTRIES + 1; i++) {
+        key_lens[i] = snprintf(keybufs[i], sizeof(keybufs[i]), KEY_FMT, NUM_ENTRIES - i);
+        keys[i] = keybufs[i];
+        valbufv[i] = valbufs[i];
+        valbuf_szs[i] = sizeof(valbufs[i]);
+    }
+
+    /* Look up the keys both from c0 and, after a sync, from cn. */
+    for (int pass = 0; pass < 2; pass++) {
+        err = hse_kvs_get_many(
+            kvs_handle, 0, NULL, NELEM(keys), keys, key_lens, found, valbufv, valbuf_szs,
+            val_lens);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        ASSERT_FALSE(found[0]);
+
+        for (int i = 1; i < NUM_ENTRIES + 1; i++) {
+            char expected[8];
+            int len;
+
+            len = snprintf(expected, sizeof(expected), VALUE_FMT, NUM_ENTRIES - i);
+            ASSERT_TRUE(found[i]);
+            ASSERT_EQ(len, val_lens[i]);
+            ASSERT_EQ(0, memcmp(valbufs[i], expected, len));
+        }
+
+        err = hse_kvdb_sync(kvdb_handle, 0);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    /* Probe for existence and value length only. */
+    err = hse_kvs_get_many(
+        kvs_handle, 0, NULL, NELEM(keys), keys, key_lens, found, NULL, NULL, val_lens);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found[0]);
+    ASSERT_TRUE(found[1]);
+    ASSERT_EQ(sizeof("value4") - 1, val_lens[1]);
+}
+
+MTF_DEFINE_UTEST_PREPOST(
+    kvs_api_test,
+    get_many_success_transactional,
+    transactional_kvs_setup,
+    kvs_teardown)
+{
+    hse_err_t err;
+    const void *keys[] = { "key0", "key1" };
+    size_t key_lens[] = { sizeof("key0") - 1, sizeof("key1") - 1 };
+    char valbufs[2][8];
+    void *valbufv[] = { valbufs[0], valbufs[1] };
+    size_t valbuf_szs[] = { sizeof(valbufs[0]), sizeof(valbufs[1]) };
+    size_t val_lens[2];
+    bool found[2];
+    struct hse_kvdb_txn *txn;
+
+    txn = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn);
+
+    err = hse_kvdb_txn_begin(kvdb_handle, txn);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err =
+        hse_kvs_put(kvs_handle, 0, txn, "key0", sizeof("key0") - 1, "value0", sizeof("value0") - 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get_many(
+        kvs_handle, 0, txn, NELEM(keys), keys, key_lens, found, valbufv, valbuf_szs, val_lens);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found[0]);
+    ASSERT_EQ(sizeof("value0") - 1, val_lens[0]);
+    ASSERT_EQ(0, memcmp(valbufs[0], "value0", val_lens[0]));
+    ASSERT_FALSE(found[1]);
+
+    err = hse_kvdb_txn_abort(kvdb_handle, txn);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    hse_kvdb_txn_free(kvdb_handle, txn);
+}
+
+struct get_async_ctx {
+    pthread_mutex_t lock;
+    pthread_cond_t cv;
+    int pending;
+    int nfound;
+    hse_err_t err;
+    size_t val_len;
+};
+
+static void
+get_async_cb(void *arg, hse_err_t err, bool found, size_t val_len)
+{
+    struct get_async_ctx *ctx = arg;
+
+    pthread_mutex_lock(&ctx->lock);
+    if (err)
+        ctx->err = err;
+    if (found) {
+        ctx->nfound++;
+        ctx->val_len = val_len;
+    }
+    if (--ctx->pending == 0)
+        pthread_cond_signal(&ctx->cv);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static void
+get_async_wait(struct get_async_ctx *ctx)
+{
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->pending > 0)
+        pthread_cond_wait(&ctx->cv, &ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_async_null_kvs)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_async(NULL, 0, NULL, "key", 3, NULL, 0, get_async_cb, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_async_null_cb, kvs_setup, kvs_teardown)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_async(kvs_handle, 0, NULL, "key", 3, NULL, 0, NULL, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_async_key_len_is_0, kvs_setup, kvs_teardown)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_async(kvs_handle, 0, NULL, "key", 0, NULL, 0, get_async_cb, NULL);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_async_success, kvs_setup, kvs_teardown)
+{
+    struct get_async_ctx ctx = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cv = PTHREAD_COND_INITIALIZER,
+    };
+    const size_t vlen = 64 * 1024;
+    char *val, *valbuf;
+    hse_err_t err;
+
+    /* Values this large are read directly from media once in cn, which
+     * exercises the asynchronous read path.
+     */
+    val = malloc(vlen);
+    ASSERT_NE(NULL, val);
+    valbuf = aligned_alloc(4096, vlen);
+    ASSERT_NE(NULL, valbuf);
+
+    for (size_t i = 0; i < vlen; i++)
+        val[i] = i % 251;
+
+    err = hse_kvs_put(kvs_handle, 0, NULL, "big", 3, val, vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Look up the key both from c0 and, after a sync, from cn. */
+    for (int pass = 0; pass < 2; pass++) {
+        memset(valbuf, 0, vlen);
+        ctx.pending = 2;
+        ctx.nfound = 0;
+
+        err = hse_kvs_get_async(kvs_handle, 0, NULL, "big", 3, valbuf, vlen, get_async_cb, &ctx);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvs_get_async(kvs_handle, 0, NULL, "nokey", 5, NULL, 0, get_async_cb, &ctx);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        get_async_wait(&ctx);
+        ASSERT_EQ(0, hse_err_to_errno(ctx.err));
+        ASSERT_EQ(1, ctx.nfound);
+        ASSERT_EQ(vlen, ctx.val_len);
+        ASSERT_EQ(0, memcmp(val, valbuf, vlen));
+
+        err = hse_kvdb_sync(kvdb_handle, 0);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    /* Unaligned, undersized buffer. */
+    memset(valbuf, 0, vlen);
+    ctx.pending = 1;
+    ctx.nfound = 0;
+
+    err = hse_kvs_get_async(
+        kvs_handle, 0, NULL, "big", 3, valbuf + 1, vlen / 2, get_async_cb, &ctx);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    get_async_wait(&ctx);
+    ASSERT_EQ(0, hse_err_to_errno(ctx.err));
+    ASSERT_EQ(1, ctx.nfound);
+    ASSERT_EQ(vlen, ctx.val_len);
+    ASSERT_EQ(0, memcmp(val, valbuf + 1, vlen / 2));
+
+    free(valbuf);
+    free(val);
+}
+
 MTF_DEFINE_UTEST(kvs_api_test, name_null_kvs)
 {
     const char *name;
@@ -761,6 +1045,336 @@ MTF_DEFINE_UTEST_PREPOST(kvs_api_test, put_vcomp_exclusivity, kvs_setup_with_dat
     ASSERT_EQ(EINVAL, merr_errno(err));
 }
 
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, put_sync, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    char buf[16];
+    size_t len;
+    bool found;
+
+    err = hse_kvs_put(kvs_handle, HSE_KVS_PUT_SYNC, NULL, "sync", 4, "value", 5);
+    ASSERT_EQ(0, merr_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "sync", 4, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(5, len);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, put_sync_txn)
+{
+    hse_err_t err;
+
+    err = hse_kvs_put(
+        (struct hse_kvs *)-1, HSE_KVS_PUT_SYNC, (struct hse_kvdb_txn *)-1, (void *)-1, 1, NULL,
+        0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, batch_put_invalid_args)
+{
+    struct hse_kvdb_batch *batch = (struct hse_kvdb_batch *)-1;
+    hse_err_t err;
+
+    err = hse_kvs_batch_put(NULL, 0, batch, "key", 3, NULL, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put((struct hse_kvs *)-1, 0, NULL, "key", 3, NULL, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put((struct hse_kvs *)-1, HSE_KVS_PUT_SYNC, batch, "key", 3, NULL, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put((struct hse_kvs *)-1, 0, batch, "key", 0, NULL, 0);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put((struct hse_kvs *)-1, 0, batch, "key", HSE_KVS_KEY_LEN_MAX + 1, NULL, 0);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_delete((struct hse_kvs *)-1, 1, batch, "key", 3);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvdb_batch_apply(NULL, 0, batch);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvdb_batch_apply(kvdb_handle, 1, batch);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, batch_txn_kvs, transactional_kvs_setup, kvs_teardown)
+{
+    struct hse_kvdb_batch *batch;
+    hse_err_t err;
+
+    batch = hse_kvdb_batch_alloc(kvdb_handle);
+    ASSERT_NE(NULL, batch);
+
+    err = hse_kvs_batch_put(kvs_handle, 0, batch, "key", 3, "value", 5);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_delete(kvs_handle, 0, batch, "key", 3);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    hse_kvdb_batch_free(kvdb_handle, batch);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, batch_success, kvs_setup_with_data, kvs_teardown)
+{
+    struct hse_kvdb_batch *batch;
+    char big[4096], buf[sizeof(big)];
+    hse_err_t err;
+    size_t len;
+    bool found;
+
+    memset(big, 'x', sizeof(big));
+
+    batch = hse_kvdb_batch_alloc(kvdb_handle);
+    ASSERT_NE(NULL, batch);
+
+    err = hse_kvs_batch_put(kvs_handle, 0, batch, "batch0", 6, "value", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put(kvs_handle, HSE_KVS_PUT_VCOMP_ON, batch, "batch1", 6, big, sizeof(big));
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_put(kvs_handle, 0, batch, "batch2", 6, NULL, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_delete(kvs_handle, 0, batch, "key0", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Nothing is visible until the batch is applied.
+     */
+    err = hse_kvs_get(kvs_handle, 0, NULL, "batch0", 6, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key0", 4, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+
+    err = hse_kvdb_batch_apply(kvdb_handle, 0, batch);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "batch0", 6, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(5, len);
+    ASSERT_EQ(0, memcmp(buf, "value", len));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "batch1", 6, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(sizeof(big), len);
+    ASSERT_EQ(0, memcmp(buf, big, len));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "batch2", 6, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(0, len);
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key0", 4, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    /* An applied batch is empty and may be reused.
+     */
+    err = hse_kvdb_batch_apply(kvdb_handle, 0, batch);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_batch_delete(kvs_handle, 0, batch, "batch0", 6);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_batch_apply(kvdb_handle, 0, batch);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "batch0", 6, &found, buf, sizeof(buf), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    hse_kvdb_batch_free(kvdb_handle, batch);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, batch_kvs_closed)
+{
+    struct hse_kvdb_batch *batch;
+    struct hse_kvs *kvs;
+    hse_err_t err;
+
+    err = hse_kvdb_kvs_create(kvdb_handle, __func__, 0, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_open(kvdb_handle, __func__, 0, NULL, &kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    batch = hse_kvdb_batch_alloc(kvdb_handle);
+    ASSERT_NE(NULL, batch);
+
+    err = hse_kvs_batch_put(kvs, 0, batch, "key", 3, "value", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* A pending batch does not hold the kvs open.
+     */
+    err = hse_kvdb_kvs_close(kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_batch_apply(kvdb_handle, 0, batch);
+    ASSERT_EQ(EBADF, hse_err_to_errno(err));
+
+    hse_kvdb_batch_free(kvdb_handle, batch);
+
+    err = hse_kvdb_kvs_drop(kvdb_handle, __func__);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+/* Sums the 64-bit operands onto the base, a missing base counting as zero.
+ */
+static int
+merge_add(
+    const void *key,
+    size_t key_len,
+    const void *base,
+    size_t base_len,
+    unsigned int opndc,
+    const void * const *opndv,
+    const size_t *opnd_lenv,
+    void *buf,
+    size_t buf_sz,
+    size_t *out_len)
+{
+    uint64_t sum = 0, opnd;
+
+    if (base) {
+        if (base_len != sizeof(sum))
+            return EINVAL;
+        memcpy(&sum, base, sizeof(sum));
+    }
+
+    for (unsigned int i = 0; i < opndc; i++) {
+        if (opnd_lenv[i] != sizeof(opnd))
+            return EINVAL;
+        memcpy(&opnd, opndv[i], sizeof(opnd));
+        sum += opnd;
+    }
+
+    memcpy(buf, &sum, sizeof(sum));
+    *out_len = sizeof(sum);
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, merge_invalid_args)
+{
+    uint64_t opnd = 1;
+    char big[HSE_KVS_MERGE_OPND_LEN_MAX + 1] = { 0 };
+    hse_err_t err;
+
+    err = hse_kvs_merge_op_set(NULL, merge_add);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge(NULL, 0, NULL, "key", 3, &opnd, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, HSE_KVS_PUT_SYNC, NULL, "key", 3, &opnd, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge(
+        (struct hse_kvs *)-1, 0, (struct hse_kvdb_txn *)-1, "key", 3, &opnd, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, NULL, 3, &opnd, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, "key", 0, &opnd, sizeof(opnd));
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+
+    err = hse_kvs_merge(
+        (struct hse_kvs *)-1, 0, NULL, "key", HSE_KVS_KEY_LEN_MAX + 1, &opnd, sizeof(opnd));
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, "key", 3, NULL, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, "key", 3, &opnd, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, "key", 3, big, sizeof(big));
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_txn_kvs, transactional_kvs_setup, kvs_teardown)
+{
+    uint64_t opnd = 1;
+    hse_err_t err;
+
+    err = hse_kvs_merge_op_set(kvs_handle, merge_add);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge(kvs_handle, 0, NULL, "key", 3, &opnd, sizeof(opnd));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_success, kvs_setup, kvs_teardown)
+{
+    uint64_t base = 100, opnd, sum;
+    hse_err_t err;
+    size_t len;
+    bool found;
+
+    err = hse_kvs_merge_op_set(kvs_handle, merge_add);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs_handle, 0, NULL, "ctr0", 4, &base, sizeof(base));
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (opnd = 1; opnd <= 10; opnd++) {
+        err = hse_kvs_merge(kvs_handle, 0, NULL, "ctr0", 4, &opnd, sizeof(opnd));
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvs_merge(kvs_handle, 0, NULL, "ctr1", 4, &opnd, sizeof(opnd));
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        /* Spread the operands of each key over c0 and cn.
+         */
+        if (opnd % 4 == 0) {
+            err = hse_kvdb_sync(kvdb_handle, 0);
+            ASSERT_EQ(0, hse_err_to_errno(err));
+        }
+    }
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr0", 4, &found, &sum, sizeof(sum), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(sizeof(sum), len);
+    ASSERT_EQ(155, sum);
+
+    /* Operands merged into a key without a value merge onto no base.
+     */
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr1", 4, &found, &sum, sizeof(sum), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(sizeof(sum), len);
+    ASSERT_EQ(55, sum);
+
+    /* A put supersedes all prior operands.
+     */
+    err = hse_kvs_put(kvs_handle, 0, NULL, "ctr1", 4, &base, sizeof(base));
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr1", 4, &found, &sum, sizeof(sum), &len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(base, sum);
+
+    /* Reads of unresolved operands fail without an operator.
+     */
+    err = hse_kvs_merge_op_set(kvs_handle, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr0", 4, &found, &sum, sizeof(sum), &len);
+    ASSERT_EQ(ENOTSUP, hse_err_to_errno(err));
+}
+
 MTF_DEFINE_UTEST(kvs_api_test, prefix_probe_null_kvs)
 {
     hse_err_t err;
@@ -138,6 +138,149 @@ MTF_DEFINE_UTEST(transaction_api_test, begin_null_txn)
     ASSERT_EQ(EINVAL, hse_err_to_errno(err));
 }
 
+MTF_DEFINE_UTEST(transaction_api_test, begin_invalid_flags)
+{
+    hse_err_t err;
+    struct hse_kvdb_txn *txn;
+
+    txn = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn);
+
+    err = hse_kvdb_txn_begin_flags(
+        kvdb_handle, ~(HSE_KVDB_TXN_BEGIN_WAIT | HSE_KVDB_TXN_BEGIN_SERIALIZABLE), txn);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    hse_kvdb_txn_free(kvdb_handle, txn);
+}
+
+MTF_DEFINE_UTEST(transaction_api_test, begin_wait)
+{
+    hse_err_t err;
+    struct hse_kvdb_txn *txn1, *txn2;
+
+    txn1 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn1);
+    txn2 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn2);
+
+    err = hse_kvdb_txn_begin(kvdb_handle, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvdb_txn_begin_flags(kvdb_handle, HSE_KVDB_TXN_BEGIN_WAIT, txn2);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs_handle, 0, txn1, "wait", 4, "1", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* The holder is still active, so the waiter times out.
+     */
+    err = hse_kvs_put(kvs_handle, 0, txn2, "wait", 4, "2", 1);
+    ASSERT_EQ(ECANCELED, hse_err_to_errno(err));
+
+    err = hse_kvdb_txn_commit(kvdb_handle, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* The holder has committed after the waiter began, which is a write
+     * conflict as always.
+     */
+    err = hse_kvs_put(kvs_handle, 0, txn2, "wait", 4, "2", 1);
+    ASSERT_EQ(ECANCELED, hse_err_to_errno(err));
+
+    hse_kvdb_txn_free(kvdb_handle, txn2);
+    hse_kvdb_txn_free(kvdb_handle, txn1);
+}
+
+MTF_DEFINE_UTEST(transaction_api_test, begin_serializable)
+{
+    hse_err_t err;
+    struct hse_kvdb_txn *txn1, *txn2;
+    char buf[8];
+    size_t vlen;
+    bool found;
+
+    txn1 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn1);
+    txn2 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn2);
+
+    err = hse_kvdb_txn_begin_flags(kvdb_handle, HSE_KVDB_TXN_BEGIN_SERIALIZABLE, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvdb_txn_begin_flags(kvdb_handle, HSE_KVDB_TXN_BEGIN_SERIALIZABLE, txn2);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Each txn writes the key the other one read (write skew), which snapshot
+     * isolation alone permits.
+     */
+    err = hse_kvs_get(kvs_handle, 0, txn1, "skew-x", 6, &found, buf, sizeof(buf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvs_get(kvs_handle, 0, txn2, "skew-y", 6, &found, buf, sizeof(buf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs_handle, 0, txn1, "skew-y", 6, "1", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvs_put(kvs_handle, 0, txn2, "skew-x", 6, "2", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_txn_commit(kvdb_handle, txn1);
+    ASSERT_EQ(ECANCELED, hse_err_to_errno(err));
+    ASSERT_EQ(HSE_KVDB_TXN_ABORTED, hse_kvdb_txn_state_get(kvdb_handle, txn1));
+
+    err = hse_kvdb_txn_commit(kvdb_handle, txn2);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* A txn that begins after the write reads it without conflict.
+     */
+    err = hse_kvdb_txn_begin_flags(kvdb_handle, HSE_KVDB_TXN_BEGIN_SERIALIZABLE, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, txn1, "skew-x", 6, &found, buf, sizeof(buf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+
+    err = hse_kvdb_txn_commit(kvdb_handle, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    hse_kvdb_txn_free(kvdb_handle, txn2);
+    hse_kvdb_txn_free(kvdb_handle, txn1);
+}
+
+MTF_DEFINE_UTEST(transaction_api_test, serializable_range_unlocked_writer)
+{
+    struct hse_kvdb_txn *txn1, *txn2;
+    struct hse_kvs_cursor *cursor;
+    hse_err_t err;
+
+    txn1 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn1);
+    txn2 = hse_kvdb_txn_alloc(kvdb_handle);
+    ASSERT_NE(NULL, txn2);
+
+    /* The writer takes no kvs-wide lock, as no serializable txn is active
+     * when it writes, but its commit still invalidates the range read.
+     */
+    err = hse_kvdb_txn_begin(kvdb_handle, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvs_put(kvs_handle, 0, txn1, "range-a", 7, "1", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_txn_begin_flags(kvdb_handle, HSE_KVDB_TXN_BEGIN_SERIALIZABLE, txn2);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvs_cursor_create(kvs_handle, 0, txn2, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_txn_commit(kvdb_handle, txn1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs_handle, 0, txn2, "range-b", 7, "2", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    err = hse_kvdb_txn_commit(kvdb_handle, txn2);
+    ASSERT_EQ(ECANCELED, hse_err_to_errno(err));
+
+    hse_kvdb_txn_free(kvdb_handle, txn2);
+    hse_kvdb_txn_free(kvdb_handle, txn1);
+}
+
 MTF_DEFINE_UTEST(transaction_api_test, commit_null_kvdb)
 {
     hse_err_t err;
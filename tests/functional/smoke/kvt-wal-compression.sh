@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+
+# SPDX-License-Identifier: Apache-2.0 OR MIT
+#
+# SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+
+#doc: kvt crash test with values compressed for the WAL only (replay and read back)
+
+. common.subr
+
+trap cleanup EXIT
+kvdb_create
+
+cpus=$(nproc)
+
+props="-oinodesc=3,datac=7"
+rparams="durability.compression.min_value_bytes=1024"
+
+cmd kvt -i64k -l1k,16k -ovrunlen=32 "${props}" "$home" kvdb-oparms "${rparams}"
+cmd -s 9 kvt -T60,$((cpus * 2)) -ccv -l1k,16k -m1 -ovrunlen=32 -K9,10,20 "${props}" "$home" kvdb-oparms "${rparams}"
+
+cmd kvt -cv "${props}" "$home"
+cmd kvt -cv "${props}" "$home" kvdb-oparms "${rparams}"
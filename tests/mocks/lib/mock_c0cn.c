@@ -316,7 +316,8 @@ _c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct mock_c0 *m0 = mock_c0_h2r(handle);
     int i;
@@ -347,7 +348,8 @@ _cn_get(
     struct kvs_ktuple *kt,
     uint64_t seq,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     *res = NOT_FOUND;
     return 0;
@@ -652,6 +654,11 @@ static struct mapi_injection cn_inject_list[] = {
     { mapi_idx_cn_get_mpool, MAPI_RC_PTR, NULL },
     { mapi_idx_cn_get_mclass_policy, MAPI_RC_PTR, NULL },
     { mapi_idx_cn_get_ingest_perfc, MAPI_RC_PTR, NULL },
+    { mapi_idx_cn_get_io_wq, MAPI_RC_PTR, NULL },
+    { mapi_idx_cn_get_merge_fn, MAPI_RC_PTR, NULL },
+    { mapi_idx_cn_set_merge_fn, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_set_ingest_inval, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_ingest_inval, MAPI_RC_SCALAR, 0 },
 
     { -1 },
 };
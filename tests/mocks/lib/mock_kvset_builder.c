@@ -43,6 +43,7 @@ _kvset_builder_destroy(struct kvset_builder *bld)
  */
 static struct mapi_injection inject_list[] = {
     { mapi_idx_kvset_builder_add_key, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_kvset_builder_add_mopnd, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_builder_add_nonval, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_builder_add_val, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_builder_add_vref, MAPI_RC_SCALAR, 0 },
@@ -269,6 +269,22 @@ _mpool_mblock_read(struct mpool *mp, uint64_t id, const struct iovec *iovec, int
     return mblock_rw(id, iovec, niov, off, true);
 }
 
+static merr_t
+_mpool_mblock_read_async(
+    struct mpool *mp,
+    uint64_t id,
+    const struct iovec *iovec,
+    int niov,
+    off_t off,
+    struct mpool_aio *aio)
+{
+    aio->ma_len = 0;
+    aio->ma_err = mblock_rw(id, iovec, niov, off, true);
+    aio->ma_cb(aio);
+
+    return 0;
+}
+
 static merr_t
 _mpool_mblock_write(struct mpool *mp, uint64_t id, const struct iovec *iovec, int niov)
 {
@@ -678,6 +694,7 @@ mock_mpool_set(void)
     MOCK_SET(mpool, _mpool_mblock_delete);
     MOCK_SET(mpool, _mpool_mblock_props_get);
     MOCK_SET(mpool, _mpool_mblock_read);
+    MOCK_SET(mpool, _mpool_mblock_read_async);
     MOCK_SET(mpool, _mpool_mblock_write);
 
     MOCK_SET(mpool, _mpool_mdc_append);
@@ -704,6 +721,7 @@ mock_mpool_unset(void)
     MOCK_UNSET(mpool, _mpool_mblock_delete);
     MOCK_UNSET(mpool, _mpool_mblock_props_get);
     MOCK_UNSET(mpool, _mpool_mblock_read);
+    MOCK_UNSET(mpool, _mpool_mblock_read_async);
     MOCK_UNSET(mpool, _mpool_mblock_write);
 
     MOCK_UNSET(mpool, _mpool_mdc_append);
@@ -228,7 +228,7 @@ MTF_DEFINE_UTEST(c0_test, basic_ops)
     mapi_calls_clear(mapi_idx_c0sk_del);
 
     /* c0_get */
-    err = c0_get(c0, &kt, seqno, 0, &res, &vbuf);
+    err = c0_get(c0, &kt, seqno, 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(1, mapi_calls(mapi_idx_c0sk_get));
     mapi_calls_clear(mapi_idx_c0sk_get);
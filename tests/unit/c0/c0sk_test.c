@@ -185,6 +185,70 @@ no_fail_ctxn_pre(struct mtf_test_info *info)
     return 0;
 }
 
+/* The multi-kvs ingest test gives each kvs its own mock cn, from which the
+ * mocked builder learns its kvs, and records the keys each builder receives.
+ */
+#define MKVS_CNT   5
+#define MKVS_KEYS  1000
+#define MKVS_KLEN  8
+
+struct mkvs_bldr {
+    uint mb_kvs;
+};
+
+static struct cn *mkvs_cnv[MKVS_CNT];
+static char mkvs_keyv[MKVS_CNT][MKVS_KEYS][MKVS_KLEN + 1];
+static uint mkvs_keyc[MKVS_CNT];
+static atomic_int mkvs_bldrc[MKVS_CNT];
+
+static merr_t
+mkvs_builder_create(
+    struct kvset_builder **builder_out,
+    struct cn *cn,
+    struct perfc_set *pc,
+    uint64_t vgroup)
+{
+    struct mkvs_bldr *bldr;
+    uint i;
+
+    for (i = 0; i < MKVS_CNT && mkvs_cnv[i] != cn; i++)
+        ; /* do nothing */
+
+    assert(i < MKVS_CNT);
+
+    bldr = calloc(1, sizeof(*bldr));
+    if (!bldr)
+        return merr(ENOMEM);
+
+    bldr->mb_kvs = i;
+    atomic_inc(&mkvs_bldrc[i]);
+
+    *builder_out = (struct kvset_builder *)bldr;
+
+    return 0;
+}
+
+static merr_t
+mkvs_builder_add_key(struct kvset_builder *self, const struct key_obj *kobj)
+{
+    struct mkvs_bldr *bldr = (struct mkvs_bldr *)self;
+    uint kvs = bldr->mb_kvs;
+    uint klen;
+
+    if (mkvs_keyc[kvs] >= MKVS_KEYS)
+        return merr(EOVERFLOW);
+
+    key_obj_copy(mkvs_keyv[kvs][mkvs_keyc[kvs]++], MKVS_KLEN, &klen, kobj);
+
+    return 0;
+}
+
+static void
+mkvs_builder_destroy(struct kvset_builder *self)
+{
+    free(self);
+}
+
 MTF_BEGIN_UTEST_COLLECTION_PREPOST(c0sk_test, test_collection_setup, test_collection_teardown);
 
 MTF_DEFINE_UTEST_PREPOST(c0sk_test, basic, no_fail_pre, no_fail_post)
@@ -325,13 +389,14 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
         err = c0sk_put(mkvdb.ikdb_c0sk, skidx, &kt, &vt, HSE_SQNREF_SINGLE);
         ASSERT_EQ(0, err);
 
-        err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+        err = c0sk_get(
+            mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
         ASSERT_EQ(0, err);
         ASSERT_EQ(res, FOUND_VAL);
 
         if (i % 5 == 0 && kt.kt_len >= pfx_len) {
-            err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+            err = c0sk_get(
+                mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
 
             if (res != FOUND_TMB) {
@@ -342,12 +407,14 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
                 ASSERT_EQ(0, err);
 
                 err = c0sk_get(
-                    mkvdb.ikdb_c0sk, skidx, pfx_len, &pfx_kt, atomic_read(&seqno), 0, &res, &vbuf);
+                    mkvdb.ikdb_c0sk, skidx, pfx_len, &pfx_kt, atomic_read(&seqno), 0, &res, &vbuf,
+                    NULL);
                 ASSERT_EQ(0, err);
                 ASSERT_EQ(res, FOUND_PTMB);
 
                 err = c0sk_get(
-                    mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+                    mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf,
+                    NULL);
                 ASSERT_EQ(0, err);
                 ASSERT_EQ(res, FOUND_PTMB);
 
@@ -356,8 +423,8 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
             }
 
             atomic_inc(&seqno);
-            err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+            err = c0sk_get(
+                mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
             ASSERT_EQ(res, FOUND_VAL);
 
@@ -365,8 +432,8 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
             err = c0sk_del(mkvdb.ikdb_c0sk, skidx, &kt, HSE_SQNREF_SINGLE);
             ASSERT_EQ(0, err);
 
-            err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+            err = c0sk_get(
+                mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
             ASSERT_EQ(res, FOUND_TMB);
         }
@@ -375,7 +442,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
     err = c0sk_del(mkvdb.ikdb_c0sk, skidx, &kt, HSE_SQNREF_SINGLE);
     ASSERT_EQ(0, err);
 
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, FOUND_TMB);
 
@@ -443,6 +510,111 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, t_sync, no_fail_pre, no_fail_post)
     destroy_mock_cn(mock_cn);
 }
 
+MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_multi_kvs, no_fail_pre, no_fail_post)
+{
+    struct kvdb_rparams kvdb_rp;
+    struct c0_kvmultiset *kvms;
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    struct mock_kvdb mkvdb;
+    struct c0sk_impl *self;
+    char key[MKVS_KLEN + 1];
+    uint16_t skidx[MKVS_CNT];
+    atomic_ulong seqno;
+    merr_t err;
+    int i, j;
+
+    memset(mkvs_keyv, 0, sizeof(mkvs_keyv));
+    memset(mkvs_keyc, 0, sizeof(mkvs_keyc));
+
+    mapi_inject_unset(mapi_idx_kvset_builder_add_key);
+    mapi_inject_unset(mapi_idx_kvset_builder_destroy);
+    MOCK_SET_FN(kvset_builder, kvset_builder_create, mkvs_builder_create);
+    MOCK_SET_FN(kvset_builder, kvset_builder_add_key, mkvs_builder_add_key);
+    MOCK_SET_FN(kvset_builder, kvset_builder_destroy, mkvs_builder_destroy);
+
+    kvdb_rp = kvdb_rparams_defaults();
+
+    kvdb_rp.c0_ingest_width = 2;
+    kvdb_rp.c0_ingest_build_threads = 4;
+
+    atomic_set(&seqno, 0);
+    err = c0sk_open(&kvdb_rp, 0, "mock_mp", &mock_health, &seqno, 0, &mkvdb.ikdb_c0sk);
+    ASSERT_EQ(0, err);
+    ASSERT_NE((struct c0sk *)0, mkvdb.ikdb_c0sk);
+
+    for (i = 0; i < MKVS_CNT; i++) {
+        atomic_set(&mkvs_bldrc[i], 0);
+
+        err = create_mock_cn(&mkvs_cnv[i], false, false, 0);
+        ASSERT_EQ(0, err);
+
+        err = c0sk_c0_register(mkvdb.ikdb_c0sk, mkvs_cnv[i], &skidx[i]);
+        ASSERT_EQ(0, err);
+    }
+
+    self = c0sk_h2r(mkvdb.ikdb_c0sk);
+
+    err = c0kvms_create(1, &seqno, NULL, &kvms);
+    ASSERT_EQ(0, err);
+    ASSERT_NE(NULL, kvms);
+
+    err = c0sk_install_c0kvms(self, NULL, kvms);
+    ASSERT_EQ(0, err);
+
+    /* All kvses share one key space.  Kvs i receives the keys from i * 100
+     * onward, in descending order and interleaved with the other kvses' puts.
+     * The last kvs receives no keys at all.
+     */
+    kvs_ktuple_init(&kt, key, MKVS_KLEN);
+
+    for (j = MKVS_KEYS - 1; j >= 0; j--) {
+        snprintf(key, sizeof(key), "key%05d", j);
+
+        for (i = 0; i < MKVS_CNT - 1; i++) {
+            if (j < i * 100)
+                continue;
+
+            kvs_vtuple_init(&vt, &i, sizeof(i));
+
+            err = c0sk_put(mkvdb.ikdb_c0sk, skidx[i], &kt, &vt, HSE_SQNREF_SINGLE);
+            ASSERT_EQ(0, err);
+        }
+    }
+
+    err = c0sk_sync(mkvdb.ikdb_c0sk, 0);
+    ASSERT_EQ(0, err);
+
+    /* Each kvs must have got one kvset holding exactly its own keys, in order.
+     */
+    for (i = 0; i < MKVS_CNT - 1; i++) {
+        ASSERT_EQ(1, atomic_read(&mkvs_bldrc[i]));
+        ASSERT_EQ(MKVS_KEYS - i * 100, mkvs_keyc[i]);
+
+        for (j = 0; j < mkvs_keyc[i]; j++) {
+            snprintf(key, sizeof(key), "key%05d", i * 100 + j);
+            ASSERT_EQ(0, memcmp(key, mkvs_keyv[i][j], MKVS_KLEN));
+        }
+    }
+
+    ASSERT_EQ(0, atomic_read(&mkvs_bldrc[MKVS_CNT - 1]));
+    ASSERT_EQ(0, mkvs_keyc[MKVS_CNT - 1]);
+
+    c0kvms_putref(kvms);
+
+    err = c0sk_close(mkvdb.ikdb_c0sk);
+    ASSERT_EQ(0, err);
+
+    for (i = 0; i < MKVS_CNT; i++)
+        destroy_mock_cn(mkvs_cnv[i]);
+
+    MOCK_SET(kvset_builder, _kvset_builder_create);
+    MOCK_UNSET_FN(kvset_builder, kvset_builder_add_key);
+    MOCK_UNSET_FN(kvset_builder, kvset_builder_destroy);
+    mapi_inject(mapi_idx_kvset_builder_add_key, 0);
+    mapi_inject(mapi_idx_kvset_builder_destroy, 0);
+}
+
 MTF_DEFINE_UTEST_PREPOST(c0sk_test, various, no_fail_pre, no_fail_post)
 {
     struct kvdb_rparams kvdb_rp;
@@ -1496,7 +1668,7 @@ parallel_get_helper(void *arg)
 
         kvs_ktuple_init(&kt, key_buf, key_len);
 
-        c0sk_get(ikvdb, skidx, pfx_len, &kt, seq, 0, &res, &vbuf);
+        c0sk_get(ikvdb, skidx, pfx_len, &kt, seq, 0, &res, &vbuf, NULL);
         if (found) {
             int rc = memcmp(key_buf, val_buf, key_len);
 
@@ -1663,14 +1835,14 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, c0sk_get_test, no_fail_pre, no_fail_post)
 
     /* small buffer */
     kvs_buf_init(&vbuf, buf, 4); /* insufficiently sized buffer */
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, merr_errno(err));
     ASSERT_EQ(res, FOUND_VAL);
     ASSERT_EQ(vbuf.b_len, kvs_vtuple_vlen(&vt));
     ASSERT_EQ(0, strncmp(buf, "this", vbuf.b_buf_sz));
 
     kvs_buf_init(&vbuf, buf, vbuf.b_len);
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, FOUND_VAL);
     ASSERT_EQ(vbuf.b_len, kvs_vtuple_vlen(&vt));
@@ -1680,7 +1852,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, c0sk_get_test, no_fail_pre, no_fail_post)
     str = "shouldnt_exist";
     kvs_ktuple_init(&kt, str, strlen(str));
     kvs_buf_init(&vbuf, buf, sizeof(buf));
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, NOT_FOUND);
 
@@ -110,6 +110,7 @@ mock_cn_best_ingest_count(struct cn *cn, unsigned avg_key_len)
 struct mapi_injection inject_list[] = { { mapi_idx_cn_disable_maint, MAPI_RC_SCALAR, 0 },
                                         { mapi_idx_cn_get_cnid, MAPI_RC_SCALAR, 1 },
                                         { mapi_idx_cn_disable_maint, MAPI_RC_SCALAR, 0 },
+                                        { mapi_idx_cn_ingest_inval, MAPI_RC_SCALAR, 0 },
                                         { -1 } };
 
 merr_t
@@ -98,7 +98,7 @@ read_blooms(struct mtf_test_info *lcl_ti, char *kblock_file)
     mpm_mblock_read(blkid, &blm_hdr, omf_kbh_blm_hoff(&kb_hdr), omf_kbh_blm_hlen(&kb_hdr));
 
     ASSERT_EQ(omf_bh_magic(&blm_hdr), BLOOM_OMF_MAGIC);
-    ASSERT_EQ(omf_bh_version(&blm_hdr), BLOOM_OMF_VERSION);
+    ASSERT_EQ(omf_bh_version(&blm_hdr), BLOOM_OMF_VERSION5);
 
     ASSERT_GE(omf_bh_bktshift(&blm_hdr), 9);
     ASSERT_LE(omf_bh_bktshift(&blm_hdr), 16);
@@ -154,6 +154,30 @@ read_blooms(struct mtf_test_info *lcl_ti, char *kblock_file)
      */
     ASSERT_LT((fpc * 1000) / cnt, 25); /* < 2.5% */
 
+    /* A batch probe must agree with individual probes, including when
+     * the same filter appears more than once in the batch.
+     */
+    for (i = 0; i < cnt; i += 8) {
+        const struct bloom_desc *descv[8];
+        uint64_t hashv[8];
+        bool hitv[8];
+        uint j;
+
+        for (j = 0; j < 8; ++j) {
+            int len = snprintf(keybuf, sizeof(keybuf), "k%u", (i + j / 2) % cnt);
+
+            kvs_ktuple_init(&ktuple, keybuf, len);
+
+            descv[j] = &rgndesc;
+            hashv[j] = (j & 1) ? ~ktuple.kt_hash : ktuple.kt_hash;
+        }
+
+        bloom_reader_lookup_batch(descv, hashv, 8, hitv);
+
+        for (j = 0; j < 8; ++j)
+            ASSERT_EQ(bloom_reader_lookup(&rgndesc, hashv[j]), hitv[j]);
+    }
+
     free(blm_pages);
 }
 
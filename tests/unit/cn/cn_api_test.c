@@ -96,7 +96,7 @@ MTF_DEFINE_UTEST_PRE(cn_api, basic, pre)
     (void)cn_get_perfc(cn, CN_ACTION_SPILL);
     (void)cn_get_perfc(cn, CN_ACTION_NONE);
 
-    err = cn_get(cn, &kt, 0, &res, &vbuf);
+    err = cn_get(cn, &kt, 0, &res, &vbuf, NULL);
     ASSERT_EQ(err, 0);
     ASSERT_EQ(res, NOT_FOUND);
 
@@ -12,6 +12,7 @@
 #include <hse/ikvdb/kvdb_health.h>
 #include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/ikvdb/tuple.h>
 #include <hse/logging/logging.h>
 #include <hse/util/keycmp.h>
 
@@ -257,6 +258,46 @@ _kvset_iter_release(struct kv_iterator *h)
     mapi_safe_free(mk);
 }
 
+/* Records of the kvsets filtered and searched by cn_tree_lookup().
+ */
+static uint filter_runv[32];
+static uint filter_runc;
+static uint64_t lookup_dgenv[64];
+static uint lookup_dgenc;
+static uint64_t lookup_hit_dgen;
+
+static void
+_kvset_lookup_filter(
+    struct kvset *const *kvsetv,
+    uint kvsetc,
+    const struct kvs_ktuple *kt,
+    const struct key_disc *kdisc,
+    int *kblkv)
+{
+    filter_runv[filter_runc++] = kvsetc;
+
+    for (uint i = 0; i < kvsetc; i++)
+        kblkv[i] = 0;
+}
+
+static merr_t
+_kvset_lookup(
+    struct kvset *kvset,
+    struct kvs_ktuple *kt,
+    int kblk,
+    uint64_t seq,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
+{
+    struct fake_kvset *fk = (struct fake_kvset *)kvset;
+
+    lookup_dgenv[lookup_dgenc++] = fk->dgen_hi;
+    *res = (fk->dgen_hi == lookup_hit_dgen) ? FOUND_VAL : NOT_FOUND;
+
+    return 0;
+}
+
 atomic_int g_cancel_request;
 
 /* Prefer the mapi_inject_list method for mocking functions over the
@@ -285,6 +326,7 @@ struct mapi_injection inject_list[] = {
     { mapi_idx_kvset_get_hlog, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_get_vbsetv, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_get_vgroups, MAPI_RC_SCALAR, 1 },
+    { mapi_idx_kvset_get_scatter, MAPI_RC_SCALAR, 1 },
     { mapi_idx_vgmap_vbidx_out_end, MAPI_RC_SCALAR, 0 },
 
     /* cn */
@@ -460,6 +502,45 @@ MTF_DEFINE_UTEST_PRE(test, t_simple_api, test_setup)
     cn_tree_destroy(tree);
 }
 
+MTF_DEFINE_UTEST_PRE(test, t_node_heat, test_setup)
+{
+    struct kvs_cparams cp = {};
+    struct cn_tree *tree = NULL;
+    struct cn_tree_node *tn;
+    merr_t err;
+
+    err = cn_tree_create(&tree, 0, &cp, &mock_health, rp);
+    ASSERT_EQ(0, err);
+
+    tn = cn_node_alloc(tree, 1);
+    ASSERT_NE(NULL, tn);
+
+    for (int i = 0; i < 1000 * CN_NODE_HEAT_SAMPLE; i++)
+        cn_node_heat_record(tn);
+
+    cn_node_heat_update(tn);
+    ASSERT_EQ(500 * CN_NODE_HEAT_SAMPLE, atomic_read(&tn->tn_heat));
+    ASSERT_EQ(0, atomic_read(&tn->tn_heat_reads));
+
+    ASSERT_FALSE(cn_node_ishot(tn, rp));
+
+    rp->cn_mclass_hot = 500 * CN_NODE_HEAT_SAMPLE;
+    ASSERT_TRUE(cn_node_ishot(tn, rp));
+    ASSERT_FALSE(cn_node_ishot(tree->ct_root, rp));
+    ASSERT_FALSE(cn_node_ishot(NULL, rp));
+
+    /* Heat decays in the absence of reads.
+     */
+    cn_node_heat_update(tn);
+    ASSERT_EQ(250 * CN_NODE_HEAT_SAMPLE, atomic_read(&tn->tn_heat));
+    ASSERT_FALSE(cn_node_ishot(tn, rp));
+
+    rp->cn_mclass_hot = 0;
+
+    cn_node_free(tn);
+    cn_tree_destroy(tree);
+}
+
 MTF_DEFINE_UTEST_PRE(test, t_cn_tree_ingest_update, test_setup)
 {
     struct cn_tree *tree;
@@ -501,6 +582,88 @@ MTF_DEFINE_UTEST_PRE(test, t_cn_tree_ingest_update, test_setup)
         fake_kvset_destroy((struct fake_kvset *)kvsetv[i]);
 }
 
+MTF_DEFINE_UTEST_PRE(test, t_cn_tree_lookup, test_setup)
+{
+    struct fake_kvset *kvset_list = NULL;
+    const uint kvsetc = 20;
+    struct kvs_cparams cp = {};
+    struct cn_tree *tree;
+    struct kvs_ktuple kt;
+    enum key_lookup_res res;
+    merr_t err;
+
+    MOCK_SET(kvset, _kvset_lookup_filter);
+    MOCK_SET(kvset, _kvset_lookup);
+
+    err = cn_tree_create(&tree, 0, &cp, &mock_health, rp);
+    ASSERT_EQ(0, err);
+
+    for (uint i = 0; i < kvsetc; i++)
+        ASSERT_NE(NULL, fake_kvset_open_add(&kvset_list, tree, 0, 100 + i));
+
+    kvs_ktuple_init(&kt, "key", 3);
+
+    /* Found in the newest kvset: only the first (short) run is filtered.
+     */
+    filter_runc = lookup_dgenc = 0;
+    lookup_hit_dgen = 100 + kvsetc - 1;
+
+    err = cn_tree_lookup(tree, NULL, &kt, 1, &res, NULL, NULL, NULL);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(FOUND_VAL, res);
+    ASSERT_EQ(1, filter_runc);
+    ASSERT_EQ(KVSET_FILTER_MIN, filter_runv[0]);
+    ASSERT_EQ(1, lookup_dgenc);
+
+    /* Found in the tenth newest kvset: runs grow 2, 4, 8.
+     */
+    filter_runc = lookup_dgenc = 0;
+    lookup_hit_dgen = 100 + kvsetc - 10;
+
+    err = cn_tree_lookup(tree, NULL, &kt, 1, &res, NULL, NULL, NULL);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(FOUND_VAL, res);
+    ASSERT_EQ(3, filter_runc);
+    ASSERT_EQ(2, filter_runv[0]);
+    ASSERT_EQ(4, filter_runv[1]);
+    ASSERT_EQ(8, filter_runv[2]);
+    ASSERT_EQ(10, lookup_dgenc);
+
+    for (uint i = 0; i < lookup_dgenc; i++)
+        ASSERT_EQ(100 + kvsetc - 1 - i, lookup_dgenv[i]);
+
+    /* Not found: every kvset is filtered and searched exactly once, in
+     * order from newest to oldest, in runs of at most KVSET_FILTER_MAX.
+     */
+    filter_runc = lookup_dgenc = 0;
+    lookup_hit_dgen = 0;
+
+    err = cn_tree_lookup(tree, NULL, &kt, 1, &res, NULL, NULL, NULL);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(NOT_FOUND, res);
+    ASSERT_EQ(4, filter_runc);
+    ASSERT_EQ(kvsetc - 2 - 4 - 8, filter_runv[3]);
+    ASSERT_EQ(kvsetc, lookup_dgenc);
+
+    for (uint i = 0; i < filter_runc; i++)
+        ASSERT_GE(KVSET_FILTER_MAX, filter_runv[i]);
+
+    for (uint i = 0; i < lookup_dgenc; i++)
+        ASSERT_EQ(100 + kvsetc - 1 - i, lookup_dgenv[i]);
+
+    MOCK_UNSET(kvset, _kvset_lookup_filter);
+    MOCK_UNSET(kvset, _kvset_lookup);
+
+    cn_tree_destroy(tree);
+
+    while (kvset_list) {
+        struct fake_kvset *kvset = kvset_list;
+
+        kvset_list = kvset->next;
+        fake_kvset_destroy(kvset);
+    }
+}
+
 /*----------------------------------------------------------------
  * Support for the MY_TEST1 and MY_TEST2 macros below
  */
@@ -0,0 +1,312 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/cn.h>
+#include <hse/ikvdb/cndb.h>
+#include <hse/ikvdb/kvset_builder.h>
+#include <hse/ikvdb/sched_sts.h>
+#include <hse/util/atomic.h>
+#include <hse/util/key_util.h>
+#include <hse/util/platform.h>
+
+#include <hse/test/mock/api.h>
+#include <hse/test/mtf/framework.h>
+
+#include "cn/cn_metrics.h"
+#include "cn/cn_tree.h"
+#include "cn/cn_tree_compact.h"
+#include "cn/compact_slice.h"
+#include "cn/kvset.h"
+
+/* The mocked input kvsets all share one sorted key space, kvset i holding
+ * every key whose index is congruent to i modulo NKVSETS.  The pivot kvset
+ * has NKBLKS kblocks, each covering an equal share of the key space.
+ */
+#define NKEYS   4000
+#define NKVSETS 3
+#define NKBLKS  16
+#define KEYLEN  8
+
+static char keyv[NKEYS][KEYLEN + 1];
+static struct kvset_stats mock_stats = { .kst_kblks = NKBLKS };
+static atomic_int slices_started;
+static atomic_int slices_on_workers;
+static pthread_t caller;
+static int fail_slice = -1;
+
+struct mock_bldr {
+    uint keyv[NKEYS];
+    uint keyc;
+};
+
+static struct kvset *
+mocked_kvset_iter_kvset_get(struct kv_iterator *handle)
+{
+    return (struct kvset *)handle;
+}
+
+static const struct kvset_stats *
+mocked_kvset_statsp(const struct kvset *ks)
+{
+    return &mock_stats;
+}
+
+static void
+mocked_kvset_kblk_minkey(const struct kvset *ks, uint32_t index, const void **key, uint16_t *klen)
+{
+    *key = keyv[index * NKEYS / NKBLKS];
+    *klen = KEYLEN;
+}
+
+static void
+mocked_kvset_kblk_range(
+    const struct kvset *ks,
+    const struct key_obj *lo,
+    const struct key_obj *hi,
+    uint *start,
+    uint *end)
+{
+    *start = 0;
+    *end = NKBLKS;
+}
+
+static merr_t
+mocked_kvset_iter_create_range(
+    struct kvset *kvset,
+    struct workqueue_struct *io_workq,
+    struct workqueue_struct *vra_wq,
+    struct perfc_set *pc,
+    enum kvset_iter_flags flags,
+    uint kblk_start,
+    uint kblk_end,
+    struct kv_iterator **kv_iter)
+{
+    *kv_iter = (struct kv_iterator *)kvset;
+    return 0;
+}
+
+static merr_t
+mocked_kvset_builder_create(
+    struct kvset_builder **builder_out,
+    struct cn *cn,
+    struct perfc_set *pc,
+    uint64_t vgroup)
+{
+    *builder_out = calloc(1, sizeof(struct mock_bldr));
+
+    return *builder_out ? 0 : merr(ENOMEM);
+}
+
+static void
+mocked_kvset_builder_destroy(struct kvset_builder *builder)
+{
+    free(builder);
+}
+
+static merr_t
+mocked_kvset_builder_adopt_slices(
+    struct kvset_builder *self,
+    struct kvset_builder **slicev,
+    uint slicec)
+{
+    struct mock_bldr *dst = (void *)self;
+
+    for (uint i = 0; i < slicec; i++) {
+        struct mock_bldr *src = (void *)slicev[i];
+
+        memcpy(dst->keyv + dst->keyc, src->keyv, src->keyc * sizeof(src->keyv[0]));
+        dst->keyc += src->keyc;
+    }
+
+    return 0;
+}
+
+/* Merge the keys of the slice's input kvsets in key order.
+ */
+static merr_t
+mock_merge(struct compact_slice *cs)
+{
+    struct mock_bldr *bldr = (void *)cs->cs_bldr;
+    struct cn_compaction_work *w = cs->cs_work;
+    int idx = atomic_inc_return(&slices_started);
+
+    if (!pthread_equal(pthread_self(), caller))
+        atomic_inc(&slices_on_workers);
+
+    /* Hold up slice 0 until some other slice has started so that the
+     * workers get a chance to run slices (gives up after ~10s).
+     */
+    if (cs->cs_progress && w->cw_job.sj_sts) {
+        for (int i = 0; i < 10000 && atomic_read(&slices_started) < 2; i++)
+            usleep(1000);
+    }
+
+    if (idx == fail_slice)
+        return merr(EIO);
+
+    for (uint i = 0; i < NKEYS; i++) {
+        struct key_obj kobj;
+
+        if (!cs->cs_inputv[i % NKVSETS])
+            continue;
+
+        key2kobj(&kobj, keyv[i], KEYLEN);
+
+        if (compact_slice_lo(cs, &kobj) || compact_slice_hi(cs, &kobj))
+            continue;
+
+        bldr->keyv[bldr->keyc++] = i;
+        cs->cs_stats->ms_keys_out++;
+    }
+
+    return 0;
+}
+
+static int
+pre(struct mtf_test_info *info)
+{
+    for (uint i = 0; i < NKEYS; i++)
+        snprintf(keyv[i], sizeof(keyv[i]), "key%05u", i);
+
+    MOCK_SET_FN(kvset, kvset_iter_kvset_get, mocked_kvset_iter_kvset_get);
+    MOCK_SET_FN(kvset, kvset_statsp, mocked_kvset_statsp);
+    MOCK_SET_FN(kvset, kvset_kblk_minkey, mocked_kvset_kblk_minkey);
+    MOCK_SET_FN(kvset, kvset_kblk_range, mocked_kvset_kblk_range);
+    MOCK_SET_FN(kvset, kvset_iter_create_range, mocked_kvset_iter_create_range);
+    MOCK_SET_FN(kvset_builder, kvset_builder_create, mocked_kvset_builder_create);
+    MOCK_SET_FN(kvset_builder, kvset_builder_destroy, mocked_kvset_builder_destroy);
+    MOCK_SET_FN(kvset_builder, kvset_builder_adopt_slices, mocked_kvset_builder_adopt_slices);
+
+    mapi_inject(mapi_idx_kvset_iter_set_stats, 0);
+    mapi_inject(mapi_idx_kvset_iter_release, 0);
+    mapi_inject(mapi_idx_kvset_builder_set_agegroup, 0);
+    mapi_inject(mapi_idx_kvset_builder_set_merge_stats, 0);
+    mapi_inject(mapi_idx_kvset_builder_set_vbidx_base, 0);
+    mapi_inject(mapi_idx_cndb_kvsetid_mint, 1);
+    mapi_inject_ptr(mapi_idx_cn_tree_get_cndb, NULL);
+    mapi_inject_ptr(mapi_idx_cn_tree_get_cn, NULL);
+    mapi_inject_ptr(mapi_idx_cn_get_maint_wq, NULL);
+
+    atomic_set(&slices_started, 0);
+    atomic_set(&slices_on_workers, 0);
+    caller = pthread_self();
+    fail_slice = -1;
+
+    return 0;
+}
+
+static int
+post(struct mtf_test_info *info)
+{
+    mapi_inject_clear();
+
+    return 0;
+}
+
+static merr_t
+run_slices(uint slicec, struct sts *sts, struct mock_bldr *out, struct cn_merge_stats *stats)
+{
+    struct kv_iterator *inputv[NKVSETS];
+    struct cn_compaction_work w = { 0 };
+    uint64_t kvsetid = 1;
+    merr_t err;
+
+    for (uint i = 0; i < NKVSETS; i++)
+        inputv[i] = (struct kv_iterator *)(uintptr_t)(0x1000 + i);
+
+    w.cw_kvset_cnt = NKVSETS;
+    w.cw_inputv = inputv;
+    w.cw_kvsetidv = &kvsetid;
+    w.cw_job.sj_sts = sts;
+
+    memset(out, 0, sizeof(*out));
+
+    err = compact_slice_run(&w, slicec, mock_merge, (struct kvset_builder *)out);
+    *stats = w.cw_stats;
+
+    return err;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(compact_slice_test);
+
+MTF_DEFINE_UTEST_PREPOST(compact_slice_test, inline_slices, pre, post)
+{
+    static struct mock_bldr serial, sliced;
+    struct cn_merge_stats stats1, stats2;
+    merr_t err;
+
+    err = run_slices(1, NULL, &serial, &stats1);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(NKEYS, serial.keyc);
+
+    for (uint i = 0; i < serial.keyc; i++)
+        ASSERT_EQ(i, serial.keyv[i]);
+
+    /* Without an sts every slice runs in the calling thread.
+     */
+    atomic_set(&slices_started, 0);
+    err = run_slices(4, NULL, &sliced, &stats2);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(4, atomic_read(&slices_started));
+    ASSERT_EQ(0, atomic_read(&slices_on_workers));
+
+    ASSERT_EQ(serial.keyc, sliced.keyc);
+    ASSERT_EQ(0, memcmp(serial.keyv, sliced.keyv, serial.keyc * sizeof(serial.keyv[0])));
+    ASSERT_EQ(stats1.ms_keys_out, stats2.ms_keys_out);
+}
+
+MTF_DEFINE_UTEST_PREPOST(compact_slice_test, sts_slices, pre, post)
+{
+    static struct mock_bldr serial, sliced;
+    struct cn_merge_stats stats1, stats2;
+    struct sts *sts;
+    merr_t err;
+
+    err = sts_create("cslice_test", 1, &sts);
+    ASSERT_EQ(0, err);
+
+    err = run_slices(1, sts, &serial, &stats1);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(NKEYS, serial.keyc);
+
+    for (uint slicec = 2; slicec <= 8; slicec *= 2) {
+        atomic_set(&slices_started, 0);
+        atomic_set(&slices_on_workers, 0);
+
+        err = run_slices(slicec, sts, &sliced, &stats2);
+        ASSERT_EQ(0, err);
+        ASSERT_EQ(slicec, atomic_read(&slices_started));
+        ASSERT_GT(atomic_read(&slices_on_workers), 0);
+
+        ASSERT_EQ(serial.keyc, sliced.keyc);
+        ASSERT_EQ(0, memcmp(serial.keyv, sliced.keyv, serial.keyc * sizeof(serial.keyv[0])));
+        ASSERT_EQ(stats1.ms_keys_out, stats2.ms_keys_out);
+    }
+
+    /* Slice jobs that found their slice already run must not hold up
+     * sts_destroy().
+     */
+    sts_destroy(sts);
+}
+
+MTF_DEFINE_UTEST_PREPOST(compact_slice_test, slice_error, pre, post)
+{
+    static struct mock_bldr sliced;
+    struct cn_merge_stats stats;
+    merr_t err;
+
+    fail_slice = 3;
+
+    err = run_slices(4, NULL, &sliced, &stats);
+    ASSERT_EQ(EIO, merr_errno(err));
+    ASSERT_EQ(0, sliced.keyc);
+}
+
+MTF_END_UTEST_COLLECTION(compact_slice_test)
@@ -336,6 +336,7 @@ struct mapi_injection inject_list[] = {
     { mapi_idx_cn_ref_get, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_ref_put, MAPI_RC_SCALAR, 0 },
     { mapi_idx_kvset_get_vgroups, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_kvset_get_scatter, MAPI_RC_SCALAR, 0 },
     { mapi_idx_route_map_delete, MAPI_RC_SCALAR, 0 },
     { -1 },
 };
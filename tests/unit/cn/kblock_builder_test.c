@@ -8,11 +8,13 @@
 #include <hse/limits.h>
 
 #include <hse/error/merr.h>
+#include <hse/ikvdb/key_hash.h>
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/mclass_policy.h>
+#include <hse/ikvdb/omf_kmd.h>
 #include <hse/ikvdb/tuple.h>
 #include <hse/logging/logging.h>
 
@@ -25,7 +27,9 @@
 #include "cn/hblock_builder.h"
 #include "cn/kblock_builder.h"
 #include "cn/kblock_reader.h"
+#include "cn/kvs_mblk_desc.h"
 #include "cn/omf.h"
+#include "cn/wbt_reader.h"
 
 const struct kvs_rparams mocked_rp_default = {
     .cn_bloom_create = 1,
@@ -158,6 +162,7 @@ test_setup(struct mtf_test_info *lcl_ti)
     mapi_inject(mapi_idx_cn_get_cnid, 1001);
     mapi_inject(mapi_idx_cn_get_mpool, 0);
     mapi_inject(mapi_idx_cn_get_flags, 0);
+    mapi_inject(mapi_idx_cn_get_io_wq, 0);
 
     mapi_inject(mapi_idx_delete_mblock, 0);
     mapi_inject(mapi_idx_delete_mblocks, 0);
@@ -568,4 +573,80 @@ MTF_DEFINE_UTEST_PRE(test, t_hash_set, test_setup)
     kbb_destroy(kbb);
 }
 
+MTF_DEFINE_UTEST_PRE(test, t_hash_index, test_setup)
+{
+    struct key_stats stats = { .nvals = 1 };
+    struct kvs_mblk_desc kbd = { 0 };
+    struct kblock_builder *kbb = 0;
+    struct kblock_hix_desc hix;
+    struct blk_list blks;
+    struct wbt_desc wbd;
+    const uint nkeys = 20000;
+    uint8_t kmd[16];
+    char key[32];
+    size_t wlen;
+    merr_t err;
+
+    mocked_cp.hash_index = true;
+
+    err = kbb_create(KBB_CREATE_ARGS);
+    ASSERT_EQ(0, err);
+
+    for (uint i = 0; i < nkeys; i++) {
+        struct key_obj ko;
+        size_t off = 0;
+
+        kmd_add_zval(kmd, &off, i);
+        snprintf(key, sizeof(key), "key%08u", i * 2);
+        key2kobj(&ko, key, strlen(key));
+
+        err = kbb_add_entry(kbb, &ko, kmd, off, &stats);
+        ASSERT_EQ(0, err);
+    }
+
+    err = kbb_finish(kbb, &blks);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(1, blks.idc);
+
+    kbd.mbid = blks.idv[0];
+    err = mpm_mblock_get_base(kbd.mbid, &kbd.map_base, &wlen);
+    ASSERT_EQ(0, err);
+    kbd.wlen_pages = wlen / PAGE_SIZE;
+
+    err = kbr_read_wbt_region_desc(&kbd, &wbd);
+    ASSERT_EQ(0, err);
+
+    err = kbr_read_hix_region_desc(&kbd, &hix);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(kblock_hix_nbkts(nkeys), hix.hix_nbkts);
+    ASSERT_GT(wbd.wbd_leaf_cnt, 1);
+
+    /* Even keys are present, odd keys are not.
+     */
+    for (uint i = 0; i < 2 * nkeys; i++) {
+        struct kvs_vtuple_ref vref;
+        enum key_lookup_res res;
+        struct kvs_ktuple kt;
+
+        snprintf(key, sizeof(key), "key%08u", i);
+        kvs_ktuple_init(&kt, key, strlen(key));
+
+        kbr_hix_read_vref(
+            kbd.map_base, &hix, &wbd, &kt, key_hash64(key, kt.kt_len), UINT64_MAX, &res, NULL,
+            &vref);
+
+        if (i % 2) {
+            ASSERT_EQ(NOT_FOUND, res);
+            continue;
+        }
+
+        ASSERT_EQ(FOUND_VAL, res);
+        ASSERT_EQ(VTYPE_ZVAL, vref.vr_type);
+        ASSERT_EQ(i / 2, vref.vr_seq);
+    }
+
+    blk_list_free(&blks);
+    kbb_destroy(kbb);
+}
+
 MTF_END_UTEST_COLLECTION(test)
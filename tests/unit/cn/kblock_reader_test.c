@@ -7,6 +7,7 @@
 
 #include <hse/logging/logging.h>
 #include <hse/util/bloom_filter.h>
+#include <hse/util/fuse_filter.h>
 #include <hse/util/page.h>
 
 #include <hse/test/mtf/framework.h>
@@ -137,7 +138,7 @@ init_kblock(struct kblock_hdr_omf *kbh)
     omf_set_bh_version(bh, BLOOM_OMF_VERSION);
     omf_set_bh_bitmapsz(bh, 128);
     omf_set_bh_modulus(bh, 11);
-    omf_set_bh_bktshift(bh, 8);
+    omf_set_bh_bktshift(bh, BF_SB_BKTSHIFT);
     omf_set_bh_rotl(bh, 8);
     omf_set_bh_n_hashes(bh, 4);
 }
@@ -188,6 +189,42 @@ MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_wbt_region_desc, pre)
     ASSERT_EQ(wbt.wbd_n_pages, kbhro.kbh_wbt_dlen_pg);
 }
 
+MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_hix_region_desc, pre)
+{
+    struct kblock_hix_desc hix;
+    merr_t err;
+
+    /* No hash index.
+     */
+    err = kbr_read_hix_region_desc(&mblk, &hix);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(0, hix.hix_nbkts);
+    ASSERT_EQ(NULL, hix.hix_bktv);
+
+    omf_set_kbh_hix_doff_pg((void *)kblock, FAKE_BLOOM_DOFF_PG);
+    omf_set_kbh_hix_nbkts((void *)kblock, 2 * PAGE_SIZE / KBLOCK_HIX_BKT_SIZE);
+
+    err = kbr_read_hix_region_desc(&mblk, &hix);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(2 * PAGE_SIZE / KBLOCK_HIX_BKT_SIZE, hix.hix_nbkts);
+    ASSERT_EQ((void *)kblock + FAKE_BLOOM_DOFF_PG * PAGE_SIZE, (void *)hix.hix_bktv);
+
+    /* Index extends past the end of the kblock.
+     */
+    omf_set_kbh_hix_nbkts((void *)kblock, 4 * PAGE_SIZE / KBLOCK_HIX_BKT_SIZE);
+
+    err = kbr_read_hix_region_desc(&mblk, &hix);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    /* Version 6 kblocks have no hash index.
+     */
+    omf_set_kbh_version((void *)kblock, KBLOCK_HDR_VERSION6);
+
+    err = kbr_read_hix_region_desc(&mblk, &hix);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(0, hix.hix_nbkts);
+}
+
 MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_blm_region_desc, pre)
 {
     merr_t err;
@@ -200,6 +237,62 @@ MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_blm_region_desc, pre)
     ASSERT_EQ(blm.bd_bitmap, mblk.map_base + PAGE_SIZE * blm.bd_first_page);
 }
 
+MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_blm_region_desc_fuse, pre)
+{
+    struct bloom_hdr_omf *bh = (void *)kblock + BLM_HOFF;
+    struct bloom_desc blm;
+    merr_t err;
+
+    omf_set_bh_type(bh, BLOOM_OMF_TYPE_FUSE);
+    omf_set_bh_bitmapsz(bh, 8192);
+    omf_set_bh_modulus(bh, 8192 - 2 * 1024);
+    omf_set_bh_bktshift(bh, 10);
+    omf_set_bh_rotl(bh, FF_FPBITS_MIN);
+    omf_set_bh_n_hashes(bh, FF_ARITY);
+    omf_set_bh_seed(bh, 0x1234567890abcdefull);
+
+    err = kbr_read_blm_region_desc(&mblk, &blm);
+    ASSERT_EQ(0, err);
+    ASSERT_TRUE(blm.bd_fuse);
+    ASSERT_FALSE(blm.bd_split);
+    ASSERT_EQ(FF_FPBITS_MIN, blm.bd_ff_fpbits);
+    ASSERT_EQ(10, blm.bd_ff_seglen_shift);
+    ASSERT_EQ(8192 - 2 * 1024, blm.bd_ff_seg_count_len);
+    ASSERT_EQ(0x1234567890abcdefull, blm.bd_ff_seed);
+
+    /* The bloom fields of a fuse filter descriptor are left zero.
+     */
+    ASSERT_EQ(0, blm.bd_modulus);
+    ASSERT_EQ(0, blm.bd_bktshift);
+    ASSERT_EQ(0, blm.bd_rotl);
+    ASSERT_EQ(0, blm.bd_n_hashes);
+    ASSERT_EQ(blm.bd_bitmap, mblk.map_base + PAGE_SIZE * blm.bd_first_page);
+
+    /* A fingerprint array larger than the bloom region is rejected.
+     */
+    omf_set_bh_rotl(bh, FF_FPBITS_MAX);
+
+    err = kbr_read_blm_region_desc(&mblk, &blm);
+    ASSERT_EQ(0, err);
+    ASSERT_FALSE(blm.bd_fuse);
+    ASSERT_EQ(NULL, blm.bd_bitmap);
+
+    /* As is an unsupported fingerprint width.
+     */
+    omf_set_bh_modulus(bh, 1024);
+    omf_set_bh_rotl(bh, FF_FPBITS_MID - 2);
+
+    err = kbr_read_blm_region_desc(&mblk, &blm);
+    ASSERT_EQ(0, err);
+    ASSERT_FALSE(blm.bd_fuse);
+
+    omf_set_bh_rotl(bh, FF_FPBITS_MID);
+
+    err = kbr_read_blm_region_desc(&mblk, &blm);
+    ASSERT_EQ(0, err);
+    ASSERT_TRUE(blm.bd_fuse);
+}
+
 MTF_DEFINE_UTEST_PRE(kblock_reader, t_kbr_read_metrics, pre)
 {
     merr_t err;
@@ -78,6 +78,7 @@ init_work(
 {
     w->cw_mp = ds;
     w->cw_rp = rp;
+    rp->cn_compact_slices = 1; /* mocked input iterators have no kblocks to slice */
     w->cw_kvset_cnt = kvset_cnt;
     w->cw_inputv = inputv;
     w->cw_cancel_request = cancel;
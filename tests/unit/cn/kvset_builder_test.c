@@ -45,6 +45,7 @@ pre(struct mtf_test_info *mtf)
     mapi_inject(mapi_idx_cn_get_cnid, TEST_DEF_UTAG);
     mapi_inject(mapi_idx_cn_get_mpool, 0);
     mapi_inject(mapi_idx_cn_get_flags, 0);
+    mapi_inject(mapi_idx_cn_get_io_wq, 0);
 
     mapi_inject(mapi_idx_delete_mblock, 0);
     mapi_inject(mapi_idx_delete_mblocks, 0);
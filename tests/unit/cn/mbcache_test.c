@@ -0,0 +1,511 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/hse_gparams.h>
+#include <hse/mpool/mpool.h>
+#include <hse/mpool/mpool_structs.h>
+#include <hse/util/page.h>
+
+#include <hse/test/mtf/framework.h>
+#include <hse/test/mock/api.h>
+
+#include "cn/kvs_mblk_desc.h"
+#include "cn/mbcache.h"
+
+#define ds ((struct mpool *)1)
+
+/* All the test mblocks map to the same shard.
+ */
+#define MBID_DIRECTIO  1024
+#define MBID_PAGECACHE 2048
+#define MBID(_i)       (MBID_DIRECTIO + 16 * (_i))
+
+#define mock_wlen_pages 16
+#define mock_alen_pages 32
+
+/* Pages mapped "from media" read as MEDIA, pages read into the cache as
+ * CACHED, such that the tests can tell which is mapped.
+ */
+#define MEDIA  'm'
+#define CACHED 'c'
+
+#define NMAPS 4
+
+static struct {
+    uint64_t mbid;
+    void *base;
+    uint refcnt;
+} mapv[NMAPS];
+
+static int mocked_read_errno;
+static uint mocked_reads;
+static uint mocked_restores;
+static int mocked_restore_errno;
+
+static merr_t
+mocked_mblock_props_get(struct mpool *mp, uint64_t mbid, struct mblock_props *props)
+{
+    memset(props, 0, sizeof(*props));
+    props->mpr_objid = mbid;
+    props->mpr_alloc_cap = mock_alen_pages * PAGE_SIZE;
+    props->mpr_write_len = mock_wlen_pages * PAGE_SIZE;
+    props->mpr_mclass = HSE_MCLASS_CAPACITY;
+    props->mpr_directio = (mbid < MBID_PAGECACHE);
+
+    return 0;
+}
+
+static merr_t
+mocked_mblock_read(struct mpool *mp, uint64_t mbid, const struct iovec *iov, int iovc, off_t off)
+{
+    if (mocked_read_errno)
+        return merr(mocked_read_errno);
+
+    mocked_reads++;
+
+    for (int i = 0; i < iovc; i++)
+        memset(iov[i].iov_base, CACHED, iov[i].iov_len);
+
+    return 0;
+}
+
+static void *
+media_map(void *addr, size_t len)
+{
+    void *base;
+
+    base = mmap(
+        addr, len, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | (addr ? MAP_FIXED : 0), -1, 0);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    memset(base, MEDIA, len);
+    mprotect(base, len, PROT_READ);
+
+    return base;
+}
+
+/* Like mpool, map all mappings of an mblock to the same address.
+ */
+static merr_t
+mocked_mblk_mmap(struct mpool *mp, uint64_t mbid, struct kvs_mblk_desc *md)
+{
+    int i, slot = -1;
+
+    for (i = 0; i < NMAPS; i++) {
+        if (mapv[i].refcnt && mapv[i].mbid == mbid)
+            break;
+        if (!mapv[i].refcnt && slot < 0)
+            slot = i;
+    }
+
+    if (i == NMAPS) {
+        if (slot < 0)
+            return merr(ENOMEM);
+
+        i = slot;
+        mapv[i].base = media_map(NULL, mock_wlen_pages * PAGE_SIZE);
+        if (!mapv[i].base)
+            return merr(ENOMEM);
+        mapv[i].mbid = mbid;
+    }
+
+    mapv[i].refcnt++;
+
+    memset(md, 0, sizeof(*md));
+    md->map_base = mapv[i].base;
+    md->mbid = mbid;
+    md->alen_pages = mock_alen_pages;
+    md->wlen_pages = mock_wlen_pages;
+
+    return 0;
+}
+
+static merr_t
+mocked_mblk_munmap(struct mpool *mp, struct kvs_mblk_desc *md)
+{
+    for (int i = 0; i < NMAPS; i++) {
+        if (mapv[i].refcnt && mapv[i].base == md->map_base) {
+            if (--mapv[i].refcnt == 0)
+                munmap(mapv[i].base, mock_wlen_pages * PAGE_SIZE);
+            break;
+        }
+    }
+
+    md->map_base = NULL;
+    return 0;
+}
+
+static merr_t
+mocked_mblock_mmap_restore(struct mpool *mp, uint64_t mbid, size_t off, size_t len)
+{
+    if (mocked_restore_errno)
+        return merr(mocked_restore_errno);
+
+    for (int i = 0; i < NMAPS; i++) {
+        if (mapv[i].refcnt && mapv[i].mbid == mbid) {
+            mocked_restores++;
+            return media_map(mapv[i].base + off, len) ? 0 : merr(ENOMEM);
+        }
+    }
+
+    return merr(EINVAL);
+}
+
+static int
+pre(struct mtf_test_info *mtf)
+{
+    MOCK_SET_FN(mpool, mpool_mblock_props_get, mocked_mblock_props_get);
+    MOCK_SET_FN(mpool, mpool_mblock_read, mocked_mblock_read);
+    MOCK_SET_FN(mpool, mpool_mblock_mmap_restore, mocked_mblock_mmap_restore);
+    MOCK_SET_FN(mblk_desc, mblk_mmap, mocked_mblk_mmap);
+    MOCK_SET_FN(mblk_desc, mblk_munmap, mocked_mblk_munmap);
+
+    memset(mapv, 0, sizeof(mapv));
+    mocked_read_errno = 0;
+    mocked_reads = 0;
+    mocked_restores = 0;
+    mocked_restore_errno = 0;
+
+    /* Four pages per shard.
+     */
+    hse_gparams.gp_cn_mbcache_sz = 16 * 4 * PAGE_SIZE;
+
+    return merr_errno(mbcache_init());
+}
+
+static int
+post(struct mtf_test_info *mtf)
+{
+    mbcache_fini();
+    hse_gparams.gp_cn_mbcache_sz = 0;
+
+    return 0;
+}
+
+static bool
+pages_are(const struct kvs_mblk_desc *md, uint pg, uint pgc, char c)
+{
+    const char *p = md->map_base + pg * PAGE_SIZE;
+
+    for (size_t i = 0; i < pgc * PAGE_SIZE; i++) {
+        if (p[i] != c)
+            return false;
+    }
+
+    return true;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(mbcache_test);
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, fill_on_touch, pre, post)
+{
+    struct kvs_mblk_desc md;
+    struct mbcache_map *map;
+    merr_t err;
+    bool hit;
+
+    err = mbcache_mmap(ds, MBID(0), &md, &map);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_NE(NULL, map);
+    ASSERT_EQ(1, md.cached);
+
+    mbcache_extent_set(map, MBC_EXT_FILTER, 1, 1);
+    mbcache_extent_set(map, MBC_EXT_WBT_LEAF, 2, 2);
+    mbcache_extent_set(map, MBC_EXT_KMD, 4, 8);
+
+    /* Nothing is read at open.
+     */
+    mbcache_sync();
+    ASSERT_EQ(0, mocked_reads);
+
+    hit = mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER));
+    ASSERT_FALSE(hit);
+
+    mbcache_sync();
+    ASSERT_EQ(1, mocked_reads);
+    ASSERT_TRUE(pages_are(&md, 0, 1, MEDIA));
+    ASSERT_TRUE(pages_are(&md, 1, 1, CACHED));
+    ASSERT_TRUE(pages_are(&md, 2, 14, MEDIA));
+
+    hit = mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER));
+    ASSERT_TRUE(hit);
+
+    /* A lookup hits only if all the extents it reads are resident.
+     */
+    hit = mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER) | MBC_EXT_MASK(MBC_EXT_WBT_LEAF));
+    ASSERT_FALSE(hit);
+
+    mbcache_sync();
+    ASSERT_EQ(2, mocked_reads);
+    ASSERT_TRUE(pages_are(&md, 1, 3, CACHED));
+
+    hit = mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER) | MBC_EXT_MASK(MBC_EXT_WBT_LEAF));
+    ASSERT_TRUE(hit);
+
+    /* The key metadata exceeds the shard budget and is never filled.
+     */
+    hit = mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_KMD));
+    ASSERT_FALSE(hit);
+    mbcache_sync();
+    ASSERT_EQ(2, mocked_reads);
+
+    /* madvise is a no-op on cached mblocks.
+     */
+    err = mblk_madvise_pages(&md, 0, mock_wlen_pages, MADV_DONTNEED);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_TRUE(pages_are(&md, 1, 3, CACHED));
+
+    err = mbcache_munmap(ds, &md, map);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(2, mocked_restores);
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, shared_map, pre, post)
+{
+    struct kvs_mblk_desc md[2];
+    struct mbcache_map *map[2];
+    merr_t err;
+
+    for (int i = 0; i < 2; i++) {
+        err = mbcache_mmap(ds, MBID(0), &md[i], &map[i]);
+        ASSERT_EQ(0, merr_errno(err));
+        mbcache_extent_set(map[i], MBC_EXT_WBT_INT, 3, 2);
+    }
+
+    /* A second mapping of the same mblock (e.g., a kblock retained by a
+     * split) shares the cache map.
+     */
+    ASSERT_EQ(map[0], map[1]);
+    ASSERT_EQ(md[0].map_base, md[1].map_base);
+
+    mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_WBT_INT));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md[0], 3, 2, CACHED));
+
+    err = mbcache_munmap(ds, &md[0], map[0]);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(0, mocked_restores);
+    ASSERT_TRUE(pages_are(&md[1], 3, 2, CACHED));
+    ASSERT_TRUE(mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_WBT_INT)));
+
+    /* The last unmap puts the pages from media back before the mblock
+     * itself is unmapped.
+     */
+    ASSERT_EQ(1, mapv[0].refcnt);
+    err = mbcache_munmap(ds, &md[1], map[1]);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(1, mocked_restores);
+    ASSERT_EQ(0, mapv[0].refcnt);
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, clock_eviction, pre, post)
+{
+    struct kvs_mblk_desc md[3];
+    struct mbcache_map *map[3];
+    merr_t err;
+
+    for (int i = 0; i < 3; i++) {
+        err = mbcache_mmap(ds, MBID(i), &md[i], &map[i]);
+        ASSERT_EQ(0, merr_errno(err));
+        ASSERT_NE(NULL, map[i]);
+
+        mbcache_extent_set(map[i], MBC_EXT_FILTER, 0, 2);
+        mbcache_extent_set(map[i], MBC_EXT_WBT_LEAF, 2, 2);
+    }
+
+    /* Fill the shard with a filter of mblock 0 and leaves of mblock 1.
+     */
+    mbcache_touch(map[0], MBC_EXT_MASK(MBC_EXT_FILTER));
+    mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_WBT_LEAF));
+    mbcache_sync();
+    ASSERT_EQ(2, mocked_reads);
+    ASSERT_TRUE(pages_are(&md[0], 0, 2, CACHED));
+    ASSERT_TRUE(pages_are(&md[1], 2, 2, CACHED));
+
+    /* Leaves weigh less than filters, so the hand evicts them first.
+     */
+    mbcache_touch(map[2], MBC_EXT_MASK(MBC_EXT_WBT_LEAF));
+    mbcache_sync();
+    ASSERT_EQ(3, mocked_reads);
+    ASSERT_EQ(1, mocked_restores);
+    ASSERT_TRUE(pages_are(&md[0], 0, 2, CACHED));
+    ASSERT_TRUE(pages_are(&md[1], 2, 2, MEDIA));
+    ASSERT_TRUE(pages_are(&md[2], 2, 2, CACHED));
+
+    ASSERT_TRUE(mbcache_touch(map[0], MBC_EXT_MASK(MBC_EXT_FILTER)));
+    ASSERT_FALSE(mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_WBT_LEAF)));
+    mbcache_sync();
+
+    /* Refilling mblock 1's leaves evicts mblock 2's, as the filter was
+     * touched again in the meantime.
+     */
+    ASSERT_EQ(4, mocked_reads);
+    ASSERT_TRUE(pages_are(&md[0], 0, 2, CACHED));
+    ASSERT_TRUE(pages_are(&md[1], 2, 2, CACHED));
+    ASSERT_TRUE(pages_are(&md[2], 2, 2, MEDIA));
+
+    for (int i = 0; i < 3; i++) {
+        err = mbcache_munmap(ds, &md[i], map[i]);
+        ASSERT_EQ(0, merr_errno(err));
+    }
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, page_cache_mclass, pre, post)
+{
+    struct kvs_mblk_desc md;
+    struct mbcache_map *map;
+    merr_t err;
+
+    err = mbcache_mmap(ds, MBID_PAGECACHE, &md, &map);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(NULL, map);
+    ASSERT_EQ(0, md.cached);
+
+    mbcache_extent_set(map, MBC_EXT_FILTER, 0, 1);
+    ASSERT_FALSE(mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER)));
+    mbcache_sync();
+    ASSERT_EQ(0, mocked_reads);
+
+    err = mbcache_munmap(ds, &md, map);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(0, mapv[0].refcnt);
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, disabled, pre, post)
+{
+    struct kvs_mblk_desc md;
+    struct mbcache_map *map;
+    merr_t err;
+
+    mbcache_fini();
+    hse_gparams.gp_cn_mbcache_sz = 0;
+    err = mbcache_init();
+    ASSERT_EQ(0, merr_errno(err));
+
+    err = mbcache_mmap(ds, MBID(0), &md, &map);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(NULL, map);
+    ASSERT_EQ(0, md.cached);
+
+    err = mbcache_munmap(ds, &md, map);
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, read_error, pre, post)
+{
+    struct kvs_mblk_desc md;
+    struct mbcache_map *map;
+    merr_t err;
+
+    err = mbcache_mmap(ds, MBID(0), &md, &map);
+    ASSERT_EQ(0, merr_errno(err));
+    mbcache_extent_set(map, MBC_EXT_HIX, 4, 4);
+
+    mocked_read_errno = EIO;
+    mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_HIX));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md, 4, 4, MEDIA));
+
+    /* A failed fill must not leak its share of the budget, nor keep the
+     * extent from being filled by a later lookup.
+     */
+    mocked_read_errno = 0;
+    ASSERT_FALSE(mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_HIX)));
+    mbcache_sync();
+    ASSERT_EQ(1, mocked_reads);
+    ASSERT_TRUE(pages_are(&md, 4, 4, CACHED));
+    ASSERT_TRUE(mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_HIX)));
+
+    err = mbcache_munmap(ds, &md, map);
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, unmap_while_filling, pre, post)
+{
+    struct kvs_mblk_desc md;
+    struct mbcache_map *map;
+    merr_t err;
+
+    for (int i = 0; i < 8; i++) {
+        err = mbcache_mmap(ds, MBID(0), &md, &map);
+        ASSERT_EQ(0, merr_errno(err));
+        mbcache_extent_set(map, MBC_EXT_FILTER, 0, 4);
+
+        /* The fill either completes first and is undone by the unmap,
+         * or finds the map dead and discards its copy.
+         */
+        mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER));
+
+        err = mbcache_munmap(ds, &md, map);
+        ASSERT_EQ(0, merr_errno(err));
+        ASSERT_EQ(0, mapv[0].refcnt);
+    }
+
+    mbcache_sync();
+
+    /* The budget is intact.
+     */
+    err = mbcache_mmap(ds, MBID(1), &md, &map);
+    ASSERT_EQ(0, merr_errno(err));
+    mbcache_extent_set(map, MBC_EXT_FILTER, 0, 4);
+    mbcache_touch(map, MBC_EXT_MASK(MBC_EXT_FILTER));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md, 0, 4, CACHED));
+
+    err = mbcache_munmap(ds, &md, map);
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(mbcache_test, restore_error, pre, post)
+{
+    struct kvs_mblk_desc md[2];
+    struct mbcache_map *map[2];
+    merr_t err;
+
+    for (int i = 0; i < 2; i++) {
+        err = mbcache_mmap(ds, MBID(i), &md[i], &map[i]);
+        ASSERT_EQ(0, merr_errno(err));
+        mbcache_extent_set(map[i], MBC_EXT_FILTER, 0, 4);
+    }
+
+    mbcache_touch(map[0], MBC_EXT_MASK(MBC_EXT_FILTER));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md[0], 0, 4, CACHED));
+
+    /* While the mblock is mapped, an extent that cannot be evicted keeps
+     * its copy and its share of the budget.
+     */
+    mocked_restore_errno = ENOMEM;
+    ASSERT_FALSE(mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_FILTER)));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md[0], 0, 4, CACHED));
+    ASSERT_TRUE(pages_are(&md[1], 0, 4, MEDIA));
+    ASSERT_TRUE(mbcache_touch(map[0], MBC_EXT_MASK(MBC_EXT_FILTER)));
+
+    /* The last unmap fails, but releases the extent regardless.
+     */
+    err = mbcache_munmap(ds, &md[0], map[0]);
+    ASSERT_EQ(ENOMEM, merr_errno(err));
+    ASSERT_EQ(0, mapv[0].refcnt);
+
+    mocked_restore_errno = 0;
+    ASSERT_FALSE(mbcache_touch(map[1], MBC_EXT_MASK(MBC_EXT_FILTER)));
+    mbcache_sync();
+    ASSERT_TRUE(pages_are(&md[1], 0, 4, CACHED));
+
+    err = mbcache_munmap(ds, &md[1], map[1]);
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_END_UTEST_COLLECTION(mbcache_test)
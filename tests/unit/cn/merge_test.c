@@ -841,6 +841,7 @@ init_work(
     w->cw_mp = ds;
     w->cw_tree = tree;
     w->cw_rp = rp;
+    rp->cn_compact_slices = 1; /* mocked input iterators have no kblocks to slice */
     w->cw_cp = tree ? cn_tree_get_cparams(tree) : 0;
     w->cw_pfx_len = pfx_len;
     w->cw_horizon = horizon;
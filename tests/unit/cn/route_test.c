@@ -161,4 +161,139 @@ MTF_DEFINE_UTEST(route_test, route_api_test)
     route_map_destroy(map);
 }
 
+/* Reference lookup by a linear walk of the route map.
+ */
+static struct route_node *
+route_map_lookup_ref(struct route_map *map, const void *key, uint keylen, bool gt)
+{
+    struct route_node *rn = route_map_first_node(map);
+
+    while (rn) {
+        int rc = route_node_keycmp(key, keylen, rn);
+
+        if (rc < 0 || (rc == 0 && !gt))
+            return rn;
+
+        if (!route_node_next(rn))
+            return (rc == 0) ? NULL : rn;
+
+        rn = route_node_next(rn);
+    }
+
+    return NULL;
+}
+
+static uint
+route_key_gen(uint64_t *state, uint8_t *kbuf, uint pfxlen)
+{
+    static const uint8_t alphabet[] = { 0x00, 0x01, 0x41, 0x7f, 0x80, 0xff };
+    uint klen;
+
+    *state = *state * 6364136223846793005ul + 1442695040888963407ul;
+    klen = pfxlen + (*state >> 33) % 12;
+
+    memset(kbuf, 'p', pfxlen);
+    for (uint i = pfxlen; i < klen; i++) {
+        *state = *state * 6364136223846793005ul + 1442695040888963407ul;
+        kbuf[i] = alphabet[(*state >> 33) % NELEM(alphabet)];
+    }
+
+    return klen;
+}
+
+static int
+route_index_verify(struct mtf_test_info *lcl_ti, struct route_map *map, uint64_t seed)
+{
+    struct route_node *rn, *ref;
+    uint8_t kbuf[64];
+    uint klen;
+
+    /* Probe each edge key, its neighbors, and a bunch of random keys.
+     */
+    for (rn = route_map_first_node(map); rn; rn = route_node_next(rn)) {
+        route_node_keycpy(rn, kbuf, sizeof(kbuf), &klen);
+
+        ASSERT_EQ_RET(rn, route_map_lookup(map, kbuf, klen), -1);
+        ref = route_map_lookup_ref(map, kbuf, klen, true);
+        ASSERT_EQ_RET(ref, route_map_lookupGT(map, kbuf, klen), -1);
+
+        kbuf[klen] = 0;
+        ref = route_map_lookup_ref(map, kbuf, klen + 1, false);
+        ASSERT_EQ_RET(ref, route_map_lookup(map, kbuf, klen + 1), -1);
+
+        if (klen > 0) {
+            ref = route_map_lookup_ref(map, kbuf, klen - 1, false);
+            ASSERT_EQ_RET(ref, route_map_lookup(map, kbuf, klen - 1), -1);
+
+            ref = route_map_lookup_ref(map, kbuf, klen - 1, true);
+            ASSERT_EQ_RET(ref, route_map_lookupGT(map, kbuf, klen - 1), -1);
+        }
+    }
+
+    for (uint i = 0; i < 10000; i++) {
+        klen = route_key_gen(&seed, kbuf, (i % 3) * 4);
+
+        ref = route_map_lookup_ref(map, kbuf, klen, false);
+        ASSERT_EQ_RET(ref, route_map_lookup(map, kbuf, klen), -1);
+
+        ref = route_map_lookup_ref(map, kbuf, klen, true);
+        ASSERT_EQ_RET(ref, route_map_lookupGT(map, kbuf, klen), -1);
+    }
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST(route_test, route_index_test)
+{
+    struct cn_tree_node tn;
+    struct route_node *rnodev[CN_FANOUT_MAX], *rn;
+    struct route_map *map;
+    uint64_t seed = 42;
+    uint8_t kbuf[64];
+    uint klen, nodec = 0;
+    merr_t err;
+
+    map = route_map_create(NELEM(rnodev));
+    ASSERT_NE(NULL, map);
+
+    /* Edge keys share an eight byte prefix, which the index must skip.
+     */
+    for (uint i = 0; i < NELEM(rnodev); i++) {
+        klen = route_key_gen(&seed, kbuf, 8);
+
+        rn = route_map_insert(map, &tn, kbuf, klen);
+        if (rn)
+            rnodev[nodec++] = rn;
+    }
+
+    ASSERT_GT(nodec, NELEM(rnodev) / 2);
+    ASSERT_EQ(0, route_index_verify(lcl_ti, map, 1));
+
+    /* Mutations must discard the index.
+     */
+    for (uint i = 0; i < nodec; i += 3) {
+        route_map_delete(map, rnodev[i]);
+        rnodev[i] = NULL;
+    }
+
+    ASSERT_EQ(0, route_index_verify(lcl_ti, map, 2));
+
+    /* Shortening the first edge key shortens the common prefix.
+     */
+    memset(kbuf, 'p', 7);
+    err = route_node_key_modify(map, route_map_first_node(map), kbuf, 7);
+    ASSERT_EQ(0, err);
+
+    ASSERT_EQ(0, route_index_verify(lcl_ti, map, 3));
+
+    for (uint i = 0; i < nodec; i++) {
+        if (rnodev[i])
+            route_map_delete(map, rnodev[i]);
+    }
+
+    ASSERT_EQ(NULL, route_map_lookup(map, kbuf, 7));
+
+    route_map_destroy(map);
+}
+
 MTF_END_UTEST_COLLECTION(route_test);
@@ -74,6 +74,7 @@ test_setup(struct mtf_test_info *lcl_ti)
     mapi_inject(mapi_idx_cn_get_cnid, 1001);
     mapi_inject(mapi_idx_cn_get_mpool, 0);
     mapi_inject(mapi_idx_cn_get_flags, 0);
+    mapi_inject(mapi_idx_cn_get_io_wq, 0);
 
     mapi_inject(mapi_idx_delete_mblock, 0);
     mapi_inject(mapi_idx_delete_mblocks, 0);
@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/atomic.h>
+#include <hse/util/workqueue.h>
+
+#include <hse/test/mtf/framework.h>
+
+#include "cn/cn_metrics.h"
+#include "cn/wbehind.h"
+
+#define NREQS 64
+
+struct test_req {
+    struct wbehind_req tr_req;
+    uint tr_seq;
+};
+
+static struct test_req reqv[NREQS];
+static uint donev[NREQS];
+static uint donec;
+static int fail_seq;
+static atomic_int active;
+static atomic_int overlap;
+static struct workqueue_struct *wq;
+
+static merr_t
+test_write(struct wbehind_req *req)
+{
+    struct test_req *tr = container_of(req, struct test_req, tr_req);
+
+    if (atomic_inc_return(&active) > 1)
+        atomic_inc(&overlap);
+
+    /* Give a second write every chance to overlap this one.
+     */
+    if (tr->tr_seq % 8 == 0)
+        usleep(1000);
+
+    donev[donec++] = tr->tr_seq;
+    count_ops(&req->wr_stats, 1, 4096, 1);
+
+    atomic_dec(&active);
+
+    return (int)tr->tr_seq == fail_seq ? merr(EIO) : 0;
+}
+
+static int
+pre(struct mtf_test_info *info)
+{
+    memset(reqv, 0, sizeof(reqv));
+
+    for (uint i = 0; i < NREQS; i++)
+        reqv[i].tr_seq = i;
+
+    donec = 0;
+    fail_seq = -1;
+    atomic_set(&active, 0);
+    atomic_set(&overlap, 0);
+
+    wq = alloc_workqueue("wbehind_test", 0, 1, 4);
+
+    return wq ? 0 : ENOMEM;
+}
+
+static int
+post(struct mtf_test_info *info)
+{
+    destroy_workqueue(wq);
+
+    return 0;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(wbehind_test);
+
+MTF_DEFINE_UTEST_PREPOST(wbehind_test, ordering, pre, post)
+{
+    struct cn_merge_stats_ops stats = { 0 };
+    struct wbehind wb;
+    merr_t err;
+
+    wbehind_init(&wb, wq);
+
+    for (uint i = 0; i < NREQS; i++) {
+        err = wbehind_submit(&wb, &reqv[i].tr_req, test_write);
+        ASSERT_EQ(0, err);
+
+        /* Keep at most four requests in flight, like a builder would.
+         */
+        if (i >= 3) {
+            err = wbehind_wait(&wb, &reqv[i - 3].tr_req);
+            ASSERT_EQ(0, err);
+            ASSERT_FALSE(reqv[i - 3].tr_req.wr_busy);
+        }
+    }
+
+    err = wbehind_drain(&wb);
+    ASSERT_EQ(0, err);
+
+    wbehind_stats_get(&wb, &stats);
+    wbehind_fini(&wb);
+
+    ASSERT_EQ(NREQS, donec);
+    for (uint i = 0; i < NREQS; i++)
+        ASSERT_EQ(i, donev[i]);
+
+    ASSERT_EQ(0, atomic_read(&overlap));
+    ASSERT_EQ(NREQS, stats.op_cnt);
+    ASSERT_EQ(NREQS * 4096, stats.op_size);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbehind_test, sticky_error, pre, post)
+{
+    struct cn_merge_stats_ops stats = { 0 };
+    struct wbehind wb;
+    merr_t err;
+    uint i;
+
+    fail_seq = 5;
+
+    wbehind_init(&wb, wq);
+
+    for (i = 0; i < NREQS / 2; i++) {
+        err = wbehind_submit(&wb, &reqv[i].tr_req, test_write);
+        if (err)
+            break;
+    }
+
+    /* Once the failed write completes no further requests are accepted.
+     */
+    err = wbehind_drain(&wb);
+    ASSERT_EQ(EIO, merr_errno(err));
+
+    err = wbehind_submit(&wb, &reqv[NREQS - 1].tr_req, test_write);
+    ASSERT_EQ(EIO, merr_errno(err));
+    ASSERT_FALSE(reqv[NREQS - 1].tr_req.wr_busy);
+
+    err = wbehind_wait(&wb, &reqv[0].tr_req);
+    ASSERT_EQ(EIO, merr_errno(err));
+
+    wbehind_stats_get(&wb, &stats);
+    wbehind_fini(&wb);
+
+    /* Writes queued behind the failed write are skipped.
+     */
+    ASSERT_EQ(fail_seq + 1, donec);
+    for (i = 0; i < donec; i++)
+        ASSERT_EQ(i, donev[i]);
+
+    ASSERT_EQ(donec, stats.op_cnt);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbehind_test, synchronous, pre, post)
+{
+    struct cn_merge_stats_ops stats = { 0 };
+    struct wbehind wb;
+    merr_t err;
+
+    fail_seq = 3;
+
+    wbehind_init(&wb, NULL);
+
+    for (uint i = 0; i < fail_seq; i++) {
+        err = wbehind_submit(&wb, &reqv[i].tr_req, test_write);
+        ASSERT_EQ(0, err);
+        ASSERT_EQ(i + 1, donec);
+    }
+
+    err = wbehind_submit(&wb, &reqv[fail_seq].tr_req, test_write);
+    ASSERT_EQ(EIO, merr_errno(err));
+
+    err = wbehind_submit(&wb, &reqv[fail_seq + 1].tr_req, test_write);
+    ASSERT_EQ(EIO, merr_errno(err));
+    ASSERT_EQ(fail_seq + 1, donec);
+
+    err = wbehind_drain(&wb);
+    ASSERT_EQ(EIO, merr_errno(err));
+
+    wbehind_stats_get(&wb, &stats);
+    wbehind_fini(&wb);
+
+    ASSERT_EQ(fail_seq + 1, stats.op_cnt);
+}
+
+MTF_END_UTEST_COLLECTION(wbehind_test)
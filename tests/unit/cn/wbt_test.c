@@ -435,7 +435,7 @@ MTF_DEFINE_UTEST_PREPOST(wbt_test, large_last_key, pre_test, post_test)
     size_t nkeys = 3000;
     size_t klen = 128;
     const uint lcp = 23;
-    const uint lfe_sz = sizeof(struct wbt_lfe_omf);
+    const uint lfe_sz = sizeof(struct wbt_lfe_omf) + sizeof(struct wbt_lfe_shared_omf);
     const uint hdr_sz = sizeof(struct wbt_node_hdr_omf);
     struct key_list *ql = &key_list; /* query list */
 
@@ -570,4 +570,101 @@ MTF_DEFINE_UTEST_PREPOST(wbt_test, skip_keys, pre_test, post_test)
     free(ql.buf);
 }
 
+MTF_DEFINE_UTEST_PREPOST(wbt_test, hint_ties, pre_test, post_test)
+{
+    int i, rc;
+    unsigned char buf[16];
+    size_t nkeys = 20 * 1000;
+    struct key_list ql = { 0 }; /* query list */
+
+    ql.bufsz = 2 * BUF_SIZE;
+    ql.buf = aligned_alloc(8, ql.bufsz);
+    ASSERT_NE(NULL, ql.buf);
+
+    /* Keys that differ only by trailing zeros have equal hints, as do
+     * keys shorter than a hint, hence must be ordered by keycmp().
+     */
+    for (i = 0; i < nkeys; i++) {
+        size_t klen = 2 + (i & 7);
+        bool added;
+
+        memset(buf, 0, sizeof(buf));
+        buf[0] = (i >> 3) >> 8;
+        buf[1] = (i >> 3) & 0xff;
+
+        added = add_key(&key_list, buf, klen);
+        ASSERT_TRUE(added);
+        added = ref_tree_insert(rtree, buf, klen, 0);
+        ASSERT_TRUE(added);
+
+        added = add_key(&ql, buf, klen);
+        ASSERT_TRUE(added);
+
+        /* Query for a key that is not in the tree. */
+        buf[klen] = 1;
+        added = add_key(&ql, buf, klen + 1);
+        ASSERT_TRUE(added);
+    }
+
+    rc = load_and_test(lcl_ti, &ql);
+    ASSERT_EQ(0, rc);
+
+    free(ql.buf);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, front_coding, pre_test, post_test)
+{
+    int i, rc;
+    unsigned char buf[128];
+    size_t nkeys = 20 * 1000;
+    struct key_list ql = { 0 }; /* query list */
+
+    ql.bufsz = 2 * BUF_SIZE;
+    ql.buf = aligned_alloc(8, ql.bufsz);
+    ASSERT_NE(NULL, ql.buf);
+
+    /* Keys of a group of 64 share a padded prefix whose length varies from
+     * group to group, such that the prefix shared with the restart keys of
+     * a leaf node varies in length, as do the keys themselves.
+     */
+    for (i = 0; i < nkeys; i++) {
+        size_t pad = (i / 64) % 50;
+        size_t tail = (i * 7) % 13;
+        size_t klen = 0;
+        bool added;
+
+        buf[klen++] = (i / 64) >> 8;
+        buf[klen++] = (i / 64) & 0xff;
+        memset(buf + klen, 'x', pad);
+        klen += pad;
+        buf[klen++] = i >> 8;
+        buf[klen++] = i & 0xff;
+        memset(buf + klen, 0xa5, tail);
+        klen += tail;
+
+        added = add_key(&key_list, buf, klen);
+        ASSERT_TRUE(added);
+        added = ref_tree_insert(rtree, buf, klen, 0);
+        ASSERT_TRUE(added);
+
+        added = add_key(&ql, buf, klen);
+        ASSERT_TRUE(added);
+
+        /* Query for keys that are not in the tree, one of which is a prefix
+         * of the keys of the group.
+         */
+        added = add_key(&ql, buf, 2 + pad);
+        ASSERT_TRUE(added);
+
+        buf[klen] = 0;
+        added = add_key(&ql, buf, klen + 1);
+        ASSERT_TRUE(added);
+    }
+
+    rc = load_and_test(lcl_ti, &ql);
+    ASSERT_EQ(0, rc);
+
+    free(ql.buf);
+}
+
 MTF_END_UTEST_COLLECTION(wbt_test)
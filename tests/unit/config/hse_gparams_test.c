@@ -152,6 +152,25 @@ MTF_DEFINE_UTEST_PRE(hse_gparams_test, vlb_cache_sz, test_pre)
     ASSERT_EQ(HSE_VLB_CACHESZ_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(hse_gparams_test, cn_mbcache_sz, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_mbcache_sz");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U64, ps->ps_type);
+    ASSERT_EQ(offsetof(struct hse_gparams, gp_cn_mbcache_sz), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint64_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(HSE_CN_MBCACHE_SZ_DFLT, params.gp_cn_mbcache_sz);
+    ASSERT_EQ(HSE_CN_MBCACHE_SZ_MIN, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(HSE_CN_MBCACHE_SZ_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(hse_gparams_test, workqueue_tcdelay, test_pre)
 {
     const struct param_spec *ps = ps_get("workqueue_tcdelay");
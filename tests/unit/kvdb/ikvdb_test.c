@@ -318,9 +318,9 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, basic_lifecycle, test_pre, test_post)
     ASSERT_NE(NULL, txn1);
     ASSERT_NE(NULL, txn2);
 
-    err = ikvdb_txn_begin(store, txn1);
+    err = ikvdb_txn_begin(store, 0, txn1);
     ASSERT_EQ(0, err);
-    err = ikvdb_txn_begin(store, txn2);
+    err = ikvdb_txn_begin(store, 0, txn2);
     ASSERT_EQ(0, err);
     ASSERT_EQ(KVDB_CTXN_ACTIVE, ikvdb_txn_state(store, txn1));
     ASSERT_EQ(KVDB_CTXN_ACTIVE, ikvdb_txn_state(store, txn2));
@@ -332,9 +332,9 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, basic_lifecycle, test_pre, test_post)
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn1));
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn2));
 
-    err = ikvdb_txn_begin(store, txn1);
+    err = ikvdb_txn_begin(store, 0, txn1);
     ASSERT_EQ(0, err);
-    err = ikvdb_txn_begin(store, txn2);
+    err = ikvdb_txn_begin(store, 0, txn2);
     ASSERT_EQ(0, err);
     err = ikvdb_txn_commit(store, txn2);
     ASSERT_EQ(0, err);
@@ -343,9 +343,9 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, basic_lifecycle, test_pre, test_post)
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn1));
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn2));
 
-    err = ikvdb_txn_begin(store, txn1);
+    err = ikvdb_txn_begin(store, 0, txn1);
     ASSERT_EQ(0, err);
-    err = ikvdb_txn_begin(store, txn2);
+    err = ikvdb_txn_begin(store, 0, txn2);
     ASSERT_EQ(0, err);
     err = ikvdb_txn_commit(store, txn1);
     ASSERT_EQ(0, err);
@@ -354,9 +354,9 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, basic_lifecycle, test_pre, test_post)
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn1));
     ASSERT_EQ(KVDB_CTXN_ABORTED, ikvdb_txn_state(store, txn2));
 
-    err = ikvdb_txn_begin(store, txn1);
+    err = ikvdb_txn_begin(store, 0, txn1);
     ASSERT_EQ(0, err);
-    err = ikvdb_txn_begin(store, txn2);
+    err = ikvdb_txn_begin(store, 0, txn2);
     ASSERT_EQ(0, err);
     err = ikvdb_txn_abort(store, txn1);
     ASSERT_EQ(0, err);
@@ -365,9 +365,9 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, basic_lifecycle, test_pre, test_post)
     ASSERT_EQ(KVDB_CTXN_ABORTED, ikvdb_txn_state(store, txn1));
     ASSERT_EQ(KVDB_CTXN_COMMITTED, ikvdb_txn_state(store, txn2));
 
-    err = ikvdb_txn_begin(store, txn1);
+    err = ikvdb_txn_begin(store, 0, txn1);
     ASSERT_EQ(0, err);
-    err = ikvdb_txn_begin(store, txn2);
+    err = ikvdb_txn_begin(store, 0, txn2);
     ASSERT_EQ(0, err);
     err = ikvdb_txn_abort(store, txn1);
     ASSERT_EQ(0, err);
@@ -570,14 +570,14 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, txn_del_test, test_pre, test_post)
     txn = ikvdb_txn_alloc(h);
     ASSERT_NE(0, txn);
 
-    err = ikvdb_txn_begin(h, txn);
+    err = ikvdb_txn_begin(h, 0, txn);
     ASSERT_EQ(0, err);
     err = ikvdb_kvs_put(kvs_h, 0, txn, &kt, &vt);
     ASSERT_EQ(0, err);
     err = ikvdb_txn_commit(h, txn);
     ASSERT_EQ(0, err);
 
-    err = ikvdb_txn_begin(h, txn);
+    err = ikvdb_txn_begin(h, 0, txn);
     ASSERT_EQ(0, err);
 
     err = ikvdb_kvs_del(kvs_h, 0, txn, &kt);
@@ -626,7 +626,7 @@ parallel_transactions(void *info)
     txn = ikvdb_txn_alloc(ti->kvdb);
     VERIFY_NE_RET(0, txn, 0);
 
-    err = ikvdb_txn_begin(ti->kvdb, txn);
+    err = ikvdb_txn_begin(ti->kvdb, 0, txn);
     VERIFY_EQ_RET(0, err, 0);
 
     snprintf(kbuf, sizeof(kbuf), "key-%d", ti->idx);
@@ -751,7 +751,7 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, aborted_txn_bind, test_pre, test_post)
     txn = ikvdb_txn_alloc(kvdb_h);
     ASSERT_NE(NULL, txn);
 
-    err = ikvdb_txn_begin(kvdb_h, txn);
+    err = ikvdb_txn_begin(kvdb_h, 0, txn);
     ASSERT_EQ(err, 0);
 
     err = ikvdb_txn_abort(kvdb_h, txn);
@@ -1070,7 +1070,7 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, cursor_tx, test_pre_c0, test_post_c0)
     ASSERT_NE(NULL, txn1);
 
     /* cursor should see these two keys; seqno 0 */
-    err = ikvdb_txn_begin(h, txn2);
+    err = ikvdb_txn_begin(h, 0, txn2);
     ASSERT_EQ(err, 0);
     PUT(txn2, kvdata[0]);
     PUT(txn2, kvdata[1]);
@@ -1079,13 +1079,13 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, cursor_tx, test_pre_c0, test_post_c0)
 
     hor1 = ikvdb_horizon(h);
 
-    err = ikvdb_txn_begin(h, txn2);
+    err = ikvdb_txn_begin(h, 0, txn2);
     ASSERT_EQ(err, 0);
     err = ikvdb_kvs_cursor_create(kvs_h, flags2, txn2, 0, 0, &spam);
     ASSERT_EQ(err, 0);
 
     /* tx bumps the seqno; view 1, seqno 2 */
-    err = ikvdb_txn_begin(h, txn1);
+    err = ikvdb_txn_begin(h, 0, txn1);
     ASSERT_EQ(err, 0);
 
 #if 0
@@ -1323,7 +1323,7 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, cursor_tombspan, test_pre_c0, test_post_c0)
 
             kvs_ktuple_init(&kt, kbuf, kmin_len);
 
-            err = ikvdb_txn_begin(h, txspec.kop_txn);
+            err = ikvdb_txn_begin(h, 0, txspec.kop_txn);
             ASSERT_EQ(err, 0);
 
             txspec.kop_flags = HSE_KVDB_KOP_FLAG_BIND_TXN;
@@ -1366,7 +1366,7 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, cursor_tombspan, test_pre_c0, test_post_c0)
         kvs_vtuple_init(&vt, kbuf, klen);
 
         if (value < LEN) {
-            err = ikvdb_txn_begin(h, txspec.kop_txn);
+            err = ikvdb_txn_begin(h, 0, txspec.kop_txn);
             ASSERT_EQ(err, 0);
 
             err = ikvdb_kvs_put(kvs_h, &opspec, &kt, &vt);
@@ -1387,7 +1387,7 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, cursor_tombspan, test_pre_c0, test_post_c0)
 
         kvs_ktuple_init(&kt, kbuf, kmin_len);
 
-        err = ikvdb_txn_begin(h, txspec.kop_txn);
+        err = ikvdb_txn_begin(h, 0, txspec.kop_txn);
         ASSERT_EQ(err, 0);
 
         txspec.kop_flags = HSE_KVDB_KOP_FLAG_BIND_TXN;
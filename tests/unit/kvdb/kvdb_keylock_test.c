@@ -9,6 +9,7 @@
 #include <hse/ikvdb/kvdb_ctxn.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/util/arch.h>
 #include <hse/util/atomic.h>
 #include <hse/util/keylock.h>
 
@@ -430,4 +431,263 @@ MTF_DEFINE_UTEST_PREPOST(kvdb_keylock_test, multiple_ctxn_end, mapi_pre, mapi_po
     kvdb_keylock_destroy(klock_handle);
 }
 
+struct lock_wait_arg {
+    struct kvdb_keylock *klock_handle;
+    struct kvdb_ctxn_locks *locks_handle;
+    uint64_t hash;
+    uint64_t start_seq;
+    uint useconds;
+    merr_t err;
+};
+
+void *
+lock_wait_helper(void *arg)
+{
+    struct lock_wait_arg *p = arg;
+
+    p->err = kvdb_keylock_lock_wait(p->klock_handle, p->locks_handle, p->hash, p->start_seq, 10000);
+
+    return 0;
+}
+
+void *
+abort_helper(void *arg)
+{
+    struct lock_wait_arg *p = arg;
+
+    usleep(p->useconds);
+    kvdb_keylock_prune_own_locks(p->klock_handle, p->locks_handle);
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvdb_keylock_test, keylock_lock_wait, mapi_pre, mapi_post)
+{
+    struct kvdb_keylock *klock_handle;
+    struct kvdb_ctxn_locks *a, *b;
+    struct lock_wait_arg arg;
+    uint64_t tstart, elapsed;
+    pthread_t tid;
+    void *cookie;
+    merr_t err;
+    int rc;
+
+    err = kvdb_keylock_create(&klock_handle, 16);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_ctxn_locks_create(&a);
+    ASSERT_EQ(0, err);
+    err = kvdb_ctxn_locks_create(&b);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_keylock_lock(klock_handle, a, 1, 10);
+    ASSERT_EQ(0, err);
+    err = kvdb_keylock_lock(klock_handle, b, 2, 10);
+    ASSERT_EQ(0, err);
+
+    /* A wait on an active holder times out.
+     */
+    tstart = get_time_ns();
+    err = kvdb_keylock_lock_wait(klock_handle, b, 1, 10, 20);
+    elapsed = get_time_ns() - tstart;
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+    ASSERT_GE(elapsed, 20 * 1000 * 1000);
+
+    /* The waiter acquires the lock once the holder aborts.
+     */
+    arg.klock_handle = klock_handle;
+    arg.locks_handle = a;
+    arg.useconds = 50 * 1000;
+
+    rc = pthread_create(&tid, 0, abort_helper, &arg);
+    ASSERT_EQ(0, rc);
+
+    err = kvdb_keylock_lock_wait(klock_handle, b, 1, 10, 10000);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(2, kvdb_ctxn_locks_count(b));
+    ASSERT_EQ(0, kvdb_ctxn_locks_count(a));
+
+    rc = pthread_join(tid, 0);
+    ASSERT_EQ(0, rc);
+
+    /* a waits on b for key 2, then b waiting on a for key 3 would
+     * deadlock, hence b must fail without waiting.
+     */
+    err = kvdb_keylock_lock(klock_handle, a, 3, 10);
+    ASSERT_EQ(0, err);
+
+    arg.locks_handle = a;
+    arg.hash = 2;
+    arg.start_seq = 10;
+
+    rc = pthread_create(&tid, 0, lock_wait_helper, &arg);
+    ASSERT_EQ(0, rc);
+
+    usleep(100 * 1000);
+
+    tstart = get_time_ns();
+    err = kvdb_keylock_lock_wait(klock_handle, b, 3, 10, 10000);
+    elapsed = get_time_ns() - tstart;
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+    ASSERT_LT(elapsed, 5000UL * 1000 * 1000);
+
+    /* The deadlock victim aborts, which lets a proceed.
+     */
+    kvdb_keylock_prune_own_locks(klock_handle, b);
+
+    rc = pthread_join(tid, 0);
+    ASSERT_EQ(0, rc);
+    ASSERT_EQ(0, arg.err);
+    ASSERT_EQ(2, kvdb_ctxn_locks_count(a));
+
+    /* Once the holder commits, the waiter (whose view predates the
+     * commit) fails without waiting.
+     */
+    kvdb_keylock_list_lock(klock_handle, &cookie);
+    kvdb_keylock_enqueue_locks(a, 20, cookie);
+    kvdb_keylock_list_unlock(cookie);
+
+    tstart = get_time_ns();
+    err = kvdb_keylock_lock_wait(klock_handle, b, 3, 10, 10000);
+    elapsed = get_time_ns() - tstart;
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+    ASSERT_LT(elapsed, 5000UL * 1000 * 1000);
+
+    /* A txn that begins after the commit inherits the lock.
+     */
+    err = kvdb_keylock_lock_wait(klock_handle, b, 3, 21, 10000);
+    ASSERT_EQ(0, err);
+
+    kvdb_keylock_expire(klock_handle, UINT64_MAX, UINT64_MAX);
+
+    kvdb_keylock_release_locks(klock_handle, b);
+    kvdb_ctxn_locks_destroy(b);
+
+    kvdb_keylock_destroy(klock_handle);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvdb_keylock_test, keylock_lock_wait_commit, mapi_pre, mapi_post)
+{
+    struct kvdb_keylock *klock_handle;
+    struct kvdb_ctxn_locks *a, *b, *c;
+    struct lock_wait_arg arg;
+    uint64_t tstart, elapsed;
+    pthread_t tid;
+    void *cookie;
+    merr_t err;
+    int rc;
+
+    err = kvdb_keylock_create(&klock_handle, 16);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_ctxn_locks_create(&a);
+    ASSERT_EQ(0, err);
+    err = kvdb_ctxn_locks_create(&b);
+    ASSERT_EQ(0, err);
+    err = kvdb_ctxn_locks_create(&c);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_keylock_lock(klock_handle, a, 1, 10);
+    ASSERT_EQ(0, err);
+    err = kvdb_keylock_lock(klock_handle, a, 2, 10);
+    ASSERT_EQ(0, err);
+    err = kvdb_keylock_lock(klock_handle, c, 3, 10);
+    ASSERT_EQ(0, err);
+
+    /* b waits on a for key 1 with a view newer than the commit of a
+     * below, hence is woken by the commit and inherits the lock.
+     */
+    arg.klock_handle = klock_handle;
+    arg.locks_handle = b;
+    arg.hash = 1;
+    arg.start_seq = 30;
+
+    tstart = get_time_ns();
+
+    rc = pthread_create(&tid, 0, lock_wait_helper, &arg);
+    ASSERT_EQ(0, rc);
+
+    usleep(100 * 1000);
+
+    /* Unlocking some other key does not satisfy the waiter.
+     */
+    kvdb_keylock_prune_own_locks(klock_handle, c);
+    usleep(50 * 1000);
+
+    kvdb_keylock_list_lock(klock_handle, &cookie);
+    kvdb_keylock_enqueue_locks(a, 20, cookie);
+    kvdb_keylock_list_unlock(cookie);
+
+    rc = pthread_join(tid, 0);
+    ASSERT_EQ(0, rc);
+
+    elapsed = get_time_ns() - tstart;
+    ASSERT_EQ(0, arg.err);
+    ASSERT_EQ(1, kvdb_ctxn_locks_count(b));
+    ASSERT_GE(elapsed, 150 * 1000 * 1000);
+    ASSERT_LT(elapsed, 5000UL * 1000 * 1000);
+
+    /* A waiter whose view predates the commit fails at once.
+     */
+    tstart = get_time_ns();
+    err = kvdb_keylock_lock_wait(klock_handle, c, 2, 10, 10000);
+    elapsed = get_time_ns() - tstart;
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+    ASSERT_LT(elapsed, 5000UL * 1000 * 1000);
+
+    kvdb_keylock_expire(klock_handle, UINT64_MAX, UINT64_MAX);
+
+    kvdb_keylock_release_locks(klock_handle, b);
+    kvdb_ctxn_locks_destroy(b);
+    kvdb_ctxn_locks_destroy(c);
+
+    kvdb_keylock_destroy(klock_handle);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvdb_keylock_test, keylock_read_conflict, mapi_pre, mapi_post)
+{
+    struct kvdb_keylock *klock_handle;
+    struct kvdb_ctxn_locks *a, *b;
+    void *cookie;
+    merr_t err;
+
+    err = kvdb_keylock_create(&klock_handle, 16);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_ctxn_locks_create(&a);
+    ASSERT_EQ(0, err);
+    err = kvdb_ctxn_locks_create(&b);
+    ASSERT_EQ(0, err);
+
+    err = kvdb_keylock_lock(klock_handle, a, 1, 10);
+    ASSERT_EQ(0, err);
+
+    /* Unlocked keys and keys locked by the reader itself don't conflict,
+     * whereas keys locked by an active txn do.
+     */
+    ASSERT_FALSE(kvdb_keylock_read_conflict(klock_handle, NULL, 2, 10));
+    ASSERT_FALSE(kvdb_keylock_read_conflict(klock_handle, a, 1, 10));
+    ASSERT_TRUE(kvdb_keylock_read_conflict(klock_handle, b, 1, 10));
+    ASSERT_TRUE(kvdb_keylock_read_conflict(klock_handle, NULL, 1, 30));
+
+    /* Once committed, only readers whose view predates the commit
+     * conflict.
+     */
+    kvdb_keylock_list_lock(klock_handle, &cookie);
+    kvdb_keylock_enqueue_locks(a, 20, cookie);
+    kvdb_keylock_list_unlock(cookie);
+
+    ASSERT_TRUE(kvdb_keylock_read_conflict(klock_handle, b, 1, 10));
+    ASSERT_FALSE(kvdb_keylock_read_conflict(klock_handle, b, 1, 20));
+    ASSERT_FALSE(kvdb_keylock_read_conflict(klock_handle, NULL, 1, 30));
+
+    kvdb_keylock_expire(klock_handle, UINT64_MAX, UINT64_MAX);
+
+    ASSERT_FALSE(kvdb_keylock_read_conflict(klock_handle, b, 1, 10));
+
+    kvdb_ctxn_locks_destroy(b);
+
+    kvdb_keylock_destroy(klock_handle);
+}
+
 MTF_END_UTEST_COLLECTION(kvdb_keylock_test);
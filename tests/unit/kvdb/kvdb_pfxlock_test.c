@@ -180,4 +180,50 @@ MTF_DEFINE_UTEST_PREPOST(kvdb_pfxlock_test, long_txn, mapi_pre, mapi_post)
     kvdb_pfxlock_seqno_pub(kpl, 504, lockv[3]);
 }
 
+MTF_DEFINE_UTEST_PREPOST(kvdb_pfxlock_test, read_conflict, mapi_pre, mapi_post)
+{
+    const uint64_t hash = xrand64_tls();
+    void *lock1 = NULL;
+    void *lock2 = NULL;
+    merr_t err;
+
+    g_txn_horizon = 0;
+
+    /* Nothing written under the prefix.
+     */
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 5, false, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 5, true, NULL));
+
+    err = kvdb_pfxlock_shared(kpl, hash, 1, &lock1); /* put */
+    ASSERT_EQ(0, err);
+
+    /* An active writer conflicts with range reads by others only.
+     */
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 5, false, NULL));
+    ASSERT_TRUE(kvdb_pfxlock_read_conflict(kpl, hash, 5, true, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 1, true, lock1));
+
+    kvdb_pfxlock_seqno_pub(kpl, 10, lock1); /* commit put */
+
+    ASSERT_TRUE(kvdb_pfxlock_read_conflict(kpl, hash, 5, true, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 11, true, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 5, false, NULL));
+
+    err = kvdb_pfxlock_excl(kpl, hash, 11, &lock2); /* pdel */
+    ASSERT_EQ(0, err);
+
+    /* An active prefix delete conflicts with point reads as well,
+     * but not with reads by the txn that holds it.
+     */
+    ASSERT_TRUE(kvdb_pfxlock_read_conflict(kpl, hash, 12, false, NULL));
+    ASSERT_TRUE(kvdb_pfxlock_read_conflict(kpl, hash, 12, true, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 11, true, lock2));
+
+    kvdb_pfxlock_seqno_pub(kpl, 20, lock2); /* commit pdel */
+
+    ASSERT_TRUE(kvdb_pfxlock_read_conflict(kpl, hash, 15, false, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 21, false, NULL));
+    ASSERT_FALSE(kvdb_pfxlock_read_conflict(kpl, hash, 21, true, NULL));
+}
+
 MTF_END_UTEST_COLLECTION(kvdb_pfxlock_test);
@@ -177,6 +177,25 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, txn_timeout, test_pre)
     ASSERT_EQ(UINT64_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, txn_lock_wait_timeout, test_pre)
+{
+    const struct param_spec *ps = ps_get("txn_lock_wait_timeout");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, txn_lock_wait_timeout), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(1000, params.txn_lock_wait_timeout);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(1000 * 60, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, csched_policy, test_pre)
 {
     const struct param_spec *ps = ps_get("csched_policy");
@@ -627,6 +646,61 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, durability_mclass, test_pre)
     ASSERT_EQ(0, merr_errno(err));
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, durability_group_commit_enabled, test_pre)
+{
+    const struct param_spec *ps = ps_get("durability.group_commit.enabled");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, dur_gc_enable), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(false, params.dur_gc_enable);
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, durability_group_commit_max_wait, test_pre)
+{
+    const struct param_spec *ps = ps_get("durability.group_commit.max_wait_us");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, dur_gc_wait_us), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(HSE_WAL_GC_WAIT_US_DFLT, params.dur_gc_wait_us);
+    ASSERT_EQ(HSE_WAL_GC_WAIT_US_MIN, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(HSE_WAL_GC_WAIT_US_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, durability_compression_min_value_bytes, test_pre)
+{
+    const struct param_spec *ps = ps_get("durability.compression.min_value_bytes");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, dur_vcomp_min), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(HSE_WAL_VCOMP_MIN_DFLT, params.dur_vcomp_min);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(HSE_WAL_VCOMP_MIN_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, throttle_disable, test_pre)
 {
     const struct param_spec *ps = ps_get("throttle_disable");
@@ -802,6 +876,25 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, c0_ingest_threads, test_pre)
     ASSERT_EQ(HSE_C0_INGEST_THREADS_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, c0_ingest_build_threads, test_pre)
+{
+    const struct param_spec *ps = ps_get("c0_ingest_build_threads");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, c0_ingest_build_threads), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(HSE_C0_INGEST_BUILD_THREADS_DFLT, params.c0_ingest_build_threads);
+    ASSERT_EQ(HSE_C0_INGEST_BUILD_THREADS_MIN, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(HSE_C0_INGEST_BUILD_THREADS_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, cn_maint_threads, test_pre)
 {
     const struct param_spec *ps = ps_get("cn_maint_threads");
@@ -929,6 +1022,104 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_pmem_directio_enabled, test_pre)
     ASSERT_EQ(true, params.dio_enable[HSE_MCLASS_PMEM]);
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_capacity_io_engine, test_pre)
+{
+    merr_t err;
+    char buf[128];
+    size_t needed_sz;
+    const struct param_spec *ps = ps_get("storage.capacity.io_engine");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_CAPACITY]), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum mpool_io_engine), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(MPOOL_IO_ENGINE_SYNC, params.io_engine[HSE_MCLASS_CAPACITY]);
+    ASSERT_EQ(MPOOL_IO_ENGINE_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(MPOOL_IO_ENGINE_MAX, ps->ps_bounds.as_enum.ps_max);
+
+    ps->ps_stringify(ps, &params.io_engine[HSE_MCLASS_CAPACITY], buf, sizeof(buf), &needed_sz);
+    ASSERT_STREQ("\"sync\"", buf);
+    ASSERT_EQ(6, needed_sz);
+
+    /* clang-format off */
+    err = check(
+        "storage.capacity.io_engine=aio", false,
+        "storage.capacity.io_engine=io_uring", true,
+        "storage.capacity.io_engine=sync", true,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_staging_io_engine, test_pre)
+{
+    char buf[128];
+    size_t needed_sz;
+    const struct param_spec *ps = ps_get("storage.staging.io_engine");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_STAGING]), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum mpool_io_engine), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(MPOOL_IO_ENGINE_SYNC, params.io_engine[HSE_MCLASS_STAGING]);
+    ASSERT_EQ(MPOOL_IO_ENGINE_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(MPOOL_IO_ENGINE_MAX, ps->ps_bounds.as_enum.ps_max);
+
+    ps->ps_stringify(ps, &params.io_engine[HSE_MCLASS_STAGING], buf, sizeof(buf), &needed_sz);
+    ASSERT_STREQ("\"sync\"", buf);
+    ASSERT_EQ(6, needed_sz);
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_pmem_io_engine, test_pre)
+{
+    merr_t err;
+    char buf[128];
+    size_t needed_sz;
+    const struct param_spec *ps = ps_get("storage.pmem.io_engine");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, io_engine[HSE_MCLASS_PMEM]), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum mpool_io_engine), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(MPOOL_IO_ENGINE_SYNC, params.io_engine[HSE_MCLASS_PMEM]);
+    ASSERT_EQ(MPOOL_IO_ENGINE_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(MPOOL_IO_ENGINE_SYNC, ps->ps_bounds.as_enum.ps_max);
+
+    ps->ps_stringify(ps, &params.io_engine[HSE_MCLASS_PMEM], buf, sizeof(buf), &needed_sz);
+    ASSERT_STREQ("\"sync\"", buf);
+    ASSERT_EQ(6, needed_sz);
+
+    /* clang-format off */
+    err = check(
+        "storage.pmem.io_engine=io_uring", false,
+        "storage.pmem.io_engine=sync", true,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, mclass_policies, test_pre)
 {
     /* [HSE_REVISIT]: mclass_policies has its own test. It should maybe be moved
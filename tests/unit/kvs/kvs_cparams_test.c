@@ -8,6 +8,7 @@
 #include <hse/config/params.h>
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/util/base.h>
 
 #include <hse/test/mtf/framework.h>
 
@@ -77,6 +78,63 @@ MTF_DEFINE_UTEST_PRE(kvs_cparams_test, kvs_ext01, test_pre)
     ASSERT_EQ(UINT32_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_cparams_test, filter_type, test_pre)
+{
+    const struct param_spec *ps = ps_get("filter.type");
+    const char *paramv[] = { "filter.type=fuse" };
+    char buf[128];
+    merr_t err;
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_cparams, filter_type), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum kvs_filter_type), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(KVS_FILTER_BLOOM, params.filter_type);
+    ASSERT_EQ(KVS_FILTER_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(KVS_FILTER_MAX, ps->ps_bounds.as_enum.ps_max);
+
+    err = kvs_cparams_get(&params, "filter.type", buf, sizeof(buf), NULL);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_STREQ("\"bloom\"", buf);
+
+    err = kvs_cparams_from_paramv(&params, NELEM(paramv), paramv);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(KVS_FILTER_FUSE, params.filter_type);
+
+    err = kvs_cparams_get(&params, "filter.type", buf, sizeof(buf), NULL);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_STREQ("\"fuse\"", buf);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_cparams_test, hash_index, test_pre)
+{
+    const struct param_spec *ps = ps_get("hash_index.enabled");
+    const char *paramv[] = { "hash_index.enabled=true" };
+    merr_t err;
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_cparams, hash_index), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(false, params.hash_index);
+
+    err = kvs_cparams_from_paramv(&params, NELEM(paramv), paramv);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(true, params.hash_index);
+}
+
 MTF_DEFINE_UTEST(kvs_cparams_test, get)
 {
     merr_t err;
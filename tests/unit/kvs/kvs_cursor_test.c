@@ -69,7 +69,7 @@ insert_key(struct mtf_test_info *lcl_ti, char *key)
     kvs_ktuple_init(&kt, key, strlen(key));
     kvs_vtuple_init(&vt, key, strlen(key));
 
-    err = kvs_put(kvs, NULL, &kt, &vt, 1);
+    err = kvs_put(kvs, NULL, &kt, &vt, NULL, 1, false);
     ASSERT_EQ(0, err);
 }
 
@@ -0,0 +1,275 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/tuple.h>
+
+#include <hse/test/mtf/framework.h>
+
+#include "kvs/kvs_rcache.h"
+
+#define CACHESZ (16 * 1024)
+
+static struct kvs_rcache *rc;
+
+static void
+kt_init(struct kvs_ktuple *kt, const char *key)
+{
+    kvs_ktuple_init(kt, key, strlen(key));
+}
+
+static void
+vbuf_init(struct kvs_buf *vbuf, void *buf, uint32_t bufsz, uint32_t len)
+{
+    vbuf->b_buf = buf;
+    vbuf->b_buf_sz = bufsz;
+    vbuf->b_len = len;
+}
+
+static int
+pre(struct mtf_test_info *mtf)
+{
+    return merr_errno(kvs_rcache_create(CACHESZ, "global", 0, &rc));
+}
+
+static int
+post(struct mtf_test_info *mtf)
+{
+    kvs_rcache_destroy(rc);
+    rc = NULL;
+
+    return 0;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(kvs_rcache_test);
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, put_get, pre, post)
+{
+    struct kvs_ktuple kt;
+    struct kvs_buf vbuf;
+    char val[32], buf[32];
+    bool hit;
+
+    kt_init(&kt, "alpha");
+    snprintf(val, sizeof(val), "value-alpha");
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+
+    vbuf_init(&vbuf, val, sizeof(val), strlen(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 1, &vbuf);
+
+    memset(buf, 0, sizeof(buf));
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(strlen(val), vbuf.b_len);
+    ASSERT_EQ(0, memcmp(buf, val, vbuf.b_len));
+
+    /* A short buffer receives a truncated value but the full length.
+     */
+    memset(buf, 0, sizeof(buf));
+    vbuf_init(&vbuf, buf, 4, 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(strlen(val), vbuf.b_len);
+    ASSERT_EQ(0, memcmp(buf, val, 4));
+    ASSERT_EQ(0, buf[4]);
+
+    /* A NULL buffer yields only the length.
+     */
+    vbuf_init(&vbuf, NULL, 0, 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(strlen(val), vbuf.b_len);
+
+    /* Replacing an entry.
+     */
+    snprintf(val, sizeof(val), "alpha-2");
+    vbuf_init(&vbuf, val, sizeof(val), strlen(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 1, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(strlen(val), vbuf.b_len);
+    ASSERT_EQ(0, memcmp(buf, val, vbuf.b_len));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, invalidate, pre, post)
+{
+    struct kvs_ktuple kt, other;
+    struct kvs_buf vbuf;
+    char key[32], val[] = "value";
+    char buf[32];
+    bool hit;
+
+    kt_init(&kt, "beta");
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 7, &vbuf);
+
+    /* Ingesting other keys leaves the entry in place.
+     */
+    for (uint i = 0; i < 100; ++i) {
+        snprintf(key, sizeof(key), "other-%u", i);
+        kt_init(&other, key);
+
+        if ((other.kt_hash ^ kt.kt_hash) % 1024 != 0)
+            kvs_rcache_invalidate(rc, other.kt_hash, 20 + i);
+    }
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+
+    /* Ingesting the key drops the entry.
+     */
+    kvs_rcache_invalidate(rc, kt.kt_hash, 10);
+
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+
+    /* A reader whose view predates the ingested value may have read the
+     * old value from cn, hence its fill is refused.
+     */
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 9, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 10, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, invalidate_all, pre, post)
+{
+    struct kvs_ktuple kt1, kt2;
+    struct kvs_buf vbuf;
+    char val[] = "value";
+    char buf[32];
+    bool hit;
+
+    kt_init(&kt1, "zeta");
+    kt_init(&kt2, "eta");
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt1, kt1.kt_hash, 5, &vbuf);
+    kvs_rcache_put(rc, &kt2, kt2.kt_hash, 5, &vbuf);
+
+    /* A prefix tombstone invalidates every key.
+     */
+    kvs_rcache_invalidate_all(rc, 8);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt1, kt1.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+    hit = kvs_rcache_get(rc, &kt2, kt2.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt1, kt1.kt_hash, 7, &vbuf);
+    kvs_rcache_put(rc, &kt2, kt2.kt_hash, 8, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt1, kt1.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+    hit = kvs_rcache_get(rc, &kt2, kt2.kt_hash, &vbuf);
+    ASSERT_TRUE(hit);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, hash_collision, pre, post)
+{
+    struct kvs_ktuple kt1, kt2;
+    struct kvs_buf vbuf;
+    char val[] = "value";
+    char buf[32];
+    bool hit;
+
+    kt_init(&kt1, "gamma");
+    kt_init(&kt2, "delta");
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt1, 12345, 1, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt2, 12345, &vbuf);
+    ASSERT_FALSE(hit);
+
+    hit = kvs_rcache_get(rc, &kt1, 12345, &vbuf);
+    ASSERT_TRUE(hit);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, oversize, pre, post)
+{
+    static char val[CACHESZ];
+    struct kvs_ktuple kt;
+    struct kvs_buf vbuf;
+    char buf[32];
+    bool hit;
+
+    kt_init(&kt, "epsilon");
+
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &kt, kt.kt_hash, 1, &vbuf);
+
+    vbuf_init(&vbuf, buf, sizeof(buf), 0);
+    hit = kvs_rcache_get(rc, &kt, kt.kt_hash, &vbuf);
+    ASSERT_FALSE(hit);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_rcache_test, evict, pre, post)
+{
+    struct kvs_ktuple kt, hot;
+    struct kvs_buf vbuf;
+    char key[32], val[64], buf[64];
+    uint hits = 0;
+    bool hit;
+
+    memset(val, 'v', sizeof(val));
+
+    /* All keys map to the same shard, hence far exceed its budget.  The hot
+     * key is referenced between inserts and must survive the clock.
+     */
+    kt_init(&hot, "hot");
+    vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+    kvs_rcache_put(rc, &hot, 0, 1, &vbuf);
+
+    for (uint64_t i = 1; i < 1000; ++i) {
+        snprintf(key, sizeof(key), "key-%lu", i);
+        kt_init(&kt, key);
+
+        vbuf_init(&vbuf, val, sizeof(val), sizeof(val));
+        kvs_rcache_put(rc, &kt, i * 16, 1, &vbuf);
+
+        vbuf_init(&vbuf, buf, sizeof(buf), 0);
+        hit = kvs_rcache_get(rc, &hot, 0, &vbuf);
+        ASSERT_TRUE(hit);
+    }
+
+    for (uint64_t i = 1; i < 1000; ++i) {
+        snprintf(key, sizeof(key), "key-%lu", i);
+        kt_init(&kt, key);
+
+        vbuf_init(&vbuf, buf, sizeof(buf), 0);
+        hits += kvs_rcache_get(rc, &kt, i * 16, &vbuf);
+    }
+
+    ASSERT_GT(hits, 0);
+    ASSERT_LT(hits, 100);
+}
+
+MTF_END_UTEST_COLLECTION(kvs_rcache_test)
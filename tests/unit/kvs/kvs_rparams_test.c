@@ -94,6 +94,25 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, kvs_cursor_ttl, test_pre)
     ASSERT_EQ(UINT64_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, kvs_rcache_sz, test_pre)
+{
+    const struct param_spec *ps = ps_get("kvs_rcache_sz");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U64, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, kvs_rcache_sz), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint64_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(HSE_KVS_RCACHE_SZ_DFLT, params.kvs_rcache_sz);
+    ASSERT_EQ(HSE_KVS_RCACHE_SZ_MIN, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(HSE_KVS_RCACHE_SZ_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, kvs_sfx_len, test_pre)
 {
     const struct param_spec *ps = ps_get("kvs_sfx_len");
@@ -272,6 +291,44 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_compact_kblk_ra, test_pre)
     ASSERT_EQ(2 << MB_SHIFT, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_compact_slices, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_compact_slices");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL | PARAM_WRITABLE, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_compact_slices), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(4, params.cn_compact_slices);
+    ASSERT_EQ(1, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(16, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_wbehind_qdepth, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_wbehind_qdepth");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_wbehind_qdepth), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(2, params.cn_wbehind_qdepth);
+    ASSERT_EQ(1, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(8, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_capped_ttl, test_pre)
 {
     const struct param_spec *ps = ps_get("cn_capped_ttl");
@@ -623,6 +680,25 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, capped_evict_ttl, test_pre)
     ASSERT_EQ(UINT64_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_mclass_hot, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_mclass_hot");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_mclass_hot), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.cn_mclass_hot);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(UINT32_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, mclass_policy, test_pre)
 {
     const struct param_spec *ps = ps_get("mclass.policy");
@@ -678,6 +754,75 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_default, test_pre)
     ASSERT_EQ(0, merr_errno(err));
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_algorithm, test_pre)
+{
+    merr_t err;
+    char buf[128];
+    size_t needed_sz;
+    const struct param_spec *ps = ps_get("value.compression.algorithm");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, value.compression.algo), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum vcomp_algorithm), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(VCOMP_ALGO_LZ4, params.value.compression.algo);
+    ASSERT_EQ(VCOMP_ALGO_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(VCOMP_ALGO_MAX, ps->ps_bounds.as_enum.ps_max);
+
+    ps->ps_stringify(ps, &params.value.compression.algo, buf, sizeof(buf), &needed_sz);
+    ASSERT_STREQ("\"lz4\"", buf);
+    ASSERT_EQ(5, needed_sz);
+
+    /* clang-format off */
+    err = check(
+        "value.compression.algorithm=lz4", true,
+        "value.compression.algorithm=zstd", true,
+        "value.compression.algorithm=does-not-exist", false,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_level, test_pre)
+{
+    merr_t err;
+    const struct param_spec *ps = ps_get("value.compression.level");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_I32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, value.compression.level), ps->ps_offset);
+    ASSERT_EQ(sizeof(int32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.value.compression.level);
+    ASSERT_EQ(VCOMP_LEVEL_MIN, ps->ps_bounds.as_scalar.ps_min);
+    ASSERT_EQ(VCOMP_LEVEL_MAX, ps->ps_bounds.as_scalar.ps_max);
+
+    /* clang-format off */
+    err = check(
+        "value.compression.level=-5", true,
+        "value.compression.level=19", true,
+        "value.compression.level=-6", false,
+        "value.compression.level=20", false,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
 MTF_DEFINE_UTEST(kvs_rparams_test, get)
 {
     merr_t err;
@@ -124,10 +124,10 @@ MTF_DEFINE_UTEST(bloom_filter_basic, BasicInsert)
 
             bitmap += bf_hash2bkt(hash, f.bf_modulus, f.bf_bktshift);
 
-            hit = bf_lookup(hash, bitmap, f.bf_n_hashes, f.bf_rotl, f.bf_bktmask);
+            hit = bf_sb_lookup(hash, bitmap, f.bf_n_hashes);
             ASSERT_TRUE(hit);
 
-            hit = bf_lookup(~hash, bitmap, f.bf_n_hashes, f.bf_rotl, f.bf_bktmask);
+            hit = bf_sb_lookup(~hash, bitmap, f.bf_n_hashes);
             if (hit)
                 ++fpc;
         }
@@ -138,6 +138,82 @@ MTF_DEFINE_UTEST(bloom_filter_basic, BasicInsert)
     }
 }
 
+/* Verify bf_sb_lookup() (which may use a vector implementation) agrees
+ * with a bit-by-bit probe of the split-block bucket.
+ */
+MTF_DEFINE_UTEST(bloom_filter_basic, SplitBlockLookup)
+{
+    uint8_t bkt[1u << (BF_SB_BKTSHIFT - 3)] HSE_ALIGNED(64);
+    uint64_t hash = 0x9e3779b97f4a7c15ul;
+    uint i, j, n;
+
+    for (i = 0; i < 100000; ++i) {
+        bool expect = true;
+
+        hash = hse_hash64(&hash, sizeof(hash));
+
+        /* Sparse buckets yield a mix of hits and misses.
+         */
+        for (j = 0; j < sizeof(bkt); ++j)
+            bkt[j] = (hash >> (j % 57)) & (hash >> ((j + 13) % 61));
+
+        n = (i % BF_SB_LANES) + 1;
+
+        for (j = 0; j < n; ++j) {
+            if (!isset(bkt, bf_sb_hash2bit(hash, j)))
+                expect = false;
+        }
+
+        ASSERT_EQ(expect, bf_sb_lookup(hash, bkt, n));
+
+        for (j = 0; j < n; ++j)
+            setbit(bkt, bf_sb_hash2bit(hash, j));
+
+        ASSERT_TRUE(bf_sb_lookup(hash, bkt, n));
+    }
+}
+
+/* Filters built prior to the split-block layout must remain readable.
+ */
+MTF_DEFINE_UTEST(bloom_filter_basic, LegacyInsert)
+{
+    struct bf_bithash_desc desc;
+    struct bloom_filter f;
+    uint8_t *bits;
+    uint32_t n_elts = 10000;
+    uint32_t i, n;
+    uint64_t hash;
+    char buf[100];
+    size_t sz;
+
+    desc = bf_compute_bithash_est(1000);
+
+    sz = ALIGN(n_elts * desc.bhd_bits_per_elt, PAGE_SIZE);
+    bits = aligned_alloc(PAGE_SIZE, sz);
+    ASSERT_NE(NULL, bits);
+    memset(bits, 0, sz);
+
+    bf_filter_init(&f, desc, n_elts, bits, sz);
+
+    for (i = 0; i < n_elts; ++i) {
+        n = sprintf(buf, "%x:%d", i, i);
+        bf_populate(&f, hse_hash64(buf, n));
+    }
+
+    for (i = 0; i < n_elts; ++i) {
+        const uint8_t *bitmap = bits;
+
+        n = sprintf(buf, "%x:%d", i, i);
+        hash = hse_hash64(buf, n);
+
+        bitmap += bf_hash2bkt(hash, f.bf_modulus, f.bf_bktshift);
+
+        ASSERT_TRUE(bf_lookup(hash, bitmap, f.bf_n_hashes, f.bf_rotl, f.bf_bktmask));
+    }
+
+    free(bits);
+}
+
 MTF_DEFINE_UTEST(bloom_filter_basic, RepeatableBasic)
 {
     const char *buf1 = "The cow jumped over the moon";
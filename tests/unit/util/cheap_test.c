@@ -3,6 +3,7 @@
  * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
  */
 
+#include <pthread.h>
 #include <stdint.h>
 
 #include <sys/mman.h>
@@ -327,8 +328,8 @@ MTF_DEFINE_UTEST(cheap_test, cheap_test_free)
             ASSERT_NE(NULL, p0);
 
             memset(p0, 0xff, sz);
-            cheap_free(h, p0);
-            cheap_free(h, p0);
+            cheap_free(h, p0, sz);
+            cheap_free(h, p0, sz);
 
             sz = ALIGN(sz, align);
             p1 = cheap_malloc(h, sz);
@@ -363,19 +364,149 @@ MTF_DEFINE_UTEST(cheap_test, cheap_test_free)
         ASSERT_NE(NULL, p0);
         p1 = cheap_malloc(h, 1);
         ASSERT_NE(NULL, p0);
-        cheap_free(h, p0);
-        cheap_free(h, p1);
+        cheap_free(h, p0, align);
+        cheap_free(h, p1, 1);
 
         avail = cheap_avail(h);
         ASSERT_EQ(free - align, avail);
 
-        cheap_free(h, NULL);
-        cheap_free(h, NULL);
+        cheap_free(h, NULL, 0);
+        cheap_free(h, NULL, 0);
 
         cheap_destroy(h);
     }
 }
 
+#define CHEAP_MT_THREADS (8)
+#define CHEAP_MT_ALLOCS  (4096)
+
+struct cheap_mt_arg {
+    struct cheap *h;
+    uint8_t id;
+    uint8_t *allocv[CHEAP_MT_ALLOCS];
+};
+
+static void *
+cheap_mt_worker(void *arg)
+{
+    struct cheap_mt_arg *ma = arg;
+
+    for (uint i = 0; i < CHEAP_MT_ALLOCS; ++i) {
+        uint8_t *p = cheap_malloc(ma->h, 64);
+
+        if (p)
+            memset(p, ma->id, 64);
+        ma->allocv[i] = p;
+    }
+
+    return NULL;
+}
+
+/* Verify concurrent allocations do not overlap. */
+MTF_DEFINE_UTEST(cheap_test, cheap_test_mt)
+{
+    struct cheap_mt_arg argv[CHEAP_MT_THREADS];
+    pthread_t tidv[CHEAP_MT_THREADS];
+    struct cheap *h;
+    size_t used;
+    int rc;
+
+    h = cheap_create(8, CHEAP_MT_THREADS * CHEAP_MT_ALLOCS * 64 + PAGE_SIZE);
+    ASSERT_NE(NULL, h);
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i) {
+        argv[i].h = h;
+        argv[i].id = i + 1;
+
+        rc = pthread_create(tidv + i, NULL, cheap_mt_worker, argv + i);
+        ASSERT_EQ(0, rc);
+    }
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i)
+        pthread_join(tidv[i], NULL);
+
+    used = cheap_used(h);
+    ASSERT_EQ(CHEAP_MT_THREADS * CHEAP_MT_ALLOCS * 64, used);
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i) {
+        for (uint j = 0; j < CHEAP_MT_ALLOCS; ++j) {
+            uint8_t *p = argv[i].allocv[j];
+
+            ASSERT_NE(NULL, p);
+            ASSERT_EQ(argv[i].id, p[0]);
+            ASSERT_EQ(argv[i].id, p[63]);
+        }
+    }
+
+    cheap_destroy(h);
+}
+
+static void *
+cheap_mt_free_worker(void *arg)
+{
+    struct cheap_mt_arg *ma = arg;
+
+    for (uint i = 0; i < CHEAP_MT_ALLOCS; ++i) {
+        uint8_t *p = cheap_malloc(ma->h, 64);
+
+        ma->allocv[i] = NULL;
+        if (!p)
+            continue;
+
+        /* Free every other chunk, it is reclaimed only if no other
+         * thread allocated from the cheap in the meantime.
+         */
+        if (i % 2) {
+            memset(p, 0xff, 64);
+            cheap_free(ma->h, p, 64);
+            continue;
+        }
+
+        memset(p, ma->id, 64);
+        ma->allocv[i] = p;
+    }
+
+    return NULL;
+}
+
+/* Verify concurrent frees never release another thread's allocation. */
+MTF_DEFINE_UTEST(cheap_test, cheap_test_mt_free)
+{
+    struct cheap_mt_arg argv[CHEAP_MT_THREADS];
+    pthread_t tidv[CHEAP_MT_THREADS];
+    struct cheap *h;
+    int rc;
+
+    h = cheap_create(8, CHEAP_MT_THREADS * CHEAP_MT_ALLOCS * 64 + PAGE_SIZE);
+    ASSERT_NE(NULL, h);
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i) {
+        argv[i].h = h;
+        argv[i].id = i + 1;
+
+        rc = pthread_create(tidv + i, NULL, cheap_mt_free_worker, argv + i);
+        ASSERT_EQ(0, rc);
+    }
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i)
+        pthread_join(tidv[i], NULL);
+
+    ASSERT_GE(CHEAP_MT_THREADS * CHEAP_MT_ALLOCS * 64, cheap_used(h));
+    ASSERT_LE(CHEAP_MT_THREADS * CHEAP_MT_ALLOCS * 64 / 2, cheap_used(h));
+
+    for (uint i = 0; i < CHEAP_MT_THREADS; ++i) {
+        for (uint j = 0; j < CHEAP_MT_ALLOCS; j += 2) {
+            uint8_t *p = argv[i].allocv[j];
+
+            ASSERT_NE(NULL, p);
+            ASSERT_EQ(argv[i].id, p[0]);
+            ASSERT_EQ(argv[i].id, p[63]);
+        }
+    }
+
+    cheap_destroy(h);
+}
+
 static size_t
 rss(void *mem, size_t maxpg, unsigned char *vec)
 {
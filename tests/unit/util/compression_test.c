@@ -3,15 +3,18 @@
  * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
  */
 
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/compression_lz4.h>
+#include <hse/util/compression_zstd.h>
 #include <hse/util/platform.h>
 
 #include <hse/test/mtf/framework.h>
 
 MTF_BEGIN_UTEST_COLLECTION(compression_test);
 
-MTF_DEFINE_UTEST(compression_test, compress)
+static void
+compress_and_verify(struct mtf_test_info *lcl_ti, const struct compress_ops *cops, int level)
 {
     size_t srcsz, cbufsz, dbufsz;
     char *src, *src_base, *cbuf, *dbuf;
@@ -27,7 +30,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
     dbuf = malloc(dbufsz);
     ASSERT_NE(NULL, dbuf);
 
-    cbufsz = compress_lz4_ops.cop_estimate(NULL, srcsz);
+    cbufsz = cops->cop_estimate(NULL, srcsz);
     ASSERT_GE(cbufsz, srcsz);
 
     cbuf = malloc(cbufsz);
@@ -38,7 +41,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
 
     /* Compress the full source buffer, output to cbuf...
      */
-    err = compress_lz4_ops.cop_compress(src, srcsz, cbuf, cbufsz, &cbuflen);
+    err = cops->cop_compress(src, srcsz, cbuf, cbufsz, level, &cbuflen);
     if (err)
         log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz, cbuflen);
     ASSERT_EQ(0, err);
@@ -47,7 +50,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
 
     /* Decompress the full compressed buffer, output to dbuf...
      */
-    err = compress_lz4_ops.cop_decompress(cbuf, cbuflen, dbuf, dbufsz, &dbuflen);
+    err = cops->cop_decompress(cbuf, cbuflen, dbuf, dbufsz, &dbuflen);
     ASSERT_EQ(0, err);
     ASSERT_EQ(srcsz, dbuflen);
     ASSERT_EQ(0, memcmp(src, dbuf, dbuflen));
@@ -58,7 +61,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
     for (i = 1; i < srcsz + 1; ++i) {
         memset(dbuf, 0xaa, i);
 
-        err = compress_lz4_ops.cop_decompress(cbuf, cbuflen, dbuf, i, &dbuflen);
+        err = cops->cop_decompress(cbuf, cbuflen, dbuf, i, &dbuflen);
         if (err)
             log_errx("i %u, cbuflen %u, dbuflen %u", err, i, cbuflen, dbuflen);
 
@@ -76,15 +79,14 @@ MTF_DEFINE_UTEST(compression_test, compress)
     for (i = 0; i < 32; ++i) {
         srcsz = 512 + 8 - i;
 
-        err = compress_lz4_ops.cop_compress(src + i, srcsz, cbuf + i, cbufsz - i, &cbuflen);
+        err = cops->cop_compress(src + i, srcsz, cbuf + i, cbufsz - i, level, &cbuflen);
         if (err)
             log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz - i, cbuflen);
         ASSERT_EQ(0, err);
 
         memset(dbuf, 0xaa, dbufsz);
 
-        err = compress_lz4_ops.cop_decompress(
-            cbuf + i, cbuflen, dbuf + i, (srcsz % 15) + 1, &dbuflen);
+        err = cops->cop_decompress(cbuf + i, cbuflen, dbuf + i, (srcsz % 15) + 1, &dbuflen);
         ASSERT_EQ(0, err);
         ASSERT_EQ((srcsz % 15) + 1, dbuflen);
         ASSERT_EQ(0, memcmp(src + i, dbuf + i, dbuflen));
@@ -95,6 +97,52 @@ MTF_DEFINE_UTEST(compression_test, compress)
     free(src_base);
 }
 
+MTF_DEFINE_UTEST(compression_test, compress)
+{
+    compress_and_verify(lcl_ti, &compress_lz4_ops, 0);
+}
+
+#ifdef HAVE_ZSTD
+MTF_DEFINE_UTEST(compression_test, compress_zstd)
+{
+    compress_and_verify(lcl_ti, &compress_zstd_ops, 0);
+    compress_and_verify(lcl_ti, &compress_zstd_ops, VCOMP_LEVEL_MIN);
+    compress_and_verify(lcl_ti, &compress_zstd_ops, VCOMP_LEVEL_MAX);
+}
+#endif
+
+/* The algorithm of a compressed value is inferred from its first four bytes,
+ * hence LZ4 output must never look like a zstd frame.
+ */
+MTF_DEFINE_UTEST(compression_test, frame_detect)
+{
+    const uint8_t magic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+    char src[512], cbuf[1024];
+    uint cbuflen;
+    merr_t err;
+    int i, j;
+
+    ASSERT_FALSE(compress_zstd_frame(magic, 3));
+    ASSERT_TRUE(compress_zstd_frame(magic, 4));
+
+    /* Values that begin with (or consist entirely of) the zstd magic number.
+     */
+    for (i = 0; i < 256; ++i) {
+        for (j = 0; j < sizeof(src); ++j)
+            src[j] = (j < 4 || i == 0) ? magic[j % 4] : (i * j) / 7;
+
+        err = compress_lz4_ops.cop_compress(src, sizeof(src), cbuf, sizeof(cbuf), 0, &cbuflen);
+        ASSERT_EQ(0, err);
+        ASSERT_FALSE(compress_zstd_frame(cbuf, cbuflen));
+
+#ifdef HAVE_ZSTD
+        err = compress_zstd_ops.cop_compress(src, sizeof(src), cbuf, sizeof(cbuf), 0, &cbuflen);
+        ASSERT_EQ(0, err);
+        ASSERT_TRUE(compress_zstd_frame(cbuf, cbuflen));
+#endif
+    }
+}
+
 /* A known test case that fails with versions of liblz4 prior to v1.9.2
  * that was generated via the hse-mongo connector.
  */
@@ -130,7 +178,7 @@ MTF_DEFINE_UTEST(compression_test, mongo)
 
     /* Compress the full source buffer, output to cbuf...
      */
-    err = compress_lz4_ops.cop_compress(srcv, srcsz, cbuf, cbufsz, &cbuflen);
+    err = compress_lz4_ops.cop_compress(srcv, srcsz, cbuf, cbufsz, 0, &cbuflen);
     if (err)
         log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz, cbuflen);
     ASSERT_EQ(0, err);
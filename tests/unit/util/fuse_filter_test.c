@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/base.h>
+#include <hse/util/bloom_filter.h>
+#include <hse/util/fuse_filter.h>
+#include <hse/util/hash.h>
+#include <hse/util/page.h>
+
+#include <hse/test/mtf/framework.h>
+
+MTF_BEGIN_UTEST_COLLECTION(fuse_filter_test);
+
+static bool
+fuse_lookup(const struct fuse_filter *ff, uint64_t hash)
+{
+    return ff_lookup(
+        hash, ff->ff_fpv, ff->ff_fpbits, ff->ff_seed, ff->ff_seglen_shift, ff->ff_seg_count_len);
+}
+
+MTF_DEFINE_UTEST(fuse_filter_test, fpbits_est)
+{
+    ASSERT_EQ(FF_FPBITS_MIN, ff_compute_fpbits_est(1000000));
+    ASSERT_EQ(FF_FPBITS_MIN, ff_compute_fpbits_est(10000));
+    ASSERT_EQ(FF_FPBITS_MIN, ff_compute_fpbits_est(3907));
+    ASSERT_EQ(FF_FPBITS_MID, ff_compute_fpbits_est(3906));
+    ASSERT_EQ(FF_FPBITS_MID, ff_compute_fpbits_est(245));
+    ASSERT_EQ(FF_FPBITS_MAX, ff_compute_fpbits_est(244));
+    ASSERT_EQ(FF_FPBITS_MAX, ff_compute_fpbits_est(0));
+}
+
+MTF_DEFINE_UTEST(fuse_filter_test, estimates)
+{
+    size_t last = 0;
+    uint32_t n;
+
+    for (n = 0; n < 1000000; n += 997) {
+        size_t sz = ff_size_estimate(FF_FPBITS_MIN, n);
+
+        ASSERT_GE(sz, n);
+        ASSERT_GE(sz, last);
+        ASSERT_EQ(sz * 2, ff_size_estimate(FF_FPBITS_MAX, n));
+        ASSERT_EQ((sz * 3 + 1) / 2, ff_size_estimate(FF_FPBITS_MID, n));
+
+        for (uint32_t fpbits = FF_FPBITS_MIN; fpbits <= FF_FPBITS_MAX; fpbits += 4) {
+            size_t fpsz = ff_size_estimate(fpbits, n);
+
+            ASSERT_GE(ff_element_estimate(fpbits, fpsz), n);
+            ASSERT_LE(ff_size_estimate(fpbits, ff_element_estimate(fpbits, fpsz)), fpsz);
+        }
+
+        last = sz;
+    }
+
+    /* At 8 bits per fingerprint a large filter should cost less than 10 bits
+     * per key, compared to 13 bits per key for a bloom filter with a similar
+     * false positive rate.
+     */
+    n = 1000000;
+    ASSERT_LT(ff_size_estimate(FF_FPBITS_MIN, n) * 8, n * 10);
+    ASSERT_GE(bf_compute_bithash_est(3900).bhd_bits_per_elt, 13);
+}
+
+static void
+build_and_probe(struct mtf_test_info *lcl_ti, uint32_t fpbits, uint32_t n, bool dups)
+{
+    struct fuse_filter ff;
+    uint64_t *hashv;
+    uint8_t *storage;
+    size_t storage_sz;
+    uint32_t fpc = 0;
+    merr_t err;
+
+    hashv = malloc((n + 1) * sizeof(*hashv));
+    ASSERT_NE(NULL, hashv);
+
+    for (uint32_t i = 0; i < n; ++i)
+        hashv[i] = hse_hash64(&i, sizeof(i));
+
+    if (dups && n > 3)
+        hashv[n / 2] = hashv[n / 3];
+
+    storage_sz = ff_size_estimate(fpbits, n) + PAGE_SIZE;
+    storage = malloc(storage_sz);
+    ASSERT_NE(NULL, storage);
+
+    err = ff_filter_build(&ff, fpbits, hashv, n, storage, storage_sz);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_EQ(fpbits, ff.ff_fpbits);
+    ASSERT_EQ(storage, ff.ff_fpv);
+    ASSERT_LE(ff.ff_fpvsz, storage_sz);
+
+    /* No false negatives.
+     */
+    for (uint32_t i = 0; i < n; ++i)
+        ASSERT_TRUE(fuse_lookup(&ff, hashv[i]));
+
+    /* The expected false positive rate is 2^-fpbits, allow for twice that
+     * plus some slack for small filters.
+     */
+    for (uint32_t i = 0; i < n; ++i)
+        fpc += fuse_lookup(&ff, ~hashv[i]);
+
+    ASSERT_LE(fpc, (n >> (fpbits - 1)) + 8);
+
+    free(storage);
+    free(hashv);
+}
+
+MTF_DEFINE_UTEST(fuse_filter_test, build)
+{
+    const uint32_t nv[] = { 1, 2, 3, 10, 100, 1000, 12345, 300000 };
+
+    for (int i = 0; i < NELEM(nv); ++i) {
+        build_and_probe(lcl_ti, FF_FPBITS_MIN, nv[i], false);
+        build_and_probe(lcl_ti, FF_FPBITS_MID, nv[i], false);
+        build_and_probe(lcl_ti, FF_FPBITS_MAX, nv[i], false);
+    }
+}
+
+MTF_DEFINE_UTEST(fuse_filter_test, duplicates)
+{
+    build_and_probe(lcl_ti, FF_FPBITS_MIN, 10, true);
+    build_and_probe(lcl_ti, FF_FPBITS_MIN, 54321, true);
+    build_and_probe(lcl_ti, FF_FPBITS_MID, 54321, true);
+    build_and_probe(lcl_ti, FF_FPBITS_MAX, 54321, true);
+}
+
+MTF_END_UTEST_COLLECTION(fuse_filter_test)
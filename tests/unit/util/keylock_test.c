@@ -263,4 +263,37 @@ MTF_DEFINE_UTEST(keylock_test, keylock_inheritance)
     keylock_destroy(handle);
 }
 
+MTF_DEFINE_UTEST(keylock_test, keylock_owner)
+{
+    struct keylock *handle;
+    uint32_t owner;
+    bool inherited;
+    merr_t err;
+    int i;
+
+    err = keylock_create(0, &handle);
+    ASSERT_EQ(0, err);
+
+    /* Colliding buckets exercise the probe sequence.
+     */
+    for (i = 0; i < 8; ++i) {
+        err = keylock_lock(handle, i * KLE_PSL_MAX, i + 100, 0, &inherited);
+        ASSERT_EQ(0, err);
+    }
+
+    for (i = 0; i < 8; ++i) {
+        ASSERT_TRUE(keylock_owner(handle, i * KLE_PSL_MAX, &owner));
+        ASSERT_EQ(i + 100, owner);
+    }
+
+    ASSERT_FALSE(keylock_owner(handle, 8 * KLE_PSL_MAX, &owner));
+
+    for (i = 0; i < 8; ++i) {
+        keylock_unlock(handle, i * KLE_PSL_MAX, i + 100);
+        ASSERT_FALSE(keylock_owner(handle, i * KLE_PSL_MAX, &owner));
+    }
+
+    keylock_destroy(handle);
+}
+
 MTF_END_UTEST_COLLECTION(keylock_test)
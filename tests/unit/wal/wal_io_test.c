@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/atomic.h>
+#include <hse/util/condvar.h>
+#include <hse/util/mutex.h>
+
+#include <hse/test/mock/api.h>
+#include <hse/test/mtf/framework.h>
+
+#include "wal/wal.h"
+#include "wal/wal_file.h"
+#include "wal/wal_io.h"
+
+/* Each thread models an HSE_KVS_PUT_SYNC caller: it queues one buffer and
+ * waits for the durable offset to cover it.
+ */
+#define NTHREADS (16)
+#define BUFLEN   (4096)
+
+static char buf[BUFLEN];
+static struct wal_io *io;
+static struct wal_iocb iocb;
+static atomic_ulong doff;
+static uint64_t woff;
+static merr_t cb_err;
+static struct mutex lock;
+static struct cv cv;
+
+static atomic_int writes;
+static atomic_int syncs;
+static merr_t sync_err;
+
+static merr_t
+mocked_wal_file_open(
+    struct wal_fileset *wfset,
+    uint64_t gen,
+    int fileid,
+    bool replay,
+    struct wal_file **handle)
+{
+    *handle = (struct wal_file *)buf;
+    return 0;
+}
+
+static merr_t
+mocked_wal_file_write(struct wal_file *wfile, char *data, size_t len, bool bufwrap)
+{
+    atomic_inc(&writes);
+    usleep(100);
+
+    return 0;
+}
+
+static merr_t
+mocked_wal_file_sync(struct wal_file *wfile)
+{
+    atomic_inc(&syncs);
+
+    /* A slow flush gives the other callers time to queue behind it.
+     */
+    usleep(1000);
+
+    return sync_err;
+}
+
+static void
+test_iocb(void *cbarg, merr_t err)
+{
+    mutex_lock(&lock);
+    if (err)
+        cb_err = err;
+    cv_broadcast(&cv);
+    mutex_unlock(&lock);
+}
+
+static void *
+putter(void *arg)
+{
+    struct wal_minmax_info info = { 0 };
+    merr_t *errp = arg;
+    uint64_t end;
+
+    mutex_lock(&lock);
+    end = (woff += BUFLEN);
+    *errp = wal_io_enqueue(io, buf, BUFLEN, 1, &info, false);
+    while (!*errp && !cb_err && atomic_read(&doff) < end)
+        cv_wait(&cv, &lock, "putsync");
+    if (!*errp)
+        *errp = cb_err;
+    mutex_unlock(&lock);
+
+    return NULL;
+}
+
+static int
+pre(struct mtf_test_info *info)
+{
+    merr_t err;
+
+    MOCK_SET_FN(wal_file, wal_file_open, mocked_wal_file_open);
+    MOCK_SET_FN(wal_file, wal_file_write, mocked_wal_file_write);
+    MOCK_SET_FN(wal_file, wal_file_sync, mocked_wal_file_sync);
+
+    mapi_inject(mapi_idx_wal_file_get, 0);
+    mapi_inject(mapi_idx_wal_file_put, 0);
+    mapi_inject(mapi_idx_wal_file_minmax_update, 0);
+    mapi_inject(mapi_idx_wal_file_complete, 0);
+
+    mutex_init(&lock);
+    cv_init(&cv);
+
+    atomic_set(&doff, 0);
+    atomic_set(&writes, 0);
+    atomic_set(&syncs, 0);
+    woff = 0;
+    cb_err = 0;
+    sync_err = 0;
+
+    iocb.cbarg = NULL;
+    iocb.iocb = test_iocb;
+
+    err = wal_io_init(1);
+    if (err)
+        return merr_errno(err);
+
+    io = wal_io_create(NULL, 0, &doff, &iocb, true);
+
+    return io ? 0 : ENOMEM;
+}
+
+static int
+post(struct mtf_test_info *info)
+{
+    wal_io_destroy(io);
+    wal_io_fini();
+
+    cv_destroy(&cv);
+    mutex_destroy(&lock);
+
+    mapi_inject_clear();
+
+    return 0;
+}
+
+static void
+run_putters(merr_t *errv)
+{
+    pthread_t tidv[NTHREADS];
+
+    for (int i = 0; i < NTHREADS; i++)
+        pthread_create(tidv + i, NULL, putter, errv + i);
+
+    for (int i = 0; i < NTHREADS; i++)
+        pthread_join(tidv[i], NULL);
+}
+
+MTF_BEGIN_UTEST_COLLECTION(wal_io_test);
+
+MTF_DEFINE_UTEST_PREPOST(wal_io_test, group_commit, pre, post)
+{
+    merr_t errv[NTHREADS];
+
+    run_putters(errv);
+
+    for (int i = 0; i < NTHREADS; i++)
+        ASSERT_EQ(0, errv[i]);
+
+    /* Every buffer was written, and the callers shared flushes.
+     */
+    ASSERT_EQ(NTHREADS, atomic_read(&writes));
+    ASSERT_EQ(NTHREADS * BUFLEN, atomic_read(&doff));
+    ASSERT_GT(atomic_read(&syncs), 0);
+    ASSERT_LT(atomic_read(&syncs), NTHREADS);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wal_io_test, sync_error, pre, post)
+{
+    struct wal_minmax_info minmax = { 0 };
+    merr_t errv[NTHREADS], err;
+    int nwrites;
+
+    sync_err = merr(EIO);
+
+    run_putters(errv);
+
+    /* No caller was told its buffer is durable.
+     */
+    for (int i = 0; i < NTHREADS; i++)
+        ASSERT_EQ(EIO, merr_errno(errv[i]));
+
+    ASSERT_EQ(0, atomic_read(&doff));
+    ASSERT_EQ(1, atomic_read(&syncs));
+
+    /* The error is sticky, nothing is written after the failed flush.
+     */
+    nwrites = atomic_read(&writes);
+
+    err = wal_io_enqueue(io, buf, BUFLEN, 1, &minmax, false);
+    ASSERT_EQ(EIO, merr_errno(err));
+
+    usleep(10 * 1000);
+    ASSERT_EQ(nwrites, atomic_read(&writes));
+    ASSERT_EQ(1, atomic_read(&syncs));
+}
+
+MTF_END_UTEST_COLLECTION(wal_io_test)
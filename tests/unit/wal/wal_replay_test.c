@@ -0,0 +1,378 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <hse/test/mock/api.h>
+#include <hse/test/mtf/framework.h>
+
+#include "wal/wal_replay.c"
+
+/* The records of a gen update a small set of key names in several kvses,
+ * such that each key is updated many times, interleaved with updates of
+ * the same key name in the other kvses.
+ */
+#define NKVS    (4)
+#define NKEYS   (64)
+#define NRECS   (8192)
+#define KEYSZ   (8)
+
+struct kv_state {
+    uint64_t seqno;
+    uint64_t val;
+    bool tomb;
+};
+
+static char keyv[NKEYS][KEYSZ];
+static uint64_t valv[NRECS];
+static struct kv_state serialv[NKVS][NKEYS];
+static struct kv_state replayv[NKVS][NKEYS];
+static uint64_t applyc, misorderc;
+static struct mutex lock;
+
+static struct kv_state *
+replay_state(uint64_t cnid, const struct kvs_ktuple *kt)
+{
+    uint keyidx = ((const char *)kt->kt_data - keyv[0]) / KEYSZ;
+
+    return &replayv[cnid - 1][keyidx];
+}
+
+/* Apply a mutation as c0 would and check that the mutations of each key
+ * arrive in seqno order.
+ */
+static void
+replay_apply(uint64_t cnid, uint64_t seqno, struct kvs_ktuple *kt, struct kvs_vtuple *vt)
+{
+    struct kv_state *kv = replay_state(cnid, kt);
+
+    mutex_lock(&lock);
+    if (seqno <= kv->seqno)
+        misorderc++;
+
+    kv->seqno = seqno;
+    kv->val = vt ? *(uint64_t *)vt->vt_data : 0;
+    kv->tomb = !vt;
+    applyc++;
+    mutex_unlock(&lock);
+}
+
+static merr_t
+mocked_replay_put(
+    struct ikvdb *ikvdb,
+    struct ikvdb_kvs_hdl *ikvsh,
+    uint64_t cnid,
+    uint64_t seqno,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt)
+{
+    replay_apply(cnid, seqno, kt, vt);
+
+    return 0;
+}
+
+static merr_t
+mocked_replay_del(
+    struct ikvdb *ikvdb,
+    struct ikvdb_kvs_hdl *ikvsh,
+    uint64_t cnid,
+    uint64_t seqno,
+    struct kvs_ktuple *kt)
+{
+    replay_apply(cnid, seqno, kt, NULL);
+
+    return 0;
+}
+
+/* A write batch is logged as a txn: a begin record, a run of WAL_RT_TX
+ * records under the batch's txid and a single commit (or abort) record.
+ * The file image below is built from the same packing routines as the
+ * WAL buffers use, with EORG marking the end of each flushed IO.
+ */
+#define FILE_GEN     (7)
+#define BATCH_NRECS  (16)
+
+static char filebuf[64 * 1024] HSE_ALIGNED(sizeof(uint64_t));
+static size_t fileoff;
+static uint64_t filerid;
+
+static void
+file_eorg(char *buf)
+{
+    struct wal_rechdr_omf *rhomf = (void *)buf;
+
+    omf_set_rh_flags(rhomf, omf_rh_flags(rhomf) | WAL_FLAGS_EORG);
+}
+
+static void
+file_txn(enum wal_rec_type rtype, uint64_t txid, uint64_t seqno, uint64_t cid, bool eorg)
+{
+    size_t len = wal_txn_reclen(WAL_VERSION);
+    char *buf = filebuf + fileoff;
+
+    wal_rechdr_pack(rtype, ++filerid, len, FILE_GEN, buf);
+    wal_txn_rec_pack(txid, seqno, cid, buf);
+    wal_txn_rechdr_finish(buf, len, fileoff);
+
+    if (eorg)
+        file_eorg(buf);
+
+    fileoff += len;
+}
+
+static void
+file_batch_puts(uint64_t txid, bool eorg)
+{
+    const size_t rlen = wal_reclen(WAL_VERSION);
+
+    for (uint i = 0; i < BATCH_NRECS; i++) {
+        struct wal_record rec = { 0 };
+        char *buf = filebuf + fileoff;
+
+        rec.recbuf = buf;
+        rec.offset = fileoff;
+        rec.len = rlen + ALIGN(KEYSZ, sizeof(uint64_t)) + sizeof(valv[i]);
+
+        valv[i] = txid;
+
+        wal_rechdr_pack(WAL_RT_TX, ++filerid, rec.len, 0, buf);
+        wal_rec_pack(WAL_OP_PUT, 1 + i % NKVS, txid, KEYSZ, sizeof(valv[i]), buf);
+        memcpy(buf + rlen, keyv[i], KEYSZ);
+        memcpy(buf + rlen + ALIGN(KEYSZ, sizeof(uint64_t)), &valv[i], sizeof(valv[i]));
+        wal_rec_finish(&rec, 0, FILE_GEN);
+
+        if (eorg && i == BATCH_NRECS - 1)
+            file_eorg(buf);
+
+        fileoff += rec.len;
+    }
+}
+
+static int
+pre(struct mtf_test_info *info)
+{
+    for (uint i = 0; i < NKEYS; i++)
+        snprintf(keyv[i], sizeof(keyv[i]), "key%03u", i);
+
+    memset(serialv, 0, sizeof(serialv));
+    memset(replayv, 0, sizeof(replayv));
+    applyc = misorderc = 0;
+
+    mutex_init(&lock);
+
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_put, mocked_replay_put);
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_del, mocked_replay_del);
+
+    return 0;
+}
+
+static int
+post(struct mtf_test_info *info)
+{
+    MOCK_UNSET(ikvdb, _ikvdb_wal_replay_put);
+    MOCK_UNSET(ikvdb, _ikvdb_wal_replay_del);
+
+    mutex_destroy(&lock);
+
+    return 0;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(wal_replay_test);
+
+MTF_DEFINE_UTEST_PREPOST(wal_replay_test, interleaved_kvs, pre, post)
+{
+    struct wal_replay_gen_info rginfo = { 0 };
+    struct wal_replay_gen *rgen;
+    struct wal_replay rep = { 0 };
+    uint64_t seed = 1;
+    merr_t err;
+
+    rep.r_cache =
+        kmem_cache_create("wal-reprec", sizeof(struct wal_rec), alignof(struct wal_rec), 0, NULL);
+    ASSERT_NE(NULL, rep.r_cache);
+
+    rep.r_applywq = alloc_workqueue("wal_replay_test", 0, 1, WAL_REPLAY_PARTS);
+    ASSERT_NE(NULL, rep.r_applywq);
+
+    rgen = aligned_alloc(__alignof__(*rgen), sizeof(*rgen));
+    ASSERT_NE(NULL, rgen);
+
+    rginfo.gen = 7;
+    wal_replay_gen_init(rgen, &rginfo);
+
+    /* Generate the records in record ID (and hence seqno) order, applying
+     * each to the serial model on the way.
+     */
+    for (uint i = 0; i < NRECS; i++) {
+        struct kv_state *kv;
+        struct wal_rec *rec;
+        uint cnid, keyidx;
+
+        seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+        cnid = 1 + (seed >> 33) % NKVS;
+        keyidx = (seed >> 40) % NKEYS;
+
+        rec = kmem_cache_alloc(rep.r_cache);
+        ASSERT_NE(NULL, rec);
+
+        memset(rec, 0, sizeof(*rec));
+        rec->hdr.type = WAL_RT_NONTX;
+        rec->hdr.rid = i + 1;
+        rec->hdr.gen = rginfo.gen;
+        rec->cnid = cnid;
+        rec->seqno = i + 1;
+        rec->op = ((seed >> 20) % 8 == 0) ? WAL_OP_DEL : WAL_OP_PUT;
+
+        kvs_ktuple_init(&rec->kt, keyv[keyidx], strlen(keyv[keyidx]));
+
+        valv[i] = i;
+        kvs_vtuple_init(&rec->vt, &valv[i], sizeof(valv[i]));
+
+        kv = &serialv[cnid - 1][keyidx];
+        kv->seqno = rec->seqno;
+        kv->tomb = (rec->op == WAL_OP_DEL);
+        kv->val = kv->tomb ? 0 : valv[i];
+
+        err = wal_rec_rb_insert(&wal_replay_gen_part(rgen, rec)->rp_root, rec);
+        ASSERT_EQ(0, err);
+    }
+
+    err = wal_replay_gen_impl(&rep, rgen, 0);
+    ASSERT_EQ(0, err);
+
+    ASSERT_EQ(NRECS, applyc);
+    ASSERT_EQ(0, misorderc);
+    ASSERT_EQ(NRECS, rgen->rg_krcnt);
+    ASSERT_EQ(NRECS, rgen->rg_maxseqno);
+
+    for (uint i = 0; i < NKVS; i++) {
+        for (uint j = 0; j < NKEYS; j++) {
+            ASSERT_EQ(serialv[i][j].seqno, replayv[i][j].seqno);
+            ASSERT_EQ(serialv[i][j].tomb, replayv[i][j].tomb);
+            ASSERT_EQ(serialv[i][j].val, replayv[i][j].val);
+        }
+    }
+
+    for (uint i = 0; i < WAL_REPLAY_PARTS; i++)
+        ASSERT_TRUE(RB_EMPTY_ROOT(&rgen->rg_partv[i].rp_root));
+
+    wal_replay_gen_free(rgen);
+    destroy_workqueue(rep.r_applywq);
+    kmem_cache_destroy(rep.r_cache);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wal_replay_test, batch_all_or_nothing, pre, post)
+{
+    struct wal_replay_gen_info rginfo = { 0 };
+    struct wal_replay_info rinfo = { 0 };
+    struct wal_replay_work rw = { 0 };
+    struct wal_replay_gen *rgen, *next;
+    struct wal_txmeta_rec *trec, *tnext;
+    struct wal_replay *rep;
+    struct wal_rec_iter iter;
+    struct wal_rec *rec;
+    uint recc[5] = { 0 };
+    size_t eoff;
+    merr_t err;
+
+    rep = aligned_alloc(__alignof__(*rep), sizeof(*rep));
+    ASSERT_NE(NULL, rep);
+    memset(rep, 0, sizeof(*rep));
+
+    rep->r_cache =
+        kmem_cache_create("wal-reprec", sizeof(struct wal_rec), alignof(struct wal_rec), 0, NULL);
+    ASSERT_NE(NULL, rep->r_cache);
+
+    rep->r_txm_cache = kmem_cache_create(
+        "wal-reptxm", sizeof(struct wal_txmeta_rec), alignof(struct wal_txmeta_rec), 0, NULL);
+    ASSERT_NE(NULL, rep->r_txm_cache);
+
+    rep->r_version = WAL_VERSION;
+    rep->r_info = &rinfo;
+    rep->r_ginfo = &rginfo;
+    rep->r_cnt = 1;
+    INIT_LIST_HEAD(&rep->r_head);
+    rmlock_init(&rep->r_txm_lock);
+    rep->r_txm_root = RB_ROOT;
+    rep->r_txcid_root = RB_ROOT;
+
+    fileoff = 0;
+    filerid = 0;
+
+    /* Batch 1 commits.  Batch 2 is aborted.  The process crashes after
+     * the records of batch 3 are durable but before its commit record is
+     * written, and while the IO that carries batch 4's commit record is
+     * in flight (hence that IO has no EORG record).
+     */
+    file_txn(WAL_RT_TXBEGIN, 1, 0, 0, false);
+    file_batch_puts(1, false);
+    file_txn(WAL_RT_TXCOMMIT, 1, 11, 1, true);
+
+    file_txn(WAL_RT_TXBEGIN, 2, 0, 0, false);
+    file_batch_puts(2, false);
+    file_txn(WAL_RT_TXABORT, 2, 0, 0, true);
+
+    file_txn(WAL_RT_TXBEGIN, 3, 0, 0, false);
+    file_batch_puts(3, true);
+    eoff = fileoff;
+
+    file_txn(WAL_RT_TXBEGIN, 4, 0, 0, false);
+    file_batch_puts(4, false);
+    file_txn(WAL_RT_TXCOMMIT, 4, 13, 2, false);
+
+    spin_lock_init(&rginfo.txm_lock);
+    rginfo.txm_root = RB_ROOT;
+    rginfo.txcid_root = RB_ROOT;
+    rginfo.info.min_seqno = rginfo.info.min_gen = rginfo.info.min_txid = UINT64_MAX;
+    rginfo.buf = filebuf;
+    rginfo.gen = FILE_GEN;
+    rginfo.size = fileoff;
+
+    rw.rw_rep = rep;
+    rw.rw_rginfo = &rginfo;
+
+    err = wal_recs_validate(&rw);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(eoff, rginfo.eoff);
+
+    err = wal_replay_consolidate(rep);
+    ASSERT_EQ(0, err);
+
+    err = wal_txmeta_gen_update(rep);
+    ASSERT_EQ(0, err);
+
+    wal_rec_iter_init(&rw, &iter);
+
+    while ((rec = wal_rec_iter_next(&iter))) {
+        ASSERT_EQ(WAL_RT_TX, rec->hdr.type);
+        ASSERT_EQ(11, rec->seqno);
+        ASSERT_EQ(rec->txid, *(uint64_t *)rec->vt.vt_data);
+
+        recc[rec->txid]++;
+        kmem_cache_free(rep->r_cache, rec);
+    }
+
+    ASSERT_EQ(0, iter.err);
+    ASSERT_EQ(BATCH_NRECS, recc[1]);
+    ASSERT_EQ(0, recc[2]);
+    ASSERT_EQ(0, recc[3]);
+    ASSERT_EQ(0, recc[4]);
+
+    list_for_each_entry_safe(rgen, next, &rep->r_head, rg_link) {
+        list_del_init(&rgen->rg_link);
+        wal_replay_gen_free(rgen);
+    }
+
+    rbtree_postorder_for_each_entry_safe(trec, tnext, &rep->r_txm_root, node)
+        kmem_cache_free(rep->r_txm_cache, trec);
+
+    kmem_cache_destroy(rep->r_txm_cache);
+    kmem_cache_destroy(rep->r_cache);
+    rmlock_destroy(&rep->r_txm_lock);
+    free(rep);
+}
+
+MTF_END_UTEST_COLLECTION(wal_replay_test)
@@ -271,6 +271,10 @@ val_get_next(const void *kmd, size_t *off, struct kmd_vref *vref)
         kmd_ival(kmd, off, &vdata, &vlen);
         snprintf(vref->vinfo, sizeof(vref->vinfo), "IVAL len %u", vlen);
         break;
+    case VTYPE_MOPND:
+        kmd_mopnd(kmd, off, &vdata, &vlen);
+        snprintf(vref->vinfo, sizeof(vref->vinfo), "MOPND len %u", vlen);
+        break;
     case VTYPE_ZVAL:
         snprintf(vref->vinfo, sizeof(vref->vinfo), "ZVAL");
         break;
@@ -319,9 +323,9 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
     lfe = (struct wbt_lfe_omf *)(((void *)wbn) + hdr_sz + pfx_len);
 
     printf(
-        "    %c: pg %d  magic 0x%04x  nkeys %u  kmdoff %u  pfx_len %u  pfx %s\n",
+        "    %c: pg %d  magic 0x%04x  nkeys %u  kmdoff %u  restart %u  pfx_len %u  pfx %s\n",
         fmt_wtype(omf_wbn_magic(wbn), pgno == root), pgno, omf_wbn_magic(wbn),
-        omf_wbn_num_keys(wbn), omf_wbn_kmd(wbn), pfx_len,
+        omf_wbn_num_keys(wbn), omf_wbn_kmd(wbn), omf_wbn_restart(wbn), pfx_len,
         fmt_data(&buf, &bufsz, pfx, pfx_len, opts.klen, opts.penc));
 
     if (opts.wbt_detail <= 2)
@@ -338,11 +342,14 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
                 fmt_data(&buf, &bufsz, kdata, klen, opts.klen, opts.penc));
         } else {
             size_t off;
-            uint j, cnt, lfe_kmd, koff, klen;
+            uint j, cnt, lfe_kmd, koff, klen, shared = 0;
+            const void *head;
 
             struct kmd_vref vref;
 
             wbt_lfe_key(wbn, lfe, &kdata, &klen);
+            if (wbt_lfe_front_coded(wbn))
+                wbt_lfe_pfx(wbn, lfe, &head, &shared);
 
             koff = omf_lfe_koff(lfe);
             lfe_kmd = wbt_lfe_kmd(wbn, lfe);
@@ -354,8 +361,8 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
             while (val_get_next(kmd, &off, &vref)) {
                 if (j == 1)
                     printf(
-                        "      key: %u/%u lfe %-4u koff %-4u klen %-2u kmd %u key %s", i, nkeys,
-                        (uint)((void *)lfe - (void *)wbn), koff, klen, lfe_kmd,
+                        "      key: %u/%u lfe %-4u koff %-4u shared %-2u klen %-2u kmd %u key %s",
+                        i, nkeys, (uint)((void *)lfe - (void *)wbn), koff, shared, klen, lfe_kmd,
                         fmt_data(&buf, &bufsz, kdata, klen, opts.klen, opts.penc));
                 if (j > 1)
                     printf("\n        ");
@@ -443,7 +450,9 @@ wbt_dump(struct dump_mblock *mblk)
     const struct wbt_hdr_omf *wbt = mblk->data + omf_kbh_wbt_hoff(mblk->data);
 
     switch (omf_wbt_version(wbt)) {
-    case WBT_TREE_VERSION:
+    case WBT_TREE_VERSION6:
+    case WBT_TREE_VERSION7:
+    case WBT_TREE_VERSION8:
         wbt_dump_impl(mblk, wbt);
         break;
     default:
@@ -493,6 +502,15 @@ bloom_dump(struct dump_mblock *mblk)
     uint bktmax;
     uint i, j;
 
+    if (omf_bh_version(bh) >= BLOOM_OMF_VERSION7 && omf_bh_type(bh) == BLOOM_OMF_TYPE_FUSE) {
+        printf(
+            "  fuse hdr: magic 0x%08x  ver %u seglen %u  fpbits %u  "
+            "fpvsz %u  slots %u  seed 0x%lx\n",
+            omf_bh_magic(bh), omf_bh_version(bh), 1u << omf_bh_bktshift(bh), omf_bh_rotl(bh),
+            omf_bh_bitmapsz(bh), omf_bh_modulus(bh), omf_bh_seed(bh));
+        return;
+    }
+
     bktsz = (1u << omf_bh_bktshift(bh)) / 8;
     bitsperbkt = bktsz * CHAR_BIT;
 
@@ -655,6 +673,14 @@ kblock_dump(struct dump_mblock *mblk)
         "  bloom: hdr %d %d  data_pg %d %d  ver %u\n", omf_kbh_blm_hoff(kbh), omf_kbh_blm_hlen(kbh),
         omf_kbh_blm_doff_pg(kbh), omf_kbh_blm_dlen_pg(kbh), omf_bh_version(bh));
 
+    if (omf_kbh_version(kbh) >= KBLOCK_HDR_VERSION7 && omf_kbh_hix_nbkts(kbh)) {
+        uint32_t nbkts = omf_kbh_hix_nbkts(kbh);
+
+        printf(
+            "  hix: data_pg %u %u  buckets %u\n", omf_kbh_hix_doff_pg(kbh), kblock_hix_pgc(nbkts),
+            nbkts);
+    }
+
     printf("  kmd: start_pg %u\n", omf_kbh_wbt_doff_pg(kbh) + omf_wbt_root(wbt) + 1);
 
     printf(
@@ -570,6 +570,7 @@ run_kmd_read_perf(struct kmd_test_stats *s)
             assert(exp_seq + i == seq);
             switch (vtype) {
             case VTYPE_IVAL:
+            case VTYPE_MOPND:
                 kmd_ival(mem, &off, &vdata, &vlen);
                 s->nvals++;
                 break;
@@ -639,6 +640,7 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                 s->nzvals++;
                 break;
             case VTYPE_IVAL:
+            case VTYPE_MOPND:
                 s->nivals++;
                 break;
             case VTYPE_CVAL:
@@ -660,6 +662,9 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                 case VTYPE_IVAL:
                     kmd_add_ival(mem, &off, seq, vdata, vlen);
                     break;
+                case VTYPE_MOPND:
+                    kmd_add_mopnd(mem, &off, seq, vdata, vlen);
+                    break;
                 case VTYPE_CVAL:
                     kmd_add_cval(mem, &off, seq, vbidx, vboff, vlen, clen);
                     break;
@@ -694,6 +699,7 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                     assert(actual_clen == clen);
                     break;
                 case VTYPE_IVAL:
+                case VTYPE_MOPND:
                     kmd_ival(mem, &off, &actual_vdata, &actual_vlen);
                     assert(actual_vlen == vlen);
                     break;